@@ -1377,6 +1377,8 @@ typedef struct
 #define VID_RECORD_ID_COLUMN        ((UINT32)705)
 #define VID_OBJECT_ID_COLUMN        ((UINT32)706)
 #define VID_RAW_VALUE               ((UINT32)707)
+#define VID_TABLE_BINARY_DATA       ((UINT32)708)
+#define VID_ACCEPT_BINARY_TABLE     ((UINT32)709)
 
 // Base variabe for single threshold in message
 #define VID_THRESHOLD_BASE          ((UINT32)0x00800000)
@@ -199,6 +199,11 @@ inline WCHAR towupper(WCHAR c)
 #define ICMP_API_ERROR        4
 #define ICMP_SEND_FAILED      5
 
+/**
+ * Callback for asynchronous ICMP ping (called with one of ICMP_xxx codes and round trip time in milliseconds)
+ */
+typedef void (*IcmpPingCallback)(UINT32 result, UINT32 rtt, void *context);
+
 /**
  * Token types for configuration loader
  */
@@ -2567,6 +2572,8 @@ class LIBNETXMS_EXPORTABLE ByteStream
    void write(double n) { double x = htond(n); write(&x, 8); }
    void writeString(const TCHAR *s);
    void writeStringUtf8(const char *s);
+   void writeVarInt(uint64_t n);
+   void writeSignedVarInt(int64_t n) { writeVarInt((static_cast<uint64_t>(n) << 1) ^ static_cast<uint64_t>(n >> 63)); }
 
    size_t read(void *buffer, size_t count);
    char readChar() { return !eos() ? (char)m_data[m_pos++] : 0; }
@@ -2580,6 +2587,8 @@ class LIBNETXMS_EXPORTABLE ByteStream
    double readDouble();
    TCHAR *readString();
    char *readStringUtf8();
+   uint64_t readVarInt();
+   int64_t readSignedVarInt() { uint64_t n = readVarInt(); return static_cast<int64_t>(n >> 1) ^ -static_cast<int64_t>(n & 1); }
 
    bool save(int f);
 };
@@ -2737,6 +2746,9 @@ class LIBNETXMS_EXPORTABLE Table : public RefCountObject
 	void createFromMessage(NXCPMessage *msg);
 	void destroy();
    bool parseXML(const char *xml);
+   bool readBinary(ByteStream *in);
+   void writeBinaryColumn(ByteStream *out, int col) const;
+   bool readBinaryColumn(ByteStream *in, int col);
 
 public:
    Table();
@@ -2745,6 +2757,7 @@ class LIBNETXMS_EXPORTABLE Table : public RefCountObject
    virtual ~Table();
 
 	int fillMessage(NXCPMessage &msg, int offset, int rowLimit);
+   void fillMessageBinary(NXCPMessage &msg) const;
 	void updateFromMessage(NXCPMessage *msg);
 
    void addAll(const Table *src);
@@ -2834,6 +2847,12 @@ class LIBNETXMS_EXPORTABLE Table : public RefCountObject
 
    static Table *createFromPackedXML(const char *packedXml);
    char *createPackedXML() const;
+
+   static Table *createFromBinary(ByteStream *in);
+   void writeBinary(ByteStream *out) const;
+
+   static Table *createFromPackedData(const char *packedData);
+   char *createPackedBinary() const;
 };
 
 /**
@@ -3188,6 +3207,39 @@ class LIBNETXMS_EXPORTABLE InetAddressList
    static InetAddressList *resolveHostName(const char *hostname);
 };
 
+struct InetAddressPrefixTreeNode;
+
+/**
+ * Path-compressed binary prefix tree (Patricia trie) for IP prefixes with longest prefix match.
+ * Separate trees are maintained for IPv4 and IPv6. Not synchronized - caller should provide locking.
+ */
+class LIBNETXMS_EXPORTABLE InetAddressPrefixTree
+{
+   DISABLE_COPY_CTOR(InetAddressPrefixTree)
+
+private:
+   InetAddressPrefixTreeNode *m_rootV4;
+   InetAddressPrefixTreeNode *m_rootV6;
+   int m_size;
+
+   InetAddressPrefixTreeNode **getRoot(int family) { return (family == AF_INET) ? &m_rootV4 : ((family == AF_INET6) ? &m_rootV6 : nullptr); }
+   InetAddressPrefixTreeNode *getRoot(int family) const { return (family == AF_INET) ? m_rootV4 : ((family == AF_INET6) ? m_rootV6 : nullptr); }
+
+public:
+   InetAddressPrefixTree();
+   ~InetAddressPrefixTree();
+
+   bool put(const InetAddress& prefix, void *value);
+   void *remove(const InetAddress& prefix);
+   void clear();
+
+   void *get(const InetAddress& prefix) const;
+   void *findLongestMatch(const InetAddress& addr, InetAddress *matchedPrefix = nullptr) const;
+
+   int size() const { return m_size; }
+   bool isEmpty() const { return m_size == 0; }
+};
+
 /**
  * Network connection
  */
@@ -4136,6 +4188,29 @@ enum TcpPingResult
 // Defined by Windows header files and not used in our code anyway
 #undef IGNORE
 
+/**
+ * Registered debug tag. Effective debug level for the tag is cached in the handle and
+ * updated on every debug level change, so check for disabled debug output costs
+ * single memory read.
+ */
+struct DebugTagHandle
+{
+   TCHAR name[64];
+   volatile int32_t level;
+};
+
+DebugTagHandle LIBNETXMS_EXPORTABLE *nxlog_register_debug_tag(const TCHAR *tag);
+void LIBNETXMS_EXPORTABLE nxlog_debug_tag(const DebugTagHandle *tag, int level, const TCHAR *format, ...);
+void LIBNETXMS_EXPORTABLE nxlog_debug_tag2(const DebugTagHandle *tag, int level, const TCHAR *format, va_list args);
+
+/**
+ * Check if debug output with given level is enabled for registered tag
+ */
+inline bool nxlog_is_debug_enabled(const DebugTagHandle *tag, int level)
+{
+   return level <= tag->level;
+}
+
 /**
  * Generic state change instruction
  */
@@ -4205,6 +4280,16 @@ inline String GetStringAttributeWithLock(const TCHAR *attr, MUTEX mutex)
    return value;
 }
 
+/**
+ * Target for IcmpPingMultiple (result and rtt are set by IcmpPingMultiple)
+ */
+struct IcmpPingTarget
+{
+   InetAddress addr;
+   UINT32 result;
+   UINT32 rtt;
+};
+
 TCHAR LIBNETXMS_EXPORTABLE *GetHeapInfo();
 INT64 LIBNETXMS_EXPORTABLE GetAllocatedHeapMemory();
 INT64 LIBNETXMS_EXPORTABLE GetActiveHeapMemory();
@@ -4214,6 +4299,11 @@ void LIBNETXMS_EXPORTABLE GetNetXMSDirectory(nxDirectoryType type, TCHAR *dir);
 
 TcpPingResult LIBNETXMS_EXPORTABLE TcpPing(const InetAddress& addr, UINT16 port, UINT32 timeout);
 UINT32 LIBNETXMS_EXPORTABLE IcmpPing(const InetAddress& addr, int numRetries, UINT32 timeout, UINT32 *rtt, UINT32 packetSize, bool dontFragment);
+bool LIBNETXMS_EXPORTABLE IcmpPingAsync(const InetAddress& addr, UINT32 timeout, UINT32 packetSize, bool dontFragment, IcmpPingCallback callback, void *context);
+UINT32 LIBNETXMS_EXPORTABLE IcmpPingShared(const InetAddress& addr, int numRetries, UINT32 timeout, UINT32 *rtt, UINT32 packetSize, bool dontFragment);
+int LIBNETXMS_EXPORTABLE IcmpPingMultiple(IcmpPingTarget *targets, int count, int numRetries, UINT32 timeout, UINT32 packetSize, bool dontFragment);
+void LIBNETXMS_EXPORTABLE InitIcmpPinger();
+void LIBNETXMS_EXPORTABLE ShutdownIcmpPinger();
 UINT16 LIBNETXMS_EXPORTABLE CalculateIPChecksum(const void *data, size_t len);
 
 TCHAR LIBNETXMS_EXPORTABLE *EscapeStringForXML(const TCHAR *str, int length);
@@ -81,6 +81,9 @@ typedef db_result_t * DB_RESULT;
 struct db_unbuffered_result_t;
 typedef db_unbuffered_result_t * DB_UNBUFFERED_RESULT;
 
+struct db_bulk_insert_t;
+typedef db_bulk_insert_t * DB_BULK_INSERT;
+
 /**
  * Pool connection information
  */
@@ -147,6 +150,24 @@ void LIBNXDB_EXPORTABLE DBBind(DB_STATEMENT hStmt, int pos, int sqlType, const M
 void LIBNXDB_EXPORTABLE DBBind(DB_STATEMENT hStmt, int pos, int sqlType, json_t *value, int allocType);
 bool LIBNXDB_EXPORTABLE DBExecute(DB_STATEMENT hStmt);
 bool LIBNXDB_EXPORTABLE DBExecuteEx(DB_STATEMENT hStmt, TCHAR *errorText);
+DB_BULK_INSERT LIBNXDB_EXPORTABLE DBBulkInsertCreate(const TCHAR *table, const TCHAR *columns, const int *sqlTypes, int numColumns);
+void LIBNXDB_EXPORTABLE DBBulkInsertFree(DB_BULK_INSERT bi);
+void LIBNXDB_EXPORTABLE DBBulkInsertAddRow(DB_BULK_INSERT bi);
+void LIBNXDB_EXPORTABLE DBBulkInsertSet(DB_BULK_INSERT bi, int column, INT32 value);
+void LIBNXDB_EXPORTABLE DBBulkInsertSet(DB_BULK_INSERT bi, int column, UINT32 value);
+void LIBNXDB_EXPORTABLE DBBulkInsertSet(DB_BULK_INSERT bi, int column, INT64 value);
+void LIBNXDB_EXPORTABLE DBBulkInsertSet(DB_BULK_INSERT bi, int column, UINT64 value);
+void LIBNXDB_EXPORTABLE DBBulkInsertSet(DB_BULK_INSERT bi, int column, double value);
+void LIBNXDB_EXPORTABLE DBBulkInsertSet(DB_BULK_INSERT bi, int column, const TCHAR *value);
+void LIBNXDB_EXPORTABLE DBBulkInsertSetMB(DB_BULK_INSERT bi, int column, const char *value);
+void LIBNXDB_EXPORTABLE DBBulkInsertSetUTF8(DB_BULK_INSERT bi, int column, const char *value);
+int LIBNXDB_EXPORTABLE DBBulkInsertGetRowCount(DB_BULK_INSERT bi);
+void LIBNXDB_EXPORTABLE DBBulkInsertClear(DB_BULK_INSERT bi);
+bool LIBNXDB_EXPORTABLE DBBulkInsertExecute(DB_HANDLE hConn, DB_BULK_INSERT bi);
+bool LIBNXDB_EXPORTABLE DBBulkInsertExecuteEx(DB_HANDLE hConn, DB_BULK_INSERT bi, TCHAR *errorText);
+int LIBNXDB_EXPORTABLE DBBulkInsertExecuteRowByRow(DB_HANDLE hConn, DB_BULK_INSERT bi);
+bool LIBNXDB_EXPORTABLE DBBulkInsertIsConnectionLost(DB_BULK_INSERT bi);
+
 DB_RESULT LIBNXDB_EXPORTABLE DBSelectPrepared(DB_STATEMENT hStmt);
 DB_RESULT LIBNXDB_EXPORTABLE DBSelectPreparedEx(DB_STATEMENT hStmt, TCHAR *errorText);
 DB_UNBUFFERED_RESULT LIBNXDB_EXPORTABLE DBSelectPreparedUnbuffered(DB_STATEMENT hStmt);
@@ -236,6 +257,7 @@ int LIBNXDB_EXPORTABLE DBConnectionPoolGetAcquiredCount();
 void LIBNXDB_EXPORTABLE DBSetLongRunningThreshold(UINT32 threshold);
 ObjectArray<PoolConnectionInfo> LIBNXDB_EXPORTABLE *DBConnectionPoolGetConnectionList();
 void LIBNXDB_EXPORTABLE DBGetPerfCounters(LIBNXDB_PERF_COUNTERS *counters);
+UINT64 LIBNXDB_EXPORTABLE DBGetNonSelectQueryCount(DB_HANDLE hdb);
 
 bool LIBNXDB_EXPORTABLE IsDatabaseRecordExist(DB_HANDLE hdb, const TCHAR *table, const TCHAR *idColumn, uint32_t id);
 bool LIBNXDB_EXPORTABLE IsDatabaseRecordExist(DB_HANDLE hdb, const TCHAR *table, const TCHAR *idColumn, uint64_t id);
@@ -254,6 +276,14 @@ bool LIBNXDB_EXPORTABLE DBDropColumn(DB_HANDLE hdb, const TCHAR *table, const TC
 bool LIBNXDB_EXPORTABLE DBRenameColumn(DB_HANDLE hdb, const TCHAR *tableName, const TCHAR *oldName, const TCHAR *newName);
 bool LIBNXDB_EXPORTABLE DBDropIndex(DB_HANDLE hdb, const TCHAR *table, const TCHAR *index);
 
+TCHAR LIBNXDB_EXPORTABLE *DBGetTimePartitionName(DB_HANDLE hdb, const TCHAR *table, int64_t start, TCHAR *buffer);
+int64_t LIBNXDB_EXPORTABLE DBGetTimePartitionStart(DB_HANDLE hdb, const TCHAR *table, const TCHAR *name);
+bool LIBNXDB_EXPORTABLE DBGetTimePartitions(DB_HANDLE hdb, const TCHAR *table, IntegerArray<int64_t> *partitions);
+bool LIBNXDB_EXPORTABLE DBCreateTimePartition(DB_HANDLE hdb, const TCHAR *table, const TCHAR *column, int64_t start, uint32_t interval);
+bool LIBNXDB_EXPORTABLE DBDropTimePartition(DB_HANDLE hdb, const TCHAR *table, int64_t start);
+int LIBNXDB_EXPORTABLE DBCreateTimePartitions(DB_HANDLE hdb, const TCHAR *table, const TCHAR *column, uint32_t interval, time_t until);
+int LIBNXDB_EXPORTABLE DBDropExpiredTimePartitions(DB_HANDLE hdb, const TCHAR *table, const TCHAR *column, uint32_t interval, time_t cutoff);
+
 DB_HANDLE LIBNXDB_EXPORTABLE DBOpenInMemoryDatabase();
 void LIBNXDB_EXPORTABLE DBCloseInMemoryDatabase(DB_HANDLE hdb);
 bool LIBNXDB_EXPORTABLE DBCacheTable(DB_HANDLE cacheDB, DB_HANDLE sourceDB, const TCHAR *table, const TCHAR *indexColumn, const TCHAR *columns, const TCHAR * const *intColumns = NULL);
@@ -89,6 +89,7 @@ typedef void (* LogParserCallback)(UINT32, const TCHAR *, const TCHAR *, const T
          int, time_t, const TCHAR *, const StringList *, void *);
 
 class LIBNXLP_EXPORTABLE LogParser;
+class RulePrefilter;
 
 #ifdef _WIN32
 
@@ -145,6 +146,8 @@ class LIBNXLP_EXPORTABLE LogParserRule
 	bool m_resetRepeat;
 	int m_checkCount;
 	int m_matchCount;
+	int m_skipCount;
+	TCHAR *m_literal;
 	TCHAR *m_agentAction;
 	StringList *m_agentActionArgs;
 	HashMap<uint32_t, ObjectRuleStats> *m_objectCounters;
@@ -156,6 +159,7 @@ class LIBNXLP_EXPORTABLE LogParserRule
    void expandMacros(const TCHAR *regexp, StringBuffer &out);
    void incCheckCount(uint32_t objectId);
    void incMatchCount(uint32_t objectId);
+   void skip(uint32_t objectId);
 
 public:
 	LogParserRule(LogParser *parser, const TCHAR *name,
@@ -212,9 +216,11 @@ class LIBNXLP_EXPORTABLE LogParserRule
    bool isRepeatReset() const { return m_resetRepeat; }
 
 	const TCHAR *getRegexpSource() const { return CHECK_NULL(m_regexp); }
+	const TCHAR *getRequiredLiteral() const { return m_literal; }
 
    int getCheckCount(uint32_t objectId = 0) const;
    int getMatchCount(uint32_t objectId = 0) const;
+   int getSkipCount() const { return m_skipCount; }
 
    void restoreCounters(const LogParserRule *rule);
 };
@@ -226,6 +232,7 @@ class LIBNXLP_EXPORTABLE LogParser
 {
 private:
 	ObjectArray<LogParserRule> *m_rules;
+	RulePrefilter *m_prefilter;
 	StringMap m_contexts;
 	StringMap m_macros;
 	LogParserCallback m_cb;
@@ -238,6 +245,7 @@ class LIBNXLP_EXPORTABLE LogParser
 	bool (*m_eventResolver)(const TCHAR *, uint32_t *);
 	THREAD m_thread;	// Associated thread
    CONDITION m_stopCondition;
+   CONDITION m_fileChangeCondition;
    int m_recordsProcessed;
 	int m_recordsMatched;
 	bool m_preallocatedFile;
@@ -348,6 +356,7 @@ class LIBNXLP_EXPORTABLE LogParser
 
    int getRuleCheckCount(const TCHAR *ruleName, UINT32 objectId = 0) const { const LogParserRule *r = findRuleByName(ruleName); return (r != NULL) ? r->getCheckCount(objectId) : -1; }
    int getRuleMatchCount(const TCHAR *ruleName, UINT32 objectId = 0) const { const LogParserRule *r = findRuleByName(ruleName); return (r != NULL) ? r->getMatchCount(objectId) : -1; }
+   int getRuleSkipCount(const TCHAR *ruleName) const { const LogParserRule *r = findRuleByName(ruleName); return (r != NULL) ? r->getSkipCount() : -1; }
 
    void restoreCounters(const LogParser *parser);
 
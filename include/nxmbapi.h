@@ -81,6 +81,7 @@ class LIBNXMB_EXPORTABLE NXMBFilter
 	virtual ~NXMBFilter();
 
 	virtual bool isAllowed(NXMBMessage &msg);
+	virtual bool isTypeAccepted(const TCHAR *type);
 	virtual bool isOwnedByDispatcher();
 };
 
@@ -97,6 +98,7 @@ class LIBNXMB_EXPORTABLE NXMBTypeFilter : public NXMBFilter
 	virtual ~NXMBTypeFilter();
 
 	virtual bool isAllowed(NXMBMessage &msg);
+	virtual bool isTypeAccepted(const TCHAR *type);
 
 	void addMessageType(const TCHAR *type);
 	void removeMessageType(const TCHAR *type);
@@ -119,6 +121,8 @@ class CallHandlerMap : public StringMapBase
 	NXMBCallHandler get(const TCHAR *name) { return (NXMBCallHandler)getObject(name); }
 };
 
+class NXMBSubscriberList;
+
 /**
  * Message dispatcher class
  */
@@ -126,11 +130,10 @@ class LIBNXMB_EXPORTABLE NXMBDispatcher
 {
 private:
 	Queue *m_queue;
-	int m_numSubscribers;
-	NXMBSubscriber **m_subscribers;
-	NXMBFilter **m_filters;
+	shared_ptr<NXMBSubscriberList> m_subscribers;
 	MUTEX m_subscriberListAccess;
 	THREAD m_workerThreadHandle;
+	UINT32 m_workerThreadId;
    CallHandlerMap *m_callHandlers;
    MUTEX m_callHandlerAccess;
    CONDITION m_startCondition;
@@ -139,6 +142,9 @@ class LIBNXMB_EXPORTABLE NXMBDispatcher
 	void workerThread();
 	static THREAD_RESULT THREAD_CALL workerThreadStarter(void *);
 
+	shared_ptr<NXMBSubscriberList> getSubscribers();
+	void replaceSubscriber(const TCHAR *id, NXMBSubscriber *subscriber, NXMBFilter *filter, int queueSize);
+
 public:
 	NXMBDispatcher();
 	~NXMBDispatcher();
@@ -146,7 +152,7 @@ class LIBNXMB_EXPORTABLE NXMBDispatcher
 	void postMessage(NXMBMessage *msg);
    bool call(const TCHAR *callName, const void *input, void *output);
 	
-	void addSubscriber(NXMBSubscriber *subscriber, NXMBFilter *filter);
+	void addSubscriber(NXMBSubscriber *subscriber, NXMBFilter *filter, int queueSize = 0);
 	void removeSubscriber(const TCHAR *id);
 
    void addCallHandler(const TCHAR *callName, NXMBCallHandler handler);
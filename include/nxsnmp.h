@@ -420,6 +420,35 @@ class LIBNXSNMP_EXPORTABLE SNMP_ObjectId
    static SNMP_ObjectId parse(const TCHAR *oid);
 };
 
+struct SNMP_ObjectIdTrieNode;
+
+/**
+ * OID prefix tree. Provides exact and longest prefix match in time proportional to OID length.
+ */
+class LIBNXSNMP_EXPORTABLE SNMP_ObjectIdTrie
+{
+   DISABLE_COPY_CTOR(SNMP_ObjectIdTrie)
+
+private:
+   SNMP_ObjectIdTrieNode *m_root;
+   int m_size;
+
+public:
+   SNMP_ObjectIdTrie();
+   ~SNMP_ObjectIdTrie();
+
+   bool put(const UINT32 *oid, size_t length, void *value);
+   bool put(const SNMP_ObjectId& oid, void *value) { return put(oid.value(), oid.length(), value); }
+
+   void *get(const UINT32 *oid, size_t length) const;
+   void *get(const SNMP_ObjectId& oid) const { return get(oid.value(), oid.length()); }
+   void *findLongestMatch(const UINT32 *oid, size_t length, size_t *matchLength = NULL) const;
+   void *findLongestMatch(const SNMP_ObjectId& oid, size_t *matchLength = NULL) const { return findLongestMatch(oid.value(), oid.length(), matchLength); }
+
+   int size() const { return m_size; }
+   bool isEmpty() const { return m_size == 0; }
+};
+
 /**
  * SNMP variable (varbind)
  */
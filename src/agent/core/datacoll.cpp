@@ -21,6 +21,7 @@
 **/
 
 #include "nxagentd.h"
+#include "dcbatch.h"
 
 #define DEBUG_TAG _T("dc")
 
@@ -1009,6 +1010,62 @@ static bool SessionComparator_Reconciliation(AbstractCommSession *session, void
    return false;
 }
 
+/**
+ * Send DCI data to server in bulk mode (only data elements of type "item" can be sent this way).
+ * Sets delivery status for each element (one of BULK_DATA_REC_xxx values) and returns request completion code.
+ */
+static uint32_t SendBulkData(CommSession *session, ObjectArray<DataElement> *elements, BYTE *status)
+{
+   memset(status, BULK_DATA_REC_RETRY, MAX_BULK_DATA_BLOCK_SIZE);
+
+   NXCPMessage msg(CMD_DCI_DATA, session->generateRequestId(), session->getProtocolVersion());
+   msg.setField(VID_BULK_RECONCILIATION, (INT16)1);
+   msg.setField(VID_NUM_ELEMENTS, (INT16)elements->size());
+   msg.setField(VID_TIMEOUT, g_dcReconciliationTimeout);
+
+   UINT32 fieldId = VID_ELEMENT_LIST_BASE;
+   for(int i = 0; i < elements->size(); i++)
+   {
+      elements->get(i)->fillReconciliationMessage(&msg, fieldId);
+      fieldId += 10;
+   }
+
+   if (!session->sendMessage(&msg))
+   {
+      nxlog_debug_tag(DEBUG_TAG, 4, _T("SendBulkData: communication error"));
+      return ERR_CONNECTION_BROKEN;
+   }
+
+   uint32_t rcc;
+   do
+   {
+      NXCPMessage *response = session->waitForMessage(CMD_REQUEST_COMPLETED, msg.getId(), g_dcReconciliationTimeout);
+      if (response != nullptr)
+      {
+         rcc = response->getFieldAsUInt32(VID_RCC);
+         if (rcc == ERR_SUCCESS)
+         {
+            response->getFieldAsBinary(VID_STATUS, status, MAX_BULK_DATA_BLOCK_SIZE);
+         }
+         else if (rcc == ERR_PROCESSING)
+         {
+            nxlog_debug_tag(DEBUG_TAG, 4, _T("SendBulkData: server is processing data (%d%% completed)"), response->getFieldAsInt32(VID_PROGRESS));
+         }
+         else
+         {
+            nxlog_debug_tag(DEBUG_TAG, 4, _T("SendBulkData: bulk send failed (%d)"), rcc);
+         }
+         delete response;
+      }
+      else
+      {
+         nxlog_debug_tag(DEBUG_TAG, 4, _T("SendBulkData: timeout on bulk send"));
+         rcc = ERR_REQUEST_TIMEOUT;
+      }
+   } while(rcc == ERR_PROCESSING);
+   return rcc;
+}
+
 /**
  * Data reconciliation thread
  */
@@ -1112,74 +1169,30 @@ static THREAD_RESULT THREAD_CALL ReconciliationThread(void *arg)
          {
             nxlog_debug_tag(DEBUG_TAG, 6, _T("ReconciliationThread: %d records to be sent in bulk mode"), bulkSendList.size());
 
-            NXCPMessage msg(CMD_DCI_DATA, session->generateRequestId(), session->getProtocolVersion());
-            msg.setField(VID_BULK_RECONCILIATION, (INT16)1);
-            msg.setField(VID_NUM_ELEMENTS, (INT16)bulkSendList.size());
-            msg.setField(VID_TIMEOUT, g_dcReconciliationTimeout);
-
-            UINT32 fieldId = VID_ELEMENT_LIST_BASE;
-            for(int i = 0; i < bulkSendList.size(); i++)
+            BYTE status[MAX_BULK_DATA_BLOCK_SIZE];
+            if (SendBulkData(session, &bulkSendList, status) == ERR_SUCCESS)
             {
-               bulkSendList.get(i)->fillReconciliationMessage(&msg, fieldId);
-               fieldId += 10;
-            }
+               s_serverSyncStatusLock.lock();
+               ServerSyncStatus *serverSyncStatus = s_serverSyncStatus.get(session->getServerId());
 
-            if (session->sendMessage(&msg))
-            {
-               UINT32 rcc;
-               do
+               // Check status for each data element
+               bulkSendList.setOwner(Ownership::False);
+               for(int i = 0; i < bulkSendList.size(); i++)
                {
-                  NXCPMessage *response = session->waitForMessage(CMD_REQUEST_COMPLETED, msg.getId(), g_dcReconciliationTimeout);
-                  if (response != NULL)
+                  DataElement *e = bulkSendList.get(i);
+                  if (status[i] != BULK_DATA_REC_RETRY)
                   {
-                     rcc = response->getFieldAsUInt32(VID_RCC);
-                     if (rcc == ERR_SUCCESS)
-                     {
-                        s_serverSyncStatusLock.lock();
-                        ServerSyncStatus *serverSyncStatus = s_serverSyncStatus.get(session->getServerId());
-
-                        // Check status for each data element
-                        BYTE status[MAX_BULK_DATA_BLOCK_SIZE];
-                        memset(status, 0, MAX_BULK_DATA_BLOCK_SIZE);
-                        response->getFieldAsBinary(VID_STATUS, status, MAX_BULK_DATA_BLOCK_SIZE);
-                        bulkSendList.setOwner(Ownership::False);
-                        for(int i = 0; i < bulkSendList.size(); i++)
-                        {
-                           DataElement *e = bulkSendList.get(i);
-                           if (status[i] != BULK_DATA_REC_RETRY)
-                           {
-                              deleteList.add(e);
-                              serverSyncStatus->queueSize--;
-                           }
-                           else
-                           {
-                              delete e;
-                           }
-                        }
-                        serverSyncStatus->lastSync = time(NULL);
-
-                        s_serverSyncStatusLock.unlock();
-                     }
-                     else if (rcc == ERR_PROCESSING)
-                     {
-                        nxlog_debug_tag(DEBUG_TAG, 4, _T("ReconciliationThread: server is processing data (%d%% completed)"), response->getFieldAsInt32(VID_PROGRESS));
-                     }
-                     else
-                     {
-                        nxlog_debug_tag(DEBUG_TAG, 4, _T("ReconciliationThread: bulk send failed (%d)"), rcc);
-                     }
-                     delete response;
+                     deleteList.add(e);
+                     serverSyncStatus->queueSize--;
                   }
                   else
                   {
-                     nxlog_debug_tag(DEBUG_TAG, 4, _T("ReconciliationThread: timeout on bulk send"));
-                     rcc = ERR_REQUEST_TIMEOUT;
+                     delete e;
                   }
-               } while(rcc == ERR_PROCESSING);
-            }
-            else
-            {
-               nxlog_debug_tag(DEBUG_TAG, 4, _T("ReconciliationThread: communication error"));
+               }
+               serverSyncStatus->lastSync = time(NULL);
+
+               s_serverSyncStatusLock.unlock();
             }
          }
 
@@ -1220,43 +1233,146 @@ static THREAD_RESULT THREAD_CALL ReconciliationThread(void *arg)
 static Queue s_dataSenderQueue;
 
 /**
- * Data sender
+ * Get sync status for given server, creating new one if needed. Must be called with server sync status lock held.
  */
-static THREAD_RESULT THREAD_CALL DataSender(void *arg)
+static ServerSyncStatus *GetServerSyncStatus(UINT64 serverId)
 {
-   nxlog_debug_tag(DEBUG_TAG, 1, _T("Data sender thread started"));
-   while(true)
+   ServerSyncStatus *status = s_serverSyncStatus.get(serverId);
+   if (status == nullptr)
    {
-      DataElement *e = static_cast<DataElement*>(s_dataSenderQueue.getOrBlock());
-      if (e == INVALID_POINTER_VALUE)
-         break;
+      status = new ServerSyncStatus(serverId);
+      s_serverSyncStatus.set(serverId, status);
+   }
+   return status;
+}
 
-      s_serverSyncStatusLock.lock();
-      ServerSyncStatus *status = s_serverSyncStatus.get(e->getServerId());
-      if (status == NULL)
+/**
+ * Sender for collected data. Server sync status lock is held only while status is checked
+ * or updated, and not while waiting for server response.
+ */
+class CollectedDataSender : public DataBatchSender<DataElement>
+{
+protected:
+   virtual bool isQueued(UINT64 serverId) override;
+   virtual void send(UINT64 serverId, ObjectArray<DataElement> *elements) override;
+   virtual void queue(UINT64 serverId, ObjectArray<DataElement> *elements) override;
+};
+
+/**
+ * Check if server has values waiting in local database
+ */
+bool CollectedDataSender::isQueued(UINT64 serverId)
+{
+   s_serverSyncStatusLock.lock();
+   bool queued = (GetServerSyncStatus(serverId)->queueSize > 0);
+   s_serverSyncStatusLock.unlock();
+   return queued;
+}
+
+/**
+ * Send data elements collected for same server. Items are sent in one bulk message if supported by server.
+ */
+void CollectedDataSender::send(UINT64 serverId, ObjectArray<DataElement> *elements)
+{
+   bool failed = false;
+   CommSession *session = static_cast<CommSession*>(FindServerSession(SessionComparator_Sender, &serverId));
+   if ((session != nullptr) && session->isBulkReconciliationSupported())
+   {
+      ObjectArray<DataElement> bulkSendList(elements->size(), 16, Ownership::False);
+      IntegerArray<int> positions(elements->size(), 16);
+      for(int i = 0; i < elements->size(); i++)
       {
-         status = new ServerSyncStatus(e->getServerId());
-         s_serverSyncStatus.set(e->getServerId(), status);
+         DataElement *e = elements->get(i);
+         if (e->getType() == DCO_TYPE_ITEM)
+         {
+            bulkSendList.add(e);
+            positions.add(i);
+         }
       }
 
-      if (status->queueSize == 0)
+      if (bulkSendList.size() > 0)
       {
-         if (!e->sendToServer(false))
+         nxlog_debug_tag(DEBUG_TAG, 7, _T("DataSender: %d records to be sent in bulk mode"), bulkSendList.size());
+         BYTE deliveryStatus[MAX_BULK_DATA_BLOCK_SIZE];
+         SendBulkData(session, &bulkSendList, deliveryStatus);
+         for(int i = 0; i < bulkSendList.size(); i++)
          {
-            status->queueSize++;
-            s_databaseWriterQueue.put(e);
-            e = NULL;
+            if (deliveryStatus[i] != BULK_DATA_REC_RETRY)
+            {
+               delete bulkSendList.get(i);
+               elements->set(positions.get(i), nullptr);
+            }
+            else
+            {
+               failed = true;
+            }
          }
       }
+   }
+   if (session != nullptr)
+      session->decRefCount();
+
+   for(int i = 0; (i < elements->size()) && !failed; i++)
+   {
+      DataElement *e = elements->get(i);
+      if (e == nullptr)
+         continue;
+
+      if (e->sendToServer(false))
+      {
+         delete e;
+         elements->set(i, nullptr);
+      }
       else
       {
-         status->queueSize++;
-         s_databaseWriterQueue.put(e);
-         e = NULL;
+         failed = true;
+      }
+   }
+}
+
+/**
+ * Put undelivered elements into local database
+ */
+void CollectedDataSender::queue(UINT64 serverId, ObjectArray<DataElement> *elements)
+{
+   s_serverSyncStatusLock.lock();
+   GetServerSyncStatus(serverId)->queueSize += elements->size();
+   for(int i = 0; i < elements->size(); i++)
+      s_databaseWriterQueue.put(elements->get(i));
+   s_serverSyncStatusLock.unlock();
+}
+
+/**
+ * Data sender. Sends all elements accumulated in queue at once, so values collected
+ * at same time are delivered to server in one bulk message.
+ */
+static THREAD_RESULT THREAD_CALL DataSender(void *arg)
+{
+   nxlog_debug_tag(DEBUG_TAG, 1, _T("Data sender thread started"));
+   ObjectArray<DataElement> batch(g_dcReconciliationBlockSize, 64, Ownership::False);
+   CollectedDataSender sender;
+   bool shutdown = false;
+   while(!shutdown)
+   {
+      DataElement *e = static_cast<DataElement*>(s_dataSenderQueue.getOrBlock());
+      if (e == INVALID_POINTER_VALUE)
+         break;
+
+      batch.add(e);
+      while(batch.size() < static_cast<int>(g_dcReconciliationBlockSize))
+      {
+         e = static_cast<DataElement*>(s_dataSenderQueue.get());
+         if (e == nullptr)
+            break;
+         if (e == INVALID_POINTER_VALUE)
+         {
+            shutdown = true;
+            break;
+         }
+         batch.add(e);
       }
-      s_serverSyncStatusLock.unlock();
 
-      delete e;
+      sender.process(&batch);
    }
    nxlog_debug_tag(DEBUG_TAG, 1, _T("Data sender thread stopped"));
    return THREAD_OK;
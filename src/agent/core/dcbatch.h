@@ -0,0 +1,103 @@
+/*
+** NetXMS multiplatform core agent
+** Copyright (C) 2003-2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: dcbatch.h
+**
+**/
+
+#ifndef _dcbatch_h_
+#define _dcbatch_h_
+
+#include <nms_common.h>
+#include <nms_util.h>
+
+/**
+ * Sender for batch of collected data elements. Elements are grouped by server (keeping
+ * collection order within group) and each group is either sent directly or, if server
+ * already has undelivered values in local queue, queued after them. No locks are held
+ * by the sender itself, so implementation can check and update server sync status under
+ * its own lock while network exchange is done without it. Element type should provide
+ * method getServerId().
+ */
+template<typename E> class DataBatchSender
+{
+protected:
+   /**
+    * Check if server has undelivered values in local queue
+    */
+   virtual bool isQueued(UINT64 serverId) = 0;
+
+   /**
+    * Send elements to server. Delivered elements should be destroyed and replaced with
+    * nullptr in the array. After first failure all following elements should be left
+    * undelivered to keep values in order.
+    */
+   virtual void send(UINT64 serverId, ObjectArray<E> *elements) = 0;
+
+   /**
+    * Put undelivered elements into local queue. Sender takes ownership of the elements.
+    */
+   virtual void queue(UINT64 serverId, ObjectArray<E> *elements) = 0;
+
+public:
+   virtual ~DataBatchSender() { }
+
+   /**
+    * Process batch. All elements are either delivered or queued, and batch is cleared.
+    */
+   void process(ObjectArray<E> *batch)
+   {
+      ObjectArray<E> elements(batch->size(), 16, Ownership::False);
+      ObjectArray<E> undelivered(batch->size(), 16, Ownership::False);
+      for(int i = 0; i < batch->size(); i++)
+      {
+         E *e = batch->get(i);
+         if (e == nullptr)
+            continue;
+
+         UINT64 serverId = e->getServerId();
+         for(int j = i; j < batch->size(); j++)
+         {
+            E *d = batch->get(j);
+            if ((d != nullptr) && (d->getServerId() == serverId))
+            {
+               elements.add(d);
+               batch->set(j, nullptr);
+            }
+         }
+
+         if (!isQueued(serverId))
+            send(serverId, &elements);
+
+         for(int j = 0; j < elements.size(); j++)
+         {
+            E *d = elements.get(j);
+            if (d != nullptr)
+               undelivered.add(d);
+         }
+         if (undelivered.size() > 0)
+            queue(serverId, &undelivered);
+
+         elements.clear();
+         undelivered.clear();
+      }
+      batch->clear();
+   }
+};
+
+#endif
@@ -21,6 +21,7 @@
 **/
 
 #include "nxagentd.h"
+#include "paramidx.h"
 
 #if defined(_WIN32)
 #include <intrin.h>
@@ -83,6 +84,9 @@ static NETXMS_SUBAGENT_LIST *m_pEnumList = NULL;
 static int m_iNumEnums = 0;
 static NETXMS_SUBAGENT_TABLE *m_pTableList = NULL;
 static int m_iNumTables = 0;
+static ParameterIndex s_paramIndex;
+static ParameterIndex s_listIndex;
+static ParameterIndex s_tableIndex;
 static UINT32 m_dwTimedOutRequests = 0;
 static UINT32 m_dwAuthenticationFailures = 0;
 static UINT32 m_dwProcessedRequests = 0;
@@ -533,6 +537,13 @@ BOOL InitParameterList()
 		memcpy(m_pTableList, m_stdTables, sizeof(NETXMS_SUBAGENT_TABLE) * m_iNumTables);
 	}
 
+   for(int i = 0; i < m_iNumParams; i++)
+      s_paramIndex.add(m_pParamList[i].name, i);
+   for(int i = 0; i < m_iNumEnums; i++)
+      s_listIndex.add(m_pEnumList[i].name, i);
+   for(int i = 0; i < m_iNumTables; i++)
+      s_tableIndex.add(m_pTableList[i].name, i);
+
    return TRUE;
 }
 
@@ -604,6 +615,7 @@ void AddParameter(const TCHAR *pszName, LONG (* fpHandler)(const TCHAR *, const
       m_pParamList[m_iNumParams].arg = pArg;
       m_pParamList[m_iNumParams].dataType = iDataType;
       nx_strncpy(m_pParamList[m_iNumParams].description, pszDescription, MAX_DB_STRING);
+      s_paramIndex.add(m_pParamList[m_iNumParams].name, m_iNumParams);
       m_iNumParams++;
    }
 }
@@ -632,6 +644,7 @@ void AddList(const TCHAR *name, LONG (* handler)(const TCHAR *, const TCHAR *, S
       _tcslcpy(m_pEnumList[m_iNumEnums].name, name, MAX_PARAM_NAME - 1);
       m_pEnumList[m_iNumEnums].handler = handler;
       m_pEnumList[m_iNumEnums].arg = arg;
+      s_listIndex.add(m_pEnumList[m_iNumEnums].name, m_iNumEnums);
       m_iNumEnums++;
    }
 }
@@ -669,6 +682,7 @@ void AddTable(const TCHAR *name, LONG (* handler)(const TCHAR *, const TCHAR *,
 		_tcslcpy(m_pTableList[m_iNumTables].description, description, MAX_DB_STRING);
       m_pTableList[m_iNumTables].numColumns = numColumns;
       m_pTableList[m_iNumTables].columns = columns;
+      s_tableIndex.add(m_pTableList[m_iNumTables].name, m_iNumTables);
       m_iNumTables++;
       nxlog_debug(7, _T("Table %s added (%d predefined columns, instance columns \"%s\")"), name, numColumns, instanceColumns);
    }
@@ -776,40 +790,37 @@ UINT32 GetParameterValue(const TCHAR *param, TCHAR *value, AbstractCommSession *
    UINT32 dwErrorCode;
 
    session->debugPrintf(5, _T("Requesting parameter \"%s\""), param);
-   for(i = 0; i < m_iNumParams; i++)
+   i = s_paramIndex.find(m_pParamList, param);
+   if (i != -1)
 	{
-      if (MatchString(m_pParamList[i].name, param, FALSE))
+      rc = m_pParamList[i].handler(param, m_pParamList[i].arg, value, session);
+      switch(rc)
       {
-         rc = m_pParamList[i].handler(param, m_pParamList[i].arg, value, session);
-         switch(rc)
-         {
-            case SYSINFO_RC_SUCCESS:
-               dwErrorCode = ERR_SUCCESS;
-               m_dwProcessedRequests++;
-               break;
-            case SYSINFO_RC_ERROR:
-               dwErrorCode = ERR_INTERNAL_ERROR;
-               m_dwFailedRequests++;
-               break;
-            case SYSINFO_RC_NO_SUCH_INSTANCE:
-               dwErrorCode = ERR_NO_SUCH_INSTANCE;
-               m_dwFailedRequests++;
-               break;
-            case SYSINFO_RC_UNSUPPORTED:
-               dwErrorCode = ERR_UNKNOWN_PARAMETER;
-               m_dwUnsupportedRequests++;
-               break;
-            default:
-               nxlog_write(NXLOG_ERROR, _T("Internal error: unexpected return code %d in GetParameterValue(\"%s\")"), rc, param);
-               dwErrorCode = ERR_INTERNAL_ERROR;
-               m_dwFailedRequests++;
-               break;
-         }
-         break;
+         case SYSINFO_RC_SUCCESS:
+            dwErrorCode = ERR_SUCCESS;
+            m_dwProcessedRequests++;
+            break;
+         case SYSINFO_RC_ERROR:
+            dwErrorCode = ERR_INTERNAL_ERROR;
+            m_dwFailedRequests++;
+            break;
+         case SYSINFO_RC_NO_SUCH_INSTANCE:
+            dwErrorCode = ERR_NO_SUCH_INSTANCE;
+            m_dwFailedRequests++;
+            break;
+         case SYSINFO_RC_UNSUPPORTED:
+            dwErrorCode = ERR_UNKNOWN_PARAMETER;
+            m_dwUnsupportedRequests++;
+            break;
+         default:
+            nxlog_write(NXLOG_ERROR, _T("Internal error: unexpected return code %d in GetParameterValue(\"%s\")"), rc, param);
+            dwErrorCode = ERR_INTERNAL_ERROR;
+            m_dwFailedRequests++;
+            break;
       }
 	}
 
-   if (i == m_iNumParams)
+   if (i == -1)
    {
 		rc = GetParameterValueFromExtProvider(param, value);
 		if (rc == SYSINFO_RC_SUCCESS)
@@ -823,7 +834,7 @@ UINT32 GetParameterValue(const TCHAR *param, TCHAR *value, AbstractCommSession *
 		}
    }
 
-   if ((dwErrorCode == ERR_UNKNOWN_PARAMETER) && (i == m_iNumParams))
+   if ((dwErrorCode == ERR_UNKNOWN_PARAMETER) && (i == -1))
    {
 		dwErrorCode = GetParameterValueFromAppAgent(param, value);
 		if (dwErrorCode == ERR_SUCCESS)
@@ -836,7 +847,7 @@ UINT32 GetParameterValue(const TCHAR *param, TCHAR *value, AbstractCommSession *
 		}
    }
 
-   if ((dwErrorCode == ERR_UNKNOWN_PARAMETER) && (i == m_iNumParams))
+   if ((dwErrorCode == ERR_UNKNOWN_PARAMETER) && (i == -1))
    {
 		dwErrorCode = GetParameterValueFromExtSubagent(param, value);
 		if (dwErrorCode == ERR_SUCCESS)
@@ -867,40 +878,37 @@ UINT32 GetListValue(const TCHAR *param, StringList *value, AbstractCommSession *
    UINT32 dwErrorCode;
 
    session->debugPrintf(5, _T("Requesting list \"%s\""), param);
-   for(i = 0; i < m_iNumEnums; i++)
+   i = s_listIndex.find(m_pEnumList, param);
+   if (i != -1)
 	{
-      if (MatchString(m_pEnumList[i].name, param, FALSE))
+      rc = m_pEnumList[i].handler(param, m_pEnumList[i].arg, value, session);
+      switch(rc)
       {
-         rc = m_pEnumList[i].handler(param, m_pEnumList[i].arg, value, session);
-         switch(rc)
-         {
-            case SYSINFO_RC_SUCCESS:
-               dwErrorCode = ERR_SUCCESS;
-               m_dwProcessedRequests++;
-               break;
-            case SYSINFO_RC_ERROR:
-               dwErrorCode = ERR_INTERNAL_ERROR;
-               m_dwFailedRequests++;
-               break;
-            case SYSINFO_RC_NO_SUCH_INSTANCE:
-               dwErrorCode = ERR_NO_SUCH_INSTANCE;
-               m_dwFailedRequests++;
-               break;
-            case SYSINFO_RC_UNSUPPORTED:
-               dwErrorCode = ERR_UNKNOWN_PARAMETER;
-               m_dwUnsupportedRequests++;
-               break;
-            default:
-               nxlog_write(NXLOG_ERROR, _T("Internal error: unexpected return code %d in GetListValue(\"%s\")"), rc, param);
-               dwErrorCode = ERR_INTERNAL_ERROR;
-               m_dwFailedRequests++;
-               break;
-         }
-         break;
+         case SYSINFO_RC_SUCCESS:
+            dwErrorCode = ERR_SUCCESS;
+            m_dwProcessedRequests++;
+            break;
+         case SYSINFO_RC_ERROR:
+            dwErrorCode = ERR_INTERNAL_ERROR;
+            m_dwFailedRequests++;
+            break;
+         case SYSINFO_RC_NO_SUCH_INSTANCE:
+            dwErrorCode = ERR_NO_SUCH_INSTANCE;
+            m_dwFailedRequests++;
+            break;
+         case SYSINFO_RC_UNSUPPORTED:
+            dwErrorCode = ERR_UNKNOWN_PARAMETER;
+            m_dwUnsupportedRequests++;
+            break;
+         default:
+            nxlog_write(NXLOG_ERROR, _T("Internal error: unexpected return code %d in GetListValue(\"%s\")"), rc, param);
+            dwErrorCode = ERR_INTERNAL_ERROR;
+            m_dwFailedRequests++;
+            break;
       }
 	}
 
-	if (i == m_iNumEnums)
+	if (i == -1)
    {
 		dwErrorCode = GetListValueFromExtSubagent(param, value);
 		if (dwErrorCode == ERR_SUCCESS)
@@ -931,50 +939,47 @@ UINT32 GetTableValue(const TCHAR *param, Table *value, AbstractCommSession *sess
    UINT32 dwErrorCode;
 
    session->debugPrintf(5, _T("Requesting table \"%s\""), param);
-   for(i = 0; i < m_iNumTables; i++)
+   i = s_tableIndex.find(m_pTableList, param);
+   if (i != -1)
 	{
-      if (MatchString(m_pTableList[i].name, param, FALSE))
+      // pre-fill table columns if specified in table definition
+      if (m_pTableList[i].numColumns > 0)
       {
-         // pre-fill table columns if specified in table definition
-         if (m_pTableList[i].numColumns > 0)
+         for(int c = 0; c < m_pTableList[i].numColumns; c++)
          {
-            for(int c = 0; c < m_pTableList[i].numColumns; c++)
-            {
-               NETXMS_SUBAGENT_TABLE_COLUMN *col = &m_pTableList[i].columns[c];
-               value->addColumn(col->name, col->dataType, col->displayName, col->isInstance);
-            }
+            NETXMS_SUBAGENT_TABLE_COLUMN *col = &m_pTableList[i].columns[c];
+            value->addColumn(col->name, col->dataType, col->displayName, col->isInstance);
          }
+      }
 
-         rc = m_pTableList[i].handler(param, m_pTableList[i].arg, value, session);
-         switch(rc)
-         {
-            case SYSINFO_RC_SUCCESS:
-               dwErrorCode = ERR_SUCCESS;
-               m_dwProcessedRequests++;
-               break;
-            case SYSINFO_RC_ERROR:
-               dwErrorCode = ERR_INTERNAL_ERROR;
-               m_dwFailedRequests++;
-               break;
-            case SYSINFO_RC_NO_SUCH_INSTANCE:
-               dwErrorCode = ERR_NO_SUCH_INSTANCE;
-               m_dwFailedRequests++;
-               break;
-            case SYSINFO_RC_UNSUPPORTED:
-               dwErrorCode = ERR_UNKNOWN_PARAMETER;
-               m_dwUnsupportedRequests++;
-               break;
-            default:
-               nxlog_write(NXLOG_ERROR, _T("Internal error: unexpected return code %d in GetTableValue(\"%s\")"), rc, param);
-               dwErrorCode = ERR_INTERNAL_ERROR;
-               m_dwFailedRequests++;
-               break;
-         }
-         break;
+      rc = m_pTableList[i].handler(param, m_pTableList[i].arg, value, session);
+      switch(rc)
+      {
+         case SYSINFO_RC_SUCCESS:
+            dwErrorCode = ERR_SUCCESS;
+            m_dwProcessedRequests++;
+            break;
+         case SYSINFO_RC_ERROR:
+            dwErrorCode = ERR_INTERNAL_ERROR;
+            m_dwFailedRequests++;
+            break;
+         case SYSINFO_RC_NO_SUCH_INSTANCE:
+            dwErrorCode = ERR_NO_SUCH_INSTANCE;
+            m_dwFailedRequests++;
+            break;
+         case SYSINFO_RC_UNSUPPORTED:
+            dwErrorCode = ERR_UNKNOWN_PARAMETER;
+            m_dwUnsupportedRequests++;
+            break;
+         default:
+            nxlog_write(NXLOG_ERROR, _T("Internal error: unexpected return code %d in GetTableValue(\"%s\")"), rc, param);
+            dwErrorCode = ERR_INTERNAL_ERROR;
+            m_dwFailedRequests++;
+            break;
       }
 	}
 
-	if (i == m_iNumTables)
+	if (i == -1)
    {
 		dwErrorCode = GetTableValueFromExtSubagent(param, value);
 		if (dwErrorCode == ERR_SUCCESS)
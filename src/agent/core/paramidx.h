@@ -0,0 +1,106 @@
+/*
+** NetXMS multiplatform core agent
+** Copyright (C) 2003-2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: paramidx.h
+**
+**/
+
+#ifndef _paramidx_h_
+#define _paramidx_h_
+
+#include <nms_common.h>
+#include <nms_util.h>
+
+/**
+ * Index for handler lookup by requested parameter, list, or table name. Handler names
+ * without wildcards before opening parenthesis are indexed by that part of the name
+ * (case insensitive). All other handlers are checked for each request. Candidates are
+ * checked in registration order, so lookup result is the same as for linear search.
+ */
+class ParameterIndex
+{
+   DISABLE_COPY_CTOR(ParameterIndex)
+
+private:
+   StringObjectMap<IntegerArray<int>> m_names;
+   IntegerArray<int> m_wildcards;
+
+   static size_t keyLength(const TCHAR *name)
+   {
+      const TCHAR *p = _tcschr(name, _T('('));
+      return (p != nullptr) ? p - name : _tcslen(name);
+   }
+
+public:
+   ParameterIndex() : m_names(Ownership::True), m_wildcards(64, 64) { }
+
+   /**
+    * Add handler with given name and position in handler list. Handlers should be added
+    * in the same order as they appear in the list.
+    */
+   void add(const TCHAR *name, int index)
+   {
+      size_t len = keyLength(name);
+      for(size_t i = 0; i < len; i++)
+      {
+         if ((name[i] == _T('*')) || (name[i] == _T('?')))
+         {
+            m_wildcards.add(index);
+            return;
+         }
+      }
+
+      IntegerArray<int> *indexes = m_names.get(name, len);
+      if (indexes == nullptr)
+      {
+         TCHAR *key = MemAllocString(len + 1);
+         memcpy(key, name, len * sizeof(TCHAR));
+         key[len] = 0;
+         indexes = new IntegerArray<int>(4, 4);
+         m_names.setPreallocated(key, indexes);
+      }
+      indexes->add(index);
+   }
+
+   /**
+    * Find first handler in given list which matches requested name. Returns index of
+    * handler in the list or -1 if no matching handler was found.
+    */
+   template<typename T> int find(const T *list, const TCHAR *name) const
+   {
+      const IntegerArray<int> *indexes = m_names.get(name, keyLength(name));
+      int ncount = (indexes != nullptr) ? indexes->size() : 0;
+      int wcount = m_wildcards.size();
+      for(int n = 0, w = 0; (n < ncount) || (w < wcount);)
+      {
+         int index;
+         if ((w == wcount) || ((n < ncount) && (indexes->get(n) < m_wildcards.get(w))))
+            index = indexes->get(n++);
+         else
+            index = m_wildcards.get(w++);
+         if (MatchString(list[index].name, name, false))
+            return index;
+      }
+      return -1;
+   }
+
+   int getIndexedCount() const { return m_names.size(); }
+   int getWildcardCount() const { return m_wildcards.size(); }
+};
+
+#endif
@@ -946,7 +946,11 @@ void CommSession::getTable(NXCPMessage *pRequest, NXCPMessage *pMsg)
    pMsg->setField(VID_RCC, dwErrorCode);
    if (dwErrorCode == ERR_SUCCESS)
    {
-		value.fillMessage(*pMsg, 0, -1);	// no row limit
+      // Servers supporting binary table format indicate it in request
+      if (pRequest->getFieldAsBoolean(VID_ACCEPT_BINARY_TABLE))
+         value.fillMessageBinary(*pMsg);
+      else
+         value.fillMessage(*pMsg, 0, -1);	// no row limit
    }
 }
 
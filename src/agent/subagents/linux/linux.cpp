@@ -21,6 +21,7 @@
 **/
 
 #include "linux_subagent.h"
+#include "procsnap.h"
 #if HAVE_SYS_REBOOT_H
 #include <sys/reboot.h>
 #endif
@@ -105,6 +106,7 @@ static bool SubAgentInit(Config *config)
 	StartCpuUsageCollector();
 	StartIoStatCollector();
 	InitDrbdCollector();
+   SetProcessSnapshotOptions("/proc", config->getValueAsUInt(_T("/Linux/ProcessSnapshotMaxAge"), 1000));
 	return true;
 }
 
@@ -19,11 +19,7 @@
 **/
 
 #include "linux_subagent.h"
-
-/**
- * Maximum possible length of process name
- */
-#define MAX_PROCESS_NAME_LEN  32
+#include "procsnap.h"
 
 /**
  * File descriptor
@@ -63,37 +59,13 @@ class FileDescriptor
 /**
  * Process entry
  */
-class Process
+class Process : public ProcessSnapshotEntry
 {
 public:
-	UINT32 pid;
-	char name[MAX_PROCESS_NAME_LEN];
-	UINT32 parent;          // PID of parent process
-	UINT32 group;           // Group ID
-	char state;             // Process state
-	long threads;           // Number of threads
-	unsigned long ktime;    // Number of ticks spent in kernel mode
-	unsigned long utime;    // Number of ticks spent in user mode
-	unsigned long vmsize;   // Size of process's virtual memory in bytes
-	long rss;               // Process's resident set size in pages
-	unsigned long minflt;   // Number of minor page faults
-	unsigned long majflt;   // Number of major page faults
    ObjectArray<FileDescriptor> *fd;
    
-   Process(UINT32 _pid, const char *_name)
+   Process(const ProcessSnapshotEntry *p) : ProcessSnapshotEntry(*p)
    {
-      pid = _pid;
-      strlcpy(name, _name, MAX_PROCESS_NAME_LEN);
-      parent = 0;
-      group = 0;
-      state = '?';
-      threads = 0;
-      ktime = 0;
-      utime = 0;
-      vmsize = 0;
-      rss = 0;
-      minflt = 0;
-      majflt = 0;
       fd = NULL;
    }
    
@@ -103,31 +75,6 @@ class Process
    }
 };
 
-/**
- * Filter for reading only pid directories from /proc
- */
-static int ProcFilter(const struct dirent *pEnt)
-{
-	char *pTmp;
-
-	if (pEnt == NULL)
-	{
-		return 0; // ignore file
-	}
-
-	pTmp = (char *)pEnt->d_name;
-	while (*pTmp != 0)
-	{
-		if (*pTmp < '0' || *pTmp > '9')
-		{
-			return 0; // skip
-		}
-		pTmp++;
-	}
-
-	return 1;
-}
-
 /**
  * Read handles
  */
@@ -136,23 +83,23 @@ static ObjectArray<FileDescriptor> *ReadProcessHandles(UINT32 pid)
    char path[MAX_PATH];
    snprintf(path, MAX_PATH, "/proc/%u/fd", pid);
    
-	struct dirent **handles;
-	int count = scandir(path, &handles, ProcFilter, alphasort);
-   if (count < 0)
+   DIR *dir = opendir(path);
+   if (dir == NULL)
       return NULL;
       
-   ObjectArray<FileDescriptor> *fd = new ObjectArray<FileDescriptor>(count, 16, Ownership::True);
-   while(count-- > 0)
+   ObjectArray<FileDescriptor> *fd = new ObjectArray<FileDescriptor>(64, 64, Ownership::True);
+   struct dirent *e;
+   while((e = readdir(dir)) != NULL)
    {
-      fd->add(new FileDescriptor(handles[count], path));
-      free(handles[count]);
+      if ((e->d_name[0] >= '0') && (e->d_name[0] <= '9'))
+         fd->add(new FileDescriptor(e, path));
    }
-   free(handles);
+   closedir(dir);
    return fd;
 }
 
 /**
- * Read process information from /proc system
+ * Read process information from shared process snapshot
  * Parameters:
  *    plist    - array to fill, can be NULL
  *    procNameFilter - If not NULL, only processes with matched name will
@@ -178,196 +125,54 @@ static int ProcRead(ObjectArray<Process> *plist, const char *procNameFilter, con
       getpwnam_r(procUser, &pwd, buf, 16384, &result);
       if (result == NULL)
       {
+         free(buf);
          return -2; //If user is set, but it's not found return unsupported
       }
       procUid = pwd.pw_uid;
       free(buf);
    }
 
-	struct dirent **nameList;
-	int count = scandir("/proc", &nameList, ProcFilter, alphasort);
-   if (count < 0)
+   shared_ptr<ProcessSnapshot> snapshot = AcquireProcessSnapshot();
+   if (snapshot == nullptr)
       return -1;
-   if (count == 0)
-   {
-      free(nameList);
-      return -1;  // consider 0 as error as there should not be 0 processes
-   }
-   
+
    // get process count without filtering, we can skip long loop
 	if ((plist == NULL) && (procNameFilter == NULL) && (cmdLineFilter == NULL) && (procUser == NULL))
-	{
-      for(int i = 0; i < count; i++)
-         free(nameList[i]);
-      free(nameList);
-		return count;
-	}
+		return snapshot->size();
 
+   bool nameFilter = (procNameFilter != NULL) && (*procNameFilter != 0);
+   bool cmdFilter = (cmdLineFilter != NULL) && (*cmdLineFilter != 0);
    int found = 0;
-   while(count-- > 0)
+   for(int i = 0; i < snapshot->size(); i++)
    {
-      bool procFound = false;
-      bool cmdFound = false;
-      bool uidFound = true;
-      char *pProcName = NULL;
-      char *pProcStat = NULL;
-      unsigned int nPid = 0;
-
-      char fileName[MAX_PATH], procNameBuffer[MAX_PROCESS_NAME_LEN + 1];
-
-      snprintf(fileName, MAX_PATH, "/proc/%s/comm", nameList[count]->d_name);
-      int hFile = _open(fileName, O_RDONLY);
-      if (hFile != -1)
+      const ProcessSnapshotEntry *p = snapshot->get(i);
+      if (nameFilter)
       {
-         ssize_t bytes = _read(hFile, procNameBuffer, sizeof(procNameBuffer) - 1);
-         if (bytes > 0)
+         if (cmdLineFilter == NULL) // use old style compare
          {
-            procNameBuffer[bytes] = 0;
-            char *p = strrchr(procNameBuffer, '\n');
-            if (p != NULL)
-               *p = 0;
-            pProcName = procNameBuffer;
+            if (strcmp(p->name, procNameFilter))
+               continue;
          }
-         _close(hFile);
-      }
-
-      snprintf(fileName, MAX_PATH, "/proc/%s/stat", nameList[count]->d_name);
-      hFile = _open(fileName, O_RDONLY);
-      if (hFile != -1)
-      {
-         char szProcStat[1024];
-         ssize_t bytes = _read(hFile, szProcStat, sizeof(szProcStat) - 1);
-         if (bytes > 0)
+         else if (!RegexpMatchA(p->name, procNameFilter, FALSE))
          {
-            szProcStat[bytes] = 0;
-            if (sscanf(szProcStat, "%u ", &nPid) == 1)
-            {
-               char *procNamePos = strchr(szProcStat, '(');
-               if (procNamePos != NULL)
-               {
-                  if (pProcName != NULL)
-                  {
-                     // Already got process name from comm file
-                     pProcStat = procNamePos + strlen(pProcName) + 2;   // process name plus 2 brackets
-                  }
-                  else
-                  {
-                     pProcStat = strchr(procNamePos, ')');
-                     if (pProcStat != NULL)
-                     {
-                        pProcName = procNamePos + 1;
-                        *pProcStat = 0;
-                        pProcStat++;
-                     }
-                  }
-                  if (pProcName != NULL)
-                  {
-                     if ((procNameFilter != NULL) && (*procNameFilter != 0))
-                     {
-                        if (cmdLineFilter == NULL) // use old style compare
-                           procFound = (strcmp(pProcName, procNameFilter) == 0);
-                        else
-                           procFound = RegexpMatchA(pProcName, procNameFilter, FALSE);
-                     }
-                     else
-                     {
-                        procFound = true;
-                     }
-                  }
-               } // pProcName != NULL
-            }
-         } // _read
-         _close(hFile);
-      } // hFile
-
-      if (procUid != -1)
-      {
-         snprintf(fileName, MAX_PATH, "/proc/%s/", nameList[count]->d_name);
-         struct stat fileInfo;
-         if (stat(fileName, &fileInfo) == 0)
-            uidFound = fileInfo.st_uid == procUid;
-         else
-            uidFound = false;
-      }
-
-      if ((cmdLineFilter != NULL) && (*cmdLineFilter != 0))
-      {
-         snprintf(fileName, MAX_PATH, "/proc/%s/cmdline", nameList[count]->d_name);
-         hFile = _open(fileName, O_RDONLY);
-         if (hFile != -1)
-         {
-            size_t len = 0, pos = 0;
-            char *processCmdLine = (char *)malloc(4096);
-            while(true)
-            {
-               ssize_t bytes = _read(hFile, &processCmdLine[pos], 4096);
-               if (bytes < 0)
-                  bytes = 0;
-               len += bytes;
-               if (bytes < 1024)
-               {
-                  processCmdLine[len] = 0;
-                  break;
-               }
-               pos += bytes;
-               processCmdLine = (char *)realloc(processCmdLine, pos + 4096);
-            }
-            if (len > 0)
-            {
-               // got a valid record in format: argv[0]\x00argv[1]\x00...
-               // Note: to behave identicaly on different platforms,
-               // full command line including argv[0] should be matched
-               // replace 0x00 with spaces
-               for(int j = 0; j < len - 1; j++)
-               {
-                  if (processCmdLine[j] == 0)
-                  {
-                     processCmdLine[j] = ' ';
-                  }
-               }
-               cmdFound = RegexpMatchA(processCmdLine, cmdLineFilter, TRUE);
-            }
-            else
-            {
-               cmdFound = RegexpMatchA("", cmdLineFilter, TRUE);
-            }
-            _close(hFile);
-            free(processCmdLine);
-         } // hFile != -1
-         else
-         {
-            cmdFound = RegexpMatchA("", cmdLineFilter, TRUE);
+            continue;
          }
-      } // cmdLineFilter
-      else
-      {
-         cmdFound = true;
       }
 
-      if (procFound && cmdFound && uidFound)
+      if ((procUid != -1) && (p->uid != procUid))
+         continue;
+
+      if (cmdFilter && !RegexpMatchA(snapshot->getCommandLine(p), cmdLineFilter, TRUE))
+         continue;
+
+      if (plist != NULL)
       {
-         if ((plist != NULL) && (pProcName != NULL))
-         {
-            Process *p = new Process(nPid, pProcName);
-            // Parse rest of /proc/pid/stat file
-            if (pProcStat != NULL)
-            {
-               if (sscanf(pProcStat, " %c %d %d %*d %*d %*d %*u %lu %*u %lu %*u %lu %lu %*u %*u %*d %*d %ld %*d %*u %lu %ld ",
-                          &p->state, &p->parent, &p->group, &p->minflt, &p->majflt,
-                          &p->utime, &p->ktime, &p->threads, &p->vmsize, &p->rss) != 10)
-               {
-                  AgentWriteDebugLog(2, _T("Error parsing /proc/%u/stat"), nPid);
-               }
-            }
-            p->fd = readHandles ? ReadProcessHandles(nPid) : NULL;
-            plist->add(p);
-         }
-         found++;
+         Process *process = new Process(p);
+         process->fd = readHandles ? ReadProcessHandles(p->pid) : NULL;
+         plist->add(process);
       }
-
-      free(nameList[count]);
+      found++;
    }
-   free(nameList);
 	return found;
 }
 
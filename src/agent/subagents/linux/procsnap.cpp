@@ -0,0 +1,234 @@
+/*
+** NetXMS subagent for GNU/Linux
+** Copyright (C) 2004-2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: procsnap.cpp
+**
+**/
+
+#include "procsnap.h"
+#include <dirent.h>
+
+#define DEBUG_TAG_PROCSNAP _T("sa.linux.proc")
+
+/**
+ * Snapshot cache
+ */
+static Mutex s_snapshotLock;
+static shared_ptr<ProcessSnapshot> s_snapshot;
+static char s_procfs[MAX_PATH] = "/proc";
+static uint32_t s_maxAge = 1000;
+static uint64_t s_cacheHits = 0;
+static uint64_t s_cacheMisses = 0;
+
+/**
+ * Create empty snapshot
+ */
+ProcessSnapshot::ProcessSnapshot() : m_processes(256, 256)
+{
+   m_cmdLinesAllocated = 65536;
+   m_cmdLines = MemAllocArrayNoInit<char>(m_cmdLinesAllocated);
+   m_cmdLinesSize = 0;
+   m_timestamp = GetCurrentTimeMs();
+}
+
+/**
+ * Snapshot destructor
+ */
+ProcessSnapshot::~ProcessSnapshot()
+{
+   MemFree(m_cmdLines);
+}
+
+/**
+ * Read process command line into command line pool. Arguments are separated by spaces.
+ * Returns offset of command line in the pool.
+ */
+size_t ProcessSnapshot::readCommandLine(const char *path)
+{
+   size_t offset = m_cmdLinesSize;
+   int fh = _open(path, O_RDONLY);
+   if (fh != -1)
+   {
+      while(true)
+      {
+         if (m_cmdLinesAllocated - m_cmdLinesSize < 4097)
+         {
+            m_cmdLinesAllocated += 65536;
+            m_cmdLines = MemReallocArray(m_cmdLines, m_cmdLinesAllocated);
+         }
+         ssize_t bytes = _read(fh, &m_cmdLines[m_cmdLinesSize], 4096);
+         if (bytes <= 0)
+            break;
+         m_cmdLinesSize += bytes;
+      }
+      _close(fh);
+
+      // got a valid record in format: argv[0]\x00argv[1]\x00...
+      // Note: to behave identicaly on different platforms,
+      // full command line including argv[0] should be matched
+      // replace 0x00 with spaces
+      for(size_t i = offset; i + 1 < m_cmdLinesSize; i++)
+      {
+         if (m_cmdLines[i] == 0)
+            m_cmdLines[i] = ' ';
+      }
+   }
+   if (m_cmdLinesSize == m_cmdLinesAllocated)
+   {
+      // Pool can be full if command line file cannot be opened
+      m_cmdLinesAllocated += 65536;
+      m_cmdLines = MemReallocArray(m_cmdLines, m_cmdLinesAllocated);
+   }
+   m_cmdLines[m_cmdLinesSize++] = 0;
+   if ((m_cmdLinesSize - offset > 1) && (m_cmdLines[m_cmdLinesSize - 2] == 0))
+      m_cmdLinesSize--;    // keep single terminating zero
+   return offset;
+}
+
+/**
+ * Read information about single process. Returns false if process information
+ * cannot be read (usually because process already terminated).
+ */
+bool ProcessSnapshot::readProcess(const char *procfs, const char *pid, ProcessSnapshotEntry *p)
+{
+   char path[MAX_PATH];
+   snprintf(path, MAX_PATH, "%s/%s/stat", procfs, pid);
+   int fh = _open(path, O_RDONLY);
+   if (fh == -1)
+      return false;
+
+   char buffer[1024];
+   ssize_t bytes = _read(fh, buffer, sizeof(buffer) - 1);
+
+   // Owner of stat file is the same as owner of process directory
+   struct stat st;
+   p->uid = (fstat(fh, &st) == 0) ? st.st_uid : static_cast<uid_t>(-1);
+   _close(fh);
+   if (bytes <= 0)
+      return false;
+   buffer[bytes] = 0;
+
+   // Process name is enclosed in brackets and can contain spaces and brackets itself
+   char *nameStart = strchr(buffer, '(');
+   char *nameEnd = strrchr(buffer, ')');
+   if ((nameStart == nullptr) || (nameEnd == nullptr) || (nameEnd < nameStart))
+      return false;
+
+   p->pid = strtoul(buffer, nullptr, 10);
+   *nameEnd = 0;
+   strlcpy(p->name, nameStart + 1, MAX_PROCESS_NAME_LEN);
+   if (sscanf(nameEnd + 1, " %c %d %d %*d %*d %*d %*u %lu %*u %lu %*u %lu %lu %*u %*u %*d %*d %ld %*d %*u %lu %ld ",
+              &p->state, &p->parent, &p->group, &p->minflt, &p->majflt,
+              &p->utime, &p->ktime, &p->threads, &p->vmsize, &p->rss) != 10)
+   {
+      nxlog_debug_tag(DEBUG_TAG_PROCSNAP, 2, _T("Error parsing %hs"), path);
+   }
+
+   snprintf(path, MAX_PATH, "%s/%s/cmdline", procfs, pid);
+   p->cmdLine = readCommandLine(path);
+   return true;
+}
+
+/**
+ * Create snapshot of process table using given procfs mount point. Returns NULL on failure.
+ */
+ProcessSnapshot *ProcessSnapshot::create(const char *procfs)
+{
+   DIR *dir = opendir(procfs);
+   if (dir == nullptr)
+   {
+      nxlog_debug_tag(DEBUG_TAG_PROCSNAP, 4, _T("ProcessSnapshot::create: cannot open %hs (%s)"), procfs, _tcserror(errno));
+      return nullptr;
+   }
+
+   ProcessSnapshot *snapshot = new ProcessSnapshot();
+   struct dirent *e;
+   while((e = readdir(dir)) != nullptr)
+   {
+      const char *p = e->d_name;
+      while((*p >= '0') && (*p <= '9'))
+         p++;
+      if ((*p != 0) || (p == e->d_name))
+         continue;   // not a process directory
+
+      ProcessSnapshotEntry process;
+      memset(&process, 0, sizeof(process));
+      process.state = '?';
+      if (snapshot->readProcess(procfs, e->d_name, &process))
+         snapshot->m_processes.add(process);
+   }
+   closedir(dir);
+
+   // consider 0 as error as there should not be 0 processes
+   if (snapshot->m_processes.isEmpty())
+   {
+      delete snapshot;
+      return nullptr;
+   }
+   return snapshot;
+}
+
+/**
+ * Get current process snapshot. New snapshot is created if cached one is older than
+ * configured maximum age. Concurrent callers wait for single snapshot to be created.
+ * Returns NULL if process table cannot be read.
+ */
+shared_ptr<ProcessSnapshot> AcquireProcessSnapshot()
+{
+   s_snapshotLock.lock();
+   if ((s_snapshot == nullptr) || (GetCurrentTimeMs() - s_snapshot->getTimestamp() >= static_cast<int64_t>(s_maxAge)))
+   {
+      int64_t startTime = GetCurrentTimeMs();
+      s_snapshot = shared_ptr<ProcessSnapshot>(ProcessSnapshot::create(s_procfs));
+      s_cacheMisses++;
+      nxlog_debug_tag(DEBUG_TAG_PROCSNAP, 7, _T("Process snapshot created in %d ms (%d processes, cache hits/misses ") UINT64_FMT _T("/") UINT64_FMT _T(")"),
+               static_cast<int>(GetCurrentTimeMs() - startTime), (s_snapshot != nullptr) ? s_snapshot->size() : 0,
+               s_cacheHits, s_cacheMisses);
+   }
+   else
+   {
+      s_cacheHits++;
+   }
+   shared_ptr<ProcessSnapshot> snapshot = s_snapshot;
+   s_snapshotLock.unlock();
+   return snapshot;
+}
+
+/**
+ * Set procfs mount point and maximum snapshot age in milliseconds (0 disables caching)
+ */
+void SetProcessSnapshotOptions(const char *procfs, uint32_t maxAge)
+{
+   s_snapshotLock.lock();
+   strlcpy(s_procfs, procfs, MAX_PATH);
+   s_maxAge = maxAge;
+   s_snapshot.reset();
+   s_snapshotLock.unlock();
+   nxlog_debug_tag(DEBUG_TAG_PROCSNAP, 3, _T("Process snapshot: procfs=%hs, max age %u ms"), procfs, maxAge);
+}
+
+/**
+ * Get snapshot cache statistics
+ */
+void GetProcessSnapshotStats(uint64_t *hits, uint64_t *misses)
+{
+   s_snapshotLock.lock();
+   *hits = s_cacheHits;
+   *misses = s_cacheMisses;
+   s_snapshotLock.unlock();
+}
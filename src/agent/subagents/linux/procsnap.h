@@ -0,0 +1,90 @@
+/*
+** NetXMS subagent for GNU/Linux
+** Copyright (C) 2004-2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: procsnap.h
+**
+**/
+
+#ifndef _procsnap_h_
+#define _procsnap_h_
+
+#include <nms_common.h>
+#include <nms_util.h>
+
+/**
+ * Maximum possible length of process name
+ */
+#define MAX_PROCESS_NAME_LEN  32
+
+/**
+ * Process information from /proc/<pid>/stat
+ */
+struct ProcessSnapshotEntry
+{
+   uint32_t pid;
+   uint32_t parent;        // PID of parent process
+   uint32_t group;         // Group ID
+   uid_t uid;              // Owner of /proc/<pid> directory
+   char state;             // Process state
+   char name[MAX_PROCESS_NAME_LEN];
+   long threads;           // Number of threads
+   unsigned long ktime;    // Number of ticks spent in kernel mode
+   unsigned long utime;    // Number of ticks spent in user mode
+   unsigned long vmsize;   // Size of process's virtual memory in bytes
+   long rss;               // Process's resident set size in pages
+   unsigned long minflt;   // Number of minor page faults
+   unsigned long majflt;   // Number of major page faults
+   size_t cmdLine;         // Offset of command line in snapshot's command line pool
+};
+
+/**
+ * Snapshot of process table. Snapshot is immutable after creation and can be
+ * used by multiple threads at once.
+ */
+class ProcessSnapshot
+{
+   DISABLE_COPY_CTOR(ProcessSnapshot)
+
+private:
+   StructArray<ProcessSnapshotEntry> m_processes;
+   char *m_cmdLines;
+   size_t m_cmdLinesSize;
+   size_t m_cmdLinesAllocated;
+   int64_t m_timestamp;
+
+   ProcessSnapshot();
+
+   bool readProcess(const char *procfs, const char *pid, ProcessSnapshotEntry *p);
+   size_t readCommandLine(const char *path);
+
+public:
+   ~ProcessSnapshot();
+
+   static ProcessSnapshot *create(const char *procfs);
+
+   int size() const { return m_processes.size(); }
+   const ProcessSnapshotEntry *get(int index) const { return m_processes.get(index); }
+   const char *getCommandLine(const ProcessSnapshotEntry *p) const { return &m_cmdLines[p->cmdLine]; }
+   int64_t getTimestamp() const { return m_timestamp; }
+};
+
+shared_ptr<ProcessSnapshot> AcquireProcessSnapshot();
+void SetProcessSnapshotOptions(const char *procfs, uint32_t maxAge);
+void GetProcessSnapshotStats(uint64_t *hits, uint64_t *misses);
+
+#endif
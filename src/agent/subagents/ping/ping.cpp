@@ -42,25 +42,15 @@ static UINT32 s_options = PING_OPT_ALLOW_AUTOCONFIGURE;
 #define EXP       2037            /* 1/exp(5sec/15min) */
 #define CALC_EMA(s, y) do { s *= EXP; s += y * (FP_1 - EXP); s >>= FP_SHIFT; } while(0)
 
+static void Poller(PING_TARGET *target);
+
 /**
- * Poller
+ * Process ping result
  */
-static void Poller(PING_TARGET *target)
+static void ProcessPingResult(PING_TARGET *target)
 {
 	bool unreachable = false;
-	INT64 startTime = GetCurrentTimeMs();
-
-   if (target->automatic && (startTime / 1000 - target->lastDataRead > s_maxTargetInactivityTime))
-   {
-      nxlog_debug_tag(DEBUG_TAG, 3, _T("Target %s (%s) removed because of inactivity"), target->name, (const TCHAR *)target->ipAddr.toString());
-      s_targetLock.lock();
-      s_targets.remove(target);
-      s_targetLock.unlock();
-      return;
-   }
-
-retry:
-   if (IcmpPing(target->ipAddr, 1, s_timeout, &target->lastRTT, target->packetSize, target->dontFragment) != ICMP_SUCCESS)
+   if (target->pingResult != ICMP_SUCCESS)
    {
       InetAddress ip = InetAddress::resolveHostName(target->dnsName);
       if (!ip.equals(target->ipAddr))
@@ -69,10 +59,13 @@ static void Poller(PING_TARGET *target)
          nxlog_debug_tag(DEBUG_TAG, 6, _T("IP address for target %s changed from %s to %s"), target->name,
                   target->ipAddr.toString(ip1), ip.toString(ip2));
          target->ipAddr = ip;
-         goto retry;
+         target->pingResult = IcmpPingShared(target->ipAddr, 1, s_timeout, &target->lastRTT, target->packetSize, target->dontFragment);
+      }
+      if (target->pingResult != ICMP_SUCCESS)
+      {
+         target->lastRTT = 10000;
+         unreachable = true;
       }
-      target->lastRTT = 10000;
-      unreachable = TRUE;
    }
 
    target->history[target->bufPos++] = target->lastRTT;
@@ -156,12 +149,47 @@ static void Poller(PING_TARGET *target)
       }
    }
 
-   UINT32 elapsedTime = static_cast<UINT32>(GetCurrentTimeMs() - startTime);
+   UINT32 elapsedTime = static_cast<UINT32>(GetCurrentTimeMs() - target->pollStartTime);
    UINT32 interval = 60000 / s_pollsPerMinute;
 
    ThreadPoolScheduleRelative(s_pollers, (interval > elapsedTime) ? interval - elapsedTime : 1, Poller, target);
 }
 
+/**
+ * Callback for shared pinger
+ */
+static void PingCallback(UINT32 result, UINT32 rtt, void *context)
+{
+   PING_TARGET *target = static_cast<PING_TARGET*>(context);
+   target->pingResult = result;
+   if (result == ICMP_SUCCESS)
+      target->lastRTT = rtt;
+   ThreadPoolExecute(s_pollers, ProcessPingResult, target);
+}
+
+/**
+ * Poller
+ */
+static void Poller(PING_TARGET *target)
+{
+   target->pollStartTime = GetCurrentTimeMs();
+   if (target->automatic && (target->pollStartTime / 1000 - target->lastDataRead > s_maxTargetInactivityTime))
+   {
+      nxlog_debug_tag(DEBUG_TAG, 3, _T("Target %s (%s) removed because of inactivity"), target->name, (const TCHAR *)target->ipAddr.toString());
+      s_targetLock.lock();
+      s_targets.remove(target);
+      s_targetLock.unlock();
+      return;
+   }
+
+   // Pool thread is not blocked while waiting for reply if shared pinger is available
+   if (IcmpPingAsync(target->ipAddr, s_timeout, target->packetSize, target->dontFragment, PingCallback, target))
+      return;
+
+   target->pingResult = IcmpPing(target->ipAddr, 1, s_timeout, &target->lastRTT, target->packetSize, target->dontFragment);
+   ProcessPingResult(target);
+}
+
 /**
  * Hanlder for immediate ping request
  */
@@ -211,7 +239,7 @@ static LONG H_IcmpPing(const TCHAR *pszParam, const TCHAR *pArg, TCHAR *pValue,
 
 	TCHAR ipAddrText[64];
 	nxlog_debug_tag(DEBUG_TAG, 7, _T("IcmpPing: start for host=%s addr=%s retryCount=%d"), szHostName, addr.toString(ipAddrText), retryCount);
-	UINT32 result = IcmpPing(addr, retryCount, dwTimeOut, &dwRTT, dwPacketSize, dontFragment);
+	UINT32 result = IcmpPingShared(addr, retryCount, dwTimeOut, &dwRTT, dwPacketSize, dontFragment);
 	nxlog_debug_tag(DEBUG_TAG, 7, _T("IcmpPing: completed for host=%s timeout=%d packetSize=%d dontFragment=%s result=%d time=%d"),
 	      szHostName, dwTimeOut, dwPacketSize, dontFragment ? _T("true") : _T("false"), result, dwRTT);
 
@@ -436,6 +464,7 @@ static LONG H_ScanRange(const TCHAR *param, const TCHAR *arg, StringList *value,
  */
 static void SubagentShutdown()
 {
+   ShutdownIcmpPinger();
    ThreadPoolDestroy(s_pollers);
    nxlog_debug_tag(DEBUG_TAG, 2, _T("Poller thread pool destroyed"));
 }
@@ -558,6 +587,7 @@ static bool SubagentInit(Config *config)
 	   return false;
 	}
 
+	InitIcmpPinger();
 	s_pollers = ThreadPoolCreate(_T("PING"), s_poolMinSize, s_poolMaxSize);
 
    if (s_pollsPerMinute == 0)
@@ -62,6 +62,8 @@ struct PING_TARGET
 	bool dontFragment;
 	bool automatic;
 	time_t lastDataRead;
+   INT64 pollStartTime;
+   UINT32 pingResult;
 };
 
 StructArray<InetAddress> *ScanAddressRange(const InetAddress& start, const InetAddress& end, UINT32 timeout);
@@ -566,6 +566,87 @@ extern "C" DWORD __EXPORT DrvExecute(PG_CONN *pConn, PG_STATEMENT *hStmt, WCHAR
 	return rc;
 }
 
+/**
+ * Set error text from connection error message
+ */
+static void SetCopyErrorText(PG_CONN *pConn, PGresult *pResult, WCHAR *errorText)
+{
+   if (errorText == NULL)
+      return;
+
+   const char *sqlState = (pResult != NULL) ? PQresultErrorField(pResult, PG_DIAG_SQLSTATE) : NULL;
+   MultiByteToWideChar(CP_UTF8, 0, CHECK_NULL_EX_A(sqlState), -1, errorText, DBDRV_MAX_ERROR_TEXT);
+   int len = (int)wcslen(errorText);
+   if (len > 0)
+   {
+      errorText[len] = L' ';
+      len++;
+   }
+   MultiByteToWideChar(CP_UTF8, 0, PQerrorMessage(pConn->handle), -1, &errorText[len], DBDRV_MAX_ERROR_TEXT - len);
+   errorText[DBDRV_MAX_ERROR_TEXT - 1] = 0;
+   RemoveTrailingCRLFW(errorText);
+}
+
+/**
+ * Load data into table using COPY ... FROM STDIN. Data should be in COPY text format and UTF-8 encoding.
+ */
+extern "C" DWORD __EXPORT DrvCopyFrom(PG_CONN *pConn, const WCHAR *query, const char *data, size_t size, WCHAR *errorText)
+{
+   char localBuffer[1024];
+   char *queryUTF8 = WideStringToUTF8(query, localBuffer, 1024);
+
+   DWORD rc = DBERR_OTHER_ERROR;
+   MutexLock(pConn->mutexQueryLock);
+
+   PGresult *pResult = PQexec(pConn->handle, queryUTF8);
+   if ((pResult != NULL) && (PQresultStatus(pResult) == PGRES_COPY_IN))
+   {
+      PQclear(pResult);
+
+      bool success = true;
+      while((size > 0) && success)
+      {
+         int chunk = static_cast<int>(std::min(size, static_cast<size_t>(0x10000000)));
+         success = (PQputCopyData(pConn->handle, data, chunk) == 1);
+         data += chunk;
+         size -= chunk;
+      }
+      if (PQputCopyEnd(pConn->handle, success ? NULL : "client error") == 1)
+      {
+         // Collect all results of COPY command
+         rc = DBERR_SUCCESS;
+         while((pResult = PQgetResult(pConn->handle)) != NULL)
+         {
+            if (PQresultStatus(pResult) != PGRES_COMMAND_OK)
+            {
+               SetCopyErrorText(pConn, pResult, errorText);
+               rc = (PQstatus(pConn->handle) == CONNECTION_BAD) ? DBERR_CONNECTION_LOST : DBERR_OTHER_ERROR;
+            }
+            PQclear(pResult);
+         }
+      }
+      else
+      {
+         SetCopyErrorText(pConn, NULL, errorText);
+         rc = (PQstatus(pConn->handle) == CONNECTION_BAD) ? DBERR_CONNECTION_LOST : DBERR_OTHER_ERROR;
+      }
+   }
+   else
+   {
+      SetCopyErrorText(pConn, pResult, errorText);
+      rc = (PQstatus(pConn->handle) == CONNECTION_BAD) ? DBERR_CONNECTION_LOST : DBERR_OTHER_ERROR;
+      if (pResult != NULL)
+         PQclear(pResult);
+   }
+
+   if ((rc == DBERR_SUCCESS) && (errorText != NULL))
+      *errorText = 0;
+
+   MutexUnlock(pConn->mutexQueryLock);
+   FreeConvertedString(queryUTF8, localBuffer);
+   return rc;
+}
+
 /**
  * Destroy prepared statement
  */
@@ -0,0 +1,604 @@
+/*
+** NetXMS - Network Management System
+** Database Abstraction Library
+** Copyright (C) 2008-2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation; either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: bulk.cpp
+**
+**/
+
+#include "libnxdb.h"
+
+#define DEBUG_TAG _T("db.bulk")
+
+/**
+ * Maximum number of bound parameters in single multi-row INSERT (SQLite default limit is 999)
+ */
+#define MAX_BULK_INSERT_PARAMETERS  999
+
+/**
+ * Maximum number of rows in single multi-row INSERT (MS SQL limit is 1000)
+ */
+#define MAX_BULK_INSERT_ROWS        1000
+
+/**
+ * Value type for columns not set for current row
+ */
+#define DB_CTYPE_NOT_SET   -1
+
+/**
+ * Bulk insert value
+ */
+struct BulkInsertValue
+{
+   int cType;
+   union
+   {
+      INT32 i32;
+      UINT32 u32;
+      INT64 i64;
+      UINT64 u64;
+      double d;
+      size_t offset;    // Offset of UTF-8 string in string buffer
+   } value;
+};
+
+/**
+ * Bulk insert
+ */
+struct db_bulk_insert_t
+{
+   TCHAR *table;
+   TCHAR *columns;
+   int *sqlTypes;
+   int numColumns;
+   int numRows;
+   StructArray<BulkInsertValue> *values;
+   char *strings;
+   size_t stringsSize;
+   size_t stringsAllocated;
+   bool connectionLost;
+};
+
+/**
+ * Create bulk insert object. Columns should be given as comma separated list
+ * (as in INSERT statement), and sqlTypes should contain SQL type for each column.
+ */
+DB_BULK_INSERT LIBNXDB_EXPORTABLE DBBulkInsertCreate(const TCHAR *table, const TCHAR *columns, const int *sqlTypes, int numColumns)
+{
+   DB_BULK_INSERT bi = MemAllocStruct<db_bulk_insert_t>();
+   bi->table = MemCopyString(table);
+   bi->columns = MemCopyString(columns);
+   bi->sqlTypes = MemCopyArray(sqlTypes, numColumns);
+   bi->numColumns = numColumns;
+   bi->values = new StructArray<BulkInsertValue>(numColumns * 256, numColumns * 256);
+   bi->stringsAllocated = 65536;
+   bi->strings = MemAllocArrayNoInit<char>(bi->stringsAllocated);
+   return bi;
+}
+
+/**
+ * Destroy bulk insert object
+ */
+void LIBNXDB_EXPORTABLE DBBulkInsertFree(DB_BULK_INSERT bi)
+{
+   if (bi == NULL)
+      return;
+
+   MemFree(bi->table);
+   MemFree(bi->columns);
+   MemFree(bi->sqlTypes);
+   delete bi->values;
+   MemFree(bi->strings);
+   MemFree(bi);
+}
+
+/**
+ * Start new row. Columns not set for a row are written as zero or empty string,
+ * depending on column type.
+ */
+void LIBNXDB_EXPORTABLE DBBulkInsertAddRow(DB_BULK_INSERT bi)
+{
+   BulkInsertValue v;
+   memset(&v, 0, sizeof(v));
+   v.cType = DB_CTYPE_NOT_SET;
+   for(int i = 0; i < bi->numColumns; i++)
+      bi->values->add(&v);
+   bi->numRows++;
+}
+
+/**
+ * Get value for given column in current row (column numbering starts from 1)
+ */
+static inline BulkInsertValue *GetCurrentRowValue(DB_BULK_INSERT bi, int column)
+{
+   if ((bi->numRows == 0) || (column < 1) || (column > bi->numColumns))
+      return NULL;
+   return bi->values->get((bi->numRows - 1) * bi->numColumns + column - 1);
+}
+
+/**
+ * Reserve space in string buffer
+ */
+static inline char *ReserveStringSpace(DB_BULK_INSERT bi, size_t size)
+{
+   if (bi->stringsSize + size > bi->stringsAllocated)
+   {
+      bi->stringsAllocated = std::max(bi->stringsAllocated * 2, bi->stringsSize + size);
+      bi->strings = MemRealloc(bi->strings, bi->stringsAllocated);
+   }
+   return &bi->strings[bi->stringsSize];
+}
+
+/**
+ * Set 32 bit integer value
+ */
+void LIBNXDB_EXPORTABLE DBBulkInsertSet(DB_BULK_INSERT bi, int column, INT32 value)
+{
+   BulkInsertValue *v = GetCurrentRowValue(bi, column);
+   if (v == NULL)
+      return;
+   v->cType = DB_CTYPE_INT32;
+   v->value.i32 = value;
+}
+
+/**
+ * Set 32 bit unsigned integer value
+ */
+void LIBNXDB_EXPORTABLE DBBulkInsertSet(DB_BULK_INSERT bi, int column, UINT32 value)
+{
+   BulkInsertValue *v = GetCurrentRowValue(bi, column);
+   if (v == NULL)
+      return;
+   v->cType = DB_CTYPE_UINT32;
+   v->value.u32 = value;
+}
+
+/**
+ * Set 64 bit integer value
+ */
+void LIBNXDB_EXPORTABLE DBBulkInsertSet(DB_BULK_INSERT bi, int column, INT64 value)
+{
+   BulkInsertValue *v = GetCurrentRowValue(bi, column);
+   if (v == NULL)
+      return;
+   v->cType = DB_CTYPE_INT64;
+   v->value.i64 = value;
+}
+
+/**
+ * Set 64 bit unsigned integer value
+ */
+void LIBNXDB_EXPORTABLE DBBulkInsertSet(DB_BULK_INSERT bi, int column, UINT64 value)
+{
+   BulkInsertValue *v = GetCurrentRowValue(bi, column);
+   if (v == NULL)
+      return;
+   v->cType = DB_CTYPE_UINT64;
+   v->value.u64 = value;
+}
+
+/**
+ * Set floating point value
+ */
+void LIBNXDB_EXPORTABLE DBBulkInsertSet(DB_BULK_INSERT bi, int column, double value)
+{
+   BulkInsertValue *v = GetCurrentRowValue(bi, column);
+   if (v == NULL)
+      return;
+   v->cType = DB_CTYPE_DOUBLE;
+   v->value.d = value;
+}
+
+/**
+ * Set string value
+ */
+void LIBNXDB_EXPORTABLE DBBulkInsertSet(DB_BULK_INSERT bi, int column, const TCHAR *value)
+{
+   BulkInsertValue *v = GetCurrentRowValue(bi, column);
+   if (v == NULL)
+      return;
+
+   size_t len = _tcslen(CHECK_NULL_EX(value));
+#ifdef UNICODE
+   size_t maxSize = len * 4 + 1;
+#else
+   size_t maxSize = len * 3 + 1;
+#endif
+   char *buffer = ReserveStringSpace(bi, maxSize);
+   size_t size = (len > 0) ? tchar_to_utf8(value, len, buffer, maxSize - 1) : 0;
+   buffer[size] = 0;
+
+   v->cType = DB_CTYPE_UTF8_STRING;
+   v->value.offset = bi->stringsSize;
+   bi->stringsSize += size + 1;
+}
+
+/**
+ * Set string value from multibyte string in system code page
+ */
+void LIBNXDB_EXPORTABLE DBBulkInsertSetMB(DB_BULK_INSERT bi, int column, const char *value)
+{
+   BulkInsertValue *v = GetCurrentRowValue(bi, column);
+   if (v == NULL)
+      return;
+
+   size_t len = strlen(CHECK_NULL_EX_A(value));
+   size_t maxSize = len * 3 + 1;
+   char *buffer = ReserveStringSpace(bi, maxSize);
+   size_t size = (len > 0) ? mb_to_utf8(value, len, buffer, maxSize - 1) : 0;
+   buffer[size] = 0;
+
+   v->cType = DB_CTYPE_UTF8_STRING;
+   v->value.offset = bi->stringsSize;
+   bi->stringsSize += size + 1;
+}
+
+/**
+ * Set string value from UTF-8 string
+ */
+void LIBNXDB_EXPORTABLE DBBulkInsertSetUTF8(DB_BULK_INSERT bi, int column, const char *value)
+{
+   BulkInsertValue *v = GetCurrentRowValue(bi, column);
+   if (v == NULL)
+      return;
+
+   size_t size = strlen(CHECK_NULL_EX_A(value)) + 1;
+   char *buffer = ReserveStringSpace(bi, size);
+   memcpy(buffer, CHECK_NULL_EX_A(value), size);
+
+   v->cType = DB_CTYPE_UTF8_STRING;
+   v->value.offset = bi->stringsSize;
+   bi->stringsSize += size;
+}
+
+/**
+ * Get number of rows
+ */
+int LIBNXDB_EXPORTABLE DBBulkInsertGetRowCount(DB_BULK_INSERT bi)
+{
+   return bi->numRows;
+}
+
+/**
+ * Remove all rows
+ */
+void LIBNXDB_EXPORTABLE DBBulkInsertClear(DB_BULK_INSERT bi)
+{
+   bi->values->clear();
+   bi->stringsSize = 0;
+   bi->numRows = 0;
+}
+
+/**
+ * Check if given SQL type is numeric
+ */
+static inline bool IsNumericType(int sqlType)
+{
+   return (sqlType == DB_SQLTYPE_INTEGER) || (sqlType == DB_SQLTYPE_BIGINT) || (sqlType == DB_SQLTYPE_DOUBLE);
+}
+
+/**
+ * Bind value to statement
+ */
+static void BindValue(DB_STATEMENT hStmt, int pos, int sqlType, BulkInsertValue *v, char *strings)
+{
+   static char emptyString[] = "";
+   static INT32 zero = 0;
+
+   switch(v->cType)
+   {
+      case DB_CTYPE_NOT_SET:
+         if (IsNumericType(sqlType))
+            DBBind(hStmt, pos, sqlType, DB_CTYPE_INT32, &zero, DB_BIND_STATIC);
+         else
+            DBBind(hStmt, pos, sqlType, DB_CTYPE_UTF8_STRING, emptyString, DB_BIND_STATIC);
+         break;
+      case DB_CTYPE_UTF8_STRING:
+         DBBind(hStmt, pos, sqlType, DB_CTYPE_UTF8_STRING, &strings[v->value.offset], DB_BIND_STATIC);
+         break;
+      default:
+         DBBind(hStmt, pos, sqlType, v->cType, &v->value, DB_BIND_STATIC);
+         break;
+   }
+}
+
+/**
+ * Append value to COPY data in text format
+ */
+static void AppendCopyValue(ByteStream *out, int sqlType, const BulkInsertValue *v, const char *strings)
+{
+   char buffer[64];
+   switch(v->cType)
+   {
+      case DB_CTYPE_NOT_SET:
+         if (IsNumericType(sqlType))
+            out->write('0');
+         break;
+      case DB_CTYPE_INT32:
+         out->write(buffer, snprintf(buffer, 64, "%d", v->value.i32));
+         break;
+      case DB_CTYPE_UINT32:
+         out->write(buffer, snprintf(buffer, 64, "%u", v->value.u32));
+         break;
+      case DB_CTYPE_INT64:
+         out->write(buffer, snprintf(buffer, 64, INT64_FMTA, v->value.i64));
+         break;
+      case DB_CTYPE_UINT64:
+         out->write(buffer, snprintf(buffer, 64, UINT64_FMTA, v->value.u64));
+         break;
+      case DB_CTYPE_DOUBLE:
+         out->write(buffer, snprintf(buffer, 64, "%.17g", v->value.d));
+         break;
+      case DB_CTYPE_UTF8_STRING:
+         {
+            const char *s = &strings[v->value.offset];
+            const char *start = s;
+            for(; *s != 0; s++)
+            {
+               char escape;
+               switch(*s)
+               {
+                  case '\\':
+                     escape = '\\';
+                     break;
+                  case '\t':
+                     escape = 't';
+                     break;
+                  case '\n':
+                     escape = 'n';
+                     break;
+                  case '\r':
+                     escape = 'r';
+                     break;
+                  default:
+                     continue;
+               }
+               if (s > start)
+                  out->write(start, s - start);
+               out->write('\\');
+               out->write(escape);
+               start = s + 1;
+            }
+            if (s > start)
+               out->write(start, s - start);
+         }
+         break;
+   }
+}
+
+/**
+ * Execute bulk insert using COPY ... FROM STDIN
+ */
+static bool ExecuteCopy(DB_HANDLE hConn, DB_BULK_INSERT bi, TCHAR *errorText)
+{
+   ByteStream data(bi->stringsSize + bi->numRows * bi->numColumns * 12);
+   for(int row = 0, index = 0; row < bi->numRows; row++)
+   {
+      for(int col = 0; col < bi->numColumns; col++, index++)
+      {
+         if (col > 0)
+            data.write('\t');
+         AppendCopyValue(&data, bi->sqlTypes[col], bi->values->get(index), bi->strings);
+      }
+      data.write('\n');
+   }
+
+   TCHAR query[1024];
+   _sntprintf(query, 1024, _T("COPY %s (%s) FROM STDIN"), bi->table, bi->columns);
+   return DBCopyFrom(hConn, query, reinterpret_cast<const char*>(data.buffer()), data.size(), errorText);
+}
+
+/**
+ * Execute bulk insert using batch mode of prepared statement
+ */
+static bool ExecuteBatch(DB_HANDLE hConn, DB_BULK_INSERT bi, TCHAR *errorText)
+{
+   StringBuffer query(_T("INSERT INTO "));
+   query.append(bi->table);
+   query.append(_T(" ("));
+   query.append(bi->columns);
+   query.append(_T(") VALUES (?"));
+   for(int i = 1; i < bi->numColumns; i++)
+      query.append(_T(",?"));
+   query.append(_T(')'));
+
+   DB_STATEMENT hStmt = DBPrepareEx(hConn, query, false, errorText);
+   if (hStmt == NULL)
+      return false;
+
+   bool success = DBOpenBatch(hStmt);
+   if (success)
+   {
+      for(int row = 0, index = 0; row < bi->numRows; row++)
+      {
+         DBNextBatchRow(hStmt);
+         for(int col = 0; col < bi->numColumns; col++, index++)
+            BindValue(hStmt, col + 1, bi->sqlTypes[col], bi->values->get(index), bi->strings);
+      }
+      success = DBExecuteEx(hStmt, errorText);
+   }
+   else
+   {
+      _tcslcpy(errorText, _T("Cannot open batch"), DBDRV_MAX_ERROR_TEXT);
+   }
+   DBFreeStatement(hStmt);
+   return success;
+}
+
+/**
+ * Prepare multi-row INSERT statement
+ */
+static DB_STATEMENT PrepareMultiRowInsert(DB_HANDLE hConn, DB_BULK_INSERT bi, int rows, TCHAR *errorText)
+{
+   StringBuffer query(_T("INSERT INTO "));
+   query.append(bi->table);
+   query.append(_T(" ("));
+   query.append(bi->columns);
+   query.append(_T(") VALUES "));
+   for(int row = 0; row < rows; row++)
+   {
+      if (row > 0)
+         query.append(_T(','));
+      query.append(_T("(?"));
+      for(int i = 1; i < bi->numColumns; i++)
+         query.append(_T(",?"));
+      query.append(_T(')'));
+   }
+   return DBPrepareEx(hConn, query, rows > 1, errorText);
+}
+
+/**
+ * Execute bulk insert using multi-row INSERT statements
+ */
+static bool ExecuteMultiRowInsert(DB_HANDLE hConn, DB_BULK_INSERT bi, TCHAR *errorText)
+{
+   const char *driverName = hConn->m_driver->m_name;
+   int rowsPerStatement = (!stricmp(driverName, "INFORMIX") || !stricmp(driverName, "ODBC")) ? 1 :
+            std::min(std::max(MAX_BULK_INSERT_PARAMETERS / bi->numColumns, 1), MAX_BULK_INSERT_ROWS);
+
+   DB_STATEMENT hStmt = NULL;
+   int statementRows = 0;
+   bool success = true;
+   for(int row = 0; (row < bi->numRows) && success; row += statementRows)
+   {
+      int rows = std::min(rowsPerStatement, bi->numRows - row);
+      if (rows != statementRows)
+      {
+         if (hStmt != NULL)
+            DBFreeStatement(hStmt);
+         hStmt = PrepareMultiRowInsert(hConn, bi, rows, errorText);
+         if (hStmt == NULL)
+            return false;
+         statementRows = rows;
+      }
+
+      int index = row * bi->numColumns;
+      for(int pos = 1; pos <= rows * bi->numColumns; pos++, index++)
+         BindValue(hStmt, pos, bi->sqlTypes[(pos - 1) % bi->numColumns], bi->values->get(index), bi->strings);
+      success = DBExecuteEx(hStmt, errorText);
+   }
+   if (hStmt != NULL)
+      DBFreeStatement(hStmt);
+   return success;
+}
+
+/**
+ * Write all rows to database. Best available method is selected depending on database driver:
+ * COPY for PostgreSQL, batch mode for Oracle, and multi-row INSERT for other databases.
+ * Rows are not removed after execution. Caller should start transaction if needed.
+ */
+bool LIBNXDB_EXPORTABLE DBBulkInsertExecuteEx(DB_HANDLE hConn, DB_BULK_INSERT bi, TCHAR *errorText)
+{
+   bi->connectionLost = false;
+   if (bi->numRows == 0)
+   {
+      *errorText = 0;
+      return true;
+   }
+
+   INT64 startTime = GetCurrentTimeMs();
+   UINT32 reconnects = hConn->m_reconnects;
+   bool success;
+   const TCHAR *method;
+   if (hConn->m_driver->m_fpDrvCopyFrom != NULL)
+   {
+      method = _T("COPY");
+      success = ExecuteCopy(hConn, bi, errorText);
+   }
+   else if (hConn->m_driver->m_fpDrvOpenBatch != NULL)
+   {
+      method = _T("batch");
+      success = ExecuteBatch(hConn, bi, errorText);
+   }
+   else
+   {
+      method = _T("multi-row INSERT");
+      success = ExecuteMultiRowInsert(hConn, bi, errorText);
+   }
+   bi->connectionLost = (hConn->m_reconnects != reconnects);
+
+   nxlog_debug_tag(DEBUG_TAG, 7, _T("Bulk insert of %d rows into %s using %s %s [") INT64_FMT _T(" ms]"),
+            bi->numRows, bi->table, method, success ? _T("completed") : _T("failed"), GetCurrentTimeMs() - startTime);
+   return success;
+}
+
+/**
+ * Write all rows to database
+ */
+bool LIBNXDB_EXPORTABLE DBBulkInsertExecute(DB_HANDLE hConn, DB_BULK_INSERT bi)
+{
+   TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
+   return DBBulkInsertExecuteEx(hConn, bi, errorText);
+}
+
+/**
+ * Write rows one by one using single row INSERT statements, skipping rows that cannot be written.
+ * Intended as fallback when whole batch was rejected by database. Should be called outside of
+ * transaction, so that failed row does not abort other rows. Row is retried once if connection
+ * was lost and restored while writing it. Returns number of rows written.
+ */
+int LIBNXDB_EXPORTABLE DBBulkInsertExecuteRowByRow(DB_HANDLE hConn, DB_BULK_INSERT bi)
+{
+   if (bi->numRows == 0)
+      return 0;
+
+   TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
+   DB_STATEMENT hStmt = PrepareMultiRowInsert(hConn, bi, 1, errorText);
+   if (hStmt == NULL)
+      return 0;
+
+   int written = 0;
+   for(int row = 0, index = 0; row < bi->numRows; row++, index += bi->numColumns)
+   {
+      for(int attempt = 0; attempt < 2; attempt++)
+      {
+         UINT32 reconnects = hConn->m_reconnects;
+         for(int col = 0; col < bi->numColumns; col++)
+            BindValue(hStmt, col + 1, bi->sqlTypes[col], bi->values->get(index + col), bi->strings);
+         if (DBExecuteEx(hStmt, errorText))
+         {
+            written++;
+            break;
+         }
+         if (hConn->m_reconnects == reconnects)
+         {
+            nxlog_debug_tag(DEBUG_TAG, 5, _T("Row %d rejected by database (%s)"), row + 1, errorText);
+            break;
+         }
+
+         // Prepared statement was invalidated by reconnect
+         DBFreeStatement(hStmt);
+         hStmt = PrepareMultiRowInsert(hConn, bi, 1, errorText);
+         if (hStmt == NULL)
+            return written;
+      }
+   }
+   DBFreeStatement(hStmt);
+
+   nxlog_debug_tag(DEBUG_TAG, 7, _T("Row by row insert into %s: %d of %d rows written"), bi->table, written, bi->numRows);
+   return written;
+}
+
+/**
+ * Check if last execution of bulk insert failed because connection to database was lost
+ * (connection is already restored when this function returns true)
+ */
+bool LIBNXDB_EXPORTABLE DBBulkInsertIsConnectionLost(DB_BULK_INSERT bi)
+{
+   return bi->connectionLost;
+}
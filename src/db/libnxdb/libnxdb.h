@@ -86,6 +86,7 @@ struct db_driver_t
 	WCHAR* (* m_fpDrvPrepareStringW)(const WCHAR *);
 	char* (* m_fpDrvPrepareStringA)(const char *);
 	int (* m_fpDrvIsTableExist)(DBDRV_CONNECTION, const WCHAR *);
+	DWORD (* m_fpDrvCopyFrom)(DBDRV_CONNECTION, const WCHAR *, const char *, size_t, WCHAR *);
 };
 
 /**
@@ -110,6 +111,8 @@ struct db_handle_t
 	bool m_reconnectEnabled;
    MUTEX m_mutexTransLock;      // Transaction lock
    int m_transactionLevel;
+   UINT64 m_nonSelectQueries;   // Number of non-SELECT queries executed on this connection
+   UINT32 m_reconnects;         // Number of reconnects performed on this connection
    char *m_server;
    char *m_login;
    char *m_password;
@@ -139,6 +142,11 @@ struct db_unbuffered_result_t
 	DBDRV_UNBUFFERED_RESULT m_data;
 };
 
+/**
+ * Internal functions
+ */
+bool DBCopyFrom(DB_HANDLE hConn, const TCHAR *query, const char *data, size_t size, TCHAR *errorText);
+
 /**
  * Global variables
  */
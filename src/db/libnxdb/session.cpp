@@ -94,6 +94,8 @@ DB_HANDLE LIBNXDB_EXPORTABLE DBConnect(DB_DRIVER driver, const TCHAR *server, co
 			hConn->m_connection = hDrvConn;
          hConn->m_mutexTransLock = MutexCreateRecursive();
          hConn->m_transactionLevel = 0;
+         hConn->m_nonSelectQueries = 0;
+         hConn->m_reconnects = 0;
          hConn->m_preparedStatements = new ObjectArray<db_statement_t>(4, 4, Ownership::False);
          hConn->m_preparedStatementsLock = MutexCreateFast();
 #ifdef UNICODE
@@ -180,6 +182,7 @@ static void DBReconnect(DB_HANDLE hConn)
 
    InvalidatePreparedStatements(hConn);
 	hConn->m_driver->m_fpDrvDisconnect(hConn->m_connection);
+   hConn->m_reconnects++;
    for(nCount = 0; ; nCount++)
    {
 		hConn->m_connection = hConn->m_driver->m_fpDrvConnect(hConn->m_server, hConn->m_login,
@@ -246,6 +249,78 @@ void LIBNXDB_EXPORTABLE DBSetSessionInitCallback(void (*cb)(DB_HANDLE))
    s_sessionInitCb = cb;
 }
 
+/**
+ * Load data into table using driver's bulk load facility (like COPY on PostgreSQL).
+ * Query should be driver specific bulk load command, and data should be in format
+ * expected by that command. Connection is restored if lost during bulk load,
+ * but command is not retried, as it is expected to be called within transaction.
+ */
+bool DBCopyFrom(DB_HANDLE hConn, const TCHAR *query, const char *data, size_t size, TCHAR *errorText)
+{
+   if (hConn->m_driver->m_fpDrvCopyFrom == NULL)
+   {
+      _tcslcpy(errorText, _T("Bulk load is not supported by database driver"), DBDRV_MAX_ERROR_TEXT);
+      return false;
+   }
+
+#ifdef UNICODE
+#define pwszQuery query
+#define wcErrorText errorText
+#else
+   WCHAR *pwszQuery = WideStringFromMBString(query);
+   WCHAR wcErrorText[DBDRV_MAX_ERROR_TEXT] = L"";
+#endif
+
+   MutexLock(hConn->m_mutexTransLock);
+   INT64 ms = GetCurrentTimeMs();
+
+   DWORD dwResult = hConn->m_driver->m_fpDrvCopyFrom(hConn->m_connection, pwszQuery, data, size, wcErrorText);
+
+   s_perfNonSelectQueries++;
+   s_perfTotalQueries++;
+   hConn->m_nonSelectQueries++;
+
+   ms = GetCurrentTimeMs() - ms;
+   if (hConn->m_driver->m_dumpSql)
+   {
+      nxlog_debug_tag(DEBUG_TAG_QUERY, 9, _T("%s bulk load: \"%s\" (%u bytes) [%d ms]"), (dwResult == DBERR_SUCCESS) ? _T("Successful") : _T("Failed"),
+               query, static_cast<uint32_t>(size), static_cast<int>(ms));
+   }
+   if ((dwResult == DBERR_SUCCESS) && ((UINT32)ms > g_sqlQueryExecTimeThreshold))
+   {
+      nxlog_debug_tag(DEBUG_TAG_QUERY, 3, _T("Long running query: \"%s\" [%d ms]"), query, (int)ms);
+      s_perfLongRunningQueries++;
+   }
+
+   if ((dwResult == DBERR_CONNECTION_LOST) && hConn->m_reconnectEnabled)
+   {
+      DBReconnect(hConn);
+   }
+
+   MutexUnlock(hConn->m_mutexTransLock);
+
+#ifndef UNICODE
+   WideCharToMultiByte(CP_ACP, WC_COMPOSITECHECK | WC_DEFAULTCHAR, wcErrorText, -1, errorText, DBDRV_MAX_ERROR_TEXT, NULL, NULL);
+   errorText[DBDRV_MAX_ERROR_TEXT - 1] = 0;
+#endif
+
+   if (dwResult != DBERR_SUCCESS)
+   {
+      s_perfFailedQueries++;
+      nxlog_write_tag(NXLOG_ERROR, DEBUG_TAG_DRIVER, _T("SQL query failed (Query = \"%s\"): %s"), query, errorText);
+      if (hConn->m_driver->m_fpEventHandler != NULL)
+         hConn->m_driver->m_fpEventHandler(DBEVENT_QUERY_FAILED, pwszQuery, wcErrorText, dwResult == DBERR_CONNECTION_LOST, hConn->m_driver->m_userArg);
+   }
+
+#ifndef UNICODE
+   free(pwszQuery);
+#endif
+
+   return dwResult == DBERR_SUCCESS;
+#undef pwszQuery
+#undef wcErrorText
+}
+
 /**
  * Perform a non-SELECT SQL query
  */
@@ -272,6 +347,7 @@ bool LIBNXDB_EXPORTABLE DBQueryEx(DB_HANDLE hConn, const TCHAR *szQuery, TCHAR *
 
    s_perfNonSelectQueries++;
    s_perfTotalQueries++;
+   hConn->m_nonSelectQueries++;
 
    ms = GetCurrentTimeMs() - ms;
    if (hConn->m_driver->m_dumpSql)
@@ -1495,6 +1571,7 @@ bool LIBNXDB_EXPORTABLE DBExecuteEx(DB_STATEMENT hStmt, TCHAR *errorText)
 
    s_perfNonSelectQueries++;
    s_perfTotalQueries++;
+   hConn->m_nonSelectQueries++;
 
 	DWORD dwResult = hConn->m_driver->m_fpDrvExecute(hConn->m_connection, hStmt->m_statement, wcErrorText);
    ms = GetCurrentTimeMs() - ms;
@@ -1924,3 +2001,14 @@ void LIBNXDB_EXPORTABLE DBGetPerfCounters(LIBNXDB_PERF_COUNTERS *counters)
    counters->selectQueries = s_perfSelectQueries;
    counters->totalQueries = s_perfTotalQueries;
 }
+
+/**
+ * Get number of non-SELECT queries executed on given connection
+ */
+UINT64 LIBNXDB_EXPORTABLE DBGetNonSelectQueryCount(DB_HANDLE hdb)
+{
+   MutexLock(hdb->m_mutexTransLock);
+   UINT64 count = hdb->m_nonSelectQueries;
+   MutexUnlock(hdb->m_mutexTransLock);
+   return count;
+}
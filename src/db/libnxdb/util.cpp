@@ -1022,3 +1022,329 @@ void LIBNXDB_EXPORTABLE DBResultToTable(DB_RESULT hResult, Table *table)
       }
    }
 }
+
+/**
+ * Convert number of days since epoch to calendar date
+ */
+static void DaysToDate(int64_t days, int *year, int *month, int *day)
+{
+   days += 719468;
+   int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+   int64_t doe = days - era * 146097;
+   int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+   int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+   int64_t mp = (5 * doy + 2) / 153;
+   *day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+   *month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+   *year = static_cast<int>(yoe + era * 400 + (*month <= 2 ? 1 : 0));
+}
+
+/**
+ * Convert calendar date to number of days since epoch
+ */
+static int64_t DateToDays(int year, int month, int day)
+{
+   year -= (month <= 2) ? 1 : 0;
+   int64_t era = (year >= 0 ? year : year - 399) / 400;
+   int64_t yoe = year - era * 400;
+   int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+   int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+   return era * 146097 + doe - 719468;
+}
+
+/**
+ * Get name of time partition starting at given time. PostgreSQL partitions are separate tables
+ * named <table>_pYYYYMMDD, MySQL partitions are named pYYYYMMDD.
+ */
+TCHAR LIBNXDB_EXPORTABLE *DBGetTimePartitionName(DB_HANDLE hdb, const TCHAR *table, int64_t start, TCHAR *buffer)
+{
+   int year, month, day;
+   DaysToDate(start / 86400, &year, &month, &day);
+   if (DBGetSyntax(hdb) == DB_SYNTAX_MYSQL)
+      _sntprintf(buffer, 128, _T("p%04d%02d%02d"), year, month, day);
+   else
+      _sntprintf(buffer, 128, _T("%s_p%04d%02d%02d"), table, year, month, day);
+   return buffer;
+}
+
+/**
+ * Get prefix of time partition names for given table
+ */
+static void GetTimePartitionPrefix(int syntax, const TCHAR *table, TCHAR *prefix)
+{
+   if (syntax == DB_SYNTAX_MYSQL)
+      _tcscpy(prefix, _T("p"));
+   else
+      _sntprintf(prefix, 128, _T("%s_p"), table);
+}
+
+/**
+ * Get start time of time partition from partition name. Returns -1 if name is not a valid time partition name.
+ */
+static int64_t ParseTimePartitionName(const TCHAR *name, const TCHAR *prefix)
+{
+   size_t len = _tcslen(prefix);
+   if (_tcsnicmp(name, prefix, len) || (_tcslen(&name[len]) != 8))
+      return -1;
+
+   int date[3], pos = static_cast<int>(len);
+   static const int digits[3] = { 4, 2, 2 };
+   for(int i = 0; i < 3; i++)
+   {
+      date[i] = 0;
+      for(int j = 0; j < digits[i]; j++, pos++)
+      {
+         if (!_istdigit(name[pos]))
+            return -1;
+         date[i] = date[i] * 10 + (name[pos] - _T('0'));
+      }
+   }
+   if ((date[1] < 1) || (date[1] > 12) || (date[2] < 1) || (date[2] > 31))
+      return -1;
+   return DateToDays(date[0], date[1], date[2]) * 86400;
+}
+
+/**
+ * Get start time of time partition from partition name (reverse of DBGetTimePartitionName).
+ * Returns -1 if name is not a valid time partition name for given table.
+ */
+int64_t LIBNXDB_EXPORTABLE DBGetTimePartitionStart(DB_HANDLE hdb, const TCHAR *table, const TCHAR *name)
+{
+   TCHAR prefix[128];
+   GetTimePartitionPrefix(DBGetSyntax(hdb), table, prefix);
+   return ParseTimePartitionName(name, prefix);
+}
+
+/**
+ * Callback for sorting partition list
+ */
+static int ComparePartitionStart(const void *p1, const void *p2)
+{
+   int64_t s1 = *static_cast<const int64_t*>(p1);
+   int64_t s2 = *static_cast<const int64_t*>(p2);
+   return (s1 < s2) ? -1 : ((s1 > s2) ? 1 : 0);
+}
+
+/**
+ * Get start times of existing time partitions of given table (sorted in ascending order).
+ * Only PostgreSQL and MySQL are supported - Oracle creates interval partitions automatically.
+ */
+bool LIBNXDB_EXPORTABLE DBGetTimePartitions(DB_HANDLE hdb, const TCHAR *table, IntegerArray<int64_t> *partitions)
+{
+   TCHAR query[512];
+   int syntax = DBGetSyntax(hdb);
+   switch(syntax)
+   {
+      case DB_SYNTAX_PGSQL:
+      case DB_SYNTAX_TSDB:
+         _sntprintf(query, 512, _T("SELECT c.relname FROM pg_inherits i INNER JOIN pg_class c ON c.oid=i.inhrelid INNER JOIN pg_class p ON p.oid=i.inhparent WHERE p.relname='%s'"), table);
+         break;
+      case DB_SYNTAX_MYSQL:
+         _sntprintf(query, 512, _T("SELECT partition_name FROM information_schema.partitions WHERE table_schema=DATABASE() AND table_name='%s' AND partition_name IS NOT NULL"), table);
+         break;
+      default:
+         return false;
+   }
+
+   DB_RESULT hResult = DBSelect(hdb, query);
+   if (hResult == nullptr)
+      return false;
+
+   TCHAR prefix[128];
+   GetTimePartitionPrefix(syntax, table, prefix);
+   int count = DBGetNumRows(hResult);
+   for(int i = 0; i < count; i++)
+   {
+      TCHAR name[128];
+      DBGetField(hResult, i, 0, name, 128);
+      int64_t start = ParseTimePartitionName(name, prefix);
+      if (start >= 0)
+         partitions->add(start);
+   }
+   DBFreeResult(hResult);
+
+   partitions->sort(ComparePartitionStart);
+   return true;
+}
+
+/**
+ * Create time partition on PostgreSQL. PostgreSQL refuses to create new partition if default partition
+ * already contains records within its range, so in that case default partition is detached, records
+ * are moved into new partition, and default partition is attached back.
+ */
+static bool CreateTimePartition_PGSQL(DB_HANDLE hdb, const TCHAR *table, const TCHAR *column, int64_t start, uint32_t interval)
+{
+   TCHAR query[1024], name[128];
+   DBGetTimePartitionName(hdb, table, start, name);
+
+   _sntprintf(query, 1024, _T("SELECT count(*) FROM pg_inherits i INNER JOIN pg_class c ON c.oid=i.inhrelid INNER JOIN pg_class p ON p.oid=i.inhparent WHERE p.relname='%s' AND c.relname='%s_pdefault'"), table, table);
+   DB_RESULT hResult = DBSelect(hdb, query);
+   if (hResult == nullptr)
+      return false;
+   bool hasDefault = (DBGetNumRows(hResult) > 0) && (DBGetFieldLong(hResult, 0, 0) > 0);
+   DBFreeResult(hResult);
+
+   TCHAR range[256];
+   _sntprintf(range, 256, _T("%s>=") INT64_FMT _T(" AND %s<") INT64_FMT, column, start, column, start + interval);
+
+   bool moveRecords = false;
+   if (hasDefault)
+   {
+      _sntprintf(query, 1024, _T("SELECT count(*) FROM %s_pdefault WHERE %s"), table, range);
+      hResult = DBSelect(hdb, query);
+      if (hResult == nullptr)
+         return false;
+      moveRecords = (DBGetNumRows(hResult) > 0) && (DBGetFieldInt64(hResult, 0, 0) > 0);
+      DBFreeResult(hResult);
+   }
+
+   TCHAR createQuery[1024];
+   _sntprintf(createQuery, 1024, _T("CREATE TABLE %s PARTITION OF %s FOR VALUES FROM (") INT64_FMT _T(") TO (") INT64_FMT _T(")"),
+            name, table, start, start + interval);
+   if (!moveRecords)
+      return ExecuteQuery(hdb, createQuery);
+
+   if (!DBBegin(hdb))
+      return false;
+
+   _sntprintf(query, 1024, _T("ALTER TABLE %s DETACH PARTITION %s_pdefault"), table, table);
+   bool success = ExecuteQuery(hdb, query) && ExecuteQuery(hdb, createQuery);
+   if (success)
+   {
+      _sntprintf(query, 1024, _T("INSERT INTO %s SELECT * FROM %s_pdefault WHERE %s"), name, table, range);
+      success = ExecuteQuery(hdb, query);
+   }
+   if (success)
+   {
+      _sntprintf(query, 1024, _T("DELETE FROM %s_pdefault WHERE %s"), table, range);
+      success = ExecuteQuery(hdb, query);
+   }
+   if (success)
+   {
+      _sntprintf(query, 1024, _T("ALTER TABLE %s ATTACH PARTITION %s_pdefault DEFAULT"), table, table);
+      success = ExecuteQuery(hdb, query);
+   }
+
+   if (success)
+      success = DBCommit(hdb);
+   else
+      DBRollback(hdb);
+   return success;
+}
+
+/**
+ * Create time partition for given table. Partition will cover time range [start, start + interval)
+ * of given timestamp column. New partition should start after all existing partitions. On Oracle
+ * partitions are created automatically and this function does nothing.
+ */
+bool LIBNXDB_EXPORTABLE DBCreateTimePartition(DB_HANDLE hdb, const TCHAR *table, const TCHAR *column, int64_t start, uint32_t interval)
+{
+   TCHAR query[1024], name[128];
+   switch(DBGetSyntax(hdb))
+   {
+      case DB_SYNTAX_PGSQL:
+      case DB_SYNTAX_TSDB:
+         return CreateTimePartition_PGSQL(hdb, table, column, start, interval);
+      case DB_SYNTAX_MYSQL:
+         // Split catch-all partition (normally empty)
+         _sntprintf(query, 1024, _T("ALTER TABLE %s REORGANIZE PARTITION pmax INTO (PARTITION %s VALUES LESS THAN (") INT64_FMT _T("), PARTITION pmax VALUES LESS THAN MAXVALUE)"),
+                  table, DBGetTimePartitionName(hdb, table, start, name), start + interval);
+         break;
+      case DB_SYNTAX_ORACLE:
+         return true;
+      default:
+         return false;
+   }
+   return ExecuteQuery(hdb, query);
+}
+
+/**
+ * Drop time partition of given table starting at given time
+ */
+bool LIBNXDB_EXPORTABLE DBDropTimePartition(DB_HANDLE hdb, const TCHAR *table, int64_t start)
+{
+   TCHAR query[1024], name[128];
+   switch(DBGetSyntax(hdb))
+   {
+      case DB_SYNTAX_PGSQL:
+      case DB_SYNTAX_TSDB:
+         _sntprintf(query, 1024, _T("DROP TABLE %s"), DBGetTimePartitionName(hdb, table, start, name));
+         break;
+      case DB_SYNTAX_MYSQL:
+         _sntprintf(query, 1024, _T("ALTER TABLE %s DROP PARTITION %s"), table, DBGetTimePartitionName(hdb, table, start, name));
+         break;
+      case DB_SYNTAX_ORACLE:
+         _sntprintf(query, 1024, _T("ALTER TABLE %s DROP PARTITION FOR (") INT64_FMT _T(") UPDATE GLOBAL INDEXES"), table, start);
+         break;
+      default:
+         return false;
+   }
+   return ExecuteQuery(hdb, query);
+}
+
+/**
+ * Create missing time partitions for given table so that partitions cover time up to given time.
+ * Returns number of created partitions or -1 on error.
+ */
+int LIBNXDB_EXPORTABLE DBCreateTimePartitions(DB_HANDLE hdb, const TCHAR *table, const TCHAR *column, uint32_t interval, time_t until)
+{
+   if (DBGetSyntax(hdb) == DB_SYNTAX_ORACLE)
+      return 0;   // Interval partitioning
+
+   IntegerArray<int64_t> partitions(64, 64);
+   if (!DBGetTimePartitions(hdb, table, &partitions))
+      return -1;
+
+   int64_t start = partitions.isEmpty() ? (static_cast<int64_t>(time(nullptr)) / interval) * interval : partitions.get(partitions.size() - 1) + interval;
+   int count = 0;
+   for(; start < static_cast<int64_t>(until); start += interval, count++)
+   {
+      if (!DBCreateTimePartition(hdb, table, column, start, interval))
+         return -1;
+   }
+   return count;
+}
+
+/**
+ * Drop time partitions of given table which contain only records older than given cutoff time.
+ * Returns number of dropped partitions or -1 on error.
+ */
+int LIBNXDB_EXPORTABLE DBDropExpiredTimePartitions(DB_HANDLE hdb, const TCHAR *table, const TCHAR *column, uint32_t interval, time_t cutoff)
+{
+   int64_t limit = (static_cast<int64_t>(cutoff) / interval) * interval;
+   int count = 0;
+
+   if (DBGetSyntax(hdb) == DB_SYNTAX_ORACLE)
+   {
+      // Partitions are created by database, so find oldest remaining partition by oldest record
+      TCHAR query[512];
+      _sntprintf(query, 512, _T("SELECT count(*),min(%s) FROM %s WHERE %s<") INT64_FMT, column, table, column, limit);
+      while(true)
+      {
+         DB_RESULT hResult = DBSelect(hdb, query);
+         if (hResult == nullptr)
+            return -1;
+         bool found = (DBGetNumRows(hResult) > 0) && (DBGetFieldLong(hResult, 0, 0) > 0);
+         int64_t oldest = found ? DBGetFieldInt64(hResult, 0, 1) : 0;
+         DBFreeResult(hResult);
+         if (!found)
+            break;
+         if (!DBDropTimePartition(hdb, table, oldest))
+            return -1;
+         count++;
+      }
+      return count;
+   }
+
+   IntegerArray<int64_t> partitions(64, 64);
+   if (!DBGetTimePartitions(hdb, table, &partitions))
+      return -1;
+
+   for(int i = 0; (i < partitions.size()) && (partitions.get(i) + interval <= limit); i++)
+   {
+      if (!DBDropTimePartition(hdb, table, partitions.get(i)))
+         return -1;
+      count++;
+   }
+   return count;
+}
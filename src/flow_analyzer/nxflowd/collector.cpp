@@ -16,7 +16,7 @@ static int s_numTcpSockets = 0;
 static SOCKET *s_tcpSockets = NULL;
 static int s_numUdpSockets = 0;
 static SOCKET *s_udpSockets = NULL;
-static INT64 s_flowId = 1;
+static FlowBatch *s_currentBatch = NULL;
 
 
 //
@@ -68,37 +68,164 @@ static INT64 Int64FromData(void *data, int len)
 	return value;
 }
 
+/**
+ * Get unsigned 64bit integer value from data field (already converted to host byte order by IPFIX library)
+ */
+static UINT64 UInt64FromData(void *data, int len)
+{
+	switch(len)
+	{
+		case 1:
+			return *((BYTE *)data);
+		case 2:
+			return *((UINT16 *)data);
+		case 4:
+			return *((UINT32 *)data);
+		case 8:
+			return *((UINT64 *)data);
+	}
+	return 0;
+}
 
-//
-// Handler for data record
-//
+/**
+ * Get IPv4 address from data field (IPFIX library keeps addresses in network byte order)
+ */
+static UINT32 IPAddressFromData(void *data, int len)
+{
+	if (len != 4)
+		return 0;
+	UINT32 addr;
+	memcpy(&addr, data, 4);
+	return ntohl(addr);
+}
 
-static struct
+/**
+ * Get MAC address from data field
+ */
+static void MACAddressFromData(void *data, int len, BYTE *mac)
 {
-	int ipfixField;
-	const TCHAR *dbField;
-} s_fieldMapping[] =
+	memset(mac, 0, 6);
+	memcpy(mac, data, std::min(len, 6));
+}
+
+/**
+ * Add flow record to current batch. Batch is passed to writer when full.
+ */
+static void AddToBatch(const FlowRecord *record)
 {
-	{ IPFIX_FT_EXPORTERIPV4ADDRESS, _T("exporter_ip_addr") },
-	{ IPFIX_FT_SOURCEMACADDRESS, _T("source_mac_addr") },
-	{ IPFIX_FT_DESTINATIONMACADDRESS, _T("dest_mac_addr") },
-	{ IPFIX_FT_SOURCEIPV4ADDRESS, _T("source_ip_addr") },
-	{ IPFIX_FT_DESTINATIONIPV4ADDRESS, _T("dest_ip_addr") },
-	{ IPFIX_FT_PROTOCOLIDENTIFIER, _T("ip_proto") },
-	{ IPFIX_FT_SOURCETRANSPORTPORT, _T("source_ip_port") },
-	{ IPFIX_FT_DESTINATIONTRANSPORTPORT, _T("dest_ip_port") },
-	{ IPFIX_FT_OCTETDELTACOUNT, _T("octet_count") },
-	{ IPFIX_FT_PACKETDELTACOUNT, _T("packet_count") },
-	{ IPFIX_FT_INGRESSINTERFACE, _T("ingress_interface") },
-	{ IPFIX_FT_EGRESSINTERFACE, _T("egress_interface") },
-	{ 0, NULL }
+	if (s_currentBatch == NULL)
+		s_currentBatch = new FlowBatch(g_flowBatchSize);
+	s_currentBatch->add(record);
+	if (s_currentBatch->isFull())
+	{
+		QueueFlowBatch(s_currentBatch);
+		s_currentBatch = NULL;
+	}
+}
+
+/**
+ * Pass current batch to writer if it is older than flush interval (or unconditionally if force is true)
+ */
+static void FlushBatch(bool force)
+{
+	if ((s_currentBatch != NULL) && (force || (GetCurrentTimeMs() - s_currentBatch->getCreateTime() >= g_flowFlushInterval)))
+	{
+		QueueFlowBatch(s_currentBatch);
+		s_currentBatch = NULL;
+	}
+}
+
+/**
+ * Flow aggregation key (5-tuple, exporter, and minute of flow start)
+ */
+struct FlowAggregationKey
+{
+	INT64 minute;
+	UINT32 exporterIp;
+	UINT32 sourceIp;
+	UINT32 destIp;
+	UINT16 sourcePort;
+	UINT16 destPort;
+	UINT32 protocol;
 };
 
+/**
+ * Aggregated flows for current aggregation interval
+ */
+static HashMap<FlowAggregationKey, FlowRecord> s_aggregatedFlows(Ownership::True);
+static time_t s_aggregationInterval = 0;
+
+/**
+ * Move aggregated flows to batch
+ */
+static void FlushAggregatedFlows()
+{
+	if (s_aggregatedFlows.size() == 0)
+		return;
+
+	nxlog_debug(6, _T("Flushing %d aggregated flows"), s_aggregatedFlows.size());
+	Iterator<FlowRecord> *it = s_aggregatedFlows.iterator();
+	while(it->hasNext())
+		AddToBatch(it->next());
+	delete it;
+	s_aggregatedFlows.clear();
+}
+
+/**
+ * Add flow record to aggregation table. Aggregated flows are passed to writer
+ * once per minute.
+ */
+static void AggregateFlow(const FlowRecord *record)
+{
+	FlowAggregationKey key;
+	memset(&key, 0, sizeof(key));  // key is compared as raw bytes, so padding should be cleared
+	key.minute = record->startTime / 60000;
+	key.exporterIp = record->exporterIp;
+	key.sourceIp = record->sourceIp;
+	key.destIp = record->destIp;
+	key.sourcePort = record->sourcePort;
+	key.destPort = record->destPort;
+	key.protocol = record->protocol;
+
+	FlowRecord *flow = s_aggregatedFlows.get(key);
+	if (flow != NULL)
+	{
+		if (record->startTime < flow->startTime)
+			flow->startTime = record->startTime;
+		if (record->endTime > flow->endTime)
+			flow->endTime = record->endTime;
+		flow->octets += record->octets;
+		flow->packets += record->packets;
+		flow->fields |= record->fields & (FLOW_FIELD_OCTETS | FLOW_FIELD_PACKETS);
+	}
+	else
+	{
+		flow = new FlowRecord;
+		memcpy(flow, record, sizeof(FlowRecord));
+		s_aggregatedFlows.set(key, flow);
+	}
+}
+
+/**
+ * Check if aggregation interval is over and pass aggregated flows to writer if needed
+ */
+static void CheckAggregationInterval()
+{
+	time_t interval = time(NULL) / 60;
+	if (interval != s_aggregationInterval)
+	{
+		FlushAggregatedFlows();
+		s_aggregationInterval = interval;
+	}
+}
+
+/**
+ * Handler for data record
+ */
 static int H_DataRecord(ipfixs_node_t *node, ipfixt_node_t *trec, ipfix_datarecord_t *data, void *arg) 
 {
-	StringBuffer fields, values;
-	char buffer[256];
-	INT64 flowStartTime = 0, flowEndTime = 0;
+	FlowRecord record;
+	memset(&record, 0, sizeof(record));
 
 	for(int i = 0; i < trec->ipfixt->nfields; i++)
 	{
@@ -107,70 +234,110 @@ static int H_DataRecord(ipfixs_node_t *node, ipfixt_node_t *trec, ipfix_datareco
 		{
 			case IPFIX_FT_FLOWSTARTSYSUPTIME:
 				if (node->boot_time != 0)
-					flowStartTime = node->boot_time * 1000 + Int64FromData(data->addrs[i], data->lens[i]);
+					record.startTime = node->boot_time * 1000 + Int64FromData(data->addrs[i], data->lens[i]);
 				break;
 			case IPFIX_FT_FLOWENDSYSUPTIME:
 				if (node->boot_time != 0)
-					flowEndTime = node->boot_time * 1000 + Int64FromData(data->addrs[i], data->lens[i]);
+					record.endTime = node->boot_time * 1000 + Int64FromData(data->addrs[i], data->lens[i]);
 				break;
 			case IPFIX_FT_FLOWSTARTSECONDS:
-				flowStartTime = Int64FromData(data->addrs[i], data->lens[i]) * 1000;
+				record.startTime = Int64FromData(data->addrs[i], data->lens[i]) * 1000;
 				break;
 			case IPFIX_FT_FLOWENDSECONDS:
-				flowEndTime = Int64FromData(data->addrs[i], data->lens[i]) * 1000;
+				record.endTime = Int64FromData(data->addrs[i], data->lens[i]) * 1000;
 				break;
 			case IPFIX_FT_FLOWSTARTMILLISECONDS:
-				flowStartTime = Int64FromData(data->addrs[i], data->lens[i]);
+				record.startTime = Int64FromData(data->addrs[i], data->lens[i]);
 				break;
 			case IPFIX_FT_FLOWENDMILLISECONDS:
-				flowEndTime = Int64FromData(data->addrs[i], data->lens[i]);
+				record.endTime = Int64FromData(data->addrs[i], data->lens[i]);
 				break;
 			case IPFIX_FT_FLOWSTARTMICROSECONDS:
-				flowStartTime = Int64FromData(data->addrs[i], data->lens[i]) / 1000;
+				record.startTime = Int64FromData(data->addrs[i], data->lens[i]) / 1000;
 				break;
 			case IPFIX_FT_FLOWENDMICROSECONDS:
-				flowEndTime = Int64FromData(data->addrs[i], data->lens[i]) / 1000;
+				record.endTime = Int64FromData(data->addrs[i], data->lens[i]) / 1000;
 				break;
 			case IPFIX_FT_FLOWSTARTNANOSECONDS:
-				flowStartTime = Int64FromData(data->addrs[i], data->lens[i]) / 1000000;
+				record.startTime = Int64FromData(data->addrs[i], data->lens[i]) / 1000000;
 				break;
 			case IPFIX_FT_FLOWENDNANOSECONDS:
-				flowEndTime = Int64FromData(data->addrs[i], data->lens[i]) / 1000000;
+				record.endTime = Int64FromData(data->addrs[i], data->lens[i]) / 1000000;
 				break;
 			case IPFIX_FT_FLOWSTARTDELTAMICROSECONDS:
 				if (node->export_time != 0)
-					flowStartTime = node->export_time * 1000 + Int64FromData(data->addrs[i], data->lens[i]);
+					record.startTime = node->export_time * 1000 + Int64FromData(data->addrs[i], data->lens[i]);
 				break;
 			case IPFIX_FT_FLOWENDDELTAMICROSECONDS:
 				if (node->export_time != 0)
-					flowEndTime = node->export_time * 1000 + Int64FromData(data->addrs[i], data->lens[i]);
+					record.endTime = node->export_time * 1000 + Int64FromData(data->addrs[i], data->lens[i]);
+				break;
+			case IPFIX_FT_EXPORTERIPV4ADDRESS:
+				record.exporterIp = IPAddressFromData(data->addrs[i], data->lens[i]);
+				record.fields |= FLOW_FIELD_EXPORTER_IP;
+				break;
+			case IPFIX_FT_SOURCEMACADDRESS:
+				MACAddressFromData(data->addrs[i], data->lens[i], record.sourceMac);
+				record.fields |= FLOW_FIELD_SOURCE_MAC;
+				break;
+			case IPFIX_FT_DESTINATIONMACADDRESS:
+				MACAddressFromData(data->addrs[i], data->lens[i], record.destMac);
+				record.fields |= FLOW_FIELD_DEST_MAC;
+				break;
+			case IPFIX_FT_SOURCEIPV4ADDRESS:
+				record.sourceIp = IPAddressFromData(data->addrs[i], data->lens[i]);
+				record.fields |= FLOW_FIELD_SOURCE_IP;
+				break;
+			case IPFIX_FT_DESTINATIONIPV4ADDRESS:
+				record.destIp = IPAddressFromData(data->addrs[i], data->lens[i]);
+				record.fields |= FLOW_FIELD_DEST_IP;
+				break;
+			case IPFIX_FT_PROTOCOLIDENTIFIER:
+				record.protocol = static_cast<BYTE>(UInt64FromData(data->addrs[i], data->lens[i]));
+				record.fields |= FLOW_FIELD_PROTOCOL;
+				break;
+			case IPFIX_FT_SOURCETRANSPORTPORT:
+				record.sourcePort = static_cast<UINT16>(UInt64FromData(data->addrs[i], data->lens[i]));
+				record.fields |= FLOW_FIELD_SOURCE_PORT;
+				break;
+			case IPFIX_FT_DESTINATIONTRANSPORTPORT:
+				record.destPort = static_cast<UINT16>(UInt64FromData(data->addrs[i], data->lens[i]));
+				record.fields |= FLOW_FIELD_DEST_PORT;
+				break;
+			case IPFIX_FT_OCTETDELTACOUNT:
+				record.octets = UInt64FromData(data->addrs[i], data->lens[i]);
+				record.fields |= FLOW_FIELD_OCTETS;
+				break;
+			case IPFIX_FT_PACKETDELTACOUNT:
+				record.packets = UInt64FromData(data->addrs[i], data->lens[i]);
+				record.fields |= FLOW_FIELD_PACKETS;
+				break;
+			case IPFIX_FT_INGRESSINTERFACE:
+				record.ingressInterface = static_cast<UINT32>(UInt64FromData(data->addrs[i], data->lens[i]));
+				record.fields |= FLOW_FIELD_INGRESS_IF;
+				break;
+			case IPFIX_FT_EGRESSINTERFACE:
+				record.egressInterface = static_cast<UINT32>(UInt64FromData(data->addrs[i], data->lens[i]));
+				record.fields |= FLOW_FIELD_EGRESS_IF;
 				break;
 			default:
-				for(int j = 0; s_fieldMapping[j].dbField != NULL; j++)
-				{
-					if (ftype == s_fieldMapping[j].ipfixField)
-					{
-						fields += _T(",");
-						fields += s_fieldMapping[j].dbField;
-						trec->ipfixt->fields[i].elem->snprint(buffer, sizeof(buffer), data->addrs[i], data->lens[i]);
-						values.appendFormattedString(_T(",'%hs'"), buffer);
-						break;
-					}
-				}
 				break;
 		}
 	}
 
-	if (!fields.isEmpty() && (flowStartTime != 0) && (flowEndTime != 0))
+	if ((record.fields != 0) && (record.startTime != 0) && (record.endTime != 0))
 	{
-		StringBuffer query = _T("INSERT INTO flows (flow_id,start_time,end_time");
-		query += (const TCHAR *)fields;
-		query.appendFormattedString(_T(") VALUES (") INT64_FMT _T(",") INT64_FMT _T(",") INT64_FMT, s_flowId++, flowStartTime, flowEndTime);
-		query += (const TCHAR *)values;
-		query += _T(")");
-
-		DBQuery(g_dbConnection, query);
+		if (g_flags & AF_AGGREGATE_FLOWS)
+		{
+			CheckAggregationInterval();
+			AggregateFlow(&record);
+		}
+		else
+		{
+			AddToBatch(&record);
+		}
 	}
+	FlushBatch(false);
 	return 0;
 }
 
@@ -199,13 +366,20 @@ static THREAD_RESULT THREAD_CALL CollectorThread(void *arg)
 
 	while(!(g_flags & AF_SHUTDOWN))
 	{
-		if (mpoll_loop(2) < 0)
+		if (mpoll_loop(1) < 0)
 		{
 		   nxlog_write(NXLOG_ERROR, _T("IPFIX polling error"));
 			break;
 		}
+		if (g_flags & AF_AGGREGATE_FLOWS)
+			CheckAggregationInterval();
+		FlushBatch(false);
 	}
 
+	// Pass all remaining flows to writer
+	FlushAggregatedFlows();
+	FlushBatch(true);
+
    nxlog_write(NXLOG_INFO, _T("Collector thread stopped"));
    return THREAD_OK;
 }
@@ -215,13 +389,7 @@ static THREAD_RESULT THREAD_CALL CollectorThread(void *arg)
  */
 bool StartCollector()
 {
-	// Initialize flow ID
-	DB_RESULT hResult = DBSelect(g_dbConnection, _T("SELECT max(flow_id) FROM flows"));
-	if (hResult != NULL)
-	{
-		s_flowId = DBGetFieldInt64(hResult, 0, 0) + 1;
-		DBFreeResult(hResult);
-	}
+	s_aggregationInterval = time(NULL) / 60;
 
 	s_collectorInfo = (ipfix_col_info_t *)malloc(sizeof(ipfix_col_info_t));
 	s_collectorInfo->export_newsource = NULL;
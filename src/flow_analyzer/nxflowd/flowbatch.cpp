@@ -0,0 +1,259 @@
+/*
+** nxflowd - NetXMS Flow Collector Daemon
+** Copyright (c) 2009-2020 Raden Solutions
+*/
+
+#include "nxflowd.h"
+
+/**
+ * Columns of flows table in the order used by bulk insert
+ */
+static const TCHAR *s_columns = _T("flow_id,start_time,end_time,exporter_ip_addr,source_mac_addr,dest_mac_addr,source_ip_addr,dest_ip_addr,ip_proto,source_ip_port,dest_ip_port,octet_count,packet_count,ingress_interface,egress_interface");
+static const int s_sqlTypes[] =
+{
+   DB_SQLTYPE_BIGINT, DB_SQLTYPE_BIGINT, DB_SQLTYPE_BIGINT, DB_SQLTYPE_VARCHAR, DB_SQLTYPE_VARCHAR, DB_SQLTYPE_VARCHAR,
+   DB_SQLTYPE_VARCHAR, DB_SQLTYPE_VARCHAR, DB_SQLTYPE_INTEGER, DB_SQLTYPE_INTEGER, DB_SQLTYPE_INTEGER, DB_SQLTYPE_BIGINT,
+   DB_SQLTYPE_BIGINT, DB_SQLTYPE_INTEGER, DB_SQLTYPE_INTEGER
+};
+
+/**
+ * Create empty batch
+ */
+FlowBatch::FlowBatch(int capacity)
+{
+   m_size = 0;
+   m_capacity = capacity;
+   m_createTime = GetCurrentTimeMs();
+   m_startTime = MemAllocArrayNoInit<INT64>(capacity);
+   m_endTime = MemAllocArrayNoInit<INT64>(capacity);
+   m_octets = MemAllocArrayNoInit<UINT64>(capacity);
+   m_packets = MemAllocArrayNoInit<UINT64>(capacity);
+   m_exporterIp = MemAllocArrayNoInit<UINT32>(capacity);
+   m_sourceIp = MemAllocArrayNoInit<UINT32>(capacity);
+   m_destIp = MemAllocArrayNoInit<UINT32>(capacity);
+   m_ingressInterface = MemAllocArrayNoInit<UINT32>(capacity);
+   m_egressInterface = MemAllocArrayNoInit<UINT32>(capacity);
+   m_fields = MemAllocArrayNoInit<UINT32>(capacity);
+   m_sourcePort = MemAllocArrayNoInit<UINT16>(capacity);
+   m_destPort = MemAllocArrayNoInit<UINT16>(capacity);
+   m_protocol = MemAllocArrayNoInit<BYTE>(capacity);
+   m_sourceMac = MemAllocArrayNoInit<BYTE>(capacity * 6);
+   m_destMac = MemAllocArrayNoInit<BYTE>(capacity * 6);
+}
+
+/**
+ * Destructor
+ */
+FlowBatch::~FlowBatch()
+{
+   MemFree(m_startTime);
+   MemFree(m_endTime);
+   MemFree(m_octets);
+   MemFree(m_packets);
+   MemFree(m_exporterIp);
+   MemFree(m_sourceIp);
+   MemFree(m_destIp);
+   MemFree(m_ingressInterface);
+   MemFree(m_egressInterface);
+   MemFree(m_fields);
+   MemFree(m_sourcePort);
+   MemFree(m_destPort);
+   MemFree(m_protocol);
+   MemFree(m_sourceMac);
+   MemFree(m_destMac);
+}
+
+/**
+ * Add record to batch. Caller should check that batch is not full.
+ */
+void FlowBatch::add(const FlowRecord *record)
+{
+   int i = m_size++;
+   m_startTime[i] = record->startTime;
+   m_endTime[i] = record->endTime;
+   m_octets[i] = record->octets;
+   m_packets[i] = record->packets;
+   m_exporterIp[i] = record->exporterIp;
+   m_sourceIp[i] = record->sourceIp;
+   m_destIp[i] = record->destIp;
+   m_ingressInterface[i] = record->ingressInterface;
+   m_egressInterface[i] = record->egressInterface;
+   m_fields[i] = record->fields;
+   m_sourcePort[i] = record->sourcePort;
+   m_destPort[i] = record->destPort;
+   m_protocol[i] = record->protocol;
+   memcpy(&m_sourceMac[i * 6], record->sourceMac, 6);
+   memcpy(&m_destMac[i * 6], record->destMac, 6);
+}
+
+/**
+ * Format IPv4 address in same way as IPFIX library does
+ */
+static inline const char *FormatIPAddress(UINT32 addr, char *buffer)
+{
+   snprintf(buffer, 16, "%u.%u.%u.%u", addr >> 24, (addr >> 16) & 0xFF, (addr >> 8) & 0xFF, addr & 0xFF);
+   return buffer;
+}
+
+/**
+ * Format MAC address in same way as IPFIX library does
+ */
+static inline const char *FormatMACAddress(const BYTE *addr, char *buffer)
+{
+   snprintf(buffer, 16, "0x%02x%02x%02x%02x%02x%02x", addr[0], addr[1], addr[2], addr[3], addr[4], addr[5]);
+   return buffer;
+}
+
+/**
+ * Add all records from batch to bulk insert. Flow IDs are assigned starting from given value.
+ * Fields not present in flow record are left unset.
+ */
+void FlowBatch::fillBulkInsert(DB_BULK_INSERT bi, INT64 *flowId) const
+{
+   char buffer[32];
+   for(int i = 0; i < m_size; i++)
+   {
+      UINT32 fields = m_fields[i];
+      DBBulkInsertAddRow(bi);
+      DBBulkInsertSet(bi, 1, (*flowId)++);
+      DBBulkInsertSet(bi, 2, m_startTime[i]);
+      DBBulkInsertSet(bi, 3, m_endTime[i]);
+      if (fields & FLOW_FIELD_EXPORTER_IP)
+         DBBulkInsertSetUTF8(bi, 4, FormatIPAddress(m_exporterIp[i], buffer));
+      if (fields & FLOW_FIELD_SOURCE_MAC)
+         DBBulkInsertSetUTF8(bi, 5, FormatMACAddress(&m_sourceMac[i * 6], buffer));
+      if (fields & FLOW_FIELD_DEST_MAC)
+         DBBulkInsertSetUTF8(bi, 6, FormatMACAddress(&m_destMac[i * 6], buffer));
+      if (fields & FLOW_FIELD_SOURCE_IP)
+         DBBulkInsertSetUTF8(bi, 7, FormatIPAddress(m_sourceIp[i], buffer));
+      if (fields & FLOW_FIELD_DEST_IP)
+         DBBulkInsertSetUTF8(bi, 8, FormatIPAddress(m_destIp[i], buffer));
+      if (fields & FLOW_FIELD_PROTOCOL)
+         DBBulkInsertSet(bi, 9, static_cast<UINT32>(m_protocol[i]));
+      if (fields & FLOW_FIELD_SOURCE_PORT)
+         DBBulkInsertSet(bi, 10, static_cast<UINT32>(m_sourcePort[i]));
+      if (fields & FLOW_FIELD_DEST_PORT)
+         DBBulkInsertSet(bi, 11, static_cast<UINT32>(m_destPort[i]));
+      if (fields & FLOW_FIELD_OCTETS)
+         DBBulkInsertSet(bi, 12, m_octets[i]);
+      if (fields & FLOW_FIELD_PACKETS)
+         DBBulkInsertSet(bi, 13, m_packets[i]);
+      if (fields & FLOW_FIELD_INGRESS_IF)
+         DBBulkInsertSet(bi, 14, m_ingressInterface[i]);
+      if (fields & FLOW_FIELD_EGRESS_IF)
+         DBBulkInsertSet(bi, 15, m_egressInterface[i]);
+   }
+}
+
+/**
+ * Writer queue and thread
+ */
+static Queue s_writerQueue;
+static THREAD s_writerThread = INVALID_THREAD_HANDLE;
+static INT64 s_flowId = 1;
+static UINT64 s_droppedFlows = 0;   // updated only by collector thread
+static UINT64 s_failedFlows = 0;    // updated only by writer thread
+
+/**
+ * Write single batch to database
+ */
+static void WriteBatch(DB_BULK_INSERT bi, FlowBatch *batch)
+{
+   INT64 startTime = GetCurrentTimeMs();
+   INT64 firstFlowId = s_flowId;
+   batch->fillBulkInsert(bi, &s_flowId);
+
+   TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
+   bool success = DBBegin(g_dbConnection);
+   if (success)
+   {
+      success = DBBulkInsertExecuteEx(g_dbConnection, bi, errorText);
+      if (success)
+         success = DBCommit(g_dbConnection);
+      else
+         DBRollback(g_dbConnection);
+   }
+   else
+   {
+      _tcscpy(errorText, _T("cannot start transaction"));
+   }
+   DBBulkInsertClear(bi);
+
+   if (success)
+   {
+      nxlog_debug(6, _T("Flow writer: %d flows written in ") INT64_FMT _T(" ms"), batch->size(), GetCurrentTimeMs() - startTime);
+   }
+   else
+   {
+      s_flowId = firstFlowId;
+      s_failedFlows += batch->size();
+      if (g_flags & AF_LOG_SQL_ERRORS)
+         nxlog_write(NXLOG_ERROR, _T("Flow writer: cannot write %d flows to database (%s)"), batch->size(), errorText);
+   }
+}
+
+/**
+ * Writer thread
+ */
+static THREAD_RESULT THREAD_CALL WriterThread(void *arg)
+{
+   nxlog_write(NXLOG_INFO, _T("Flow writer thread started"));
+
+   DB_BULK_INSERT bi = DBBulkInsertCreate(_T("flows"), s_columns, s_sqlTypes, sizeof(s_sqlTypes) / sizeof(int));
+   while(true)
+   {
+      FlowBatch *batch = static_cast<FlowBatch*>(s_writerQueue.getOrBlock());
+      if (batch == INVALID_POINTER_VALUE)
+         break;
+      WriteBatch(bi, batch);
+      delete batch;
+   }
+   DBBulkInsertFree(bi);
+
+   nxlog_write(NXLOG_INFO, _T("Flow writer thread stopped"));
+   return THREAD_OK;
+}
+
+/**
+ * Queue batch for writing. Batch will be dropped if writer cannot keep up.
+ */
+void QueueFlowBatch(FlowBatch *batch)
+{
+   if ((g_maxPendingBatches > 0) && (s_writerQueue.size() >= g_maxPendingBatches))
+   {
+      if (s_droppedFlows == 0)
+         nxlog_write(NXLOG_WARNING, _T("Flow writer queue is full, flow records will be dropped"));
+      s_droppedFlows += batch->size();
+      delete batch;
+      return;
+   }
+   s_writerQueue.put(batch);
+}
+
+/**
+ * Start flow writer
+ */
+bool StartFlowWriter()
+{
+   DB_RESULT hResult = DBSelect(g_dbConnection, _T("SELECT max(flow_id) FROM flows"));
+   if (hResult != NULL)
+   {
+      s_flowId = DBGetFieldInt64(hResult, 0, 0) + 1;
+      DBFreeResult(hResult);
+   }
+
+   s_writerThread = ThreadCreateEx(WriterThread, 0, NULL);
+   return s_writerThread != INVALID_THREAD_HANDLE;
+}
+
+/**
+ * Stop flow writer. All queued batches will be written before writer thread stops.
+ */
+void StopFlowWriter()
+{
+   s_writerQueue.put(INVALID_POINTER_VALUE);
+   ThreadJoin(s_writerThread);
+   s_writerThread = INVALID_THREAD_HANDLE;
+   nxlog_write(NXLOG_INFO, _T("Flow writer statistics: ") UINT64_FMT _T(" flows dropped because of full queue, ") UINT64_FMT _T(" flows not written because of database errors"),
+            s_droppedFlows, s_failedFlows);
+}
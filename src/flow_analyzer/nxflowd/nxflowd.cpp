@@ -36,6 +36,9 @@ DWORD g_tcpPort = IPFIX_DEFAULT_PORT;
 DWORD g_udpPort = IPFIX_DEFAULT_PORT;
 DB_DRIVER g_dbDriverHandle = NULL;
 DB_HANDLE g_dbConnection = NULL;
+DWORD g_flowBatchSize = DEFAULT_FLOW_BATCH_SIZE;
+DWORD g_flowFlushInterval = DEFAULT_FLOW_FLUSH_INTERVAL;
+DWORD g_maxPendingBatches = DEFAULT_MAX_PENDING_BATCHES;
 #ifdef _WIN32
 TCHAR g_configFile[MAX_PATH] = _T("C:\\nxflowd.conf");
 TCHAR g_logFile[MAX_PATH] = _T("C:\\nxflowd.log");
@@ -63,6 +66,7 @@ static TCHAR s_dbLogin[MAX_DB_LOGIN] = _T("netxms");
 static TCHAR s_dbPassword[MAX_PASSWORD] = _T("");
 static NX_CFG_TEMPLATE m_cfgTemplate[] =
 {
+   { _T("AggregateFlows"), CT_BOOLEAN, 0, 0, AF_AGGREGATE_FLOWS, 0, &g_flags },
    { _T("DBDriver"), CT_STRING, 0, 0, MAX_PATH, 0, s_dbDriver },
    { _T("DBDrvParams"), CT_STRING, 0, 0, MAX_PATH, 0, s_dbDrvParams },
    { _T("DBLogin"), CT_STRING, 0, 0, MAX_DB_LOGIN, 0, s_dbLogin },
@@ -71,11 +75,14 @@ static NX_CFG_TEMPLATE m_cfgTemplate[] =
    { _T("DBEncryptedPassword"), CT_STRING, 0, 0, MAX_PASSWORD, 0, s_dbPassword },
    { _T("DBSchema"), CT_STRING, 0, 0, MAX_DB_NAME, 0, s_dbSchema },
    { _T("DBServer"), CT_STRING, 0, 0, MAX_PATH, 0, s_dbServer },
+   { _T("FlowBatchSize"), CT_LONG, 0, 0, 0, 0, &g_flowBatchSize },
+   { _T("FlowFlushInterval"), CT_LONG, 0, 0, 0, 0, &g_flowFlushInterval },
    { _T("ListenAddress"), CT_STRING, 0, 0, MAX_PATH, 0, g_listenAddress },
    { _T("ListenPortTCP"), CT_LONG, 0, 0, 0, 0, &g_tcpPort },
    { _T("ListenPortUDP"), CT_LONG, 0, 0, 0, 0, &g_udpPort },
    { _T("LogFile"), CT_STRING, 0, 0, MAX_PATH, 0, g_logFile },
    { _T("LogFailedSQLQueries"), CT_BOOLEAN, 0, 0, AF_LOG_SQL_ERRORS, 0, &g_flags },
+   { _T("MaxPendingBatches"), CT_LONG, 0, 0, 0, 0, &g_maxPendingBatches },
    { _T("LogFile"), CT_STRING, 0, 0, MAX_PATH, 0, g_logFile },
    { _T(""), CT_END_OF_LIST, 0, 0, 0, 0, NULL }
 };
@@ -101,6 +108,8 @@ static bool LoadConfig()
       {
          g_flags &= ~AF_USE_SYSLOG;
       }
+      if (g_flowBatchSize < 1)
+         g_flowBatchSize = 1;
       success = true;
    }
 	delete config;
@@ -161,8 +170,14 @@ bool Initialize()
 	}
 	nxlog_debug(1, _T("Successfully connected to database %s@%s"), s_dbName, s_dbServer);
 
+	if (!StartFlowWriter())
+		return false;
+
 	if (!StartCollector())
+	{
+		StopFlowWriter();
 		return false;
+	}
 
 	return true;
 }
@@ -176,6 +191,7 @@ void Shutdown()
    g_flags |= AF_SHUTDOWN;
 
 	WaitForCollectorThread();
+	StopFlowWriter();
 
 	ipfix_cleanup();
    nxlog_close();
@@ -9,6 +9,7 @@
 #include <nms_common.h>
 #include <nms_util.h>
 #include <nms_threads.h>
+#include <nxqueue.h>
 #include <nxdbapi.h>
 #include <ipfix.h>
 #include <ipfix_col.h>
@@ -28,6 +29,10 @@
 
 #define IPFIX_DEFAULT_PORT       4739
 
+#define DEFAULT_FLOW_BATCH_SIZE        5000
+#define DEFAULT_FLOW_FLUSH_INTERVAL    1000
+#define DEFAULT_MAX_PENDING_BATCHES    100
+
 
 //
 // Application flags
@@ -37,9 +42,85 @@
 #define AF_DEBUG           0x00000002
 #define AF_USE_SYSLOG      0x00000004
 #define AF_LOG_SQL_ERRORS  0x00000008
+#define AF_AGGREGATE_FLOWS 0x00000010
 #define AF_SHUTDOWN        0x01000000
 
 
+/**
+ * Flow record fields (bit mask of fields present in record)
+ */
+#define FLOW_FIELD_EXPORTER_IP      0x0001
+#define FLOW_FIELD_SOURCE_MAC       0x0002
+#define FLOW_FIELD_DEST_MAC         0x0004
+#define FLOW_FIELD_SOURCE_IP        0x0008
+#define FLOW_FIELD_DEST_IP          0x0010
+#define FLOW_FIELD_PROTOCOL         0x0020
+#define FLOW_FIELD_SOURCE_PORT      0x0040
+#define FLOW_FIELD_DEST_PORT        0x0080
+#define FLOW_FIELD_OCTETS           0x0100
+#define FLOW_FIELD_PACKETS          0x0200
+#define FLOW_FIELD_INGRESS_IF       0x0400
+#define FLOW_FIELD_EGRESS_IF        0x0800
+
+/**
+ * Decoded flow record. IP addresses are in host byte order.
+ */
+struct FlowRecord
+{
+   INT64 startTime;
+   INT64 endTime;
+   UINT64 octets;
+   UINT64 packets;
+   UINT32 exporterIp;
+   UINT32 sourceIp;
+   UINT32 destIp;
+   UINT32 ingressInterface;
+   UINT32 egressInterface;
+   UINT32 fields;
+   UINT16 sourcePort;
+   UINT16 destPort;
+   BYTE protocol;
+   BYTE sourceMac[6];
+   BYTE destMac[6];
+};
+
+/**
+ * Batch of flow records stored by columns
+ */
+class FlowBatch
+{
+private:
+   int m_size;
+   int m_capacity;
+   INT64 m_createTime;
+   INT64 *m_startTime;
+   INT64 *m_endTime;
+   UINT64 *m_octets;
+   UINT64 *m_packets;
+   UINT32 *m_exporterIp;
+   UINT32 *m_sourceIp;
+   UINT32 *m_destIp;
+   UINT32 *m_ingressInterface;
+   UINT32 *m_egressInterface;
+   UINT32 *m_fields;
+   UINT16 *m_sourcePort;
+   UINT16 *m_destPort;
+   BYTE *m_protocol;
+   BYTE *m_sourceMac;
+   BYTE *m_destMac;
+
+public:
+   FlowBatch(int capacity);
+   ~FlowBatch();
+
+   void add(const FlowRecord *record);
+   void fillBulkInsert(DB_BULK_INSERT bi, INT64 *flowId) const;
+
+   int size() const { return m_size; }
+   bool isFull() const { return m_size == m_capacity; }
+   INT64 getCreateTime() const { return m_createTime; }
+};
+
 //
 // Functions
 //
@@ -51,6 +132,10 @@ void Main();
 bool StartCollector();
 void WaitForCollectorThread();
 
+bool StartFlowWriter();
+void StopFlowWriter();
+void QueueFlowBatch(FlowBatch *batch);
+
 #ifdef _WIN32
 void InitService();
 void InstallFlowCollectorService(const TCHAR *pszExecName);
@@ -75,5 +160,8 @@ extern TCHAR g_configFile[];
 extern TCHAR g_logFile[];
 extern int g_debugLevel;
 extern DB_HANDLE g_dbConnection;
+extern DWORD g_flowBatchSize;
+extern DWORD g_flowFlushInterval;
+extern DWORD g_maxPendingBatches;
 
 #endif
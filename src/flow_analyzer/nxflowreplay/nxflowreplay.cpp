@@ -0,0 +1,269 @@
+/*
+** nxflowreplay - replay recorded IPFIX messages to flow collector
+** Copyright (C) 2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: nxflowreplay.cpp
+**
+**/
+
+#include <nms_common.h>
+#include <nms_util.h>
+#include <netxms-version.h>
+
+NETXMS_EXECUTABLE_HEADER(nxflowreplay)
+
+/**
+ * IPFIX message header size and version
+ */
+#define IPFIX_HEADER_SIZE  16
+#define IPFIX_VERSION      10
+
+/**
+ * Options
+ */
+static uint32_t s_loops = 1;
+static uint32_t s_rate = 0;
+static uint16_t s_port = 4739;
+static bool s_updateExportTime = false;
+
+/**
+ * Recorded message
+ */
+struct Message
+{
+   const BYTE *data;
+   size_t size;
+};
+
+/**
+ * Split file content into IPFIX messages (file is expected to be in RFC 5655 format,
+ * i.e. sequence of IPFIX messages without any additional headers)
+ */
+static bool ParseFile(const char *fileName, const BYTE *data, size_t size, StructArray<Message> *messages)
+{
+   size_t offset = 0;
+   while(offset < size)
+   {
+      if (size - offset < IPFIX_HEADER_SIZE)
+      {
+         _tprintf(_T("%hs: truncated message header at offset ") UINT64_FMT _T("\n"), fileName, static_cast<uint64_t>(offset));
+         return false;
+      }
+
+      uint16_t version = (static_cast<uint16_t>(data[offset]) << 8) | data[offset + 1];
+      uint16_t length = (static_cast<uint16_t>(data[offset + 2]) << 8) | data[offset + 3];
+      if (version != IPFIX_VERSION)
+      {
+         _tprintf(_T("%hs: unsupported message version %d at offset ") UINT64_FMT _T("\n"), fileName, version, static_cast<uint64_t>(offset));
+         return false;
+      }
+      if ((length < IPFIX_HEADER_SIZE) || (length > size - offset))
+      {
+         _tprintf(_T("%hs: invalid message length %d at offset ") UINT64_FMT _T("\n"), fileName, length, static_cast<uint64_t>(offset));
+         return false;
+      }
+
+      Message *m = static_cast<Message*>(messages->addPlaceholder());
+      m->data = &data[offset];
+      m->size = length;
+      offset += length;
+   }
+   return true;
+}
+
+/**
+ * Send messages
+ */
+static void SendMessages(SOCKET s, StructArray<Message> *messages)
+{
+   uint32_t sent = 0, errors = 0;
+   uint64_t bytes = 0;
+   int64_t startTime = GetCurrentTimeMs();
+   BYTE buffer[65536];
+
+   uint32_t index = 0;
+   for(uint32_t loop = 0; loop < s_loops; loop++)
+   {
+      for(int i = 0; i < messages->size(); i++, index++)
+      {
+         // Rate control - check how many messages should be sent by now
+         if (s_rate > 0)
+         {
+            int64_t expected = static_cast<int64_t>(index) * 1000 / s_rate;
+            int64_t elapsed = GetCurrentTimeMs() - startTime;
+            if (expected > elapsed)
+               ThreadSleepMs(static_cast<uint32_t>(expected - elapsed));
+         }
+
+         Message *m = messages->get(i);
+         const BYTE *data = m->data;
+         if (s_updateExportTime)
+         {
+            memcpy(buffer, m->data, m->size);
+            uint32_t now = htonl(static_cast<uint32_t>(time(nullptr)));
+            memcpy(&buffer[4], &now, 4);
+            data = buffer;
+         }
+
+         if (send(s, reinterpret_cast<const char*>(data), static_cast<int>(m->size), 0) > 0)
+         {
+            sent++;
+            bytes += m->size;
+         }
+         else
+         {
+            errors++;
+         }
+      }
+   }
+
+   int64_t elapsed = GetCurrentTimeMs() - startTime;
+   _tprintf(_T("%u messages (") UINT64_FMT _T(" bytes) sent in ") INT64_FMT _T(" ms (%u errors, %u messages/sec)\n"), sent, bytes, elapsed, errors,
+            static_cast<uint32_t>((elapsed > 0) ? static_cast<int64_t>(sent) * 1000 / elapsed : sent));
+}
+
+/**
+ * Entry point
+ */
+int main(int argc, char *argv[])
+{
+   InitNetXMSProcess(true);
+
+   // Parse command line
+   opterr = 1;
+   int ch;
+   char *eptr;
+   while((ch = getopt(argc, argv, "hl:p:r:t")) != -1)
+   {
+      switch(ch)
+      {
+         case 'h':   // Display help and exit
+            _tprintf(_T("NetXMS IPFIX Replay Tool Version ") NETXMS_VERSION_STRING _T("\n\n")
+                     _T("Usage: nxflowreplay [options] host file [file ...]\n\n")
+                     _T("Files should contain IPFIX messages as defined in RFC 5655.\n\n")
+                     _T("Valid options are:\n")
+                     _T("   -h         : Display help and exit\n")
+                     _T("   -l count   : Number of times to replay all files (default is %u)\n")
+                     _T("   -p port    : Target UDP port (default is %d)\n")
+                     _T("   -r rate    : Messages per second (default is 0 - as fast as possible)\n")
+                     _T("   -t         : Set export time in message headers to current time\n")
+                     _T("\n"), s_loops, s_port);
+            return 0;
+         case 'l':   // Loop count
+            s_loops = strtoul(optarg, &eptr, 0);
+            if ((*eptr != 0) || (s_loops == 0))
+            {
+               _tprintf(_T("Invalid loop count \"%hs\"\n"), optarg);
+               return 1;
+            }
+            break;
+         case 'p':   // Port number
+            {
+               long port = strtol(optarg, &eptr, 0);
+               if ((*eptr != 0) || (port < 1) || (port > 65535))
+               {
+                  _tprintf(_T("Invalid port number \"%hs\"\n"), optarg);
+                  return 1;
+               }
+               s_port = static_cast<uint16_t>(port);
+            }
+            break;
+         case 'r':   // Rate
+            s_rate = strtoul(optarg, &eptr, 0);
+            if (*eptr != 0)
+            {
+               _tprintf(_T("Invalid rate \"%hs\"\n"), optarg);
+               return 1;
+            }
+            break;
+         case 't':
+            s_updateExportTime = true;
+            break;
+         case '?':
+            return 1;
+         default:
+            break;
+      }
+   }
+
+   if (argc - optind < 2)
+   {
+      _tprintf(_T("Usage: nxflowreplay [-h] [-l count] [-p port] [-r rate] [-t] host file [file ...]\n"));
+      return 1;
+   }
+
+#ifdef _WIN32
+   WSADATA wsaData;
+   WSAStartup(2, &wsaData);
+#endif
+
+   InetAddress target = InetAddress::resolveHostName(argv[optind]);
+   if (!target.isValid())
+   {
+      _tprintf(_T("Cannot resolve host name \"%hs\"\n"), argv[optind]);
+      return 2;
+   }
+
+   // Load all files into memory so that reading does not affect send rate
+   ObjectArray<ByteStream> files(16, 16, Ownership::True);
+   StructArray<Message> messages(0, 4096);
+   for(int i = optind + 1; i < argc; i++)
+   {
+#ifdef UNICODE
+      WCHAR fileName[MAX_PATH];
+      MultiByteToWideChar(CP_ACP, MB_PRECOMPOSED, argv[i], -1, fileName, MAX_PATH);
+      fileName[MAX_PATH - 1] = 0;
+#else
+      const char *fileName = argv[i];
+#endif
+      ByteStream *content = ByteStream::load(fileName);
+      if (content == nullptr)
+      {
+         _tprintf(_T("Cannot load file \"%hs\"\n"), argv[i]);
+         return 3;
+      }
+      files.add(content);
+
+      size_t size;
+      const BYTE *data = content->buffer(&size);
+      if (!ParseFile(argv[i], data, size, &messages))
+         return 3;
+   }
+   _tprintf(_T("%d messages loaded from %d files\n"), messages.size(), files.size());
+
+   SOCKET s = CreateSocket(target.getFamily(), SOCK_DGRAM, 0);
+   if (s == INVALID_SOCKET)
+   {
+      TCHAR buffer[1024];
+      _tprintf(_T("Cannot create socket (%s)\n"), GetLastSocketErrorText(buffer, 1024));
+      return 4;
+   }
+
+   SockAddrBuffer sa;
+   target.fillSockAddr(&sa, s_port);
+   if (connect(s, (struct sockaddr *)&sa, SA_LEN((struct sockaddr *)&sa)) != 0)
+   {
+      TCHAR buffer[1024];
+      _tprintf(_T("Cannot connect socket (%s)\n"), GetLastSocketErrorText(buffer, 1024));
+      closesocket(s);
+      return 4;
+   }
+
+   SendMessages(s, &messages);
+   closesocket(s);
+   return 0;
+}
@@ -1147,6 +1147,8 @@
    public static final long VID_RECORD_ID_COLUMN = 705;
    public static final long VID_OBJECT_ID_COLUMN = 706;
    public static final long VID_RAW_VALUE = 707;
+   public static final long VID_TABLE_BINARY_DATA = 708;
+   public static final long VID_ACCEPT_BINARY_TABLE = 709;
 
 	public static final long VID_ACL_USER_BASE = 0x00001000L;
 	public static final long VID_ACL_USER_LAST = 0x00001FFFL;
@@ -124,7 +124,12 @@ protected void fillParameterList()
          list.add(new AgentParameter("Server.Heap.Mapped", "Mapped server heap memory", DataType.UINT64)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.MemoryUsage.Alarms", "Server memory usage: alarms", DataType.UINT64)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.MemoryUsage.DataCollectionCache", "Server memory usage: data collection cache", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.MemoryUsage.DBWriterQueue", "Server memory usage: DB writer queues", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.MemoryUsage.Events", "Server memory usage: events", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.MemoryUsage.NXCPMessages", "Server memory usage: queued NXCP messages", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.MemoryUsage.Objects", "Server memory usage: objects", DataType.UINT64)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.MemoryUsage.RawDataWriter", "Server memory usage: raw data writer", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.MemoryUsage.ScriptVM", "Server memory usage: script VMs", DataType.UINT64)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.ObjectCount.Clusters", "Objects: clusters", DataType.UINT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.ObjectCount.Nodes", "Objects: nodes", DataType.UINT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.ObjectCount.Sensors", "Objects: sensors", DataType.UINT32)); //$NON-NLS-1$
@@ -139,6 +144,9 @@ protected void fillParameterList()
          list.add(new AgentParameter("Server.SyncerRunTime.Last", "Syncer run time: last", DataType.UINT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.SyncerRunTime.Max", "Syncer run time: max", DataType.UINT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.SyncerRunTime.Min", "Syncer run time: min", DataType.UINT32)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.SyslogProcessor.DroppedMessages", "Syslog messages dropped because processing queue limit was reached", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.SyslogProcessor.QueueLimit", "Syslog processing queue limit", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.SyslogReceiver.DroppedMessages", "Syslog messages dropped by OS because socket buffer was full", DataType.UINT64)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.ThreadPool.ActiveRequests(*)", "Thread pool {instance}: active requests", DataType.INT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.ThreadPool.CurrSize(*)", "Thread pool {instance}: current size", DataType.INT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.ThreadPool.Load(*)", "Thread pool {instance}: current load", DataType.INT32)); //$NON-NLS-1$
@@ -149,6 +157,9 @@ protected void fillParameterList()
          list.add(new AgentParameter("Server.ThreadPool.MinSize(*)", "Thread pool {instance}: minimum size", DataType.INT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.ThreadPool.ScheduledRequests(*)", "Thread pool {instance}: scheduled requests", DataType.INT32)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.ThreadPool.Usage(*)", "Thread pool {instance}: usage", DataType.INT32)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.ZeroMQ.DroppedMessages", "ZeroMQ messages dropped because publisher queue limit was reached", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.ZeroMQ.MessagesSent", "ZeroMQ messages sent since server start", DataType.UINT64)); //$NON-NLS-1$
+         list.add(new AgentParameter("Server.ZeroMQ.SendFailures", "ZeroMQ messages not sent because of socket error or full socket buffer", DataType.UINT64)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.TotalEventsProcessed", Messages.get().SelectInternalParamDlg_DCI_TotalEventsProcessed, DataType.UINT64)); //$NON-NLS-1$
          list.add(new AgentParameter("Server.Uptime", "Server uptime", DataType.INT32)); //$NON-NLS-1$
 		}
@@ -113,6 +113,22 @@ void ByteStream::writeStringUtf8(const char *s)
    write(s, len);
 }
 
+/**
+ * Write unsigned integer in variable length encoding (7 bits per byte, higher bit set if more bytes follow)
+ */
+void ByteStream::writeVarInt(uint64_t n)
+{
+   BYTE buffer[10];
+   int len = 0;
+   while(n >= 0x80)
+   {
+      buffer[len++] = static_cast<BYTE>(n | 0x80);
+      n >>= 7;
+   }
+   buffer[len++] = static_cast<BYTE>(n);
+   write(buffer, len);
+}
+
 /**
  * Read data
  */
@@ -316,6 +332,22 @@ char *ByteStream::readStringUtf8()
    return s;
 }
 
+/**
+ * Read unsigned integer in variable length encoding
+ */
+uint64_t ByteStream::readVarInt()
+{
+   uint64_t n = 0;
+   for(int shift = 0; (shift < 64) && (m_pos < m_size); shift += 7)
+   {
+      BYTE b = m_data[m_pos++];
+      n |= static_cast<uint64_t>(b & 0x7F) << shift;
+      if (!(b & 0x80))
+         break;
+   }
+   return n;
+}
+
 /**
  * Save byte stream to file
  */
@@ -89,6 +89,9 @@ static CONDITION s_writerStopCondition = INVALID_CONDITION_HANDLE;
 static NxLogDebugWriter s_debugWriter = NULL;
 static volatile DebugTagManager s_tagTree;
 static Mutex s_mutexDebugTagTreeWrite;
+static ObjectArray<DebugTagHandle> s_registeredTags(64, 64, Ownership::True);  // Protected by s_mutexDebugTagTreeWrite
+static volatile int32_t s_rootDebugLevel = 0;   // Cached level for "*"
+static volatile int32_t s_maxDebugLevel = 0;    // Highest level set for any tag
 
 /**
  * Swaps tag tree pointers and waits till reader count drops to 0
@@ -101,6 +104,33 @@ static inline void SwapAndWait()
       ThreadSleepMs(10);
 }
 
+/**
+ * Update cached debug levels after debug configuration change. Must be called with
+ * s_mutexDebugTagTreeWrite locked and after tree swap, so active tree is up to date.
+ */
+static void UpdateCachedDebugLevels()
+{
+   DebugTagTree *tagTree = s_tagTree.active;
+
+   int32_t maxLevel = tagTree->getRootDebugLevel();
+   ObjectArray<DebugTagInfo> *tags = tagTree->getAllTags();
+   for(int i = 0; i < tags->size(); i++)
+   {
+      if (tags->get(i)->level > maxLevel)
+         maxLevel = tags->get(i)->level;
+   }
+   delete tags;
+
+   for(int i = 0; i < s_registeredTags.size(); i++)
+   {
+      DebugTagHandle *handle = s_registeredTags.get(i);
+      handle->level = tagTree->getDebugLevel(handle->name);
+   }
+
+   s_rootDebugLevel = tagTree->getRootDebugLevel();
+   s_maxDebugLevel = maxLevel;
+}
+
 /**
  * Allocate string buffer on heap if requested size is bigger than local buffer size
  */
@@ -218,6 +248,7 @@ void LIBNETXMS_EXPORTABLE nxlog_set_debug_level(int level)
       SwapAndWait();
       s_tagTree.secondary->setRootDebugLevel(level); // Update the previously active tree
       InterlockedDecrement(&s_tagTree.secondary->m_writers);
+      UpdateCachedDebugLevels();
       s_mutexDebugTagTreeWrite.unlock();
    }
 }
@@ -247,6 +278,7 @@ void LIBNETXMS_EXPORTABLE nxlog_set_debug_level_tag(const TCHAR *tag, int level)
          s_tagTree.secondary->remove(tag);
       }
       InterlockedDecrement(&s_tagTree.secondary->m_writers);
+      UpdateCachedDebugLevels();
       s_mutexDebugTagTreeWrite.unlock();
    }
 }
@@ -261,6 +293,7 @@ void LIBNETXMS_EXPORTABLE nxlog_reset_debug_level_tags()
    SwapAndWait();
    s_tagTree.secondary->clear();
    InterlockedDecrement(&s_tagTree.secondary->m_writers);
+   UpdateCachedDebugLevels();
    s_mutexDebugTagTreeWrite.unlock();
 }
 
@@ -335,6 +368,38 @@ ObjectArray<DebugTagInfo> LIBNETXMS_EXPORTABLE *nxlog_get_all_debug_tags()
    return tags;
 }
 
+/**
+ * Register debug tag and get handle with cached effective debug level for it. Handle remains
+ * valid until process exit, and registering same tag again returns same handle. Should not be
+ * called from static initializers.
+ */
+DebugTagHandle LIBNETXMS_EXPORTABLE *nxlog_register_debug_tag(const TCHAR *tag)
+{
+   if (tag == nullptr)
+      tag = _T("*");
+
+   s_mutexDebugTagTreeWrite.lock();
+   DebugTagHandle *handle = nullptr;
+   for(int i = 0; i < s_registeredTags.size(); i++)
+   {
+      DebugTagHandle *h = s_registeredTags.get(i);
+      if (!_tcscmp(h->name, tag))
+      {
+         handle = h;
+         break;
+      }
+   }
+   if (handle == nullptr)
+   {
+      handle = new DebugTagHandle;
+      _tcslcpy(handle->name, tag, 64);
+      handle->level = s_tagTree.active->getDebugLevel(handle->name);
+      s_registeredTags.add(handle);
+   }
+   s_mutexDebugTagTreeWrite.unlock();
+   return handle;
+}
+
 /**
  * Set additional debug writer callback. It will be called for each line written with nxlog_debug.
  */
@@ -1308,7 +1373,7 @@ void LIBNETXMS_EXPORTABLE nxlog_write_tag2(INT16 severity, const TCHAR *tag, con
  */
 void LIBNETXMS_EXPORTABLE nxlog_debug(int level, const TCHAR *format, ...)
 {
-   if (level > nxlog_get_debug_level_tag(_T("*")))
+   if (level > s_rootDebugLevel)
       return;
 
    va_list args;
@@ -1322,7 +1387,7 @@ void LIBNETXMS_EXPORTABLE nxlog_debug(int level, const TCHAR *format, ...)
  */
 void LIBNETXMS_EXPORTABLE nxlog_debug2(int level, const TCHAR *format, va_list args)
 {
-   if (level > nxlog_get_debug_level_tag(_T("*")))
+   if (level > s_rootDebugLevel)
       return;
 
    WriteLog(NXLOG_DEBUG, NULL, format, args);
@@ -1333,7 +1398,7 @@ void LIBNETXMS_EXPORTABLE nxlog_debug2(int level, const TCHAR *format, va_list a
  */
 void LIBNETXMS_EXPORTABLE nxlog_debug_tag(const TCHAR *tag, int level, const TCHAR *format, ...)
 {
-   if (level > nxlog_get_debug_level_tag(tag))
+   if ((level > s_maxDebugLevel) || (level > nxlog_get_debug_level_tag(tag)))
       return;
 
    va_list args;
@@ -1347,7 +1412,7 @@ void LIBNETXMS_EXPORTABLE nxlog_debug_tag(const TCHAR *tag, int level, const TCH
  */
 void LIBNETXMS_EXPORTABLE nxlog_debug_tag2(const TCHAR *tag, int level, const TCHAR *format, va_list args)
 {
-   if (level > nxlog_get_debug_level_tag(tag))
+   if ((level > s_maxDebugLevel) || (level > nxlog_get_debug_level_tag(tag)))
       return;
 
    WriteLog(NXLOG_DEBUG, tag, format, args);
@@ -1358,6 +1423,9 @@ void LIBNETXMS_EXPORTABLE nxlog_debug_tag2(const TCHAR *tag, int level, const TC
  */
 void LIBNETXMS_EXPORTABLE nxlog_debug_tag_object(const TCHAR *tag, UINT32 objectId, int level, const TCHAR *format, ...)
 {
+   if (level > s_maxDebugLevel)
+      return;
+
    TCHAR fullTag[256];
    _sntprintf(fullTag, 256, _T("%s.%u"), tag, objectId);
    if (level > nxlog_get_debug_level_tag(fullTag))
@@ -1374,6 +1442,9 @@ void LIBNETXMS_EXPORTABLE nxlog_debug_tag_object(const TCHAR *tag, UINT32 object
  */
 void LIBNETXMS_EXPORTABLE nxlog_debug_tag_object2(const TCHAR *tag, UINT32 objectId, int level, const TCHAR *format, va_list args)
 {
+   if (level > s_maxDebugLevel)
+      return;
+
    TCHAR fullTag[256];
    _sntprintf(fullTag, 256, _T("%s.%u"), tag, objectId);
    if (level > nxlog_get_debug_level_tag(fullTag))
@@ -1382,6 +1453,31 @@ void LIBNETXMS_EXPORTABLE nxlog_debug_tag_object2(const TCHAR *tag, UINT32 objec
    WriteLog(NXLOG_DEBUG, fullTag, format, args);
 }
 
+/**
+ * Write debug message with registered tag
+ */
+void LIBNETXMS_EXPORTABLE nxlog_debug_tag(const DebugTagHandle *tag, int level, const TCHAR *format, ...)
+{
+   if (level > tag->level)
+      return;
+
+   va_list args;
+   va_start(args, format);
+   WriteLog(NXLOG_DEBUG, tag->name, format, args);
+   va_end(args);
+}
+
+/**
+ * Write debug message with registered tag
+ */
+void LIBNETXMS_EXPORTABLE nxlog_debug_tag2(const DebugTagHandle *tag, int level, const TCHAR *format, va_list args)
+{
+   if (level > tag->level)
+      return;
+
+   WriteLog(NXLOG_DEBUG, tag->name, format, args);
+}
+
 /**
  * Call ReportEvent if writing to Windows Event Log, otherwise write normal message using provided alternative text
  */
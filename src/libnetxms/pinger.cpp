@@ -0,0 +1,861 @@
+/*
+** libnetxms - Common NetXMS utility library
+** Copyright (C) 2003-2020 Victor Kirhenshtein
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published
+** by the Free Software Foundation; either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: pinger.cpp
+**
+**/
+
+#include "libnetxms.h"
+
+#define DEBUG_TAG _T("icmp.pinger")
+
+/**
+ * Max size for ping packet
+ */
+#define MAX_PING_SIZE      8192
+
+#ifdef _WIN32
+
+/**
+ * Asynchronous ping request
+ */
+struct PingRequest
+{
+   InetAddress addr;
+   UINT32 timeout;
+   UINT32 packetSize;
+   bool dontFragment;
+   IcmpPingCallback callback;
+   void *context;
+};
+
+/**
+ * Pinger state. ICMP API on Windows is blocking, so requests are executed by thread pool.
+ */
+static Mutex s_lock;
+static ThreadPool *s_pool = nullptr;
+static bool s_shutdown = false;
+static int s_users = 0;
+
+/**
+ * Execute ping request
+ */
+static void ExecuteRequest(PingRequest *request)
+{
+   UINT32 rtt = 0;
+   UINT32 result = IcmpPing(request->addr, 1, request->timeout, &rtt, request->packetSize, request->dontFragment);
+   request->callback(result, rtt, request->context);
+   delete request;
+}
+
+/**
+ * Send ICMP echo request to given address. Callback will be called exactly once when reply
+ * is received or request is timed out. Returns false if request cannot be sent (callback
+ * will not be called in that case).
+ */
+bool LIBNETXMS_EXPORTABLE IcmpPingAsync(const InetAddress& addr, UINT32 timeout, UINT32 packetSize, bool dontFragment, IcmpPingCallback callback, void *context)
+{
+   s_lock.lock();
+   if (s_shutdown)
+   {
+      s_lock.unlock();
+      return false;
+   }
+   if (s_pool == nullptr)
+      s_pool = ThreadPoolCreate(_T("PINGER"), 4, 256);
+
+   PingRequest *request = new PingRequest();
+   request->addr = addr;
+   request->timeout = timeout;
+   request->packetSize = packetSize;
+   request->dontFragment = dontFragment;
+   request->callback = callback;
+   request->context = context;
+   ThreadPoolExecute(s_pool, ExecuteRequest, request);
+   s_lock.unlock();
+   return true;
+}
+
+/**
+ * Register pinger user. Pinger is started on first request and shut down when last registered
+ * user calls ShutdownIcmpPinger(), after that it can be started again by new users.
+ */
+void LIBNETXMS_EXPORTABLE InitIcmpPinger()
+{
+   s_lock.lock();
+   s_users++;
+   s_shutdown = false;
+   s_lock.unlock();
+}
+
+/**
+ * Unregister pinger user and shutdown pinger if there are no more users. All outstanding requests will be completed.
+ */
+void LIBNETXMS_EXPORTABLE ShutdownIcmpPinger()
+{
+   s_lock.lock();
+   if ((s_users > 0) && (--s_users > 0))
+   {
+      s_lock.unlock();
+      return;
+   }
+   s_shutdown = true;
+   ThreadPool *pool = s_pool;
+   s_pool = nullptr;
+   s_lock.unlock();
+   if (pool != nullptr)
+      ThreadPoolDestroy(pool);
+}
+
+#else /* _WIN32 */
+
+/**
+ * Timer wheel resolution in milliseconds
+ */
+#define PINGER_TICK           10
+
+/**
+ * Number of timer wheel slots (one wheel rotation covers 5.12 seconds, longer
+ * timeouts wait for additional rotations)
+ */
+#define PINGER_WHEEL_SIZE     512
+
+/**
+ * Number of ICMP identifiers used by pinger. Each identifier provides 65536
+ * sequence numbers, so up to 131072 requests can be outstanding at once.
+ */
+#define PINGER_ID_COUNT       2
+#define PINGER_MAX_REQUESTS   (PINGER_ID_COUNT * 65536)
+
+#ifdef __HP_aCC
+#pragma pack 1
+#else
+#pragma pack(1)
+#endif
+
+/**
+ * ICMPv6 echo header
+ */
+struct ICMP6_ECHO_HEADER
+{
+   BYTE type;
+   BYTE code;
+   UINT16 checksum;
+   UINT16 id;
+   UINT16 sequence;
+};
+
+#ifdef __HP_aCC
+#pragma pack
+#else
+#pragma pack()
+#endif
+
+/**
+ * Outstanding ping request
+ */
+struct PingRequest
+{
+   PingRequest *prev;   // timer wheel slot list
+   PingRequest *next;
+   InetAddress addr;
+   int64_t sendTime;
+   int64_t expirationTick;
+   UINT32 index;        // position in request table
+   UINT32 result;
+   UINT32 rtt;
+   IcmpPingCallback callback;
+   void *context;
+};
+
+/**
+ * Pinger state. Single raw socket per address family (and fragmentation mode) is shared by
+ * all requests. Replies are matched to requests by ICMP identifier and sequence number.
+ */
+static Mutex s_lock;
+static SOCKET s_sockets[2][2] = { { INVALID_SOCKET, INVALID_SOCKET }, { INVALID_SOCKET, INVALID_SOCKET } };
+static PingRequest **s_requests = nullptr;
+static UINT32 s_nextIndex = 0;
+static int s_pendingRequests = 0;
+static PingRequest *s_wheel[PINGER_WHEEL_SIZE];
+static int64_t s_lastTick = 0;
+static UINT16 s_idBase = 0;
+static int s_controlPipe[2] = { -1, -1 };
+static THREAD s_receiverThread = INVALID_THREAD_HANDLE;
+static bool s_started = false;
+static bool s_shutdown = false;
+static int s_users = 0;
+
+/**
+ * Send command to receiver thread via control pipe. Returns false on failure.
+ */
+static bool WakeupReceiver(char command)
+{
+   ssize_t rc;
+   do
+   {
+      rc = write(s_controlPipe[1], &command, 1);
+   } while((rc == -1) && (errno == EINTR));
+   if (rc == 1)
+      return true;
+   nxlog_debug_tag(DEBUG_TAG, 1, _T("ICMP pinger: cannot write to control pipe (%s)"), _tcserror(errno));
+   return false;
+}
+
+/**
+ * Add request to timer wheel. Must be called with lock held.
+ */
+static inline void WheelAdd(PingRequest *r)
+{
+   PingRequest **slot = &s_wheel[r->expirationTick % PINGER_WHEEL_SIZE];
+   r->prev = nullptr;
+   r->next = *slot;
+   if (*slot != nullptr)
+      (*slot)->prev = r;
+   *slot = r;
+}
+
+/**
+ * Remove request from timer wheel. Must be called with lock held.
+ */
+static inline void WheelRemove(PingRequest *r)
+{
+   if (r->prev != nullptr)
+      r->prev->next = r->next;
+   else
+      s_wheel[r->expirationTick % PINGER_WHEEL_SIZE] = r->next;
+   if (r->next != nullptr)
+      r->next->prev = r->prev;
+}
+
+/**
+ * Complete request: remove it from wheel and request table and add to completion list.
+ * Must be called with lock held.
+ */
+static void CompleteRequest(PingRequest *r, UINT32 result, UINT32 rtt, ObjectArray<PingRequest> *completed)
+{
+   WheelRemove(r);
+   s_requests[r->index] = nullptr;
+   s_pendingRequests--;
+   r->result = result;
+   r->rtt = rtt;
+   completed->add(r);
+}
+
+/**
+ * Find request by ICMP identifier and sequence number. Must be called with lock held.
+ */
+static inline PingRequest *FindRequest(UINT16 id, UINT16 sequence)
+{
+   UINT16 n = static_cast<UINT16>(id - s_idBase);
+   if (n >= PINGER_ID_COUNT)
+      return nullptr;
+   return s_requests[(static_cast<UINT32>(n) << 16) | sequence];
+}
+
+/**
+ * Process received ICMP packet. Must be called with lock held.
+ */
+static void ProcessPacket(int family, const BYTE *packet, size_t size, const SockAddrBuffer *source, ObjectArray<PingRequest> *completed, int64_t now)
+{
+   if (family == AF_INET)
+   {
+      // Raw IPv4 socket delivers packets with IP header
+      if (size < sizeof(IPHDR))
+         return;
+      size_t hlen = (packet[0] & 0x0F) * 4;
+      if (size < hlen + sizeof(ICMPHDR))
+         return;
+      const ICMPHDR *icmp = reinterpret_cast<const ICMPHDR*>(packet + hlen);
+      if (icmp->m_cType == 0)  // Echo reply
+      {
+         PingRequest *r = FindRequest(ntohs(icmp->m_wId), ntohs(icmp->m_wSeq));
+         if ((r != nullptr) && (r->addr.getFamily() == AF_INET) && (htonl(r->addr.getAddressV4()) == source->sa4.sin_addr.s_addr))
+            CompleteRequest(r, ICMP_SUCCESS, static_cast<UINT32>(now - r->sendTime), completed);
+      }
+      else if ((icmp->m_cType == 3) || (icmp->m_cType == 11))  // Destination unreachable or time exceeded
+      {
+         // Error report contains IP header and first 8 bytes of original packet
+         const BYTE *orig = packet + hlen + sizeof(ICMPHDR);
+         if (size < hlen + sizeof(ICMPHDR) + sizeof(IPHDR))
+            return;
+         size_t ohlen = (orig[0] & 0x0F) * 4;
+         if (size < hlen + sizeof(ICMPHDR) + ohlen + sizeof(ICMPHDR))
+            return;
+         const ICMPHDR *oicmp = reinterpret_cast<const ICMPHDR*>(orig + ohlen);
+         if (oicmp->m_cType != 8)
+            return;
+         PingRequest *r = FindRequest(ntohs(oicmp->m_wId), ntohs(oicmp->m_wSeq));
+         if ((r != nullptr) && (r->addr.getFamily() == AF_INET) &&
+             (htonl(r->addr.getAddressV4()) == reinterpret_cast<const IPHDR*>(orig)->m_iaDst.s_addr))
+            CompleteRequest(r, ICMP_UNREACHABLE, 0, completed);
+      }
+   }
+#ifdef WITH_IPV6
+   else
+   {
+      // Raw IPv6 socket delivers ICMPv6 packets without IP header
+      if (size < sizeof(ICMP6_ECHO_HEADER))
+         return;
+      const ICMP6_ECHO_HEADER *icmp = reinterpret_cast<const ICMP6_ECHO_HEADER*>(packet);
+      if (icmp->type == 129)  // Echo reply
+      {
+         PingRequest *r = FindRequest(ntohs(icmp->id), ntohs(icmp->sequence));
+         if ((r != nullptr) && (r->addr.getFamily() == AF_INET6) && !memcmp(r->addr.getAddressV6(), source->sa6.sin6_addr.s6_addr, 16))
+            CompleteRequest(r, ICMP_SUCCESS, static_cast<UINT32>(now - r->sendTime), completed);
+      }
+      else if ((icmp->type == 1) || (icmp->type == 3))  // Destination unreachable or time exceeded
+      {
+         // Error report contains IPv6 header (40 bytes) and start of original packet
+         if (size < 8 + 40 + sizeof(ICMP6_ECHO_HEADER))
+            return;
+         const ICMP6_ECHO_HEADER *oicmp = reinterpret_cast<const ICMP6_ECHO_HEADER*>(packet + 48);
+         if (oicmp->type != 128)
+            return;
+         PingRequest *r = FindRequest(ntohs(oicmp->id), ntohs(oicmp->sequence));
+         if ((r != nullptr) && (r->addr.getFamily() == AF_INET6) && !memcmp(r->addr.getAddressV6(), packet + 32, 16))
+            CompleteRequest(r, ICMP_UNREACHABLE, 0, completed);
+      }
+   }
+#endif
+}
+
+/**
+ * Expire timed out requests. Must be called with lock held.
+ */
+static void ProcessTimers(int64_t now, ObjectArray<PingRequest> *completed)
+{
+   int64_t currTick = now / PINGER_TICK;
+   int64_t tick = (currTick - s_lastTick > PINGER_WHEEL_SIZE) ? currTick - PINGER_WHEEL_SIZE + 1 : s_lastTick + 1;
+   for(; tick <= currTick; tick++)
+   {
+      PingRequest *r = s_wheel[tick % PINGER_WHEEL_SIZE];
+      while(r != nullptr)
+      {
+         PingRequest *next = r->next;
+         if (r->expirationTick <= currTick)
+            CompleteRequest(r, ICMP_TIMEOUT, 0, completed);
+         r = next;
+      }
+   }
+   s_lastTick = currTick;
+}
+
+/**
+ * Call callbacks for completed requests (should be called without lock)
+ */
+static void NotifyCompleted(ObjectArray<PingRequest> *completed)
+{
+   for(int i = 0; i < completed->size(); i++)
+   {
+      PingRequest *r = completed->get(i);
+      r->callback(r->result, r->rtt, r->context);
+      delete r;
+   }
+   completed->clear();
+}
+
+/**
+ * Receiver thread
+ */
+static void ReceiverThread()
+{
+   nxlog_debug_tag(DEBUG_TAG, 2, _T("ICMP pinger receiver thread started"));
+
+   BYTE *buffer = MemAllocArrayNoInit<BYTE>(MAX_PING_SIZE + 128);
+   ObjectArray<PingRequest> completed(256, 256, Ownership::False);
+   SocketPoller sp;
+   while(true)
+   {
+      sp.reset();
+      sp.add(s_controlPipe[0]);
+      s_lock.lock();
+      for(int i = 0; i < 2; i++)
+         for(int j = 0; j < 2; j++)
+            if (s_sockets[i][j] != INVALID_SOCKET)
+               sp.add(s_sockets[i][j]);
+      UINT32 timeout = (s_pendingRequests > 0) ? PINGER_TICK - static_cast<UINT32>(GetCurrentTimeMs() % PINGER_TICK) : INFINITE;
+      s_lock.unlock();
+
+      int rc = sp.poll(timeout);
+      if ((rc < 0) && (errno != EINTR))
+      {
+         nxlog_debug_tag(DEBUG_TAG, 1, _T("ICMP pinger: poll() failed (%s)"), _tcserror(errno));
+         ThreadSleepMs(PINGER_TICK);
+      }
+
+      if ((rc > 0) && sp.isSet(s_controlPipe[0]))
+      {
+         char data[64];
+         ssize_t bytes;
+         do
+         {
+            bytes = read(s_controlPipe[0], data, sizeof(data));
+         } while((bytes == -1) && (errno == EINTR));
+         if (bytes <= 0)
+         {
+            // Reject new requests, callers will fall back to synchronous ping
+            nxlog_debug_tag(DEBUG_TAG, 1, _T("ICMP pinger: cannot read from control pipe (%s)"), (bytes == 0) ? _T("pipe closed") : _tcserror(errno));
+            s_lock.lock();
+            s_shutdown = true;
+            s_lock.unlock();
+            break;
+         }
+         if (s_shutdown)
+            break;
+      }
+
+      s_lock.lock();
+      int64_t now = GetCurrentTimeMs();
+      if (rc > 0)
+      {
+         for(int i = 0; i < 2; i++)
+         {
+            for(int j = 0; j < 2; j++)
+            {
+               SOCKET s = s_sockets[i][j];
+               if ((s == INVALID_SOCKET) || !sp.isSet(s))
+                  continue;
+
+               // Read all available packets
+               while(true)
+               {
+                  SockAddrBuffer source;
+                  socklen_t addrLen = sizeof(source);
+                  ssize_t bytes = recvfrom(s, reinterpret_cast<char*>(buffer), MAX_PING_SIZE + 128, MSG_DONTWAIT, reinterpret_cast<struct sockaddr*>(&source), &addrLen);
+                  if (bytes <= 0)
+                     break;
+                  ProcessPacket((i == 0) ? AF_INET : AF_INET6, buffer, bytes, &source, &completed, now);
+               }
+            }
+         }
+      }
+      ProcessTimers(now, &completed);
+      s_lock.unlock();
+
+      NotifyCompleted(&completed);
+   }
+
+   // Complete all outstanding requests
+   s_lock.lock();
+   for(int i = 0; i < PINGER_WHEEL_SIZE; i++)
+   {
+      while(s_wheel[i] != nullptr)
+         CompleteRequest(s_wheel[i], ICMP_API_ERROR, 0, &completed);
+   }
+   s_lock.unlock();
+   NotifyCompleted(&completed);
+
+   MemFree(buffer);
+   nxlog_debug_tag(DEBUG_TAG, 2, _T("ICMP pinger receiver thread stopped"));
+}
+
+/**
+ * Start pinger. Must be called with lock held.
+ */
+static bool StartPinger()
+{
+   if (s_started)
+      return true;
+
+   if (pipe(s_controlPipe) != 0)
+   {
+      nxlog_debug_tag(DEBUG_TAG, 1, _T("Cannot create control pipe for ICMP pinger (%s)"), _tcserror(errno));
+      return false;
+   }
+
+   s_requests = MemAllocArray<PingRequest*>(PINGER_MAX_REQUESTS);
+   memset(s_wheel, 0, sizeof(s_wheel));
+   s_lastTick = GetCurrentTimeMs() / PINGER_TICK;
+
+   // Random component reduces chance of identifier collision with other pinger instances
+   // (processes in different PID namespaces can have same PID)
+   UINT16 r;
+   GenerateRandomBytes(reinterpret_cast<BYTE*>(&r), sizeof(r));
+   s_idBase = static_cast<UINT16>(getpid() * PINGER_ID_COUNT + r);
+
+   s_receiverThread = ThreadCreateEx(ReceiverThread);
+   s_started = true;
+   return true;
+}
+
+/**
+ * Get socket for given address family and fragmentation mode. Must be called with lock held.
+ */
+static SOCKET GetSocket(int family, bool dontFragment)
+{
+   SOCKET *s = &s_sockets[(family == AF_INET) ? 0 : 1][dontFragment ? 1 : 0];
+   if (*s != INVALID_SOCKET)
+      return *s;
+
+#ifdef WITH_IPV6
+   SOCKET sock = CreateSocket(family, SOCK_RAW, (family == AF_INET) ? static_cast<int>(IPPROTO_ICMP) : static_cast<int>(IPPROTO_ICMPV6));
+#else
+   SOCKET sock = CreateSocket(family, SOCK_RAW, IPPROTO_ICMP);
+#endif
+   if (sock == INVALID_SOCKET)
+   {
+      nxlog_debug_tag(DEBUG_TAG, 4, _T("Cannot create raw socket for ICMP pinger (%s)"), _tcserror(errno));
+      return INVALID_SOCKET;
+   }
+
+   if (dontFragment)
+   {
+      if (family == AF_INET)
+      {
+#if HAVE_DECL_IP_MTU_DISCOVER
+         int v = IP_PMTUDISC_DO;
+         setsockopt(sock, IPPROTO_IP, IP_MTU_DISCOVER, &v, sizeof(v));
+#elif HAVE_DECL_IP_DONTFRAG
+         int v = 1;
+         setsockopt(sock, IPPROTO_IP, IP_DONTFRAG, &v, sizeof(v));
+#else
+         closesocket(sock);
+         return INVALID_SOCKET;
+#endif
+      }
+#if defined(WITH_IPV6) && defined(IPV6_DONTFRAG)
+      else
+      {
+         int v = 1;
+         setsockopt(sock, IPPROTO_IPV6, IPV6_DONTFRAG, &v, sizeof(v));
+      }
+#endif
+   }
+
+   // Large receive buffer to avoid drops when many replies arrive at once
+   int bufferSize = 1024 * 1024;
+   setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+   *s = sock;
+   WakeupReceiver('S');  // wake up receiver thread to include new socket
+   return sock;
+}
+
+/**
+ * Send ICMP echo request to given address. Callback will be called exactly once when reply
+ * is received or request is timed out. Callbacks are called from pinger thread and should
+ * not block. Returns false if request cannot be sent (callback will not be called in that case).
+ */
+bool LIBNETXMS_EXPORTABLE IcmpPingAsync(const InetAddress& addr, UINT32 timeout, UINT32 packetSize, bool dontFragment, IcmpPingCallback callback, void *context)
+{
+   int family = addr.getFamily();
+#ifdef WITH_IPV6
+   if ((family != AF_INET) && (family != AF_INET6))
+      return false;
+#else
+   if (family != AF_INET)
+      return false;
+#endif
+
+   s_lock.lock();
+   if (s_shutdown || !StartPinger() || (s_pendingRequests >= PINGER_MAX_REQUESTS))
+   {
+      s_lock.unlock();
+      return false;
+   }
+
+   SOCKET sock = GetSocket(family, dontFragment);
+   if (sock == INVALID_SOCKET)
+   {
+      s_lock.unlock();
+      return false;
+   }
+
+   // Find free slot in request table
+   while(s_requests[s_nextIndex] != nullptr)
+      s_nextIndex = (s_nextIndex + 1) % PINGER_MAX_REQUESTS;
+   UINT32 index = s_nextIndex;
+   s_nextIndex = (s_nextIndex + 1) % PINGER_MAX_REQUESTS;
+   UINT16 id = static_cast<UINT16>(s_idBase + (index >> 16));
+   UINT16 sequence = static_cast<UINT16>(index & 0xFFFF);
+
+   // Build packet
+   static const char payload[] = "NetXMS ICMP probe [01234567890]";
+   BYTE packet[MAX_PING_SIZE];
+   size_t bytes;
+   if (family == AF_INET)
+   {
+      bytes = std::max(static_cast<size_t>(std::min(packetSize, static_cast<UINT32>(MAX_PING_SIZE))), sizeof(IPHDR) + sizeof(ICMPHDR)) - sizeof(IPHDR);
+      memset(packet, 0, bytes);
+      ICMPHDR *h = reinterpret_cast<ICMPHDR*>(packet);
+      h->m_cType = 8;   // ICMP ECHO REQUEST
+      h->m_wId = htons(id);
+      h->m_wSeq = htons(sequence);
+      memcpy(packet + sizeof(ICMPHDR), payload, std::min(bytes - sizeof(ICMPHDR), sizeof(payload)));
+      h->m_wChecksum = CalculateIPChecksum(packet, bytes);
+   }
+   else
+   {
+      // Checksum for ICMPv6 is always calculated by kernel
+      bytes = std::max(static_cast<size_t>(std::min(packetSize, static_cast<UINT32>(MAX_PING_SIZE))), 40 + sizeof(ICMP6_ECHO_HEADER)) - 40;
+      memset(packet, 0, bytes);
+      ICMP6_ECHO_HEADER *h = reinterpret_cast<ICMP6_ECHO_HEADER*>(packet);
+      h->type = 128;   // ICMPv6 Echo Request
+      h->id = htons(id);
+      h->sequence = htons(sequence);
+      memcpy(packet + sizeof(ICMP6_ECHO_HEADER), payload, std::min(bytes - sizeof(ICMP6_ECHO_HEADER), sizeof(payload)));
+   }
+
+   SockAddrBuffer sa;
+   addr.fillSockAddr(&sa);
+   int64_t now = GetCurrentTimeMs();
+   if (sendto(sock, reinterpret_cast<char*>(packet), bytes, 0, reinterpret_cast<struct sockaddr*>(&sa), SA_LEN(reinterpret_cast<struct sockaddr*>(&sa))) != static_cast<ssize_t>(bytes))
+   {
+      s_lock.unlock();
+      nxlog_debug_tag(DEBUG_TAG, 7, _T("ICMP pinger: sendto() failed for %s (%s)"), (const TCHAR *)addr.toString(), _tcserror(errno));
+      callback(ICMP_SEND_FAILED, 0, context);
+      return true;
+   }
+
+   PingRequest *r = new PingRequest();
+   r->addr = addr;
+   r->sendTime = now;
+   r->expirationTick = (now + timeout + PINGER_TICK - 1) / PINGER_TICK;
+   if (r->expirationTick <= s_lastTick)
+      r->expirationTick = s_lastTick + 1;
+   r->index = index;
+   r->callback = callback;
+   r->context = context;
+   s_requests[index] = r;
+   WheelAdd(r);
+   if (s_pendingRequests++ == 0)
+      WakeupReceiver('W');  // wake up receiver thread to start timer processing
+   s_lock.unlock();
+   return true;
+}
+
+/**
+ * Register pinger user. Pinger is started on first request and shut down when last registered
+ * user calls ShutdownIcmpPinger(), after that it can be started again by new users.
+ */
+void LIBNETXMS_EXPORTABLE InitIcmpPinger()
+{
+   s_lock.lock();
+   s_users++;
+   if (!s_started)
+      s_shutdown = false;  // pinger stopped by previous users can be started again
+   s_lock.unlock();
+}
+
+/**
+ * Unregister pinger user and shutdown pinger if there are no more users. All outstanding
+ * requests will be completed with ICMP_API_ERROR.
+ */
+void LIBNETXMS_EXPORTABLE ShutdownIcmpPinger()
+{
+   s_lock.lock();
+   if ((s_users > 0) && (--s_users > 0))
+   {
+      s_lock.unlock();
+      return;
+   }
+   s_shutdown = true;
+   if (!s_started)
+   {
+      s_lock.unlock();
+      return;
+   }
+   if (!WakeupReceiver('X'))
+   {
+      // Receiver thread cannot be stopped, leave it running until process exit
+      ThreadDetach(s_receiverThread);
+      s_receiverThread = INVALID_THREAD_HANDLE;
+      s_lock.unlock();
+      return;
+   }
+   s_lock.unlock();
+
+   ThreadJoin(s_receiverThread);
+   s_receiverThread = INVALID_THREAD_HANDLE;
+
+   s_lock.lock();
+   for(int i = 0; i < 2; i++)
+   {
+      for(int j = 0; j < 2; j++)
+      {
+         if (s_sockets[i][j] != INVALID_SOCKET)
+         {
+            closesocket(s_sockets[i][j]);
+            s_sockets[i][j] = INVALID_SOCKET;
+         }
+      }
+   }
+   close(s_controlPipe[0]);
+   close(s_controlPipe[1]);
+   MemFreeAndNull(s_requests);
+   s_started = false;
+   if (s_users > 0)
+      s_shutdown = false;  // new user registered while pinger was stopping
+   s_lock.unlock();
+}
+
+#endif /* _WIN32 */
+
+/**
+ * Synchronous ping request
+ */
+struct SyncPingRequest
+{
+   Condition completed;
+   UINT32 result;
+   UINT32 rtt;
+
+   SyncPingRequest() : completed(true)
+   {
+      result = ICMP_API_ERROR;
+      rtt = 0;
+   }
+};
+
+/**
+ * Callback for synchronous ping
+ */
+static void SyncPingCallback(UINT32 result, UINT32 rtt, void *context)
+{
+   SyncPingRequest *request = static_cast<SyncPingRequest*>(context);
+   request->result = result;
+   request->rtt = rtt;
+   request->completed.set();
+}
+
+/**
+ * Do an ICMP ping to specific IP address using shared pinger. Parameters and return
+ * value are the same as for IcmpPing(). Falls back to IcmpPing() if shared pinger
+ * cannot be used.
+ */
+UINT32 LIBNETXMS_EXPORTABLE IcmpPingShared(const InetAddress& addr, int numRetries, UINT32 timeout, UINT32 *rtt, UINT32 packetSize, bool dontFragment)
+{
+   UINT32 result = ICMP_API_ERROR;
+   for(int i = 0; i < numRetries; i++)
+   {
+      SyncPingRequest request;
+      if (!IcmpPingAsync(addr, timeout, packetSize, dontFragment, SyncPingCallback, &request))
+         return (i == 0) ? IcmpPing(addr, numRetries, timeout, rtt, packetSize, dontFragment) : result;
+      request.completed.wait(INFINITE);
+      result = request.result;
+      if (result == ICMP_SUCCESS)
+      {
+         if (rtt != nullptr)
+            *rtt = request.rtt;
+         break;
+      }
+      if (result != ICMP_TIMEOUT)
+         break;  // fatal error
+   }
+   return result;
+}
+
+/**
+ * State of IcmpPingMultiple call
+ */
+struct MultiPingState
+{
+   Condition completed;
+   VolatileCounter pending;
+   int numRetries;
+   UINT32 timeout;
+   UINT32 packetSize;
+   bool dontFragment;
+
+   MultiPingState() : completed(true)
+   {
+      pending = 0;
+      numRetries = 1;
+      timeout = 0;
+      packetSize = 0;
+      dontFragment = false;
+   }
+};
+
+/**
+ * Single request within IcmpPingMultiple call
+ */
+struct MultiPingRequest
+{
+   MultiPingState *state;
+   IcmpPingTarget *target;
+   int attempt;
+};
+
+/**
+ * Complete single request within IcmpPingMultiple call
+ */
+static void CompleteMultiPingRequest(MultiPingRequest *request, UINT32 result, UINT32 rtt)
+{
+   request->target->result = result;
+   request->target->rtt = rtt;
+   if (InterlockedDecrement(&request->state->pending) == 0)
+      request->state->completed.set();
+}
+
+/**
+ * Callback for IcmpPingMultiple. Timed out requests are re-sent from callback until retry count is exhausted.
+ */
+static void MultiPingCallback(UINT32 result, UINT32 rtt, void *context)
+{
+   MultiPingRequest *request = static_cast<MultiPingRequest*>(context);
+   MultiPingState *state = request->state;
+   if ((result == ICMP_TIMEOUT) && (++request->attempt < state->numRetries) &&
+       IcmpPingAsync(request->target->addr, state->timeout, state->packetSize, state->dontFragment, MultiPingCallback, request))
+      return;
+   CompleteMultiPingRequest(request, result, rtt);
+}
+
+/**
+ * Ping multiple addresses in parallel using shared pinger. Requests to all targets are sent at once
+ * and function returns when all of them are completed. Result code (one of ICMP_xxx) and round trip
+ * time are stored in each target. Falls back to IcmpPing() for targets that cannot be pinged via
+ * shared pinger. Returns number of targets that responded.
+ */
+int LIBNETXMS_EXPORTABLE IcmpPingMultiple(IcmpPingTarget *targets, int count, int numRetries, UINT32 timeout, UINT32 packetSize, bool dontFragment)
+{
+   if (count <= 0)
+      return 0;
+
+   MultiPingState state;
+   state.pending = count;
+   state.numRetries = numRetries;
+   state.timeout = timeout;
+   state.packetSize = packetSize;
+   state.dontFragment = dontFragment;
+
+   MultiPingRequest *requests = new MultiPingRequest[count];
+   for(int i = 0; i < count; i++)
+   {
+      targets[i].result = ICMP_API_ERROR;
+      targets[i].rtt = 0;
+      requests[i].state = &state;
+      requests[i].target = &targets[i];
+      requests[i].attempt = 0;
+      if (!IcmpPingAsync(targets[i].addr, timeout, packetSize, dontFragment, MultiPingCallback, &requests[i]))
+      {
+         UINT32 rtt = 0;
+         UINT32 result = IcmpPing(targets[i].addr, numRetries, timeout, &rtt, packetSize, dontFragment);
+         CompleteMultiPingRequest(&requests[i], result, rtt);
+      }
+   }
+   state.completed.wait(INFINITE);
+   delete[] requests;
+
+   int responded = 0;
+   for(int i = 0; i < count; i++)
+      if (targets[i].result == ICMP_SUCCESS)
+         responded++;
+   return responded;
+}
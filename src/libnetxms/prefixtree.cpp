@@ -0,0 +1,351 @@
+/*
+** NetXMS - Network Management System
+** Utility Library
+** Copyright (C) 2003-2020 Victor Kirhenshtein
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published
+** by the Free Software Foundation; either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: prefixtree.cpp
+**
+**/
+
+#include "libnetxms.h"
+
+/**
+ * Prefix tree node. Nodes without value are "glue" nodes created at branching points.
+ */
+struct InetAddressPrefixTreeNode
+{
+   BYTE key[16];
+   int bits;
+   bool hasValue;
+   void *value;
+   InetAddressPrefixTreeNode *child[2];
+};
+
+/**
+ * Get bit at given position from key
+ */
+static inline int GetKeyBit(const BYTE *key, int pos)
+{
+   return (key[pos >> 3] >> (7 - (pos & 7))) & 1;
+}
+
+/**
+ * Get number of leading bits common for two keys (checks no more than limit bits)
+ */
+static int CommonPrefixLength(const BYTE *k1, const BYTE *k2, int limit)
+{
+   int bits = 0;
+   for(int i = 0; bits < limit; i++, bits += 8)
+   {
+      BYTE diff = k1[i] ^ k2[i];
+      if (diff != 0)
+      {
+         while(!(diff & 0x80))
+         {
+            diff <<= 1;
+            bits++;
+         }
+         break;
+      }
+   }
+   return std::min(bits, limit);
+}
+
+/**
+ * Build tree key from address. Bits beyond prefix length are cleared.
+ * Returns prefix length or -1 if address is not valid.
+ */
+static int BuildKey(const InetAddress& addr, BYTE *key, bool useMask)
+{
+   memset(key, 0, 16);
+   int maxBits;
+   if (addr.getFamily() == AF_INET)
+   {
+      uint32_t a = addr.getAddressV4();
+      key[0] = static_cast<BYTE>(a >> 24);
+      key[1] = static_cast<BYTE>(a >> 16);
+      key[2] = static_cast<BYTE>(a >> 8);
+      key[3] = static_cast<BYTE>(a);
+      maxBits = 32;
+   }
+   else if (addr.getFamily() == AF_INET6)
+   {
+      memcpy(key, addr.getAddressV6(), 16);
+      maxBits = 128;
+   }
+   else
+   {
+      return -1;
+   }
+
+   if (!useMask)
+      return maxBits;
+
+   int bits = addr.getMaskBits();
+   if ((bits < 0) || (bits > maxBits))
+      bits = maxBits;
+
+   int b = bits / 8;
+   if (b < 16)
+   {
+      int shift = bits % 8;
+      key[b] &= (shift > 0) ? static_cast<BYTE>(0xFF << (8 - shift)) : 0;
+      for(int i = b + 1; i < 16; i++)
+         key[i] = 0;
+   }
+   return bits;
+}
+
+/**
+ * Create new tree node
+ */
+static InetAddressPrefixTreeNode *CreateNode(const BYTE *key, int bits)
+{
+   InetAddressPrefixTreeNode *node = MemAllocStruct<InetAddressPrefixTreeNode>();
+   memcpy(node->key, key, 16);
+
+   // Clear bits beyond prefix length so that glue nodes have canonical keys
+   int b = bits / 8;
+   if (b < 16)
+   {
+      int shift = bits % 8;
+      node->key[b] &= (shift > 0) ? static_cast<BYTE>(0xFF << (8 - shift)) : 0;
+      for(int i = b + 1; i < 16; i++)
+         node->key[i] = 0;
+   }
+   node->bits = bits;
+   return node;
+}
+
+/**
+ * Destroy subtree
+ */
+static void DestroySubtree(InetAddressPrefixTreeNode *node)
+{
+   if (node == nullptr)
+      return;
+   DestroySubtree(node->child[0]);
+   DestroySubtree(node->child[1]);
+   MemFree(node);
+}
+
+/**
+ * Create empty tree
+ */
+InetAddressPrefixTree::InetAddressPrefixTree()
+{
+   m_rootV4 = nullptr;
+   m_rootV6 = nullptr;
+   m_size = 0;
+}
+
+/**
+ * Destructor
+ */
+InetAddressPrefixTree::~InetAddressPrefixTree()
+{
+   clear();
+}
+
+/**
+ * Remove all prefixes from tree
+ */
+void InetAddressPrefixTree::clear()
+{
+   DestroySubtree(m_rootV4);
+   DestroySubtree(m_rootV6);
+   m_rootV4 = nullptr;
+   m_rootV6 = nullptr;
+   m_size = 0;
+}
+
+/**
+ * Add prefix to the tree. Prefix length is taken from address mask bits.
+ * Returns true if value for existing prefix was replaced.
+ */
+bool InetAddressPrefixTree::put(const InetAddress& prefix, void *value)
+{
+   BYTE key[16];
+   int bits = BuildKey(prefix, key, true);
+   if (bits < 0)
+      return false;
+
+   InetAddressPrefixTreeNode **link = getRoot(prefix.getFamily());
+   InetAddressPrefixTreeNode *node;
+   while((node = *link) != nullptr)
+   {
+      int common = CommonPrefixLength(node->key, key, std::min(node->bits, bits));
+      if (common == node->bits)
+      {
+         if (node->bits == bits)
+         {
+            bool replaced = node->hasValue;
+            node->value = value;
+            node->hasValue = true;
+            if (!replaced)
+               m_size++;
+            return replaced;
+         }
+         link = &node->child[GetKeyBit(key, node->bits)];
+         continue;
+      }
+
+      // Key diverges from this node's prefix
+      InetAddressPrefixTreeNode *n = CreateNode(key, bits);
+      n->value = value;
+      n->hasValue = true;
+      if (common == bits)
+      {
+         // New prefix covers existing node
+         n->child[GetKeyBit(node->key, bits)] = node;
+         *link = n;
+      }
+      else
+      {
+         InetAddressPrefixTreeNode *glue = CreateNode(key, common);
+         glue->child[GetKeyBit(key, common)] = n;
+         glue->child[GetKeyBit(node->key, common)] = node;
+         *link = glue;
+      }
+      m_size++;
+      return false;
+   }
+
+   node = CreateNode(key, bits);
+   node->value = value;
+   node->hasValue = true;
+   *link = node;
+   m_size++;
+   return false;
+}
+
+/**
+ * Remove prefix from the tree. Returns value associated with removed prefix or nullptr.
+ */
+void *InetAddressPrefixTree::remove(const InetAddress& prefix)
+{
+   BYTE key[16];
+   int bits = BuildKey(prefix, key, true);
+   if (bits < 0)
+      return nullptr;
+
+   InetAddressPrefixTreeNode **parentLink = nullptr;
+   InetAddressPrefixTreeNode **link = getRoot(prefix.getFamily());
+   InetAddressPrefixTreeNode *node;
+   while((node = *link) != nullptr)
+   {
+      if ((node->bits > bits) || (CommonPrefixLength(node->key, key, node->bits) < node->bits))
+         return nullptr;
+      if (node->bits == bits)
+         break;
+      parentLink = link;
+      link = &node->child[GetKeyBit(key, node->bits)];
+   }
+   if ((node == nullptr) || !node->hasValue)
+      return nullptr;
+
+   void *value = node->value;
+   m_size--;
+
+   if ((node->child[0] != nullptr) && (node->child[1] != nullptr))
+   {
+      // Keep as glue node
+      node->hasValue = false;
+      node->value = nullptr;
+      return value;
+   }
+
+   *link = (node->child[0] != nullptr) ? node->child[0] : node->child[1];
+   MemFree(node);
+
+   // Collapse parent glue node if it has only one child left
+   if (parentLink != nullptr)
+   {
+      InetAddressPrefixTreeNode *parent = *parentLink;
+      if (!parent->hasValue && ((parent->child[0] == nullptr) || (parent->child[1] == nullptr)))
+      {
+         *parentLink = (parent->child[0] != nullptr) ? parent->child[0] : parent->child[1];
+         MemFree(parent);
+      }
+   }
+   return value;
+}
+
+/**
+ * Get value for exact prefix match
+ */
+void *InetAddressPrefixTree::get(const InetAddress& prefix) const
+{
+   BYTE key[16];
+   int bits = BuildKey(prefix, key, true);
+   if (bits < 0)
+      return nullptr;
+
+   InetAddressPrefixTreeNode *node = getRoot(prefix.getFamily());
+   while(node != nullptr)
+   {
+      if ((node->bits > bits) || (CommonPrefixLength(node->key, key, node->bits) < node->bits))
+         return nullptr;
+      if (node->bits == bits)
+         return node->hasValue ? node->value : nullptr;
+      node = node->child[GetKeyBit(key, node->bits)];
+   }
+   return nullptr;
+}
+
+/**
+ * Find value for longest prefix containing given address. Address mask is ignored.
+ * If matchedPrefix is not null it will be set to matched prefix.
+ */
+void *InetAddressPrefixTree::findLongestMatch(const InetAddress& addr, InetAddress *matchedPrefix) const
+{
+   BYTE key[16];
+   int maxBits = BuildKey(addr, key, false);
+   if (maxBits < 0)
+      return nullptr;
+
+   const InetAddressPrefixTreeNode *match = nullptr;
+   const InetAddressPrefixTreeNode *node = getRoot(addr.getFamily());
+   while(node != nullptr)
+   {
+      if (CommonPrefixLength(node->key, key, node->bits) < node->bits)
+         break;
+      if (node->hasValue)
+         match = node;
+      if (node->bits == maxBits)
+         break;
+      node = node->child[GetKeyBit(key, node->bits)];
+   }
+
+   if (match == nullptr)
+      return nullptr;
+
+   if (matchedPrefix != nullptr)
+   {
+      if (addr.getFamily() == AF_INET)
+      {
+         *matchedPrefix = InetAddress((static_cast<uint32_t>(match->key[0]) << 24) | (static_cast<uint32_t>(match->key[1]) << 16) |
+                  (static_cast<uint32_t>(match->key[2]) << 8) | static_cast<uint32_t>(match->key[3]));
+      }
+      else
+      {
+         *matchedPrefix = InetAddress(match->key);
+      }
+      matchedPrefix->setMaskBits(match->bits);
+   }
+   return match->value;
+}
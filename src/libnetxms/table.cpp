@@ -318,33 +318,62 @@ Table *Table::createFromXML(const char *xml)
  */
 Table *Table::createFromPackedXML(const char *packedXml)
 {
-   char *compressedXml = nullptr;
+   return createFromPackedData(packedXml);
+}
+
+/**
+ * Magic bytes for binary table format
+ */
+static const char s_binaryTableMagic[4] = { 'N', 'X', 'T', 'B' };
+
+/**
+ * Create table from packed data (either packed XML document or packed binary table)
+ */
+Table *Table::createFromPackedData(const char *packedData)
+{
+   char *compressedData = nullptr;
    size_t compressedSize = 0;
-   base64_decode_alloc(packedXml, strlen(packedXml), &compressedXml, &compressedSize);
-   if (compressedXml == nullptr)
+   base64_decode_alloc(packedData, strlen(packedData), &compressedData, &compressedSize);
+   if (compressedData == nullptr)
       return nullptr;
+   if (compressedSize < 4)
+   {
+      MemFree(compressedData);
+      return nullptr;
+   }
 
-   size_t xmlSize = ntohl(*reinterpret_cast<uint32_t*>(compressedXml));
-   char *xml = MemAllocStringA(xmlSize + 1);
-   uLongf uncompSize = (uLongf)xmlSize;
-   if (uncompress((BYTE *)xml, &uncompSize, (BYTE *)&compressedXml[4], (uLong)compressedSize - 4) != Z_OK)
+   // Binary format has magic bytes followed by uncompressed size, XML format starts with uncompressed size
+   bool binary = (compressedSize > 8) && !memcmp(compressedData, s_binaryTableMagic, 4);
+   size_t headerSize = binary ? 8 : 4;
+   size_t dataSize = ntohl(*reinterpret_cast<uint32_t*>(&compressedData[headerSize - 4]));
+   char *data = MemAllocStringA(dataSize + 1);
+   uLongf uncompSize = (uLongf)dataSize;
+   if (uncompress((BYTE *)data, &uncompSize, (BYTE *)&compressedData[headerSize], (uLong)(compressedSize - headerSize)) != Z_OK)
    {
-      MemFree(xml);
-      MemFree(compressedXml);
+      MemFree(data);
+      MemFree(compressedData);
       return nullptr;
    }
-   xml[xmlSize] = 0;
-   MemFree(compressedXml);
+   data[dataSize] = 0;
+   MemFree(compressedData);
 
-   Table *table = new Table();
-   if (table->parseXML(xml))
+   Table *table;
+   if (binary)
    {
-      MemFree(xml);
-      return table;
+      ByteStream in(data, dataSize);
+      table = createFromBinary(&in);
    }
-   MemFree(xml);
-   delete table;
-   return nullptr;
+   else
+   {
+      table = new Table();
+      if (!table->parseXML(data))
+      {
+         delete table;
+         table = nullptr;
+      }
+   }
+   MemFree(data);
+   return table;
 }
 
 /**
@@ -432,11 +461,374 @@ char *Table::createPackedXML() const
    return encodedBuffer;
 }
 
+/**
+ * Create packed binary table (compressed and base64 encoded)
+ */
+char *Table::createPackedBinary() const
+{
+   ByteStream out(4096);
+   writeBinary(&out);
+
+   uLongf buflen = compressBound((uLong)out.size());
+   BYTE *buffer = MemAllocArrayNoInit<BYTE>(buflen + 8);
+   if (compress(&buffer[8], &buflen, out.buffer(), (uLong)out.size()) != Z_OK)
+   {
+      MemFree(buffer);
+      return nullptr;
+   }
+   memcpy(buffer, s_binaryTableMagic, 4);
+   *reinterpret_cast<uint32_t*>(&buffer[4]) = htonl(static_cast<uint32_t>(out.size()));
+   char *encodedBuffer = nullptr;
+   base64_encode_alloc(reinterpret_cast<char*>(buffer), buflen + 8, &encodedBuffer);
+   MemFree(buffer);
+   return encodedBuffer;
+}
+
+/**
+ * Binary table format version
+ */
+#define BINARY_TABLE_VERSION  1
+
+/**
+ * Column encodings in binary format
+ */
+#define COLUMN_ENCODING_DICTIONARY     0
+#define COLUMN_ENCODING_SIGNED_DELTA   1
+#define COLUMN_ENCODING_UNSIGNED_DELTA 2
+
+/**
+ * Parse integer value if it is in canonical form (so it can be restored from number without changes)
+ */
+static bool ParseCanonicalInteger(const TCHAR *s, bool isSigned, uint64_t *value)
+{
+   if (s == nullptr)
+      return false;
+
+   const TCHAR *p = s;
+   bool negative = false;
+   if (*p == _T('-'))
+   {
+      if (!isSigned)
+         return false;
+      negative = true;
+      p++;
+   }
+   if ((*p == 0) || ((*p == _T('0')) && ((p[1] != 0) || negative)))
+      return false;
+
+   uint64_t n = 0;
+   for(; *p != 0; p++)
+   {
+      if ((*p < _T('0')) || (*p > _T('9')))
+         return false;
+      uint64_t d = *p - _T('0');
+      if (n > (_ULL(0xFFFFFFFFFFFFFFFF) - d) / 10)
+         return false;
+      n = n * 10 + d;
+   }
+
+   if (isSigned)
+   {
+      if (n > (negative ? _ULL(0x8000000000000000) : _ULL(0x7FFFFFFFFFFFFFFF)))
+         return false;
+      *value = negative ? (0 - n) : n;
+   }
+   else
+   {
+      *value = n;
+   }
+   return true;
+}
+
+/**
+ * Write table in binary format. Format is columnar - values for each column are written together. Columns
+ * containing only integers are delta encoded, all other columns are dictionary encoded.
+ */
+void Table::writeBinary(ByteStream *out) const
+{
+   out->write(s_binaryTableMagic, 4);
+   out->write(static_cast<BYTE>(BINARY_TABLE_VERSION));
+   out->write(static_cast<BYTE>(m_extendedFormat ? 1 : 0));
+   out->writeSignedVarInt(m_source);
+   out->writeString(CHECK_NULL_EX(m_title));
+   out->writeVarInt(m_columns->size());
+   out->writeVarInt(m_data->size());
+
+   for(int i = 0; i < m_columns->size(); i++)
+   {
+      const TableColumnDefinition *c = m_columns->get(i);
+      out->writeString(c->getName());
+      out->writeString(c->getDisplayName());
+      out->writeSignedVarInt(c->getDataType());
+      out->write(static_cast<BYTE>(c->isInstanceColumn() ? 1 : 0));
+   }
+
+   if (m_extendedFormat)
+   {
+      uint32_t prevObjectId = 0;
+      for(int i = 0; i < m_data->size(); i++)
+      {
+         const TableRow *r = m_data->get(i);
+         out->writeSignedVarInt(static_cast<int64_t>(r->getObjectId()) - static_cast<int64_t>(prevObjectId));
+         out->writeSignedVarInt(r->getBaseRow());
+         prevObjectId = r->getObjectId();
+      }
+   }
+
+   for(int i = 0; i < m_columns->size(); i++)
+      writeBinaryColumn(out, i);
+}
+
+/**
+ * Write values of single column in binary format
+ */
+void Table::writeBinaryColumn(ByteStream *out, int col) const
+{
+   int rows = m_data->size();
+
+   // Check if all values are signed integers, and if not, check all values again as unsigned integers
+   uint64_t *values = MemAllocArrayNoInit<uint64_t>(std::max(rows, 1));
+   bool isSigned = true;
+   for(int i = 0; (i < rows) && isSigned; i++)
+      isSigned = ParseCanonicalInteger(m_data->get(i)->getValue(col), true, &values[i]);
+   bool isUnsigned = !isSigned;
+   for(int i = 0; (i < rows) && isUnsigned; i++)
+      isUnsigned = ParseCanonicalInteger(m_data->get(i)->getValue(col), false, &values[i]);
+
+   if (isSigned || isUnsigned)
+   {
+      out->write(static_cast<BYTE>(isSigned ? COLUMN_ENCODING_SIGNED_DELTA : COLUMN_ENCODING_UNSIGNED_DELTA));
+      uint64_t prev = 0;
+      for(int i = 0; i < rows; i++)
+      {
+         out->writeSignedVarInt(static_cast<int64_t>(values[i] - prev));
+         prev = values[i];
+      }
+   }
+   else
+   {
+      // Dictionary encoding: index 0 is reserved for null values
+      StringMap dictionary;
+      dictionary.setIgnoreCase(false);
+      ObjectArray<const TCHAR> entries(64, 64, Ownership::False);
+      for(int i = 0; i < rows; i++)
+      {
+         const TCHAR *v = m_data->get(i)->getValue(col);
+         if (v == nullptr)
+         {
+            values[i] = 0;
+            continue;
+         }
+         UINT32 index = dictionary.getUInt32(v, 0);
+         if (index == 0)
+         {
+            entries.add(v);
+            index = static_cast<UINT32>(entries.size());
+            dictionary.set(v, index);
+         }
+         values[i] = index;
+      }
+
+      out->write(static_cast<BYTE>(COLUMN_ENCODING_DICTIONARY));
+      out->writeVarInt(entries.size());
+      for(int i = 0; i < entries.size(); i++)
+         out->writeString(entries.get(i));
+      for(int i = 0; i < rows; i++)
+         out->writeVarInt(values[i]);
+   }
+   MemFree(values);
+
+   // Cell status and object ID are written only if set for at least one cell
+   bool hasStatus = false, hasObjectId = false;
+   for(int i = 0; i < rows; i++)
+   {
+      const TableRow *r = m_data->get(i);
+      if (r->getStatus(col) != DEFAULT_STATUS)
+         hasStatus = true;
+      if (r->getCellObjectId(col) != DEFAULT_OBJECT_ID)
+         hasObjectId = true;
+   }
+   out->write(static_cast<BYTE>((hasStatus ? 1 : 0) | (hasObjectId ? 2 : 0)));
+   if (hasStatus)
+   {
+      for(int i = 0; i < rows; i++)
+         out->writeSignedVarInt(m_data->get(i)->getStatus(col));
+   }
+   if (hasObjectId)
+   {
+      for(int i = 0; i < rows; i++)
+         out->writeVarInt(m_data->get(i)->getCellObjectId(col));
+   }
+}
+
+/**
+ * Read table from binary format. Table is expected to be empty.
+ */
+bool Table::readBinary(ByteStream *in)
+{
+   char magic[4];
+   if ((in->read(magic, 4) != 4) || memcmp(magic, s_binaryTableMagic, 4) || (in->readByte() != BINARY_TABLE_VERSION))
+      return false;
+
+   m_extendedFormat = ((in->readByte() & 1) != 0);
+   m_source = static_cast<int>(in->readSignedVarInt());
+   TCHAR *title = in->readString();
+   if (title == nullptr)
+      return false;
+   if (*title != 0)
+   {
+      MemFree(m_title);
+      m_title = title;
+   }
+   else
+   {
+      MemFree(title);
+   }
+
+   uint64_t columns = in->readVarInt();
+   uint64_t rows = in->readVarInt();
+   size_t remaining = in->size() - in->pos();
+   if ((columns > remaining) || (rows > 0x7FFFFFFF) || ((columns > 0) ? (rows * columns > remaining) : (rows > 0xFFFF)))
+      return false;
+
+   for(uint64_t i = 0; i < columns; i++)
+   {
+      TCHAR *name = in->readString();
+      TCHAR *displayName = in->readString();
+      int32_t dataType = static_cast<int32_t>(in->readSignedVarInt());
+      bool isInstance = (in->readByte() != 0);
+      if ((name == nullptr) || (displayName == nullptr))
+      {
+         MemFree(name);
+         MemFree(displayName);
+         return false;
+      }
+      addColumn(name, dataType, displayName, isInstance);
+      MemFree(name);
+      MemFree(displayName);
+   }
+
+   for(uint64_t i = 0; i < rows; i++)
+      m_data->add(new TableRow(static_cast<int>(columns)));
+
+   if (m_extendedFormat)
+   {
+      uint32_t objectId = 0;
+      for(uint64_t i = 0; i < rows; i++)
+      {
+         TableRow *r = m_data->get(static_cast<int>(i));
+         objectId += static_cast<uint32_t>(in->readSignedVarInt());
+         r->setObjectId(objectId);
+         r->setBaseRow(static_cast<int>(in->readSignedVarInt()));
+      }
+   }
+
+   for(int i = 0; i < static_cast<int>(columns); i++)
+   {
+      if (!readBinaryColumn(in, i))
+         return false;
+   }
+   return true;
+}
+
+/**
+ * Read values of single column from binary format
+ */
+bool Table::readBinaryColumn(ByteStream *in, int col)
+{
+   int rows = m_data->size();
+   BYTE encoding = in->readByte();
+   if ((encoding == COLUMN_ENCODING_SIGNED_DELTA) || (encoding == COLUMN_ENCODING_UNSIGNED_DELTA))
+   {
+      uint64_t value = 0;
+      TCHAR buffer[32];
+      for(int i = 0; i < rows; i++)
+      {
+         value += static_cast<uint64_t>(in->readSignedVarInt());
+         if (encoding == COLUMN_ENCODING_SIGNED_DELTA)
+            _sntprintf(buffer, 32, INT64_FMT, static_cast<int64_t>(value));
+         else
+            _sntprintf(buffer, 32, UINT64_FMT, value);
+         m_data->get(i)->setValue(col, buffer);
+      }
+   }
+   else if (encoding == COLUMN_ENCODING_DICTIONARY)
+   {
+      uint64_t count = in->readVarInt();
+      if (count > in->size() - in->pos())
+         return false;
+
+      StringList dictionary;
+      for(uint64_t i = 0; i < count; i++)
+      {
+         TCHAR *s = in->readString();
+         if (s == nullptr)
+            return false;
+         dictionary.addPreallocated(s);
+      }
+      for(int i = 0; i < rows; i++)
+      {
+         uint64_t index = in->readVarInt();
+         if (index > count)
+            return false;
+         if (index > 0)
+            m_data->get(i)->setValue(col, dictionary.get(static_cast<int>(index - 1)));
+      }
+   }
+   else
+   {
+      return false;
+   }
+
+   BYTE flags = in->readByte();
+   if (flags & 1)
+   {
+      for(int i = 0; i < rows; i++)
+         m_data->get(i)->setStatus(col, static_cast<int>(in->readSignedVarInt()));
+   }
+   if (flags & 2)
+   {
+      for(int i = 0; i < rows; i++)
+         m_data->get(i)->setCellObjectId(col, static_cast<uint32_t>(in->readVarInt()));
+   }
+   return true;
+}
+
+/**
+ * Create table from binary format
+ */
+Table *Table::createFromBinary(ByteStream *in)
+{
+   Table *table = new Table();
+   if (table->readBinary(in))
+      return table;
+   delete table;
+   return nullptr;
+}
+
 /**
  * Create table from NXCP message
  */
 void Table::createFromMessage(NXCPMessage *msg)
 {
+   if (msg->isFieldExist(VID_TABLE_BINARY_DATA))
+   {
+      m_data = new ObjectArray<TableRow>(32, 32, Ownership::True);
+      m_title = nullptr;
+      m_source = DS_INTERNAL;
+      m_extendedFormat = false;
+
+      size_t size;
+      const BYTE *data = msg->getBinaryFieldPtr(VID_TABLE_BINARY_DATA, &size);
+      ByteStream in(data, size);
+      if (!readBinary(&in))
+      {
+         m_columns->clear();
+         m_data->clear();
+      }
+      return;
+   }
+
 	int i;
 	uint32_t dwId;
 
@@ -554,6 +946,16 @@ int Table::fillMessage(NXCPMessage &msg, int offset, int rowLimit)
 	return stopRow;
 }
 
+/**
+ * Fill NXCP message with table data in binary format
+ */
+void Table::fillMessageBinary(NXCPMessage &msg) const
+{
+   ByteStream out(4096);
+   writeBinary(&out);
+   msg.setField(VID_TABLE_BINARY_DATA, out.buffer(), out.size());
+}
+
 /**
  * Add new column
  */
@@ -32,7 +32,40 @@
 /**
  * Constants
  */
-#define READ_BUFFER_SIZE      4096
+#define READ_BUFFER_SIZE      65536
+
+/**
+ * Interval between file checks when polling (milliseconds)
+ */
+#define FILE_POLL_INTERVAL    5000
+
+/**
+ * Interval between file checks when change notifications are used (milliseconds). Checks are
+ * still needed for exclusion periods, file name changes, and as protection against lost notifications.
+ */
+#define FILE_CHECK_INTERVAL   30000
+
+/**
+ * Read buffer. Allocated once per parser thread. Extra bytes after data area are used for
+ * terminating lines which do not fit into buffer.
+ */
+struct LogReadBuffer
+{
+   char *data;
+   TCHAR *text;
+
+   LogReadBuffer()
+   {
+      data = MemAllocArrayNoInit<char>(READ_BUFFER_SIZE + 4);
+      text = MemAllocArrayNoInit<TCHAR>(READ_BUFFER_SIZE + 1);
+   }
+
+   ~LogReadBuffer()
+   {
+      MemFree(data);
+      MemFree(text);
+   }
+};
 
 /**
  * File encoding names
@@ -145,10 +178,127 @@ static char *FindEOL(char *start, int length, int encoding)
    return eol;
 }
 
+/**
+ * Convert line from file encoding to platform encoding and pass it to parser
+ */
+static void ProcessLine(LogParser *parser, char *ptr, int encoding, TCHAR *text)
+{
+#ifdef UNICODE
+   switch(encoding)
+   {
+      case LP_FCP_ACP:
+         MultiByteToWideChar(CP_ACP, MB_PRECOMPOSED, ptr, -1, text, READ_BUFFER_SIZE + 1);
+         break;
+      case LP_FCP_UTF8:
+         MultiByteToWideChar(CP_UTF8, 0, ptr, -1, text, READ_BUFFER_SIZE + 1);
+         break;
+      case LP_FCP_UCS2_LE:
+#if WORDS_BIGENDIAN
+         bswap_array_16((UINT16 *)ptr, -1);
+#endif
+#ifdef UNICODE_UCS2
+         wcslcpy(text, (WCHAR *)ptr, READ_BUFFER_SIZE + 1);
+#else
+         ucs2_to_ucs4((UCS2CHAR *)ptr, -1, text, READ_BUFFER_SIZE + 1);
+#endif
+         break;
+      case LP_FCP_UCS2_BE:
+#if !WORDS_BIGENDIAN
+         bswap_array_16((UINT16 *)ptr, -1);
+#endif
+#ifdef UNICODE_UCS2
+         wcslcpy(text, (WCHAR *)ptr, READ_BUFFER_SIZE + 1);
+#else
+         ucs2_to_ucs4((UCS2CHAR *)ptr, -1, text, READ_BUFFER_SIZE + 1);
+#endif
+         break;
+      case LP_FCP_UCS2:
+#ifdef UNICODE_UCS2
+         wcslcpy(text, (WCHAR *)ptr, READ_BUFFER_SIZE + 1);
+#else
+         ucs2_to_ucs4((UCS2CHAR *)ptr, -1, text, READ_BUFFER_SIZE + 1);
+#endif
+         break;
+      case LP_FCP_UCS4_LE:
+#if WORDS_BIGENDIAN
+         bswap_array_32((UINT32 *)ptr, -1);
+#endif
+#ifdef UNICODE_UCS2
+         ucs4_to_ucs2((UCS4CHAR *)ptr, -1, text, READ_BUFFER_SIZE + 1);
+#else
+         wcslcpy(text, (WCHAR *)ptr, READ_BUFFER_SIZE + 1);
+#endif
+         break;
+      case LP_FCP_UCS4_BE:
+#if !WORDS_BIGENDIAN
+         bswap_array_32((UINT32 *)ptr, -1);
+#endif
+#ifdef UNICODE_UCS2
+         ucs4_to_ucs2((UCS4CHAR *)ptr, -1, text, READ_BUFFER_SIZE + 1);
+#else
+         wcslcpy(text, (WCHAR *)ptr, READ_BUFFER_SIZE + 1);
+#endif
+         break;
+      case LP_FCP_UCS4:
+#ifdef UNICODE_UCS2
+         ucs4_to_ucs2((UCS4CHAR *)ptr, -1, text, READ_BUFFER_SIZE + 1);
+#else
+         wcslcpy(text, (WCHAR *)ptr, READ_BUFFER_SIZE + 1);
+#endif
+         break;
+      default:
+         break;
+   }
+#else
+   switch(encoding)
+   {
+      case LP_FCP_ACP:
+         _tcslcpy(text, ptr, READ_BUFFER_SIZE + 1);
+         break;
+      case LP_FCP_UTF8:
+         utf8_to_mb(ptr, -1, text, READ_BUFFER_SIZE + 1);
+         break;
+      case LP_FCP_UCS2_LE:
+#if WORDS_BIGENDIAN
+         bswap_array_16((UINT16 *)ptr, -1);
+#endif
+         ucs2_to_mb((UCS2CHAR *)ptr, -1, text, READ_BUFFER_SIZE + 1);
+         break;
+      case LP_FCP_UCS2_BE:
+#if !WORDS_BIGENDIAN
+         bswap_array_16((UINT16 *)ptr, -1);
+#endif
+         ucs2_to_mb((UCS2CHAR *)ptr, -1, text, READ_BUFFER_SIZE + 1);
+         break;
+      case LP_FCP_UCS2:
+         ucs2_to_mb((UCS2CHAR *)ptr, -1, text, READ_BUFFER_SIZE + 1);
+         break;
+      case LP_FCP_UCS4_LE:
+#if WORDS_BIGENDIAN
+         bswap_array_32((UINT32 *)ptr, -1);
+#endif
+         ucs4_to_mb((UCS4CHAR *)ptr, -1, text, READ_BUFFER_SIZE + 1);
+         break;
+      case LP_FCP_UCS4_BE:
+#if !WORDS_BIGENDIAN
+         bswap_array_32((UINT32 *)ptr, -1);
+#endif
+         ucs4_to_mb((UCS4CHAR *)ptr, -1, text, READ_BUFFER_SIZE + 1);
+         break;
+      case LP_FCP_UCS4:
+         ucs4_to_mb((UCS4CHAR *)ptr, -1, text, READ_BUFFER_SIZE + 1);
+         break;
+      default:
+         break;
+   }
+#endif
+   parser->matchLine(text);
+}
+
 /**
  * Parse new log records
  */
-static off_t ParseNewRecords(LogParser *parser, int fh)
+static off_t ParseNewRecords(LogParser *parser, int fh, LogReadBuffer *buffer)
 {
    int encoding = parser->getFileEncoding();
    int charSize;
@@ -169,30 +319,40 @@ static off_t ParseNewRecords(LogParser *parser, int fh)
          break;
    }
 
-   char buffer[READ_BUFFER_SIZE];
+   char *data = buffer->data;
    int bytes, bufPos = 0;
    off_t resetPos = _lseek(fh, 0, SEEK_CUR);
    do
    {
-      if ((bytes = _read(fh, &buffer[bufPos], READ_BUFFER_SIZE - bufPos)) > 0)
+      if ((bytes = _read(fh, &data[bufPos], READ_BUFFER_SIZE - bufPos)) > 0)
       {
          nxlog_debug_tag(DEBUG_TAG, 7, _T("Read %d bytes into buffer at offset %d"), bytes, bufPos);
          bytes += bufPos;
 
          char *ptr, *eptr;
-         for(ptr = buffer;; ptr = eptr + charSize)
+         for(ptr = data;; ptr = eptr + charSize)
          {
-            bufPos = (int)(ptr - buffer);
+            bufPos = (int)(ptr - data);
 				eptr = FindEOL(ptr, bytes - bufPos, encoding);
             if (eptr == nullptr)
             {
 					int remaining = bytes - bufPos;
+               if (remaining == READ_BUFFER_SIZE)
+               {
+                  // Line does not fit into buffer, pass it to parser in parts
+                  memset(&data[READ_BUFFER_SIZE], 0, 4);
+                  ProcessLine(parser, data, encoding, buffer->text);
+                  resetPos = _lseek(fh, 0, SEEK_CUR);
+                  bufPos = 0;
+                  nxlog_debug_tag(DEBUG_TAG, 7, _T("Line in file \"%s\" is longer than read buffer"), parser->getFileName());
+                  break;
+               }
                resetPos = _lseek(fh, 0, SEEK_CUR) - remaining;
 					if (remaining > 0)
 					{
-					   if (buffer != ptr)
-					      memmove(buffer, ptr, remaining);
-                  if (parser->isFilePreallocated() && !memcmp(buffer, "\x00\x00\x00\x00", std::min(remaining, 4)))
+					   if (data != ptr)
+					      memmove(data, ptr, remaining);
+                  if (parser->isFilePreallocated() && !memcmp(data, "\x00\x00\x00\x00", std::min(remaining, 4)))
                   {
                      // Found zeroes in preallocated file, next read should be after last known EOL
                      return resetPos;
@@ -264,119 +424,7 @@ static off_t ParseNewRecords(LogParser *parser, int fh)
 						break;
 				}
 
-				// Now ptr points to null-terminated string in original encoding
-				// Do the conversion to platform encoding
-            TCHAR text[READ_BUFFER_SIZE];
-#ifdef UNICODE
-				switch(encoding)
-				{
-					case LP_FCP_ACP:
-						MultiByteToWideChar(CP_ACP, MB_PRECOMPOSED, ptr, -1, text, READ_BUFFER_SIZE);
-						break;
-					case LP_FCP_UTF8:
-						MultiByteToWideChar(CP_UTF8, 0, ptr, -1, text, READ_BUFFER_SIZE);
-						break;
-               case LP_FCP_UCS2_LE:
-#if WORDS_BIGENDIAN
-                  bswap_array_16((UINT16 *)ptr, -1);
-#endif
-#ifdef UNICODE_UCS2
-						wcslcpy(text, (WCHAR *)ptr, READ_BUFFER_SIZE);
-#else
-                  ucs2_to_ucs4((UCS2CHAR *)ptr, -1, text, READ_BUFFER_SIZE);
-#endif
-                  break;
-               case LP_FCP_UCS2_BE:
-#if !WORDS_BIGENDIAN
-                  bswap_array_16((UINT16 *)ptr, -1);
-#endif
-#ifdef UNICODE_UCS2
-						wcslcpy(text, (WCHAR *)ptr, READ_BUFFER_SIZE);
-#else
-                  ucs2_to_ucs4((UCS2CHAR *)ptr, -1, text, READ_BUFFER_SIZE);
-#endif
-                  break;
-               case LP_FCP_UCS2:
-#ifdef UNICODE_UCS2
-						wcslcpy(text, (WCHAR *)ptr, READ_BUFFER_SIZE);
-#else
-                  ucs2_to_ucs4((UCS2CHAR *)ptr, -1, text, READ_BUFFER_SIZE);
-#endif
-                  break;
-               case LP_FCP_UCS4_LE:
-#if WORDS_BIGENDIAN
-                  bswap_array_32((UINT32 *)ptr, -1);
-#endif
-#ifdef UNICODE_UCS2
-                  ucs4_to_ucs2((UCS4CHAR *)ptr, -1, text, READ_BUFFER_SIZE);
-#else
-                  wcslcpy(text, (WCHAR *)ptr, READ_BUFFER_SIZE);
-#endif
-                  break;
-               case LP_FCP_UCS4_BE:
-#if !WORDS_BIGENDIAN
-                  bswap_array_32((UINT32 *)ptr, -1);
-#endif
-#ifdef UNICODE_UCS2
-                  ucs4_to_ucs2((UCS4CHAR *)ptr, -1, text, READ_BUFFER_SIZE);
-#else
-                  wcslcpy(text, (WCHAR *)ptr, READ_BUFFER_SIZE);
-#endif
-                  break;
-               case LP_FCP_UCS4:
-#ifdef UNICODE_UCS2
-                  ucs4_to_ucs2((UCS4CHAR *)ptr, -1, text, READ_BUFFER_SIZE);
-#else
-                  wcslcpy(text, (WCHAR *)ptr, READ_BUFFER_SIZE);
-#endif
-                  break;
-					default:
-						break;
-				}
-#else
-				switch(encoding)
-				{
-					case LP_FCP_ACP:
-						_tcslcpy(text, ptr, READ_BUFFER_SIZE);
-						break;
-               case LP_FCP_UTF8:
-                  utf8_to_mb(ptr, -1, text, READ_BUFFER_SIZE);
-                  break;
-               case LP_FCP_UCS2_LE:
-#if WORDS_BIGENDIAN
-                  bswap_array_16((UINT16 *)ptr, -1);
-#endif
-                  ucs2_to_mb((UCS2CHAR *)ptr, -1, text, READ_BUFFER_SIZE);
-                  break;
-               case LP_FCP_UCS2_BE:
-#if !WORDS_BIGENDIAN
-                  bswap_array_16((UINT16 *)ptr, -1);
-#endif
-                  ucs2_to_mb((UCS2CHAR *)ptr, -1, text, READ_BUFFER_SIZE);
-                  break;
-               case LP_FCP_UCS2:
-                  ucs2_to_mb((UCS2CHAR *)ptr, -1, text, READ_BUFFER_SIZE);
-                  break;
-               case LP_FCP_UCS4_LE:
-#if WORDS_BIGENDIAN
-                  bswap_array_32((UINT32 *)ptr, -1);
-#endif
-                  ucs4_to_mb((UCS4CHAR *)ptr, -1, text, READ_BUFFER_SIZE);
-                  break;
-               case LP_FCP_UCS4_BE:
-#if !WORDS_BIGENDIAN
-                  bswap_array_32((UINT32 *)ptr, -1);
-#endif
-                  ucs4_to_mb((UCS4CHAR *)ptr, -1, text, READ_BUFFER_SIZE);
-                  break;
-               case LP_FCP_UCS4:
-                  ucs4_to_mb((UCS4CHAR *)ptr, -1, text, READ_BUFFER_SIZE);
-                  break;
-					default:
-						break;
-				}
-#endif
-				parser->matchLine(text);
+				ProcessLine(parser, ptr, encoding, buffer->text);
          }
       }
       else
@@ -545,6 +593,7 @@ bool LogParser::monitorFile()
    }
 
 	nxlog_debug_tag(DEBUG_TAG, 0, _T("Parser thread for file \"%s\" started"), m_fileName);
+	LogReadBuffer readBuffer;
 	bool exclusionPeriod = false;
 	while(true)
 	{
@@ -606,7 +655,7 @@ bool LogParser::monitorFile()
 		if (readFromStart)
 		{
 			nxlog_debug_tag(DEBUG_TAG, 5, _T("Parsing existing records in file \"%s\""), fname);
-			off_t resetPos = ParseNewRecords(this, fh);
+			off_t resetPos = ParseNewRecords(this, fh, &readBuffer);
          _lseek(fh, resetPos, SEEK_SET);
 		}
 		else if (m_preallocatedFile)
@@ -618,10 +667,31 @@ bool LogParser::monitorFile()
 			_lseek(fh, 0, SEEK_END);
 		}
 
+#if HAVE_SYS_INOTIFY_H
+		FileChangeWatch *watch = AddFileChangeWatch(fname, m_fileChangeCondition);
+		if (watch != nullptr)
+		   nxlog_debug_tag(DEBUG_TAG, 5, _T("Using change notifications for file \"%s\""), fname);
+#endif
+
 		while(true)
 		{
-			if (ConditionWait(m_stopCondition, 5000))
+		   bool stop;
+#if HAVE_SYS_INOTIFY_H
+		   if (watch != nullptr)
+		   {
+		      ConditionWait(m_fileChangeCondition, FILE_CHECK_INTERVAL);
+		      stop = ConditionWait(m_stopCondition, 0);
+		   }
+		   else
+#endif
+		   stop = ConditionWait(m_stopCondition, FILE_POLL_INTERVAL);
+			if (stop)
+			{
+#if HAVE_SYS_INOTIFY_H
+			   RemoveFileChangeWatch(watch);
+#endif
 				goto stop_parser;
+			}
 
 			// Check if file name was changed
 			ExpandFileName(getFileName(), temp, MAX_PATH, true);
@@ -639,9 +709,15 @@ bool LogParser::monitorFile()
 				break;
 			}
 
-			if (CALL_STAT(fname, &stn) < 0)
+			// Follow symbolic links - file handle refers to link target
+			if (CALL_STAT_FOLLOW_SYMLINK(fname, &stn) < 0)
 			{
 				nxlog_debug_tag(DEBUG_TAG, 1, _T("stat(%s) failed, errno=%d"), fname, errno);
+				if ((size_t)st.st_size > size)
+				{
+				   // Read records written to old file before rotation
+				   ParseNewRecords(this, fh, &readBuffer);
+				}
 				readFromStart = true;
 				break;
 			}
@@ -657,6 +733,11 @@ bool LogParser::monitorFile()
 			if ((st.st_ino != stn.st_ino) || (st.st_dev != stn.st_dev))
 			{
 				nxlog_debug_tag(DEBUG_TAG, 3, _T("File device or inode differs for stat(%d) and fstat(%s), assume file rename"), fh, fname);
+				if ((size_t)st.st_size > size)
+				{
+				   // Read records written to old file before rotation
+				   ParseNewRecords(this, fh, &readBuffer);
+				}
 				readFromStart = true;
 				break;
 			}
@@ -675,7 +756,7 @@ bool LogParser::monitorFile()
 				size = (size_t)st.st_size;
 				mtime = st.st_mtime;
 				nxlog_debug_tag(DEBUG_TAG, 6, _T("New data available in file \"%s\""), fname);
-				off_t resetPos = ParseNewRecords(this, fh);
+				off_t resetPos = ParseNewRecords(this, fh, &readBuffer);
 				_lseek(fh, resetPos, SEEK_SET);
 			}
 			else if (m_preallocatedFile)
@@ -686,7 +767,7 @@ bool LogParser::monitorFile()
 				{
                _lseek(fh, -4, SEEK_CUR);
 	            nxlog_debug_tag(DEBUG_TAG, 6, _T("New data available in file \"%s\""), fname);
-	            off_t resetPos = ParseNewRecords(this, fh);
+	            off_t resetPos = ParseNewRecords(this, fh, &readBuffer);
 	            _lseek(fh, resetPos, SEEK_SET);
 				}
 				else
@@ -701,7 +782,7 @@ bool LogParser::monitorFile()
                   {
                      nxlog_debug_tag(DEBUG_TAG, 6, _T("Detected reset of preallocated file \"%s\""), fname);
                      _lseek(fh, 0, SEEK_SET);
-                     off_t resetPos = ParseNewRecords(this, fh);
+                     off_t resetPos = ParseNewRecords(this, fh, &readBuffer);
                      _lseek(fh, resetPos, SEEK_SET);
                   }
                }
@@ -716,6 +797,9 @@ bool LogParser::monitorFile()
 				break;
 			}
 		}
+#if HAVE_SYS_INOTIFY_H
+		RemoveFileChangeWatch(watch);
+#endif
 		_close(fh);
 	}
 
@@ -739,6 +823,7 @@ bool LogParser::monitorFile2()
    bool firstRead = true;
 
    nxlog_debug_tag(DEBUG_TAG, 0, _T("Parser thread for file \"%s\" started (\"keep open\" option disabled)"), m_fileName);
+   LogReadBuffer readBuffer;
    bool exclusionPeriod = false;
    while(true)
    {
@@ -881,7 +966,7 @@ bool LogParser::monitorFile2()
       }
       readFromStart = false;
 
-      lastPos = ParseNewRecords(this, fh);
+      lastPos = ParseNewRecords(this, fh, &readBuffer);
       _close(fh);
       size = static_cast<size_t>(st.st_size);
       mtime = st.st_mtime;
@@ -917,6 +1002,7 @@ bool LogParser::monitorFileWithSnapshot()
    bool firstRead = true;
 
    nxlog_debug_tag(DEBUG_TAG, 0, _T("Parser thread for file \"%s\" started (using VSS snapshots)"), m_fileName);
+   LogReadBuffer readBuffer;
    bool exclusionPeriod = false;
    while(true)
    {
@@ -1014,7 +1100,7 @@ bool LogParser::monitorFileWithSnapshot()
       }
       readFromStart = false;
 
-      lastPos = ParseNewRecords(this, fh);
+      lastPos = ParseNewRecords(this, fh, &readBuffer);
       _close(fh);
       size = static_cast<size_t>(st.st_size);
       mtime = st.st_mtime;
@@ -30,6 +30,49 @@
 
 #define DEBUG_TAG _T("logwatch")
 
+/**
+ * Rule prefilter - finds rules which can match given line by searching for required literals
+ * of all rules at once (Aho-Corasick automaton over lower case ASCII characters).
+ */
+class RulePrefilter
+{
+private:
+   int m_ruleCount;
+   int m_literalCount;
+   int m_alphabetSize;
+   int m_charMap[128];
+   int32_t *m_transitions;    // Full transition table, m_alphabetSize entries per state
+   int32_t *m_outputs;        // First output entry for state or -1
+   int32_t *m_dictLinks;      // Nearest state on suffix link chain with outputs (0 if none)
+   int32_t *m_outputRules;    // Rule index for output entry
+   int32_t *m_outputNext;     // Next output entry for same state or -1
+   bool *m_candidates;
+   bool *m_unfiltered;        // Rules which should always be checked
+
+   int mapChar(TCHAR ch) const;
+
+public:
+   RulePrefilter(ObjectArray<LogParserRule> *rules);
+   ~RulePrefilter();
+
+   const bool *scan(const TCHAR *line);
+
+   int getLiteralCount() const { return m_literalCount; }
+};
+
+#if HAVE_SYS_INOTIFY_H
+
+/**
+ * File change watch (opaque)
+ */
+struct FileChangeWatch;
+
+FileChangeWatch *AddFileChangeWatch(const TCHAR *fileName, CONDITION condition);
+void RemoveFileChangeWatch(FileChangeWatch *watch);
+void ShutdownFileChangeNotifier();
+
+#endif
+
 #ifdef _WIN32
 
 THREAD_RESULT THREAD_CALL ParserThreadEventLog(void *);
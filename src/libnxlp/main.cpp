@@ -71,6 +71,9 @@ void LIBNXLP_EXPORTABLE CleanupLogParserLibrary()
       CleanupEventLogParsers();
    }
 #endif
+#if HAVE_SYS_INOTIFY_H
+   ShutdownFileChangeNotifier();
+#endif
 }
 
 #ifdef _WIN32
@@ -0,0 +1,388 @@
+/*
+** NetXMS - Network Management System
+** Log Parsing Library
+** Copyright (C) 2003-2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation; either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: notify.cpp
+**
+**/
+
+#include "libnxlp.h"
+
+#if HAVE_SYS_INOTIFY_H
+
+#include <sys/inotify.h>
+
+#if HAVE_SYS_VFS_H
+#include <sys/vfs.h>
+#endif
+
+/**
+ * Events watched on parent directory of monitored file
+ */
+#define WATCH_MASK   (IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)
+
+/**
+ * File change watch. Watches are set on parent directory so file rotation and re-creation
+ * are reported as well. Same directory watch descriptor can be shared by multiple files.
+ * If monitored file name is a symbolic link, directory containing the link is watched as
+ * well, so link replacement or retargeting is reported.
+ */
+struct FileChangeWatch
+{
+   int wd;
+   char *name;
+   int linkWd;
+   char *linkName;
+   CONDITION condition;
+};
+
+/**
+ * Notifier state. Single inotify instance is used for all parsers because number
+ * of instances per user is limited (128 by default).
+ */
+static Mutex s_lock;
+static ObjectArray<FileChangeWatch> s_watches(16, 16, Ownership::False);
+static int s_inotifyFd = -1;
+static int s_controlPipe[2] = { -1, -1 };
+static THREAD s_notifierThread = INVALID_THREAD_HANDLE;
+static bool s_initFailed = false;
+
+/**
+ * Process single inotify event. Must be called with lock held.
+ */
+static void ProcessEvent(struct inotify_event *e)
+{
+   if (e->mask & IN_Q_OVERFLOW)
+   {
+      // Some events were lost, wake up all parsers
+      for(int i = 0; i < s_watches.size(); i++)
+         ConditionSet(s_watches.get(i)->condition);
+      return;
+   }
+
+   for(int i = 0; i < s_watches.size(); i++)
+   {
+      FileChangeWatch *w = s_watches.get(i);
+      if (w->wd == e->wd)
+      {
+         if (e->mask & IN_IGNORED)
+         {
+            // Directory was removed or unmounted, parser will rely on periodic checks
+            w->wd = -1;
+            ConditionSet(w->condition);
+         }
+         else if ((e->len > 0) && !strcmp(e->name, w->name))
+         {
+            ConditionSet(w->condition);
+         }
+      }
+      if (w->linkWd == e->wd)
+      {
+         if (e->mask & IN_IGNORED)
+         {
+            w->linkWd = -1;
+            ConditionSet(w->condition);
+         }
+         else if ((e->len > 0) && !strcmp(e->name, w->linkName))
+         {
+            ConditionSet(w->condition);
+         }
+      }
+   }
+}
+
+/**
+ * Notifier thread
+ */
+static void NotifierThread()
+{
+   nxlog_debug_tag(DEBUG_TAG, 2, _T("File change notifier thread started"));
+
+   char buffer[8192] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+   SocketPoller sp;
+   while(true)
+   {
+      sp.reset();
+      sp.add(s_inotifyFd);
+      sp.add(s_controlPipe[0]);
+      if (sp.poll(INFINITE) < 0)
+      {
+         if (errno == EINTR)
+            continue;
+         nxlog_debug_tag(DEBUG_TAG, 1, _T("File change notifier: poll() failed (%s)"), _tcserror(errno));
+         break;
+      }
+
+      if (sp.isSet(s_controlPipe[0]))
+         break;
+
+      ssize_t bytes = read(s_inotifyFd, buffer, sizeof(buffer));
+      if (bytes <= 0)
+         continue;
+
+      s_lock.lock();
+      for(char *curr = buffer; curr < buffer + bytes;)
+      {
+         struct inotify_event *e = reinterpret_cast<struct inotify_event*>(curr);
+         ProcessEvent(e);
+         curr += sizeof(struct inotify_event) + e->len;
+      }
+      s_lock.unlock();
+   }
+
+   nxlog_debug_tag(DEBUG_TAG, 2, _T("File change notifier thread stopped"));
+}
+
+/**
+ * Start notifier. Must be called with lock held.
+ */
+static bool StartNotifier()
+{
+   if (s_inotifyFd != -1)
+      return true;
+   if (s_initFailed)
+      return false;
+
+   s_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+   if (s_inotifyFd == -1)
+   {
+      nxlog_debug_tag(DEBUG_TAG, 1, _T("Cannot initialize inotify (%s), file change notifications disabled"), _tcserror(errno));
+      s_initFailed = true;
+      return false;
+   }
+
+   if (pipe(s_controlPipe) != 0)
+   {
+      nxlog_debug_tag(DEBUG_TAG, 1, _T("Cannot create control pipe (%s), file change notifications disabled"), _tcserror(errno));
+      close(s_inotifyFd);
+      s_inotifyFd = -1;
+      s_initFailed = true;
+      return false;
+   }
+
+   s_notifierThread = ThreadCreateEx(NotifierThread);
+   return true;
+}
+
+/**
+ * Check if file system at given path is local. Change notifications are not reliable
+ * on network file systems (changes made by other hosts are not reported).
+ */
+static bool IsLocalFileSystem(const char *path)
+{
+   struct statfs fs;
+   if (statfs(path, &fs) != 0)
+      return false;
+
+   switch((uint32_t)fs.f_type)
+   {
+      case 0x6969:      // NFS
+      case 0x517B:      // SMB
+      case 0xFF534D42:  // CIFS
+      case 0xFE534D42:  // SMB2
+      case 0x73757245:  // CODA
+      case 0x5346414F:  // AFS
+      case 0x01021997:  // 9P
+      case 0x00C36400:  // CEPH
+      case 0x65735546:  // FUSE
+         return false;
+      default:
+         return true;
+   }
+}
+
+/**
+ * Split path into directory and file name (path is modified). Returns directory or NULL if path does not contain file name.
+ */
+static const char *SplitPath(char *path, char **name)
+{
+   char *s = strrchr(path, '/');
+   if (s == nullptr)
+   {
+      *name = path;
+      return ".";
+   }
+   if (s[1] == 0)
+      return nullptr;
+   *s = 0;
+   *name = s + 1;
+   return (s == path) ? "/" : path;
+}
+
+/**
+ * Check if given watch descriptor is used by any registered watch. Must be called with lock held.
+ */
+static bool IsWatchDescriptorUsed(int wd)
+{
+   for(int i = 0; i < s_watches.size(); i++)
+   {
+      FileChangeWatch *w = s_watches.get(i);
+      if ((w->wd == wd) || (w->linkWd == wd))
+         return true;
+   }
+   return false;
+}
+
+/**
+ * Start watching for changes of given file. Condition will be set on every change of
+ * file content and on file rename or creation. Returns NULL if change notifications
+ * cannot be used for this file, caller should fall back to polling in that case.
+ */
+FileChangeWatch *AddFileChangeWatch(const TCHAR *fileName, CONDITION condition)
+{
+#ifdef UNICODE
+   char *mbName = MBStringFromWideStringSysLocale(fileName);
+#else
+   char *mbName = MemCopyStringA(fileName);
+#endif
+
+   // Resolve symbolic links so that directory with actual file is watched
+   char path[MAX_PATH];
+   if (realpath(mbName, path) == nullptr)
+      strlcpy(path, mbName, MAX_PATH);
+
+   // If file name itself is a symbolic link, also watch directory where link is located
+   char linkPath[MAX_PATH];
+   struct stat st;
+   bool isLink = (lstat(mbName, &st) == 0) && S_ISLNK(st.st_mode);
+   if (isLink)
+      strlcpy(linkPath, mbName, MAX_PATH);
+   MemFree(mbName);
+
+   char *name;
+   const char *dir = SplitPath(path, &name);
+   if (dir == nullptr)
+      return nullptr;
+
+   char *linkName = nullptr;
+   const char *linkDir = isLink ? SplitPath(linkPath, &linkName) : nullptr;
+
+   if (!IsLocalFileSystem(dir) || ((linkDir != nullptr) && !IsLocalFileSystem(linkDir)))
+   {
+      nxlog_debug_tag(DEBUG_TAG, 4, _T("File \"%s\" is not on local file system, change notifications will not be used"), fileName);
+      return nullptr;
+   }
+
+   s_lock.lock();
+   if (!StartNotifier())
+   {
+      s_lock.unlock();
+      return nullptr;
+   }
+
+   int wd = inotify_add_watch(s_inotifyFd, dir, WATCH_MASK);
+   if (wd == -1)
+   {
+      s_lock.unlock();
+      nxlog_debug_tag(DEBUG_TAG, 4, _T("Cannot add inotify watch for file \"%s\" (%s)"), fileName, _tcserror(errno));
+      return nullptr;
+   }
+
+   int linkWd = -1;
+   if (linkDir != nullptr)
+   {
+      linkWd = inotify_add_watch(s_inotifyFd, linkDir, WATCH_MASK);
+      if (linkWd == -1)
+      {
+         // Changes of link target will be detected by periodic checks
+         nxlog_debug_tag(DEBUG_TAG, 4, _T("Cannot add inotify watch for symbolic link \"%s\" (%s)"), fileName, _tcserror(errno));
+      }
+   }
+
+   FileChangeWatch *watch = MemAllocStruct<FileChangeWatch>();
+   watch->wd = wd;
+   watch->name = MemCopyStringA(name);
+   watch->linkWd = linkWd;
+   watch->linkName = (linkWd != -1) ? MemCopyStringA(linkName) : nullptr;
+   watch->condition = condition;
+   s_watches.add(watch);
+   s_lock.unlock();
+   return watch;
+}
+
+/**
+ * Stop watching for file changes. Directory watch is removed when last file in that
+ * directory is not watched anymore.
+ */
+void RemoveFileChangeWatch(FileChangeWatch *watch)
+{
+   if (watch == nullptr)
+      return;
+
+   s_lock.lock();
+   s_watches.remove(watch);
+   if (s_inotifyFd != -1)
+   {
+      if ((watch->wd != -1) && !IsWatchDescriptorUsed(watch->wd))
+         inotify_rm_watch(s_inotifyFd, watch->wd);
+      if ((watch->linkWd != -1) && (watch->linkWd != watch->wd) && !IsWatchDescriptorUsed(watch->linkWd))
+         inotify_rm_watch(s_inotifyFd, watch->linkWd);
+   }
+   s_lock.unlock();
+
+   MemFree(watch->name);
+   MemFree(watch->linkName);
+   MemFree(watch);
+}
+
+/**
+ * Stop notifier thread and release inotify instance
+ */
+void ShutdownFileChangeNotifier()
+{
+   s_lock.lock();
+   if (s_inotifyFd == -1)
+   {
+      s_lock.unlock();
+      return;
+   }
+   ssize_t rc;
+   do
+   {
+      rc = write(s_controlPipe[1], "X", 1);
+   } while((rc == -1) && (errno == EINTR));
+   if (rc != 1)
+   {
+      // Notifier thread cannot be stopped, leave it running until process exit
+      nxlog_debug_tag(DEBUG_TAG, 1, _T("Cannot signal file change notifier thread to stop (%s)"), _tcserror(errno));
+      ThreadDetach(s_notifierThread);
+      s_notifierThread = INVALID_THREAD_HANDLE;
+      s_lock.unlock();
+      return;
+   }
+   s_lock.unlock();
+
+   ThreadJoin(s_notifierThread);
+   s_notifierThread = INVALID_THREAD_HANDLE;
+
+   s_lock.lock();
+   for(int i = 0; i < s_watches.size(); i++)
+   {
+      s_watches.get(i)->wd = -1;
+      s_watches.get(i)->linkWd = -1;
+   }
+   close(s_inotifyFd);
+   close(s_controlPipe[0]);
+   close(s_controlPipe[1]);
+   s_inotifyFd = -1;
+   s_controlPipe[0] = -1;
+   s_controlPipe[1] = -1;
+   s_lock.unlock();
+}
+
+#endif   /* HAVE_SYS_INOTIFY_H */
@@ -116,6 +116,7 @@ struct LogParser_XmlParserState
 LogParser::LogParser()
 {
    m_rules = new ObjectArray<LogParserRule>(16, 16, Ownership::True);
+   m_prefilter = NULL;
 	m_cb = NULL;
 	m_userArg = NULL;
 	m_name = NULL;
@@ -127,6 +128,7 @@ LogParser::LogParser()
 	m_eventResolver = NULL;
 	m_thread = INVALID_THREAD_HANDLE;
    m_stopCondition = ConditionCreate(true);
+   m_fileChangeCondition = ConditionCreate(false);
 	m_recordsProcessed = 0;
 	m_recordsMatched = 0;
 	m_processAllRules = false;
@@ -150,6 +152,7 @@ LogParser::LogParser(const LogParser *src)
    m_rules = new ObjectArray<LogParserRule>(count, 16, Ownership::True);
 	for(int i = 0; i < count; i++)
 		m_rules->add(new LogParserRule(src->m_rules->get(i), this));
+   m_prefilter = NULL;
 
 	m_macros.addAll(&src->m_macros);
 	m_contexts.addAll(&src->m_contexts);
@@ -177,6 +180,7 @@ LogParser::LogParser(const LogParser *src)
 	m_eventResolver = src->m_eventResolver;
 	m_thread = INVALID_THREAD_HANDLE;
    m_stopCondition = ConditionCreate(true);
+   m_fileChangeCondition = ConditionCreate(false);
    m_recordsProcessed = 0;
 	m_recordsMatched = 0;
 	m_processAllRules = src->m_processAllRules;
@@ -196,6 +200,7 @@ LogParser::LogParser(const LogParser *src)
  */
 LogParser::~LogParser()
 {
+   delete m_prefilter;
    delete m_rules;
 	MemFree(m_name);
 	MemFree(m_fileName);
@@ -203,6 +208,7 @@ LogParser::~LogParser()
    MemFree(m_marker);
 #endif
    ConditionDestroy(m_stopCondition);
+   ConditionDestroy(m_fileChangeCondition);
 }
 
 /**
@@ -228,6 +234,8 @@ bool LogParser::addRule(LogParserRule *rule)
 	if (valid)
 	{
 	   m_rules->add(rule);
+	   delete m_prefilter;  // will be rebuilt on next match
+	   m_prefilter = NULL;
 	}
 	else
 	{
@@ -282,6 +290,13 @@ bool LogParser::matchLogRecord(bool hasAttributes, const TCHAR *source, UINT32 e
 	else
 		trace(5, _T("Match line: \"%s\""), line);
 
+	if (m_prefilter == NULL)
+	{
+	   m_prefilter = new RulePrefilter(m_rules);
+	   trace(5, _T("Rule prefilter created (%d rules, %d required literals)"), m_rules->size(), m_prefilter->getLiteralCount());
+	}
+	const bool *candidates = m_prefilter->scan(line);
+
 	m_recordsProcessed++;
 	int i;
 	for(i = 0; i < m_rules->size(); i++)
@@ -290,6 +305,14 @@ bool LogParser::matchLogRecord(bool hasAttributes, const TCHAR *source, UINT32 e
 		trace(6, _T("checking rule %d \"%s\""), i + 1, rule->getDescription());
 		if ((state = checkContext(rule)) != NULL)
 		{
+		   if (!candidates[i])
+		   {
+		      // Required literal is not present in the line, so regular expression cannot match
+		      trace(6, _T("  required literal \"%s\" not found"), rule->getRequiredLiteral());
+		      rule->skip(objectId);
+		      continue;
+		   }
+
 			bool ruleMatched = hasAttributes ?
 			   rule->matchEx(source, eventId, level, line, variables, recordId, objectId, timestamp, m_cb, m_userArg) :
 				rule->match(line, objectId, m_cb, m_userArg);
@@ -993,6 +1016,7 @@ bool LogParser::isExclusionPeriod()
 void LogParser::stop()
 {
    ConditionSet(m_stopCondition);
+   ConditionSet(m_fileChangeCondition);
    ThreadJoin(m_thread);
    m_thread = INVALID_THREAD_HANDLE;
 }
@@ -0,0 +1,180 @@
+/*
+** NetXMS - Network Management System
+** Log Parsing Library
+** Copyright (C) 2003-2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation; either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: prefilter.cpp
+**
+**/
+
+#include "libnxlp.h"
+
+/**
+ * Build prefilter for given rule set. Inverted rules and rules without required literal are always checked.
+ */
+RulePrefilter::RulePrefilter(ObjectArray<LogParserRule> *rules)
+{
+   m_ruleCount = rules->size();
+   m_candidates = MemAllocArrayNoInit<bool>(std::max(m_ruleCount, 1));
+   m_unfiltered = MemAllocArrayNoInit<bool>(std::max(m_ruleCount, 1));
+
+   // Build alphabet from characters used in literals; all other characters are mapped to 0
+   memset(m_charMap, 0, sizeof(m_charMap));
+   m_alphabetSize = 1;
+   m_literalCount = 0;
+   int maxStates = 1;
+   for(int i = 0; i < m_ruleCount; i++)
+   {
+      LogParserRule *rule = rules->get(i);
+      const TCHAR *literal = rule->getRequiredLiteral();
+      m_unfiltered[i] = (literal == NULL) || rule->isInverted();
+      if (m_unfiltered[i])
+         continue;
+      for(const TCHAR *p = literal; *p != 0; p++)
+      {
+         if (m_charMap[*p] == 0)
+            m_charMap[*p] = m_alphabetSize++;
+      }
+      maxStates += static_cast<int>(_tcslen(literal));
+      m_literalCount++;
+   }
+
+   m_transitions = MemAllocArrayNoInit<int32_t>(maxStates * m_alphabetSize);
+   memset(m_transitions, 0xFF, maxStates * m_alphabetSize * sizeof(int32_t));
+   m_outputs = MemAllocArrayNoInit<int32_t>(maxStates);
+   memset(m_outputs, 0xFF, maxStates * sizeof(int32_t));
+   m_dictLinks = MemAllocArray<int32_t>(maxStates);
+   m_outputRules = MemAllocArrayNoInit<int32_t>(std::max(m_literalCount, 1));
+   m_outputNext = MemAllocArrayNoInit<int32_t>(std::max(m_literalCount, 1));
+
+   // Build trie
+   int stateCount = 1;
+   int outputCount = 0;
+   for(int i = 0; i < m_ruleCount; i++)
+   {
+      if (m_unfiltered[i])
+         continue;
+      int state = 0;
+      for(const TCHAR *p = rules->get(i)->getRequiredLiteral(); *p != 0; p++)
+      {
+         int32_t *next = &m_transitions[state * m_alphabetSize + m_charMap[*p]];
+         if (*next == -1)
+            *next = stateCount++;
+         state = *next;
+      }
+      m_outputRules[outputCount] = i;
+      m_outputNext[outputCount] = m_outputs[state];
+      m_outputs[state] = outputCount++;
+   }
+
+   // Calculate failure links breadth first and convert trie into full transition table
+   int32_t *failLinks = MemAllocArray<int32_t>(stateCount);
+   int32_t *queue = MemAllocArrayNoInit<int32_t>(stateCount);
+   int head = 0, tail = 0;
+   for(int c = 0; c < m_alphabetSize; c++)
+   {
+      int32_t s = m_transitions[c];
+      if (s == -1)
+      {
+         m_transitions[c] = 0;
+      }
+      else
+      {
+         failLinks[s] = 0;
+         queue[tail++] = s;
+      }
+   }
+   while(head < tail)
+   {
+      int32_t state = queue[head++];
+      int32_t fail = failLinks[state];
+      for(int c = 0; c < m_alphabetSize; c++)
+      {
+         int32_t s = m_transitions[state * m_alphabetSize + c];
+         if (s == -1)
+         {
+            m_transitions[state * m_alphabetSize + c] = m_transitions[fail * m_alphabetSize + c];
+         }
+         else
+         {
+            int32_t f = m_transitions[fail * m_alphabetSize + c];
+            failLinks[s] = f;
+            m_dictLinks[s] = (m_outputs[f] != -1) ? f : m_dictLinks[f];
+            queue[tail++] = s;
+         }
+      }
+   }
+   MemFree(queue);
+   MemFree(failLinks);
+}
+
+/**
+ * Destructor
+ */
+RulePrefilter::~RulePrefilter()
+{
+   MemFree(m_candidates);
+   MemFree(m_unfiltered);
+   MemFree(m_transitions);
+   MemFree(m_outputs);
+   MemFree(m_dictLinks);
+   MemFree(m_outputRules);
+   MemFree(m_outputNext);
+}
+
+/**
+ * Map line character to alphabet index. Non-ASCII characters which are case equivalent
+ * to ASCII characters in Unicode (KELVIN SIGN and LATIN SMALL LETTER LONG S) are mapped
+ * as well because caseless regular expressions will match them.
+ */
+inline int RulePrefilter::mapChar(TCHAR ch) const
+{
+#ifdef UNICODE
+   if (static_cast<uint32_t>(ch) < 128)
+      return m_charMap[_totlower(ch)];
+   if (ch == 0x212A)
+      return m_charMap['k'];
+   if (ch == 0x017F)
+      return m_charMap['s'];
+   return 0;
+#else
+   unsigned char c = static_cast<unsigned char>(ch);
+   return (c < 128) ? m_charMap[tolower(c)] : 0;
+#endif
+}
+
+/**
+ * Scan line and return array of flags indicating rules which should be checked
+ */
+const bool *RulePrefilter::scan(const TCHAR *line)
+{
+   memcpy(m_candidates, m_unfiltered, m_ruleCount * sizeof(bool));
+   if (m_literalCount == 0)
+      return m_candidates;
+
+   int32_t state = 0;
+   for(const TCHAR *p = line; *p != 0; p++)
+   {
+      state = m_transitions[state * m_alphabetSize + mapChar(*p)];
+      for(int32_t s = (m_outputs[state] != -1) ? state : m_dictLinks[state]; s != 0; s = m_dictLinks[s])
+      {
+         for(int32_t o = m_outputs[s]; o != -1; o = m_outputNext[o])
+            m_candidates[m_outputRules[o]] = true;
+      }
+   }
+   return m_candidates;
+}
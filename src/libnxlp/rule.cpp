@@ -25,6 +25,166 @@
 
 #define MAX_PARAM_COUNT 127
 
+#define MIN_LITERAL_LENGTH 3
+
+/**
+ * Skip character class starting at given position. Returns pointer to closing bracket or to terminating zero.
+ */
+static const TCHAR *SkipCharacterClass(const TCHAR *p)
+{
+   p++;
+   if (*p == _T('^'))
+      p++;
+   if (*p == _T(']'))
+      p++;  // ] as first character is literal
+   for(; (*p != 0) && (*p != _T(']')); p++)
+   {
+      if ((*p == _T('\\')) && (*(p + 1) != 0))
+         p++;
+   }
+   return p;
+}
+
+/**
+ * Check if character after "(?" starts group which does not change matching options
+ */
+static inline bool IsPlainGroup(TCHAR ch)
+{
+   return (ch == _T(':')) || (ch == _T('=')) || (ch == _T('!')) || (ch == _T('<')) || (ch == _T('P')) || (ch == _T('\''));
+}
+
+/**
+ * Check if given character is printable ASCII character
+ */
+static inline bool IsPrintableASCII(TCHAR ch)
+{
+   return (ch >= _T(' ')) && (ch < 127);
+}
+
+/**
+ * Complete current literal sequence
+ */
+static void FlushLiteral(StringBuffer *current, StringBuffer *best)
+{
+   if (current->length() > best->length())
+      *best = *current;
+   current->clear();
+}
+
+/**
+ * Extract longest literal substring which must be present in any line matched by given regular
+ * expression. Only top level sequences of plain ASCII characters are considered, and extraction
+ * gives up on constructs which may change matching semantics (top level alternation, inline
+ * options, quoting, numeric escapes). Returned literal is converted to lower case. Returns NULL
+ * if no usable literal found.
+ */
+static TCHAR *ExtractRequiredLiteral(const TCHAR *regexp)
+{
+   StringBuffer best, current;
+   int depth = 0;
+   for(const TCHAR *p = regexp; *p != 0; p++)
+   {
+      TCHAR ch = *p;
+      if (ch == _T('\\'))
+      {
+         TCHAR next = *(p + 1);
+         if (next == 0)
+            break;
+         p++;
+         if (IsPrintableASCII(next) && _istalnum(next))
+         {
+            // Character types, anchors and control characters are not literals; other escapes
+            // (hex and octal codes, back references, properties, quoting) are not parsed
+            if (_tcschr(_T("dDsSwWbBAzZGhHvVRXtnrfeaEK"), next) == NULL)
+               return NULL;
+            FlushLiteral(&current, &best);
+         }
+         else if (depth == 0)
+         {
+            if (IsPrintableASCII(next))
+               current.append(static_cast<TCHAR>(_totlower(next)));
+            else
+               FlushLiteral(&current, &best);
+         }
+         continue;
+      }
+
+      if (ch == _T('['))
+      {
+         FlushLiteral(&current, &best);
+         p = SkipCharacterClass(p);
+         if (*p == 0)
+            break;
+         continue;
+      }
+
+      if (ch == _T('('))
+      {
+         if ((*(p + 1) == _T('?')) && !IsPlainGroup(*(p + 2)))
+            return NULL;
+         FlushLiteral(&current, &best);
+         depth++;
+         continue;
+      }
+
+      if (ch == _T(')'))
+      {
+         if (depth == 0)
+            return NULL;
+         depth--;
+         continue;
+      }
+
+      if (depth > 0)
+         continue;   // Group content is not required to be present (may be optional or alternative)
+
+      switch(ch)
+      {
+         case _T('|'):
+            return NULL;   // Top level alternation
+         case _T('?'):
+         case _T('*'):
+            // Previous character is optional
+            if (!current.isEmpty())
+               current.shrink(1);
+            FlushLiteral(&current, &best);
+            break;
+         case _T('{'):
+            if (_istdigit(*(p + 1)) || (*(p + 1) == _T(',')))
+            {
+               TCHAR *eptr;
+               long minCount = _tcstol(p + 1, &eptr, 10);
+               while(_istdigit(*eptr) || (*eptr == _T(',')))
+                  eptr++;
+               if (*eptr == _T('}'))
+               {
+                  if ((minCount == 0) && !current.isEmpty())
+                     current.shrink(1);
+                  p = eptr;
+               }
+            }
+            FlushLiteral(&current, &best);
+            break;
+         case _T('+'):
+         case _T('.'):
+         case _T('^'):
+         case _T('$'):
+            FlushLiteral(&current, &best);
+            break;
+         default:
+            if (IsPrintableASCII(ch))
+               current.append(static_cast<TCHAR>(_totlower(ch)));
+            else
+               FlushLiteral(&current, &best);
+            break;
+      }
+   }
+   if (depth != 0)
+      return NULL;
+   FlushLiteral(&current, &best);
+   return (best.length() >= MIN_LITERAL_LENGTH) ? MemCopyString(best) : NULL;
+}
+
 /**
  * Constructor
  */
@@ -59,6 +219,8 @@ LogParserRule::LogParserRule(LogParser *parser, const TCHAR *name, const TCHAR *
 	m_resetRepeat = resetRepeat;
 	m_checkCount = 0;
 	m_matchCount = 0;
+	m_skipCount = 0;
+	m_literal = ExtractRequiredLiteral(m_regexp);
 	m_agentAction = NULL;
 	m_agentActionArgs = new StringList();
    m_objectCounters = new HashMap<uint32_t, ObjectRuleStats>(Ownership::True);
@@ -109,6 +271,7 @@ LogParserRule::LogParserRule(LogParserRule *src, LogParser *parser)
    {
       m_matchArray = new IntegerArray<time_t>();
    }
+   m_literal = MemCopyString(src->m_literal);
    m_agentAction = MemCopyString(src->m_agentAction);
    m_agentActionArgs = new StringList(src->m_agentActionArgs);
    m_objectCounters = new HashMap<uint32_t, ObjectRuleStats>(Ownership::True);
@@ -136,6 +299,7 @@ LogParserRule::~LogParserRule()
 	MemFree(m_description);
 	MemFree(m_source);
 	MemFree(m_regexp);
+	MemFree(m_literal);
 	MemFree(m_eventName);
 	MemFree(m_eventTag);
 	MemFree(m_context);
@@ -354,6 +518,15 @@ void LogParserRule::incMatchCount(uint32_t objectId)
    s->matchCount++;
 }
 
+/**
+ * Register check which was resolved without running regular expression (required literal is not present in the line)
+ */
+void LogParserRule::skip(uint32_t objectId)
+{
+   incCheckCount(objectId);
+   m_skipCount++;
+}
+
 /**
  * Get check count for specfic object
  */
@@ -395,5 +568,6 @@ void LogParserRule::restoreCounters(const LogParserRule *rule)
 {
    m_checkCount = rule->m_checkCount;
    m_matchCount = rule->m_matchCount;
+   m_skipCount = rule->m_skipCount;
    rule->m_objectCounters->forEach(RestoreCountersCallback, m_objectCounters);
 }
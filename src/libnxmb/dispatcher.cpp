@@ -39,11 +39,10 @@ THREAD_RESULT THREAD_CALL NXMBDispatcher::workerThreadStarter(void *arg)
 NXMBDispatcher::NXMBDispatcher()
 {
 	m_queue = new Queue;
-	m_numSubscribers = 0;
-	m_subscribers = NULL;
-	m_filters = NULL;
+	m_subscribers = make_shared<NXMBSubscriberList>();
 	m_subscriberListAccess = MutexCreate();
 	m_workerThreadHandle = INVALID_THREAD_HANDLE;
+   m_workerThreadId = 0;
    m_callHandlers = new CallHandlerMap();
    m_callHandlerAccess = MutexCreate();
    m_startCondition = ConditionCreate(TRUE);
@@ -72,15 +71,9 @@ NXMBDispatcher::~NXMBDispatcher()
 
 	MutexDestroy(m_subscriberListAccess);
 
-	for(int i = 0; i < m_numSubscribers; i++)
-	{
-		if ((m_subscribers[i] != NULL) && m_subscribers[i]->isOwnedByDispatcher())
-			delete m_subscribers[i];
-		if ((m_filters[i] != NULL) && m_filters[i]->isOwnedByDispatcher())
-			delete m_filters[i];
-	}
-	free(m_subscribers);
-	free(m_filters);
+	for(int i = 0; i < m_subscribers->size(); i++)
+		m_subscribers->get(i)->stop();
+	m_subscribers.reset();
 
    MutexDestroy(m_callHandlerAccess);
    delete m_callHandlers;
@@ -95,6 +88,7 @@ NXMBDispatcher::~NXMBDispatcher()
 void NXMBDispatcher::workerThread()
 {
    nxlog_debug(3, _T("NXMB: dispatcher thread started"));
+   m_workerThreadId = GetCurrentThreadId();
    ConditionSet(m_startCondition);
 	while(true)
 	{
@@ -104,16 +98,27 @@ void NXMBDispatcher::workerThread()
 
       nxlog_debug(7, _T("NXMB: processing message %s from %s"), msg->getType(), msg->getSenderId());
 
-		MutexLock(m_subscriberListAccess);
-		for(int i = 0; i < m_numSubscribers; i++)
+		shared_ptr<NXMBSubscriberList> subscribers = getSubscribers();
+		const ObjectArray<NXMBSubscriberEntry> *targets = subscribers->getSubscribersForType(msg->getType());
+		NXMBMessageRef *ref = NULL;
+		for(int i = 0; i < targets->size(); i++)
 		{
-			if (m_filters[i]->isAllowed(*msg))
+			NXMBSubscriberEntry *entry = targets->get(i);
+			if (entry->isQueued())
+			{
+				if (ref == NULL)
+					ref = new NXMBMessageRef(msg);
+				entry->enqueue(ref);
+			}
+			else
 			{
-				m_subscribers[i]->messageHandler(*msg);
+				entry->deliver(msg);
 			}
 		}
-		MutexUnlock(m_subscriberListAccess);
-		delete msg;
+		if (ref != NULL)
+			ref->release();
+		else
+			delete msg;
 	}
    nxlog_debug(3, _T("NXMB: dispatcher thread stopped"));
 }
@@ -127,48 +132,74 @@ void NXMBDispatcher::postMessage(NXMBMessage *msg)
 }
 
 /**
- * Add subscriber
+ * Get current subscriber list
  */
-void NXMBDispatcher::addSubscriber(NXMBSubscriber *subscriber, NXMBFilter *filter)
+shared_ptr<NXMBSubscriberList> NXMBDispatcher::getSubscribers()
 {
-	int i;
+   MutexLock(m_subscriberListAccess);
+   shared_ptr<NXMBSubscriberList> subscribers = m_subscribers;
+   MutexUnlock(m_subscriberListAccess);
+   return subscribers;
+}
 
-	MutexLock(m_subscriberListAccess);
+/**
+ * Replace or remove (if new subscriber is NULL) subscriber with given ID. New
+ * subscriber list is built and swapped with current one, so dispatcher thread
+ * never waits for subscriber list changes.
+ */
+void NXMBDispatcher::replaceSubscriber(const TCHAR *id, NXMBSubscriber *subscriber, NXMBFilter *filter, int queueSize)
+{
+   MutexLock(m_subscriberListAccess);
 
-	for(i = 0; i < m_numSubscribers; i++)
-	{
-		if ((m_subscribers[i] != NULL) && (!_tcscmp(m_subscribers[i]->getId(), subscriber->getId())))
-		{
-			// Subscriber already registered, replace it
-			if (m_subscribers[i] != subscriber)
-			{
-				// Different object with same ID
-				if (m_subscribers[i]->isOwnedByDispatcher())
-					delete m_subscribers[i];
-				m_subscribers[i] = subscriber;
-			}
+   shared_ptr<NXMBSubscriberEntry> oldEntry;
+   auto subscribers = make_shared<NXMBSubscriberList>();
+   for(int i = 0; i < m_subscribers->size(); i++)
+   {
+      const shared_ptr<NXMBSubscriberEntry>& entry = m_subscribers->getShared(i);
+      if (!_tcscmp(entry->getId(), id))
+         oldEntry = entry;
+      else
+         subscribers->add(entry);
+   }
 
-			// Replace filter
-			if (m_filters[i] != filter)
-			{
-				if (m_filters[i]->isOwnedByDispatcher())
-					delete m_filters[i];
-				m_filters[i] = filter;
-			}
-			break;
-		}
-	}
+   if (oldEntry != NULL)
+   {
+      // Same subscriber or filter object can be registered again
+      if (oldEntry->getSubscriber() == subscriber)
+         oldEntry->releaseSubscriber();
+      if (oldEntry->getFilter() == filter)
+         oldEntry->releaseFilter();
+   }
 
-	if (i == m_numSubscribers)		// New subscriber
-	{
-		m_numSubscribers++;
-		m_subscribers = (NXMBSubscriber **)realloc(m_subscribers, sizeof(NXMBSubscriber *) * m_numSubscribers);
-		m_filters = (NXMBFilter **)realloc(m_filters, sizeof(NXMBFilter *) * m_numSubscribers);
-		m_subscribers[i] = subscriber;
-		m_filters[i] = filter;
-	}
+   if (subscriber != NULL)
+   {
+      auto entry = make_shared<NXMBSubscriberEntry>(subscriber, filter, queueSize);
+      entry->start(entry);
+      subscribers->add(entry);
+   }
+   m_subscribers = subscribers;
+
+   MutexUnlock(m_subscriberListAccess);
 
-	MutexUnlock(m_subscriberListAccess);
+   if (oldEntry != NULL)
+   {
+      // Wait for completion of message delivery to old subscriber. There is nothing
+      // to wait for if subscriber is replaced from within handler on dispatcher thread.
+      oldEntry->stop();
+      if (!oldEntry->isQueued() && (GetCurrentThreadId() != m_workerThreadId))
+         oldEntry->waitForDelivery();
+   }
+}
+
+/**
+ * Add subscriber. If queue size is 0, messages will be delivered to subscriber on
+ * dispatcher thread in same order for all subscribers. Otherwise subscriber will get
+ * own delivery queue of given size and worker thread. Dispatcher will wait if
+ * subscriber's queue is full.
+ */
+void NXMBDispatcher::addSubscriber(NXMBSubscriber *subscriber, NXMBFilter *filter, int queueSize)
+{
+   replaceSubscriber(subscriber->getId(), subscriber, filter, queueSize);
 }
 
 /**
@@ -176,26 +207,7 @@ void NXMBDispatcher::addSubscriber(NXMBSubscriber *subscriber, NXMBFilter *filte
  */
 void NXMBDispatcher::removeSubscriber(const TCHAR *id)
 {
-	int i;
-
-	MutexLock(m_subscriberListAccess);
-
-	for(i = 0; i < m_numSubscribers; i++)
-	{
-		if ((m_subscribers[i] != NULL) && (!_tcscmp(m_subscribers[i]->getId(), id)))
-		{
-			if (m_subscribers[i]->isOwnedByDispatcher())
-				delete m_subscribers[i];
-			if ((m_filters[i] != NULL) && m_filters[i]->isOwnedByDispatcher())
-				delete m_filters[i];
-			m_numSubscribers--;
-			memmove(&m_subscribers[i], &m_subscribers[i + 1], sizeof(NXMBSubscriber *) * (m_numSubscribers - i));
-			memmove(&m_filters[i], &m_filters[i + 1], sizeof(NXMBFilter *) * (m_numSubscribers - i));
-			break;
-		}
-	}
-
-	MutexUnlock(m_subscriberListAccess);
+   replaceSubscriber(id, NULL, NULL, 0);
 }
 
 /**
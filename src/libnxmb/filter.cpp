@@ -41,6 +41,17 @@ bool NXMBFilter::isAllowed(NXMBMessage &msg)
 	return true;
 }
 
+/**
+ * Check if messages of given type can be accepted by this filter. Dispatcher
+ * calls this method once per message type and does not call isAllowed() for
+ * messages of types rejected by it. Filter should not be changed after
+ * subscriber registration, otherwise subscriber should be registered again.
+ */
+bool NXMBFilter::isTypeAccepted(const TCHAR *type)
+{
+	return true;
+}
+
 bool NXMBFilter::isOwnedByDispatcher()
 {
 	return true;
@@ -63,6 +74,11 @@ bool NXMBTypeFilter::isAllowed(NXMBMessage &msg)
 	return m_types.get(msg.getType()) != NULL;
 }
 
+bool NXMBTypeFilter::isTypeAccepted(const TCHAR *type)
+{
+	return m_types.contains(type);
+}
+
 void NXMBTypeFilter::addMessageType(const TCHAR *type)
 { 
 	m_types.set(type, _T("*"));
@@ -26,5 +26,115 @@
 
 #include <nxmbapi.h>
 
+/**
+ * Message shared between several subscriber delivery queues
+ */
+struct NXMBMessageRef
+{
+   NXMBMessage *message;
+   VolatileCounter refCount;
+
+   NXMBMessageRef(NXMBMessage *msg)
+   {
+      message = msg;
+      refCount = 1;
+   }
+
+   void addRef()
+   {
+      InterlockedIncrement(&refCount);
+   }
+
+   void release()
+   {
+      if (InterlockedDecrement(&refCount) == 0)
+      {
+         delete message;
+         delete this;
+      }
+   }
+};
+
+/**
+ * Registered subscriber. If delivery queue size is 0 messages are delivered
+ * on dispatcher thread, otherwise subscriber has own bounded queue and worker thread.
+ * Inline delivery is guarded by delivery lock, so subscriber removal can wait for
+ * completion of current delivery without blocking whole dispatcher.
+ */
+class NXMBSubscriberEntry
+{
+private:
+   NXMBSubscriber *m_subscriber;
+   NXMBFilter *m_filter;
+   bool m_ownSubscriber;
+   bool m_ownFilter;
+   Queue *m_queue;
+   size_t m_queueSize;
+   CONDITION m_queueNotFull;
+   CONDITION m_stopCondition;
+   THREAD m_workerThread;
+   UINT32 m_workerThreadId;
+   Mutex m_deliveryLock;
+   volatile bool m_stopped;
+
+   void workerThread();
+   static THREAD_RESULT THREAD_CALL workerThreadStarter(void *arg);
+
+public:
+   NXMBSubscriberEntry(NXMBSubscriber *subscriber, NXMBFilter *filter, int queueSize);
+   ~NXMBSubscriberEntry();
+
+   NXMBSubscriber *getSubscriber() const { return m_subscriber; }
+   NXMBFilter *getFilter() const { return m_filter; }
+   const TCHAR *getId() const { return m_subscriber->getId(); }
+   bool isQueued() const { return m_queue != NULL; }
+   bool isTypeAccepted(const TCHAR *type) const { return m_filter->isTypeAccepted(type); }
+
+   void releaseSubscriber() { m_ownSubscriber = false; }
+   void releaseFilter() { m_ownFilter = false; }
+
+   void process(NXMBMessage *msg)
+   {
+      if (m_filter->isAllowed(*msg))
+         m_subscriber->messageHandler(*msg);
+   }
+   void deliver(NXMBMessage *msg)
+   {
+      m_deliveryLock.lock();
+      if (!m_stopped)
+         process(msg);
+      m_deliveryLock.unlock();
+   }
+   void waitForDelivery()
+   {
+      m_deliveryLock.lock();
+      m_deliveryLock.unlock();
+   }
+   void start(const shared_ptr<NXMBSubscriberEntry>& self);
+   void enqueue(NXMBMessageRef *ref);
+   void stop();
+};
+
+/**
+ * Immutable list of subscribers. Subscribers for each message type are
+ * selected on first use and cached; cache is accessed only by dispatcher thread.
+ */
+class NXMBSubscriberList
+{
+private:
+   SharedObjectArray<NXMBSubscriberEntry> m_entries;
+   StringObjectMap<ObjectArray<NXMBSubscriberEntry>> m_typeCache;
+
+public:
+   NXMBSubscriberList() : m_entries(0, 16), m_typeCache(Ownership::True) { }
+
+   int size() const { return m_entries.size(); }
+   NXMBSubscriberEntry *get(int index) const { return m_entries.get(index); }
+   const shared_ptr<NXMBSubscriberEntry>& getShared(int index) const { return m_entries.getShared(index); }
+   void add(const shared_ptr<NXMBSubscriberEntry>& entry) { m_entries.add(entry); }
+
+   const ObjectArray<NXMBSubscriberEntry> *getSubscribersForType(const TCHAR *type);
+};
+
 
 #endif
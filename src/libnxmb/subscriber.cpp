@@ -54,3 +54,151 @@ bool NXMBSubscriber::isOwnedByDispatcher()
 {
 	return true;
 }
+
+/**
+ * Create subscriber entry. For queued subscribers worker thread is started by start().
+ */
+NXMBSubscriberEntry::NXMBSubscriberEntry(NXMBSubscriber *subscriber, NXMBFilter *filter, int queueSize) : m_deliveryLock(true)
+{
+   m_subscriber = subscriber;
+   m_filter = filter;
+   m_ownSubscriber = subscriber->isOwnedByDispatcher();
+   m_ownFilter = filter->isOwnedByDispatcher();
+   m_stopped = false;
+   if (queueSize > 0)
+   {
+      m_queue = new Queue();
+      m_queueSize = queueSize;
+      m_queueNotFull = ConditionCreate(FALSE);
+      m_stopCondition = ConditionCreate(TRUE);
+   }
+   else
+   {
+      m_queue = NULL;
+      m_queueSize = 0;
+      m_queueNotFull = INVALID_CONDITION_HANDLE;
+      m_stopCondition = INVALID_CONDITION_HANDLE;
+   }
+   m_workerThread = INVALID_THREAD_HANDLE;
+   m_workerThreadId = 0;
+}
+
+/**
+ * Destroy subscriber entry
+ */
+NXMBSubscriberEntry::~NXMBSubscriberEntry()
+{
+   stop();
+   if (m_queue != NULL)
+   {
+      // Release messages posted after stop request
+      void *ref;
+      while((ref = m_queue->get()) != NULL)
+      {
+         if (ref != INVALID_POINTER_VALUE)
+            static_cast<NXMBMessageRef*>(ref)->release();
+      }
+      delete m_queue;
+      ConditionDestroy(m_queueNotFull);
+      ConditionDestroy(m_stopCondition);
+   }
+   if (m_ownSubscriber)
+      delete m_subscriber;
+   if (m_ownFilter)
+      delete m_filter;
+}
+
+/**
+ * Start worker thread for queued subscriber. Worker thread holds reference to the entry,
+ * so entry can be removed from within subscriber's own message handler.
+ */
+void NXMBSubscriberEntry::start(const shared_ptr<NXMBSubscriberEntry>& self)
+{
+   if (m_queue != NULL)
+      m_workerThread = ThreadCreateEx(NXMBSubscriberEntry::workerThreadStarter, 0, new shared_ptr<NXMBSubscriberEntry>(self));
+}
+
+/**
+ * Stop delivery to subscriber. For queued subscriber messages already in queue will be
+ * processed before worker thread stops. Does not wait if called by worker thread itself
+ * (subscriber removed from own handler).
+ */
+void NXMBSubscriberEntry::stop()
+{
+   m_stopped = true;
+   if (m_workerThread == INVALID_THREAD_HANDLE)
+      return;
+
+   ConditionSet(m_queueNotFull);  // wake up dispatcher if it waits for free space
+
+   // ThreadJoin is not used for the same reason as in dispatcher destructor
+   ThreadDetach(m_workerThread);
+   m_workerThread = INVALID_THREAD_HANDLE;
+   m_queue->put(INVALID_POINTER_VALUE);
+   if (GetCurrentThreadId() != m_workerThreadId)
+      ConditionWait(m_stopCondition, 30000);
+}
+
+/**
+ * Put message into delivery queue. Waits for free space if queue is full.
+ */
+void NXMBSubscriberEntry::enqueue(NXMBMessageRef *ref)
+{
+   while(!m_stopped && (m_queue->size() >= m_queueSize))
+      ConditionWait(m_queueNotFull, 1000);
+   if (m_stopped)
+      return;
+   ref->addRef();
+   m_queue->put(ref);
+}
+
+/**
+ * Worker thread starter
+ */
+THREAD_RESULT THREAD_CALL NXMBSubscriberEntry::workerThreadStarter(void *arg)
+{
+   shared_ptr<NXMBSubscriberEntry> *self = static_cast<shared_ptr<NXMBSubscriberEntry>*>(arg);
+   (*self)->workerThread();
+   ConditionSet((*self)->m_stopCondition);
+   delete self;   // may destroy entry if it was already removed from subscriber list
+   return THREAD_OK;
+}
+
+/**
+ * Worker thread
+ */
+void NXMBSubscriberEntry::workerThread()
+{
+   m_workerThreadId = GetCurrentThreadId();
+   nxlog_debug(5, _T("NXMB: delivery thread for subscriber %s started"), m_subscriber->getId());
+   while(true)
+   {
+      NXMBMessageRef *ref = static_cast<NXMBMessageRef*>(m_queue->getOrBlock());
+      if (ref == INVALID_POINTER_VALUE)
+         break;
+      ConditionSet(m_queueNotFull);
+      process(ref->message);
+      ref->release();
+   }
+   nxlog_debug(5, _T("NXMB: delivery thread for subscriber %s stopped"), m_subscriber->getId());
+}
+
+/**
+ * Get subscribers which may accept messages of given type
+ */
+const ObjectArray<NXMBSubscriberEntry> *NXMBSubscriberList::getSubscribersForType(const TCHAR *type)
+{
+   ObjectArray<NXMBSubscriberEntry> *subscribers = m_typeCache.get(type);
+   if (subscribers == NULL)
+   {
+      subscribers = new ObjectArray<NXMBSubscriberEntry>(m_entries.size(), 16, Ownership::False);
+      for(int i = 0; i < m_entries.size(); i++)
+      {
+         NXMBSubscriberEntry *entry = m_entries.get(i);
+         if (entry->isTypeAccepted(type))
+            subscribers->add(entry);
+      }
+      m_typeCache.set(type, subscribers);
+   }
+   return subscribers;
+}
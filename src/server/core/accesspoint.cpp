@@ -99,28 +99,27 @@ bool AccessPoint::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
       if (!m_dcObjects->get(i)->loadThresholdsFromDB(hdb))
          return false;
 
-   // Link access point to node
-	bool success = false;
-   if (!m_isDeleted)
-   {
-      shared_ptr<NetObj> object = FindObjectById(m_nodeId, OBJECT_NODE);
-      if (object != nullptr)
-      {
-         object->addChild(self());
-         addParent(object);
-         success = true;
-      }
-      else
-      {
-         nxlog_write(NXLOG_ERROR, _T("Inconsistent database: access point %s [%u] linked to non-existent node [%u]"), m_name, m_id, m_nodeId);
-      }
-   }
-   else
+   return true;
+}
+
+/**
+ * Link access point to node after loading from database. Called on main thread by startup object loader.
+ */
+bool AccessPoint::linkAfterLoad()
+{
+   if (m_isDeleted)
+      return true;
+
+   shared_ptr<NetObj> node = FindObjectById(m_nodeId, OBJECT_NODE);
+   if (node == nullptr)
    {
-      success = true;
+      nxlog_write(NXLOG_ERROR, _T("Inconsistent database: access point %s [%u] linked to non-existent node [%u]"), m_name, m_id, m_nodeId);
+      return false;
    }
 
-   return success;
+   node->addChild(self());
+   addParent(node);
+   return true;
 }
 
 /**
@@ -507,8 +506,10 @@ void AccessPoint::statusPollFromController(ClientSession *session, UINT32 rqId,
 			sendPollerMsg(rqId, _T("      Starting ICMP ping\r\n"));
 			nxlog_debug(7, _T("AccessPoint::StatusPoll(%d,%s): calling IcmpPing on %s, timeout=%d, size=%d"), m_id, m_name,
 			         m_ipAddress.toString(buffer), g_icmpPingTimeout, g_icmpPingSize);
-			UINT32 responseTime;
-			UINT32 dwPingStatus = IcmpPing(m_ipAddress, 3, g_icmpPingTimeout, &responseTime, g_icmpPingSize, false);
+			IcmpPingTarget target;
+			target.addr = m_ipAddress;
+			IcmpPingMultiple(&target, 1, 3, g_icmpPingTimeout, g_icmpPingSize, false);
+			UINT32 dwPingStatus = target.result;
 			if (dwPingStatus == ICMP_SUCCESS)
          {
 				sendPollerMsg(rqId, POLLER_ERROR _T("      responded to ICMP ping\r\n"));
@@ -0,0 +1,146 @@
+/*
+** NetXMS - Network Management System
+** Copyright (C) 2003-2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: attr_index.cpp
+**
+**/
+
+#include "nxcore.h"
+
+/**
+ * Constructor
+ */
+StringAttributeIndex::StringAttributeIndex() : m_keys(Ownership::True), m_objects(Ownership::True)
+{
+   m_keys.setIgnoreCase(false);
+   m_lock = RWLockCreate();
+}
+
+/**
+ * Destructor
+ */
+StringAttributeIndex::~StringAttributeIndex()
+{
+   RWLockDestroy(m_lock);
+}
+
+/**
+ * Remove object from index (index should be locked by caller)
+ */
+void StringAttributeIndex::removeInternal(uint32_t objectId)
+{
+   String *key = m_objects.get(objectId);
+   if (key == nullptr)
+      return;
+
+   IntegerArray<uint32_t> *objects = m_keys.get(key->cstr());
+   if (objects != nullptr)
+   {
+      objects->remove(objects->indexOf(objectId));
+      if (objects->isEmpty())
+         m_keys.remove(key->cstr());
+   }
+   m_objects.remove(objectId);
+}
+
+/**
+ * Set indexed attribute value for given object. Null or empty key removes object from index.
+ * Returns true if indexed value was changed.
+ */
+bool StringAttributeIndex::update(uint32_t objectId, const TCHAR *key)
+{
+   if ((key != nullptr) && (*key == 0))
+      key = nullptr;
+
+   RWLockWriteLock(m_lock);
+
+   String *currKey = m_objects.get(objectId);
+   bool changed = (currKey == nullptr) ? (key != nullptr) : ((key == nullptr) || _tcscmp(currKey->cstr(), key));
+   if (changed)
+   {
+      removeInternal(objectId);
+      if (key != nullptr)
+      {
+         IntegerArray<uint32_t> *objects = m_keys.get(key);
+         if (objects == nullptr)
+         {
+            objects = new IntegerArray<uint32_t>(1, 4);
+            m_keys.set(key, objects);
+         }
+         objects->add(objectId);
+         m_objects.set(objectId, new String(key));
+      }
+   }
+
+   RWLockUnlock(m_lock);
+   return changed;
+}
+
+/**
+ * Remove object from index. Returns true if object was indexed.
+ */
+bool StringAttributeIndex::remove(uint32_t objectId)
+{
+   RWLockWriteLock(m_lock);
+   bool found = m_objects.contains(objectId);
+   removeInternal(objectId);
+   RWLockUnlock(m_lock);
+   return found;
+}
+
+/**
+ * Get IDs of objects with given attribute value. Returns number of objects found.
+ */
+int StringAttributeIndex::get(const TCHAR *key, IntegerArray<uint32_t> *objects) const
+{
+   if ((key == nullptr) || (*key == 0))
+      return 0;
+
+   int count = 0;
+   RWLockReadLock(m_lock);
+   IntegerArray<uint32_t> *list = m_keys.get(key);
+   if (list != nullptr)
+   {
+      for(int i = 0; i < list->size(); i++)
+         objects->add(list->get(i));
+      count = list->size();
+   }
+   RWLockUnlock(m_lock);
+   return count;
+}
+
+/**
+ * Enumerate all indexed attribute values
+ */
+void StringAttributeIndex::forEach(EnumerationCallbackResult (*callback)(const TCHAR *, const IntegerArray<uint32_t> *, void *), void *context) const
+{
+   RWLockReadLock(m_lock);
+   m_keys.forEach(callback, context);
+   RWLockUnlock(m_lock);
+}
+
+/**
+ * Get number of indexed objects
+ */
+int StringAttributeIndex::size() const
+{
+   RWLockReadLock(m_lock);
+   int s = m_objects.size();
+   RWLockUnlock(m_lock);
+   return s;
+}
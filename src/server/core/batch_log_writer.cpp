@@ -0,0 +1,294 @@
+/*
+** NetXMS - Network Management System
+** Copyright (C) 2003-2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: batch_log_writer.cpp
+**
+**/
+
+#include "nxcore.h"
+
+#define DEBUG_TAG _T("db.writer.log")
+
+/**
+ * Number of attempts to write batch if database connection is lost
+ */
+#define MAX_WRITE_ATTEMPTS    3
+
+/**
+ * Registered writers
+ */
+static ObjectArray<BatchLogWriter> s_writers(8, 8, Ownership::False);
+static Mutex s_writersLock;
+
+/**
+ * Create new writer. Writer thread should be started separately.
+ */
+BatchLogWriter::BatchLogWriter(const TCHAR *name, const TCHAR *table, const TCHAR *columns, const int *sqlTypes, int numColumns,
+         void (*setRowValues)(DB_BULK_INSERT, const void*)) : m_queue(1024, Ownership::True), m_statLock(true)
+{
+   _tcslcpy(m_name, name, 64);
+   m_bulkInsert = DBBulkInsertCreate(table, columns, sqlTypes, numColumns);
+   m_setRowValues = setRowValues;
+   m_thread = INVALID_THREAD_HANDLE;
+   m_stopped = false;
+   m_recordsWritten = 0;
+   m_recordsFailed = 0;
+   m_batches = 0;
+   m_writeTime = 0;
+   m_maxBatchSize = 0;
+
+   s_writersLock.lock();
+   s_writers.add(this);
+   s_writersLock.unlock();
+}
+
+/**
+ * Destructor
+ */
+BatchLogWriter::~BatchLogWriter()
+{
+   s_writersLock.lock();
+   s_writers.remove(this);
+   s_writersLock.unlock();
+   DBBulkInsertFree(m_bulkInsert);
+}
+
+/**
+ * Start writer thread
+ */
+void BatchLogWriter::start()
+{
+   if (m_thread == INVALID_THREAD_HANDLE)
+      m_thread = ThreadCreateEx(writerThreadStarter, this);
+}
+
+/**
+ * Queue record for writing. Writer takes ownership of the record. Records passed
+ * after writer was stopped are discarded.
+ */
+void BatchLogWriter::put(void *record)
+{
+   m_statLock.lock();
+   if (m_stopped)
+   {
+      m_recordsFailed++;
+      m_statLock.unlock();
+      MemFree(record);
+      nxlog_debug_tag(DEBUG_TAG, 5, _T("%s writer: record discarded because writer is stopped"), m_name);
+      return;
+   }
+   m_queue.put(record);
+   m_statLock.unlock();
+}
+
+/**
+ * Stop writer thread. All records queued before this call will be written to database.
+ */
+void BatchLogWriter::stop()
+{
+   if (m_thread == INVALID_THREAD_HANDLE)
+      return;
+   m_statLock.lock();
+   m_stopped = true;
+   m_statLock.unlock();
+   m_queue.put(INVALID_POINTER_VALUE);
+   ThreadJoin(m_thread);
+   m_thread = INVALID_THREAD_HANDLE;
+}
+
+/**
+ * Write collected batch to database. If connection is lost while writing, batch is retried
+ * few times and then kept for later retry by writer thread. If batch is rejected by database,
+ * records are written one by one and only rejected records are discarded. Returns false if
+ * batch was not written because of database connectivity problems.
+ */
+bool BatchLogWriter::flush()
+{
+   int count = DBBulkInsertGetRowCount(m_bulkInsert);
+   INT64 startTime = GetCurrentTimeMs();
+
+   DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+   TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
+   int written = -1;
+   for(int attempt = 1; attempt <= MAX_WRITE_ATTEMPTS; attempt++)
+   {
+      if (attempt > 1)
+         ThreadSleepMs(attempt * 500);
+
+      // Failure to start transaction is always treated as connectivity problem, because
+      // connection lost flag of bulk insert object reflects only previous execution
+      if (!DBBegin(hdb))
+      {
+         nxlog_debug_tag(DEBUG_TAG, 4, _T("%s writer: cannot start transaction for batch of %d records (attempt %d of %d)"), m_name, count, attempt, MAX_WRITE_ATTEMPTS);
+         continue;
+      }
+
+      bool success = DBBulkInsertExecuteEx(hdb, m_bulkInsert, errorText);
+      if (success)
+         success = DBCommit(hdb);
+      else
+         DBRollback(hdb);
+      if (success)
+      {
+         written = count;
+         break;
+      }
+      if (!DBBulkInsertIsConnectionLost(m_bulkInsert))
+      {
+         nxlog_debug_tag(DEBUG_TAG, 4, _T("%s writer: batch of %d records rejected by database, writing records one by one"), m_name, count);
+         written = DBBulkInsertExecuteRowByRow(hdb, m_bulkInsert);
+         break;
+      }
+      nxlog_debug_tag(DEBUG_TAG, 4, _T("%s writer: database connection lost while writing batch of %d records (attempt %d of %d)"), m_name, count, attempt, MAX_WRITE_ATTEMPTS);
+   }
+   DBConnectionPoolReleaseConnection(hdb);
+
+   uint64_t elapsed = static_cast<uint64_t>(GetCurrentTimeMs() - startTime);
+   if (written < 0)
+   {
+      nxlog_debug_tag(DEBUG_TAG, 4, _T("%s writer: batch of %d records not written, will retry later"), m_name, count);
+      return false;
+   }
+
+   DBBulkInsertClear(m_bulkInsert);
+
+   m_statLock.lock();
+   m_recordsWritten += written;
+   m_recordsFailed += count - written;
+   m_batches++;
+   m_writeTime += elapsed;
+   if (count > m_maxBatchSize)
+      m_maxBatchSize = count;
+   m_statLock.unlock();
+
+   nxlog_debug_tag(DEBUG_TAG, 7, _T("%s writer: %d records written, %d discarded in ") UINT64_FMT _T(" ms"), m_name, written, count - written, elapsed);
+   return true;
+}
+
+/**
+ * Discard batch that cannot be written
+ */
+void BatchLogWriter::discardBatch()
+{
+   int count = DBBulkInsertGetRowCount(m_bulkInsert);
+   DBBulkInsertClear(m_bulkInsert);
+   m_statLock.lock();
+   m_recordsFailed += count;
+   m_statLock.unlock();
+   nxlog_debug_tag(DEBUG_TAG, 4, _T("%s writer: batch of %d records discarded"), m_name, count);
+}
+
+/**
+ * Writer thread
+ */
+void BatchLogWriter::writerThread()
+{
+   char threadName[16];
+   snprintf(threadName, 16, "LogWriter/%c%c", static_cast<char>(m_name[0]), static_cast<char>(m_name[1]));
+   ThreadSetName(threadName);
+   nxlog_debug_tag(DEBUG_TAG, 1, _T("%s writer thread started"), m_name);
+
+   int maxRecords = ConfigReadInt(_T("DBWriter.MaxRecordsPerTransaction"), 1000);
+   bool running = true;
+   while(running)
+   {
+      void *record = m_queue.getOrBlock();
+      if (record == INVALID_POINTER_VALUE)
+         break;
+
+      // Collect all immediately available records into single batch
+      while(true)
+      {
+         DBBulkInsertAddRow(m_bulkInsert);
+         m_setRowValues(m_bulkInsert, record);
+         MemFree(record);
+         if (DBBulkInsertGetRowCount(m_bulkInsert) >= maxRecords)
+            break;
+         record = m_queue.get();
+         if (record == nullptr)
+            break;
+         if (record == INVALID_POINTER_VALUE)
+         {
+            running = false;
+            break;
+         }
+      }
+
+      // Keep unwritten batch and retry with increasing delay while new records stay in the queue.
+      // Batch is discarded only on shutdown so that writer thread can be stopped while database is unavailable.
+      uint32_t delay = 1000;
+      while(!flush())
+      {
+         m_statLock.lock();
+         bool stopped = m_stopped;
+         m_statLock.unlock();
+         if (stopped)
+         {
+            discardBatch();
+            break;
+         }
+         ThreadSleepMs(delay);
+         if (delay < 30000)
+            delay *= 2;
+      }
+   }
+
+   nxlog_debug_tag(DEBUG_TAG, 1, _T("%s writer thread stopped"), m_name);
+}
+
+/**
+ * Get writer statistics
+ */
+void BatchLogWriter::getStatistics(uint64_t *recordsWritten, uint64_t *recordsFailed, uint64_t *batches, uint64_t *writeTime, int *maxBatchSize)
+{
+   m_statLock.lock();
+   *recordsWritten = m_recordsWritten;
+   *recordsFailed = m_recordsFailed;
+   *batches = m_batches;
+   *writeTime = m_writeTime;
+   *maxBatchSize = m_maxBatchSize;
+   m_statLock.unlock();
+}
+
+/**
+ * Show statistics for all log writers
+ */
+void ShowBatchLogWriterStatistics(ServerConsole *console)
+{
+   console->print(_T("\x1b[1mWriter          | Queue  | Written      | Failed     | Batches    | Max batch | Avg batch | Time (ms)  | Records/sec\x1b[0m\n"));
+   console->print(_T("----------------+--------+--------------+------------+------------+-----------+-----------+------------+------------\n"));
+   s_writersLock.lock();
+   for(int i = 0; i < s_writers.size(); i++)
+   {
+      BatchLogWriter *writer = s_writers.get(i);
+      uint64_t written, failed, batches, writeTime;
+      int maxBatchSize;
+      writer->getStatistics(&written, &failed, &batches, &writeTime, &maxBatchSize);
+      TCHAR writtenText[32], failedText[32], batchesText[32], timeText[32];
+      _sntprintf(writtenText, 32, UINT64_FMT, written);
+      _sntprintf(failedText, 32, UINT64_FMT, failed);
+      _sntprintf(batchesText, 32, UINT64_FMT, batches);
+      _sntprintf(timeText, 32, UINT64_FMT, writeTime);
+      console->printf(_T("%-15s | %6d | %12s | %10s | %10s | %9d | %9.1f | %10s | %11.1f\n"), writer->getName(),
+               static_cast<int>(writer->getQueue()->size()), writtenText, failedText, batchesText, maxBatchSize,
+               (batches > 0) ? static_cast<double>(written + failed) / static_cast<double>(batches) : 0.0, timeText,
+               (writeTime > 0) ? static_cast<double>(written) * 1000.0 / static_cast<double>(writeTime) : 0.0);
+   }
+   s_writersLock.unlock();
+   console->print(_T("\n"));
+}
@@ -68,29 +68,31 @@ THREAD_RESULT THREAD_CALL BeaconPoller(void *arg)
 		return THREAD_OK;
 	}
 
+	IcmpPingTarget *targets = new IcmpPingTarget[hostList.size()];
 	DbgPrintf(1, _T("Beacon poller thread started"));
 	while(!(g_flags & AF_SHUTDOWN))
 	{
-      int i;
-      for(i = 0; i < hostList.size(); i++)
+      // Check all beacons at once, network is considered available if at least one beacon responds
+      for(int i = 0; i < hostList.size(); i++)
 		{
          DbgPrintf(7, _T("Beacon poller: checking host %s"), hostList.get(i).toString(hosts));
-         if (IcmpPing(hostList.get(i), 1, timeout, NULL, packetSize, false) == ICMP_SUCCESS)
-				break;	// At least one beacon responds, no need to check others
+         targets[i].addr = hostList.get(i);
 		}
-      if ((i == hostList.size()) && (!(g_flags & AF_NO_NETWORK_CONNECTIVITY)))
+      bool available = (IcmpPingMultiple(targets, hostList.size(), 1, timeout, packetSize, false) > 0);
+      if (!available && (!(g_flags & AF_NO_NETWORK_CONNECTIVITY)))
 		{
 			// All beacons are lost, consider NetXMS server network conectivity loss
 			g_flags |= AF_NO_NETWORK_CONNECTIVITY;
          PostSystemEvent(EVENT_NETWORK_CONNECTION_LOST, g_dwMgmtNode, "d", hostList.size());
 		}
-      else if ((i < hostList.size()) && (g_flags & AF_NO_NETWORK_CONNECTIVITY))
+      else if (available && (g_flags & AF_NO_NETWORK_CONNECTIVITY))
 		{
 			g_flags &= ~AF_NO_NETWORK_CONNECTIVITY;
 			PostSystemEvent(EVENT_NETWORK_CONNECTION_RESTORED, g_dwMgmtNode, "d", hostList.size());
 		}
 		ThreadSleepMs(interval);
 	}
+	delete[] targets;
 	DbgPrintf(1, _T("Beacon poller thread terminated"));
 	return THREAD_OK;
 }
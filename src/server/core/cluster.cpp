@@ -32,6 +32,7 @@ Cluster::Cluster() : super()
 	m_dwNumResources = 0;
 	m_pResourceList = NULL;
 	m_zoneUIN = 0;
+   m_loadedMemberIds = nullptr;
 }
 
 /**
@@ -44,6 +45,7 @@ Cluster::Cluster(const TCHAR *pszName, int32_t zoneUIN) : super(pszName)
 	m_dwNumResources = 0;
 	m_pResourceList = NULL;
 	m_zoneUIN = zoneUIN;
+   m_loadedMemberIds = nullptr;
 }
 
 /**
@@ -53,6 +55,7 @@ Cluster::~Cluster()
 {
    delete m_syncNetworks;
 	MemFree(m_pResourceList);
+   delete m_loadedMemberIds;
 }
 
 /**
@@ -63,7 +66,6 @@ bool Cluster::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
 	TCHAR szQuery[256];
    bool bResult = false;
 	DB_RESULT hResult;
-	UINT32 dwNodeId;
 	int i, nRows;
 
    m_id = dwId;
@@ -97,23 +99,10 @@ bool Cluster::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
 		if (hResult != NULL)
 		{
 			nRows = DBGetNumRows(hResult);
+			m_loadedMemberIds = new IntegerArray<UINT32>(nRows);
 			for(i = 0; i < nRows; i++)
-			{
-				dwNodeId = DBGetFieldULong(hResult, i, 0);
-				shared_ptr<NetObj> object = FindObjectById(dwNodeId, OBJECT_NODE);
-				if (object != nullptr)
-				{
-               addChild(object);
-               object->addParent(self());
-				}
-				else
-				{
-               nxlog_write(NXLOG_ERROR, _T("Inconsistent database: cluster object %s [%u] has reference to non-existent node object [%u]"), m_name, m_id, dwNodeId);
-					break;
-				}
-			}
-			if (i == nRows)
-				bResult = true;
+				m_loadedMemberIds->add(DBGetFieldULong(hResult, i, 0));
+			bResult = true;
 			DBFreeResult(hResult);
 		}
 
@@ -174,6 +163,33 @@ bool Cluster::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
    return bResult;
 }
 
+/**
+ * Link member nodes after loading from database. Called on main thread by startup object loader.
+ */
+bool Cluster::linkAfterLoad()
+{
+   if (m_loadedMemberIds == nullptr)
+      return true;
+
+   bool success = true;
+   for(int i = 0; i < m_loadedMemberIds->size(); i++)
+   {
+      UINT32 nodeId = m_loadedMemberIds->get(i);
+      shared_ptr<NetObj> node = FindObjectById(nodeId, OBJECT_NODE);
+      if (node == nullptr)
+      {
+         nxlog_write(NXLOG_ERROR, _T("Inconsistent database: cluster object %s [%u] has reference to non-existent node object [%u]"), m_name, m_id, nodeId);
+         success = false;
+         break;
+      }
+      addChild(node);
+      node->addParent(self());
+   }
+
+   delete_and_null(m_loadedMemberIds);
+   return success;
+}
+
 /**
  * Called by client session handler to check if threshold summary should be shown for this object.
  */
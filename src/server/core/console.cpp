@@ -23,12 +23,14 @@
 #include "nxcore.h"
 #include <entity_mib.h>
 
+#ifdef WITH_ZMQ
+#include "zeromq.h"
+#endif
+
 /**
  * Externals
  */
 extern ObjectQueue<DiscoveredAddress> g_nodePollerQueue;
-extern Queue g_syslogProcessingQueue;
-extern Queue g_syslogWriteQueue;
 extern ThreadPool *g_pollerThreadPool;
 extern ThreadPool *g_schedulerThreadPool;
 extern ThreadPool *g_dataCollectorThreadPool;
@@ -45,6 +47,7 @@ void DiscoveryPoller(PollerInfo *poller);
 void RangeScanCallback(const InetAddress& addr, int32_t zoneUIN, const Node *proxy, uint32_t rtt, ServerConsole *console, void *context);
 void CheckRange(const InetAddressListElement& range, void(*callback)(const InetAddress&, int32_t, const Node *, uint32_t, ServerConsole *, void *), ServerConsole *console, void *context);
 void ShowSyncerStats(ServerConsole *console);
+void ShowPerfDataStorageStats(ServerConsole *console);
 
 /**
  * Format string to show value of global flag
@@ -76,6 +79,7 @@ static void ShowMemoryUsage(ServerConsole *console)
    console->printf(_T("Data collection cache ....: %.02f MB\n"), static_cast<double>(GetDCICacheMemoryUsage()) / 1048576);
    console->printf(_T("Raw DCI data write cache .: %.02f MB\n"), static_cast<double>(GetRawDataWriterMemoryUsage()) / 1048576);
    console->print(_T("\n"));
+   ShowMemoryAccountingCounters(console);
 }
 
 /**
@@ -220,6 +224,20 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
          AddRecurrentScheduledTask(_T("Execute.Script"), szBuffer, pArg, nullptr, 0, 0, SYSTEM_ACCESS_FULL); //TODO: change to correct user
       }
    }
+   else if (IsCommand(_T("BENCHMARK"), szBuffer, 5))
+   {
+      pArg = ExtractWord(pArg, szBuffer);
+      if (IsCommand(_T("FDB"), szBuffer, 3))
+      {
+         ExtractWord(pArg, szBuffer);
+         int size = _tcstol(szBuffer, nullptr, 0);
+         BenchmarkForwardingDatabase(pCtx, (size > 0) ? size : 100000);
+      }
+      else
+      {
+         ConsoleWrite(pCtx, _T("ERROR: Invalid BENCHMARK subcommand\n\n"));
+      }
+   }
    else if (IsCommand(_T("CLEAR"), szBuffer, 5))
    {
       pArg = ExtractWord(pArg, szBuffer);
@@ -733,6 +751,10 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
             ConsoleWrite(pCtx, _T("ERROR: Invalid or missing node ID\n\n"));
          }
       }
+      else if (IsCommand(_T("BINDING-CACHE"), szBuffer, 1))
+      {
+         ShowSourceBindingCacheStatistics(pCtx);
+      }
       else if (IsCommand(_T("COMPONENTS"), szBuffer, 1))
       {
          // Get argument
@@ -1083,6 +1105,10 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
             ConsoleWrite(pCtx, _T("ERROR: Invalid or missing node ID\n\n"));
          }
       }
+      else if (IsCommand(_T("LOG-WRITERS"), szBuffer, 4))
+      {
+         ShowBatchLogWriterStatistics(pCtx);
+      }
       else if (IsCommand(_T("MEMUSAGE"), szBuffer, 3))
       {
          ShowMemoryUsage(pCtx);
@@ -1113,6 +1139,10 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
          StrStrip(szBuffer);
          DumpObjects(pCtx, (szBuffer[0] != 0) ? szBuffer : nullptr);
       }
+      else if (IsCommand(_T("PDS"), szBuffer, 2))
+      {
+         ShowPerfDataStorageStats(pCtx);
+      }
       else if (IsCommand(_T("PE"), szBuffer, 2))
       {
          ShowPredictionEngines(pCtx);
@@ -1133,9 +1163,12 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
          ShowQueueStats(pCtx, GetEventLogWriterQueueSize(), _T("Event log writer"));
          ShowThreadPoolPendingQueue(pCtx, g_pollerThreadPool, _T("Poller"));
          ShowQueueStats(pCtx, GetDiscoveryPollerQueueSize(), _T("Node discovery poller"));
-         ShowQueueStats(pCtx, &g_syslogProcessingQueue, _T("Syslog processing"));
-         ShowQueueStats(pCtx, &g_syslogWriteQueue, _T("Syslog writer"));
+         ShowQueueStats(pCtx, GetSyslogProcessingQueueSize(), _T("Syslog processing"));
+         ShowQueueStats(pCtx, GetSyslogWriterQueueSize(), _T("Syslog writer"));
          ShowThreadPoolPendingQueue(pCtx, g_schedulerThreadPool, _T("Scheduler"));
+#ifdef WITH_ZMQ
+         ShowQueueStats(pCtx, GetZmqPublisherQueueSize(), _T("ZeroMQ publisher"));
+#endif
          ConsolePrintf(pCtx, _T("\n"));
       }
       else if (IsCommand(_T("ROUTING-TABLE"), szBuffer, 1))
@@ -1595,6 +1628,7 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
             _T("Valid commands are:\n")
             _T("   at +<sec> <script> [<params>]     - Schedule one time script execution task\n")
             _T("   at <schedule> <script> [<params>] - Schedule repeated script execution task\n")
+            _T("   benchmark fdb [<entries>]         - Benchmark forwarding database on synthetic data (100000 entries by default)\n")
             _T("   clear                             - Show list of valid component names for clearing\n")
             _T("   clear <component>                 - Clear internal data or queue for given component\n")
             _T("   dbcp reset                        - Reset database connection pool\n")
@@ -1618,6 +1652,7 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
             _T("                                     - Manual active discovery scan for given range. Without 'discovery' parameter prints results only\n")
             _T("   set <variable> <value>            - Set value of server configuration variable\n")
             _T("   show arp <node>                   - Show ARP cache for node\n")
+            _T("   show binding-cache                - Show syslog and SNMP trap source binding cache statistics\n")
             _T("   show components <node>            - Show physical components of given node\n")
             _T("   show dbcp                         - Show active sessions in database connection pool\n")
             _T("   show dbstats                      - Show DB library statistics\n")
@@ -1627,10 +1662,12 @@ int ProcessConsoleCommand(const TCHAR *pszCmdLine, CONSOLE_CTX pCtx)
             _T("   show heap details                 - Show detailed heap information\n")
             _T("   show heap summary                 - Show heap usage summary\n")
             _T("   show index <index>                - Show internal index\n")
+            _T("   show log-writers                  - Show syslog and SNMP trap log writer statistics\n")
             _T("   show modules                      - Show loaded server modules\n")
             _T("   show msgwq                        - Show message wait queues information\n")
             _T("   show ndd                          - Show loaded network device drivers\n")
             _T("   show objects [<filter>]           - Dump network objects to screen\n")
+            _T("   show pds                          - Show performance data storage driver queues\n")
             _T("   show pe                           - Show registered prediction engines\n")
             _T("   show pollers                      - Show poller threads state information\n")
             _T("   show queues                       - Show internal queues statistics\n")
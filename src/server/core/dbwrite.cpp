@@ -25,6 +25,15 @@
 
 #define DEBUG_TAG _T("db.writer")
 
+/**
+ * Registered debug tag (registered on first use, so it is safe to call before server initialization)
+ */
+static inline const DebugTagHandle *DebugTag()
+{
+   static const DebugTagHandle *handle = nxlog_register_debug_tag(DEBUG_TAG);
+   return handle;
+}
+
 /**
  * Delayed SQL request
  */
@@ -32,6 +41,7 @@ struct DELAYED_SQL_REQUEST
 {
    TCHAR *query;
    int bindCount;
+   uint32_t size;
    BYTE *sqlTypes;
    TCHAR *bindings[1]; /* actual size determined by bindCount field */
 };
@@ -91,6 +101,7 @@ static IDataWriter s_idataWriters[MAX_IDATA_WRITERS];
  */
 static void WriterQueueElementDestructor(void *element, Queue *queue)
 {
+   MemoryAccountingRemove(MemoryAccountingTag::DB_WRITER_QUEUE, static_cast<DELAYED_SQL_REQUEST*>(element)->size);
    MemFree(element);
 }
 
@@ -132,12 +143,15 @@ static THREAD s_queueMonitorThread = INVALID_THREAD_HANDLE;
  */
 void NXCORE_EXPORTABLE QueueSQLRequest(const TCHAR *query)
 {
-	DELAYED_SQL_REQUEST *rq = static_cast<DELAYED_SQL_REQUEST*>(MemAlloc(sizeof(DELAYED_SQL_REQUEST) + (_tcslen(query) + 1) * sizeof(TCHAR)));
+   size_t size = sizeof(DELAYED_SQL_REQUEST) + (_tcslen(query) + 1) * sizeof(TCHAR);
+	DELAYED_SQL_REQUEST *rq = static_cast<DELAYED_SQL_REQUEST*>(MemAlloc(size));
 	rq->query = (TCHAR *)&rq->bindings[0];
 	_tcscpy(rq->query, query);
 	rq->bindCount = 0;
+	rq->size = static_cast<uint32_t>(size);
+   MemoryAccountingAdd(MemoryAccountingTag::DB_WRITER_QUEUE, size);
    g_dbWriterQueue.put(rq);
-   nxlog_debug_tag(DEBUG_TAG, 8, _T("SQL request queued: %s"), query);
+   nxlog_debug_tag(DebugTag(), 8, _T("SQL request queued: %s"), query);
 	InterlockedIncrement64(&g_otherWriteRequests);
 }
 
@@ -161,6 +175,7 @@ void NXCORE_EXPORTABLE QueueSQLRequest(const TCHAR *query, int bindCount, int *s
 	rq->query = (TCHAR *)base;
 	_tcscpy(rq->query, query);
 	rq->bindCount = bindCount;
+	rq->size = static_cast<uint32_t>(size);
 	pos += ((int)_tcslen(query) + 1) * sizeof(TCHAR);
 
 	rq->sqlTypes = &base[pos];
@@ -185,8 +200,9 @@ void NXCORE_EXPORTABLE QueueSQLRequest(const TCHAR *query, int bindCount, int *s
 		}
 	}
 
+   MemoryAccountingAdd(MemoryAccountingTag::DB_WRITER_QUEUE, size);
    g_dbWriterQueue.put(rq);
-   nxlog_debug_tag(DEBUG_TAG, 8, _T("SQL request queued: %s"), query);
+   nxlog_debug_tag(DebugTag(), 8, _T("SQL request queued: %s"), query);
    InterlockedIncrement64(&g_otherWriteRequests);
 }
 
@@ -204,6 +220,7 @@ void QueueIDataInsert(time_t timestamp, uint32_t nodeId, uint32_t dciId, const T
 	rq->dciId = dciId;
    _tcslcpy(rq->rawValue, rawValue, MAX_RESULT_LENGTH);
    _tcslcpy(rq->transformedValue, transformedValue, MAX_RESULT_LENGTH);
+   MemoryAccountingAdd(MemoryAccountingTag::DB_WRITER_QUEUE, sizeof(DELAYED_IDATA_INSERT));
    if ((g_flags & AF_SINGLE_TABLE_PERF_DATA) && (g_dbSyntax == DB_SYNTAX_TSDB))
    {
       s_idataWriters[static_cast<int>(storageClass)].queue->put(rq);
@@ -292,12 +309,22 @@ static void DBWriteThread()
 				DBFreeStatement(hStmt);
 			}
 		}
+      MemoryAccountingRemove(MemoryAccountingTag::DB_WRITER_QUEUE, rq->size);
       MemFree(rq);
 
       DBConnectionPoolReleaseConnection(hdb);
    }
 }
 
+/**
+ * Release processed IData request
+ */
+static inline void ReleaseIDataRequest(DELAYED_IDATA_INSERT *rq)
+{
+   MemoryAccountingRemove(MemoryAccountingTag::DB_WRITER_QUEUE, sizeof(DELAYED_IDATA_INSERT));
+   MemFree(rq);
+}
+
 /**
  * Database "lazy" write thread for idata_xxx INSERTs
  */
@@ -351,7 +378,7 @@ static THREAD_RESULT THREAD_CALL IDataWriteThread(void *arg)
                success = DBQuery(hdb, query);
 				}
 
-				MemFree(rq);
+				ReleaseIDataRequest(rq);
 
 				count++;
 				if (!success || (count > maxRecords))
@@ -365,7 +392,7 @@ static THREAD_RESULT THREAD_CALL IDataWriteThread(void *arg)
 		}
 		else
 		{
-			MemFree(rq);
+			ReleaseIDataRequest(rq);
 		}
 		DBConnectionPoolReleaseConnection(hdb);
       if (rq == INVALID_POINTER_VALUE)   // End-of-job indicator
@@ -403,7 +430,7 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_Generic(void *arg)
                        (const TCHAR *)DBPrepareString(hdb, rq->rawValue));
             bool success = DBQuery(hdb, query);
 
-            MemFree(rq);
+            ReleaseIDataRequest(rq);
 
             count++;
             if (!success || (count > maxRecords))
@@ -417,7 +444,7 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_Generic(void *arg)
       }
       else
       {
-         MemFree(rq);
+         ReleaseIDataRequest(rq);
       }
       DBConnectionPoolReleaseConnection(hdb);
       if (rq == INVALID_POINTER_VALUE)   // End-of-job indicator
@@ -475,7 +502,7 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_PostgreSQL(void *ar
                        (const TCHAR *)DBPrepareString(hdb, rq->transformedValue),
                        (const TCHAR *)DBPrepareString(hdb, rq->rawValue));
             query.append(data);
-            MemFree(rq);
+            ReleaseIDataRequest(rq);
 
             countTxn++;
             countStmt++;
@@ -505,7 +532,7 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_PostgreSQL(void *ar
       }
       else
       {
-         MemFree(rq);
+         ReleaseIDataRequest(rq);
       }
       DBConnectionPoolReleaseConnection(hdb);
       if (rq == INVALID_POINTER_VALUE)   // End-of-job indicator
@@ -544,7 +571,7 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_Oracle(void *arg)
                DBBind(hStmt, 4, DB_SQLTYPE_VARCHAR, rq->rawValue, DB_BIND_STATIC);
                bool success = DBExecute(hStmt);
 
-               MemFree(rq);
+               ReleaseIDataRequest(rq);
 
                count++;
                if (!success || (count > maxRecords))
@@ -558,13 +585,13 @@ static THREAD_RESULT THREAD_CALL IDataWriteThreadSingleTable_Oracle(void *arg)
          }
          else
          {
-            MemFree(rq);
+            ReleaseIDataRequest(rq);
          }
          DBCommit(hdb);
       }
       else
       {
-         MemFree(rq);
+         ReleaseIDataRequest(rq);
       }
       DBConnectionPoolReleaseConnection(hdb);
       if (rq == INVALID_POINTER_VALUE)   // End-of-job indicator
@@ -587,11 +614,11 @@ static void SaveRawData(int maxRecords)
    s_batchSize = HASH_COUNT(batch);
    if (s_batchSize == 0)
    {
-      nxlog_debug_tag(DEBUG_TAG, 7, _T("Empty raw data batch, skipping write cycle"));
+      nxlog_debug_tag(DebugTag(), 7, _T("Empty raw data batch, skipping write cycle"));
       return;
    }
 
-   nxlog_debug_tag(DEBUG_TAG, 7, _T("%d records in raw data batch"), s_batchSize);
+   nxlog_debug_tag(DebugTag(), 7, _T("%d records in raw data batch"), s_batchSize);
    DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
    if (DBBegin(hdb))
    {
@@ -666,13 +693,13 @@ static void RawDataWriteThread()
    ThreadSetName("DBWriter/RData");
    int maxRecords = ConfigReadInt(_T("DBWriter.MaxRecordsPerTransaction"), 1000);
    int flushInterval = ConfigReadInt(_T("DBWriter.RawDataFlushInterval"), 30);
-   nxlog_debug_tag(DEBUG_TAG, 1, _T("Raw DCI data flush interval is %d seconds"), flushInterval);
+   nxlog_debug_tag(DebugTag(), 1, _T("Raw DCI data flush interval is %d seconds"), flushInterval);
    while(!SleepAndCheckForShutdown(flushInterval))
    {
       SaveRawData(maxRecords);
 	}
    SaveRawData(maxRecords);
-   nxlog_debug_tag(DEBUG_TAG, 1, _T("Raw DCI data writer stopped"));
+   nxlog_debug_tag(DebugTag(), 1, _T("Raw DCI data writer stopped"));
 }
 
 /**
@@ -681,7 +708,7 @@ static void RawDataWriteThread()
 static void QueueMonitorThread()
 {
    ThreadSetName("DBQueueMonitor");
-   nxlog_debug_tag(DEBUG_TAG, 1, _T("Queue monitor started"));
+   nxlog_debug_tag(DebugTag(), 1, _T("Queue monitor started"));
    while(!s_queueMonitorStopCondition.wait(5000))
    {
       int64_t maxQueueSize = ConfigReadULong(_T("DBWriter.MaxQueueSize"), 0);
@@ -710,7 +737,7 @@ static void QueueMonitorThread()
          PostSystemEvent(EVENT_DBWRITER_QUEUE_NORMAL, g_dwMgmtNode, nullptr);
       }
    }
-   nxlog_debug_tag(DEBUG_TAG, 1, _T("Queue monitor stopped"));
+   nxlog_debug_tag(DebugTag(), 1, _T("Queue monitor stopped"));
 }
 
 /**
@@ -718,7 +745,7 @@ static void QueueMonitorThread()
  */
 static void QueuedRequestDestructor(void *object, Queue *queue)
 {
-   MemFree(object);
+   ReleaseIDataRequest(static_cast<DELAYED_IDATA_INSERT*>(object));
 }
 
 /**
@@ -767,7 +794,7 @@ void StartDBWriter()
          s_idataWriterCount = 1;
       else if (s_idataWriterCount > MAX_IDATA_WRITERS)
          s_idataWriterCount = MAX_IDATA_WRITERS;
-      nxlog_debug_tag(DEBUG_TAG, 1, _T("Using %d DCI data write queues"), s_idataWriterCount);
+      nxlog_debug_tag(DebugTag(), 1, _T("Using %d DCI data write queues"), s_idataWriterCount);
       for(int i = 0; i < s_idataWriterCount; i++)
       {
          s_idataWriters[i].storageClass = nullptr;
@@ -802,7 +829,7 @@ void StopDBWriter()
    }
    ThreadJoin(s_rawDataWriterThread);
 
-   nxlog_debug_tag(DEBUG_TAG, 1, _T("All background database writers stopped"));
+   nxlog_debug_tag(DebugTag(), 1, _T("All background database writers stopped"));
 }
 
 /**
@@ -810,7 +837,7 @@ void StopDBWriter()
  */
 void OnDBWriterMaxQueueSizeChange()
 {
-   nxlog_debug_tag(DEBUG_TAG, 3, _T("Threshold for background database writer queue size changed"));
+   nxlog_debug_tag(DebugTag(), 3, _T("Threshold for background database writer queue size changed"));
    s_queueMonitorStateLock.lock();
    if (ConfigReadULong(_T("DBWriter.MaxQueueSize"), 0) > 0)
    {
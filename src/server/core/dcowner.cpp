@@ -109,7 +109,8 @@ bool DataCollectionOwner::saveToDatabase(DB_HANDLE hdb)
 
    unlockProperties();
 
-   // Save data collection items
+   // Save data collection items. Items do not track own changes, so unlike common
+   // properties and access list all items are written when any of them was changed.
 	if (success && (m_modified & MODIFY_DATA_COLLECTION))
 	{
       readLockDciAccess();
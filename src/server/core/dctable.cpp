@@ -386,56 +386,47 @@ bool DCTable::processNewValue(time_t timestamp, void *value, bool *updateStatus)
 
    unlock();
 
-	// Save data to database
+	// Queue data for saving to database
 	// Object is unlocked, so only local variables can be used
    if (save)
    {
-	   DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
-      if (!DBBegin(hdb))
+      TCHAR query[256];
+      if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
       {
-   	   DBConnectionPoolReleaseConnection(hdb);
-         return true;
+         if (g_dbSyntax == DB_SYNTAX_TSDB)
+         {
+            _sntprintf(query, 256, _T("INSERT INTO tdata_sc_%s (item_id,tdata_timestamp,tdata_value) VALUES (?,to_timestamp(?),?)"),
+                     getStorageClassName(getStorageClass()));
+         }
+         else
+         {
+            _tcscpy(query, _T("INSERT INTO tdata (item_id,tdata_timestamp,tdata_value) VALUES (?,?,?)"));
+         }
       }
-
-      bool success = false;
-	   Table *data = static_cast<Table*>(value);
-
-	   DB_STATEMENT hStmt;
-	   if (g_flags & AF_SINGLE_TABLE_PERF_DATA)
-	   {
-	      if (g_dbSyntax == DB_SYNTAX_TSDB)
-	      {
-	         TCHAR query[256];
-	         _sntprintf(query, 256, _T("INSERT INTO tdata_sc_%s (item_id,tdata_timestamp,tdata_value) VALUES (?,to_timestamp(?),?)"),
-	                  getStorageClassName(getStorageClass()));
-            hStmt = DBPrepare(hdb, query);
-	      }
-	      else
-	      {
-	         hStmt = DBPrepare(hdb, _T("INSERT INTO tdata (item_id,tdata_timestamp,tdata_value) VALUES (?,?,?)"));
-	      }
-	   }
-	   else
-	   {
-	      TCHAR query[256];
-	      _sntprintf(query, 256, _T("INSERT INTO tdata_%u (item_id,tdata_timestamp,tdata_value) VALUES (?,?,?)"), nodeId);
-	      hStmt = DBPrepare(hdb, query);
-	   }
-	   if (hStmt != nullptr)
-	   {
-		   DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, tableId);
-		   DBBind(hStmt, 2, DB_SQLTYPE_INTEGER, (INT32)timestamp);
-		   DBBind(hStmt, 3, DB_SQLTYPE_TEXT, DB_CTYPE_UTF8_STRING, data->createPackedXML(), DB_BIND_DYNAMIC);
-	      success = DBExecute(hStmt);
-		   DBFreeStatement(hStmt);
-	   }
-
-      if (success)
-         DBCommit(hdb);
       else
-         DBRollback(hdb);
+      {
+         _sntprintf(query, 256, _T("INSERT INTO tdata_%u (item_id,tdata_timestamp,tdata_value) VALUES (?,?,?)"), nodeId);
+      }
 
-	   DBConnectionPoolReleaseConnection(hdb);
+      char *packedTable = static_cast<Table*>(value)->createPackedBinary();
+      if (packedTable != nullptr)
+      {
+         TCHAR tableIdText[16], timestampText[32];
+         _sntprintf(tableIdText, 16, _T("%u"), tableId);
+         _sntprintf(timestampText, 32, INT64_FMT, static_cast<int64_t>(timestamp));
+#ifdef UNICODE
+         WCHAR *packedTableText = WideStringFromMBString(packedTable);
+#else
+         char *packedTableText = packedTable;
+#endif
+         int sqlTypes[3] = { DB_SQLTYPE_INTEGER, DB_SQLTYPE_INTEGER, DB_SQLTYPE_TEXT };
+         const TCHAR *values[3] = { tableIdText, timestampText, packedTableText };
+         QueueSQLRequest(query, 3, sqlTypes, values);
+#ifdef UNICODE
+         MemFree(packedTableText);
+#endif
+         MemFree(packedTable);
+      }
    }
    if ((g_offlineDataRelevanceTime <= 0) || (timestamp > (time(nullptr) - g_offlineDataRelevanceTime)))
       checkThresholds(static_cast<Table*>(value));
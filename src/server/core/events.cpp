@@ -195,6 +195,7 @@ bool EventTemplate::saveToDatabase() const
  */
 Event::Event()
 {
+   MemoryAccountingAdd(MemoryAccountingTag::EVENTS, sizeof(Event));
    m_id = 0;
 	m_name[0] = 0;
    m_rootId = 0;
@@ -218,6 +219,7 @@ Event::Event()
  */
 Event::Event(const Event *src)
 {
+   MemoryAccountingAdd(MemoryAccountingTag::EVENTS, sizeof(Event));
    m_id = src->m_id;
    _tcscpy(m_name, src->m_name);
    m_rootId = src->m_rootId;
@@ -353,6 +355,7 @@ Event *Event::createFromJson(json_t *json)
 Event::Event(const EventTemplate *eventTemplate, EventOrigin origin, time_t originTimestamp, UINT32 sourceId,
          UINT32 dciId, const TCHAR *tag, const char *format, const TCHAR **names, va_list args)
 {
+   MemoryAccountingAdd(MemoryAccountingTag::EVENTS, sizeof(Event));
    init(eventTemplate, origin, originTimestamp, sourceId, dciId, tag);
 
    // Create parameters
@@ -454,6 +457,7 @@ Event::Event(const EventTemplate *eventTemplate, EventOrigin origin, time_t orig
 Event::Event(const EventTemplate *eventTemplate, EventOrigin origin, time_t originTimestamp, UINT32 sourceId,
          UINT32 dciId, const TCHAR *tag, StringMap *args)
 {
+   MemoryAccountingAdd(MemoryAccountingTag::EVENTS, sizeof(Event));
    init(eventTemplate, origin, originTimestamp, sourceId, dciId, tag);
    Iterator<std::pair<const TCHAR*, const TCHAR*>> *it = args->iterator();
    while(it->hasNext())
@@ -526,6 +530,7 @@ void Event::init(const EventTemplate *eventTemplate, EventOrigin origin, time_t
  */
 Event::~Event()
 {
+   MemoryAccountingRemove(MemoryAccountingTag::EVENTS, sizeof(Event));
    MemFree(m_messageText);
    MemFree(m_messageTemplate);
 	MemFree(m_customMessage);
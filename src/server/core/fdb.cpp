@@ -21,6 +21,27 @@
 **/
 
 #include "nxcore.h"
+#include <uthash.h>
+
+/**
+ * MAC address index entry
+ */
+struct FDB_MAC_INDEX_ENTRY
+{
+   UT_hash_handle hh;
+   BYTE macAddr[MAC_ADDR_LENGTH];
+   int index;
+};
+
+/**
+ * Bridge port index entry
+ */
+struct FDB_PORT_INDEX_ENTRY
+{
+   UT_hash_handle hh;
+   uint32_t port;
+   uint32_t ifIndex;
+};
 
 /**
  * Constructor
@@ -31,9 +52,12 @@ ForwardingDatabase::ForwardingDatabase(uint32_t nodeId)
 	m_fdb = nullptr;
 	m_fdbSize = 0;
 	m_fdbAllocated = 0;
-	m_portMap = nullptr;
-	m_pmSize = 0;
-	m_pmAllocated = 0;
+	m_macIndex = nullptr;
+	m_macIndexPool = new MemoryPool(65536);
+	m_portIndex = nullptr;
+	m_portIndexPool = new MemoryPool(4096);
+	m_portCounts = nullptr;
+	m_portCountsSize = 0;
 	m_timestamp = time(nullptr);
 	m_currentVlanId = 0;
 }
@@ -43,22 +67,53 @@ ForwardingDatabase::ForwardingDatabase(uint32_t nodeId)
  */
 ForwardingDatabase::~ForwardingDatabase()
 {
+   destroyMacIndex();
+   HASH_CLEAR(hh, m_portIndex);
+   delete m_portIndexPool;
 	MemFree(m_fdb);
-	MemFree(m_portMap);
+	MemFree(m_portCounts);
 }
 
 /**
- * Add port mapping entry
+ * Destroy MAC address index used during database construction
+ */
+void ForwardingDatabase::destroyMacIndex()
+{
+   HASH_CLEAR(hh, m_macIndex);
+   delete m_macIndexPool;
+   m_macIndexPool = nullptr;
+}
+
+/**
+ * Rebuild MAC address index (only needed if entries are added after sort)
+ */
+void ForwardingDatabase::buildMacIndex()
+{
+   if (m_macIndexPool == nullptr)
+      m_macIndexPool = new MemoryPool(65536);
+   for(int i = 0; i < m_fdbSize; i++)
+   {
+      FDB_MAC_INDEX_ENTRY *e = m_macIndexPool->allocateArray<FDB_MAC_INDEX_ENTRY>(1);
+      memcpy(e->macAddr, m_fdb[i].macAddr, MAC_ADDR_LENGTH);
+      e->index = i;
+      HASH_ADD(hh, m_macIndex, macAddr, MAC_ADDR_LENGTH, e);
+   }
+}
+
+/**
+ * Add port mapping entry. If mapping for same port already exist it is not changed.
  */
 void ForwardingDatabase::addPortMapping(PORT_MAPPING_ENTRY *entry)
 {
-	if (m_pmSize == m_pmAllocated)
-	{
-		m_pmAllocated += 32;
-		m_portMap = (PORT_MAPPING_ENTRY *)realloc(m_portMap, sizeof(PORT_MAPPING_ENTRY) * m_pmAllocated);
-	}
-	memcpy(&m_portMap[m_pmSize], entry, sizeof(PORT_MAPPING_ENTRY));
-	m_pmSize++;
+   FDB_PORT_INDEX_ENTRY *e;
+   HASH_FIND(hh, m_portIndex, &entry->port, sizeof(uint32_t), e);
+   if (e != nullptr)
+      return;
+
+   e = m_portIndexPool->allocateArray<FDB_PORT_INDEX_ENTRY>(1);
+   e->port = entry->port;
+   e->ifIndex = entry->ifIndex;
+   HASH_ADD(hh, m_portIndex, port, sizeof(uint32_t), e);
 }
 
 /**
@@ -66,19 +121,27 @@ void ForwardingDatabase::addPortMapping(PORT_MAPPING_ENTRY *entry)
  */
 uint32_t ForwardingDatabase::ifIndexFromPort(uint32_t port)
 {
-	for(int i = 0; i < m_pmSize; i++)
-		if (m_portMap[i].port == port)
-			return m_portMap[i].ifIndex;
+   FDB_PORT_INDEX_ENTRY *e;
+   HASH_FIND(hh, m_portIndex, &port, sizeof(uint32_t), e);
+   if (e != nullptr)
+      return e->ifIndex;
 
 	// Try to lookup node interfaces because correct bridge port number may be set by driver
+   uint32_t ifIndex = 0;
 	shared_ptr<NetObj> node = FindObjectById(m_nodeId, OBJECT_NODE);
 	if (node != nullptr)
 	{
 	   shared_ptr<Interface> iface = static_cast<Node*>(node.get())->findBridgePort(port);
 	   if (iface != nullptr)
-	      return iface->getIfIndex();
+	      ifIndex = iface->getIfIndex();
 	}
-	return 0;
+
+	// Remember result so node interfaces will be checked only once for each unmapped port
+	PORT_MAPPING_ENTRY pm;
+	pm.port = port;
+	pm.ifIndex = ifIndex;
+	addPortMapping(&pm);
+	return ifIndex;
 }
 
 /**
@@ -86,22 +149,40 @@ uint32_t ForwardingDatabase::ifIndexFromPort(uint32_t port)
  */
 void ForwardingDatabase::addEntry(FDB_ENTRY *entry)
 {
+   if ((m_macIndex == nullptr) && (m_fdbSize > 0))
+      buildMacIndex();
+   if (m_portCounts != nullptr)
+   {
+      MemFree(m_portCounts);
+      m_portCounts = nullptr;
+      m_portCountsSize = 0;
+   }
+
 	// Check for duplicate
-	for(int i = 0; i < m_fdbSize; i++)
-		if (!memcmp(m_fdb[i].macAddr, entry->macAddr, MAC_ADDR_LENGTH))
-		{
-			memcpy(&m_fdb[i], entry, sizeof(FDB_ENTRY));
-			m_fdb[i].ifIndex = ifIndexFromPort(entry->port);
-			return;
-		}
+   FDB_MAC_INDEX_ENTRY *e;
+   HASH_FIND(hh, m_macIndex, entry->macAddr, MAC_ADDR_LENGTH, e);
+   if (e != nullptr)
+   {
+      memcpy(&m_fdb[e->index], entry, sizeof(FDB_ENTRY));
+      m_fdb[e->index].ifIndex = ifIndexFromPort(entry->port);
+      return;
+   }
 
 	if (m_fdbSize == m_fdbAllocated)
 	{
-		m_fdbAllocated += 32;
+		m_fdbAllocated += std::max(m_fdbAllocated / 2, 32);
 		m_fdb = MemReallocArray(m_fdb, m_fdbAllocated);
 	}
 	memcpy(&m_fdb[m_fdbSize], entry, sizeof(FDB_ENTRY));
 	m_fdb[m_fdbSize].ifIndex = ifIndexFromPort(entry->port);
+
+   if (m_macIndexPool == nullptr)
+      m_macIndexPool = new MemoryPool(65536);
+   e = m_macIndexPool->allocateArray<FDB_MAC_INDEX_ENTRY>(1);
+   memcpy(e->macAddr, entry->macAddr, MAC_ADDR_LENGTH);
+   e->index = m_fdbSize;
+   HASH_ADD(hh, m_macIndex, macAddr, MAC_ADDR_LENGTH, e);
+
 	m_fdbSize++;
 }
 
@@ -127,6 +208,79 @@ uint32_t ForwardingDatabase::findMacAddress(const BYTE *macAddr, bool *isStatic)
 	return (entry != nullptr) ? entry->ifIndex : 0;
 }
 
+/**
+ * Port count comparator
+ */
+static int PortCountComparator(const void *p1, const void *p2)
+{
+   uint32_t i1 = static_cast<const FDB_PORT_COUNT*>(p1)->ifIndex;
+   uint32_t i2 = static_cast<const FDB_PORT_COUNT*>(p2)->ifIndex;
+   if (i1 != i2)
+      return (i1 < i2) ? -1 : 1;
+   int e1 = static_cast<const FDB_PORT_COUNT*>(p1)->firstEntry;
+   int e2 = static_cast<const FDB_PORT_COUNT*>(p2)->firstEntry;
+   return (e1 < e2) ? -1 : ((e1 > e2) ? 1 : 0);
+}
+
+/**
+ * Build per-interface MAC address counts
+ */
+void ForwardingDatabase::buildPortCounts()
+{
+   MemFree(m_portCounts);
+   m_portCountsSize = 0;
+   if (m_fdbSize == 0)
+   {
+      m_portCounts = nullptr;
+      return;
+   }
+
+   m_portCounts = MemAllocArrayNoInit<FDB_PORT_COUNT>(m_fdbSize);
+   for(int i = 0; i < m_fdbSize; i++)
+   {
+      m_portCounts[i].ifIndex = m_fdb[i].ifIndex;
+      m_portCounts[i].count = 1;
+      m_portCounts[i].firstEntry = i;
+   }
+   qsort(m_portCounts, m_fdbSize, sizeof(FDB_PORT_COUNT), PortCountComparator);
+
+   // Merge entries for same interface in place
+   int n = 0;
+   for(int i = 1; i < m_fdbSize; i++)
+   {
+      if (m_portCounts[i].ifIndex == m_portCounts[n].ifIndex)
+      {
+         m_portCounts[n].count++;
+      }
+      else
+      {
+         n++;
+         m_portCounts[n] = m_portCounts[i];
+      }
+   }
+   m_portCountsSize = n + 1;
+   m_portCounts = MemReallocArray(m_portCounts, m_portCountsSize);
+}
+
+/**
+ * Find MAC address count for given interface
+ */
+const FDB_PORT_COUNT *ForwardingDatabase::findPortCount(uint32_t ifIndex) const
+{
+   int l = 0, r = m_portCountsSize - 1;
+   while(l <= r)
+   {
+      int m = (l + r) / 2;
+      if (m_portCounts[m].ifIndex == ifIndex)
+         return &m_portCounts[m];
+      if (m_portCounts[m].ifIndex < ifIndex)
+         l = m + 1;
+      else
+         r = m - 1;
+   }
+   return nullptr;
+}
+
 /**
  * Check if port has only one MAC in FDB
  * If macAddr parameter is not nullptr, MAC address found on port
@@ -134,18 +288,29 @@ uint32_t ForwardingDatabase::findMacAddress(const BYTE *macAddr, bool *isStatic)
  */
 bool ForwardingDatabase::isSingleMacOnPort(uint32_t ifIndex, BYTE *macAddr)
 {
-	int count = 0;
-	for(int i = 0; i < m_fdbSize; i++)
-		if (m_fdb[i].ifIndex == ifIndex)
-		{
-			count++;
-			if (count > 1)
-				return false;
-			if (macAddr != nullptr)
-				memcpy(macAddr, m_fdb[i].macAddr, MAC_ADDR_LENGTH);
-		}
+   if (m_portCounts == nullptr)
+   {
+      // Database not finalized yet
+      int count = 0;
+      for(int i = 0; i < m_fdbSize; i++)
+         if (m_fdb[i].ifIndex == ifIndex)
+         {
+            count++;
+            if (count > 1)
+               return false;
+            if (macAddr != nullptr)
+               memcpy(macAddr, m_fdb[i].macAddr, MAC_ADDR_LENGTH);
+         }
+      return count == 1;
+   }
 
-	return count == 1;
+   const FDB_PORT_COUNT *pc = findPortCount(ifIndex);
+   if ((pc == nullptr) || (pc->count != 1))
+      return false;
+
+   if (macAddr != nullptr)
+      memcpy(macAddr, m_fdb[pc->firstEntry].macAddr, MAC_ADDR_LENGTH);
+   return true;
 }
 
 /**
@@ -153,14 +318,18 @@ bool ForwardingDatabase::isSingleMacOnPort(uint32_t ifIndex, BYTE *macAddr)
  */
 int ForwardingDatabase::getMacCountOnPort(uint32_t ifIndex)
 {
-	int count = 0;
-	for(int i = 0; i < m_fdbSize; i++)
-		if (m_fdb[i].ifIndex == ifIndex)
-		{
-			count++;
-		}
+   if (m_portCounts == nullptr)
+   {
+      // Database not finalized yet
+      int count = 0;
+      for(int i = 0; i < m_fdbSize; i++)
+         if (m_fdb[i].ifIndex == ifIndex)
+            count++;
+      return count;
+   }
 
-	return count;
+   const FDB_PORT_COUNT *pc = findPortCount(ifIndex);
+   return (pc != nullptr) ? pc->count : 0;
 }
 
 /**
@@ -232,11 +401,15 @@ void ForwardingDatabase::fillMessage(NXCPMessage *msg)
 }
 
 /**
- * Sort FDB
+ * Sort FDB and build per-interface MAC address counts. MAC address index used during
+ * construction is destroyed (it will be rebuilt if more entries are added later).
+ * Port mappings are kept so that entries added after sort get correct interface index.
  */
 void ForwardingDatabase::sort()
 {
+   destroyMacIndex();
 	qsort(m_fdb, m_fdbSize, sizeof(FDB_ENTRY), EntryComparator);
+	buildPortCounts();
 }
 
 /**
@@ -411,3 +584,96 @@ ForwardingDatabase *GetSwitchForwardingDatabase(Node *node)
 	fdb->sort();
 	return fdb;
 }
+
+/**
+ * Generate synthetic MAC address for FDB benchmark
+ */
+static void GenerateBenchmarkMacAddress(int n, BYTE *macAddr)
+{
+   uint32_t x = static_cast<uint32_t>(n) * 2654435761U;  // spread addresses so they are not added in sorted order
+   macAddr[0] = 0x02;
+   macAddr[1] = static_cast<BYTE>(n >> 24);
+   macAddr[2] = static_cast<BYTE>(x >> 24);
+   macAddr[3] = static_cast<BYTE>(x >> 16);
+   macAddr[4] = static_cast<BYTE>(x >> 8);
+   macAddr[5] = static_cast<BYTE>(x);
+}
+
+/**
+ * Benchmark forwarding database construction and lookups on synthetic data. Database
+ * is filled the same way as by GetSwitchForwardingDatabase for switch with 48 VLANs:
+ * each address is reported first by dot1qTpFdbTable and then again by per-VLAN walk
+ * of dot1dTpFdbTable.
+ */
+void BenchmarkForwardingDatabase(CONSOLE_CTX console, int size)
+{
+   static const int portCount = 512;
+   static const int vlanCount = 48;
+
+   ConsolePrintf(console, _T("Running FDB benchmark with %d entries (%d ports, %d VLANs)\n"), size, portCount, vlanCount);
+
+   INT64 startTime = GetCurrentTimeMs();
+   ForwardingDatabase *fdb = new ForwardingDatabase(0);
+   for(int v = 0; v < vlanCount; v++)
+   {
+      for(int p = 1; p <= portCount; p++)
+      {
+         PORT_MAPPING_ENTRY pm;
+         pm.port = p;
+         pm.ifIndex = 1000 + p;
+         fdb->addPortMapping(&pm);
+      }
+   }
+
+   FDB_ENTRY entry;
+   memset(&entry, 0, sizeof(FDB_ENTRY));
+   entry.type = 3;
+   for(int pass = 0; pass < 2; pass++)
+   {
+      for(int i = 0; i < size; i++)
+      {
+         GenerateBenchmarkMacAddress(i, entry.macAddr);
+         // Most addresses are on first few (uplink) ports, last ports have one address each
+         entry.port = (i < size - portCount / 2) ? (i % (portCount / 2)) + 1 : portCount / 2 + (size - i);
+         entry.vlanId = static_cast<uint16_t>(i % vlanCount + 1);
+         fdb->addEntry(&entry);
+      }
+   }
+   INT64 buildTime = GetCurrentTimeMs() - startTime;
+
+   startTime = GetCurrentTimeMs();
+   fdb->sort();
+   INT64 sortTime = GetCurrentTimeMs() - startTime;
+
+   startTime = GetCurrentTimeMs();
+   int found = 0;
+   for(int i = 0; i < size; i++)
+   {
+      GenerateBenchmarkMacAddress(i, entry.macAddr);
+      if (fdb->findMacAddress(entry.macAddr, nullptr) != 0)
+         found++;
+   }
+   INT64 lookupTime = GetCurrentTimeMs() - startTime;
+
+   startTime = GetCurrentTimeMs();
+   int singleMacPorts = 0;
+   int totalCount = 0;
+   for(int n = 0; n < 100; n++)
+   {
+      for(int p = 1; p <= portCount; p++)
+      {
+         if (fdb->isSingleMacOnPort(1000 + p))
+            singleMacPorts++;
+         totalCount += fdb->getMacCountOnPort(1000 + p);
+      }
+   }
+   INT64 portCountTime = GetCurrentTimeMs() - startTime;
+
+   ConsolePrintf(console, _T("   Entries ............. %d\n"), fdb->getSize());
+   ConsolePrintf(console, _T("   Construction ........ ") INT64_FMT _T(" ms\n"), buildTime);
+   ConsolePrintf(console, _T("   Finalization ........ ") INT64_FMT _T(" ms\n"), sortTime);
+   ConsolePrintf(console, _T("   MAC lookups ......... ") INT64_FMT _T(" ms (%d lookups, %d found)\n"), lookupTime, size, found);
+   ConsolePrintf(console, _T("   Port MAC counts ..... ") INT64_FMT _T(" ms (%d queries, %d single MAC ports, %d addresses)\n\n"),
+            portCountTime, portCount * 200, singleMacPorts / 100, totalCount / 100);
+   fdb->decRefCount();
+}
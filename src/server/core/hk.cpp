@@ -244,6 +244,111 @@ static void CleanTimescaleData(DB_HANDLE hdb)
    }
 }
 
+/**
+ * Log table descriptor
+ */
+struct LogTable
+{
+   const TCHAR *name;
+   const TCHAR *timestampColumn;
+   const TCHAR *retentionParameter;
+   const TCHAR *description;
+   bool hypertable;              // Table is TimescaleDB hypertable
+   uint32_t partitionInterval;   // Partition interval in seconds or 0 if table is not partitioned
+};
+
+/**
+ * Log tables with time based retention
+ */
+static LogTable s_logTables[] =
+{
+   { _T("event_log"), _T("event_timestamp"), _T("EventLogRetentionTime"), _T("event log"), true, 0 },
+   { _T("syslog"), _T("msg_timestamp"), _T("SyslogRetentionTime"), _T("syslog"), true, 0 },
+   { _T("audit_log"), _T("timestamp"), _T("AuditLogRetentionTime"), _T("audit log"), false, 0 },
+   { _T("snmp_trap_log"), _T("trap_timestamp"), _T("SNMPTrapLogRetentionTime"), _T("SNMP trap log"), true, 0 },
+   { nullptr, nullptr, nullptr, nullptr, false, 0 }
+};
+
+/**
+ * Read partitioning information for log tables (set by nxdbmgr when table is converted to partitioned one)
+ */
+static void ReadLogTablePartitioning()
+{
+   for(LogTable *t = s_logTables; t->name != nullptr; t++)
+   {
+      TCHAR name[128];
+      _sntprintf(name, 128, _T("LogTablePartitionInterval.%s"), t->name);
+      int interval = MetaDataReadInt32(name, 0);
+      t->partitionInterval = ((interval > 0) && (interval % 86400 == 0)) ? interval : 0;
+      if (t->partitionInterval != 0)
+         nxlog_debug_tag(DEBUG_TAG, 2, _T("Table %s is partitioned by time (partition interval %u seconds)"), t->name, t->partitionInterval);
+   }
+}
+
+/**
+ * Create partitions ahead for partitioned log tables
+ */
+static void CreateLogTablePartitions(DB_HANDLE hdb)
+{
+   for(LogTable *t = s_logTables; t->name != nullptr; t++)
+   {
+      if (t->partitionInterval == 0)
+         continue;
+
+      time_t until = time(nullptr) + std::max(t->partitionInterval * 2, static_cast<uint32_t>(7 * 86400));
+      int count = DBCreateTimePartitions(hdb, t->name, t->timestampColumn, t->partitionInterval, until);
+      if (count > 0)
+         nxlog_debug_tag(DEBUG_TAG, 4, _T("%d new partitions created for table %s"), count, t->name);
+      else if (count < 0)
+         nxlog_write_tag(NXLOG_WARNING, DEBUG_TAG, _T("Cannot create new partitions for table %s"), t->name);
+   }
+}
+
+/**
+ * Remove outdated records from log tables. Partitioned tables are cleaned by dropping expired partitions,
+ * TimescaleDB hypertables by dropping expired chunks. Returns false if housekeeper should be aborted.
+ */
+static bool CleanLogTables(DB_HANDLE hdb, time_t cycleStartTime)
+{
+   CreateLogTablePartitions(hdb);
+
+   for(LogTable *t = s_logTables; t->name != nullptr; t++)
+   {
+      uint32_t retentionTime = ConfigReadULong(t->retentionParameter, 90);
+      if (retentionTime == 0)
+         continue;
+
+      nxlog_debug_tag(DEBUG_TAG, 2, _T("Clearing %s (retention time %u days)"), t->description, retentionTime);
+      time_t cutoffTime = cycleStartTime - static_cast<time_t>(retentionTime) * 86400;
+      if (t->partitionInterval != 0)
+      {
+         int count = DBDropExpiredTimePartitions(hdb, t->name, t->timestampColumn, t->partitionInterval, cutoffTime);
+         if (count >= 0)
+            nxlog_debug_tag(DEBUG_TAG, 4, _T("%d expired partitions dropped for table %s"), count, t->name);
+         else
+            nxlog_write_tag(NXLOG_WARNING, DEBUG_TAG, _T("Cannot drop expired partitions for table %s"), t->name);
+      }
+      else if (t->hypertable && (g_dbSyntax == DB_SYNTAX_TSDB))
+      {
+         TCHAR query[256];
+         _sntprintf(query, 256, _T("SELECT drop_chunks(") INT64_FMT _T(", '%s')"), static_cast<int64_t>(cutoffTime), t->name);
+         nxlog_debug_tag(DEBUG_TAG, 5, _T("Executing query \"%s\""), query);
+         DB_RESULT hResult = DBSelect(hdb, query);
+         if (hResult != nullptr)
+            DBFreeResult(hResult);
+      }
+      else
+      {
+         TCHAR query[256];
+         _sntprintf(query, 256, _T("DELETE FROM %s WHERE %s<") INT64_FMT, t->name, t->timestampColumn, static_cast<int64_t>(cutoffTime));
+         DBQuery(hdb, query);
+      }
+      if (!ThrottleHousekeeper())
+         return false;
+   }
+   return true;
+}
+
 /**
  * Callback for validating template DCIs
  */
@@ -300,6 +405,11 @@ static void HouseKeeper()
    }
    nxlog_debug_tag(DEBUG_TAG, 2, _T("Wakeup time is %02d:%02d"), hour, minute);
 
+   ReadLogTablePartitioning();
+   DB_HANDLE hdbStartup = DBConnectionPoolAcquireConnection();
+   CreateLogTablePartitions(hdbStartup);
+   DBConnectionPoolReleaseConnection(hdbStartup);
+
    int sleepTime = GetSleepTime(hour, minute, 0);
    while(!s_shutdown)
    {
@@ -319,60 +429,12 @@ static void HouseKeeper()
 		DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
 		CleanAlarmHistory(hdb);
 
-		// Remove outdated event log records
-		uint32_t dwRetentionTime = ConfigReadULong(_T("EventLogRetentionTime"), 90);
-		if (dwRetentionTime > 0)
-		{
-	      nxlog_debug_tag(DEBUG_TAG, 2, _T("Clearing event log (retention time %d days)"), dwRetentionTime);
-			dwRetentionTime *= 86400;	// Convert days to seconds
-         TCHAR query[256];
-			_sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("DELETE FROM event_log WHERE event_timestamp<%ld"), (long)(cycleStartTime - dwRetentionTime));
-			DBQuery(hdb, query);
-			if (!ThrottleHousekeeper())
-			   break;
-		}
-
-		// Remove outdated syslog records
-		dwRetentionTime = ConfigReadULong(_T("SyslogRetentionTime"), 90);
-		if (dwRetentionTime > 0)
-		{
-         nxlog_debug_tag(DEBUG_TAG, 2, _T("Clearing syslog (retention time %d days)"), dwRetentionTime);
-			dwRetentionTime *= 86400;	// Convert days to seconds
-         TCHAR query[256];
-			_sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("DELETE FROM syslog WHERE msg_timestamp<%ld"), (long)(cycleStartTime - dwRetentionTime));
-			DBQuery(hdb, query);
-         if (!ThrottleHousekeeper())
-            break;
-		}
-
-		// Remove outdated audit log records
-		dwRetentionTime = ConfigReadULong(_T("AuditLogRetentionTime"), 90);
-		if (dwRetentionTime > 0)
-		{
-         nxlog_debug_tag(DEBUG_TAG, 2, _T("Clearing audit log (retention time %d days)"), dwRetentionTime);
-			dwRetentionTime *= 86400;	// Convert days to seconds
-         TCHAR query[256];
-			_sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("DELETE FROM audit_log WHERE timestamp<%ld"), (long)(cycleStartTime - dwRetentionTime));
-			DBQuery(hdb, query);
-         if (!ThrottleHousekeeper())
-            break;
-		}
-
-		// Remove outdated SNMP trap log records
-		dwRetentionTime = ConfigReadULong(_T("SNMPTrapLogRetentionTime"), 90);
-		if (dwRetentionTime > 0)
-		{
-         nxlog_debug_tag(DEBUG_TAG, 2, _T("Clearing SNMP trap log (retention time %d days)"), dwRetentionTime);
-			dwRetentionTime *= 86400;	// Convert days to seconds
-         TCHAR query[256];
-			_sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("DELETE FROM snmp_trap_log WHERE trap_timestamp<%ld"), (long)(cycleStartTime - dwRetentionTime));
-			DBQuery(hdb, query);
-         if (!ThrottleHousekeeper())
-            break;
-		}
+		// Remove outdated log records
+		if (!CleanLogTables(hdb, cycleStartTime))
+		   break;
 
       // Delete old user agent messages
-      dwRetentionTime = ConfigReadULong(_T("UserAgent.RetentionTime"), 30);
+      uint32_t dwRetentionTime = ConfigReadULong(_T("UserAgent.RetentionTime"), 30);
       if (dwRetentionTime > 0)
       {
          nxlog_debug_tag(DEBUG_TAG, 2, _T("Clearing user agent messages log (retention time %d days)"), dwRetentionTime);
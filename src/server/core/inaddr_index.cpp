@@ -37,10 +37,11 @@ struct InetAddressIndexEntry
 /**
  * Constructor
  */
-InetAddressIndex::InetAddressIndex()
+InetAddressIndex::InetAddressIndex(bool prefixTree)
 {
    m_root = nullptr;
    m_lock = RWLockCreate();
+   m_prefixTree = prefixTree ? new InetAddressPrefixTree() : nullptr;
 }
 
 /**
@@ -55,6 +56,7 @@ InetAddressIndex::~InetAddressIndex()
       entry->object.~shared_ptr();
       MemFree(entry);
    }
+   delete m_prefixTree;
    RWLockDestroy(m_lock);
 }
 
@@ -71,6 +73,7 @@ bool InetAddressIndex::put(const InetAddress& addr, const shared_ptr<NetObj>& ob
       return false;
 
    bool replace = true;
+   bool changed = true;
 
    BYTE key[18];
    addr.buildHashKey(key);
@@ -88,9 +91,26 @@ bool InetAddressIndex::put(const InetAddress& addr, const shared_ptr<NetObj>& ob
       HASH_ADD_KEYPTR(hh, m_root, entry->key, sizeof(key), entry);
       replace = false;
    }
+   else if ((m_prefixTree != nullptr) && (entry->addr.getMaskBits() != addr.getMaskBits()))
+   {
+      // Mask was changed, re-insert into prefix tree under new prefix
+      if (m_prefixTree->get(entry->addr) == entry)
+         m_prefixTree->remove(entry->addr);
+      entry->addr = addr;
+   }
+   else if (entry->object == object)
+   {
+      changed = false;
+   }
    entry->object = object;
+   if (m_prefixTree != nullptr)
+      m_prefixTree->put(entry->addr, entry);
 
    RWLockUnlock(m_lock);
+
+   // Address to object mapping change can affect cached syslog and trap source bindings
+   if (changed)
+      InvalidateSourceBindingCaches();
    return replace;
 }
 
@@ -129,11 +149,16 @@ void InetAddressIndex::remove(const InetAddress& addr)
    HASH_FIND(hh, m_root, key, sizeof(key), entry);
    if (entry != NULL)
    {
+      if ((m_prefixTree != nullptr) && (m_prefixTree->get(entry->addr) == entry))
+         m_prefixTree->remove(entry->addr);
       HASH_DEL(m_root, entry);
       entry->object.~shared_ptr();
       MemFree(entry);
    }
    RWLockUnlock(m_lock);
+
+   if (entry != nullptr)
+      InvalidateSourceBindingCaches();
 }
 
 /**
@@ -161,6 +186,26 @@ shared_ptr<NetObj> InetAddressIndex::get(const InetAddress& addr) const
    return object;
 }
 
+/**
+ * Find object with longest prefix containing given IP address (only for indexes with prefix tree)
+ */
+shared_ptr<NetObj> InetAddressIndex::findLongestPrefixMatch(const InetAddress& addr) const
+{
+   shared_ptr<NetObj> object;
+
+   if ((m_prefixTree == nullptr) || !addr.isValid())
+      return object;
+
+   RWLockReadLock(m_lock);
+   InetAddressIndexEntry *entry = static_cast<InetAddressIndexEntry*>(m_prefixTree->findLongestMatch(addr));
+   if (entry != nullptr)
+   {
+      object = entry->object;
+   }
+   RWLockUnlock(m_lock);
+   return object;
+}
+
 /**
  * Find object using comparator
  */
@@ -29,6 +29,7 @@
 Interface::Interface() : super(), m_macAddr(MacAddress::ZERO)
 {
    m_parentInterfaceId = 0;
+   m_loadedNodeId = 0;
    _tcslcpy(m_description, m_name, MAX_DB_STRING);
    m_alias[0] = 0;
    m_index = 0;
@@ -62,6 +63,7 @@ Interface::Interface() : super(), m_macAddr(MacAddress::ZERO)
 Interface::Interface(const InetAddressList& addrList, int32_t zoneUIN, bool bSyntheticMask) : super(), m_macAddr(MacAddress::ZERO)
 {
    m_parentInterfaceId = 0;
+   m_loadedNodeId = 0;
 	m_flags = bSyntheticMask ? IF_SYNTHETIC_MASK : 0;
    if (addrList.isLoopbackOnly())
 		m_flags |= IF_LOOPBACK;
@@ -109,6 +111,7 @@ Interface::Interface(const TCHAR *name, const TCHAR *descr, UINT32 index, const
       m_flags = 0;
 
    m_parentInterfaceId = 0;
+   m_loadedNodeId = 0;
    _tcslcpy(m_name, name, MAX_OBJECT_NAME);
    _tcslcpy(m_description, descr, MAX_DB_STRING);
    m_alias[0] = 0;
@@ -183,7 +186,7 @@ bool Interface::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
    {
       m_type = DBGetFieldULong(hResult, 0, 0);
       m_index = DBGetFieldULong(hResult, 0, 1);
-      UINT32 nodeId = DBGetFieldULong(hResult, 0, 2);
+      m_loadedNodeId = DBGetFieldULong(hResult, 0, 2);
       m_macAddr = DBGetFieldMacAddr(hResult, 0, 3);
       m_requiredPollCount = DBGetFieldLong(hResult, 0, 4);
 		m_bridgePortNumber = DBGetFieldULong(hResult, 0, 5);
@@ -219,26 +222,7 @@ bool Interface::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
          }
       }
 
-      // Link interface to node
-      if (!m_isDeleted)
-      {
-         shared_ptr<NetObj> object = FindObjectById(nodeId, OBJECT_NODE);
-         if (object != nullptr)
-         {
-            object->addChild(self());
-            addParent(object);
-            m_zoneUIN = static_cast<Node*>(object.get())->getZoneUIN();
-            success = true;
-         }
-         else
-         {
-            nxlog_write(NXLOG_ERROR, _T("Inconsistent database: interface %s [%u] linked to non-existent node [%u]"), m_name, m_id, nodeId);
-         }
-      }
-      else
-      {
-         success = true;
-      }
+      success = true;
    }
 
    DBFreeResult(hResult);
@@ -313,6 +297,27 @@ bool Interface::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
    return success;
 }
 
+/**
+ * Link interface to node after loading from database. Called on main thread by startup object loader.
+ */
+bool Interface::linkAfterLoad()
+{
+   if (m_isDeleted)
+      return true;
+
+   shared_ptr<NetObj> node = FindObjectById(m_loadedNodeId, OBJECT_NODE);
+   if (node == nullptr)
+   {
+      nxlog_write(NXLOG_ERROR, _T("Inconsistent database: interface %s [%u] linked to non-existent node [%u]"), m_name, m_id, m_loadedNodeId);
+      return false;
+   }
+
+   node->addChild(self());
+   addParent(node);
+   m_zoneUIN = static_cast<Node&>(*node).getZoneUIN();
+   return true;
+}
+
 /**
  * Save interface object to database
  */
@@ -789,18 +794,22 @@ void Interface::icmpStatusPoll(UINT32 rqId, UINT32 nodeIcmpProxy, Cluster *clust
 	else	// not using ICMP proxy
 	{
 		sendPollerMsg(rqId, _T("      Starting ICMP ping\r\n"));
+      // Ping all addresses at once, interface is considered up if any of them responds
       const ObjectArray<InetAddress> *list = m_ipAddressList.getList();
-      UINT32 dwPingStatus = ICMP_TIMEOUT;
-      for(int i = 0; (i < list->size()) && (dwPingStatus != ICMP_SUCCESS); i++)
+      IcmpPingTarget *targets = new IcmpPingTarget[list->size()];
+      int count = 0;
+      for(int i = 0; i < list->size(); i++)
       {
          const InetAddress *a = list->get(i);
          if (a->isValidUnicast() && ((cluster == nullptr) || !cluster->isSyncAddr(*a)))
          {
 		      DbgPrintf(7, _T("Interface::StatusPoll(%d,%s): calling IcmpPing(%s,3,%d,%d)"),
                m_id, m_name, (const TCHAR *)a->toString(), g_icmpPingTimeout, g_icmpPingSize);
-		      dwPingStatus = IcmpPing(*a, 3, g_icmpPingTimeout, nullptr, g_icmpPingSize, false);
+		      targets[count++].addr = *a;
          }
       }
+      UINT32 dwPingStatus = (IcmpPingMultiple(targets, count, 3, g_icmpPingTimeout, g_icmpPingSize, false) > 0) ? ICMP_SUCCESS : ICMP_TIMEOUT;
+      delete[] targets;
 		if (dwPingStatus == ICMP_SUCCESS)
 		{
 			*adminState = IF_ADMIN_STATE_UP;
@@ -984,6 +993,18 @@ void Interface::setExpectedStateInternal(int state)
 	}
 }
 
+/**
+ * Set interface description
+ */
+void Interface::setDescription(const TCHAR *descr)
+{
+   lockProperties();
+   _tcslcpy(m_description, descr, MAX_DB_STRING);
+   setModified(MODIFY_INTERFACE_PROPERTIES);
+   unlockProperties();
+   g_idxInterfaceByDescription.update(m_id, descr);
+}
+
 /**
  * Set "exclude from topology" flag
  */
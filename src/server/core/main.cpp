@@ -172,6 +172,7 @@ static THREAD s_mobileDeviceListenerThread = INVALID_THREAD_HANDLE;
 static THREAD s_tunnelListenerThread = INVALID_THREAD_HANDLE;
 static THREAD s_eventProcessorThread = INVALID_THREAD_HANDLE;
 static THREAD s_statCollectorThread = INVALID_THREAD_HANDLE;
+static THREAD s_snmpTrapReceiverThread = INVALID_THREAD_HANDLE;
 static ShutdownReason s_shutdownReason = ShutdownReason::OTHER;
 static StringSet s_components;
 
@@ -1059,6 +1060,7 @@ BOOL NXCORE_EXPORTABLE Initialize()
    ThreadCreate(JobManagerThread, 0, NULL);
    s_syncerThread = ThreadCreateEx(Syncer, 0, NULL);
 
+   InitIcmpPinger();
    CONDITION pollManagerInitialized = ConditionCreate(true);
    s_pollManagerThread = ThreadCreateEx(PollManager, 0, pollManagerInitialized);
 
@@ -1070,7 +1072,7 @@ BOOL NXCORE_EXPORTABLE Initialize()
    // Start SNMP trapper
    InitTraps();
    if (ConfigReadBoolean(_T("EnableSNMPTraps"), true))
-      ThreadCreate(SNMPTrapReceiver);
+      s_snmpTrapReceiverThread = ThreadCreateEx(SNMPTrapReceiver);
 
    // Start built-in syslog daemon
    StartSyslogServer();
@@ -1203,6 +1205,9 @@ void NXCORE_EXPORTABLE Shutdown()
 
    CloseAgentTunnels();
    StopSyslogServer();
+   ThreadJoin(s_snmpTrapReceiverThread);  // trap receiver should be stopped before trap log writer
+   ShutdownTraps();
+   ShutdownIcmpPinger();
 
    nxlog_debug(2, _T("Waiting for event processor to stop"));
 	g_eventQueue.put(INVALID_POINTER_VALUE);
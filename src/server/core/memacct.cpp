@@ -0,0 +1,278 @@
+/*
+** NetXMS - Network Management System
+** Copyright (C) 2003-2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: memacct.cpp
+**
+**/
+
+#include "nxcore.h"
+
+/**
+ * Number of tracked object classes (classes outside this range are counted as generic)
+ */
+#define OBJECT_CLASS_COUNT (OBJECT_SENSOR + 1)
+
+#ifdef WITH_MEMORY_ACCOUNTING
+
+/**
+ * Tag names
+ */
+static const TCHAR *s_tagNames[MEMORY_ACCOUNTING_TAG_COUNT] =
+{
+   _T("Objects"),
+   _T("NXCP messages"),
+   _T("Events"),
+   _T("Script VMs"),
+   _T("DB writer queues")
+};
+
+/**
+ * Counters
+ */
+MemoryAccountingCounters g_memoryAccountingCounters[MEMORY_ACCOUNTING_TAG_COUNT];
+
+/**
+ * Per-class object counters
+ */
+static MemoryAccountingCounters s_objectCounters[OBJECT_CLASS_COUNT];
+
+/**
+ * Lock for platforms without 64 bit atomic add
+ */
+static Mutex s_counterLock(true);
+
+/**
+ * Update counter under lock
+ */
+void MemoryAccountingUpdateLocked(VolatileCounter64 *counter, int64_t delta)
+{
+   s_counterLock.lock();
+   *counter += delta;
+   s_counterLock.unlock();
+}
+
+/**
+ * Get size of object of given class (not including dynamically allocated members)
+ */
+static size_t GetObjectSize(int objectClass)
+{
+   switch(objectClass)
+   {
+      case OBJECT_ACCESSPOINT:
+         return sizeof(AccessPoint);
+      case OBJECT_BUSINESSSERVICE:
+         return sizeof(BusinessService);
+      case OBJECT_BUSINESSSERVICEROOT:
+         return sizeof(BusinessServiceRoot);
+      case OBJECT_CHASSIS:
+         return sizeof(Chassis);
+      case OBJECT_CLUSTER:
+         return sizeof(Cluster);
+      case OBJECT_CONDITION:
+         return sizeof(ConditionObject);
+      case OBJECT_CONTAINER:
+         return sizeof(Container);
+      case OBJECT_DASHBOARD:
+         return sizeof(Dashboard);
+      case OBJECT_DASHBOARDGROUP:
+         return sizeof(DashboardGroup);
+      case OBJECT_DASHBOARDROOT:
+         return sizeof(DashboardRoot);
+      case OBJECT_INTERFACE:
+         return sizeof(Interface);
+      case OBJECT_MOBILEDEVICE:
+         return sizeof(MobileDevice);
+      case OBJECT_NETWORK:
+         return sizeof(Network);
+      case OBJECT_NETWORKMAP:
+         return sizeof(NetworkMap);
+      case OBJECT_NETWORKMAPGROUP:
+         return sizeof(NetworkMapGroup);
+      case OBJECT_NETWORKMAPROOT:
+         return sizeof(NetworkMapRoot);
+      case OBJECT_NETWORKSERVICE:
+         return sizeof(NetworkService);
+      case OBJECT_NODE:
+         return sizeof(Node);
+      case OBJECT_NODELINK:
+         return sizeof(NodeLink);
+      case OBJECT_RACK:
+         return sizeof(Rack);
+      case OBJECT_SENSOR:
+         return sizeof(Sensor);
+      case OBJECT_SERVICEROOT:
+         return sizeof(ServiceRoot);
+      case OBJECT_SLMCHECK:
+         return sizeof(SlmCheck);
+      case OBJECT_SUBNET:
+         return sizeof(Subnet);
+      case OBJECT_TEMPLATE:
+         return sizeof(Template);
+      case OBJECT_TEMPLATEGROUP:
+         return sizeof(TemplateGroup);
+      case OBJECT_TEMPLATEROOT:
+         return sizeof(TemplateRoot);
+      case OBJECT_VPNCONNECTOR:
+         return sizeof(VPNConnector);
+      case OBJECT_ZONE:
+         return sizeof(Zone);
+      default:
+         return sizeof(NetObj);
+   }
+}
+
+/**
+ * Approximate size of string map entry (hash handle, key and value pointers)
+ */
+#define STRING_MAP_ENTRY_SIZE 64
+
+/**
+ * Add estimated size of custom attribute
+ */
+static EnumerationCallbackResult AddCustomAttributeSize(const TCHAR *name, const CustomAttribute *attr, size_t *size)
+{
+   *size += STRING_MAP_ENTRY_SIZE + sizeof(CustomAttribute) + (_tcslen(name) + _tcslen(attr->value.cstr()) + 2) * sizeof(TCHAR);
+   return _CONTINUE;
+}
+
+/**
+ * Estimate memory used by object - object itself, parent and child lists and custom attributes
+ */
+static size_t EstimateObjectSize(NetObj *object)
+{
+   size_t size = GetObjectSize(object->getObjectClass());
+   size += 2 * sizeof(SharedObjectArray<NObject>) + (object->getParentCount() + object->getChildCount()) * (sizeof(shared_ptr<NObject>) + sizeof(void*));
+   size += sizeof(StringObjectMap<CustomAttribute>);
+   object->forEachCustomAttribute(AddCustomAttributeSize, &size);
+   return size;
+}
+
+/**
+ * Get counters for object's class
+ */
+static inline MemoryAccountingCounters *GetObjectCounters(NetObj *object)
+{
+   int objectClass = object->getObjectClass();
+   return &s_objectCounters[((objectClass >= 0) && (objectClass < OBJECT_CLASS_COUNT)) ? objectClass : OBJECT_GENERIC];
+}
+
+/**
+ * Register object
+ */
+void MemoryAccountingAddObject(NetObj *object)
+{
+   size_t size = EstimateObjectSize(object);
+   object->exchangeAccountedMemorySize(size);
+   MemoryAccountingCounters *c = GetObjectCounters(object);
+   MemoryAccountingUpdate(&c->count, 1);
+   MemoryAccountingUpdate(&c->bytes, static_cast<int64_t>(size));
+   MemoryAccountingAdd(MemoryAccountingTag::OBJECTS, size);
+}
+
+/**
+ * Update estimated size of registered object (after parent/child list or custom attribute changes).
+ * Registered size is exchanged under object lock, so concurrent updates apply deltas against the value
+ * they actually replaced and counters stay consistent.
+ */
+void MemoryAccountingUpdateObject(NetObj *object)
+{
+   size_t size = EstimateObjectSize(object);
+   int64_t delta = static_cast<int64_t>(size) - static_cast<int64_t>(object->exchangeAccountedMemorySize(size));
+   if (delta == 0)
+      return;
+   MemoryAccountingUpdate(&GetObjectCounters(object)->bytes, delta);
+   MemoryAccountingUpdate(&g_memoryAccountingCounters[static_cast<int>(MemoryAccountingTag::OBJECTS)].bytes, delta);
+}
+
+/**
+ * Unregister object. Removes size registered for object by last add or update call.
+ */
+void MemoryAccountingRemoveObject(NetObj *object)
+{
+   size_t size = object->exchangeAccountedMemorySize(0);
+   MemoryAccountingCounters *c = GetObjectCounters(object);
+   MemoryAccountingUpdate(&c->count, -1);
+   MemoryAccountingUpdate(&c->bytes, -static_cast<int64_t>(size));
+   MemoryAccountingRemove(MemoryAccountingTag::OBJECTS, size);
+}
+
+#endif /* WITH_MEMORY_ACCOUNTING */
+
+/**
+ * Get counters for given tag. Returns false if memory accounting is not enabled.
+ */
+bool GetMemoryAccountingCounters(MemoryAccountingTag tag, uint64_t *count, uint64_t *bytes)
+{
+#ifdef WITH_MEMORY_ACCOUNTING
+   const MemoryAccountingCounters *c = &g_memoryAccountingCounters[static_cast<int>(tag)];
+   *count = static_cast<uint64_t>(c->count);
+   *bytes = static_cast<uint64_t>(c->bytes);
+   return true;
+#else
+   return false;
+#endif
+}
+
+/**
+ * Get counters for objects of given class. Returns false if memory accounting
+ * is not enabled or class name is unknown.
+ */
+bool GetObjectMemoryAccountingCounters(const TCHAR *className, uint64_t *count, uint64_t *bytes)
+{
+#ifdef WITH_MEMORY_ACCOUNTING
+   for(int i = 0; i < OBJECT_CLASS_COUNT; i++)
+   {
+      if (!_tcsicmp(className, NetObj::getObjectClassName(i)))
+      {
+         *count = static_cast<uint64_t>(s_objectCounters[i].count);
+         *bytes = static_cast<uint64_t>(s_objectCounters[i].bytes);
+         return true;
+      }
+   }
+#endif
+   return false;
+}
+
+/**
+ * Show memory accounting counters on server console
+ */
+void ShowMemoryAccountingCounters(ServerConsole *console)
+{
+#ifdef WITH_MEMORY_ACCOUNTING
+   console->print(_T("\x1b[1mTag\x1b[0m                  | \x1b[1mCount\x1b[0m      | \x1b[1mMemory (MB)\x1b[0m\n"));
+   console->print(_T("---------------------+------------+------------\n"));
+   for(int i = 0; i < MEMORY_ACCOUNTING_TAG_COUNT; i++)
+   {
+      console->printf(_T("%-20s | %10u | %10.02f\n"), s_tagNames[i],
+               static_cast<uint32_t>(g_memoryAccountingCounters[i].count), static_cast<double>(g_memoryAccountingCounters[i].bytes) / 1048576);
+   }
+
+   console->print(_T("\n\x1b[1mObject class\x1b[0m         | \x1b[1mCount\x1b[0m      | \x1b[1mMemory (MB)\x1b[0m\n"));
+   console->print(_T("---------------------+------------+------------\n"));
+   for(int i = 0; i < OBJECT_CLASS_COUNT; i++)
+   {
+      if (s_objectCounters[i].count == 0)
+         continue;
+      console->printf(_T("%-20s | %10u | %10.02f\n"), NetObj::getObjectClassName(i),
+               static_cast<uint32_t>(s_objectCounters[i].count), static_cast<double>(s_objectCounters[i].bytes) / 1048576);
+   }
+   console->print(_T("\n"));
+#else
+   console->print(_T("Memory accounting is not enabled in this build\n\n"));
+#endif
+}
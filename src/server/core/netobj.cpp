@@ -56,6 +56,216 @@ static const char *s_classNameA[]=
       "Sensor"
    };
 
+/**
+ * Number of object_properties columns written by saveCommonProperties
+ */
+#define OBJECT_PROPERTIES_COLUMN_COUNT 32
+
+/**
+ * Columns of object_properties table written by saveCommonProperties
+ */
+static const TCHAR *s_objectPropertiesColumns[] = {
+   _T("name"), _T("status"), _T("is_deleted"), _T("inherit_access_rights"), _T("last_modified"), _T("status_calc_alg"),
+   _T("status_prop_alg"), _T("status_fixed_val"), _T("status_shift"), _T("status_translation"), _T("status_single_threshold"),
+   _T("status_thresholds"), _T("comments"), _T("is_system"), _T("location_type"), _T("latitude"), _T("longitude"),
+   _T("location_accuracy"), _T("location_timestamp"), _T("guid"), _T("image"), _T("submap_id"), _T("country"), _T("city"),
+   _T("street_address"), _T("postcode"), _T("maint_event_id"), _T("state_before_maint"), _T("state"), _T("flags"),
+   _T("creation_time"), _T("maint_initiator"), nullptr
+};
+
+/**
+ * Saved state slots. First OBJECT_PROPERTIES_COLUMN_COUNT slots correspond to object_properties columns.
+ */
+#define SAVED_STATE_STATUS             1
+#define SAVED_STATE_DASHBOARDS         (OBJECT_PROPERTIES_COLUMN_COUNT)
+#define SAVED_STATE_URLS               (OBJECT_PROPERTIES_COLUMN_COUNT + 1)
+#define SAVED_STATE_TRUSTED_NODES      (OBJECT_PROPERTIES_COLUMN_COUNT + 2)
+#define SAVED_STATE_RESPONSIBLE_USERS  (OBJECT_PROPERTIES_COLUMN_COUNT + 3)
+#define SAVED_STATE_SLOT_COUNT         (OBJECT_PROPERTIES_COLUMN_COUNT + 4)
+
+/**
+ * Size of text buffer for getCommonPropertyValues (6 formatted values, 64 characters each)
+ */
+#define PROPERTY_VALUES_BUFFER_SIZE    384
+
+/**
+ * Value of object_properties column or child row list as last written to database.
+ * Values are compared byte by byte, values up to 8 bytes are kept inline.
+ */
+class SavedValue
+{
+private:
+   size_t m_size;
+   union
+   {
+      BYTE m_inline[8];
+      BYTE *m_data;
+   };
+
+   bool isInline() const { return m_size <= sizeof(m_inline); }
+   const BYTE *data() const { return isInline() ? m_inline : m_data; }
+
+public:
+   SavedValue()
+   {
+      m_size = 0;
+   }
+
+   ~SavedValue()
+   {
+      if (!isInline())
+         MemFree(m_data);
+   }
+
+   bool equals(const void *value, size_t size) const
+   {
+      return (size == m_size) && ((size == 0) || !memcmp(data(), value, size));
+   }
+
+   void set(const void *value, size_t size)
+   {
+      if (!isInline())
+         MemFree(m_data);
+      m_size = size;
+      if (!isInline())
+         m_data = static_cast<BYTE*>(MemCopyBlock(value, size));
+      else if (size > 0)
+         memcpy(m_inline, value, size);
+   }
+
+   void swap(SavedValue& other)
+   {
+      SavedValue tmp;
+      memcpy(&tmp, this, sizeof(SavedValue));
+      memcpy(this, &other, sizeof(SavedValue));
+      memcpy(&other, &tmp, sizeof(SavedValue));
+      tmp.m_size = 0;
+   }
+};
+
+/**
+ * Custom attribute as last written to database
+ */
+struct SavedAttribute
+{
+   SharedString value;
+   uint32_t flags;
+
+   SavedAttribute(const SharedString& _value, uint32_t _flags) : value(_value)
+   {
+      flags = _flags;
+   }
+
+   bool equals(const SharedString& _value, uint32_t _flags) const
+   {
+      return (flags == _flags) && !_tcscmp(CHECK_NULL_EX(value.cstr()), CHECK_NULL_EX(_value.cstr()));
+   }
+};
+
+/**
+ * State of common object properties as last written to database. Values written by last save
+ * are kept, so next save can skip unchanged columns and child rows. Changes made by current
+ * save are collected in pending state and applied only after transaction commit.
+ */
+class ObjectSaveState
+{
+public:
+   SavedValue values[SAVED_STATE_SLOT_COUNT];
+   uint64_t validSlots;
+   StringObjectMap<SavedAttribute> *attributes; // Custom attributes
+   StructArray<ACL_ELEMENT> *accessList;
+   ObjectSaveState *pending;
+
+   ObjectSaveState()
+   {
+      validSlots = 0;
+      attributes = nullptr;
+      accessList = nullptr;
+      pending = nullptr;
+   }
+
+   ~ObjectSaveState()
+   {
+      delete attributes;
+      delete accessList;
+      delete pending;
+   }
+
+   bool isValid(int slot) const
+   {
+      return (validSlots & (_ULL(1) << slot)) != 0;
+   }
+
+   bool isChanged(int slot, const void *value, size_t size) const
+   {
+      return !isValid(slot) || !values[slot].equals(value, size);
+   }
+
+   void set(int slot, const void *value, size_t size)
+   {
+      values[slot].set(value, size);
+      validSlots |= _ULL(1) << slot;
+   }
+
+   void invalidate(int slot)
+   {
+      validSlots &= ~(_ULL(1) << slot);
+      if (pending != nullptr)
+         pending->validSlots &= ~(_ULL(1) << slot);
+   }
+
+   ObjectSaveState *getPending()
+   {
+      if (pending == nullptr)
+         pending = new ObjectSaveState();
+      return pending;
+   }
+
+   void setAttributes(StringObjectMap<SavedAttribute> *a)
+   {
+      delete attributes;
+      attributes = a;
+   }
+
+   void setAccessList(StructArray<ACL_ELEMENT> *a)
+   {
+      delete accessList;
+      accessList = a;
+   }
+
+   void discardPending()
+   {
+      delete pending;
+      pending = nullptr;
+   }
+
+   void commit()
+   {
+      if (pending == nullptr)
+         return;
+
+      for(int i = 0; i < SAVED_STATE_SLOT_COUNT; i++)
+      {
+         if (pending->isValid(i))
+         {
+            values[i].swap(pending->values[i]);
+            validSlots |= _ULL(1) << i;
+         }
+      }
+      if (pending->attributes != nullptr)
+      {
+         setAttributes(pending->attributes);
+         pending->attributes = nullptr;
+      }
+      if (pending->accessList != nullptr)
+      {
+         setAccessList(pending->accessList);
+         pending->accessList = nullptr;
+      }
+      discardPending();
+   }
+};
+
 /**
  * Default constructor
  */
@@ -67,6 +277,11 @@ NetObj::NetObj() : NObject()
    m_savedStatus = STATUS_UNKNOWN;
    m_comments = nullptr;
    m_modified = 0;
+   m_syncQueued = 0;
+   m_saveState = nullptr;
+#ifdef WITH_MEMORY_ACCOUNTING
+   m_accountedMemorySize = 0;
+#endif
    m_isDeleted = false;
    m_isDeleteInitiated = false;
    m_isHidden = false;
@@ -120,6 +335,7 @@ NetObj::~NetObj()
    delete m_urls;
    delete m_responsibleUsers;
    RWLockDestroy(m_rwlockResponsibleUsers);
+   delete m_saveState;
 }
 
 /**
@@ -214,7 +430,13 @@ bool NetObj::saveRuntimeData(DB_HANDLE hdb)
       DBFreeStatement(hStmt);
 
       if (success)
+      {
          m_savedStatus = m_status;
+         lockProperties();
+         if (m_saveState != nullptr)
+            m_saveState->invalidate(SAVED_STATE_STATUS);
+         unlockProperties();
+      }
    }
    else
    {
@@ -292,6 +514,340 @@ bool NetObj::deleteFromDatabase(DB_HANDLE hdb)
    return success;
 }
 
+/**
+ * Object child tables which can be prefetched at startup
+ */
+enum ObjectChildTable
+{
+   OCT_OBJECT_PROPERTIES = 0,
+   OCT_CUSTOM_ATTRIBUTES = 1,
+   OCT_DASHBOARD_ASSOCIATIONS = 2,
+   OCT_URLS = 3,
+   OCT_TRUSTED_NODES = 4,
+   OCT_RESPONSIBLE_USERS = 5,
+   OCT_ACL = 6
+};
+
+/**
+ * Object child table definitions (in same order as ObjectChildTable enum)
+ */
+static const struct
+{
+   const TCHAR *table;
+   const TCHAR *idColumn;
+   const TCHAR *columns;
+} s_objectChildTables[] =
+{
+   { _T("object_properties"), _T("object_id"),
+     _T("name,status,is_deleted,inherit_access_rights,last_modified,status_calc_alg,")
+     _T("status_prop_alg,status_fixed_val,status_shift,status_translation,status_single_threshold,")
+     _T("status_thresholds,comments,is_system,location_type,latitude,longitude,location_accuracy,")
+     _T("location_timestamp,guid,image,submap_id,country,city,street_address,postcode,maint_event_id,")
+     _T("state_before_maint,maint_initiator,state,flags,creation_time") },
+   { _T("object_custom_attributes"), _T("object_id"), _T("attr_name,attr_value,flags") },
+   { _T("dashboard_associations"), _T("object_id"), _T("dashboard_id") },
+   { _T("object_urls"), _T("object_id"), _T("url_id,url,description") },
+   { _T("trusted_nodes"), _T("source_object_id"), _T("target_node_id") },
+   { _T("responsible_users"), _T("object_id"), _T("user_id") },
+   { _T("acl"), _T("object_id"), _T("user_id,access_rights") }
+};
+
+#define OBJECT_CHILD_TABLE_COUNT (sizeof(s_objectChildTables) / sizeof(s_objectChildTables[0]))
+
+/**
+ * Copy of object child table rows. Field values are copied from result set on construction and
+ * are not modified afterwards, so they can be safely read by several loader threads at once
+ * (database drivers may use shared cursor for reading fields from result set).
+ */
+class ObjectChildTableData
+{
+private:
+   TCHAR **m_fields;
+   int m_rows;
+   int m_columns;
+
+public:
+   ObjectChildTableData(DB_RESULT hResult, int columns)
+   {
+      m_rows = DBGetNumRows(hResult);
+      m_columns = columns;
+      m_fields = MemAllocArray<TCHAR*>(m_rows * m_columns);
+      for(int i = 0; i < m_rows; i++)
+         for(int j = 0; j < m_columns; j++)
+            m_fields[i * m_columns + j] = DBGetField(hResult, i, j, nullptr, 0);
+   }
+
+   ~ObjectChildTableData()
+   {
+      for(int i = 0; i < m_rows * m_columns; i++)
+         MemFree(m_fields[i]);
+      MemFree(m_fields);
+   }
+
+   int getNumRows() const { return m_rows; }
+   const TCHAR *getField(int row, int column) const { return m_fields[row * m_columns + column]; }
+};
+
+/**
+ * Object child table prefetched with single query. Rows are ordered by object ID,
+ * so rows for each object form contiguous block within result set.
+ */
+class PrefetchedObjectTable
+{
+private:
+   ObjectChildTableData *m_data;
+   uint32_t *m_objects;
+   int *m_firstRow;
+   int m_count;
+
+public:
+   PrefetchedObjectTable(ObjectChildTableData *data, uint32_t *objects, int *firstRow, int count)
+   {
+      m_data = data;
+      m_objects = objects;
+      m_firstRow = firstRow;
+      m_count = count;
+   }
+
+   ~PrefetchedObjectTable()
+   {
+      delete m_data;
+      MemFree(m_objects);
+      MemFree(m_firstRow);
+   }
+
+   const ObjectChildTableData *getData() const { return m_data; }
+
+   /**
+    * Get block of rows for given object (binary search on object ID)
+    */
+   bool getRows(uint32_t objectId, int *first, int *count) const
+   {
+      int l = 0, r = m_count - 1;
+      while(l <= r)
+      {
+         int m = (l + r) / 2;
+         if (m_objects[m] == objectId)
+         {
+            *first = m_firstRow[m];
+            *count = m_firstRow[m + 1] - m_firstRow[m];
+            return true;
+         }
+         if (m_objects[m] < objectId)
+            l = m + 1;
+         else
+            r = m - 1;
+      }
+      return false;
+   }
+
+   static PrefetchedObjectTable *create(DB_HANDLE hdb, const TCHAR *table, const TCHAR *idColumn, const TCHAR *columns);
+};
+
+/**
+ * Read entire child table and build object ID index. Returns nullptr if table cannot be read.
+ */
+PrefetchedObjectTable *PrefetchedObjectTable::create(DB_HANDLE hdb, const TCHAR *table, const TCHAR *idColumn, const TCHAR *columns)
+{
+   // Object ID is selected as last column so that column numbers are the same as in per-object queries
+   StringBuffer query(_T("SELECT "));
+   query.append(columns);
+   query.append(_T(","));
+   query.append(idColumn);
+   query.append(_T(" FROM "));
+   query.append(table);
+   query.append(_T(" ORDER BY "));
+   query.append(idColumn);
+
+   DB_RESULT hResult = DBSelect(hdb, query);
+   if (hResult == nullptr)
+      return nullptr;
+
+   int rows = DBGetNumRows(hResult);
+   int idColumnIndex = DBGetColumnCount(hResult) - 1;
+   uint32_t *objects = MemAllocArrayNoInit<uint32_t>(rows + 1);
+   int *firstRow = MemAllocArrayNoInit<int>(rows + 1);
+   int count = 0;
+   for(int i = 0; i < rows; i++)
+   {
+      uint32_t id = DBGetFieldULong(hResult, i, idColumnIndex);
+      if ((count > 0) && (id == objects[count - 1]))
+         continue;
+      if ((count > 0) && (id < objects[count - 1]))
+      {
+         // Unexpected ordering, fall back to per-object queries
+         nxlog_debug(3, _T("PrefetchedObjectTable::create(%s): result set is not ordered by object ID"), table);
+         DBFreeResult(hResult);
+         MemFree(objects);
+         MemFree(firstRow);
+         return nullptr;
+      }
+      objects[count] = id;
+      firstRow[count] = i;
+      count++;
+   }
+   firstRow[count] = rows;
+
+   ObjectChildTableData *data = new ObjectChildTableData(hResult, idColumnIndex);
+   DBFreeResult(hResult);
+   return new PrefetchedObjectTable(data, objects, firstRow, count);
+}
+
+/**
+ * Prefetched child tables
+ */
+static PrefetchedObjectTable *s_prefetchedTables[OBJECT_CHILD_TABLE_COUNT];
+
+/**
+ * Prefetch object child tables with one query per table. Should be called before object loading
+ * starts, and prefetched data should be released with ReleasePrefetchedObjectTables() after all
+ * objects are loaded.
+ */
+void PrefetchObjectTables(DB_HANDLE hdb)
+{
+   for(size_t i = 0; i < OBJECT_CHILD_TABLE_COUNT; i++)
+   {
+      s_prefetchedTables[i] = PrefetchedObjectTable::create(hdb, s_objectChildTables[i].table, s_objectChildTables[i].idColumn, s_objectChildTables[i].columns);
+      if (s_prefetchedTables[i] != nullptr)
+         nxlog_debug(5, _T("PrefetchObjectTables: %d rows read from table %s"), s_prefetchedTables[i]->getData()->getNumRows(), s_objectChildTables[i].table);
+   }
+}
+
+/**
+ * Release prefetched object child tables
+ */
+void ReleasePrefetchedObjectTables()
+{
+   for(size_t i = 0; i < OBJECT_CHILD_TABLE_COUNT; i++)
+   {
+      delete s_prefetchedTables[i];
+      s_prefetchedTables[i] = nullptr;
+   }
+}
+
+/**
+ * Rows of object child table for single object. Rows are taken from prefetched table if available
+ * or selected from database otherwise. Field accessors follow semantics of corresponding DBGetFieldXXX functions.
+ */
+class ObjectChildRows
+{
+private:
+   const ObjectChildTableData *m_data;
+   int m_first;
+   int m_count;
+   bool m_prefetched;
+
+public:
+   ObjectChildRows(DB_HANDLE hdb, ObjectChildTable table, uint32_t objectId)
+   {
+      m_data = nullptr;
+      m_first = 0;
+      m_count = 0;
+      PrefetchedObjectTable *pt = s_prefetchedTables[table];
+      if (pt != nullptr)
+      {
+         m_data = pt->getData();
+         m_prefetched = true;
+         pt->getRows(objectId, &m_first, &m_count);
+      }
+      else
+      {
+         m_prefetched = false;
+         TCHAR query[1024];
+         _sntprintf(query, 1024, _T("SELECT %s FROM %s WHERE %s=?"), s_objectChildTables[table].columns, s_objectChildTables[table].table, s_objectChildTables[table].idColumn);
+         DB_STATEMENT hStmt = DBPrepare(hdb, query);
+         if (hStmt != nullptr)
+         {
+            DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, objectId);
+            DB_RESULT hResult = DBSelectPrepared(hStmt);
+            if (hResult != nullptr)
+            {
+               m_data = new ObjectChildTableData(hResult, DBGetColumnCount(hResult));
+               m_count = m_data->getNumRows();
+               DBFreeResult(hResult);
+            }
+            DBFreeStatement(hStmt);
+         }
+      }
+   }
+
+   ~ObjectChildRows()
+   {
+      if (!m_prefetched)
+         delete m_data;
+   }
+
+   bool isValid() const { return m_data != nullptr; }
+   int size() const { return m_count; }
+
+   const TCHAR *getField(int index, int column) const
+   {
+      return m_data->getField(m_first + index, column);
+   }
+
+   TCHAR *getField(int index, int column, TCHAR *buffer, size_t size) const
+   {
+      const TCHAR *value = getField(index, column);
+      if (buffer == nullptr)
+         return MemCopyString(value);
+      if (value == nullptr)
+      {
+         *buffer = 0;
+         return nullptr;
+      }
+      _tcslcpy(buffer, value, size);
+      return buffer;
+   }
+
+   int32_t getFieldLong(int index, int column) const
+   {
+      const TCHAR *value = getField(index, column);
+      return (value != nullptr) ? _tcstol(value, nullptr, 10) : 0;
+   }
+
+   uint32_t getFieldULong(int index, int column) const
+   {
+      TCHAR buffer[256];
+      TCHAR *value = getField(index, column, buffer, 256);
+      if (value == nullptr)
+         return 0;
+      StrStrip(value);
+      return (*value == _T('-')) ? static_cast<uint32_t>(_tcstol(value, nullptr, 10)) : static_cast<uint32_t>(_tcstoul(value, nullptr, 10));
+   }
+
+   uint64_t getFieldUInt64(int index, int column) const
+   {
+      TCHAR buffer[256];
+      TCHAR *value = getField(index, column, buffer, 256);
+      if (value == nullptr)
+         return 0;
+      StrStrip(value);
+      return (*value == _T('-')) ? static_cast<uint64_t>(_tcstoll(value, nullptr, 10)) : static_cast<uint64_t>(_tcstoull(value, nullptr, 10));
+   }
+
+   uuid getFieldGUID(int index, int column) const
+   {
+      const TCHAR *value = getField(index, column);
+      return (value == nullptr) ? uuid::NULL_UUID : uuid::parse(value);
+   }
+
+   void getFieldByteArray(int index, int column, int *data, size_t size, int defaultValue) const
+   {
+      const TCHAR *value = getField(index, column);
+      size_t i = 0;
+      if (value != nullptr)
+      {
+         char bytes[2048];
+         StrToBin(value, reinterpret_cast<BYTE*>(bytes), 2048);
+         size_t len = _tcslen(value) / 2;
+         for(; (i < size) && (i < len); i++)
+            data[i] = bytes[i];
+      }
+      for(; i < size; i++)
+         data[i] = defaultValue;
+   }
+};
+
 /**
  * Load common object properties from database
  */
@@ -300,130 +856,103 @@ bool NetObj::loadCommonProperties(DB_HANDLE hdb)
    bool success = false;
 
    // Load access options
-	DB_STATEMENT hStmt = DBPrepare(hdb,
-	                          _T("SELECT name,status,is_deleted,")
-                             _T("inherit_access_rights,last_modified,status_calc_alg,")
-                             _T("status_prop_alg,status_fixed_val,status_shift,")
-                             _T("status_translation,status_single_threshold,")
-                             _T("status_thresholds,comments,is_system,")
-									  _T("location_type,latitude,longitude,location_accuracy,")
-									  _T("location_timestamp,guid,image,submap_id,country,city,")
-                             _T("street_address,postcode,maint_event_id,state_before_maint,")
-                             _T("maint_initiator,state,flags,creation_time FROM object_properties ")
-                             _T("WHERE object_id=?"));
-	if (hStmt != NULL)
-	{
-		DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-		DB_RESULT hResult = DBSelectPrepared(hStmt);
-		if (hResult != NULL)
-		{
-			if (DBGetNumRows(hResult) > 0)
-			{
-				DBGetField(hResult, 0, 0, m_name, MAX_OBJECT_NAME);
-				m_status = m_savedStatus = DBGetFieldLong(hResult, 0, 1);
-				m_isDeleted = DBGetFieldLong(hResult, 0, 2) ? true : false;
-				m_inheritAccessRights = DBGetFieldLong(hResult, 0, 3) ? true : false;
-				m_timestamp = (time_t)DBGetFieldULong(hResult, 0, 4);
-				m_statusCalcAlg = DBGetFieldLong(hResult, 0, 5);
-				m_statusPropAlg = DBGetFieldLong(hResult, 0, 6);
-				m_fixedStatus = DBGetFieldLong(hResult, 0, 7);
-				m_statusShift = DBGetFieldLong(hResult, 0, 8);
-				DBGetFieldByteArray(hResult, 0, 9, m_statusTranslation, 4, STATUS_WARNING);
-				m_statusSingleThreshold = DBGetFieldLong(hResult, 0, 10);
-				DBGetFieldByteArray(hResult, 0, 11, m_statusThresholds, 4, 50);
-				MemFree(m_comments);
-				m_comments = DBGetField(hResult, 0, 12, NULL, 0);
-				m_isSystem = DBGetFieldLong(hResult, 0, 13) ? true : false;
-
-				int locType = DBGetFieldLong(hResult, 0, 14);
-				if (locType != GL_UNSET)
-				{
-					TCHAR lat[32], lon[32];
-
-					DBGetField(hResult, 0, 15, lat, 32);
-					DBGetField(hResult, 0, 16, lon, 32);
-					m_geoLocation = GeoLocation(locType, lat, lon, DBGetFieldLong(hResult, 0, 17), DBGetFieldULong(hResult, 0, 18));
-				}
-				else
-				{
-					m_geoLocation = GeoLocation();
-				}
-
-				m_guid = DBGetFieldGUID(hResult, 0, 19);
-				m_image = DBGetFieldGUID(hResult, 0, 20);
-				m_submapId = DBGetFieldULong(hResult, 0, 21);
-
-            TCHAR country[64], city[64], streetAddress[256], postcode[32];
-            DBGetField(hResult, 0, 22, country, 64);
-            DBGetField(hResult, 0, 23, city, 64);
-            DBGetField(hResult, 0, 24, streetAddress, 256);
-            DBGetField(hResult, 0, 25, postcode, 32);
-            delete m_postalAddress;
-            m_postalAddress = new PostalAddress(country, city, streetAddress, postcode);
-
-            m_maintenanceEventId = DBGetFieldUInt64(hResult, 0, 26);
-            m_stateBeforeMaintenance = DBGetFieldULong(hResult, 0, 27);
-            m_maintenanceInitiator = DBGetFieldULong(hResult, 0, 28);
-
-            m_state = DBGetFieldULong(hResult, 0, 29);
-            m_runtimeFlags = 0;
-            m_flags = DBGetFieldULong(hResult, 0, 30);
-            m_creationTime = static_cast<time_t>(DBGetFieldULong(hResult, 0, 31));
-
-				success = true;
-			}
-			DBFreeResult(hResult);
-		}
-		DBFreeStatement(hStmt);
-	}
+   ObjectChildRows properties(hdb, OCT_OBJECT_PROPERTIES, m_id);
+   if (properties.size() > 0)
+   {
+      properties.getField(0, 0, m_name, MAX_OBJECT_NAME);
+      m_status = m_savedStatus = properties.getFieldLong(0, 1);
+      m_isDeleted = properties.getFieldLong(0, 2) ? true : false;
+      m_inheritAccessRights = properties.getFieldLong(0, 3) ? true : false;
+      m_timestamp = (time_t)properties.getFieldULong(0, 4);
+      m_statusCalcAlg = properties.getFieldLong(0, 5);
+      m_statusPropAlg = properties.getFieldLong(0, 6);
+      m_fixedStatus = properties.getFieldLong(0, 7);
+      m_statusShift = properties.getFieldLong(0, 8);
+      properties.getFieldByteArray(0, 9, m_statusTranslation, 4, STATUS_WARNING);
+      m_statusSingleThreshold = properties.getFieldLong(0, 10);
+      properties.getFieldByteArray(0, 11, m_statusThresholds, 4, 50);
+      MemFree(m_comments);
+      m_comments = properties.getField(0, 12, NULL, 0);
+      m_isSystem = properties.getFieldLong(0, 13) ? true : false;
+
+      int locType = properties.getFieldLong(0, 14);
+      if (locType != GL_UNSET)
+      {
+         TCHAR lat[32], lon[32];
+
+         properties.getField(0, 15, lat, 32);
+         properties.getField(0, 16, lon, 32);
+         m_geoLocation = GeoLocation(locType, lat, lon, properties.getFieldLong(0, 17), properties.getFieldULong(0, 18));
+      }
+      else
+      {
+         m_geoLocation = GeoLocation();
+      }
+
+      m_guid = properties.getFieldGUID(0, 19);
+      m_image = properties.getFieldGUID(0, 20);
+      m_submapId = properties.getFieldULong(0, 21);
+
+      TCHAR country[64], city[64], streetAddress[256], postcode[32];
+      properties.getField(0, 22, country, 64);
+      properties.getField(0, 23, city, 64);
+      properties.getField(0, 24, streetAddress, 256);
+      properties.getField(0, 25, postcode, 32);
+      delete m_postalAddress;
+      m_postalAddress = new PostalAddress(country, city, streetAddress, postcode);
+
+      m_maintenanceEventId = properties.getFieldUInt64(0, 26);
+      m_stateBeforeMaintenance = properties.getFieldULong(0, 27);
+      m_maintenanceInitiator = properties.getFieldULong(0, 28);
+
+      m_state = properties.getFieldULong(0, 29);
+      m_runtimeFlags = 0;
+      m_flags = properties.getFieldULong(0, 30);
+      m_creationTime = static_cast<time_t>(properties.getFieldULong(0, 31));
+
+      success = true;
+   }
 
 	// Load custom attributes
 	if (success)
 	{
-		hStmt = DBPrepare(hdb, _T("SELECT attr_name,attr_value,flags FROM object_custom_attributes WHERE object_id=?"));
-		if (hStmt != NULL)
-		{
-			DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-			DB_RESULT hResult = DBSelectPrepared(hStmt);
-			if (hResult != NULL)
-			{
-			   setCustomAttributesFromDatabase(hResult);
-				DBFreeResult(hResult);
-			}
-			else
-			{
-				success = false;
-			}
-			DBFreeStatement(hStmt);
-		}
-		else
-		{
-			success = false;
-		}
+	   ObjectChildRows rows(hdb, OCT_CUSTOM_ATTRIBUTES, m_id);
+	   if (rows.isValid())
+	   {
+	      for(int i = 0; i < rows.size(); i++)
+	         setCustomAttributeFromDatabase(rows.getField(i, 0), rows.getField(i, 1), rows.getFieldULong(i, 2));
+	   }
+	   else
+	      success = false;
 	}
 
    // Load associated dashboards
    if (success)
    {
-      hStmt = DBPrepare(hdb, _T("SELECT dashboard_id FROM dashboard_associations WHERE object_id=?"));
-      if (hStmt != NULL)
+      ObjectChildRows rows(hdb, OCT_DASHBOARD_ASSOCIATIONS, m_id);
+      if (rows.isValid())
       {
-         DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-         DB_RESULT hResult = DBSelectPrepared(hStmt);
-         if (hResult != NULL)
+         for(int i = 0; i < rows.size(); i++)
          {
-            int count = DBGetNumRows(hResult);
-            for(int i = 0; i < count; i++)
-            {
-               m_dashboards->add(DBGetFieldULong(hResult, i, 0));
-            }
-            DBFreeResult(hResult);
+            m_dashboards->add(rows.getFieldULong(i, 0));
          }
-         else
+      }
+      else
+      {
+         success = false;
+      }
+   }
+
+   // Load associated URLs
+   if (success)
+   {
+      ObjectChildRows rows(hdb, OCT_URLS, m_id);
+      if (rows.isValid())
+      {
+         for(int i = 0; i < rows.size(); i++)
          {
-            success = false;
+            m_urls->add(new ObjectUrl(rows.getFieldULong(i, 0), rows.getField(i, 1), rows.getField(i, 2)));
          }
-         DBFreeStatement(hStmt);
       }
       else
       {
@@ -431,201 +960,447 @@ bool NetObj::loadCommonProperties(DB_HANDLE hdb)
       }
    }
 
-   // Load associated URLs
-   if (success)
+	if (success)
+		success = loadTrustedNodes(hdb);
+
+	if (success)
+	{
+	   ObjectChildRows rows(hdb, OCT_RESPONSIBLE_USERS, m_id);
+	   if (rows.isValid())
+	   {
+	      if (rows.size() > 0)
+	      {
+	         m_responsibleUsers = new IntegerArray<UINT32>(rows.size(), 16);
+	         for(int i = 0; i < rows.size(); i++)
+	            m_responsibleUsers->add(rows.getFieldULong(i, 0));
+	      }
+	   }
+	   else
+	   {
+	      success = false;
+	   }
+	}
+
+	if (success)
+	   captureSaveState();
+	else
+		DbgPrintf(4, _T("NetObj::loadCommonProperties() failed for object %s [%ld] class=%d"), m_name, (long)m_id, getObjectClass());
+
+   return success;
+}
+
+/**
+ * Callback for saving module data in database
+ */
+static EnumerationCallbackResult SaveModuleDataCallback(const TCHAR *key, const void *value, void *data)
+{
+   return ((ModuleData *)value)->saveToDatabase(((ModuleDataDatabaseCallbackParams *)data)->hdb, ((ModuleDataDatabaseCallbackParams *)data)->id) ? _CONTINUE : _STOP;
+}
+
+/**
+ * Save module data to database
+ */
+bool NetObj::saveModuleData(DB_HANDLE hdb)
+{
+   if (!(m_modified & MODIFY_MODULE_DATA) || (m_moduleData == NULL))
+      return true;
+
+   ModuleDataDatabaseCallbackParams data;
+   data.id = m_id;
+   data.hdb = hdb;
+   return m_moduleData->forEach(SaveModuleDataCallback, &data) == _CONTINUE;
+}
+
+/**
+ * Value of object_properties column prepared for binding
+ */
+struct ObjectPropertyValue
+{
+   int sqlType;
+   int cType;
+   const TCHAR *text;
+   int64_t number;
+
+   void setText(const TCHAR *value)
+   {
+      sqlType = DB_SQLTYPE_VARCHAR;
+      cType = DB_CTYPE_STRING;
+      text = value;
+      number = 0;
+   }
+
+   void setNumber(int type, int64_t value, int sqlType = DB_SQLTYPE_INTEGER)
+   {
+      this->sqlType = sqlType;
+      cType = type;
+      text = nullptr;
+      number = value;
+   }
+
+   const void *data() const
+   {
+      return (cType == DB_CTYPE_STRING) ? static_cast<const void*>(text) : static_cast<const void*>(&number);
+   }
+
+   /**
+    * Size of value data. For strings terminating zero is included, so empty string differs from NULL.
+    */
+   size_t size() const
+   {
+      if (cType == DB_CTYPE_STRING)
+         return (text != nullptr) ? (_tcslen(text) + 1) * sizeof(TCHAR) : 0;
+      return sizeof(int64_t);
+   }
+
+   void bind(DB_STATEMENT hStmt, int pos) const
    {
-      hStmt = DBPrepare(hdb, _T("SELECT url_id,url,description FROM object_urls WHERE object_id=?"));
-      if (hStmt != NULL)
-      {
-         DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-         DB_RESULT hResult = DBSelectPrepared(hStmt);
-         if (hResult != NULL)
-         {
-            int count = DBGetNumRows(hResult);
-            for(int i = 0; i < count; i++)
-            {
-               m_urls->add(new ObjectUrl(hResult, i));
-            }
-            DBFreeResult(hResult);
-         }
-         else
-         {
-            success = false;
-         }
-         DBFreeStatement(hStmt);
-      }
-      else
+      switch(cType)
       {
-         success = false;
+         case DB_CTYPE_STRING:
+            DBBind(hStmt, pos, sqlType, text, DB_BIND_STATIC);
+            break;
+         case DB_CTYPE_INT32:
+            DBBind(hStmt, pos, sqlType, static_cast<INT32>(number));
+            break;
+         case DB_CTYPE_UINT32:
+            DBBind(hStmt, pos, sqlType, static_cast<UINT32>(number));
+            break;
+         default:
+            DBBind(hStmt, pos, sqlType, static_cast<UINT64>(number));
+            break;
       }
    }
+};
 
-	if (success)
-		success = loadTrustedNodes(hdb);
-
-	if (success)
-	{
-      success = false;
-	   hStmt = DBPrepare(hdb, _T("SELECT user_id FROM responsible_users WHERE object_id=?"));
-	   if (hStmt != NULL)
-	   {
-	      DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-	      DB_RESULT hResult = DBSelectPrepared(hStmt);
-	      if (hResult != NULL)
-	      {
-	         success = true;
-	         int numRows = DBGetNumRows(hResult);
-	         if (numRows > 0)
-	         {
-	            m_responsibleUsers = new IntegerArray<UINT32>(numRows, 16);
-               for(int i = 0; i < numRows; i++)
-                  m_responsibleUsers->add(DBGetFieldULong(hResult, i, 0));
-	         }
-	         DBFreeResult(hResult);
-	      }
-	      DBFreeStatement(hStmt);
-	   }
-	}
+/**
+ * Get data of integer list for comparison with saved state
+ */
+static inline const void *IntegerListData(const IntegerArray<UINT32> *list)
+{
+   return (list != nullptr) ? list->getBuffer() : nullptr;
+}
 
-	if (!success)
-		DbgPrintf(4, _T("NetObj::loadCommonProperties() failed for object %s [%ld] class=%d"), m_name, (long)m_id, getObjectClass());
+/**
+ * Get size of integer list data
+ */
+static inline size_t IntegerListSize(const IntegerArray<UINT32> *list)
+{
+   return (list != nullptr) ? list->size() * sizeof(UINT32) : 0;
+}
 
-   return success;
+/**
+ * Serialize URL list for comparison with saved state
+ */
+static void SerializeUrlList(const ObjectArray<ObjectUrl> *urls, ByteStream *out)
+{
+   for(int i = 0; i < urls->size(); i++)
+   {
+      const ObjectUrl *url = urls->get(i);
+      out->write(url->getId());
+      out->writeString(CHECK_NULL_EX(url->getUrl()));
+      out->writeString(CHECK_NULL_EX(url->getDescription()));
+   }
 }
 
 /**
- * Callback for saving custom attribute in database
+ * Persistent custom attribute as seen at the beginning of save
  */
-static EnumerationCallbackResult SaveAttributeCallback(const TCHAR *key, const CustomAttribute *value, DB_STATEMENT hStmt)
+struct CustomAttributeSnapshot
 {
-   if(value->sourceObject != 0 && (value->flags & CAF_REDEFINED) == 0) //do not save inherited attributes
-      return _CONTINUE;
+   String name;
+   SharedString value;
+   uint32_t flags;
 
-   DBBind(hStmt, 2, DB_SQLTYPE_VARCHAR, key, DB_BIND_STATIC);
-   DBBind(hStmt, 3, DB_SQLTYPE_VARCHAR, value->value, DB_BIND_STATIC);
-   DBBind(hStmt, 4, DB_SQLTYPE_INTEGER, value->flags);
-   return DBExecute(hStmt) ? _CONTINUE : _STOP;
-}
+   CustomAttributeSnapshot(const TCHAR *_name, const CustomAttribute *attr) : name(_name)
+   {
+      value = attr->value;
+      flags = attr->flags;
+   }
+};
 
 /**
- * Callback for saving module data in database
+ * Callback for collecting persistent custom attributes
  */
-static EnumerationCallbackResult SaveModuleDataCallback(const TCHAR *key, const void *value, void *data)
+static EnumerationCallbackResult SnapshotAttributeCallback(const TCHAR *key, const CustomAttribute *value, ObjectArray<CustomAttributeSnapshot> *snapshot)
 {
-   return ((ModuleData *)value)->saveToDatabase(((ModuleDataDatabaseCallbackParams *)data)->hdb, ((ModuleDataDatabaseCallbackParams *)data)->id) ? _CONTINUE : _STOP;
+   if ((value->sourceObject == 0) || (value->flags & CAF_REDEFINED)) // do not save inherited attributes
+      snapshot->add(new CustomAttributeSnapshot(key, value));
+   return _CONTINUE;
 }
 
 /**
- * Save module data to database
+ * Build saved custom attribute map from snapshot
  */
-bool NetObj::saveModuleData(DB_HANDLE hdb)
+static StringObjectMap<SavedAttribute> *BuildSavedAttributeMap(const ObjectArray<CustomAttributeSnapshot>& snapshot)
 {
-   if (!(m_modified & MODIFY_MODULE_DATA) || (m_moduleData == NULL))
-      return true;
-
-   ModuleDataDatabaseCallbackParams data;
-   data.id = m_id;
-   data.hdb = hdb;
-   return m_moduleData->forEach(SaveModuleDataCallback, &data) == _CONTINUE;
+   auto attributes = new StringObjectMap<SavedAttribute>(Ownership::True);
+   attributes->setIgnoreCase(false);
+   for(int i = 0; i < snapshot.size(); i++)
+   {
+      const CustomAttributeSnapshot *a = snapshot.get(i);
+      attributes->set(a->name.cstr(), new SavedAttribute(a->value, a->flags));
+   }
+   return attributes;
 }
 
 /**
- * Save common object properties to database
+ * Save custom attributes to database. Only attributes changed since last save are written.
  */
-bool NetObj::saveCommonProperties(DB_HANDLE hdb)
+bool NetObj::saveCustomAttributes(DB_HANDLE hdb)
 {
-   // Save custom attributes
-   bool success = true;
-   if (m_modified & MODIFY_CUSTOM_ATTRIBUTES)
+   ObjectArray<CustomAttributeSnapshot> snapshot(32, 32, Ownership::True);
+   forEachCustomAttribute(SnapshotAttributeCallback, &snapshot);
+   StringObjectMap<SavedAttribute> *attributes = BuildSavedAttributeMap(snapshot);
+   const StringObjectMap<SavedAttribute> *savedAttributes = m_saveState->attributes;
+
+   bool success;
+   if (savedAttributes == nullptr)
    {
       success = executeQueryOnObject(hdb, _T("DELETE FROM object_custom_attributes WHERE object_id=?"));
-      if (success && getCustomAttributeSize() != 0)
+   }
+   else
+   {
+      // Delete removed attributes first so that attribute re-added with different name case will not clash with old one
+      success = true;
+      DB_STATEMENT hStmt = nullptr;
+      StructArray<KeyValuePair<SavedAttribute>> *savedList = savedAttributes->toArray();
+      for(int i = 0; (i < savedList->size()) && success; i++)
       {
-         DB_STATEMENT hStmt = DBPrepare(hdb, _T("INSERT INTO object_custom_attributes (object_id,attr_name,attr_value,flags) VALUES (?,?,?,?)"), true);
-         if (hStmt != NULL)
+         const TCHAR *name = savedList->get(i)->key;
+         if (attributes->contains(name))
+            continue;
+
+         if (hStmt == nullptr)
          {
+            hStmt = DBPrepare(hdb, _T("DELETE FROM object_custom_attributes WHERE object_id=? AND attr_name=?"), true);
+            if (hStmt == nullptr)
+            {
+               success = false;
+               break;
+            }
             DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-            success = (forEachCustomAttribute(SaveAttributeCallback, hStmt) == _CONTINUE);
-            DBFreeStatement(hStmt);
          }
-         else
+         DBBind(hStmt, 2, DB_SQLTYPE_VARCHAR, name, DB_BIND_STATIC);
+         success = DBExecute(hStmt);
+      }
+      delete savedList;
+      if (hStmt != nullptr)
+         DBFreeStatement(hStmt);
+   }
+
+   DB_STATEMENT hInsertStmt = nullptr, hUpdateStmt = nullptr;
+   for(int i = 0; (i < snapshot.size()) && success; i++)
+   {
+      const CustomAttributeSnapshot *a = snapshot.get(i);
+      const SavedAttribute *saved = (savedAttributes != nullptr) ? savedAttributes->get(a->name.cstr()) : nullptr;
+      if ((saved != nullptr) && saved->equals(a->value, a->flags))
+         continue;
+
+      if (saved == nullptr)
+      {
+         if (hInsertStmt == nullptr)
          {
-            success = false;
+            hInsertStmt = DBPrepare(hdb, _T("INSERT INTO object_custom_attributes (object_id,attr_name,attr_value,flags) VALUES (?,?,?,?)"), true);
+            if (hInsertStmt == nullptr)
+            {
+               success = false;
+               break;
+            }
+            DBBind(hInsertStmt, 1, DB_SQLTYPE_INTEGER, m_id);
          }
+         DBBind(hInsertStmt, 2, DB_SQLTYPE_VARCHAR, a->name.cstr(), DB_BIND_STATIC);
+         DBBind(hInsertStmt, 3, DB_SQLTYPE_VARCHAR, a->value.cstr(), DB_BIND_STATIC);
+         DBBind(hInsertStmt, 4, DB_SQLTYPE_INTEGER, a->flags);
+         success = DBExecute(hInsertStmt);
+      }
+      else
+      {
+         if (hUpdateStmt == nullptr)
+         {
+            hUpdateStmt = DBPrepare(hdb, _T("UPDATE object_custom_attributes SET attr_value=?,flags=? WHERE object_id=? AND attr_name=?"), true);
+            if (hUpdateStmt == nullptr)
+            {
+               success = false;
+               break;
+            }
+            DBBind(hUpdateStmt, 3, DB_SQLTYPE_INTEGER, m_id);
+         }
+         DBBind(hUpdateStmt, 1, DB_SQLTYPE_VARCHAR, a->value.cstr(), DB_BIND_STATIC);
+         DBBind(hUpdateStmt, 2, DB_SQLTYPE_INTEGER, a->flags);
+         DBBind(hUpdateStmt, 4, DB_SQLTYPE_VARCHAR, a->name.cstr(), DB_BIND_STATIC);
+         success = DBExecute(hUpdateStmt);
       }
-      if (!success)
-         return false;
    }
+   if (hInsertStmt != nullptr)
+      DBFreeStatement(hInsertStmt);
+   if (hUpdateStmt != nullptr)
+      DBFreeStatement(hUpdateStmt);
+
+   if (success)
+      m_saveState->getPending()->setAttributes(attributes);
+   else
+      delete attributes;
+   return success;
+}
+
+/**
+ * Get values of object_properties columns. Buffer should be at least PROPERTY_VALUES_BUFFER_SIZE characters.
+ * Object properties should be locked by caller.
+ */
+void NetObj::getCommonPropertyValues(ObjectPropertyValue *values, TCHAR *buffer)
+{
+   TCHAR *translation = buffer;
+   TCHAR *thresholds = &buffer[64];
+   TCHAR *lat = &buffer[128];
+   TCHAR *lon = &buffer[192];
+   TCHAR *guid = &buffer[256];
+   TCHAR *image = &buffer[320];
+   for(int i = 0, j = 0; i < 4; i++, j += 2)
+   {
+      _sntprintf(&translation[j], 64 - j, _T("%02X"), (BYTE)m_statusTranslation[i]);
+      _sntprintf(&thresholds[j], 64 - j, _T("%02X"), (BYTE)m_statusThresholds[i]);
+   }
+   _sntprintf(lat, 64, _T("%f"), m_geoLocation.getLatitude());
+   _sntprintf(lon, 64, _T("%f"), m_geoLocation.getLongitude());
+   m_guid.toString(guid);
+   m_image.toString(image);
+
+   values[0].setText(m_name);
+   values[1].setNumber(DB_CTYPE_INT32, m_status);
+   values[2].setNumber(DB_CTYPE_INT32, m_isDeleted ? 1 : 0);
+   values[3].setNumber(DB_CTYPE_INT32, m_inheritAccessRights ? 1 : 0);
+   values[4].setNumber(DB_CTYPE_INT32, static_cast<INT32>(m_timestamp));
+   values[5].setNumber(DB_CTYPE_INT32, m_statusCalcAlg);
+   values[6].setNumber(DB_CTYPE_INT32, m_statusPropAlg);
+   values[7].setNumber(DB_CTYPE_INT32, m_fixedStatus);
+   values[8].setNumber(DB_CTYPE_INT32, m_statusShift);
+   values[9].setText(translation);
+   values[10].setNumber(DB_CTYPE_INT32, m_statusSingleThreshold);
+   values[11].setText(thresholds);
+   values[12].setText(m_comments);
+   values[13].setNumber(DB_CTYPE_INT32, m_isSystem ? 1 : 0);
+   values[14].setNumber(DB_CTYPE_INT32, m_geoLocation.getType());
+   values[15].setText(lat);
+   values[16].setText(lon);
+   values[17].setNumber(DB_CTYPE_INT32, m_geoLocation.getAccuracy());
+   values[18].setNumber(DB_CTYPE_UINT32, static_cast<UINT32>(m_geoLocation.getTimestamp()));
+   values[19].setText(guid);
+   values[20].setText(image);
+   values[21].setNumber(DB_CTYPE_UINT32, m_submapId);
+   values[22].setText(m_postalAddress->getCountry());
+   values[23].setText(m_postalAddress->getCity());
+   values[24].setText(m_postalAddress->getStreetAddress());
+   values[25].setText(m_postalAddress->getPostCode());
+   values[26].setNumber(DB_CTYPE_UINT64, m_maintenanceEventId, DB_SQLTYPE_BIGINT);
+   values[27].setNumber(DB_CTYPE_UINT32, m_stateBeforeMaintenance);
+   values[28].setNumber(DB_CTYPE_UINT32, m_state);
+   values[29].setNumber(DB_CTYPE_UINT32, m_flags);
+   values[30].setNumber(DB_CTYPE_INT32, static_cast<INT32>(m_creationTime));
+   values[31].setNumber(DB_CTYPE_UINT32, m_maintenanceInitiator);
+}
+
+/**
+ * Remember current state of common properties as saved in database. Called after object is loaded from database.
+ */
+void NetObj::captureSaveState()
+{
+   delete m_saveState;
+   m_saveState = new ObjectSaveState();
+
+   ObjectPropertyValue values[OBJECT_PROPERTIES_COLUMN_COUNT];
+   TCHAR buffer[PROPERTY_VALUES_BUFFER_SIZE];
+   getCommonPropertyValues(values, buffer);
+   for(int i = 0; i < OBJECT_PROPERTIES_COLUMN_COUNT; i++)
+      m_saveState->set(i, values[i].data(), values[i].size());
+
+   m_saveState->set(SAVED_STATE_DASHBOARDS, IntegerListData(m_dashboards), IntegerListSize(m_dashboards));
+   ByteStream urls(256);
+   SerializeUrlList(m_urls, &urls);
+   m_saveState->set(SAVED_STATE_URLS, urls.buffer(), urls.size());
+   m_saveState->set(SAVED_STATE_TRUSTED_NODES, IntegerListData(m_trustedNodes), IntegerListSize(m_trustedNodes));
+   m_saveState->set(SAVED_STATE_RESPONSIBLE_USERS, IntegerListData(m_responsibleUsers), IntegerListSize(m_responsibleUsers));
+
+   ObjectArray<CustomAttributeSnapshot> snapshot(32, 32, Ownership::True);
+   forEachCustomAttribute(SnapshotAttributeCallback, &snapshot);
+   m_saveState->setAttributes(BuildSavedAttributeMap(snapshot));
+}
+
+/**
+ * Save common object properties to database. Only columns and child rows changed since last save are written.
+ * Object properties should be locked by caller.
+ */
+bool NetObj::saveCommonProperties(DB_HANDLE hdb)
+{
+   if (m_saveState == nullptr)
+      m_saveState = new ObjectSaveState();
+   m_saveState->discardPending();
+
+   // Save custom attributes
+   if ((m_modified & MODIFY_CUSTOM_ATTRIBUTES) && !saveCustomAttributes(hdb))
+      return false;
 
    if (!(m_modified & MODIFY_COMMON_PROPERTIES))
       return saveModuleData(hdb);
 
-   static const TCHAR *columns[] = {
-      _T("name"), _T("status"), _T("is_deleted"), _T("inherit_access_rights"), _T("last_modified"), _T("status_calc_alg"),
-      _T("status_prop_alg"), _T("status_fixed_val"), _T("status_shift"), _T("status_translation"), _T("status_single_threshold"),
-      _T("status_thresholds"), _T("comments"), _T("is_system"), _T("location_type"), _T("latitude"), _T("longitude"),
-      _T("location_accuracy"), _T("location_timestamp"), _T("guid"), _T("image"), _T("submap_id"), _T("country"), _T("city"),
-      _T("street_address"), _T("postcode"), _T("maint_event_id"), _T("state_before_maint"), _T("state"), _T("flags"),
-      _T("creation_time"), _T("maint_initiator"), nullptr
-   };
+   ObjectSaveState *pending = m_saveState->getPending();
 
-	DB_STATEMENT hStmt = DBPrepareMerge(hdb, _T("object_properties"), _T("object_id"), m_id, columns);
-	if (hStmt == NULL)
-		return false;
+   ObjectPropertyValue values[OBJECT_PROPERTIES_COLUMN_COUNT];
+   TCHAR buffer[PROPERTY_VALUES_BUFFER_SIZE];
+   getCommonPropertyValues(values, buffer);
 
-   TCHAR szTranslation[16], szThresholds[16], lat[32], lon[32];
-   for(int i = 0, j = 0; i < 4; i++, j += 2)
+   int changedColumns[OBJECT_PROPERTIES_COLUMN_COUNT];
+   int changedCount = 0;
+   for(int i = 0; i < OBJECT_PROPERTIES_COLUMN_COUNT; i++)
+   {
+      if (m_saveState->isChanged(i, values[i].data(), values[i].size()))
+      {
+         changedColumns[changedCount++] = i;
+         pending->set(i, values[i].data(), values[i].size());
+      }
+   }
+
+   bool success = true;
+   if (changedCount == OBJECT_PROPERTIES_COLUMN_COUNT)
+   {
+      // Row may not exist yet
+      DB_STATEMENT hStmt = DBPrepareMerge(hdb, _T("object_properties"), _T("object_id"), m_id, s_objectPropertiesColumns);
+      if (hStmt == nullptr)
+         return false;
+      for(int i = 0; i < OBJECT_PROPERTIES_COLUMN_COUNT; i++)
+         values[i].bind(hStmt, i + 1);
+      DBBind(hStmt, OBJECT_PROPERTIES_COLUMN_COUNT + 1, DB_SQLTYPE_INTEGER, m_id);
+      success = DBExecute(hStmt);
+      DBFreeStatement(hStmt);
+   }
+   else if (changedCount > 0)
    {
-      _sntprintf(&szTranslation[j], 16 - j, _T("%02X"), (BYTE)m_statusTranslation[i]);
-      _sntprintf(&szThresholds[j], 16 - j, _T("%02X"), (BYTE)m_statusThresholds[i]);
-   }
-	_sntprintf(lat, 32, _T("%f"), m_geoLocation.getLatitude());
-	_sntprintf(lon, 32, _T("%f"), m_geoLocation.getLongitude());
-
-	DBBind(hStmt, 1, DB_SQLTYPE_VARCHAR, m_name, DB_BIND_STATIC);
-	DBBind(hStmt, 2, DB_SQLTYPE_INTEGER, (LONG)m_status);
-   DBBind(hStmt, 3, DB_SQLTYPE_INTEGER, (LONG)(m_isDeleted ? 1 : 0));
-	DBBind(hStmt, 4, DB_SQLTYPE_INTEGER, (LONG)(m_inheritAccessRights ? 1 : 0));
-	DBBind(hStmt, 5, DB_SQLTYPE_INTEGER, (LONG)m_timestamp);
-	DBBind(hStmt, 6, DB_SQLTYPE_INTEGER, (LONG)m_statusCalcAlg);
-	DBBind(hStmt, 7, DB_SQLTYPE_INTEGER, (LONG)m_statusPropAlg);
-	DBBind(hStmt, 8, DB_SQLTYPE_INTEGER, (LONG)m_fixedStatus);
-	DBBind(hStmt, 9, DB_SQLTYPE_INTEGER, (LONG)m_statusShift);
-	DBBind(hStmt, 10, DB_SQLTYPE_VARCHAR, szTranslation, DB_BIND_STATIC);
-	DBBind(hStmt, 11, DB_SQLTYPE_INTEGER, (LONG)m_statusSingleThreshold);
-	DBBind(hStmt, 12, DB_SQLTYPE_VARCHAR, szThresholds, DB_BIND_STATIC);
-	DBBind(hStmt, 13, DB_SQLTYPE_VARCHAR, m_comments, DB_BIND_STATIC);
-   DBBind(hStmt, 14, DB_SQLTYPE_INTEGER, (LONG)(m_isSystem ? 1 : 0));
-	DBBind(hStmt, 15, DB_SQLTYPE_INTEGER, (LONG)m_geoLocation.getType());
-	DBBind(hStmt, 16, DB_SQLTYPE_VARCHAR, lat, DB_BIND_STATIC);
-	DBBind(hStmt, 17, DB_SQLTYPE_VARCHAR, lon, DB_BIND_STATIC);
-	DBBind(hStmt, 18, DB_SQLTYPE_INTEGER, (LONG)m_geoLocation.getAccuracy());
-	DBBind(hStmt, 19, DB_SQLTYPE_INTEGER, (UINT32)m_geoLocation.getTimestamp());
-	DBBind(hStmt, 20, DB_SQLTYPE_VARCHAR, m_guid);
-	DBBind(hStmt, 21, DB_SQLTYPE_VARCHAR, m_image);
-	DBBind(hStmt, 22, DB_SQLTYPE_INTEGER, m_submapId);
-	DBBind(hStmt, 23, DB_SQLTYPE_VARCHAR, m_postalAddress->getCountry(), DB_BIND_STATIC);
-	DBBind(hStmt, 24, DB_SQLTYPE_VARCHAR, m_postalAddress->getCity(), DB_BIND_STATIC);
-	DBBind(hStmt, 25, DB_SQLTYPE_VARCHAR, m_postalAddress->getStreetAddress(), DB_BIND_STATIC);
-	DBBind(hStmt, 26, DB_SQLTYPE_VARCHAR, m_postalAddress->getPostCode(), DB_BIND_STATIC);
-   DBBind(hStmt, 27, DB_SQLTYPE_BIGINT, m_maintenanceEventId);
-   DBBind(hStmt, 28, DB_SQLTYPE_INTEGER, m_stateBeforeMaintenance);
-	DBBind(hStmt, 29, DB_SQLTYPE_INTEGER, m_state);
-	DBBind(hStmt, 30, DB_SQLTYPE_INTEGER, m_flags);
-	DBBind(hStmt, 31, DB_SQLTYPE_INTEGER, (LONG)m_creationTime);
-   DBBind(hStmt, 32, DB_SQLTYPE_INTEGER, m_maintenanceInitiator);
-	DBBind(hStmt, 33, DB_SQLTYPE_INTEGER, m_id);
-
-   success = DBExecute(hStmt);
-	DBFreeStatement(hStmt);
+      StringBuffer query(_T("UPDATE object_properties SET "));
+      for(int i = 0; i < changedCount; i++)
+      {
+         if (i > 0)
+            query.append(_T(','));
+         query.append(s_objectPropertiesColumns[changedColumns[i]]);
+         query.append(_T("=?"));
+      }
+      query.append(_T(" WHERE object_id=?"));
+
+      DB_STATEMENT hStmt = DBPrepare(hdb, query);
+      if (hStmt == nullptr)
+         return false;
+      for(int i = 0; i < changedCount; i++)
+         values[changedColumns[i]].bind(hStmt, i + 1);
+      DBBind(hStmt, changedCount + 1, DB_SQLTYPE_INTEGER, m_id);
+      success = DBExecute(hStmt);
+      DBFreeStatement(hStmt);
+   }
 
    // Save dashboard associations
-   if (success)
+   if (success && m_saveState->isChanged(SAVED_STATE_DASHBOARDS, IntegerListData(m_dashboards), IntegerListSize(m_dashboards)))
    {
       success = ExecuteQueryOnObject(hdb, m_id, _T("DELETE FROM dashboard_associations WHERE object_id=?"));
       if (success && !m_dashboards->isEmpty())
       {
-         hStmt = DBPrepare(hdb, _T("INSERT INTO dashboard_associations (object_id,dashboard_id) VALUES (?,?)"), true);
+         DB_STATEMENT hStmt = DBPrepare(hdb, _T("INSERT INTO dashboard_associations (object_id,dashboard_id) VALUES (?,?)"), true);
          if (hStmt != NULL)
          {
             DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
@@ -641,15 +1416,18 @@ bool NetObj::saveCommonProperties(DB_HANDLE hdb)
             success = false;
          }
       }
+      pending->set(SAVED_STATE_DASHBOARDS, IntegerListData(m_dashboards), IntegerListSize(m_dashboards));
    }
 
    // Save URL associations
-   if (success)
+   ByteStream urls(256);
+   SerializeUrlList(m_urls, &urls);
+   if (success && m_saveState->isChanged(SAVED_STATE_URLS, urls.buffer(), urls.size()))
    {
       success = ExecuteQueryOnObject(hdb, m_id, _T("DELETE FROM object_urls WHERE object_id=?"));
       if (success && !m_urls->isEmpty())
       {
-         hStmt = DBPrepare(hdb, _T("INSERT INTO object_urls (object_id,url_id,url,description) VALUES (?,?,?,?)"), true);
+         DB_STATEMENT hStmt = DBPrepare(hdb, _T("INSERT INTO object_urls (object_id,url_id,url,description) VALUES (?,?,?,?)"), true);
          if (hStmt != NULL)
          {
             DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
@@ -668,19 +1446,23 @@ bool NetObj::saveCommonProperties(DB_HANDLE hdb)
             success = false;
          }
       }
+      pending->set(SAVED_STATE_URLS, urls.buffer(), urls.size());
    }
 
-	if (success)
+	if (success && m_saveState->isChanged(SAVED_STATE_TRUSTED_NODES, IntegerListData(m_trustedNodes), IntegerListSize(m_trustedNodes)))
+	{
 		success = saveTrustedNodes(hdb);
+      pending->set(SAVED_STATE_TRUSTED_NODES, IntegerListData(m_trustedNodes), IntegerListSize(m_trustedNodes));
+	}
 
 	// Save responsible users
-	if (success)
+   lockResponsibleUsersList(false);
+	if (success && m_saveState->isChanged(SAVED_STATE_RESPONSIBLE_USERS, IntegerListData(m_responsibleUsers), IntegerListSize(m_responsibleUsers)))
 	{
 	   success = executeQueryOnObject(hdb, _T("DELETE FROM responsible_users WHERE object_id=?"));
-      lockResponsibleUsersList(false);
 	   if (success && (m_responsibleUsers != NULL) && !m_responsibleUsers->isEmpty())
 	   {
-	      hStmt = DBPrepare(hdb, _T("INSERT INTO responsible_users (object_id,user_id) VALUES (?,?)"), m_responsibleUsers->size() > 1);
+	      DB_STATEMENT hStmt = DBPrepare(hdb, _T("INSERT INTO responsible_users (object_id,user_id) VALUES (?,?)"), m_responsibleUsers->size() > 1);
 	      if (hStmt != NULL)
 	      {
 	         DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
@@ -696,8 +1478,9 @@ bool NetObj::saveCommonProperties(DB_HANDLE hdb)
 	         success = false;
 	      }
 	   }
-      unlockResponsibleUsersList();
+      pending->set(SAVED_STATE_RESPONSIBLE_USERS, IntegerListData(m_responsibleUsers), IntegerListSize(m_responsibleUsers));
 	}
+   unlockResponsibleUsersList();
 
    return success ? saveModuleData(hdb) : false;
 }
@@ -1064,70 +1847,146 @@ void NetObj::calculateCompoundStatus(BOOL bForcedRecalc)
 }
 
 /**
- * Load ACL from database
+ * Handler for ACL elements enumeration - collect elements into array
  */
-bool NetObj::loadACLFromDB(DB_HANDLE hdb)
+static void CollectAccessListElement(UINT32 userId, UINT32 accessRights, void *context)
 {
-   bool success = false;
-
-	DB_STATEMENT hStmt = DBPrepare(hdb, _T("SELECT user_id,access_rights FROM acl WHERE object_id=?"));
-	if (hStmt != NULL)
-	{
-		DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
-		DB_RESULT hResult = DBSelectPrepared(hStmt);
-		if (hResult != NULL)
-		{
-			int count = DBGetNumRows(hResult);
-			for(int i = 0; i < count; i++)
-				m_accessList->addElement(DBGetFieldULong(hResult, i, 0), DBGetFieldULong(hResult, i, 1));
-			DBFreeResult(hResult);
-			success = true;
-		}
-		DBFreeStatement(hStmt);
-	}
-   return success;
+   ACL_ELEMENT e;
+   e.dwUserId = userId;
+   e.dwAccessRights = accessRights;
+   static_cast<StructArray<ACL_ELEMENT>*>(context)->add(&e);
 }
 
 /**
- * ACL enumeration parameters structure
+ * Find element for given user in access list snapshot
  */
-struct SAVE_PARAM
+static const ACL_ELEMENT *FindAccessListElement(const StructArray<ACL_ELEMENT> *elements, UINT32 userId)
 {
-   DB_HANDLE hdb;
-   UINT32 dwObjectId;
-};
+   for(int i = 0; i < elements->size(); i++)
+   {
+      const ACL_ELEMENT *e = elements->get(i);
+      if (e->dwUserId == userId)
+         return e;
+   }
+   return nullptr;
+}
 
 /**
- * Handler for ACL elements enumeration
+ * Load ACL from database
  */
-static void EnumerationHandler(UINT32 dwUserId, UINT32 dwAccessRights, void *pArg)
+bool NetObj::loadACLFromDB(DB_HANDLE hdb)
 {
-   TCHAR szQuery[256];
+   ObjectChildRows rows(hdb, OCT_ACL, m_id);
+   if (!rows.isValid())
+      return false;
 
-   _sntprintf(szQuery, sizeof(szQuery) / sizeof(TCHAR), _T("INSERT INTO acl (object_id,user_id,access_rights) VALUES (%d,%d,%d)"),
-           ((SAVE_PARAM *)pArg)->dwObjectId, dwUserId, dwAccessRights);
-   DBQuery(((SAVE_PARAM *)pArg)->hdb, szQuery);
+   for(int i = 0; i < rows.size(); i++)
+      m_accessList->addElement(rows.getFieldULong(i, 0), rows.getFieldULong(i, 1));
+
+   if (m_saveState != nullptr)
+   {
+      auto elements = new StructArray<ACL_ELEMENT>(16, 16);
+      m_accessList->enumerateElements(CollectAccessListElement, elements);
+      m_saveState->setAccessList(elements);
+   }
+   return true;
 }
 
 /**
- * Save ACL to database
+ * Save ACL to database. Only elements changed since last save are written.
  */
 bool NetObj::saveACLToDB(DB_HANDLE hdb)
 {
    if (!(m_modified & MODIFY_ACCESS_LIST))
       return true;
 
-   bool success = executeQueryOnObject(hdb, _T("DELETE FROM acl WHERE object_id=?"));
-   if (success)
+   auto elements = new StructArray<ACL_ELEMENT>(16, 16);
+   lockACL();
+   m_accessList->enumerateElements(CollectAccessListElement, elements);
+   unlockACL();
+
+   const StructArray<ACL_ELEMENT> *savedElements = (m_saveState != nullptr) ? m_saveState->accessList : nullptr;
+
+   bool success = true;
+   if (savedElements == nullptr)
+   {
+      success = executeQueryOnObject(hdb, _T("DELETE FROM acl WHERE object_id=?"));
+   }
+   else
    {
-      SAVE_PARAM sp;
-      sp.dwObjectId = m_id;
-      sp.hdb = hdb;
+      DB_STATEMENT hStmt = nullptr;
+      for(int i = 0; (i < savedElements->size()) && success; i++)
+      {
+         UINT32 userId = savedElements->get(i)->dwUserId;
+         if (FindAccessListElement(elements, userId) != nullptr)
+            continue;
 
-      lockACL();
-      m_accessList->enumerateElements(EnumerationHandler, &sp);
-      unlockACL();
+         if (hStmt == nullptr)
+         {
+            hStmt = DBPrepare(hdb, _T("DELETE FROM acl WHERE object_id=? AND user_id=?"), true);
+            if (hStmt == nullptr)
+            {
+               success = false;
+               break;
+            }
+            DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, m_id);
+         }
+         DBBind(hStmt, 2, DB_SQLTYPE_INTEGER, userId);
+         success = DBExecute(hStmt);
+      }
+      if (hStmt != nullptr)
+         DBFreeStatement(hStmt);
+   }
+
+   DB_STATEMENT hInsertStmt = nullptr, hUpdateStmt = nullptr;
+   for(int i = 0; (i < elements->size()) && success; i++)
+   {
+      const ACL_ELEMENT *e = elements->get(i);
+      const ACL_ELEMENT *saved = (savedElements != nullptr) ? FindAccessListElement(savedElements, e->dwUserId) : nullptr;
+      if ((saved != nullptr) && (saved->dwAccessRights == e->dwAccessRights))
+         continue;
+
+      DB_STATEMENT hStmt;
+      if (saved == nullptr)
+      {
+         if (hInsertStmt == nullptr)
+         {
+            hInsertStmt = DBPrepare(hdb, _T("INSERT INTO acl (access_rights,object_id,user_id) VALUES (?,?,?)"), true);
+            if (hInsertStmt == nullptr)
+            {
+               success = false;
+               break;
+            }
+         }
+         hStmt = hInsertStmt;
+      }
+      else
+      {
+         if (hUpdateStmt == nullptr)
+         {
+            hUpdateStmt = DBPrepare(hdb, _T("UPDATE acl SET access_rights=? WHERE object_id=? AND user_id=?"), true);
+            if (hUpdateStmt == nullptr)
+            {
+               success = false;
+               break;
+            }
+         }
+         hStmt = hUpdateStmt;
+      }
+      DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, e->dwAccessRights);
+      DBBind(hStmt, 2, DB_SQLTYPE_INTEGER, m_id);
+      DBBind(hStmt, 3, DB_SQLTYPE_INTEGER, e->dwUserId);
+      success = DBExecute(hStmt);
    }
+   if (hInsertStmt != nullptr)
+      DBFreeStatement(hInsertStmt);
+   if (hUpdateStmt != nullptr)
+      DBFreeStatement(hUpdateStmt);
+
+   if (success && (m_saveState != nullptr))
+      m_saveState->getPending()->setAccessList(elements);
+   else
+      delete elements;
    return success;
 }
 
@@ -1313,11 +2172,42 @@ void NetObj::setModified(UINT32 flags, bool notify)
    InterlockedOr(&m_modified, flags);
    m_timestamp = time(nullptr);
 
+   if (flags != 0)
+      enqueueForSync();
+
    // Send event to all connected clients
    if (notify && !m_isHidden && !m_isSystem)
       EnumerateClientSessions(BroadcastObjectChange, this);
 }
 
+/**
+ * Put object into syncer's modified objects queue if it is not there already.
+ * Objects without ID are not queued - they will be queued when ID is assigned.
+ */
+void NetObj::enqueueForSync()
+{
+   if ((m_id == 0) || (InterlockedCompareExchange(&m_syncQueued, 1, 0) != 0))
+      return;
+
+   shared_ptr<NetObj> object = self();
+   if (object != nullptr)
+      EnqueueModifiedObject(object);
+   else
+      m_syncQueued = 0;
+}
+
+/**
+ * Mark object as saved to database
+ */
+void NetObj::markAsSaved()
+{
+   m_modified = 0;
+   lockProperties();
+   if (m_saveState != nullptr)
+      m_saveState->commit();
+   unlockProperties();
+}
+
 /**
  * Modify object from NXCP message - common wrapper
  */
@@ -1765,6 +2655,21 @@ void NetObj::prepareForDeletion()
 {
 }
 
+/**
+ * Set object's name
+ */
+void NetObj::setName(const TCHAR *name)
+{
+   lockProperties();
+   _tcslcpy(m_name, name, MAX_OBJECT_NAME);
+   setModified(MODIFY_COMMON_PROPERTIES);
+   unlockProperties();
+
+   // Node name is used for binding syslog and SNMP trap sources to nodes
+   if (getObjectClass() == OBJECT_NODE)
+      static_cast<Node*>(this)->updateAttributeIndexes();
+}
+
 /**
  * Set object's comments.
  * NOTE: pszText should be dynamically allocated or NULL
@@ -1793,23 +2698,19 @@ void NetObj::commentsToMessage(NXCPMessage *pMsg)
  */
 bool NetObj::loadTrustedNodes(DB_HANDLE hdb)
 {
-	TCHAR query[256];
-	_sntprintf(query, 256, _T("SELECT target_node_id FROM trusted_nodes WHERE source_object_id=%d"), m_id);
-	DB_RESULT hResult = DBSelect(hdb, query);
-	if (hResult != NULL)
-	{
-		int count = DBGetNumRows(hResult);
-		if (count > 0)
-		{
-		   m_trustedNodes = new IntegerArray<UINT32>(count);
-			for(int i = 0; i < count; i++)
-			{
-				m_trustedNodes->add(DBGetFieldULong(hResult, i, 0));
-			}
-		}
-		DBFreeResult(hResult);
-	}
-	return (hResult != NULL);
+   ObjectChildRows rows(hdb, OCT_TRUSTED_NODES, m_id);
+   if (!rows.isValid())
+      return false;
+
+   if (rows.size() > 0)
+   {
+      m_trustedNodes = new IntegerArray<UINT32>(rows.size());
+      for(int i = 0; i < rows.size(); i++)
+      {
+         m_trustedNodes->add(rows.getFieldULong(i, 0));
+      }
+   }
+   return true;
 }
 
 /**
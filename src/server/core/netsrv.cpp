@@ -29,6 +29,7 @@ NetworkService::NetworkService() : super()
 {
    m_serviceType = NETSRV_HTTP;
    m_pollerNode = 0;
+   m_loadedHostNodeId = 0;
    m_proto = IPPROTO_TCP;
    m_port = 80;
    m_request = nullptr;
@@ -50,6 +51,7 @@ NetworkService::NetworkService(int iServiceType, WORD wProto, WORD wPort,
 {
    m_serviceType = iServiceType;
    m_pollerNode = dwPollerNode;
+   m_loadedHostNodeId = 0;
    m_proto = wProto;
    m_port = wPort;
    m_request = pszRequest;
@@ -138,7 +140,6 @@ bool NetworkService::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
 {
    TCHAR szQuery[256];
    DB_RESULT hResult;
-   UINT32 dwHostNodeId;
    bool bResult = false;
 
    m_id = dwId;
@@ -155,7 +156,7 @@ bool NetworkService::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
 
    if (DBGetNumRows(hResult) != 0)
    {
-      dwHostNodeId = DBGetFieldULong(hResult, 0, 0);
+      m_loadedHostNodeId = DBGetFieldULong(hResult, 0, 0);
       m_serviceType = DBGetFieldLong(hResult, 0, 1);
       m_ipAddress = DBGetFieldInetAddr(hResult, 0, 2);
       m_proto = (WORD)DBGetFieldULong(hResult, 0, 3);
@@ -165,37 +166,7 @@ bool NetworkService::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
       m_pollerNode = DBGetFieldULong(hResult, 0, 7);
       m_requiredPollCount = DBGetFieldULong(hResult, 0, 8);
 
-      // Link service to node
-      if (!m_isDeleted)
-      {
-         // Find host node
-         shared_ptr<NetObj> hostNode = static_pointer_cast<Node>(FindObjectById(dwHostNodeId, OBJECT_NODE));
-         if (hostNode != nullptr)
-         {
-            m_hostNode = static_pointer_cast<Node>(hostNode);
-            hostNode->addChild(self());
-            addParent(hostNode);
-            bResult = true;
-         }
-         else
-         {
-            nxlog_write(NXLOG_ERROR, _T("Inconsistent database: network service %s [%u] linked to non-existent node [%u]"), m_name, m_id, dwHostNodeId);
-         }
-
-         // Check that polling node ID is valid
-         if ((m_pollerNode != 0) && bResult)
-         {
-            if (FindObjectById(m_pollerNode, OBJECT_NODE) == nullptr)
-            {
-               nxlog_write(NXLOG_ERROR, _T("Inconsistent database: network service %s [%u] use non-existent poller node [%u]"), m_name, m_id, m_pollerNode);
-               bResult = false;
-            }
-         }
-      }
-      else
-      {
-         bResult = true;
-      }
+      bResult = true;
    }
 
    DBFreeResult(hResult);
@@ -206,6 +177,34 @@ bool NetworkService::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
    return bResult;
 }
 
+/**
+ * Link service to host node after loading from database. Called on main thread by startup object loader.
+ */
+bool NetworkService::linkAfterLoad()
+{
+   if (m_isDeleted)
+      return true;
+
+   shared_ptr<NetObj> hostNode = FindObjectById(m_loadedHostNodeId, OBJECT_NODE);
+   if (hostNode == nullptr)
+   {
+      nxlog_write(NXLOG_ERROR, _T("Inconsistent database: network service %s [%u] linked to non-existent node [%u]"), m_name, m_id, m_loadedHostNodeId);
+      return false;
+   }
+
+   // Check that polling node ID is valid
+   if ((m_pollerNode != 0) && (FindObjectById(m_pollerNode, OBJECT_NODE) == nullptr))
+   {
+      nxlog_write(NXLOG_ERROR, _T("Inconsistent database: network service %s [%u] use non-existent poller node [%u]"), m_name, m_id, m_pollerNode);
+      return false;
+   }
+
+   m_hostNode = static_pointer_cast<Node>(hostNode);
+   hostNode->addChild(self());
+   addParent(hostNode);
+   return true;
+}
+
 /**
  * Delete object from database
  */
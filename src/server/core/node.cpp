@@ -25,6 +25,10 @@
 #include <entity_mib.h>
 #include <ethernet_ip.h>
 
+#ifdef WITH_ZMQ
+#include "zeromq.h"
+#endif
+
 #define DEBUG_TAG_CONF_POLL      _T("poll.conf")
 #define DEBUG_TAG_AGENT          _T("node.agent")
 #define DEBUG_TAG_STATUS_POLL    _T("poll.status")
@@ -179,6 +183,7 @@ Node::Node() : super(), m_discoveryPollState(_T("discovery")),
    m_cipDeviceType = 0;
    m_cipState = 0;
    m_cipStatus = 0;
+   m_loadedSubnetIds = nullptr;
 }
 
 /**
@@ -296,6 +301,7 @@ Node::Node(const NewNodeData *newNodeData, UINT32 flags)  : super(), m_discovery
    m_cipDeviceType = 0;
    m_cipState = 0;
    m_cipStatus = 0;
+   m_loadedSubnetIds = nullptr;
 }
 
 /**
@@ -334,6 +340,7 @@ Node::~Node()
    MemFree(m_sysName);
    MemFree(m_sysContact);
    MemFree(m_sysLocation);
+   delete m_loadedSubnetIds;
    delete m_routingLoopEvents;
    MemFree(m_agentCertSubject);
    delete m_icmpStatCollectors;
@@ -528,7 +535,7 @@ bool Node::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
       return true;
    }
 
-   // Link node to subnets
+   // Read subnet list
    hStmt = DBPrepare(hdb, _T("SELECT subnet_id FROM nsmap WHERE node_id=?"));
    if (hStmt == nullptr)
       return false;
@@ -541,20 +548,13 @@ bool Node::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
       return false;     // Query failed
    }
 
+   // Actual linking is done by linkAfterLoad() on main thread
    iNumRows = DBGetNumRows(hResult);
-   for(i = 0; i < iNumRows; i++)
+   if (iNumRows > 0)
    {
-      uint32_t subnetId = DBGetFieldULong(hResult, i, 0);
-      shared_ptr<NetObj> subnet = FindObjectById(subnetId, OBJECT_SUBNET);
-      if (subnet != nullptr)
-      {
-         subnet->addChild(self());
-         addParent(subnet);
-      }
-      else
-      {
-         nxlog_write(NXLOG_ERROR, _T("Inconsistent database: node %s [%u] linked to non-existing subnet [%u]"), m_name, m_id, subnetId);
-      }
+      m_loadedSubnetIds = new IntegerArray<UINT32>(iNumRows);
+      for(i = 0; i < iNumRows; i++)
+         m_loadedSubnetIds->add(DBGetFieldULong(hResult, i, 0));
    }
 
    DBFreeResult(hResult);
@@ -788,6 +788,33 @@ bool Node::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
    return bResult;
 }
 
+/**
+ * Link node to subnets after loading from database. Called on main thread by startup object loader.
+ */
+bool Node::linkAfterLoad()
+{
+   if (m_loadedSubnetIds == nullptr)
+      return true;
+
+   for(int i = 0; i < m_loadedSubnetIds->size(); i++)
+   {
+      UINT32 subnetId = m_loadedSubnetIds->get(i);
+      shared_ptr<NetObj> subnet = FindObjectById(subnetId, OBJECT_SUBNET);
+      if (subnet != nullptr)
+      {
+         subnet->addChild(self());
+         addParent(subnet);
+      }
+      else
+      {
+         nxlog_write(NXLOG_ERROR, _T("Inconsistent database: node %s [%u] linked to non-existing subnet [%u]"), m_name, m_id, subnetId);
+      }
+   }
+
+   delete_and_null(m_loadedSubnetIds);
+   return true;
+}
+
 /**
  * Save component
  */
@@ -2362,7 +2389,9 @@ void Node::statusPoll(PollerInfo *poller, ClientSession *pSession, UINT32 rqId)
       {
          nxlog_debug_tag(DEBUG_TAG_STATUS_POLL, 6, _T("StatusPoll(%s): using ICMP ping on primary IP address"), m_name);
          sendPollerMsg(rqId, _T("Checking primary IP address with ICMP ping\r\n"));
-         if (IcmpPing(m_ipAddress, 3, g_icmpPingTimeout, nullptr, g_icmpPingSize, false) == ICMP_SUCCESS)
+         IcmpPingTarget target;
+         target.addr = m_ipAddress;
+         if (IcmpPingMultiple(&target, 1, 3, g_icmpPingTimeout, g_icmpPingSize, false) > 0)
          {
             nxlog_debug_tag(DEBUG_TAG_STATUS_POLL, 6, _T("StatusPoll(%s): primary IP address responds to ICMP ping, considering node as reachable"), m_name);
             sendPollerMsg(rqId, POLLER_INFO _T("   Primary IP address is responding to ICMP ping\r\n"));
@@ -3529,6 +3558,9 @@ void Node::configurationPoll(PollerInfo *poller, ClientSession *session, UINT32
          modified |= MODIFY_NODE_PROPERTIES;
       }
 
+      // sysName, LLDP ID, bridge ID, or agent ID could be changed by capability check
+      updateAttributeIndexes();
+
       // Retrieve interface list
       poller->setStatus(_T("interface check"));
       sendPollerMsg(rqId, _T("Capability check finished\r\n"));
@@ -6492,10 +6524,60 @@ DataCollectionError Node::getInternalMetric(const TCHAR *param, size_t bufSize,
       {
          ret_uint64(buffer, GetDCICacheMemoryUsage());
       }
+      else if (!_tcsicmp(param, _T("Server.MemoryUsage.DBWriterQueue")))
+      {
+         uint64_t count, bytes;
+         if (GetMemoryAccountingCounters(MemoryAccountingTag::DB_WRITER_QUEUE, &count, &bytes))
+            ret_uint64(buffer, bytes);
+         else
+            rc = DCE_NOT_SUPPORTED;
+      }
+      else if (!_tcsicmp(param, _T("Server.MemoryUsage.Events")))
+      {
+         uint64_t count, bytes;
+         if (GetMemoryAccountingCounters(MemoryAccountingTag::EVENTS, &count, &bytes))
+            ret_uint64(buffer, bytes);
+         else
+            rc = DCE_NOT_SUPPORTED;
+      }
+      else if (!_tcsicmp(param, _T("Server.MemoryUsage.NXCPMessages")))
+      {
+         uint64_t count, bytes;
+         if (GetMemoryAccountingCounters(MemoryAccountingTag::NXCP_MESSAGES, &count, &bytes))
+            ret_uint64(buffer, bytes);
+         else
+            rc = DCE_NOT_SUPPORTED;
+      }
+      else if (!_tcsicmp(param, _T("Server.MemoryUsage.Objects")))
+      {
+         uint64_t count, bytes;
+         if (GetMemoryAccountingCounters(MemoryAccountingTag::OBJECTS, &count, &bytes))
+            ret_uint64(buffer, bytes);
+         else
+            rc = DCE_NOT_SUPPORTED;
+      }
+      else if (MatchString(_T("Server.MemoryUsage.Objects(*)"), param, false))
+      {
+         TCHAR className[64];
+         AgentGetParameterArg(param, 1, className, 64);
+         uint64_t count, bytes;
+         if (GetObjectMemoryAccountingCounters(className, &count, &bytes))
+            ret_uint64(buffer, bytes);
+         else
+            rc = DCE_NOT_SUPPORTED;
+      }
       else if (!_tcsicmp(param, _T("Server.MemoryUsage.RawDataWriter")))
       {
          ret_uint64(buffer, GetRawDataWriterMemoryUsage());
       }
+      else if (!_tcsicmp(param, _T("Server.MemoryUsage.ScriptVM")))
+      {
+         uint64_t count, bytes;
+         if (GetMemoryAccountingCounters(MemoryAccountingTag::SCRIPT_VM, &count, &bytes))
+            ret_uint64(buffer, bytes);
+         else
+            rc = DCE_NOT_SUPPORTED;
+      }
       else if (!_tcsicmp(param, _T("Server.ObjectCount.Clusters")))
       {
          ret_uint(buffer, static_cast<uint32_t>(g_idxClusterById.size()));
@@ -6552,6 +6634,24 @@ DataCollectionError Node::getInternalMetric(const TCHAR *param, size_t bufSize,
       {
          ret_int64(buffer, GetSyncerRunTime(StatisticType::MIN));
       }
+      else if (!_tcsicmp(param, _T("Server.SyslogProcessor.DroppedMessages")))
+      {
+         uint64_t queueDrops, socketDrops, queueLimit;
+         GetSyslogReceiverStats(&queueDrops, &socketDrops, &queueLimit);
+         ret_uint64(buffer, queueDrops);
+      }
+      else if (!_tcsicmp(param, _T("Server.SyslogProcessor.QueueLimit")))
+      {
+         uint64_t queueDrops, socketDrops, queueLimit;
+         GetSyslogReceiverStats(&queueDrops, &socketDrops, &queueLimit);
+         ret_uint64(buffer, queueLimit);
+      }
+      else if (!_tcsicmp(param, _T("Server.SyslogReceiver.DroppedMessages")))
+      {
+         uint64_t queueDrops, socketDrops, queueLimit;
+         GetSyslogReceiverStats(&queueDrops, &socketDrops, &queueLimit);
+         ret_uint64(buffer, socketDrops);
+      }
       else if (MatchString(_T("Server.ThreadPool.ActiveRequests(*)"), param, false))
       {
          rc = GetThreadPoolStat(THREAD_POOL_ACTIVE_REQUESTS, param, buffer);
@@ -6592,6 +6692,26 @@ DataCollectionError Node::getInternalMetric(const TCHAR *param, size_t bufSize,
       {
          rc = GetThreadPoolStat(THREAD_POOL_USAGE, param, buffer);
       }
+#ifdef WITH_ZMQ
+      else if (!_tcsicmp(param, _T("Server.ZeroMQ.DroppedMessages")))
+      {
+         uint64_t messagesSent, queueDrops, sendFailures;
+         GetZmqPublisherStats(&messagesSent, &queueDrops, &sendFailures);
+         ret_uint64(buffer, queueDrops);
+      }
+      else if (!_tcsicmp(param, _T("Server.ZeroMQ.MessagesSent")))
+      {
+         uint64_t messagesSent, queueDrops, sendFailures;
+         GetZmqPublisherStats(&messagesSent, &queueDrops, &sendFailures);
+         ret_uint64(buffer, messagesSent);
+      }
+      else if (!_tcsicmp(param, _T("Server.ZeroMQ.SendFailures")))
+      {
+         uint64_t messagesSent, queueDrops, sendFailures;
+         GetZmqPublisherStats(&messagesSent, &queueDrops, &sendFailures);
+         ret_uint64(buffer, sendFailures);
+      }
+#endif
       else if (!_tcsicmp(param, _T("Server.TotalEventsProcessed")))
       {
          _sntprintf(buffer, bufSize, UINT64_FMT, g_totalEventsProcessed);
@@ -7104,6 +7224,16 @@ UINT32 Node::modifyFromMessageInternal(NXCPMessage *pRequest)
    return super::modifyFromMessageInternal(pRequest);
 }
 
+/**
+ * Modify object from NXCP message - stage 2 (called without properties lock)
+ */
+UINT32 Node::modifyFromMessageInternalStage2(NXCPMessage *pRequest)
+{
+   if (pRequest->isFieldExist(VID_PRIMARY_NAME) || pRequest->isFieldExist(VID_IP_ADDRESS) || pRequest->isFieldExist(VID_OBJECT_NAME))
+      updateAttributeIndexes();
+   return super::modifyFromMessageInternalStage2(pRequest);
+}
+
 /**
  * Thread pool callback executed when SNMP proxy changes
  */
@@ -7585,6 +7715,8 @@ void Node::changeIPAddress(const InetAddress& ipAddr)
    }
    unlockProperties();
 
+   updateAttributeIndexes();
+
    agentLock();
    deleteAgentConnection();
    agentUnlock();
@@ -7592,6 +7724,34 @@ void Node::changeIPAddress(const InetAddress& ipAddr)
    _pollerUnlock();
 }
 
+/**
+ * Update secondary indexes used for node lookup by sysName, LLDP ID, bridge ID, agent ID, host name,
+ * and object name with current attribute values. Should be called without properties lock.
+ */
+void Node::updateAttributeIndexes()
+{
+   TCHAR buffer[MAX_DNS_NAME], name[MAX_OBJECT_NAME];
+
+   lockProperties();
+   g_idxNodeBySysName.update(m_id, m_sysName);
+   g_idxNodeByLLDPId.update(m_id, m_lldpNodeId);
+   g_idxNodeByBridgeId.update(m_id, (m_capabilities & NC_IS_BRIDGE) ? MacAddress(m_baseBridgeAddress, MAC_ADDR_LENGTH).toString(buffer) : nullptr);
+   g_idxNodeByAgentId.update(m_id, !m_agentId.isNull() ? m_agentId.toString(buffer) : nullptr);
+   _tcslcpy(buffer, m_primaryHostName, MAX_DNS_NAME);
+   _tcslcpy(name, m_name, MAX_OBJECT_NAME);
+   unlockProperties();
+
+   _tcsupr(buffer);
+   _tcsupr(name);
+   bool changed = g_idxNodeByHostname.update(m_id, buffer);
+   if (g_idxNodeByName.update(m_id, name))
+      changed = true;
+
+   // Syslog messages and traps could be bound to nodes by name
+   if (changed)
+      InvalidateSourceBindingCaches();
+}
+
 /**
  * Change node's zone
  */
@@ -8311,8 +8471,11 @@ BOOL Node::resolveName(BOOL useOnlyDNS)
    }
 
    if (bSuccess)
+   {
       DbgPrintf(4, _T("Name for node %d was resolved to %s%s"), m_id, m_name,
          bNameTruncated ? _T(" (truncated to host)") : _T(""));
+      updateAttributeIndexes();
+   }
    else
       DbgPrintf(4, _T("Name for node %d was not resolved"), m_id);
    return bSuccess;
@@ -10290,10 +10453,31 @@ void Node::icmpPoll(PollerInfo *poller)
       }
    }
 
-   for(int i = 0; i < targets.size(); i++)
+   if (conn != nullptr)
    {
-      const IcmpPollTarget *t = targets.get(i);
-      icmpPollAddress(conn.get(), t->name, t->address);
+      for(int i = 0; i < targets.size(); i++)
+      {
+         const IcmpPollTarget *t = targets.get(i);
+         icmpPollAddress(conn.get(), t->name, t->address);
+      }
+   }
+   else if (!targets.isEmpty())
+   {
+      // Not using ICMP proxy - send requests to all targets at once via shared pinger
+      IcmpPingTarget *pingTargets = new IcmpPingTarget[targets.size()];
+      for(int i = 0; i < targets.size(); i++)
+         pingTargets[i].addr = targets.get(i)->address;
+      nxlog_debug_tag(DEBUG_TAG_ICMP_POLL, 7, _T("Node::icmpPoll(%s [%u]): pinging %d targets (timeout=%u, size=%u)"),
+               m_name, m_id, targets.size(), g_icmpPingTimeout, g_icmpPingSize);
+      IcmpPingMultiple(pingTargets, targets.size(), 1, g_icmpPingTimeout, g_icmpPingSize, false);
+      for(int i = 0; i < targets.size(); i++)
+      {
+         const IcmpPollTarget *t = targets.get(i);
+         nxlog_debug_tag(DEBUG_TAG_ICMP_POLL, 7, _T("Node::icmpPoll(%s [%u]): target %s: ping status=%u RTT=%u"),
+                  m_name, m_id, t->name, pingTargets[i].result, pingTargets[i].rtt);
+         updateIcmpStatCollector(t->name, pingTargets[i].result, pingTargets[i].rtt);
+      }
+      delete[] pingTargets;
    }
 
 end_poll:
@@ -10301,7 +10485,7 @@ void Node::icmpPoll(PollerInfo *poller)
 }
 
 /**
- * Poll specific address with ICMP
+ * Poll specific address with ICMP via proxy agent
  */
 void Node::icmpPollAddress(AgentConnection *conn, const TCHAR *target, const InetAddress& addr)
 {
@@ -10309,55 +10493,53 @@ void Node::icmpPollAddress(AgentConnection *conn, const TCHAR *target, const Ine
    _sntprintf(debugPrefix, 256, _T("Node::icmpPollAddress(%s [%u], %s, %s):"), m_name, m_id, target, addr.toString(buffer));
 
    UINT32 status = ICMP_SEND_FAILED, rtt = 0;
-   if (conn != nullptr)
+   TCHAR parameter[128];
+   _sntprintf(parameter, 128, _T("Icmp.Ping(%s)"), addr.toString(buffer));
+   UINT32 rcc = conn->getParameter(parameter, buffer, 64);
+   if (rcc == ERR_SUCCESS)
    {
-      TCHAR parameter[128];
-      _sntprintf(parameter, 128, _T("Icmp.Ping(%s)"), addr.toString(buffer));
-      UINT32 rcc = conn->getParameter(parameter, buffer, 64);
-      if (rcc == ERR_SUCCESS)
+      nxlog_debug_tag(DEBUG_TAG_ICMP_POLL, 7, _T("%s: proxy response: \"%s\""), debugPrefix, buffer);
+      TCHAR *eptr;
+      rtt = _tcstol(buffer, &eptr, 10);
+      if (*eptr == 0)
       {
-         nxlog_debug_tag(DEBUG_TAG_ICMP_POLL, 7, _T("%s: proxy response: \"%s\""), debugPrefix, buffer);
-         TCHAR *eptr;
-         rtt = _tcstol(buffer, &eptr, 10);
-         if (*eptr == 0)
-         {
-            status = ICMP_SUCCESS;
-         }
+         status = ICMP_SUCCESS;
       }
-      else if (rcc == ERR_REQUEST_TIMEOUT)
-      {
-         status = ICMP_TIMEOUT;
-         rtt = 10000;
-      }
-      nxlog_debug_tag(DEBUG_TAG_ICMP_POLL, 7, _T("%s: response time %u"), debugPrefix, rtt);
    }
-   else  // not using ICMP proxy
+   else if (rcc == ERR_REQUEST_TIMEOUT)
    {
-      nxlog_debug_tag(DEBUG_TAG_ICMP_POLL, 7, _T("%s: calling IcmpPing(%s,3,%d,%d)"),
-               debugPrefix, addr.toString(buffer), g_icmpPingTimeout, g_icmpPingSize);
-      status = IcmpPing(addr, 1, g_icmpPingTimeout, &rtt, g_icmpPingSize, false);
-      nxlog_debug_tag(DEBUG_TAG_ICMP_POLL, 7, _T("%s: ping status=%u RTT=%u"), debugPrefix, status, rtt);
+      status = ICMP_TIMEOUT;
+      rtt = 10000;
    }
+   nxlog_debug_tag(DEBUG_TAG_ICMP_POLL, 7, _T("%s: response time %u"), debugPrefix, rtt);
 
-   if ((status == ICMP_SUCCESS) || (status == ICMP_TIMEOUT) || (status == ICMP_UNREACHABLE))
-   {
-      lockProperties();
+   updateIcmpStatCollector(target, status, rtt);
+}
 
-      if (m_icmpStatCollectors == nullptr)
-         m_icmpStatCollectors = new StringObjectMap<IcmpStatCollector>(Ownership::True);
+/**
+ * Update ICMP statistic collector for given target with ping result
+ */
+void Node::updateIcmpStatCollector(const TCHAR *target, UINT32 status, UINT32 rtt)
+{
+   if ((status != ICMP_SUCCESS) && (status != ICMP_TIMEOUT) && (status != ICMP_UNREACHABLE))
+      return;
 
-      IcmpStatCollector *collector = m_icmpStatCollectors->get(target);
-      if (collector == nullptr)
-      {
-         collector = new IcmpStatCollector(ConfigReadInt(_T("ICMP.StatisticPeriod"), 60));
-         m_icmpStatCollectors->set(target, collector);
-         nxlog_debug_tag(DEBUG_TAG_ICMP_POLL, 7, _T("%s: new collector object created"), debugPrefix);
-      }
+   lockProperties();
 
-      collector->update((status == ICMP_SUCCESS) ? rtt : 10000);
+   if (m_icmpStatCollectors == nullptr)
+      m_icmpStatCollectors = new StringObjectMap<IcmpStatCollector>(Ownership::True);
 
-      unlockProperties();
+   IcmpStatCollector *collector = m_icmpStatCollectors->get(target);
+   if (collector == nullptr)
+   {
+      collector = new IcmpStatCollector(ConfigReadInt(_T("ICMP.StatisticPeriod"), 60));
+      m_icmpStatCollectors->set(target, collector);
+      nxlog_debug_tag(DEBUG_TAG_ICMP_POLL, 7, _T("Node::updateIcmpStatCollector(%s [%u], %s): new collector object created"), m_name, m_id, target);
    }
+
+   collector->update((status == ICMP_SUCCESS) ? rtt : 10000);
+
+   unlockProperties();
 }
 
 /**
@@ -328,7 +328,9 @@ static bool HostIsReachable(const InetAddress& ipAddr, int32_t zoneUIN, bool ful
 	}
 	else	// not using ICMP proxy
 	{
-		if (IcmpPing(ipAddr, 3, g_icmpPingTimeout, nullptr, g_icmpPingSize, false) == ICMP_SUCCESS)
+		IcmpPingTarget target;
+		target.addr = ipAddr;
+		if (IcmpPingMultiple(&target, 1, 3, g_icmpPingTimeout, g_icmpPingSize, false) > 0)
 			reachable = true;
 	}
 
@@ -1725,6 +1725,15 @@ NXSL_ServerEnv::NXSL_ServerEnv() : NXSL_Environment()
    if (g_flags & AF_ENABLE_NXSL_FILE_IO_FUNCTIONS)
       registerIOFunctions();
    CALL_ALL_MODULES(pfNXSLServerEnvConfig, (this));
+   MemoryAccountingAdd(MemoryAccountingTag::SCRIPT_VM, sizeof(NXSL_VM) + sizeof(NXSL_ServerEnv));
+}
+
+/**
+ * Destructor for server default script environment
+ */
+NXSL_ServerEnv::~NXSL_ServerEnv()
+{
+   MemoryAccountingRemove(MemoryAccountingTag::SCRIPT_VM, sizeof(NXSL_VM) + sizeof(NXSL_ServerEnv));
 }
 
 /**
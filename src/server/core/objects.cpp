@@ -26,7 +26,7 @@
 /**
  * Global data
  */
-BOOL g_bModificationsLocked = FALSE;
+BOOL NXCORE_EXPORTABLE g_bModificationsLocked = FALSE;
 
 shared_ptr<Network> NXCORE_EXPORTABLE g_entireNetwork;
 shared_ptr<ServiceRoot> NXCORE_EXPORTABLE g_infrastructureServiceRoot;
@@ -42,7 +42,7 @@ ObjectQueue<TemplateUpdateTask> g_templateUpdateQueue(256, Ownership::True);
 ObjectIndex g_idxObjectById;
 HashIndex<uuid> g_idxObjectByGUID;
 ObjectIndex g_idxSubnetById;
-InetAddressIndex g_idxSubnetByAddr;
+InetAddressIndex g_idxSubnetByAddr(true);
 InetAddressIndex g_idxInterfaceByAddr;
 ObjectIndex g_idxZoneByUIN;
 ObjectIndex g_idxNodeById;
@@ -55,6 +55,14 @@ ObjectIndex g_idxServiceCheckById;
 ObjectIndex g_idxNetMapById;
 ObjectIndex g_idxChassisById;
 ObjectIndex g_idxSensorById;
+StringAttributeIndex g_idxNodeBySysName;
+StringAttributeIndex g_idxNodeByLLDPId;
+StringAttributeIndex g_idxNodeByBridgeId;
+StringAttributeIndex g_idxNodeByAgentId;
+StringAttributeIndex g_idxNodeByHostname;
+StringAttributeIndex g_idxNodeByName;
+StringAttributeIndex g_idxInterfaceByDescription;
+StringAttributeIndex g_idxMobileDeviceByDeviceId;
 
 /**
  * Static data
@@ -288,6 +296,7 @@ void NetObjInsert(const shared_ptr<NetObj>& object, bool newObject, bool importe
 
 	g_idxObjectById.put(object->getId(), object);
 	g_idxObjectByGUID.put(object->getGuid(), object);
+	MemoryAccountingAddObject(object.get());
 
    if (!object->isDeleted())
    {
@@ -314,6 +323,7 @@ void NetObjInsert(const shared_ptr<NetObj>& object, bool newObject, bool importe
             break;
          case OBJECT_NODE:
 				g_idxNodeById.put(object->getId(), object);
+				static_cast<Node&>(*object).updateAttributeIndexes();
             if (!(static_cast<Node&>(*object).getFlags() & NF_REMOTE_AGENT))
             {
 			      if (IsZoningEnabled())
@@ -341,6 +351,7 @@ void NetObjInsert(const shared_ptr<NetObj>& object, bool newObject, bool importe
             break;
 			case OBJECT_MOBILEDEVICE:
 				g_idxMobileDeviceById.put(object->getId(), object);
+				g_idxMobileDeviceByDeviceId.update(object->getId(), static_cast<MobileDevice&>(*object).getDeviceId());
             break;
 			case OBJECT_ACCESSPOINT:
 				g_idxAccessPointById.put(object->getId(), object);
@@ -378,6 +389,7 @@ void NetObjInsert(const shared_ptr<NetObj>& object, bool newObject, bool importe
             }
             break;
          case OBJECT_INTERFACE:
+            g_idxInterfaceByDescription.update(object->getId(), static_cast<Interface&>(*object).getDescription());
             if (!static_cast<Interface&>(*object).isExcludedFromTopology())
             {
 					if (IsZoningEnabled())
@@ -474,6 +486,13 @@ void NetObjDeleteFromIndexes(const NetObj& object)
 			break;
       case OBJECT_NODE:
 			g_idxNodeById.remove(object.getId());
+			g_idxNodeBySysName.remove(object.getId());
+			g_idxNodeByLLDPId.remove(object.getId());
+			g_idxNodeByBridgeId.remove(object.getId());
+			g_idxNodeByAgentId.remove(object.getId());
+			g_idxNodeByHostname.remove(object.getId());
+			g_idxNodeByName.remove(object.getId());
+			InvalidateSourceBindingCaches();
          if (!(static_cast<const Node&>(object).getFlags() & NF_REMOTE_AGENT))
          {
 			   if (IsZoningEnabled())
@@ -501,6 +520,7 @@ void NetObjDeleteFromIndexes(const NetObj& object)
          break;
       case OBJECT_MOBILEDEVICE:
 			g_idxMobileDeviceById.remove(object.getId());
+			g_idxMobileDeviceByDeviceId.remove(object.getId());
          break;
 		case OBJECT_ACCESSPOINT:
 			g_idxAccessPointById.remove(object.getId());
@@ -533,6 +553,7 @@ void NetObjDeleteFromIndexes(const NetObj& object)
          }
          break;
       case OBJECT_INTERFACE:
+         g_idxInterfaceByDescription.remove(object.getId());
 			if (IsZoningEnabled())
 			{
 				shared_ptr<Zone> zone = FindZoneByUIN(static_cast<const Interface&>(object).getZoneUIN());
@@ -605,13 +626,49 @@ shared_ptr<AccessPoint> NXCORE_EXPORTABLE FindAccessPointByMAC(const MacAddress&
    return static_pointer_cast<AccessPoint>(object);
 }
 
+/**
+ * Find object using attribute index. Candidate objects from attribute index are checked with comparator
+ * to filter out objects with outdated index entries.
+ */
+template<typename C> static shared_ptr<NetObj> FindObjectByAttribute(const StringAttributeIndex& attrIndex, const TCHAR *key,
+         ObjectIndex& index, bool (*comparator)(NetObj *, C *), C *context)
+{
+   IntegerArray<uint32_t> candidates(16, 16);
+   attrIndex.get(key, &candidates);
+   for(int i = 0; i < candidates.size(); i++)
+   {
+      shared_ptr<NetObj> object = index.get(candidates.get(i));
+      if ((object != nullptr) && comparator(object.get(), context))
+         return object;
+   }
+   return shared_ptr<NetObj>();
+}
+
+/**
+ * Find all objects matching given key using attribute index
+ */
+template<typename C> static SharedObjectArray<NetObj> *FindObjectsByAttribute(const StringAttributeIndex& attrIndex, const TCHAR *key,
+         ObjectIndex& index, bool (*comparator)(NetObj *, C *), C *context)
+{
+   IntegerArray<uint32_t> candidates(16, 16);
+   attrIndex.get(key, &candidates);
+   SharedObjectArray<NetObj> *objects = new SharedObjectArray<NetObj>(candidates.size(), 16);
+   for(int i = 0; i < candidates.size(); i++)
+   {
+      shared_ptr<NetObj> object = index.get(candidates.get(i));
+      if ((object != nullptr) && comparator(object.get(), context))
+         objects->add(object);
+   }
+   return objects;
+}
+
 /**
  * Mobile device id comparator
  */
-static bool DeviceIdComparator(NetObj *object, void *deviceId)
+static bool DeviceIdComparator(NetObj *object, const TCHAR *deviceId)
 {
 	return ((object->getObjectClass() == OBJECT_MOBILEDEVICE) && !object->isDeleted() &&
-		     !_tcscmp((const TCHAR *)deviceId, ((MobileDevice *)object)->getDeviceId()));
+		     !_tcscmp(deviceId, static_cast<MobileDevice*>(object)->getDeviceId()));
 }
 
 /**
@@ -622,7 +679,7 @@ shared_ptr<MobileDevice> NXCORE_EXPORTABLE FindMobileDeviceByDeviceID(const TCHA
 	if ((deviceId == nullptr) || (*deviceId == 0))
 		return shared_ptr<MobileDevice>();
 
-	return static_pointer_cast<MobileDevice>(g_idxMobileDeviceById.find(DeviceIdComparator, (void *)deviceId));
+	return static_pointer_cast<MobileDevice>(FindObjectByAttribute(g_idxMobileDeviceByDeviceId, deviceId, g_idxMobileDeviceById, DeviceIdComparator, deviceId));
 }
 
 /**
@@ -803,6 +860,7 @@ struct NodeFindHostnameData
 {
    int32_t zoneUIN;
    TCHAR hostname[MAX_DNS_NAME];
+   IntegerArray<uint32_t> *candidates;
 };
 
 /**
@@ -819,6 +877,19 @@ static bool HostnameComparator(NetObj *object, NodeFindHostnameData *data)
    return (_tcsstr(primaryName, data->hostname) != nullptr) && (!IsZoningEnabled() || (static_cast<Node*>(object)->getZoneUIN() == data->zoneUIN));
 }
 
+/**
+ * Collect candidate nodes from host name index (index keys are in upper case)
+ */
+static EnumerationCallbackResult CollectHostnameCandidates(const TCHAR *key, const IntegerArray<uint32_t> *objects, NodeFindHostnameData *data)
+{
+   if (_tcsstr(key, data->hostname) != nullptr)
+   {
+      for(int i = 0; i < objects->size(); i++)
+         data->candidates->add(objects->get(i));
+   }
+   return _CONTINUE;
+}
+
 /**
  * Find a list of nodes that contain the hostname
  */
@@ -828,25 +899,39 @@ SharedObjectArray<NetObj> NXCORE_EXPORTABLE *FindNodesByHostname(int32_t zoneUIN
    data.zoneUIN = zoneUIN;
    _tcslcpy(data.hostname, hostname, MAX_DNS_NAME);
    _tcsupr(data.hostname);
-   SharedObjectArray<NetObj> *nodes = g_idxNodeById.findAll(HostnameComparator, &data);
+
+   // Substring match is done on distinct host names from index rather than on each node
+   IntegerArray<uint32_t> candidates(64, 64);
+   data.candidates = &candidates;
+   g_idxNodeByHostname.forEach(CollectHostnameCandidates, &data);
+
+   SharedObjectArray<NetObj> *nodes = new SharedObjectArray<NetObj>(candidates.size(), 16);
+   for(int i = 0; i < candidates.size(); i++)
+   {
+      shared_ptr<NetObj> node = g_idxNodeById.get(candidates.get(i));
+      if ((node != nullptr) && HostnameComparator(node.get(), &data))
+         nodes->add(node);
+   }
    return nodes;
 }
 
 /**
  * Interface description comparator
  */
-static bool DescriptionComparator(NetObj *object, void *description)
+static bool DescriptionComparator(NetObj *object, const TCHAR *description)
 {
 	return ((object->getObjectClass() == OBJECT_INTERFACE) && !object->isDeleted() &&
-	        !_tcscmp((const TCHAR *)description, ((Interface *)object)->getDescription()));
+	        !_tcscmp(description, static_cast<Interface*>(object)->getDescription()));
 }
 
 /**
  * Find interface by description
  */
-shared_ptr<Interface> NXCORE_EXPORTABLE FindInterfaceByDescription(const TCHAR *description, bool updateRefCount)
+shared_ptr<Interface> NXCORE_EXPORTABLE FindInterfaceByDescription(const TCHAR *description)
 {
-	return static_pointer_cast<Interface>(g_idxObjectById.find(DescriptionComparator, (void *)description));
+   if ((description == nullptr) || (*description == 0))
+      return shared_ptr<Interface>();
+	return static_pointer_cast<Interface>(FindObjectByAttribute(g_idxInterfaceByDescription, description, g_idxObjectById, DescriptionComparator, description));
 }
 
 /**
@@ -863,7 +948,9 @@ static bool LldpIdComparator(NetObj *object, const TCHAR *lldpId)
  */
 shared_ptr<Node> NXCORE_EXPORTABLE FindNodeByLLDPId(const TCHAR *lldpId)
 {
-	return static_pointer_cast<Node>(g_idxNodeById.find(LldpIdComparator, lldpId));
+   if ((lldpId == nullptr) || (*lldpId == 0))
+      return shared_ptr<Node>();
+	return static_pointer_cast<Node>(FindObjectByAttribute(g_idxNodeByLLDPId, lldpId, g_idxNodeById, LldpIdComparator, lldpId));
 }
 
 /**
@@ -884,7 +971,7 @@ shared_ptr<Node> NXCORE_EXPORTABLE FindNodeBySysName(const TCHAR *sysName)
       return shared_ptr<Node>();
 
    // return nullptr if multiple nodes with same sysName found
-   SharedObjectArray<NetObj> *objects = g_idxNodeById.findAll(SysNameComparator, sysName);
+   SharedObjectArray<NetObj> *objects = FindObjectsByAttribute(g_idxNodeBySysName, sysName, g_idxNodeById, SysNameComparator, sysName);
    shared_ptr<Node> node = (objects->size() == 1) ? static_pointer_cast<Node>(objects->getShared(0)) : shared_ptr<Node>();
    delete objects;
    return node;
@@ -903,7 +990,9 @@ static bool BridgeIdComparator(NetObj *object, const BYTE *bridgeId)
  */
 shared_ptr<Node> NXCORE_EXPORTABLE FindNodeByBridgeId(const BYTE *bridgeId)
 {
-	return static_pointer_cast<Node>(g_idxNodeById.find(BridgeIdComparator, bridgeId));
+   TCHAR key[64];
+   MacAddress(bridgeId, MAC_ADDR_LENGTH).toString(key);
+	return static_pointer_cast<Node>(FindObjectByAttribute(g_idxNodeByBridgeId, key, g_idxNodeById, BridgeIdComparator, bridgeId));
 }
 
 /**
@@ -921,7 +1010,10 @@ shared_ptr<Node> NXCORE_EXPORTABLE FindNodeByAgentId(const uuid& agentId)
 {
    if (agentId.isNull())
       return shared_ptr<Node>();
-   return static_pointer_cast<Node>(g_idxNodeById.find(AgentIdComparator, &agentId));
+
+   TCHAR key[64];
+   agentId.toString(key);
+   return static_pointer_cast<Node>(FindObjectByAttribute(g_idxNodeByAgentId, key, g_idxNodeById, AgentIdComparator, &agentId));
 }
 
 /**
@@ -967,59 +1059,27 @@ shared_ptr<Subnet> NXCORE_EXPORTABLE FindSubnetByIP(int32_t zoneUIN, const InetA
 }
 
 /**
- * Subnet matching data
- */
-struct SubnetMatchingData
-{
-   InetAddress ipAddr; // IP address to find subnet for
-   int maskLen;        // Current match mask length
-   shared_ptr<Subnet> subnet;     // search result
-
-   SubnetMatchingData(const InetAddress& _ipAddr) : ipAddr(_ipAddr)
-   {
-      maskLen = -1;
-   }
-};
-
-/**
- * Subnet matching callback
- */
-static void SubnetMatchCallback(const InetAddress& addr, NetObj *object, void *context)
-{
-   SubnetMatchingData *data = static_cast<SubnetMatchingData*>(context);
-   if (static_cast<Subnet*>(object)->getIpAddress().contain(data->ipAddr))
-   {
-      int maskLen = static_cast<Subnet*>(object)->getIpAddress().getMaskBits();
-      if (maskLen > data->maskLen)
-      {
-         data->maskLen = maskLen;
-         data->subnet = static_cast<Subnet*>(object)->self();
-      }
-   }
-}
-
-/**
- * Find subnet for given IP address
+ * Find subnet for given IP address (subnet with longest prefix containing given address)
  */
 shared_ptr<Subnet> NXCORE_EXPORTABLE FindSubnetForNode(int32_t zoneUIN, const InetAddress& nodeAddr)
 {
    if (!nodeAddr.isValidUnicast())
       return shared_ptr<Subnet>();
 
-   SubnetMatchingData matchData(nodeAddr);
+   shared_ptr<Subnet> subnet;
    if (IsZoningEnabled())
    {
       shared_ptr<Zone> zone = FindZoneByUIN(zoneUIN);
       if (zone != nullptr)
       {
-         zone->forEachSubnet(SubnetMatchCallback, &matchData);
+         subnet = zone->findSubnetForAddress(nodeAddr);
       }
    }
    else
    {
-      g_idxSubnetByAddr.forEach(SubnetMatchCallback, &matchData);
+      subnet = static_pointer_cast<Subnet>(g_idxSubnetByAddr.findLongestPrefixMatch(nodeAddr));
    }
-   return matchData.subnet;
+   return subnet;
 }
 
 /**
@@ -1212,6 +1272,13 @@ shared_ptr<NetObj> NXCORE_EXPORTABLE FindObjectByName(const TCHAR *name, int obj
 	struct __find_object_by_name_data data;
 	data.objClass = objClass;
 	data.name = name;
+	if (objClass == OBJECT_NODE)
+	{
+	   TCHAR key[MAX_OBJECT_NAME];
+	   _tcslcpy(key, name, MAX_OBJECT_NAME);
+	   _tcsupr(key);
+	   return FindObjectByAttribute<void>(g_idxNodeByName, key, g_idxNodeById, ObjectNameComparator, &data);
+	}
 	return FindObject(ObjectNameComparator, &data, objClass);
 }
 
@@ -1357,6 +1424,240 @@ static void LinkObjects(NetObj *object, void *data)
    object->linkObjects();
 }
 
+#ifdef WITH_MEMORY_ACCOUNTING
+
+/**
+ * Callback for updating memory accounting estimates after objects are linked
+ */
+static void UpdateObjectMemoryAccounting(NetObj *object, void *data)
+{
+   MemoryAccountingUpdateObject(object);
+}
+
+#endif
+
+/**
+ * Create empty object of given class for loading from database
+ */
+template<typename T> static shared_ptr<NetObj> CreateObjectForLoading()
+{
+   return MakeSharedNObject<T>();
+}
+
+/**
+ * Load objects with indexes from given range of loader's ID list
+ */
+static void LoadObjectRange(ObjectClassLoader *loader, int start, int end, DB_HANDLE hdb)
+{
+   for(int i = start; i < end; i++)
+   {
+      shared_ptr<NetObj> object = loader->create();
+      if (object->loadFromDatabase(hdb, loader->ids[i]))
+      {
+         loader->objects[i] = object;
+      }
+      else     // Object load failed
+      {
+         object->destroy();
+         nxlog_write(NXLOG_ERROR, _T("Failed to load %s object with ID %u from database"), loader->className, loader->ids[i]);
+      }
+   }
+}
+
+/**
+ * Object loading job
+ */
+struct ObjectLoadJob
+{
+   ObjectClassLoader *loader;
+   int start;
+   int end;
+   VolatileCounter *pendingJobs;
+   CONDITION completed;
+};
+
+/**
+ * Execute object loading job on loader thread pool. Each job uses own connection from pool.
+ */
+static void ExecuteObjectLoadJob(ObjectLoadJob *job)
+{
+   DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+   LoadObjectRange(job->loader, job->start, job->end, hdb);
+   DBConnectionPoolReleaseConnection(hdb);
+   if (InterlockedDecrement(job->pendingJobs) == 0)
+      ConditionSet(job->completed);
+   delete job;
+}
+
+/**
+ * Load group of object classes. Objects from classes within group should not depend on each other,
+ * so they can be loaded in parallel. Each class is split into disjoint ranges of object IDs.
+ * If thread pool is given, loading jobs are executed on that pool, otherwise all objects are loaded
+ * on calling thread using provided database handle. Loaded objects are published to indexes on
+ * calling thread after all loading jobs are completed, in the order of IDs returned by loader's query.
+ */
+void LoadObjectGroup(const TCHAR *groupName, ObjectClassLoader *loaders, int numLoaders, DB_HANDLE hdb, ThreadPool *threadPool, int threadCount)
+{
+   int64_t startTime = GetCurrentTimeMs();
+
+   for(int i = 0; i < numLoaders; i++)
+   {
+      ObjectClassLoader *loader = &loaders[i];
+      DB_RESULT hResult = DBSelect(hdb, loader->query);
+      if (hResult == nullptr)
+         continue;
+
+      loader->count = DBGetNumRows(hResult);
+      loader->ids = MemAllocArrayNoInit<uint32_t>(loader->count);
+      for(int j = 0; j < loader->count; j++)
+         loader->ids[j] = DBGetFieldULong(hResult, j, 0);
+      DBFreeResult(hResult);
+      loader->objects = new shared_ptr<NetObj>[loader->count];
+      DbgPrintf(2, _T("Loading %s (%d objects)..."), loader->name, loader->count);
+   }
+
+   // Make sure that indexes are not modified by concurrent reads from loading jobs
+   g_idxObjectById.sortStartupData();
+   g_idxSubnetById.sortStartupData();
+   g_idxZoneByUIN.sortStartupData();
+   g_idxNodeById.sortStartupData();
+   g_idxClusterById.sortStartupData();
+   g_idxMobileDeviceById.sortStartupData();
+   g_idxAccessPointById.sortStartupData();
+   g_idxConditionById.sortStartupData();
+   g_idxServiceCheckById.sortStartupData();
+   g_idxNetMapById.sortStartupData();
+   g_idxChassisById.sortStartupData();
+   g_idxSensorById.sortStartupData();
+
+   if (threadPool != nullptr)
+   {
+      VolatileCounter pendingJobs = 1;
+      CONDITION completed = ConditionCreate(true);
+      for(int i = 0; i < numLoaders; i++)
+      {
+         ObjectClassLoader *loader = &loaders[i];
+         int chunkSize = std::max(loader->count / (threadCount * 4), 16);
+         for(int start = 0; start < loader->count; start += chunkSize)
+         {
+            ObjectLoadJob *job = new ObjectLoadJob;
+            job->loader = loader;
+            job->start = start;
+            job->end = std::min(start + chunkSize, loader->count);
+            job->pendingJobs = &pendingJobs;
+            job->completed = completed;
+            InterlockedIncrement(&pendingJobs);
+            ThreadPoolExecute(threadPool, ExecuteObjectLoadJob, job);
+         }
+      }
+      if (InterlockedDecrement(&pendingJobs) > 0)
+         ConditionWait(completed, INFINITE);
+      ConditionDestroy(completed);
+   }
+   else
+   {
+      for(int i = 0; i < numLoaders; i++)
+         LoadObjectRange(&loaders[i], 0, loaders[i].count, hdb);
+   }
+
+   int64_t loadTime = GetCurrentTimeMs() - startTime;
+
+   int total = 0;
+   for(int i = 0; i < numLoaders; i++)
+   {
+      ObjectClassLoader *loader = &loaders[i];
+      for(int j = 0; j < loader->count; j++)
+      {
+         shared_ptr<NetObj> object = loader->objects[j];
+         if (object == nullptr)
+            continue;
+         if (loader->publish != nullptr)
+         {
+            if (!loader->publish(object))
+            {
+               object->destroy();
+               loader->objects[j].reset();
+               nxlog_write(NXLOG_ERROR, _T("Failed to load %s object with ID %u from database"), loader->className, loader->ids[j]);
+               continue;
+            }
+         }
+         else
+         {
+            NetObjInsert(object, false, false);  // Insert into indexes
+         }
+         total++;
+      }
+   }
+
+   DbgPrintf(2, _T("Object loading phase \"%s\" completed in %d ms (%d objects, load %d ms, publish %d ms)"), groupName,
+            static_cast<int>(GetCurrentTimeMs() - startTime), total, static_cast<int>(loadTime), static_cast<int>(GetCurrentTimeMs() - startTime - loadTime));
+}
+
+/**
+ * Publish loaded subnet
+ */
+static bool PublishSubnet(const shared_ptr<NetObj>& object)
+{
+   auto subnet = static_pointer_cast<Subnet>(object);
+   if (!subnet->isDeleted())
+   {
+      if (g_flags & AF_ENABLE_ZONING)
+      {
+         shared_ptr<Zone> zone = FindZoneByUIN(subnet->getZoneUIN());
+         if (zone != nullptr)
+            zone->addSubnet(subnet);
+      }
+      else
+      {
+         g_entireNetwork->addSubnet(subnet);
+      }
+   }
+   NetObjInsert(subnet, false, false);  // Insert into indexes
+   return true;
+}
+
+/**
+ * Publish loaded node. Node is linked to its subnets here instead of loadFromDatabase()
+ * so that subnet objects are only modified on main thread.
+ */
+static bool PublishNode(const shared_ptr<NetObj>& object)
+{
+   static_cast<Node&>(*object).linkAfterLoad();
+   NetObjInsert(object, false, false);  // Insert into indexes
+   if (IsZoningEnabled())
+   {
+      shared_ptr<Zone> zone = FindZoneByProxyId(object->getId());
+      if (zone != nullptr)
+      {
+         zone->updateProxyStatus(static_pointer_cast<Node>(object), false);
+      }
+   }
+   return true;
+}
+
+/**
+ * Publish loaded template
+ */
+static bool PublishTemplate(const shared_ptr<NetObj>& object)
+{
+   NetObjInsert(object, false, false);  // Insert into indexes
+   object->calculateCompoundStatus();	// Force status change to NORMAL
+   return true;
+}
+
+/**
+ * Publish loaded node component (interface, access point, network service, VPN connector, or cluster).
+ * Components are linked to their nodes here instead of loadFromDatabase() so that node objects
+ * are only modified on main thread.
+ */
+template<typename T> static bool PublishNodeComponent(const shared_ptr<NetObj>& object)
+{
+   if (!static_cast<T&>(*object).linkAfterLoad())
+      return false;
+   NetObjInsert(object, false, false);  // Insert into indexes
+   return true;
+}
+
 /**
  * Load objects from database at stratup
  */
@@ -1365,6 +1666,7 @@ BOOL LoadObjects()
    // Prevent objects to change it's modification flag
    g_bModificationsLocked = TRUE;
 
+   int64_t startTime = GetCurrentTimeMs();
    DB_HANDLE mainDB = DBConnectionPoolAcquireConnection();
    DB_HANDLE hdb = mainDB;
    DB_HANDLE cachedb = (g_flags & AF_CACHE_DB_ON_STARTUP) ? DBOpenInMemoryDatabase() : nullptr;
@@ -1453,8 +1755,19 @@ BOOL LoadObjects()
          DBQuery(cachedb, _T("CREATE INDEX idx_dc_tables_node_id ON dc_tables(node_id)"));
          DBQuery(cachedb, _T("CREATE INDEX idx_dct_thresholds_table_id ON dct_thresholds(table_id)"));
       }
+      else
+      {
+         DBCloseInMemoryDatabase(cachedb);
+         cachedb = nullptr;
+      }
+      DbgPrintf(2, _T("Object configuration tables cached in %d ms"), static_cast<int>(GetCurrentTimeMs() - startTime));
    }
 
+   // Read common object properties for all objects at once instead of querying them for each object
+   int64_t phaseStartTime = GetCurrentTimeMs();
+   PrefetchObjectTables(hdb);
+   DbgPrintf(2, _T("Common object properties prefetched in %d ms"), static_cast<int>(GetCurrentTimeMs() - phaseStartTime));
+
    // Load built-in object properties
    DbgPrintf(2, _T("Loading built-in object properties..."));
    g_entireNetwork->loadFromDatabase(hdb);
@@ -1515,555 +1828,94 @@ BOOL LoadObjects()
    }
    g_idxZoneByUIN.setStartupMode(false);
 
-   // Load conditions
-   // We should load conditions before nodes because
-   // DCI cache size calculation uses information from condition objects
-   DbgPrintf(2, _T("Loading conditions..."));
-   DB_RESULT hResult = DBSelect(hdb, _T("SELECT id FROM conditions"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
+   // Objects are loaded in groups. Objects within group depend only on objects from previous groups.
+   // Classes within group and disjoint ID ranges within class are loaded in parallel.
+   // In-memory cache database is single connection, so objects are loaded sequentially in that case.
+   ThreadPool *loaderThreadPool = nullptr;
+   int loaderThreadCount = 1;
+   if (cachedb == nullptr)
+   {
+      // Each loading job uses own connection from pool. One connection is already in use by this
+      // thread and one will be used by cache loading thread while last group is being loaded.
+      loaderThreadCount = std::min(ConfigReadInt(_T("ThreadPool.ObjectLoader.MaxSize"), 8), ConfigReadInt(_T("DBConnectionPoolMaxSize"), 30) - 2);
+      if (loaderThreadCount > 1)
       {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto condition = MakeSharedNObject<ConditionObject>();
-         if (condition->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(condition, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            condition->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load condition object with ID %u from database"), id);
-         }
+         loaderThreadPool = ThreadPoolCreate(_T("OBJLOAD"), loaderThreadCount, loaderThreadCount);
+         DbgPrintf(2, _T("Using %d threads for loading objects"), loaderThreadCount);
       }
-      DBFreeResult(hResult);
    }
-   g_idxConditionById.setStartupMode(false);
-
-   // Load subnets
-   DbgPrintf(2, _T("Loading subnets..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM subnets"));
-   if (hResult != nullptr)
+   else
    {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto subnet = MakeSharedNObject<Subnet>();
-         if (subnet->loadFromDatabase(hdb, id))
-         {
-            if (!subnet->isDeleted())
-            {
-               if (g_flags & AF_ENABLE_ZONING)
-               {
-                  shared_ptr<Zone> zone = FindZoneByUIN(subnet->getZoneUIN());
-                  if (zone != nullptr)
-                     zone->addSubnet(subnet);
-               }
-               else
-               {
-                  g_entireNetwork->addSubnet(subnet);
-               }
-            }
-            NetObjInsert(subnet, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            subnet->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load subnet object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
+      DbgPrintf(2, _T("Object configuration tables are cached in memory, loading objects in single thread"));
    }
-   g_idxSubnetById.setStartupMode(false);
 
-   // Load racks
-   DbgPrintf(2, _T("Loading racks..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM racks"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto rack = MakeSharedNObject<Rack>();
-         if (rack->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(rack, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            nxlog_write(NXLOG_ERROR, _T("Failed to load rack object with ID %u from database"), id);
-            rack->destroy();
-         }
-      }
-      DBFreeResult(hResult);
-   }
-
-   // Load chassis
-   DbgPrintf(2, _T("Loading chassis..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM chassis"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto chassis = MakeSharedNObject<Chassis>();
-         if (chassis->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(chassis, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            nxlog_write(NXLOG_ERROR, _T("Failed to load chassis object with ID %u from database"), id);
-            chassis->destroy();
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   // Load conditions and independent objects
+   // We should load conditions before nodes because
+   // DCI cache size calculation uses information from condition objects
+   ObjectClassLoader primaryObjects[] = {
+      ObjectClassLoader(_T("conditions"), _T("condition"), _T("SELECT id FROM conditions"), CreateObjectForLoading<ConditionObject>),
+      ObjectClassLoader(_T("subnets"), _T("subnet"), _T("SELECT id FROM subnets"), CreateObjectForLoading<Subnet>, PublishSubnet),
+      ObjectClassLoader(_T("racks"), _T("rack"), _T("SELECT id FROM racks"), CreateObjectForLoading<Rack>),
+      ObjectClassLoader(_T("chassis"), _T("chassis"), _T("SELECT id FROM chassis"), CreateObjectForLoading<Chassis>),
+      ObjectClassLoader(_T("mobile devices"), _T("mobile device"), _T("SELECT id FROM mobile_devices"), CreateObjectForLoading<MobileDevice>),
+      ObjectClassLoader(_T("sensors"), _T("sensor"), _T("SELECT id FROM sensors"), CreateObjectForLoading<Sensor>)
+   };
+   LoadObjectGroup(_T("primary objects"), primaryObjects, sizeof(primaryObjects) / sizeof(ObjectClassLoader), hdb, loaderThreadPool, loaderThreadCount);
+   g_idxConditionById.setStartupMode(false);
+   g_idxSubnetById.setStartupMode(false);
    g_idxChassisById.setStartupMode(false);
-
-   // Load mobile devices
-   DbgPrintf(2, _T("Loading mobile devices..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM mobile_devices"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto md = MakeSharedNObject<MobileDevice>();
-         if (md->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(md, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            md->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load mobile device object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
    g_idxMobileDeviceById.setStartupMode(false);
-
-   // Load sensors
-   DbgPrintf(2, _T("Loading sensors..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM sensors"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto sensor = MakeSharedNObject<Sensor>();
-         if (sensor->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(sensor, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            sensor->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load sensor object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
    g_idxSensorById.setStartupMode(false);
 
    // Load nodes
-   DbgPrintf(2, _T("Loading nodes..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM nodes"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto node = MakeSharedNObject<Node>();
-         if (node->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(node, false, false);  // Insert into indexes
-            if (IsZoningEnabled())
-            {
-               shared_ptr<Zone> zone = FindZoneByProxyId(id);
-               if (zone != nullptr)
-               {
-                  zone->updateProxyStatus(node, false);
-               }
-            }
-         }
-         else     // Object load failed
-         {
-            node->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load node object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   ObjectClassLoader nodes[] = {
+      ObjectClassLoader(_T("nodes"), _T("node"), _T("SELECT id FROM nodes"), CreateObjectForLoading<Node>, PublishNode)
+   };
+   LoadObjectGroup(_T("nodes"), nodes, 1, hdb, loaderThreadPool, loaderThreadCount);
    g_idxNodeById.setStartupMode(false);
 
-   // Load access points
-   DbgPrintf(2, _T("Loading access points..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM access_points"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto ap = MakeSharedNObject<AccessPoint>();
-         if (ap->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(ap, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            nxlog_write(NXLOG_ERROR, _T("Failed to load access point object with ID %u from database"), id);
-            ap->destroy();
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   // Load objects linked to nodes
+   ObjectClassLoader nodeComponents[] = {
+      ObjectClassLoader(_T("access points"), _T("access point"), _T("SELECT id FROM access_points"), CreateObjectForLoading<AccessPoint>, PublishNodeComponent<AccessPoint>),
+      ObjectClassLoader(_T("interfaces"), _T("interface"), _T("SELECT id FROM interfaces"), CreateObjectForLoading<Interface>, PublishNodeComponent<Interface>),
+      ObjectClassLoader(_T("network services"), _T("network service"), _T("SELECT id FROM network_services"), CreateObjectForLoading<NetworkService>, PublishNodeComponent<NetworkService>),
+      ObjectClassLoader(_T("VPN connectors"), _T("VPN connector"), _T("SELECT id FROM vpn_connectors"), CreateObjectForLoading<VPNConnector>, PublishNodeComponent<VPNConnector>),
+      ObjectClassLoader(_T("clusters"), _T("cluster"), _T("SELECT id FROM clusters"), CreateObjectForLoading<Cluster>, PublishNodeComponent<Cluster>)
+   };
+   LoadObjectGroup(_T("node components"), nodeComponents, sizeof(nodeComponents) / sizeof(ObjectClassLoader), hdb, loaderThreadPool, loaderThreadCount);
    g_idxAccessPointById.setStartupMode(false);
-
-   // Load interfaces
-   DbgPrintf(2, _T("Loading interfaces..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM interfaces"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto iface = MakeSharedNObject<Interface>();
-         if (iface->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(iface, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            nxlog_write(NXLOG_ERROR, _T("Failed to load interface object with ID %u from database"), id);
-            iface->destroy();
-         }
-      }
-      DBFreeResult(hResult);
-   }
-
-   // Load network services
-   DbgPrintf(2, _T("Loading network services..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM network_services"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto service = MakeSharedNObject<NetworkService>();
-         if (service->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(service, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            service->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load network service object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
-
-   // Load VPN connectors
-   DbgPrintf(2, _T("Loading VPN connectors..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM vpn_connectors"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto connector = MakeSharedNObject<VPNConnector>();
-         if (connector->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(connector, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            connector->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load VPN connector object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
-
-   // Load clusters
-   DbgPrintf(2, _T("Loading clusters..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM clusters"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto cluster = MakeSharedNObject<Cluster>();
-         if (cluster->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(cluster, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            cluster->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load cluster object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
    g_idxClusterById.setStartupMode(false);
 
    // Start cache loading thread.
    // All data collection targets must be loaded at this point.
    ThreadCreate(CacheLoadingThread, 0, nullptr);
 
-   // Load templates
-   DbgPrintf(2, _T("Loading templates..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM templates"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto tmpl = MakeSharedNObject<Template>();
-         if (tmpl->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(tmpl, false, false);  // Insert into indexes
-				tmpl->calculateCompoundStatus();	// Force status change to NORMAL
-         }
-         else     // Object load failed
-         {
-            tmpl->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load template object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
-
-   // Load network maps
-   DbgPrintf(2, _T("Loading network maps..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM network_maps"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto map = MakeSharedNObject<NetworkMap>();
-         if (map->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(map, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            map->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load network map object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   // Load templates, containers, and other objects
+   TCHAR containerQuery[256], templateGroupQuery[256], mapGroupQuery[256], dashboardGroupQuery[256], businessServiceQuery[256], nodeLinkQuery[256];
+   _sntprintf(containerQuery, 256, _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_CONTAINER);
+   _sntprintf(templateGroupQuery, 256, _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_TEMPLATEGROUP);
+   _sntprintf(mapGroupQuery, 256, _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_NETWORKMAPGROUP);
+   _sntprintf(dashboardGroupQuery, 256, _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_DASHBOARDGROUP);
+   _sntprintf(businessServiceQuery, 256, _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_BUSINESSSERVICE);
+   _sntprintf(nodeLinkQuery, 256, _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_NODELINK);
+   ObjectClassLoader otherObjects[] = {
+      ObjectClassLoader(_T("templates"), _T("template"), _T("SELECT id FROM templates"), CreateObjectForLoading<Template>, PublishTemplate),
+      ObjectClassLoader(_T("network maps"), _T("network map"), _T("SELECT id FROM network_maps"), CreateObjectForLoading<NetworkMap>),
+      ObjectClassLoader(_T("containers"), _T("container"), containerQuery, CreateObjectForLoading<Container>),
+      ObjectClassLoader(_T("template groups"), _T("template group"), templateGroupQuery, CreateObjectForLoading<TemplateGroup>),
+      ObjectClassLoader(_T("map groups"), _T("network map group"), mapGroupQuery, CreateObjectForLoading<NetworkMapGroup>),
+      ObjectClassLoader(_T("dashboards"), _T("dashboard"), _T("SELECT id FROM dashboards"), CreateObjectForLoading<Dashboard>),
+      ObjectClassLoader(_T("dashboard groups"), _T("dashboard group"), dashboardGroupQuery, CreateObjectForLoading<DashboardGroup>),
+      ObjectClassLoader(_T("business services"), _T("business service"), businessServiceQuery, CreateObjectForLoading<BusinessService>),
+      ObjectClassLoader(_T("node links"), _T("node link"), nodeLinkQuery, CreateObjectForLoading<NodeLink>),
+      ObjectClassLoader(_T("service checks"), _T("service check"), _T("SELECT id FROM slm_checks"), CreateObjectForLoading<SlmCheck>)
+   };
+   LoadObjectGroup(_T("templates and containers"), otherObjects, sizeof(otherObjects) / sizeof(ObjectClassLoader), hdb, loaderThreadPool, loaderThreadCount);
    g_idxNetMapById.setStartupMode(false);
 
-   // Load container objects
-   DbgPrintf(2, _T("Loading containers..."));
-   TCHAR query[256];
-   _sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_CONTAINER);
-   hResult = DBSelect(hdb, query);
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto container = MakeSharedNObject<Container>();
-         if (container->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(container, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            container->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load container object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
-
-   // Load template group objects
-   DbgPrintf(2, _T("Loading template groups..."));
-   _sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_TEMPLATEGROUP);
-   hResult = DBSelect(hdb, query);
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto group = MakeSharedNObject<TemplateGroup>();
-         if (group->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(group, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            group->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load template group object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
-
-   // Load map group objects
-   DbgPrintf(2, _T("Loading map groups..."));
-   _sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_NETWORKMAPGROUP);
-   hResult = DBSelect(hdb, query);
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto group = MakeSharedNObject<NetworkMapGroup>();
-         if (group->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(group, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            group->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load network map group object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
-
-   // Load dashboard objects
-   DbgPrintf(2, _T("Loading dashboards..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM dashboards"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto dashboard = MakeSharedNObject<Dashboard>();
-         if (dashboard->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(dashboard, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            dashboard->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load dashboard object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
-
-   // Load dashboard group objects
-   DbgPrintf(2, _T("Loading dashboard groups..."));
-   _sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_DASHBOARDGROUP);
-   hResult = DBSelect(hdb, query);
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto group = MakeSharedNObject<DashboardGroup>();
-         if (group->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(group, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            group->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load dashboard group object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
-
-   // Loading business service objects
-   DbgPrintf(2, _T("Loading business services..."));
-   _sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_BUSINESSSERVICE);
-   hResult = DBSelect(hdb, query);
-   if (hResult != nullptr)
-   {
-	   int count = DBGetNumRows(hResult);
-	   for(int i = 0; i < count; i++)
-	   {
-		   UINT32 id = DBGetFieldULong(hResult, i, 0);
-		   auto service = MakeSharedNObject<BusinessService>();
-		   if (service->loadFromDatabase(hdb, id))
-		   {
-			   NetObjInsert(service, false, false);  // Insert into indexes
-		   }
-		   else     // Object load failed
-		   {
-			   service->destroy();
-			   nxlog_write(NXLOG_ERROR, _T("Failed to load business service object with ID %u from database"), id);
-		   }
-	   }
-	   DBFreeResult(hResult);
-   }
-
-   // Loading business service objects
-   DbgPrintf(2, _T("Loading node links..."));
-   _sntprintf(query, sizeof(query) / sizeof(TCHAR), _T("SELECT id FROM object_containers WHERE object_class=%d"), OBJECT_NODELINK);
-   hResult = DBSelect(hdb, query);
-   if (hResult != nullptr)
-   {
-	   int count = DBGetNumRows(hResult);
-	   for(int i = 0; i < count; i++)
-	   {
-		   UINT32 id = DBGetFieldULong(hResult, i, 0);
-		   auto nl = MakeSharedNObject<NodeLink>();
-		   if (nl->loadFromDatabase(hdb, id))
-		   {
-			   NetObjInsert(nl, false, false);  // Insert into indexes
-		   }
-		   else     // Object load failed
-		   {
-			   nl->destroy();
-			   nxlog_write(NXLOG_ERROR, _T("Failed to load node link object with ID %u from database"), id);
-		   }
-	   }
-	   DBFreeResult(hResult);
-   }
-
-   // Load service check objects
-   DbgPrintf(2, _T("Loading service checks..."));
-   hResult = DBSelect(hdb, _T("SELECT id FROM slm_checks"));
-   if (hResult != nullptr)
-   {
-      int count = DBGetNumRows(hResult);
-      for(int i = 0; i < count; i++)
-      {
-         UINT32 id = DBGetFieldULong(hResult, i, 0);
-         auto check = MakeSharedNObject<SlmCheck>();
-         if (check->loadFromDatabase(hdb, id))
-         {
-            NetObjInsert(check, false, false);  // Insert into indexes
-         }
-         else     // Object load failed
-         {
-            check->destroy();
-            nxlog_write(NXLOG_ERROR, _T("Failed to load service check object with ID %u from database"), id);
-         }
-      }
-      DBFreeResult(hResult);
-   }
+   if (loaderThreadPool != nullptr)
+      ThreadPoolDestroy(loaderThreadPool);
+   ReleasePrefetchedObjectTables();
 
    DBConnectionPoolReleaseConnection(mainDB);
 
@@ -2075,10 +1927,15 @@ BOOL LoadObjects()
 
    // Link children to container and template group objects
    DbgPrintf(2, _T("Linking objects..."));
+   phaseStartTime = GetCurrentTimeMs();
 	g_idxObjectById.forEach(LinkObjects, nullptr);
 
 	// Link custom object classes provided by modules
    CALL_ALL_MODULES(pfLinkObjects, ());
+#ifdef WITH_MEMORY_ACCOUNTING
+   g_idxObjectById.forEach(UpdateObjectMemoryAccounting, nullptr);   // parent and child lists are known only after linking
+#endif
+   DbgPrintf(2, _T("Objects linked in %d ms"), static_cast<int>(GetCurrentTimeMs() - phaseStartTime));
 
    // Allow objects to change it's modification flag
    g_bModificationsLocked = FALSE;
@@ -2105,6 +1962,7 @@ BOOL LoadObjects()
    if (cachedb != nullptr)
       DBCloseInMemoryDatabase(cachedb);
 
+   nxlog_write(NXLOG_INFO, _T("%d objects loaded from database in %d ms"), static_cast<int>(g_idxObjectById.size()), static_cast<int>(GetCurrentTimeMs() - startTime));
    return TRUE;
 }
 
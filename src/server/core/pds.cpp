@@ -37,11 +37,129 @@ extern Config g_serverConfig;
  */
 TCHAR *g_pdsLoadList = NULL;
 
+/**
+ * Queue overflow policy
+ */
+enum class PerfDataQueueOverflowPolicy
+{
+   DROP_NEW = 0,
+   DROP_OLD = 1,
+   SPOOL = 2
+};
+
+/**
+ * Queued performance data storage request
+ */
+class PerfDataQueueElement
+{
+public:
+   shared_ptr<DataCollectionOwner> owner;
+   uint32_t dciId;
+   time_t timestamp;
+   TCHAR *value;
+   Table *table;
+   int64_t queueTime;
+   size_t size;
+
+   PerfDataQueueElement(const shared_ptr<DataCollectionOwner>& _owner, uint32_t _dciId, time_t _timestamp, const TCHAR *_value) : owner(_owner)
+   {
+      dciId = _dciId;
+      timestamp = _timestamp;
+      value = MemCopyString(_value);
+      table = nullptr;
+      queueTime = GetCurrentTimeMs();
+      size = sizeof(PerfDataQueueElement) + (_tcslen(_value) + 1) * sizeof(TCHAR);
+   }
+
+   PerfDataQueueElement(const shared_ptr<DataCollectionOwner>& _owner, uint32_t _dciId, time_t _timestamp, Table *_table) : owner(_owner)
+   {
+      dciId = _dciId;
+      timestamp = _timestamp;
+      value = nullptr;
+      table = _table;
+      table->incRefCount();
+      queueTime = GetCurrentTimeMs();
+      size = sizeof(PerfDataQueueElement) + sizeof(Table) + table->getNumRows() * table->getNumColumns() * 32;
+   }
+
+   ~PerfDataQueueElement()
+   {
+      MemFree(value);
+      if (table != nullptr)
+         table->decRefCount();
+   }
+};
+
+/**
+ * Driver context - asynchronous request queue and its statistics
+ */
+class PerfDataStorageDriverContext
+{
+private:
+   PerfDataStorageDriver *m_driver;
+   ObjectQueue<PerfDataQueueElement> m_queue;
+   THREAD m_thread;
+   Condition m_stopCondition;
+   Mutex m_lock;
+   PerfDataSpool *m_spool;
+
+   // Configuration
+   uint64_t m_memoryLimit;
+   PerfDataQueueOverflowPolicy m_overflowPolicy;
+   int m_batchSize;
+   int m_maxRetries;
+   uint32_t m_retryInterval;
+   uint32_t m_maxRetryInterval;
+
+   // State
+   uint64_t m_memoryUsage;
+   bool m_offline;
+   int64_t m_nextProbeTime;
+   uint32_t m_probeInterval;
+
+   // Statistics
+   uint64_t m_processed;
+   uint64_t m_failed;
+   uint64_t m_dropped;
+   uint64_t m_spooled;
+   uint64_t m_replayed;
+   uint64_t m_retries;
+   int64_t m_latencySum;
+   int64_t m_latencyMax;
+   int64_t m_lastLatency;
+
+   void enqueue(PerfDataQueueElement *e);
+   void processElement(PerfDataQueueElement *e, bool shutdown);
+   bool save(DCObject *dci, time_t timestamp, const TCHAR *value, Table *table);
+   void spool(uint32_t ownerId, uint32_t dciId, time_t timestamp, const TCHAR *value, Table *table);
+   bool replaySpoolRecord(ByteStream *record);
+   static bool replaySpoolRecordCallback(ByteStream *record, void *context);
+   void replaySpool();
+   void onSaveCompleted(bool success);
+
+   void workerThread();
+   static THREAD_RESULT THREAD_CALL workerThreadStarter(void *arg);
+
+public:
+   PerfDataStorageDriverContext(PerfDataStorageDriver *driver, const Config& config);
+   ~PerfDataStorageDriverContext();
+
+   void start();
+   void stop();
+
+   void queueItemValue(DCItem *dci, time_t timestamp, const TCHAR *value);
+   void queueTableValue(DCTable *dci, time_t timestamp, Table *value);
+
+   PerfDataStorageDriver *getDriver() { return m_driver; }
+   Queue *getQueue() { return &m_queue; }
+   void showStats(ServerConsole *console);
+};
+
 /**
  * List of loaded drivers
  */
 static int s_numDrivers = 0;
-static PerfDataStorageDriver *s_drivers[MAX_PDS_DRIVERS];
+static PerfDataStorageDriverContext *s_drivers[MAX_PDS_DRIVERS];
 
 /**
  * Driver base class constructor
@@ -105,12 +223,552 @@ bool PerfDataStorageDriver::saveDCTableValue(DCTable *dcObject, time_t timestamp
 }
 
 /**
- * Storage request
+ * Create spool object. Size of existing spool file is taken into account.
+ */
+PerfDataSpool::PerfDataSpool(const TCHAR *fileName, uint64_t sizeLimit)
+{
+   _tcslcpy(m_fileName, fileName, MAX_PATH);
+   m_sizeLimit = sizeLimit;
+   m_size = 0;
+   FILE *f = _tfopen(m_fileName, _T("rb"));
+   if (f != nullptr)
+   {
+      if (fseek(f, 0, SEEK_END) == 0)
+         m_size = ftell(f);
+      fclose(f);
+   }
+}
+
+/**
+ * Get current spool file size
+ */
+uint64_t PerfDataSpool::getSize()
+{
+   m_lock.lock();
+   uint64_t size = m_size;
+   m_lock.unlock();
+   return size;
+}
+
+/**
+ * Append record to spool file. Returns false if record cannot be written or size limit is reached.
+ */
+bool PerfDataSpool::write(ByteStream *record)
+{
+   bool success = false;
+   m_lock.lock();
+   if (m_size + record->size() + 4 <= m_sizeLimit)
+   {
+      int fd = _topen(m_fileName, O_WRONLY | O_BINARY | O_CREAT | O_APPEND, 0600);
+      if (fd != -1)
+      {
+         uint32_t len = htonl(static_cast<uint32_t>(record->size()));
+         success = (_write(fd, &len, 4) == 4) && record->save(fd);
+         _close(fd);
+         if (success)
+            m_size += record->size() + 4;
+      }
+      else
+      {
+         nxlog_debug_tag(DEBUG_TAG, 4, _T("Cannot open spool file %s (%s)"), m_fileName, _tcserror(errno));
+      }
+   }
+   m_lock.unlock();
+   return success;
+}
+
+/**
+ * Pass spooled records to handler in the order they were written. Replay stops when handler
+ * returns false; record rejected by handler and all records after it are moved back to spool
+ * file. Records written while replay is in progress are kept. Returns number of replayed records.
+ */
+int PerfDataSpool::replay(bool (*handler)(ByteStream*, void*), void *context)
+{
+   TCHAR replayFile[MAX_PATH];
+   _sntprintf(replayFile, MAX_PATH, _T("%s.replay"), m_fileName);
+
+   m_lock.lock();
+   bool renamed = (_trename(m_fileName, replayFile) == 0);
+   m_size = 0;
+   m_lock.unlock();
+   if (!renamed)
+      return 0;
+
+   FILE *in = _tfopen(replayFile, _T("rb"));
+   if (in == nullptr)
+      return 0;
+
+   int count = 0;
+   BYTE *buffer = nullptr;
+   size_t bufferSize = 0;
+   long recordStart = 0;
+   bool completed = true;
+   uint32_t len;
+   while(fread(&len, 4, 1, in) == 1)
+   {
+      len = ntohl(len);
+      if (len > bufferSize)
+      {
+         bufferSize = len;
+         buffer = MemRealloc(buffer, bufferSize);
+      }
+      if (fread(buffer, len, 1, in) != 1)
+         break;   // truncated record
+
+      ByteStream record(buffer, len);
+      if (!handler(&record, context))
+      {
+         completed = false;
+         break;
+      }
+      count++;
+      recordStart = ftell(in);
+   }
+   MemFree(buffer);
+
+   if (!completed)
+   {
+      // Move remaining records back to spool file
+      fseek(in, recordStart, SEEK_SET);
+      m_lock.lock();
+      int fd = _topen(m_fileName, O_WRONLY | O_BINARY | O_CREAT | O_APPEND, 0600);
+      if (fd != -1)
+      {
+         char data[16384];
+         size_t bytes;
+         while((bytes = fread(data, 1, sizeof(data), in)) > 0)
+         {
+            if (_write(fd, data, static_cast<unsigned int>(bytes)) != static_cast<int>(bytes))
+               break;
+            m_size += bytes;
+         }
+         _close(fd);
+      }
+      m_lock.unlock();
+   }
+   fclose(in);
+   _tremove(replayFile);
+   return count;
+}
+
+/**
+ * Driver context constructor. Queue parameters are read from driver's section of server configuration file.
+ */
+PerfDataStorageDriverContext::PerfDataStorageDriverContext(PerfDataStorageDriver *driver, const Config& config) :
+         m_queue(4096, Ownership::True), m_stopCondition(true)
+{
+   m_driver = driver;
+   m_thread = INVALID_THREAD_HANDLE;
+
+   const TCHAR *name = driver->getName();
+   TCHAR path[256];
+
+   _sntprintf(path, 256, _T("/%s/QueueMemoryLimit"), name);
+   m_memoryLimit = config.getValueAsUInt64(path, 65536) * 1024;   // in KB, default 64 MB
+
+   _sntprintf(path, 256, _T("/%s/QueueOverflowPolicy"), name);
+   const TCHAR *policy = config.getValue(path, _T("DropOld"));
+   if (!_tcsicmp(policy, _T("DropNew")))
+      m_overflowPolicy = PerfDataQueueOverflowPolicy::DROP_NEW;
+   else if (!_tcsicmp(policy, _T("Spool")))
+      m_overflowPolicy = PerfDataQueueOverflowPolicy::SPOOL;
+   else
+      m_overflowPolicy = PerfDataQueueOverflowPolicy::DROP_OLD;
+
+   _sntprintf(path, 256, _T("/%s/QueueBatchSize"), name);
+   m_batchSize = std::max(config.getValueAsInt(path, 256), 1);
+
+   _sntprintf(path, 256, _T("/%s/MaxRetries"), name);
+   m_maxRetries = std::max(config.getValueAsInt(path, 5), 0);
+
+   _sntprintf(path, 256, _T("/%s/RetryInterval"), name);
+   m_retryInterval = std::max(config.getValueAsUInt(path, 1), 1u) * 1000;
+
+   _sntprintf(path, 256, _T("/%s/MaxRetryInterval"), name);
+   m_maxRetryInterval = std::max(config.getValueAsUInt(path, 60) * 1000, m_retryInterval);
+
+   _sntprintf(path, 256, _T("/%s/SpoolFileSizeLimit"), name);
+   uint64_t spoolSizeLimit = config.getValueAsUInt64(path, 262144) * 1024;  // in KB, default 256 MB, 0 to disable spooling
+
+   TCHAR spoolFile[MAX_PATH];
+   _sntprintf(spoolFile, MAX_PATH, _T("%s") FS_PATH_SEPARATOR _T("pds_%s.spool"), g_netxmsdDataDir, name);
+   m_spool = new PerfDataSpool(spoolFile, spoolSizeLimit);
+
+   m_memoryUsage = 0;
+   m_offline = false;
+   m_nextProbeTime = 0;
+   m_probeInterval = m_retryInterval;
+
+   m_processed = 0;
+   m_failed = 0;
+   m_dropped = 0;
+   m_spooled = 0;
+   m_replayed = 0;
+   m_retries = 0;
+   m_latencySum = 0;
+   m_latencyMax = 0;
+   m_lastLatency = 0;
+}
+
+/**
+ * Driver context destructor
+ */
+PerfDataStorageDriverContext::~PerfDataStorageDriverContext()
+{
+   delete m_driver;
+   delete m_spool;
+}
+
+/**
+ * Start worker thread
+ */
+void PerfDataStorageDriverContext::start()
+{
+   nxlog_debug_tag(DEBUG_TAG, 3, _T("Driver %s: queue memory limit %u KB, batch size %d, max retries %d, spool size limit %u KB"),
+            m_driver->getName(), static_cast<uint32_t>(m_memoryLimit / 1024), m_batchSize, m_maxRetries, static_cast<uint32_t>(m_spool->getSizeLimit() / 1024));
+   uint64_t spoolSize = m_spool->getSize();
+   if (spoolSize > 0)
+      nxlog_debug_tag(DEBUG_TAG, 3, _T("Driver %s: spool file %s contains ") UINT64_FMT _T(" bytes of unsent data"), m_driver->getName(), m_spool->getFileName(), spoolSize);
+   m_thread = ThreadCreateEx(workerThreadStarter, 0, this);
+}
+
+/**
+ * Stop worker thread. Requests remaining in queue are saved by driver or spooled.
+ */
+void PerfDataStorageDriverContext::stop()
+{
+   m_stopCondition.set();
+   m_queue.put(INVALID_POINTER_VALUE);
+   ThreadJoin(m_thread);
+   m_thread = INVALID_THREAD_HANDLE;
+}
+
+/**
+ * Add element to queue applying overflow policy if needed
+ */
+void PerfDataStorageDriverContext::enqueue(PerfDataQueueElement *e)
+{
+   m_lock.lock();
+   while((m_memoryUsage + e->size > m_memoryLimit) && (m_overflowPolicy == PerfDataQueueOverflowPolicy::DROP_OLD))
+   {
+      PerfDataQueueElement *old = m_queue.get();
+      if (old == nullptr)
+         break;
+      if (old == INVALID_POINTER_VALUE)
+      {
+         m_queue.insert(old);  // Keep shutdown marker
+         break;
+      }
+      m_memoryUsage -= old->size;
+      m_dropped++;
+      delete old;
+   }
+
+   if (m_memoryUsage + e->size <= m_memoryLimit)
+   {
+      m_memoryUsage += e->size;
+      m_queue.put(e);
+      m_lock.unlock();
+      return;
+   }
+
+   if (m_overflowPolicy == PerfDataQueueOverflowPolicy::SPOOL)
+   {
+      m_lock.unlock();
+      spool(e->owner->getId(), e->dciId, e->timestamp, e->value, e->table);
+   }
+   else
+   {
+      m_dropped++;
+      m_lock.unlock();
+   }
+   delete e;
+}
+
+/**
+ * Queue DCI value
+ */
+void PerfDataStorageDriverContext::queueItemValue(DCItem *dci, time_t timestamp, const TCHAR *value)
+{
+   shared_ptr<DataCollectionOwner> owner = dci->getOwner();
+   if (owner != nullptr)
+      enqueue(new PerfDataQueueElement(owner, dci->getId(), timestamp, value));
+}
+
+/**
+ * Queue table DCI value
+ */
+void PerfDataStorageDriverContext::queueTableValue(DCTable *dci, time_t timestamp, Table *value)
+{
+   shared_ptr<DataCollectionOwner> owner = dci->getOwner();
+   if (owner != nullptr)
+      enqueue(new PerfDataQueueElement(owner, dci->getId(), timestamp, value));
+}
+
+/**
+ * Pass value to driver
+ */
+bool PerfDataStorageDriverContext::save(DCObject *dci, time_t timestamp, const TCHAR *value, Table *table)
+{
+   if (table != nullptr)
+      return (dci->getType() == DCO_TYPE_TABLE) ? m_driver->saveDCTableValue(static_cast<DCTable*>(dci), timestamp, table) : true;
+   return (dci->getType() == DCO_TYPE_ITEM) ? m_driver->saveDCItemValue(static_cast<DCItem*>(dci), timestamp, value) : true;
+}
+
+/**
+ * Update driver state after save attempt. After failure driver is considered offline
+ * and next save attempt will be made after exponentially growing probe interval.
+ */
+void PerfDataStorageDriverContext::onSaveCompleted(bool success)
+{
+   if (success)
+   {
+      if (m_offline)
+      {
+         nxlog_debug_tag(DEBUG_TAG, 3, _T("Driver %s is back online"), m_driver->getName());
+         m_offline = false;
+      }
+      m_probeInterval = m_retryInterval;
+   }
+   else
+   {
+      if (!m_offline)
+      {
+         nxlog_debug_tag(DEBUG_TAG, 3, _T("Driver %s is offline"), m_driver->getName());
+         m_offline = true;
+      }
+      m_nextProbeTime = GetCurrentTimeMs() + m_probeInterval;
+      m_probeInterval = std::min(m_probeInterval * 2, m_maxRetryInterval);
+   }
+}
+
+/**
+ * Process single queue element. Failed saves are retried with exponential backoff.
+ */
+void PerfDataStorageDriverContext::processElement(PerfDataQueueElement *e, bool shutdown)
+{
+   shared_ptr<DCObject> dci = e->owner->getDCObjectById(e->dciId, 0, true);
+   if (dci == nullptr)
+      return;  // DCI was deleted while request was in queue
+
+   bool success = false;
+   if (!m_offline || (GetCurrentTimeMs() >= m_nextProbeTime))
+   {
+      uint32_t delay = m_retryInterval;
+      int maxRetries = (m_offline || shutdown) ? 0 : m_maxRetries;
+      for(int attempt = 0; ; attempt++)
+      {
+         success = save(dci.get(), e->timestamp, e->value, e->table);
+         if (success || (attempt >= maxRetries))
+            break;
+         m_lock.lock();
+         m_retries++;
+         m_lock.unlock();
+         if (m_stopCondition.wait(delay))
+            break;
+         delay = std::min(delay * 2, m_maxRetryInterval);
+      }
+      onSaveCompleted(success);
+   }
+
+   if (success)
+   {
+      int64_t latency = GetCurrentTimeMs() - e->queueTime;
+      m_lock.lock();
+      m_processed++;
+      m_latencySum += latency;
+      m_lastLatency = latency;
+      if (latency > m_latencyMax)
+         m_latencyMax = latency;
+      m_lock.unlock();
+   }
+   else if (m_spool->getSizeLimit() > 0)
+   {
+      spool(e->owner->getId(), e->dciId, e->timestamp, e->value, e->table);
+   }
+   else
+   {
+      m_lock.lock();
+      m_failed++;
+      m_lock.unlock();
+   }
+}
+
+/**
+ * Write request to spool file
+ */
+void PerfDataStorageDriverContext::spool(uint32_t ownerId, uint32_t dciId, time_t timestamp, const TCHAR *value, Table *table)
+{
+   ByteStream record(256);
+   record.write(static_cast<BYTE>((table != nullptr) ? DCO_TYPE_TABLE : DCO_TYPE_ITEM));
+   record.write(ownerId);
+   record.write(dciId);
+   record.write(static_cast<int64_t>(timestamp));
+   if (table != nullptr)
+      table->writeBinary(&record);
+   else
+      record.writeString(value);
+
+   bool success = m_spool->write(&record);
+
+   m_lock.lock();
+   if (success)
+      m_spooled++;
+   else
+      m_failed++;
+   m_lock.unlock();
+}
+
+/**
+ * Replay single spooled request. Returns false if replay should be stopped and record kept in spool file.
+ */
+bool PerfDataStorageDriverContext::replaySpoolRecord(ByteStream *record)
+{
+   // New requests have priority over spooled ones
+   if (m_queue.size() >= static_cast<size_t>(m_batchSize))
+      return false;
+
+   int type = record->readByte();
+   uint32_t ownerId = record->readUInt32();
+   uint32_t dciId = record->readUInt32();
+   time_t timestamp = static_cast<time_t>(record->readInt64());
+   TCHAR *value = nullptr;
+   Table *table = nullptr;
+   if (type == DCO_TYPE_TABLE)
+      table = Table::createFromBinary(record);
+   else
+      value = record->readString();
+
+   bool success = true;
+   shared_ptr<NetObj> object = FindObjectById(ownerId);
+   if ((object != nullptr) && object->isDataCollectionTarget() && ((value != nullptr) || (table != nullptr)))
+   {
+      shared_ptr<DCObject> dci = static_cast<DataCollectionOwner*>(object.get())->getDCObjectById(dciId, 0, true);
+      if (dci != nullptr)
+      {
+         success = save(dci.get(), timestamp, value, table);
+         onSaveCompleted(success);
+      }
+   }
+   MemFree(value);
+   if (table != nullptr)
+      table->decRefCount();
+   return success;
+}
+
+/**
+ * Callback for spool replay
+ */
+bool PerfDataStorageDriverContext::replaySpoolRecordCallback(ByteStream *record, void *context)
+{
+   return static_cast<PerfDataStorageDriverContext*>(context)->replaySpoolRecord(record);
+}
+
+/**
+ * Replay spooled requests. Replay stops on first failure or if new requests are waiting in queue.
+ */
+void PerfDataStorageDriverContext::replaySpool()
+{
+   nxlog_debug_tag(DEBUG_TAG, 5, _T("Driver %s: replaying spooled requests"), m_driver->getName());
+   int count = m_spool->replay(replaySpoolRecordCallback, this);
+
+   m_lock.lock();
+   m_replayed += count;
+   m_lock.unlock();
+   nxlog_debug_tag(DEBUG_TAG, 5, _T("Driver %s: %d spooled requests replayed (") UINT64_FMT _T(" bytes left in spool)"), m_driver->getName(), count, m_spool->getSize());
+}
+
+/**
+ * Worker thread
+ */
+void PerfDataStorageDriverContext::workerThread()
+{
+   nxlog_debug_tag(DEBUG_TAG, 2, _T("Worker thread for driver %s started"), m_driver->getName());
+
+   bool shutdown = false;
+   while(!shutdown)
+   {
+      PerfDataQueueElement *e = m_queue.getOrBlock((m_spool->getSize() > 0) ? m_retryInterval : INFINITE);
+      for(int count = 0; (e != nullptr) && (count < m_batchSize); count++)
+      {
+         if (e == INVALID_POINTER_VALUE)
+         {
+            shutdown = true;
+            break;
+         }
+         m_lock.lock();
+         m_memoryUsage -= e->size;
+         m_lock.unlock();
+         processElement(e, false);
+         delete e;
+         e = m_queue.get();
+      }
+      if (e == INVALID_POINTER_VALUE)
+         shutdown = true;
+      else if (e != nullptr)
+         m_queue.insert(e);   // batch limit reached, return element to the head of the queue
+
+      if (!shutdown && (m_queue.size() == 0) && (m_spool->getSize() > 0) && (!m_offline || (GetCurrentTimeMs() >= m_nextProbeTime)))
+         replaySpool();
+   }
+
+   // Save or spool requests remaining in queue
+   PerfDataQueueElement *e;
+   while((e = m_queue.get()) != nullptr)
+   {
+      if (e == INVALID_POINTER_VALUE)
+         continue;
+      processElement(e, true);
+      delete e;
+   }
+
+   nxlog_debug_tag(DEBUG_TAG, 2, _T("Worker thread for driver %s stopped"), m_driver->getName());
+}
+
+/**
+ * Worker thread starter
+ */
+THREAD_RESULT THREAD_CALL PerfDataStorageDriverContext::workerThreadStarter(void *arg)
+{
+   ThreadSetName("PDSWorker");
+   static_cast<PerfDataStorageDriverContext*>(arg)->workerThread();
+   return THREAD_OK;
+}
+
+/**
+ * Show driver queue statistics
+ */
+void PerfDataStorageDriverContext::showStats(ServerConsole *console)
+{
+   m_lock.lock();
+   console->printf(
+            _T("\x1b[1m%s\x1b[0m (%s)\n")
+            _T("   Queue size ..........: %u\n")
+            _T("   Queue memory usage ..: %u KB (limit %u KB)\n")
+            _T("   Processed requests ..: ") UINT64_FMT _T("\n")
+            _T("   Failed requests .....: ") UINT64_FMT _T("\n")
+            _T("   Dropped requests ....: ") UINT64_FMT _T("\n")
+            _T("   Retries .............: ") UINT64_FMT _T("\n")
+            _T("   Spooled requests ....: ") UINT64_FMT _T("\n")
+            _T("   Replayed requests ...: ") UINT64_FMT _T("\n")
+            _T("   Spool file size .....: %u KB\n")
+            _T("   Average latency .....: %d ms\n")
+            _T("   Last latency ........: %d ms\n")
+            _T("   Max latency .........: %d ms\n")
+            _T("\n"), m_driver->getName(), m_offline ? _T("offline") : _T("online"),
+            static_cast<uint32_t>(m_queue.size()), static_cast<uint32_t>(m_memoryUsage / 1024), static_cast<uint32_t>(m_memoryLimit / 1024),
+            m_processed, m_failed, m_dropped, m_retries, m_spooled, m_replayed, static_cast<uint32_t>(m_spool->getSize() / 1024),
+            (m_processed > 0) ? static_cast<int>(m_latencySum / m_processed) : 0, static_cast<int>(m_lastLatency), static_cast<int>(m_latencyMax));
+   m_lock.unlock();
+}
+
+/**
+ * Storage request. Values are queued for each driver and saved asynchronously by driver's worker thread.
  */
 void PerfDataStorageRequest(DCItem *dci, time_t timestamp, const TCHAR *value)
 {
    for(int i = 0; i < s_numDrivers; i++)
-      s_drivers[i]->saveDCItemValue(dci, timestamp, value);
+      s_drivers[i]->queueItemValue(dci, timestamp, value);
 }
 
 /**
@@ -119,7 +777,32 @@ void PerfDataStorageRequest(DCItem *dci, time_t timestamp, const TCHAR *value)
 void PerfDataStorageRequest(DCTable *dci, time_t timestamp, Table *value)
 {
    for(int i = 0; i < s_numDrivers; i++)
-      s_drivers[i]->saveDCTableValue(dci, timestamp, value);
+      s_drivers[i]->queueTableValue(dci, timestamp, value);
+}
+
+/**
+ * Get queue of given driver for statistic collection. Returns nullptr if index is out of range.
+ */
+Queue *GetPerfDataStorageDriverQueue(int index, TCHAR *name, size_t size)
+{
+   if ((index < 0) || (index >= s_numDrivers))
+      return nullptr;
+   _sntprintf(name, size, _T("PerfDataStorage.%s"), s_drivers[index]->getDriver()->getName());
+   return s_drivers[index]->getQueue();
+}
+
+/**
+ * Show performance data storage driver statistics on server debug console
+ */
+void ShowPerfDataStorageStats(ServerConsole *console)
+{
+   if (s_numDrivers == 0)
+   {
+      console->print(_T("No performance data storage drivers loaded\n\n"));
+      return;
+   }
+   for(int i = 0; i < s_numDrivers; i++)
+      s_drivers[i]->showStats(console);
 }
 
 /**
@@ -172,7 +855,9 @@ static void LoadDriver(const TCHAR *file)
             PerfDataStorageDriver *driver = CreateInstance();
             if ((driver != NULL) && driver->init(&g_serverConfig))
             {
-               s_drivers[s_numDrivers++] = driver;
+               PerfDataStorageDriverContext *context = new PerfDataStorageDriverContext(driver, g_serverConfig);
+               s_drivers[s_numDrivers++] = context;
+               context->start();
                nxlog_write_tag(NXLOG_INFO, DEBUG_TAG, _T("Performance data storage driver %s loaded successfully"), driver->getName());
             }
             else
@@ -206,7 +891,7 @@ static void LoadDriver(const TCHAR *file)
  */
 void LoadPerfDataStorageDrivers()
 {
-   memset(s_drivers, 0, sizeof(PerfDataStorageDriver *) * MAX_PDS_DRIVERS);
+   memset(s_drivers, 0, sizeof(PerfDataStorageDriverContext *) * MAX_PDS_DRIVERS);
 
    nxlog_debug_tag(DEBUG_TAG, 1, _T("Loading performance data storage drivers"));
    for(TCHAR *curr = g_pdsLoadList, *next = nullptr; curr != nullptr; curr = next)
@@ -237,8 +922,10 @@ void ShutdownPerfDataStorageDrivers()
 {
    for(int i = 0; i < s_numDrivers; i++)
    {
-      nxlog_debug_tag(DEBUG_TAG, 2, _T("Executing shutdown handler for driver %s"), s_drivers[i]->getName());
-      s_drivers[i]->shutdown();
+      nxlog_debug_tag(DEBUG_TAG, 2, _T("Stopping worker thread for driver %s"), s_drivers[i]->getDriver()->getName());
+      s_drivers[i]->stop();
+      nxlog_debug_tag(DEBUG_TAG, 2, _T("Executing shutdown handler for driver %s"), s_drivers[i]->getDriver()->getName());
+      s_drivers[i]->getDriver()->shutdown();
       delete s_drivers[i];
    }
    nxlog_debug_tag(DEBUG_TAG, 1, _T("All performance data storage drivers unloaded"));
@@ -23,6 +23,10 @@
 #include "nxcore.h"
 #include <gauge_helpers.h>
 
+#ifdef WITH_ZMQ
+#include "zeromq.h"
+#endif
+
 #define DEBUG_TAG _T("statcoll")
 
 /**
@@ -38,13 +42,12 @@
 /**
  * Externals
  */
-extern Queue g_syslogProcessingQueue;
-extern Queue g_syslogWriteQueue;
 extern ThreadPool *g_dataCollectorThreadPool;
 extern ThreadPool *g_pollerThreadPool;
 extern ThreadPool *g_schedulerThreadPool;
 
 INT64 GetEventLogWriterQueueSize();
+Queue *GetPerfDataStorageDriverQueue(int index, TCHAR *name, size_t size);
 
 /**
  * Internal queue statistic
@@ -128,9 +131,16 @@ THREAD_RESULT THREAD_CALL ServerStatCollector(void *arg)
    AddQueueToCollector(_T("NodeDiscoveryPoller"), GetDiscoveryPollerQueueSize);
    AddQueueToCollector(_T("Poller"), g_pollerThreadPool);
    AddQueueToCollector(_T("Scheduler"), g_schedulerThreadPool);
-   AddQueueToCollector(_T("SyslogProcessor"), &g_syslogProcessingQueue);
-   AddQueueToCollector(_T("SyslogWriter"), &g_syslogWriteQueue);
+   AddQueueToCollector(_T("SyslogProcessor"), GetSyslogProcessingQueueSize);
+   AddQueueToCollector(_T("SyslogWriter"), GetSyslogWriterQueueSize);
    AddQueueToCollector(_T("TemplateUpdater"), &g_templateUpdateQueue);
+#ifdef WITH_ZMQ
+   AddQueueToCollector(_T("ZeroMQPublisher"), GetZmqPublisherQueueSize);
+#endif
+   TCHAR pdsQueueName[MAX_GAUGE_NAME_LEN];
+   Queue *pdsQueue;
+   for(int i = 0; (pdsQueue = GetPerfDataStorageDriverQueue(i, pdsQueueName, MAX_GAUGE_NAME_LEN)) != nullptr; i++)
+      AddQueueToCollector(pdsQueueName, pdsQueue);
    s_queuesLock.unlock();
 
    nxlog_debug_tag(DEBUG_TAG, 1, _T("Server statistic collector thread started"));
@@ -1579,6 +1579,7 @@ void ClientSession::sendRawMessage(NXCP_MESSAGE *msg)
  */
 void ClientSession::sendRawMessageAndDelete(NXCP_MESSAGE *msg)
 {
+   MemoryAccountingRemove(MemoryAccountingTag::NXCP_MESSAGES, ntohl(msg->size));
    sendRawMessage(msg);
    MemFree(msg);
    decRefCount();
@@ -1601,6 +1602,7 @@ void ClientSession::postRawMessageAndDelete(NXCP_MESSAGE *msg)
    TCHAR key[32];
    _sntprintf(key, 32, _T("POST/%u"), m_id);
    incRefCount();
+   MemoryAccountingAdd(MemoryAccountingTag::NXCP_MESSAGES, ntohl(msg->size));
    ThreadPoolExecuteSerialized(g_clientThreadPool, key, this, &ClientSession::sendRawMessageAndDelete, msg);
 }
 
@@ -4533,7 +4535,7 @@ bool ClientSession::getCollectedDataFromDB(NXCPMessage *request, NXCPMessage *re
 				   char *encodedTable = DBGetFieldUTF8(hResult, 1, nullptr, 0);
 				   if (encodedTable != nullptr)
 				   {
-				      Table *table = Table::createFromPackedXML(encodedTable);
+				      Table *table = Table::createFromPackedData(encodedTable);
 				      if (table != nullptr)
 				      {
 				         int row = table->findRowByInstance(instance);
@@ -24,6 +24,15 @@
 
 #define DEBUG_TAG _T("snmp.trap")
 
+/**
+ * Registered debug tag (registered on first use, so it is safe to call before server initialization)
+ */
+static inline const DebugTagHandle *DebugTag()
+{
+   static const DebugTagHandle *handle = nxlog_register_debug_tag(DEBUG_TAG);
+   return handle;
+}
+
 #define BY_OBJECT_ID 0
 #define BY_POSITION 1
 
@@ -41,12 +50,113 @@ VolatileCounter64 g_snmpTrapsReceived = 0;
  * Static data
  */
 static Mutex s_trapCfgLock;
-static ObjectArray<SNMPTrapConfiguration> m_trapCfgList(16, 4, Ownership::True);
+static SharedObjectArray<SNMPTrapConfiguration> m_trapCfgList(16, 16);
 static bool s_logAllTraps = false;
 static VolatileCounter64 s_trapId = 0; // Next free trap ID
 static bool s_allowVarbindConversion = true;
+static SourceBindingCache *s_bindingCache = nullptr;
+static BatchLogWriter *s_trapLogWriter = nullptr;
 static UINT16 m_wTrapPort = 162;
 
+/**
+ * Trap log record
+ */
+struct SNMPTrapLogRecord
+{
+   uint64_t trapId;
+   uint32_t timestamp;
+   uint32_t objectId;
+   int32_t zoneUIN;
+   TCHAR ipAddr[64];
+   TCHAR trapOID[MAX_DB_STRING];
+   TCHAR varbinds[1];   // actual size determined by varbind list length
+};
+
+/**
+ * Set snmp_trap_log table columns for bulk insert
+ */
+static void SetTrapLogRowValues(DB_BULK_INSERT bi, const void *record)
+{
+   auto r = static_cast<const SNMPTrapLogRecord*>(record);
+   DBBulkInsertSet(bi, 1, static_cast<UINT64>(r->trapId));
+   DBBulkInsertSet(bi, 2, static_cast<UINT32>(r->timestamp));
+   DBBulkInsertSet(bi, 3, r->ipAddr);
+   DBBulkInsertSet(bi, 4, static_cast<UINT32>(r->objectId));
+   DBBulkInsertSet(bi, 5, static_cast<INT32>(r->zoneUIN));
+   DBBulkInsertSet(bi, 6, r->trapOID);
+   DBBulkInsertSet(bi, 7, r->varbinds);
+}
+
+/**
+ * Compiled trap configuration. Once created it is never changed, so it can be used by
+ * trap processing code without holding configuration lock.
+ */
+class TrapMatcher
+{
+private:
+   SharedObjectArray<SNMPTrapConfiguration> m_configurations;  // Keeps configuration objects referenced from trie alive
+   SNMP_ObjectIdTrie m_trie;
+
+public:
+   TrapMatcher(const SharedObjectArray<SNMPTrapConfiguration>& list);
+
+   /**
+    * Find configuration with exact or longest matching OID
+    */
+   const SNMPTrapConfiguration *find(const SNMP_ObjectId& oid) const
+   {
+      return static_cast<const SNMPTrapConfiguration*>(m_trie.findLongestMatch(oid));
+   }
+
+   int size() const { return m_trie.size(); }
+};
+
+/**
+ * Build trap matcher from configuration list. If same OID is used by more than one
+ * configuration entry, first one in the list wins.
+ */
+TrapMatcher::TrapMatcher(const SharedObjectArray<SNMPTrapConfiguration>& list) : m_configurations(list.size(), 16)
+{
+   for(int i = list.size() - 1; i >= 0; i--)
+   {
+      const shared_ptr<SNMPTrapConfiguration>& trapCfg = list.getShared(i);
+      if (trapCfg->getOid().length() == 0)
+         continue;
+      m_configurations.add(trapCfg);
+      m_trie.put(trapCfg->getOid(), trapCfg.get());
+   }
+}
+
+/**
+ * Current trap matcher
+ */
+static shared_ptr<TrapMatcher> s_trapMatcher = make_shared<TrapMatcher>(m_trapCfgList);
+static Mutex s_trapMatcherLock(true);
+
+/**
+ * Rebuild trap matcher after configuration change. Should be called with configuration lock held.
+ */
+static void RebuildTrapMatcher()
+{
+   shared_ptr<TrapMatcher> matcher = make_shared<TrapMatcher>(m_trapCfgList);
+   nxlog_debug_tag(DebugTag(), 6, _T("Trap matcher rebuilt (%d OIDs)"), matcher->size());
+
+   s_trapMatcherLock.lock();
+   s_trapMatcher.swap(matcher);
+   s_trapMatcherLock.unlock();
+}
+
+/**
+ * Get current trap matcher
+ */
+static inline shared_ptr<TrapMatcher> GetTrapMatcher()
+{
+   s_trapMatcherLock.lock();
+   shared_ptr<TrapMatcher> matcher = s_trapMatcher;
+   s_trapMatcherLock.unlock();
+   return matcher;
+}
+
 /**
  * Create new SNMP trap configuration object
  */
@@ -386,6 +496,10 @@ void LoadTrapCfg()
          }
          if (hStmt != nullptr)
             DBFreeStatement(hStmt);
+
+         s_trapCfgLock.lock();
+         RebuildTrapMatcher();
+         s_trapCfgLock.unlock();
       }
       DBFreeResult(hResult);
    }
@@ -401,6 +515,13 @@ void InitTraps()
 	LoadTrapCfg();
 	s_logAllTraps = ConfigReadBoolean(_T("LogAllSNMPTraps"), false);
 	s_allowVarbindConversion = ConfigReadBoolean(_T("AllowTrapVarbindsConversion"), true);
+	s_bindingCache = new SourceBindingCache(_T("SNMP traps"));
+
+	static const int sqlTypes[] = { DB_SQLTYPE_BIGINT, DB_SQLTYPE_INTEGER, DB_SQLTYPE_VARCHAR, DB_SQLTYPE_INTEGER, DB_SQLTYPE_INTEGER,
+	         DB_SQLTYPE_VARCHAR, DB_SQLTYPE_TEXT };
+	s_trapLogWriter = new BatchLogWriter(_T("SNMP trap log"), _T("snmp_trap_log"), _T("trap_id,trap_timestamp,ip_addr,object_id,zone_uin,trap_oid,trap_varlist"),
+	         sqlTypes, 7, SetTrapLogRowValues);
+	s_trapLogWriter->start();
 
 	DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
 	DB_RESULT hResult = DBSelect(hdb, _T("SELECT max(trap_id) FROM snmp_trap_log"));
@@ -416,12 +537,21 @@ void InitTraps()
 }
 
 /**
- * Generate event for matched trap
+ * Stop trap log writer. All traps logged before this call will be written to database.
+ * Trap receiver thread should be stopped before this call. Writer object is not destroyed
+ * because traps forwarded by agents still can be processed; such traps are not logged.
  */
-static void GenerateTrapEvent(const shared_ptr<Node>& node, UINT32 dwIndex, SNMP_PDU *pdu, int sourcePort)
+void ShutdownTraps()
 {
-   SNMPTrapConfiguration *trapCfg = m_trapCfgList.get(dwIndex);
+   if (s_trapLogWriter != nullptr)
+      s_trapLogWriter->stop();
+}
 
+/**
+ * Generate event for matched trap
+ */
+static void GenerateTrapEvent(const shared_ptr<Node>& node, const SNMPTrapConfiguration *trapCfg, SNMP_PDU *pdu, int sourcePort)
+{
    StringMap parameters;
    parameters.set(_T("oid"), pdu->getTrapId()->toString());
 
@@ -488,7 +618,7 @@ static void GenerateTrapEvent(const shared_ptr<Node>& node, UINT32 dwIndex, SNMP
       }
       else
       {
-         nxlog_debug_tag(DEBUG_TAG, 6, _T("GenerateTrapEvent: cannot load transformation script for trap mapping [%u]"), trapCfg->getId());
+         nxlog_debug_tag(DebugTag(), 6, _T("GenerateTrapEvent: cannot load transformation script for trap mapping [%u]"), trapCfg->getId());
       }
    }
    else
@@ -529,7 +659,7 @@ static StringBuffer BuildVarbindList(SNMP_PDU *pdu)
       else
          v->getValueAsString(data, 4096);
 
-      nxlog_debug_tag(DEBUG_TAG, 5, _T("   %s == '%s'"), oidText, data);
+      nxlog_debug_tag(DebugTag(), 5, _T("   %s == '%s'"), oidText, data);
 
       out.append(oidText);
       out.append(_T(" == '"));
@@ -548,11 +678,14 @@ void ProcessTrap(SNMP_PDU *pdu, const InetAddress& srcAddr, int32_t zoneUIN, int
    StringBuffer varbinds;
    TCHAR buffer[4096];
 	bool processedByModule = false;
-   int iResult;
 
    InterlockedIncrement64(&g_snmpTrapsReceived);
-   nxlog_debug_tag(DEBUG_TAG, 4, _T("Received SNMP %s %s from %s"), isInformRq ? _T("INFORM-REQUEST") : _T("TRAP"),
-             pdu->getTrapId()->toString(&buffer[96], 4000), srcAddr.toString(buffer));
+   if (nxlog_is_debug_enabled(DebugTag(), 4))
+   {
+      // Formatted trap OID and source address are also used by varbind dump at level 5
+      nxlog_debug_tag(DebugTag(), 4, _T("Received SNMP %s %s from %s"), isInformRq ? _T("INFORM-REQUEST") : _T("TRAP"),
+                pdu->getTrapId()->toString(&buffer[96], 4000), srcAddr.toString(buffer));
+   }
 
 	if (isInformRq)
 	{
@@ -568,28 +701,41 @@ void ProcessTrap(SNMP_PDU *pdu, const InetAddress& srcAddr, int32_t zoneUIN, int
 	}
 
    // Match IP address to object
-   shared_ptr<Node> node = FindNodeByIP(zoneUIN, (g_flags & AF_TRAP_SOURCES_IN_ALL_ZONES) != 0, srcAddr);
+   shared_ptr<Node> node;
+   uint32_t cachedNodeId, generation;
+   if ((s_bindingCache != nullptr) && s_bindingCache->get(zoneUIN, srcAddr, nullptr, &cachedNodeId, &generation))
+   {
+      if (cachedNodeId != 0)
+         node = static_pointer_cast<Node>(FindObjectById(cachedNodeId, OBJECT_NODE));
+   }
+   else
+   {
+      node = FindNodeByIP(zoneUIN, (g_flags & AF_TRAP_SOURCES_IN_ALL_ZONES) != 0, srcAddr);
+      if (s_bindingCache != nullptr)
+         s_bindingCache->put(zoneUIN, srcAddr, nullptr, (node != nullptr) ? node->getId() : 0, generation);
+   }
 
    // Write trap to log if required
    if (s_logAllTraps || (node != nullptr))
    {
       NXCPMessage msg;
-      TCHAR szQuery[8192], oidText[1024];
+      TCHAR oidText[1024];
       UINT32 dwTimeStamp = (UINT32)time(nullptr);
 
-      nxlog_debug_tag(DEBUG_TAG, 5, _T("Varbinds for %s %s from %s:"), isInformRq ? _T("INFORM-REQUEST") : _T("TRAP"), &buffer[96], buffer);
+      nxlog_debug_tag(DebugTag(), 5, _T("Varbinds for %s %s from %s:"), isInformRq ? _T("INFORM-REQUEST") : _T("TRAP"), &buffer[96], buffer);
       varbinds = BuildVarbindList(pdu);
 
       // Write new trap to database
 		UINT64 trapId = InterlockedIncrement64(&s_trapId);
-      _sntprintf(szQuery, 8192, _T("INSERT INTO snmp_trap_log (trap_id,trap_timestamp,")
-                                _T("ip_addr,object_id,zone_uin,trap_oid,trap_varlist) VALUES ")
-                                _T("(") INT64_FMT _T(",%d,'%s',%d,%d,'%s',%s)"),
-                 trapId, dwTimeStamp, srcAddr.toString(buffer),
-                 (node != nullptr) ? node->getId() : (UINT32)0, (node != nullptr) ? node->getZoneUIN() : zoneUIN,
-                 pdu->getTrapId()->toString(oidText, 1024),
-                 (const TCHAR *)DBPrepareString(g_dbDriver, varbinds));
-      QueueSQLRequest(szQuery);
+      auto record = static_cast<SNMPTrapLogRecord*>(MemAlloc(sizeof(SNMPTrapLogRecord) + varbinds.length() * sizeof(TCHAR)));
+      record->trapId = trapId;
+      record->timestamp = dwTimeStamp;
+      record->objectId = (node != nullptr) ? node->getId() : 0;
+      record->zoneUIN = (node != nullptr) ? node->getZoneUIN() : zoneUIN;
+      srcAddr.toString(record->ipAddr);
+      _tcslcpy(record->trapOID, pdu->getTrapId()->toString(oidText, 1024), MAX_DB_STRING);
+      memcpy(record->varbinds, varbinds.cstr(), (varbinds.length() + 1) * sizeof(TCHAR));
+      s_trapLogWriter->put(record);
 
       // Notify connected clients
       msg.setCode(CMD_TRAP_LOG_RECORDS);
@@ -603,16 +749,16 @@ void ProcessTrap(SNMP_PDU *pdu, const InetAddress& srcAddr, int32_t zoneUIN, int
       msg.setField(VID_TRAP_LOG_MSG_BASE + 5, varbinds);
       EnumerateClientSessions(BroadcastNewTrap, &msg);
    }
-   else if (nxlog_get_debug_level_tag(DEBUG_TAG) >= 5)
+   else if (nxlog_is_debug_enabled(DebugTag(), 5))
    {
-      nxlog_debug_tag(DEBUG_TAG, 5, _T("Varbinds for %s %s:"), isInformRq ? _T("INFORM-REQUEST") : _T("TRAP"), &buffer[96]);
+      nxlog_debug_tag(DebugTag(), 5, _T("Varbinds for %s %s:"), isInformRq ? _T("INFORM-REQUEST") : _T("TRAP"), &buffer[96]);
       BuildVarbindList(pdu);
    }
 
    // Process trap if it is coming from host registered in database
    if (node != nullptr)
    {
-      nxlog_debug_tag(DEBUG_TAG, 4, _T("ProcessTrap: trap matched to node %s [%d]"), node->getName(), node->getId());
+      nxlog_debug_tag(DebugTag(), 4, _T("ProcessTrap: trap matched to node %s [%d]"), node->getName(), node->getId());
       node->incSnmpTrapCount();
       if ((node->getStatus() != STATUS_UNMANAGED) || (g_flags & AF_TRAPS_FROM_UNMANAGED_NODES))
       {
@@ -627,37 +773,11 @@ void ProcessTrap(SNMP_PDU *pdu, const InetAddress& srcAddr, int32_t zoneUIN, int
          }
 
          // Find if we have this trap in our list
-         s_trapCfgLock.lock();
-
-         // Try to find closest match
-         size_t matchLen = 0;
-         int matchIndex;
-         for(int i = 0; i < m_trapCfgList.size(); i++)
-         {
-            const SNMPTrapConfiguration *trapCfg = m_trapCfgList.get(i);
-            if (trapCfg->getOid().length() > 0)
-            {
-               iResult = pdu->getTrapId()->compare(trapCfg->getOid());
-               if (iResult == OID_EQUAL)
-               {
-                  matchLen = trapCfg->getOid().length();
-                  matchIndex = i;
-                  break;   // Find exact match
-               }
-               else if (iResult == OID_LONGER)
-               {
-                  if (trapCfg->getOid().length() > matchLen)
-                  {
-                     matchLen = trapCfg->getOid().length();
-                     matchIndex = i;
-                  }
-               }
-            }
-         }
-
-         if (matchLen > 0)
+         shared_ptr<TrapMatcher> matcher = GetTrapMatcher();
+         const SNMPTrapConfiguration *trapCfg = matcher->find(*pdu->getTrapId());
+         if (trapCfg != nullptr)
          {
-            GenerateTrapEvent(node, matchIndex, pdu, srcPort);
+            GenerateTrapEvent(node, trapCfg, pdu, srcPort);
          }
          else if (!processedByModule)    // Process unmatched traps not processed by module
          {
@@ -667,21 +787,20 @@ void ProcessTrap(SNMP_PDU *pdu, const InetAddress& srcAddr, int32_t zoneUIN, int
             PostEventWithNames(EVENT_SNMP_UNMATCHED_TRAP, EventOrigin::SNMP, 0, node->getId(), "ssd", names,
                pdu->getTrapId()->toString(oidText, 1024), (const TCHAR *)varbinds, srcPort);
          }
-         s_trapCfgLock.unlock();
       }
       else
       {
-         nxlog_debug_tag(DEBUG_TAG, 4, _T("ProcessTrap: Node %s [%d] is in UNMANAGED state, trap ignored"), node->getName(), node->getId());
+         nxlog_debug_tag(DebugTag(), 4, _T("ProcessTrap: Node %s [%d] is in UNMANAGED state, trap ignored"), node->getName(), node->getId());
       }
    }
    else if (g_flags & AF_SNMP_TRAP_DISCOVERY)  // unknown node, discovery enabled
    {
-      nxlog_debug_tag(DEBUG_TAG, 4, _T("ProcessTrap: trap not matched to node, adding new IP address %s for discovery"), srcAddr.toString(buffer));
+      nxlog_debug_tag(DebugTag(), 4, _T("ProcessTrap: trap not matched to node, adding new IP address %s for discovery"), srcAddr.toString(buffer));
       CheckPotentialNode(srcAddr, zoneUIN, DA_SRC_SNMP_TRAP, 0);
    }
    else  // unknown node, discovery disabled
    {
-      nxlog_debug_tag(DEBUG_TAG, 4, _T("ProcessTrap: trap not matched to any node"));
+      nxlog_debug_tag(DebugTag(), 4, _T("ProcessTrap: trap not matched to any node"));
    }
 }
 
@@ -693,7 +812,7 @@ static SNMP_SecurityContext *ContextFinder(struct sockaddr *addr, socklen_t addr
    InetAddress ipAddr = InetAddress::createFromSockaddr(addr);
 	shared_ptr<Node> node = FindNodeByIP((g_flags & AF_TRAP_SOURCES_IN_ALL_ZONES) ? ALL_ZONES : 0, ipAddr);
 	TCHAR buffer[64];
-	nxlog_debug_tag(DEBUG_TAG, 6, _T("SNMPTrapReceiver: looking for SNMP security context for node %s %s"),
+	nxlog_debug_tag(DebugTag(), 6, _T("SNMPTrapReceiver: looking for SNMP security context for node %s %s"),
       ipAddr.toString(buffer), (node != nullptr) ? node->getName() : _T("<unknown>"));
 	return (node != nullptr) ? node->getSnmpSecurityContext() : nullptr;
 }
@@ -805,7 +924,7 @@ void SNMPTrapReceiver()
    // Bind socket
    TCHAR buffer[64];
    int bindFailures = 0;
-   nxlog_debug_tag(DEBUG_TAG, 5, _T("Trying to bind on UDP %s:%d"), SockaddrToStr((struct sockaddr *)&servAddr, buffer), ntohs(servAddr.sin_port));
+   nxlog_debug_tag(DebugTag(), 5, _T("Trying to bind on UDP %s:%d"), SockaddrToStr((struct sockaddr *)&servAddr, buffer), ntohs(servAddr.sin_port));
    if (bind(hSocket, (struct sockaddr *)&servAddr, sizeof(struct sockaddr_in)) != 0)
    {
       TCHAR buffer[1024];
@@ -816,7 +935,7 @@ void SNMPTrapReceiver()
    }
 
 #ifdef WITH_IPV6
-   nxlog_debug_tag(DEBUG_TAG, 5, _T("Trying to bind on UDP [%s]:%d"), SockaddrToStr((struct sockaddr *)&servAddr6, buffer), ntohs(servAddr6.sin6_port));
+   nxlog_debug_tag(DebugTag(), 5, _T("Trying to bind on UDP [%s]:%d"), SockaddrToStr((struct sockaddr *)&servAddr6, buffer), ntohs(servAddr6.sin6_port));
    if (bind(hSocket6, (struct sockaddr *)&servAddr6, sizeof(struct sockaddr_in6)) != 0)
    {
       TCHAR buffer[1024];
@@ -832,7 +951,7 @@ void SNMPTrapReceiver()
    // Abort if cannot bind to at least one socket
    if (bindFailures == 2)
    {
-      nxlog_debug_tag(DEBUG_TAG, 1, _T("SNMP trap receiver aborted - cannot bind at least one socket"));
+      nxlog_debug_tag(DebugTag(), 1, _T("SNMP trap receiver aborted - cannot bind at least one socket"));
       return;
    }
 
@@ -856,7 +975,7 @@ void SNMPTrapReceiver()
 
    SocketPoller sp;
 
-   nxlog_debug_tag(DEBUG_TAG, 1, _T("SNMP Trap Receiver started on port %u"), m_wTrapPort);
+   nxlog_debug_tag(DebugTag(), 1, _T("SNMP Trap Receiver started on port %u"), m_wTrapPort);
 
    // Wait for packets
    while(!IsShutdownInProgress())
@@ -884,7 +1003,8 @@ void SNMPTrapReceiver()
          if ((bytes > 0) && (pdu != nullptr))
          {
             InetAddress sourceAddr = InetAddress::createFromSockaddr((struct sockaddr *)&addr);
-            nxlog_debug_tag(DEBUG_TAG, 6, _T("SNMPTrapReceiver: received PDU of type %d from %s"), pdu->getCommand(), (const TCHAR *)sourceAddr.toString());
+            if (nxlog_is_debug_enabled(DebugTag(), 6))
+               nxlog_debug_tag(DebugTag(), 6, _T("SNMPTrapReceiver: received PDU of type %d from %s"), pdu->getCommand(), (const TCHAR *)sourceAddr.toString());
 			   if ((pdu->getCommand() == SNMP_TRAP) || (pdu->getCommand() == SNMP_INFORM_REQUEST))
 			   {
 				   if ((pdu->getVersion() == SNMP_VERSION_3) && (pdu->getCommand() == SNMP_INFORM_REQUEST))
@@ -897,7 +1017,7 @@ void SNMPTrapReceiver()
 			   else if ((pdu->getVersion() == SNMP_VERSION_3) && (pdu->getCommand() == SNMP_GET_REQUEST) && (pdu->getAuthoritativeEngine().getIdLen() == 0))
 			   {
 				   // Engine ID discovery
-				   nxlog_debug_tag(DEBUG_TAG, 6, _T("SNMPTrapReceiver: EngineId discovery"));
+				   nxlog_debug_tag(DebugTag(), 6, _T("SNMPTrapReceiver: EngineId discovery"));
 
 				   SNMP_PDU *response = new SNMP_PDU(SNMP_REPORT, pdu->getRequestId(), pdu->getVersion());
 				   response->setReportable(false);
@@ -921,7 +1041,7 @@ void SNMPTrapReceiver()
 			   }
 			   else if (pdu->getCommand() == SNMP_REPORT)
 			   {
-				   nxlog_debug_tag(DEBUG_TAG, 6, _T("SNMPTrapReceiver: REPORT PDU with error %s"), (const TCHAR *)pdu->getVariable(0)->getName().toString());
+				   nxlog_debug_tag(DebugTag(), 6, _T("SNMPTrapReceiver: REPORT PDU with error %s"), (const TCHAR *)pdu->getVariable(0)->getName().toString());
 			   }
             delete pdu;
          }
@@ -937,7 +1057,7 @@ void SNMPTrapReceiver()
 #ifdef WITH_IPV6
    delete snmp6;
 #endif
-   nxlog_debug_tag(DEBUG_TAG, 1, _T("SNMP Trap Receiver terminated"));
+   nxlog_debug_tag(DebugTag(), 1, _T("SNMP Trap Receiver terminated"));
 }
 
 /**
@@ -1014,6 +1134,7 @@ UINT32 DeleteTrap(UINT32 id)
                if (DBExecute(hStmtCfg) && DBExecute(hStmtMap))
                {
                   m_trapCfgList.remove(i);
+                  RebuildTrapMatcher();
                   NotifyOnTrapCfgDelete(id);
                   dwResult = RCC_SUCCESS;
                   DBCommit(hdb);
@@ -1268,6 +1389,7 @@ void AddTrapCfgToList(SNMPTrapConfiguration *trapCfg)
       }
    }
    m_trapCfgList.add(trapCfg);
+   RebuildTrapMatcher();
 
    s_trapCfgLock.unlock();
 }
@@ -0,0 +1,227 @@
+/*
+** NetXMS - Network Management System
+** Copyright (C) 2003-2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: source_binding.cpp
+**
+**/
+
+#include "nxcore.h"
+
+#define DEBUG_TAG _T("obj.binding")
+
+/**
+ * Cache generation. Entries created under older generation are considered invalid.
+ */
+static VolatileCounter s_generation = 0;
+
+/**
+ * Registered caches
+ */
+static ObjectArray<SourceBindingCache> s_caches(8, 8, Ownership::False);
+static Mutex s_cachesLock;
+
+/**
+ * Invalidate all source binding caches
+ */
+void NXCORE_EXPORTABLE InvalidateSourceBindingCaches()
+{
+   InterlockedIncrement(&s_generation);
+}
+
+/**
+ * Create new cache. Cache size and entry TTL are read from server configuration.
+ */
+SourceBindingCache::SourceBindingCache(const TCHAR *name) : m_entries(Ownership::True)
+{
+   init(name, ConfigReadInt(_T("SourceBindingCache.MaxSize"), 16384), ConfigReadULong(_T("SourceBindingCache.TTL"), 300));
+}
+
+/**
+ * Create new cache with given size and entry TTL
+ */
+SourceBindingCache::SourceBindingCache(const TCHAR *name, int maxSize, uint32_t ttl) : m_entries(Ownership::True)
+{
+   init(name, maxSize, ttl);
+}
+
+/**
+ * Initialize cache
+ */
+void SourceBindingCache::init(const TCHAR *name, int maxSize, uint32_t ttl)
+{
+   _tcslcpy(m_name, name, 64);
+   m_maxSize = std::max(maxSize, 16);
+   m_ttl = ttl;
+   m_hits = 0;
+   m_misses = 0;
+
+   s_cachesLock.lock();
+   s_caches.add(this);
+   s_cachesLock.unlock();
+
+   nxlog_debug_tag(DEBUG_TAG, 3, _T("Source binding cache \"%s\" created (size %d, TTL %u seconds)"), m_name, m_maxSize, m_ttl);
+}
+
+/**
+ * Cache destructor
+ */
+SourceBindingCache::~SourceBindingCache()
+{
+   s_cachesLock.lock();
+   s_caches.remove(this);
+   s_cachesLock.unlock();
+}
+
+/**
+ * Build cache key. Host name is truncated to MAX_SYSLOG_HOSTNAME_LEN - 1 characters, same as in syslog record.
+ */
+void SourceBindingCache::buildKey(SourceBindingKey *key, int32_t zoneUIN, const InetAddress& addr, const char *hostName)
+{
+   memset(key, 0, sizeof(SourceBindingKey));
+   key->zoneUIN = zoneUIN;
+   addr.buildHashKey(key->address);
+   if (hostName != nullptr)
+      strlcpy(key->hostName, hostName, MAX_SYSLOG_HOSTNAME_LEN);
+}
+
+/**
+ * Get node ID for given source from cache. Returns true if valid cache entry found (node ID
+ * set to 0 means that source was not matched to any node). Cache generation at the moment of
+ * lookup is returned in generation and should be passed to put() if caller resolves binding
+ * on cache miss, so binding resolved before cache invalidation will not be cached.
+ */
+bool SourceBindingCache::get(int32_t zoneUIN, const InetAddress& addr, const char *hostName, uint32_t *nodeId, uint32_t *generation)
+{
+   *generation = static_cast<uint32_t>(s_generation);
+   if (m_ttl == 0)
+      return false;
+
+   SourceBindingKey key;
+   buildKey(&key, zoneUIN, addr, hostName);
+
+   bool found = false;
+   m_lock.lock();
+   SourceBindingEntry *entry = m_entries.get(key);
+   if ((entry != nullptr) && (entry->generation == *generation) && (entry->expirationTime > time(nullptr)))
+   {
+      *nodeId = entry->nodeId;
+      found = true;
+      m_hits++;
+   }
+   else
+   {
+      m_misses++;
+   }
+   m_lock.unlock();
+   return found;
+}
+
+/**
+ * Remove expired and invalidated entries. If cache is still full after that, remove
+ * arbitrary entries to free space for at least 1/8 of cache size.
+ * Should be called with cache lock held.
+ */
+void SourceBindingCache::purge(time_t now)
+{
+   uint32_t generation = static_cast<uint32_t>(s_generation);
+   int target = m_maxSize - m_maxSize / 8;
+   Iterator<SourceBindingEntry> *it = m_entries.iterator();
+   while(it->hasNext())
+   {
+      SourceBindingEntry *entry = it->next();
+      if ((entry->generation != generation) || (entry->expirationTime <= now))
+         it->remove();
+   }
+   delete it;
+
+   if (m_entries.size() > target)
+   {
+      it = m_entries.iterator();
+      while(it->hasNext() && (m_entries.size() > target))
+      {
+         it->next();
+         it->remove();
+      }
+      delete it;
+   }
+}
+
+/**
+ * Put node ID for given source into cache (0 for sources not matched to any node). Generation
+ * should be the one returned by get() before binding was resolved. Entry is not stored if caches
+ * were invalidated since then.
+ */
+void SourceBindingCache::put(int32_t zoneUIN, const InetAddress& addr, const char *hostName, uint32_t nodeId, uint32_t generation)
+{
+   if ((m_ttl == 0) || (generation != static_cast<uint32_t>(s_generation)))
+      return;
+
+   SourceBindingKey key;
+   buildKey(&key, zoneUIN, addr, hostName);
+   time_t now = time(nullptr);
+
+   m_lock.lock();
+   SourceBindingEntry *entry = m_entries.get(key);
+   if (entry == nullptr)
+   {
+      if (m_entries.size() >= m_maxSize)
+         purge(now);
+      entry = new SourceBindingEntry;
+      m_entries.set(key, entry);
+   }
+   entry->nodeId = nodeId;
+   entry->generation = generation;   // if invalidated after check above, entry will be ignored by get()
+   entry->expirationTime = now + m_ttl;
+   m_lock.unlock();
+}
+
+/**
+ * Get cache statistics
+ */
+void SourceBindingCache::getStatistics(uint64_t *hits, uint64_t *misses, int *size)
+{
+   m_lock.lock();
+   *hits = m_hits;
+   *misses = m_misses;
+   *size = m_entries.size();
+   m_lock.unlock();
+}
+
+/**
+ * Show statistics for all source binding caches on server console
+ */
+void ShowSourceBindingCacheStatistics(ServerConsole *console)
+{
+   console->print(_T("\x1b[1mCache           | Size   | Hits         | Misses       | Hit ratio\x1b[0m\n"));
+   console->print(_T("----------------+--------+--------------+--------------+----------\n"));
+   s_cachesLock.lock();
+   for(int i = 0; i < s_caches.size(); i++)
+   {
+      SourceBindingCache *cache = s_caches.get(i);
+      uint64_t hits, misses;
+      int size;
+      cache->getStatistics(&hits, &misses, &size);
+      TCHAR hitsText[32], missesText[32];
+      _sntprintf(hitsText, 32, UINT64_FMT, hits);
+      _sntprintf(missesText, 32, UINT64_FMT, misses);
+      console->printf(_T("%-15s | %6d | %12s | %12s | %8.2f%%\n"), cache->getName(), size, hitsText, missesText,
+               (hits + misses > 0) ? static_cast<double>(hits) * 100.0 / static_cast<double>(hits + misses) : 0.0);
+   }
+   s_cachesLock.unlock();
+   console->printf(_T("\nCache generation: %d\n\n"), static_cast<int>(s_generation));
+}
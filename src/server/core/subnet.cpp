@@ -177,19 +177,23 @@ void Subnet::setCorrectMask(const InetAddress& addr)
       _sntprintf(m_name, MAX_OBJECT_NAME, _T("%s/%d"), addr.toString(szBuffer), addr.getMaskBits());
 	}
 
-	bool reAdd = !m_ipAddress.equals(addr);
-   if (reAdd)
+	// Subnet should be re-indexed even if only mask was changed to keep prefix tree up to date
+   shared_ptr<Zone> zone = IsZoningEnabled() ? FindZoneByUIN(m_zoneUIN) : shared_ptr<Zone>();
+	if (!m_ipAddress.equals(addr))
    {
-      g_idxSubnetByAddr.remove(m_ipAddress);
+      if (zone != nullptr)
+         zone->removeFromSubnetIndex(m_ipAddress);
+      else if (!IsZoningEnabled())
+         g_idxSubnetByAddr.remove(m_ipAddress);
    }
 
 	m_ipAddress = addr;
 	m_bSyntheticMask = false;
 
-	if (reAdd)
-   {
+   if (zone != nullptr)
+      zone->addToIndex(m_ipAddress, self());
+   else if (!IsZoningEnabled())
       g_idxSubnetByAddr.put(m_ipAddress, self());
-   }
 	setModified(MODIFY_OTHER);
 	unlockProperties();
 }
@@ -35,6 +35,12 @@ ThreadPool *g_syncerThreadPool = nullptr;
  */
 static VolatileCounter s_outstandingSaveRequests = 0;
 
+/**
+ * Modified objects queue
+ */
+static SharedObjectArray<NetObj> *s_modifiedObjects = new SharedObjectArray<NetObj>(1024, 1024);
+static Mutex s_modifiedObjectsLock(true);
+
 /**
  * Object transaction lock
  */
@@ -44,8 +50,11 @@ static RWLOCK s_objectTxnLock = RWLockCreate();
  * Syncer run time statistic
  */
 static ManualGauge64 s_syncerRunTime(_T("Syncer"), 5, 900);
+static ManualGauge64 s_syncerStatements(_T("SyncerStatements"), 5, 900);
 static Mutex s_syncerGaugeLock(true);
 static time_t s_lastRunTime = 0;
+static int s_lastObjectsSaved = 0;
+static UINT64 s_statementsExecuted = 0;
 
 /**
  * Get syncer run time
@@ -86,9 +95,15 @@ void ShowSyncerStats(ServerConsole *console)
             _T("Last run time .......: %d ms\n")
             _T("Max run time ........: %d ms\n")
             _T("Min run time ........: %d ms\n")
+            _T("Objects saved .......: %d\n")
+            _T("Statements executed .: %d\n")
+            _T("Average statements ..: %d\n")
+            _T("Max statements ......: %d\n")
             _T("\n"), FormatTimestamp(s_lastRunTime, runTime),
             s_syncerRunTime.getCurrent(), s_syncerRunTime.getAverage(),
-            s_syncerRunTime.getMax(), s_syncerRunTime.getMin());
+            s_syncerRunTime.getMax(), s_syncerRunTime.getMin(),
+            s_lastObjectsSaved, static_cast<int>(s_syncerStatements.getCurrent()),
+            static_cast<int>(s_syncerStatements.getAverage()), static_cast<int>(s_syncerStatements.getMax()));
    s_syncerGaugeLock.unlock();
 }
 
@@ -111,27 +126,62 @@ void NXCORE_EXPORTABLE ObjectTransactionEnd()
 }
 
 /**
- * Save object to database on separate thread
+ * Put object into modified objects queue. Should be called only by NetObj::enqueueForSync().
  */
-static void SaveObject(NetObj *object)
+void EnqueueModifiedObject(const shared_ptr<NetObj>& object)
 {
-   DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+   s_modifiedObjectsLock.lock();
+   s_modifiedObjects->add(object);
+   s_modifiedObjectsLock.unlock();
+}
+
+/**
+ * Add number of statements executed during save to syncer statistics
+ */
+static inline void UpdateStatementsExecuted(UINT64 count)
+{
+   s_syncerGaugeLock.lock();
+   s_statementsExecuted += count;
+   s_syncerGaugeLock.unlock();
+}
+
+/**
+ * Save object to database and return number of non-SELECT statements executed. Count includes
+ * statements for class-specific tables and data collection items, but one statement may affect
+ * any number of rows (or none), so this is a measure of database round trips, not of rows written.
+ */
+static UINT64 SaveObjectToDatabase(DB_HANDLE hdb, NetObj *object)
+{
+   UINT64 startCount = DBGetNonSelectQueryCount(hdb);
    DBBegin(hdb);
    if (object->saveToDatabase(hdb))
    {
       DBCommit(hdb);
       object->markAsSaved();
+      MemoryAccountingUpdateObject(object);
    }
    else
    {
       DBRollback(hdb);
+      object->enqueueForSync();  // retry on next run
    }
+   return DBGetNonSelectQueryCount(hdb) - startCount;
+}
+
+/**
+ * Save object to database on separate thread
+ */
+static void SaveObject(NetObj *object)
+{
+   DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+   UpdateStatementsExecuted(SaveObjectToDatabase(hdb, object));
    DBConnectionPoolReleaseConnection(hdb);
    InterlockedDecrement(&s_outstandingSaveRequests);
 }
 
 /**
- * Save objects to database
+ * Save objects to database. Only objects from modified objects queue are processed unless
+ * saveRuntimeData is set (on shutdown), in which case all objects are checked.
  */
 void SaveObjects(DB_HANDLE hdb, UINT32 watchdogId, bool saveRuntimeData)
 {
@@ -140,13 +190,44 @@ void SaveObjects(DB_HANDLE hdb, UINT32 watchdogId, bool saveRuntimeData)
    if (g_flags & AF_ENABLE_OBJECT_TRANSACTIONS)
       RWLockWriteLock(s_objectTxnLock);
 
-	SharedObjectArray<NetObj> *objects = g_idxObjectById.getObjects();
+   s_syncerGaugeLock.lock();
+   s_statementsExecuted = 0;
+   s_syncerGaugeLock.unlock();
+   UINT64 startCount = DBGetNonSelectQueryCount(hdb);
+
+   SharedObjectArray<NetObj> *objects;
+   if (saveRuntimeData)
+   {
+      objects = g_idxObjectById.getObjects();
+   }
+   else
+   {
+      s_modifiedObjectsLock.lock();
+      objects = s_modifiedObjects;
+      s_modifiedObjects = new SharedObjectArray<NetObj>(1024, 1024);
+      s_modifiedObjectsLock.unlock();
+   }
    nxlog_debug_tag(DEBUG_TAG_SYNC, 5, _T("%d objects to process"), objects->size());
+
+   int savedObjects = 0;
 	for(int i = 0; i < objects->size(); i++)
    {
 	   WatchdogNotify(watchdogId);
    	NetObj *object = objects->get(i);
    	nxlog_debug_tag(DEBUG_TAG_OBJECT_SYNC, 8, _T("Object %s [%d] at index %d"), object->getName(), object->getId(), i);
+   	if (!saveRuntimeData)
+   	{
+   	   object->clearSyncQueuedFlag();
+   	   if (g_idxObjectById.get(object->getId()).get() != object)
+   	   {
+   	      // Object is either not registered yet or already removed from index. Keep it
+   	      // in the queue while it is referenced from elsewhere and not deleted.
+   	      if (!object->isDeleted() && (objects->getShared(i).use_count() > 1))
+   	         object->enqueueForSync();
+   	      continue;
+   	   }
+   	}
+
       if (object->isDeleted())
       {
          nxlog_debug_tag(DEBUG_TAG_OBJECT_SYNC, 5, _T("Object %s [%d] marked for deletion"), object->getName(), object->getId());
@@ -158,16 +239,19 @@ void SaveObjects(DB_HANDLE hdb, UINT32 watchdogId, bool saveRuntimeData)
 
             // Remove object from global object index by ID
             g_idxObjectById.remove(object->getId());
+            MemoryAccountingRemoveObject(object);
          }
          else
          {
             DBRollback(hdb);
+            object->enqueueForSync();  // retry on next run
             nxlog_debug_tag(DEBUG_TAG_OBJECT_SYNC, 4, _T("Call to deleteFromDatabase() failed for object %s [%d], transaction rollback"), object->getName(), object->getId());
          }
       }
 		else if (object->isModified())
 		{
 		   nxlog_debug_tag(DEBUG_TAG_OBJECT_SYNC, 5, _T("Object %s [%d] modified"), object->getName(), object->getId());
+		   savedObjects++;
 		   if (g_syncerThreadPool != nullptr)
 		   {
 		      InterlockedIncrement(&s_outstandingSaveRequests);
@@ -175,16 +259,7 @@ void SaveObjects(DB_HANDLE hdb, UINT32 watchdogId, bool saveRuntimeData)
 		   }
 		   else
 		   {
-            DBBegin(hdb);
-            if (object->saveToDatabase(hdb))
-            {
-               DBCommit(hdb);
-               object->markAsSaved();
-            }
-            else
-            {
-               DBRollback(hdb);
-            }
+		      SaveObjectToDatabase(hdb, object);
 		   }
 		}
 		else if (saveRuntimeData)
@@ -206,7 +281,15 @@ void SaveObjects(DB_HANDLE hdb, UINT32 watchdogId, bool saveRuntimeData)
    if (g_flags & AF_ENABLE_OBJECT_TRANSACTIONS)
       RWLockUnlock(s_objectTxnLock);
 	delete objects;
-	nxlog_debug_tag(DEBUG_TAG_SYNC, 5, _T("Save objects completed"));
+
+   s_syncerGaugeLock.lock();
+   s_statementsExecuted += DBGetNonSelectQueryCount(hdb) - startCount;
+   UINT64 statementsExecuted = s_statementsExecuted;
+   s_syncerStatements.update(static_cast<int64_t>(statementsExecuted));
+   s_lastObjectsSaved = savedObjects;
+   s_syncerGaugeLock.unlock();
+
+	nxlog_debug_tag(DEBUG_TAG_SYNC, 5, _T("Save objects completed (%d objects saved, ") UINT64_FMT _T(" statements executed)"), savedObjects, statementsExecuted);
 }
 
 /**
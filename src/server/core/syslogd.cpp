@@ -26,6 +26,15 @@
 
 #define DEBUG_TAG _T("syslog")
 
+/**
+ * Registered debug tag (registered on first use, so it is safe to call before server initialization)
+ */
+static inline const DebugTagHandle *DebugTag()
+{
+   static const DebugTagHandle *handle = nxlog_register_debug_tag(DEBUG_TAG);
+   return handle;
+}
+
 /**
  * Max syslog message length
  */
@@ -69,16 +78,42 @@ class QueuedSyslogMessage
 };
 
 /**
- * Queues
+ * Max number of datagrams read from socket in one system call
  */
-Queue g_syslogProcessingQueue(1024, Ownership::False);
-Queue g_syslogWriteQueue(1024, Ownership::False);
+#define RECEIVE_BATCH_SIZE    64
+
+/**
+ * Max number of consecutive batches read from one socket before checking other sockets
+ */
+#define MAX_BATCHES_PER_POLL  16
 
 /**
  * Total number of received syslog messages
  */
 VolatileCounter64 g_syslogMessagesReceived = 0;
 
+/**
+ * Processing queues (one per processing thread)
+ */
+static Queue **s_processingQueues = nullptr;
+static THREAD *s_processingThreads = nullptr;
+static int s_processingThreadCount = 0;
+
+/**
+ * Processing queue limit (total for all processing queues, 0 means unlimited)
+ */
+static size_t s_processingQueueLimit = 0;
+
+/**
+ * Number of messages dropped because processing queue limit was reached
+ */
+static VolatileCounter64 s_queueDrops = 0;
+
+/**
+ * Number of datagrams dropped by OS because socket receive buffer was full (as reported by OS for IPv4 and IPv6 sockets)
+ */
+static uint32_t s_socketDrops[2] = { 0, 0 };
+
 /**
  * Node matching policy
  */
@@ -91,15 +126,15 @@ enum NodeMatchingPolicy
 /**
  * Static data
  */
-static UINT64 s_msgId = 1;
+static VolatileCounter64 s_msgId = 0;  // Last used message ID
 static LogParser *s_parser = nullptr;
 static MUTEX s_parserLock = INVALID_MUTEX_HANDLE;
 static NodeMatchingPolicy s_nodeMatchingPolicy = SOURCE_IP_THEN_HOSTNAME;
 static THREAD s_receiverThread = INVALID_THREAD_HANDLE;
-static THREAD s_processingThread = INVALID_THREAD_HANDLE;
-static THREAD s_writerThread = INVALID_THREAD_HANDLE;
+static BatchLogWriter *s_writer = nullptr;
 static bool s_running = true;
 static bool s_alwaysUseServerTime = false;
+static SourceBindingCache *s_bindingCache = nullptr;
 
 /**
  * Parse timestamp field
@@ -311,39 +346,64 @@ static shared_ptr<Node> FindNodeByHostname(const char *hostName, int32_t zoneUIN
    return node;
 }
 
+/**
+ * Find node by source address and host name according to node matching policy
+ */
+static shared_ptr<Node> FindNodeBySource(const char *hostName, const InetAddress& sourceAddr, int32_t zoneUIN)
+{
+   shared_ptr<Node> node;
+   if (s_nodeMatchingPolicy == SOURCE_IP_THEN_HOSTNAME)
+   {
+      node = FindNodeByIP(zoneUIN, (g_flags & AF_TRAP_SOURCES_IN_ALL_ZONES) != 0, sourceAddr);
+      if (node == nullptr)
+      {
+         node = FindNodeByHostname(hostName, zoneUIN);
+      }
+   }
+   else
+   {
+      node = FindNodeByHostname(hostName, zoneUIN);
+      if (node == nullptr)
+      {
+         node = FindNodeByIP(zoneUIN, (g_flags & AF_TRAP_SOURCES_IN_ALL_ZONES) != 0, sourceAddr);
+      }
+   }
+   return node;
+}
+
 /**
  * Bind syslog message to NetXMS node object
  * sourceAddr is an IP address from which we receive message
  */
 static shared_ptr<Node> BindMsgToNode(NX_SYSLOG_RECORD *pRec, const InetAddress& sourceAddr, int32_t zoneUIN, uint32_t nodeId)
 {
-   nxlog_debug_tag(DEBUG_TAG, 6, _T("BindMsgToNode: addr=%s zoneUIN=%d"), (const TCHAR *)sourceAddr.toString(), zoneUIN);
+   if (nxlog_is_debug_enabled(DebugTag(), 6))
+      nxlog_debug_tag(DebugTag(), 6, _T("BindMsgToNode: addr=%s zoneUIN=%d"), (const TCHAR *)sourceAddr.toString(), zoneUIN);
 
    shared_ptr<Node> node;
    if (nodeId != 0)
    {
-      nxlog_debug_tag(DEBUG_TAG, 6, _T("BindMsgToNode: node ID explicitly set to %d"), nodeId);
+      nxlog_debug_tag(DebugTag(), 6, _T("BindMsgToNode: node ID explicitly set to %d"), nodeId);
       node = static_pointer_cast<Node>(FindObjectById(nodeId, OBJECT_NODE));
    }
    else if (sourceAddr.isLoopback() && (zoneUIN == 0))
    {
-      nxlog_debug_tag(DEBUG_TAG, 6, _T("BindMsgToNode: source is loopback in default zone, binding to management node (ID %d)"), g_dwMgmtNode);
+      nxlog_debug_tag(DebugTag(), 6, _T("BindMsgToNode: source is loopback in default zone, binding to management node (ID %d)"), g_dwMgmtNode);
       node = static_pointer_cast<Node>(FindObjectById(g_dwMgmtNode, OBJECT_NODE));
    }
-   else if (s_nodeMatchingPolicy == SOURCE_IP_THEN_HOSTNAME)
+   else
    {
-      node = FindNodeByIP(zoneUIN, (g_flags & AF_TRAP_SOURCES_IN_ALL_ZONES) != 0, sourceAddr);
-      if (node == nullptr)
+      uint32_t cachedNodeId, generation;
+      if (s_bindingCache->get(zoneUIN, sourceAddr, pRec->szHostName, &cachedNodeId, &generation))
       {
-         node = FindNodeByHostname(pRec->szHostName, zoneUIN);
+         nxlog_debug_tag(DebugTag(), 6, _T("BindMsgToNode: cached binding to node ID %u"), cachedNodeId);
+         if (cachedNodeId != 0)
+            node = static_pointer_cast<Node>(FindObjectById(cachedNodeId, OBJECT_NODE));
       }
-   }
-   else
-   {
-      node = FindNodeByHostname(pRec->szHostName, zoneUIN);
-      if (node == nullptr)
+      else
       {
-         node = FindNodeByIP(zoneUIN, (g_flags & AF_TRAP_SOURCES_IN_ALL_ZONES) != 0, sourceAddr);
+         node = FindNodeBySource(pRec->szHostName, sourceAddr, zoneUIN);
+         s_bindingCache->put(zoneUIN, sourceAddr, pRec->szHostName, (node != nullptr) ? node->getId() : 0, generation);
       }
    }
 
@@ -383,70 +443,20 @@ static void BroadcastSyslogMessage(ClientSession *pSession, void *pArg)
 }
 
 /**
- * Syslog writer thread
+ * Set syslog table columns for bulk insert
  */
-static THREAD_RESULT THREAD_CALL SyslogWriterThread(void *arg)
+static void SetSyslogRowValues(DB_BULK_INSERT bi, const void *record)
 {
-   ThreadSetName("SyslogWriter");
-   nxlog_debug_tag(DEBUG_TAG, 1, _T("Syslog writer thread started"));
-   int maxRecords = ConfigReadInt(_T("DBWriter.MaxRecordsPerTransaction"), 1000);
-   while(true)
-   {
-      NX_SYSLOG_RECORD *r = (NX_SYSLOG_RECORD *)g_syslogWriteQueue.getOrBlock();
-      if (r == INVALID_POINTER_VALUE)
-         break;
-
-      DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
-
-      DB_STATEMENT hStmt = DBPrepare(hdb, _T("INSERT INTO syslog (msg_id,msg_timestamp,facility,severity,source_object_id,zone_uin,hostname,msg_tag,msg_text) VALUES (?,?,?,?,?,?,?,?,?)"), true);
-      if (hStmt == nullptr)
-      {
-         MemFree(r);
-         DBConnectionPoolReleaseConnection(hdb);
-         continue;
-      }
-
-      int count = 0;
-      DBBegin(hdb);
-      while(true)
-      {
-         DBBind(hStmt, 1, DB_SQLTYPE_BIGINT, r->qwMsgId);
-         DBBind(hStmt, 2, DB_SQLTYPE_INTEGER, (INT32)r->tmTimeStamp);
-         DBBind(hStmt, 3, DB_SQLTYPE_INTEGER, r->nFacility);
-         DBBind(hStmt, 4, DB_SQLTYPE_INTEGER, r->nSeverity);
-         DBBind(hStmt, 5, DB_SQLTYPE_INTEGER, r->dwSourceObject);
-         DBBind(hStmt, 6, DB_SQLTYPE_INTEGER, r->zoneUIN);
-#ifdef UNICODE
-         DBBind(hStmt, 7, DB_SQLTYPE_VARCHAR, WideStringFromMBString(r->szHostName), DB_BIND_DYNAMIC);
-         DBBind(hStmt, 8, DB_SQLTYPE_VARCHAR, WideStringFromMBString(r->szTag), DB_BIND_DYNAMIC);
-         DBBind(hStmt, 9, DB_SQLTYPE_VARCHAR, WideStringFromMBString(r->szMessage), DB_BIND_DYNAMIC);
-#else
-         DBBind(hStmt, 7, DB_SQLTYPE_VARCHAR, r->szHostName, DB_BIND_STATIC);
-         DBBind(hStmt, 8, DB_SQLTYPE_VARCHAR, r->szTag, DB_BIND_STATIC);
-         DBBind(hStmt, 9, DB_SQLTYPE_VARCHAR, r->szMessage, DB_BIND_STATIC);
-#endif
-
-         if (!DBExecute(hStmt))
-         {
-            free(r);
-            break;
-         }
-         free(r);
-         count++;
-         if (count == maxRecords)
-            break;
-         r = (NX_SYSLOG_RECORD *)g_syslogWriteQueue.get();
-         if ((r == nullptr) || (r == INVALID_POINTER_VALUE))
-            break;
-      }
-      DBCommit(hdb);
-      DBFreeStatement(hStmt);
-      DBConnectionPoolReleaseConnection(hdb);
-      if (r == INVALID_POINTER_VALUE)
-         break;
-   }
-   nxlog_debug_tag(DEBUG_TAG, 1, _T("Syslog writer thread stopped"));
-   return THREAD_OK;
+   auto r = static_cast<const NX_SYSLOG_RECORD*>(record);
+   DBBulkInsertSet(bi, 1, static_cast<UINT64>(r->qwMsgId));
+   DBBulkInsertSet(bi, 2, static_cast<INT32>(r->tmTimeStamp));
+   DBBulkInsertSet(bi, 3, static_cast<INT32>(r->nFacility));
+   DBBulkInsertSet(bi, 4, static_cast<INT32>(r->nSeverity));
+   DBBulkInsertSet(bi, 5, static_cast<UINT32>(r->dwSourceObject));
+   DBBulkInsertSet(bi, 6, static_cast<INT32>(r->zoneUIN));
+   DBBulkInsertSetMB(bi, 7, r->szHostName);
+   DBBulkInsertSetMB(bi, 8, r->szTag);
+   DBBulkInsertSetMB(bi, 9, r->szMessage);
 }
 
 /**
@@ -456,22 +466,25 @@ static void ProcessSyslogMessage(QueuedSyslogMessage *msg)
 {
    NX_SYSLOG_RECORD record;
 
-	nxlog_debug_tag(DEBUG_TAG, 6, _T("ProcessSyslogMessage: Raw syslog message to process:\n%hs"), msg->message);
+	nxlog_debug_tag(DebugTag(), 6, _T("ProcessSyslogMessage: Raw syslog message to process:\n%hs"), msg->message);
    if (ParseSyslogMessage(msg->message, msg->messageLength, msg->timestamp, &record))
    {
       InterlockedIncrement64(&g_syslogMessagesReceived);
 
-      record.qwMsgId = s_msgId++;
+      record.qwMsgId = InterlockedIncrement64(&s_msgId);
       shared_ptr<Node> node = BindMsgToNode(&record, msg->sourceAddr, msg->zoneUIN, msg->nodeId);
 
-      g_syslogWriteQueue.put(MemCopyBlock(&record, sizeof(NX_SYSLOG_RECORD)));
+      s_writer->put(MemCopyBlock(&record, sizeof(NX_SYSLOG_RECORD)));
 
       // Send message to all connected clients
       EnumerateClientSessions(BroadcastSyslogMessage, &record);
 
-		TCHAR ipAddr[64];
-		nxlog_debug_tag(DEBUG_TAG, 6, _T("Syslog message: ipAddr=%s zone=%d objectId=%d tag=\"%hs\" msg=\"%hs\""),
+		if (nxlog_is_debug_enabled(DebugTag(), 6))
+		{
+		   TCHAR ipAddr[64];
+		   nxlog_debug_tag(DebugTag(), 6, _T("Syslog message: ipAddr=%s zone=%d objectId=%d tag=\"%hs\" msg=\"%hs\""),
 		            msg->sourceAddr.toString(ipAddr), msg->zoneUIN, record.dwSourceObject, record.szTag, record.szMessage);
+		}
 
 		MutexLock(s_parserLock);
 		if ((record.dwSourceObject != 0) && (s_parser != nullptr) &&
@@ -491,25 +504,26 @@ static void ProcessSyslogMessage(QueuedSyslogMessage *msg)
 
 	   if ((record.dwSourceObject == 0) && (g_flags & AF_SYSLOG_DISCOVERY))  // unknown node, discovery enabled
 	   {
-	      nxlog_debug_tag(DEBUG_TAG, 4, _T("ProcessSyslogMessage: source not matched to node, adding new IP address %s for discovery"), msg->sourceAddr.toString(ipAddr));
+	      nxlog_debug_tag(DebugTag(), 4, _T("ProcessSyslogMessage: source not matched to node, adding new IP address %s for discovery"), (const TCHAR *)msg->sourceAddr.toString());
 	      CheckPotentialNode(msg->sourceAddr, msg->zoneUIN, DA_SRC_SYSLOG, 0);
 	   }
    }
 	else
 	{
-		nxlog_debug_tag(DEBUG_TAG, 6, _T("ProcessSyslogMessage: Cannot parse syslog message"));
+		nxlog_debug_tag(DebugTag(), 6, _T("ProcessSyslogMessage: Cannot parse syslog message"));
 	}
 }
 
 /**
  * Syslog processing thread
  */
-static THREAD_RESULT THREAD_CALL SyslogProcessingThread(void *pArg)
+static THREAD_RESULT THREAD_CALL SyslogProcessingThread(void *arg)
 {
    ThreadSetName("SyslogProcessor");
+   Queue *queue = static_cast<Queue*>(arg);
    while(true)
    {
-      QueuedSyslogMessage *msg = (QueuedSyslogMessage *)g_syslogProcessingQueue.getOrBlock();
+      QueuedSyslogMessage *msg = static_cast<QueuedSyslogMessage*>(queue->getOrBlock());
       if (msg == INVALID_POINTER_VALUE)
          break;
 
@@ -519,12 +533,44 @@ static THREAD_RESULT THREAD_CALL SyslogProcessingThread(void *pArg)
    return THREAD_OK;
 }
 
+/**
+ * Put message into processing queue. Queue is selected by source address, so all messages
+ * from same source are processed by same thread in the order they were received.
+ */
+static void PutMessageToProcessingQueue(const InetAddress& addr, QueuedSyslogMessage *msg)
+{
+   uint32_t hash;
+   if (addr.getFamily() == AF_INET6)
+   {
+      const BYTE *a = addr.getAddressV6();
+      hash = (static_cast<uint32_t>(a[12]) << 24) | (static_cast<uint32_t>(a[13]) << 16) | (static_cast<uint32_t>(a[14]) << 8) | static_cast<uint32_t>(a[15]);
+   }
+   else
+   {
+      hash = addr.getAddressV4();
+   }
+   hash ^= hash >> 16;
+   hash *= 0x45D9F3B;
+   hash ^= hash >> 16;
+
+   Queue *queue = s_processingQueues[hash % s_processingThreadCount];
+   if ((s_processingQueueLimit > 0) && (queue->size() >= s_processingQueueLimit / s_processingThreadCount))
+   {
+      uint64_t drops = static_cast<uint64_t>(InterlockedIncrement64(&s_queueDrops));
+      if ((drops % 10000) == 1)
+         nxlog_debug_tag(DebugTag(), 3, _T("Syslog processing queue limit reached, ") UINT64_FMT _T(" messages dropped so far"), drops);
+      delete msg;
+      return;
+   }
+   queue->put(msg);
+}
+
 /**
  * Queue syslog message for processing
  */
-static void QueueSyslogMessage(char *msg, int msgLen, const InetAddress& sourceAddr)
+static inline void QueueSyslogMessage(char *msg, int msgLen, const InetAddress& sourceAddr)
 {
-   g_syslogProcessingQueue.put(new QueuedSyslogMessage(sourceAddr, msg, msgLen));
+   PutMessageToProcessingQueue(sourceAddr, new QueuedSyslogMessage(sourceAddr, msg, msgLen));
 }
 
 /**
@@ -532,7 +578,38 @@ static void QueueSyslogMessage(char *msg, int msgLen, const InetAddress& sourceA
  */
 void QueueProxiedSyslogMessage(const InetAddress &addr, int32_t zoneUIN, UINT32 nodeId, time_t timestamp, const char *msg, int msgLen)
 {
-   g_syslogProcessingQueue.put(new QueuedSyslogMessage(addr, timestamp, zoneUIN, nodeId, msg, msgLen));
+   if (s_processingThreadCount == 0)
+      return;  // Syslog daemon not initialized
+   PutMessageToProcessingQueue(addr, new QueuedSyslogMessage(addr, timestamp, zoneUIN, nodeId, msg, msgLen));
+}
+
+/**
+ * Get size of syslog writer queue
+ */
+int64_t GetSyslogWriterQueueSize()
+{
+   return (s_writer != nullptr) ? s_writer->getQueue()->size() : 0;
+}
+
+/**
+ * Get total size of syslog processing queues
+ */
+int64_t GetSyslogProcessingQueueSize()
+{
+   int64_t size = 0;
+   for(int i = 0; i < s_processingThreadCount; i++)
+      size += s_processingQueues[i]->size();
+   return size;
+}
+
+/**
+ * Get syslog receiver statistics
+ */
+void GetSyslogReceiverStats(uint64_t *queueDrops, uint64_t *socketDrops, uint64_t *queueLimit)
+{
+   *queueDrops = static_cast<uint64_t>(s_queueDrops);
+   *socketDrops = static_cast<uint64_t>(s_socketDrops[0]) + static_cast<uint64_t>(s_socketDrops[1]);
+   *queueLimit = s_processingQueueLimit;
 }
 
 /**
@@ -543,7 +620,7 @@ static void SyslogParserCallback(UINT32 eventCode, const TCHAR *eventName, const
          const StringList *variables, UINT64 recordId, UINT32 objectId, int repeatCount, time_t timestamp,
          const TCHAR *agentAction, const StringList *agentActionArgs, void *context)
 {
-	nxlog_debug_tag(DEBUG_TAG, 7, _T("Syslog message matched, capture group count = %d, repeat count = %d"), captureGroups->size(), repeatCount);
+	nxlog_debug_tag(DebugTag(), 7, _T("Syslog message matched, capture group count = %d, repeat count = %d"), captureGroups->size(), repeatCount);
 
 	StringMap pmap;
 	for(int i = 0; i < captureGroups->size(); i++)
@@ -605,7 +682,7 @@ static void CreateParserFromConfig()
 			s_parser->setCallback(SyslogParserCallback);
 			if (prev != nullptr)
 			   s_parser->restoreCounters(prev);
-			nxlog_debug_tag(DEBUG_TAG, 3, _T("Syslog parser successfully created from config"));
+			nxlog_debug_tag(DebugTag(), 3, _T("Syslog parser successfully created from config"));
 		}
 		else
 		{
@@ -618,6 +695,131 @@ static void CreateParserFromConfig()
 	delete prev;
 }
 
+/**
+ * Buffers for batched socket reads
+ */
+struct ReceiveBatch
+{
+#if HAVE_RECVMMSG
+   struct mmsghdr headers[RECEIVE_BATCH_SIZE];
+   struct iovec iov[RECEIVE_BATCH_SIZE];
+#ifdef SO_RXQ_OVFL
+   char control[RECEIVE_BATCH_SIZE][CMSG_SPACE(sizeof(uint32_t))];
+#endif
+#endif
+   SockAddrBuffer addr[RECEIVE_BATCH_SIZE];
+   char data[RECEIVE_BATCH_SIZE][MAX_SYSLOG_MSG_LEN + 1];
+};
+
+#if HAVE_RECVMMSG
+
+/**
+ * Read pending datagrams from socket using batched reads. Number of datagrams
+ * dropped by OS on that socket is stored in socketDrops if OS reports it.
+ * Returns false on socket error.
+ */
+static bool ReceiveMessages(SOCKET s, ReceiveBatch *batch, uint32_t *socketDrops)
+{
+   for(int n = 0; n < MAX_BATCHES_PER_POLL; n++)
+   {
+      for(int i = 0; i < RECEIVE_BATCH_SIZE; i++)
+      {
+         batch->iov[i].iov_base = batch->data[i];
+         batch->iov[i].iov_len = MAX_SYSLOG_MSG_LEN;
+         struct msghdr *h = &batch->headers[i].msg_hdr;
+         h->msg_name = &batch->addr[i];
+         h->msg_namelen = sizeof(SockAddrBuffer);
+         h->msg_iov = &batch->iov[i];
+         h->msg_iovlen = 1;
+#ifdef SO_RXQ_OVFL
+         h->msg_control = batch->control[i];
+         h->msg_controllen = sizeof(batch->control[i]);
+#else
+         h->msg_control = nullptr;
+         h->msg_controllen = 0;
+#endif
+         h->msg_flags = 0;
+      }
+
+      int count = recvmmsg(s, batch->headers, RECEIVE_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+      if (count < 0)
+         return (errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR);
+
+      for(int i = 0; i < count; i++)
+      {
+         int bytes = static_cast<int>(batch->headers[i].msg_len);
+         if (bytes > 0)
+         {
+            batch->data[i][bytes] = 0;
+            QueueSyslogMessage(batch->data[i], bytes, InetAddress::createFromSockaddr(reinterpret_cast<struct sockaddr*>(&batch->addr[i])));
+         }
+#ifdef SO_RXQ_OVFL
+         struct msghdr *h = &batch->headers[i].msg_hdr;
+         for(struct cmsghdr *c = CMSG_FIRSTHDR(h); c != nullptr; c = CMSG_NXTHDR(h, c))
+         {
+            if ((c->cmsg_level == SOL_SOCKET) && (c->cmsg_type == SO_RXQ_OVFL))
+               memcpy(socketDrops, CMSG_DATA(c), sizeof(uint32_t));
+         }
+#endif
+      }
+
+      if (count < RECEIVE_BATCH_SIZE)
+         break;   // Socket buffer is empty
+   }
+   return true;
+}
+
+#else
+
+/**
+ * Read pending datagrams from non-blocking socket one by one. Returns false on socket error.
+ */
+static bool ReceiveMessages(SOCKET s, ReceiveBatch *batch, uint32_t *socketDrops)
+{
+   for(int i = 0; i < RECEIVE_BATCH_SIZE * MAX_BATCHES_PER_POLL; i++)
+   {
+      socklen_t addrLen = sizeof(SockAddrBuffer);
+      int bytes = recvfrom(s, batch->data[0], MAX_SYSLOG_MSG_LEN, 0, (struct sockaddr *)&batch->addr[0], &addrLen);
+      if (bytes < 0)
+         return WSAGetLastError() == WSAEWOULDBLOCK;
+      if (bytes > 0)
+      {
+         batch->data[0][bytes] = 0;
+         QueueSyslogMessage(batch->data[0], bytes, InetAddress::createFromSockaddr((struct sockaddr *)&batch->addr[0]));
+      }
+   }
+   return true;
+}
+
+#endif
+
+/**
+ * Configure receive buffer size and drop counter reporting on syslog socket
+ */
+static void SetupReceiverSocket(SOCKET s, int bufferSize)
+{
+   SetSocketNonBlocking(s);
+
+   if (bufferSize > 0)
+   {
+#ifdef SO_RCVBUFFORCE
+      // Try to override system limit first (requires CAP_NET_ADMIN)
+      if (setsockopt(s, SOL_SOCKET, SO_RCVBUFFORCE, (char *)&bufferSize, sizeof(int)) != 0)
+#endif
+      setsockopt(s, SOL_SOCKET, SO_RCVBUF, (char *)&bufferSize, sizeof(int));
+
+      int actualSize = 0;
+      socklen_t len = sizeof(int);
+      getsockopt(s, SOL_SOCKET, SO_RCVBUF, (char *)&actualSize, &len);
+      nxlog_debug_tag(DebugTag(), 3, _T("Syslog receiver socket buffer size set to %d (requested %d)"), actualSize, bufferSize);
+   }
+
+#if HAVE_RECVMMSG && defined(SO_RXQ_OVFL)
+   int on = 1;
+   setsockopt(s, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(int));
+#endif
+}
+
 /**
  * Syslog messages receiver thread
  */
@@ -663,7 +865,7 @@ static THREAD_RESULT THREAD_CALL SyslogReceiver(void *pArg)
    int port = ConfigReadInt(_T("SyslogListenPort"), 514);
    if ((port < 1) || (port > 65535))
    {
-      nxlog_debug_tag(DEBUG_TAG, 2, _T("Invalid syslog listen port number %d, using default"), port);
+      nxlog_debug_tag(DebugTag(), 2, _T("Invalid syslog listen port number %d, using default"), port);
       port = 514;
    }
 
@@ -717,7 +919,7 @@ static THREAD_RESULT THREAD_CALL SyslogReceiver(void *pArg)
    // Bind socket
    TCHAR buffer[64];
    int bindFailures = 0;
-   nxlog_debug_tag(DEBUG_TAG, 5, _T("Trying to bind on UDP %s:%d"), SockaddrToStr((struct sockaddr *)&servAddr, buffer), ntohs(servAddr.sin_port));
+   nxlog_debug_tag(DebugTag(), 5, _T("Trying to bind on UDP %s:%d"), SockaddrToStr((struct sockaddr *)&servAddr, buffer), ntohs(servAddr.sin_port));
    if (bind(hSocket, (struct sockaddr *)&servAddr, sizeof(struct sockaddr_in)) != 0)
    {
       TCHAR buffer[1024];
@@ -728,7 +930,7 @@ static THREAD_RESULT THREAD_CALL SyslogReceiver(void *pArg)
    }
 
 #ifdef WITH_IPV6
-   nxlog_debug_tag(DEBUG_TAG, 5, _T("Trying to bind on UDP [%s]:%d"), SockaddrToStr((struct sockaddr *)&servAddr6, buffer), ntohs(servAddr6.sin6_port));
+   nxlog_debug_tag(DebugTag(), 5, _T("Trying to bind on UDP [%s]:%d"), SockaddrToStr((struct sockaddr *)&servAddr6, buffer), ntohs(servAddr6.sin6_port));
    if (bind(hSocket6, (struct sockaddr *)&servAddr6, sizeof(struct sockaddr_in6)) != 0)
    {
       nxlog_write_tag(NXLOG_ERROR, DEBUG_TAG, _T("Unable to bind IPv6 socket for syslog receiver (%s)"), GetLastSocketErrorText(buffer, 1024));
@@ -743,7 +945,7 @@ static THREAD_RESULT THREAD_CALL SyslogReceiver(void *pArg)
    // Abort if cannot bind to at least one socket
    if (bindFailures == 2)
    {
-      nxlog_debug_tag(DEBUG_TAG, 1, _T("Syslog receiver aborted - cannot bind at least one socket"));
+      nxlog_debug_tag(DebugTag(), 1, _T("Syslog receiver aborted - cannot bind at least one socket"));
       return THREAD_OK;
    }
 
@@ -760,9 +962,18 @@ static THREAD_RESULT THREAD_CALL SyslogReceiver(void *pArg)
    }
 #endif
 
+   int bufferSize = ConfigReadInt(_T("SyslogReceiveBufferSize"), 0);
+   if (hSocket != INVALID_SOCKET)
+      SetupReceiverSocket(hSocket, bufferSize);
+#ifdef WITH_IPV6
+   if (hSocket6 != INVALID_SOCKET)
+      SetupReceiverSocket(hSocket6, bufferSize);
+#endif
+
    SocketPoller sp;
+   ReceiveBatch *batch = MemAllocStruct<ReceiveBatch>();
 
-   nxlog_debug_tag(DEBUG_TAG, 1, _T("Syslog receiver thread started"));
+   nxlog_debug_tag(DebugTag(), 1, _T("Syslog receiver thread started"));
 
    // Wait for packets
    while(s_running)
@@ -778,21 +989,14 @@ static THREAD_RESULT THREAD_CALL SyslogReceiver(void *pArg)
       int rc = sp.poll(1000);
       if (rc > 0)
       {
-         char syslogMessage[MAX_SYSLOG_MSG_LEN + 1];
-         SockAddrBuffer addr;
-         socklen_t addrLen = sizeof(SockAddrBuffer);
+         bool success = true;
+         if ((hSocket != INVALID_SOCKET) && sp.isSet(hSocket))
+            success = ReceiveMessages(hSocket, batch, &s_socketDrops[0]);
 #ifdef WITH_IPV6
-         SOCKET s = sp.isSet(hSocket) ? hSocket : hSocket6;
-#else
-         SOCKET s = hSocket;
+         if ((hSocket6 != INVALID_SOCKET) && sp.isSet(hSocket6))
+            success = ReceiveMessages(hSocket6, batch, &s_socketDrops[1]) && success;
 #endif
-         int bytes = recvfrom(s, syslogMessage, MAX_SYSLOG_MSG_LEN, 0, (struct sockaddr *)&addr, &addrLen);
-         if (bytes > 0)
-         {
-            syslogMessage[bytes] = 0;
-            QueueSyslogMessage(syslogMessage, bytes, InetAddress::createFromSockaddr((struct sockaddr *)&addr));
-         }
-         else
+         if (!success)
          {
             // Sleep on error
             ThreadSleepMs(100);
@@ -805,6 +1009,8 @@ static THREAD_RESULT THREAD_CALL SyslogReceiver(void *pArg)
       }
    }
 
+   MemFree(batch);
+
    if (hSocket != INVALID_SOCKET)
       closesocket(hSocket);
 #ifdef WITH_IPV6
@@ -812,7 +1018,7 @@ static THREAD_RESULT THREAD_CALL SyslogReceiver(void *pArg)
       closesocket(hSocket6);
 #endif
 
-   nxlog_debug_tag(DEBUG_TAG, 1, _T("Syslog receiver thread stopped"));
+   nxlog_debug_tag(DebugTag(), 1, _T("Syslog receiver thread stopped"));
    return THREAD_OK;
 }
 
@@ -852,7 +1058,12 @@ void OnSyslogConfigurationChange(const TCHAR *name, const TCHAR *value)
    if (!_tcscmp(name, _T("SyslogIgnoreMessageTimestamp")))
    {
       s_alwaysUseServerTime = _tcstol(value, nullptr, 0) ? true : false;
-      nxlog_debug_tag(DEBUG_TAG, 4, _T("Ignore message timestamp option set to %s"), s_alwaysUseServerTime ? _T("ON") : _T("OFF"));
+      nxlog_debug_tag(DebugTag(), 4, _T("Ignore message timestamp option set to %s"), s_alwaysUseServerTime ? _T("ON") : _T("OFF"));
+   }
+   else if (!_tcscmp(name, _T("SyslogProcessingQueueLimit")))
+   {
+      s_processingQueueLimit = _tcstoul(value, nullptr, 0);
+      nxlog_debug_tag(DebugTag(), 4, _T("Syslog processing queue limit set to %u"), static_cast<uint32_t>(s_processingQueueLimit));
    }
 }
 
@@ -940,6 +1151,7 @@ void StartSyslogServer()
 {
    s_nodeMatchingPolicy = (NodeMatchingPolicy)ConfigReadInt(_T("SyslogNodeMatchingPolicy"), SOURCE_IP_THEN_HOSTNAME);
    s_alwaysUseServerTime = ConfigReadBoolean(_T("SyslogIgnoreMessageTimestamp"), false);
+   s_bindingCache = new SourceBindingCache(_T("Syslog"));
 
    // Determine first available message id
    DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
@@ -948,7 +1160,9 @@ void StartSyslogServer()
    {
       if (DBGetNumRows(hResult) > 0)
       {
-         s_msgId = std::max(DBGetFieldUInt64(hResult, 0, 0) + 1, s_msgId);
+         uint64_t id = DBGetFieldUInt64(hResult, 0, 0);
+         if (id > static_cast<uint64_t>(s_msgId))
+            s_msgId = id;
       }
       DBFreeResult(hResult);
    }
@@ -960,9 +1174,23 @@ void StartSyslogServer()
    s_parserLock = MutexCreate();
    CreateParserFromConfig();
 
-   // Start processing thread
-   s_processingThread = ThreadCreateEx(SyslogProcessingThread, 0, nullptr);
-   s_writerThread = ThreadCreateEx(SyslogWriterThread, 0, nullptr);
+   // Start processing threads
+   s_processingQueueLimit = ConfigReadULong(_T("SyslogProcessingQueueLimit"), 1000000);
+   s_processingThreadCount = std::max(ConfigReadInt(_T("SyslogProcessingThreads"), 1), 1);
+   s_processingQueues = MemAllocArrayNoInit<Queue*>(s_processingThreadCount);
+   s_processingThreads = MemAllocArrayNoInit<THREAD>(s_processingThreadCount);
+   for(int i = 0; i < s_processingThreadCount; i++)
+   {
+      s_processingQueues[i] = new Queue(1024, Ownership::False);
+      s_processingThreads[i] = ThreadCreateEx(SyslogProcessingThread, 0, s_processingQueues[i]);
+   }
+   nxlog_debug_tag(DebugTag(), 2, _T("%d syslog processing threads started (queue limit %u)"), s_processingThreadCount, static_cast<uint32_t>(s_processingQueueLimit));
+
+   static const int sqlTypes[] = { DB_SQLTYPE_BIGINT, DB_SQLTYPE_INTEGER, DB_SQLTYPE_INTEGER, DB_SQLTYPE_INTEGER, DB_SQLTYPE_INTEGER,
+            DB_SQLTYPE_INTEGER, DB_SQLTYPE_VARCHAR, DB_SQLTYPE_VARCHAR, DB_SQLTYPE_TEXT };
+   s_writer = new BatchLogWriter(_T("Syslog"), _T("syslog"), _T("msg_id,msg_timestamp,facility,severity,source_object_id,zone_uin,hostname,msg_tag,msg_text"),
+            sqlTypes, 9, SetSyslogRowValues);
+   s_writer->start();
 
    if (ConfigReadBoolean(_T("EnableSyslogReceiver"), false))
       s_receiverThread = ThreadCreateEx(SyslogReceiver, 0, nullptr);
@@ -976,14 +1204,20 @@ void StopSyslogServer()
    s_running = false;
    ThreadJoin(s_receiverThread);
 
-   // Stop processing thread
-   g_syslogProcessingQueue.put(INVALID_POINTER_VALUE);
-   ThreadJoin(s_processingThread);
+   // Stop processing threads
+   for(int i = 0; i < s_processingThreadCount; i++)
+      s_processingQueues[i]->put(INVALID_POINTER_VALUE);
+   for(int i = 0; i < s_processingThreadCount; i++)
+      ThreadJoin(s_processingThreads[i]);
 
    // Stop writer thread - it must be done after processing thread already finished
-   g_syslogWriteQueue.put(INVALID_POINTER_VALUE);
-   ThreadJoin(s_writerThread);
+   s_writer->stop();
+   delete s_writer;
+   s_writer = nullptr;
 
    delete s_parser;
    CleanupLogParserLibrary();
+
+   delete s_bindingCache;
+   s_bindingCache = nullptr;
 }
@@ -432,6 +432,16 @@ ObjectUrl::ObjectUrl(DB_RESULT hResult, int row)
    m_description = DBGetField(hResult, row, 2, nullptr, 0);
 }
 
+/**
+ * Create object URL from individual values
+ */
+ObjectUrl::ObjectUrl(uint32_t id, const TCHAR *url, const TCHAR *description)
+{
+   m_id = id;
+   m_url = MemCopyString(url);
+   m_description = MemCopyString(description);
+}
+
 /**
  * Object URL destructor
  */
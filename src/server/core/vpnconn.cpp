@@ -28,6 +28,7 @@
 VPNConnector::VPNConnector() : super()
 {
    m_dwPeerGateway = 0;
+   m_loadedNodeId = 0;
    m_localNetworks = new ObjectArray<InetAddress>(8, 8, Ownership::True);
    m_remoteNetworks = new ObjectArray<InetAddress>(8, 8, Ownership::True);
 }
@@ -38,6 +39,7 @@ VPNConnector::VPNConnector() : super()
 VPNConnector::VPNConnector(bool hidden) : super()
 {
    m_dwPeerGateway = 0;
+   m_loadedNodeId = 0;
    m_localNetworks = new ObjectArray<InetAddress>(8, 8, Ownership::True);
    m_remoteNetworks = new ObjectArray<InetAddress>(8, 8, Ownership::True);
    m_isHidden = hidden;
@@ -90,28 +92,10 @@ bool VPNConnector::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
    bool success = false;
    if (DBGetNumRows(hResult) != 0)
    {
-      UINT32 dwNodeId = DBGetFieldULong(hResult, 0, 0);
+      m_loadedNodeId = DBGetFieldULong(hResult, 0, 0);
       m_dwPeerGateway = DBGetFieldULong(hResult, 0, 1);
 
-      // Link VPN connector to node
-      if (!m_isDeleted)
-      {
-         shared_ptr<NetObj> pObject = FindObjectById(dwNodeId, OBJECT_NODE);
-         if (pObject != nullptr)
-         {
-            pObject->addChild(self());
-            addParent(pObject);
-            success = true;
-         }
-         else
-         {
-            nxlog_write(NXLOG_ERROR, _T("Inconsistent database: VPN connector %s [%u] linked to non-existent node [%u]"), m_name, m_id, dwNodeId);
-         }
-      }
-      else
-      {
-         success = true;
-      }
+      success = true;
    }
 
    DBFreeResult(hResult);
@@ -122,6 +106,26 @@ bool VPNConnector::loadFromDatabase(DB_HANDLE hdb, UINT32 dwId)
    return success;
 }
 
+/**
+ * Link VPN connector to node after loading from database. Called on main thread by startup object loader.
+ */
+bool VPNConnector::linkAfterLoad()
+{
+   if (m_isDeleted)
+      return true;
+
+   shared_ptr<NetObj> node = FindObjectById(m_loadedNodeId, OBJECT_NODE);
+   if (node == nullptr)
+   {
+      nxlog_write(NXLOG_ERROR, _T("Inconsistent database: VPN connector %s [%u] linked to non-existent node [%u]"), m_name, m_id, m_loadedNodeId);
+      return false;
+   }
+
+   node->addChild(self());
+   addParent(node);
+   return true;
+}
+
 /**
  * Save VPN connector object to database
  */
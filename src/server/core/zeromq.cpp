@@ -22,9 +22,273 @@
 
 #include "nxcore.h"
 
+/**
+ * Compact JSON message builder. Produces same output as json_dumps() with default
+ * flags but writes directly into single buffer without building object tree.
+ */
+class MessageBuilder
+{
+private:
+   char *m_buffer;
+   size_t m_size;
+   size_t m_allocated;
+   char m_localBuffer[1024];
+
+   void grow(size_t required)
+   {
+      size_t size = std::max(m_allocated * 2, m_size + required);
+      if (m_buffer == m_localBuffer)
+      {
+         m_buffer = MemAllocArrayNoInit<char>(size);
+         memcpy(m_buffer, m_localBuffer, m_size);
+      }
+      else
+      {
+         m_buffer = MemRealloc(m_buffer, size);
+      }
+      m_allocated = size;
+   }
+
+   void appendUtf8Char(UINT32 ch);
+
+public:
+   MessageBuilder()
+   {
+      m_buffer = m_localBuffer;
+      m_size = 0;
+      m_allocated = sizeof(m_localBuffer);
+   }
+
+   ~MessageBuilder()
+   {
+      if (m_buffer != m_localBuffer)
+         MemFree(m_buffer);
+   }
+
+   void append(const char *s, size_t len)
+   {
+      if (m_size + len > m_allocated)
+         grow(len);
+      memcpy(&m_buffer[m_size], s, len);
+      m_size += len;
+   }
+
+   void append(char c)
+   {
+      if (m_size == m_allocated)
+         grow(1);
+      m_buffer[m_size++] = c;
+   }
+
+   void append(const char *s) { append(s, strlen(s)); }
+   void appendInteger(INT64 n)
+   {
+      char buffer[32];
+      append(buffer, snprintf(buffer, 32, INT64_FMTA, n));
+   }
+   void appendString(const char *s);
+#ifdef UNICODE
+   void appendString(const WCHAR *s);
+#endif
+   void appendKey(const TCHAR *key) { appendString(key); append(": ", 2); }
+
+   ZmqMessage *createMessage() const;
+};
+
+/**
+ * Append character in UTF-8 encoding with JSON escaping
+ */
+void MessageBuilder::appendUtf8Char(UINT32 ch)
+{
+   if (ch < 0x80)
+   {
+      switch(ch)
+      {
+         case '"':
+            append("\\\"", 2);
+            break;
+         case '\\':
+            append("\\\\", 2);
+            break;
+         case '\b':
+            append("\\b", 2);
+            break;
+         case '\f':
+            append("\\f", 2);
+            break;
+         case '\n':
+            append("\\n", 2);
+            break;
+         case '\r':
+            append("\\r", 2);
+            break;
+         case '\t':
+            append("\\t", 2);
+            break;
+         default:
+            if (ch < 0x20)
+            {
+               char buffer[8];
+               snprintf(buffer, 8, "\\u%04X", ch);
+               append(buffer, 6);
+            }
+            else
+            {
+               append(static_cast<char>(ch));
+            }
+            break;
+      }
+   }
+   else if (ch < 0x800)
+   {
+      append(static_cast<char>(0xC0 | (ch >> 6)));
+      append(static_cast<char>(0x80 | (ch & 0x3F)));
+   }
+   else if (ch < 0x10000)
+   {
+      append(static_cast<char>(0xE0 | (ch >> 12)));
+      append(static_cast<char>(0x80 | ((ch >> 6) & 0x3F)));
+      append(static_cast<char>(0x80 | (ch & 0x3F)));
+   }
+   else
+   {
+      append(static_cast<char>(0xF0 | (ch >> 18)));
+      append(static_cast<char>(0x80 | ((ch >> 12) & 0x3F)));
+      append(static_cast<char>(0x80 | ((ch >> 6) & 0x3F)));
+      append(static_cast<char>(0x80 | (ch & 0x3F)));
+   }
+}
+
+/**
+ * Append quoted and escaped string already in UTF-8 (or null if string is NULL)
+ */
+void MessageBuilder::appendString(const char *s)
+{
+   if (s == nullptr)
+   {
+      append("null", 4);
+      return;
+   }
+   append('"');
+   for(const char *p = s; *p != 0; p++)
+   {
+      BYTE ch = static_cast<BYTE>(*p);
+      if (ch < 0x80)
+         appendUtf8Char(ch);
+      else
+         append(static_cast<char>(ch));  // part of multibyte sequence
+   }
+   append('"');
+}
+
+#ifdef UNICODE
+
+/**
+ * Append quoted and escaped string converted to UTF-8 (or null if string is NULL)
+ */
+void MessageBuilder::appendString(const WCHAR *s)
+{
+   if (s == nullptr)
+   {
+      append("null", 4);
+      return;
+   }
+   append('"');
+   for(const WCHAR *p = s; *p != 0; p++)
+   {
+      UINT32 ch = static_cast<UINT32>(*p);
+#ifdef UNICODE_UCS2
+      if ((ch >= 0xD800) && (ch < 0xDC00) && (p[1] >= 0xDC00) && (p[1] < 0xE000))
+      {
+         p++;
+         ch = 0x10000 + ((ch - 0xD800) << 10) + (static_cast<UINT32>(*p) - 0xDC00);
+      }
+#endif
+      appendUtf8Char(ch);
+   }
+   append('"');
+}
+
+#endif
+
+/**
+ * Create message for publisher queue
+ */
+ZmqMessage *MessageBuilder::createMessage() const
+{
+   ZmqMessage *message = static_cast<ZmqMessage*>(MemAlloc(sizeof(ZmqMessage) + m_size));
+   message->length = m_size;
+   memcpy(message->data, m_buffer, m_size);
+   return message;
+}
+
+/**
+ * Serialize event. Output format matches one previously produced by jansson:
+ * {"source": {...}, "arguments": {...}, "id": ..., "time": ..., "code": ..., "severity": ..., "message": "..."}
+ */
+ZmqMessage NXCORE_EXPORTABLE *ZmqSerializeEvent(const Event *event, const NetObj& object)
+{
+   MessageBuilder mb;
+
+   mb.append("{\"source\": {\"id\": ");
+   mb.appendInteger(event->getSourceId());
+   mb.append(", \"type\": ");
+   mb.appendInteger(object.getObjectClass());
+   mb.append(", \"name\": ");
+   mb.appendString(object.getName());
+   if (object.getObjectClass() == OBJECT_NODE)
+   {
+      InetAddress ip = static_cast<const Node&>(object).getIpAddress();
+      char buffer[128];
+      mb.append(", \"primary-ip\": ");
+      mb.appendString(ip.toStringA(buffer));
+   }
+
+   int count = event->getParametersCount();
+   mb.append("}, \"arguments\": {\"count\": ");
+   mb.appendInteger(count);
+   for(int i = 0; i < count; i++)
+   {
+      char name[16];
+      mb.append(name, snprintf(name, 16, ", \"p%d\": ", i + 1));
+      mb.appendString(event->getParameter(i));
+   }
+
+   mb.append("}, \"id\": ");
+   mb.appendInteger(static_cast<INT64>(event->getId()));
+   mb.append(", \"time\": ");
+   mb.appendInteger(static_cast<INT64>(event->getTimestamp()));
+   mb.append(", \"code\": ");
+   mb.appendInteger(event->getCode());
+   mb.append(", \"severity\": ");
+   mb.appendInteger(event->getSeverity());
+   mb.append(", \"message\": ");
+   mb.appendString(event->getMessage());
+   mb.append('}');
+
+   return mb.createMessage();
+}
+
+/**
+ * Serialize DCI value. Output format matches one previously produced by jansson:
+ * {"id": <object ID>, "data": [{"id": <DCI ID>, "<DCI name>": "<value>"}]}
+ */
+ZmqMessage NXCORE_EXPORTABLE *ZmqSerializeData(UINT32 objectId, UINT32 dciId, const TCHAR *dciName, const TCHAR *value)
+{
+   MessageBuilder mb;
+   mb.append("{\"id\": ");
+   mb.appendInteger(objectId);
+   mb.append(", \"data\": [{\"id\": ");
+   mb.appendInteger(dciId);
+   mb.append(", ", 2);
+   mb.appendKey(dciName);
+   mb.appendString(value);
+   mb.append("}]}");
+   return mb.createMessage();
+}
+
 #ifdef WITH_ZMQ
 #include "zeromq.h"
-#include <jansson.h>
 
 #define DB_TYPE_EVENT _T("E")
 #define DB_TYPE_DATA _T("D")
@@ -34,12 +298,32 @@ using namespace zmq;
 
 static void *m_context = nullptr;
 static void *m_socket = nullptr;
-static MUTEX m_socketLock = MutexCreate();
 static HashMap<UINT32, Subscription> m_eventSubscription(Ownership::True);
 static HashMap<UINT32, Subscription> m_dataSubscription(Ownership::True);
 static MUTEX m_eventSubscriptionLock = MutexCreate();
 static MUTEX m_dataSubscriptionLock = MutexCreate();
 
+/**
+ * Read-only copies of subscription maps used by publishing functions. New copy is
+ * created on every subscription change and replaced atomically.
+ */
+typedef HashMap<UINT32, Subscription> SubscriptionMap;
+static shared_ptr<SubscriptionMap> s_eventSnapshot = make_shared<SubscriptionMap>(Ownership::True);
+static shared_ptr<SubscriptionMap> s_dataSnapshot = make_shared<SubscriptionMap>(Ownership::True);
+
+/**
+ * Publisher queue and thread. Publisher thread is the only user of the socket.
+ */
+static Queue s_publisherQueue(1024, Ownership::True);
+static THREAD s_publisherThread = INVALID_THREAD_HANDLE;
+static int s_publisherQueueLimit = 100000;
+
+/**
+ * Publisher statistics
+ */
+static VolatileCounter64 s_messagesSent = 0;
+static VolatileCounter64 s_queueDrops = 0;
+static VolatileCounter64 s_sendFailures = 0;
 
 /******************************************************************************
  * INTERNAL                                                                   *
@@ -60,6 +344,16 @@ Subscription::Subscription(UINT32 objectId, UINT32 dciId)
    }
 }
 
+/**
+ * Subscription object copy constructor
+ */
+Subscription::Subscription(const Subscription& src)
+{
+   objectId = src.objectId;
+   ignoreItems = src.ignoreItems;
+   items = new IntegerArray<UINT32>(src.items);
+}
+
 /**
  * Subscription object destructor
  */
@@ -101,13 +395,37 @@ bool Subscription::removeItem(UINT32 dciId)
 }
 
 /**
- *
+ * Check if given DCI ID matches subscription
  */
-bool Subscription::match(UINT32 dciId)
+bool Subscription::match(UINT32 dciId) const
 {
    return ignoreItems || items->contains(dciId);
 }
 
+/**
+ * Create read-only copy of subscription map. Should be called with map lock held.
+ */
+static shared_ptr<SubscriptionMap> CreateSnapshot(SubscriptionMap *map)
+{
+   auto snapshot = make_shared<SubscriptionMap>(Ownership::True);
+   Iterator<Subscription> *it = map->iterator();
+   while(it->hasNext())
+   {
+      Subscription *sub = it->next();
+      snapshot->set(sub->getObjectId(), new Subscription(*sub));
+   }
+   delete it;
+   return snapshot;
+}
+
+/**
+ * Update read-only copy of subscription map. Should be called with map lock held.
+ */
+static void UpdateSnapshot(SubscriptionMap *map)
+{
+   std::atomic_store((map == &m_eventSubscription) ? &s_eventSnapshot : &s_dataSnapshot, CreateSnapshot(map));
+}
+
 /**
  * Load subscriptions from database
  */
@@ -178,6 +496,9 @@ static void LoadSubscriptions()
          free(items);
       }
 
+      UpdateSnapshot(&m_eventSubscription);
+      UpdateSnapshot(&m_dataSubscription);
+
       MutexUnlock(m_eventSubscriptionLock);
       MutexUnlock(m_dataSubscriptionLock);
 
@@ -263,71 +584,6 @@ static bool SaveSubscriptions()
    return success;
 }
 
-/**
- * Convert event object to JSON representation
- */
-static char *EventToJson(const Event *event, const NetObj& object)
-{
-   json_t *root = json_object();
-   json_t *args = json_object();
-   json_t *source = json_object();
-
-   json_object_set_new(root, "source", source);
-   json_object_set_new(root, "arguments", args);
-
-   json_object_set_new(root, "id", json_integer(event->getId()));
-   json_object_set_new(root, "time", json_integer(event->getTimestamp()));
-   json_object_set_new(root, "code", json_integer(event->getCode()));
-   json_object_set_new(root, "severity", json_integer(event->getSeverity()));
-   json_object_set_new(root, "message", json_string_t(event->getMessage()));
-
-   json_object_set_new(source, "id", json_integer(event->getSourceId()));
-   json_object_set_new(source, "type", json_integer(object.getObjectClass()));
-   json_object_set_new(source, "name", json_string_t(object.getName()));
-   if (object.getObjectClass() == OBJECT_NODE)
-   {
-      InetAddress ip = static_cast<const Node&>(object).getIpAddress();
-      char buffer[128];
-      json_object_set_new(source, "primary-ip", json_string(ip.toStringA(buffer)));
-   }
-
-   int count = event->getParametersCount();
-   json_object_set_new(args, "count", json_integer(count));
-   for (int i = 0; i < count; i++)
-   {
-      char name[16];
-      sprintf(name, "p%d", i + 1);
-      json_object_set_new(args, name, json_string_t(event->getParameter(i)));
-   }
-
-   char *message = json_dumps(root, 0);
-   json_decref(root);
-   return message;
-}
-
-/**
- * Convert DCI value to JSON representation
- */
-static char *DataToJson(const NetObj& object, UINT32 dciId, const TCHAR *dciName, const TCHAR *value)
-{
-   json_t *root = json_object();
-   json_object_set_new(root, "id", json_integer(object.getId()));
-
-   json_t *data = json_array();
-   json_object_set_new(root, "data", data);
-
-   json_t *record = json_object();
-   json_object_set_new(record, "id", json_integer(dciId));
-   char *utf8name = UTF8StringFromTString(dciName);
-   json_object_set_new(record, utf8name, json_string_t(value));
-   MemFree(utf8name);
-   json_array_append_new(data, record);
-
-   char *message = json_dumps(root, 0);
-   json_decref(root);
-   return message;
-}
-
 /**
  * Subscribe
  */
@@ -343,6 +599,7 @@ static bool Subscribe(HashMap<UINT32, Subscription> *map, MUTEX mutex, UINT32 ob
    {
       map->set(objectId, new Subscription(objectId, dciId));
    }
+   UpdateSnapshot(map);
    MutexUnlock(mutex);
 
    SaveSubscriptions();
@@ -370,6 +627,7 @@ static bool Unsubscribe(HashMap<UINT32, Subscription> *map, MUTEX mutex, UINT32
    {
       ret = false;
    }
+   UpdateSnapshot(map);
    MutexUnlock(mutex);
 
    SaveSubscriptions();
@@ -378,6 +636,48 @@ static bool Unsubscribe(HashMap<UINT32, Subscription> *map, MUTEX mutex, UINT32
 }
 
 
+/**
+ * Publisher thread
+ */
+static void PublisherThread()
+{
+   ThreadSetName("ZMQPublisher");
+   DbgPrintf(1, _T("ZeroMQ: publisher thread started"));
+   while(true)
+   {
+      ZmqMessage *message = static_cast<ZmqMessage*>(s_publisherQueue.getOrBlock());
+      if (message == INVALID_POINTER_VALUE)
+         break;
+
+      if (zmq_send(m_socket, message->data, message->length, ZMQ_DONTWAIT) >= 0)
+      {
+         InterlockedIncrement64(&s_messagesSent);
+      }
+      else
+      {
+         InterlockedIncrement64(&s_sendFailures);
+         DbgPrintf(7, _T("ZeroMQ: publish failed (%d)"), errno);
+      }
+      MemFree(message);
+   }
+   DbgPrintf(1, _T("ZeroMQ: publisher thread stopped"));
+}
+
+/**
+ * Put message into publisher queue or drop it if queue limit is reached
+ */
+static void EnqueueMessage(ZmqMessage *message)
+{
+   if ((s_publisherQueueLimit > 0) && (s_publisherQueue.size() >= static_cast<size_t>(s_publisherQueueLimit)))
+   {
+      MemFree(message);
+      if (InterlockedIncrement64(&s_queueDrops) % 1000 == 1)
+         DbgPrintf(4, _T("ZeroMQ: publisher queue limit reached, message dropped (") UINT64_FMT _T(" messages dropped so far)"), static_cast<uint64_t>(s_queueDrops));
+      return;
+   }
+   s_publisherQueue.put(message);
+}
+
 /******************************************************************************
  * PUBLIC                                                                     *
  *****************************************************************************/
@@ -401,11 +701,12 @@ void StartZMQConnector()
       m_socket = zmq_socket(m_context, ZMQ_PUSH);
       if (m_socket != nullptr)
       {
-         MutexLock(m_socketLock);
          if (zmq_connect(m_socket, endpoint) == 0)
          {
             LoadSubscriptions();
-            DbgPrintf(1, _T("ZeroMQ: connector initialised"));
+            s_publisherQueueLimit = ConfigReadInt(_T("ZeroMQPublisherQueueLimit"), 100000);
+            s_publisherThread = ThreadCreateEx(PublisherThread);
+            DbgPrintf(1, _T("ZeroMQ: connector initialised (publisher queue limit %d)"), s_publisherQueueLimit);
          }
          else
          {
@@ -415,7 +716,6 @@ void StartZMQConnector()
             zmq_close(m_socket);
             m_socket = nullptr;
          }
-         MutexUnlock(m_socketLock);
       }
       else
       {
@@ -436,12 +736,18 @@ void StartZMQConnector()
 void StopZMQConnector()
 {
    DbgPrintf(6, _T("ZeroMQ: shutdown initiated"));
+   if (s_publisherThread != INVALID_THREAD_HANDLE)
+   {
+      s_publisherQueue.put(INVALID_POINTER_VALUE);
+      ThreadJoin(s_publisherThread);
+      s_publisherThread = INVALID_THREAD_HANDLE;
+      DbgPrintf(6, _T("ZeroMQ: publisher thread stopped"));
+   }
    if (m_socket != nullptr)
    {
-      MutexLock(m_socketLock);
-      zmq_close(m_socket);
+      void *socket = m_socket;
       m_socket = nullptr;
-      MutexUnlock(m_socketLock);
+      zmq_close(socket);
    }
    DbgPrintf(6, _T("ZeroMQ: socket closed"));
    if (m_context != nullptr)
@@ -461,35 +767,17 @@ void ZmqPublishEvent(const Event *event)
       return;
 
    UINT32 objectId = event->getSourceId();
+   shared_ptr<SubscriptionMap> subscriptions = std::atomic_load(&s_eventSnapshot);
+   const Subscription *sub = subscriptions->get(objectId);
+   if ((sub == nullptr) || !sub->match(event->getDciId()))
+      return;
+
    shared_ptr<NetObj> object = FindObjectById(objectId);
    if (object == nullptr)
       return;
 
-   DbgPrintf(7, _T("ZeroMQ: publish event: %s(%d) from %s(%d)"), event->getName(), event->getCode(), object->getName(), event->getSourceId());
-
-   bool doSend = false;
-   MutexLock(m_eventSubscriptionLock);
-   if (m_eventSubscription.contains(objectId))
-   {
-      Subscription *sub = m_eventSubscription.get(objectId);
-      doSend = sub->match(event->getDciId());
-   }
-   MutexUnlock(m_eventSubscriptionLock);
-
-   if (doSend)
-   {
-      char *message = EventToJson(event, *object);
-      if (message != nullptr)
-      {
-         MutexLock(m_socketLock);
-         if (zmq_send(m_socket, message, strlen(message), ZMQ_DONTWAIT) != 0)
-         {
-            DbgPrintf(7, _T("ZeroMQ: publish event failed (%d)"), errno);
-         }
-         MutexUnlock(m_socketLock);
-         MemFree(message);
-      }
-   }
+   DbgPrintf(7, _T("ZeroMQ: publish event: %s(%d) from %s(%d)"), event->getName(), event->getCode(), object->getName(), objectId);
+   EnqueueMessage(ZmqSerializeEvent(event, *object));
 }
 
 /**
@@ -500,35 +788,13 @@ void ZmqPublishData(UINT32 objectId, UINT32 dciId, const TCHAR *dciName, const T
    if (m_socket == nullptr)
       return;
 
-   shared_ptr<NetObj> object = FindObjectById(objectId);
-   if (object == nullptr)
+   shared_ptr<SubscriptionMap> subscriptions = std::atomic_load(&s_dataSnapshot);
+   const Subscription *sub = subscriptions->get(objectId);
+   if ((sub == nullptr) || !sub->match(dciId))
       return;
 
-   DbgPrintf(7, _T("ZeroMQ: publish collected data on %s(%d): %s"), object->getName(), objectId, value);
-
-   bool doSend = false;
-   MutexLock(m_dataSubscriptionLock);
-   if (m_dataSubscription.contains(objectId))
-   {
-      Subscription *sub = m_dataSubscription.get(objectId);
-      doSend = sub->match(dciId);
-   }
-   MutexUnlock(m_dataSubscriptionLock);
-
-   if (doSend)
-   {
-      char *message = DataToJson(*object, dciId, dciName, value);
-      if (message != nullptr)
-      {
-         MutexLock(m_socketLock);
-         if (zmq_send(m_socket, message, strlen(message), ZMQ_DONTWAIT) != 0)
-         {
-            DbgPrintf(7, _T("ZeroMQ: publish collected data failed (%d)"), errno);
-         }
-         MutexUnlock(m_socketLock);
-         MemFree(message);
-      }
-   }
+   DbgPrintf(7, _T("ZeroMQ: publish collected data on [%u] DCI [%u]: %s"), objectId, dciId, value);
+   EnqueueMessage(ZmqSerializeData(objectId, dciId, dciName, value));
 }
 
 /**
@@ -572,13 +838,18 @@ bool ZmqUnsubscribeData(UINT32 objectId, UINT32 dciId)
  */
 void ZmqFillSubscriptionListMessage(NXCPMessage *msg, zmq::SubscriptionType type)
 {
+   MUTEX mutex;
    Iterator<Subscription> *it;
    if (type == zmq::EVENT)
    {
+      mutex = m_eventSubscriptionLock;
+      MutexLock(mutex);
       it = m_eventSubscription.iterator();
    }
    else
    {
+      mutex = m_dataSubscriptionLock;
+      MutexLock(mutex);
       it = m_dataSubscription.iterator();
    }
 
@@ -592,6 +863,26 @@ void ZmqFillSubscriptionListMessage(NXCPMessage *msg, zmq::SubscriptionType type
 
       baseId += 10;
    }
+   delete it;
+   MutexUnlock(mutex);
+}
+
+/**
+ * Get publisher statistics
+ */
+void GetZmqPublisherStats(uint64_t *messagesSent, uint64_t *queueDrops, uint64_t *sendFailures)
+{
+   *messagesSent = static_cast<uint64_t>(s_messagesSent);
+   *queueDrops = static_cast<uint64_t>(s_queueDrops);
+   *sendFailures = static_cast<uint64_t>(s_sendFailures);
+}
+
+/**
+ * Get publisher queue size
+ */
+INT64 GetZmqPublisherQueueSize()
+{
+   return static_cast<INT64>(s_publisherQueue.size());
 }
 
 #endif // WITH_ZMQ
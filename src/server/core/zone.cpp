@@ -41,7 +41,7 @@ Zone::Zone() : super()
    GenerateRandomBytes(m_proxyAuthKey, ZONE_PROXY_KEY_LENGTH);
 	m_idxNodeByAddr = new InetAddressIndex;
 	m_idxInterfaceByAddr = new InetAddressIndex;
-	m_idxSubnetByAddr = new InetAddressIndex;
+	m_idxSubnetByAddr = new InetAddressIndex(true);
    m_lastHealthCheck = NEVER;
    m_lockedForHealthCheck = false;
 }
@@ -58,7 +58,7 @@ Zone::Zone(UINT32 uin, const TCHAR *name) : super()
    GenerateRandomBytes(m_proxyAuthKey, ZONE_PROXY_KEY_LENGTH);
 	m_idxNodeByAddr = new InetAddressIndex;
 	m_idxInterfaceByAddr = new InetAddressIndex;
-	m_idxSubnetByAddr = new InetAddressIndex;
+	m_idxSubnetByAddr = new InetAddressIndex(true);
    m_lastHealthCheck = NEVER;
    m_lockedForHealthCheck = false;
    setCreationTime();
@@ -93,6 +93,7 @@
 #include "nxcore_ps.h"
 #include "nxcore_jobs.h"
 #include "nxcore_schedule.h"
+#include "nxcore_memacct.h"
 #ifdef WITH_ZMQ
 #include "zeromq.h"
 #endif
@@ -1039,6 +1040,146 @@ class FileDownloadTask
    void run();
 };
 
+/**
+ * Key for source binding cache
+ */
+struct SourceBindingKey
+{
+   int32_t zoneUIN;
+   BYTE address[18];
+   char hostName[MAX_SYSLOG_HOSTNAME_LEN];
+};
+
+/**
+ * Entry in source binding cache
+ */
+struct SourceBindingEntry
+{
+   uint32_t nodeId;
+   uint32_t generation;
+   time_t expirationTime;
+};
+
+/**
+ * Cache for binding of incoming messages (syslog, SNMP traps) to nodes by zone, source
+ * address, and host name reported by source. Node ID 0 is cached for unknown sources.
+ * All caches are invalidated when node names or IP address indexes change.
+ */
+class NXCORE_EXPORTABLE SourceBindingCache
+{
+   DISABLE_COPY_CTOR(SourceBindingCache)
+
+private:
+   TCHAR m_name[64];
+   HashMap<SourceBindingKey, SourceBindingEntry> m_entries;
+   Mutex m_lock;
+   int m_maxSize;
+   uint32_t m_ttl;
+   uint64_t m_hits;
+   uint64_t m_misses;
+
+   static void buildKey(SourceBindingKey *key, int32_t zoneUIN, const InetAddress& addr, const char *hostName);
+   void init(const TCHAR *name, int maxSize, uint32_t ttl);
+   void purge(time_t now);
+
+public:
+   SourceBindingCache(const TCHAR *name);
+   SourceBindingCache(const TCHAR *name, int maxSize, uint32_t ttl);
+   ~SourceBindingCache();
+
+   bool get(int32_t zoneUIN, const InetAddress& addr, const char *hostName, uint32_t *nodeId, uint32_t *generation);
+   void put(int32_t zoneUIN, const InetAddress& addr, const char *hostName, uint32_t nodeId, uint32_t generation);
+
+   const TCHAR *getName() const { return m_name; }
+   void getStatistics(uint64_t *hits, uint64_t *misses, int *size);
+};
+
+void NXCORE_EXPORTABLE InvalidateSourceBindingCaches();
+void ShowSourceBindingCacheStatistics(ServerConsole *console);
+
+/**
+ * Background writer for high volume logs (syslog, SNMP trap log). Records are
+ * queued as structures allocated with MemAlloc and written to database in batches
+ * using bulk insert. Callback should set columns for one record in current row.
+ */
+class NXCORE_EXPORTABLE BatchLogWriter
+{
+   DISABLE_COPY_CTOR(BatchLogWriter)
+
+private:
+   TCHAR m_name[64];
+   Queue m_queue;
+   DB_BULK_INSERT m_bulkInsert;
+   void (*m_setRowValues)(DB_BULK_INSERT, const void*);
+   THREAD m_thread;
+   bool m_stopped;
+   Mutex m_statLock;
+   uint64_t m_recordsWritten;
+   uint64_t m_recordsFailed;
+   uint64_t m_batches;
+   uint64_t m_writeTime;
+   int m_maxBatchSize;
+
+   void writerThread();
+   bool flush();
+   void discardBatch();
+
+   static void writerThreadStarter(BatchLogWriter *writer) { writer->writerThread(); }
+
+public:
+   BatchLogWriter(const TCHAR *name, const TCHAR *table, const TCHAR *columns, const int *sqlTypes, int numColumns,
+            void (*setRowValues)(DB_BULK_INSERT, const void*));
+   ~BatchLogWriter();
+
+   void start();
+   void stop();
+   void put(void *record);
+
+   const TCHAR *getName() const { return m_name; }
+   Queue *getQueue() { return &m_queue; }
+   void getStatistics(uint64_t *recordsWritten, uint64_t *recordsFailed, uint64_t *batches, uint64_t *writeTime, int *maxBatchSize);
+};
+
+void ShowBatchLogWriterStatistics(ServerConsole *console);
+
+/**
+ * Spool file for performance data which cannot be passed to storage driver. Each record
+ * is stored with 4 byte length prefix. Current file size is updated and read under the
+ * same lock as file itself, so it can be checked from any thread.
+ */
+class NXCORE_EXPORTABLE PerfDataSpool
+{
+   DISABLE_COPY_CTOR(PerfDataSpool)
+
+private:
+   TCHAR m_fileName[MAX_PATH];
+   uint64_t m_sizeLimit;
+   uint64_t m_size;
+   Mutex m_lock;
+
+public:
+   PerfDataSpool(const TCHAR *fileName, uint64_t sizeLimit);
+
+   bool write(ByteStream *record);
+   int replay(bool (*handler)(ByteStream*, void*), void *context);
+
+   uint64_t getSize();
+   uint64_t getSizeLimit() const { return m_sizeLimit; }
+   const TCHAR *getFileName() const { return m_fileName; }
+};
+
+/**
+ * Serialized message for ZeroMQ publisher
+ */
+struct ZmqMessage
+{
+   size_t length;
+   char data[1];
+};
+
+ZmqMessage NXCORE_EXPORTABLE *ZmqSerializeEvent(const Event *event, const NetObj& object);
+ZmqMessage NXCORE_EXPORTABLE *ZmqSerializeData(UINT32 objectId, UINT32 dciId, const TCHAR *dciName, const TCHAR *value);
+
 /**
  * Watchdog thread state codes
  */
@@ -1200,6 +1341,7 @@ void ShutdownMailer();
 void NXCORE_EXPORTABLE PostMail(const TCHAR *pszRcpt, const TCHAR *pszSubject, const TCHAR *pszText, bool isHtml = false);
 
 void InitTraps();
+void ShutdownTraps();
 void SendTrapsToClient(ClientSession *pSession, UINT32 dwRqId);
 void CreateTrapCfgMessage(NXCPMessage *msg);
 UINT32 CreateNewTrap(UINT32 *pdwTrapId);
@@ -1238,6 +1380,9 @@ void GetZoneAgentSecretList(NXCPMessage *msg, int32_t zoneUIN);
 void CreateMessageFromSyslogMsg(NXCPMessage *pMsg, NX_SYSLOG_RECORD *pRec);
 void ReinitializeSyslogParser();
 void OnSyslogConfigurationChange(const TCHAR *name, const TCHAR *value);
+int64_t GetSyslogProcessingQueueSize();
+int64_t GetSyslogWriterQueueSize();
+void GetSyslogReceiverStats(uint64_t *queueDrops, uint64_t *socketDrops, uint64_t *queueLimit);
 
 void EscapeString(StringBuffer &str);
 
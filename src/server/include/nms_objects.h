@@ -326,6 +326,7 @@ class NXCORE_EXPORTABLE AbstractIndexBase
    }
 
    void setStartupMode(bool startupMode);
+   void sortStartupData();
 };
 
 /**
@@ -519,16 +520,18 @@ class NXCORE_EXPORTABLE ObjectIndex : public SharedPointerIndex<NetObj>
 struct InetAddressIndexEntry;
 
 /**
- * Object index by IP address
+ * Object index by IP address. Optionally maintains prefix tree for longest prefix match lookups
+ * (used for subnet indexes).
  */
 class NXCORE_EXPORTABLE InetAddressIndex
 {
 private:
    InetAddressIndexEntry *m_root;
 	RWLOCK m_lock;
+   InetAddressPrefixTree *m_prefixTree;
 
 public:
-   InetAddressIndex();
+   InetAddressIndex(bool prefixTree = false);
    ~InetAddressIndex();
 
 	bool put(const InetAddress& addr, const shared_ptr<NetObj>& object);
@@ -536,6 +539,7 @@ class NXCORE_EXPORTABLE InetAddressIndex
 	void remove(const InetAddress& addr);
 	void remove(const InetAddressList *addrList);
 	shared_ptr<NetObj> get(const InetAddress& addr) const;
+   shared_ptr<NetObj> findLongestPrefixMatch(const InetAddress& addr) const;
 	shared_ptr<NetObj> find(bool (*comparator)(NetObj *, void *), void *context) const;
 
 	int size() const;
@@ -591,6 +595,41 @@ template<typename K> class HashIndex : public HashIndexBase
    void forEach(void (*callback)(const K *, NetObj *, void *), void *context) const { HashIndexBase::forEach(reinterpret_cast<void (*)(const void *, NetObj *, void *)>(callback), context); }
 };
 
+/**
+ * Secondary index of objects by string attribute (like sysName or LLDP ID). Several objects can share same
+ * attribute value. Index holds object IDs, so callers should check that attribute of found object still
+ * matches the key.
+ */
+class NXCORE_EXPORTABLE StringAttributeIndex
+{
+   DISABLE_COPY_CTOR(StringAttributeIndex)
+
+private:
+   StringObjectMap<IntegerArray<uint32_t>> m_keys;
+   HashMap<uint32_t, String> m_objects;
+   RWLOCK m_lock;
+
+   void removeInternal(uint32_t objectId);
+
+public:
+   StringAttributeIndex();
+   ~StringAttributeIndex();
+
+   bool update(uint32_t objectId, const TCHAR *key);
+   bool remove(uint32_t objectId);
+
+   int get(const TCHAR *key, IntegerArray<uint32_t> *objects) const;
+   void forEach(EnumerationCallbackResult (*callback)(const TCHAR *, const IntegerArray<uint32_t> *, void *), void *context) const;
+
+   template<typename C>
+   void forEach(EnumerationCallbackResult (*callback)(const TCHAR *, const IntegerArray<uint32_t> *, C *), C *context) const
+   {
+      forEach(reinterpret_cast<EnumerationCallbackResult (*)(const TCHAR *, const IntegerArray<uint32_t> *, void *)>(callback), context);
+   }
+
+   int size() const;
+};
+
 /**
  * Change code
  */
@@ -843,6 +882,7 @@ class NXCORE_EXPORTABLE ObjectUrl
 public:
    ObjectUrl(NXCPMessage *msg, UINT32 baseId);
    ObjectUrl(DB_RESULT hResult, int row);
+   ObjectUrl(uint32_t id, const TCHAR *url, const TCHAR *description);
    ~ObjectUrl();
 
    void fillMessage(NXCPMessage *msg, UINT32 baseId);
@@ -854,6 +894,9 @@ class NXCORE_EXPORTABLE ObjectUrl
    json_t *toJson() const;
 };
 
+class ObjectSaveState;
+struct ObjectPropertyValue;
+
 /**
  * Base class for network objects
  */
@@ -891,6 +934,8 @@ class NXCORE_EXPORTABLE NetObj : public NObject
    uint64_t m_maintenanceEventId;
    uint32_t m_maintenanceInitiator;
    VolatileCounter m_modified;
+   VolatileCounter m_syncQueued;    // Non-zero if object is in syncer's modified objects queue
+   ObjectSaveState *m_saveState;    // Common properties as last written to database
    bool m_isDeleted;
    bool m_isDeleteInitiated;
    bool m_isHidden;
@@ -917,6 +962,10 @@ class NXCORE_EXPORTABLE NetObj : public NObject
    IntegerArray<UINT32> *m_responsibleUsers;
    RWLOCK m_rwlockResponsibleUsers;
 
+#ifdef WITH_MEMORY_ACCOUNTING
+   size_t m_accountedMemorySize;    // Object size currently registered in memory accounting counters
+#endif
+
    const SharedObjectArray<NetObj> &getChildList() const { return reinterpret_cast<const SharedObjectArray<NetObj>&>(super::getChildList()); }
    const SharedObjectArray<NetObj> &getParentList() const { return reinterpret_cast<const SharedObjectArray<NetObj>&>(super::getParentList()); }
 
@@ -939,6 +988,9 @@ class NXCORE_EXPORTABLE NetObj : public NObject
    bool saveACLToDB(DB_HANDLE hdb);
    bool loadCommonProperties(DB_HANDLE hdb);
    bool saveCommonProperties(DB_HANDLE hdb);
+   bool saveCustomAttributes(DB_HANDLE hdb);
+   void getCommonPropertyValues(ObjectPropertyValue *values, TCHAR *buffer);
+   void captureSaveState();
    bool saveModuleData(DB_HANDLE hdb);
    bool loadTrustedNodes(DB_HANDLE hdb);
 	bool saveTrustedNodes(DB_HANDLE hdb);
@@ -996,6 +1048,9 @@ class NXCORE_EXPORTABLE NetObj : public NObject
 
    bool isModified() const { return m_modified != 0; }
    bool isModified(uint32_t bit) const { return (m_modified & bit) != 0; }
+#ifdef WITH_MEMORY_ACCOUNTING
+   size_t exchangeAccountedMemorySize(size_t size) { lockProperties(); size_t old = m_accountedMemorySize; m_accountedMemorySize = size; unlockProperties(); return old; }
+#endif
    bool isDeleted() const { return m_isDeleted; }
    bool isDeleteInitiated() const { return m_isDeleteInitiated; }
    bool isOrphaned() const { return getParentCount() == 0; }
@@ -1025,7 +1080,9 @@ class NXCORE_EXPORTABLE NetObj : public NObject
    void hide();
    void unhide();
    void markAsModified(uint32_t flags) { setModified(flags); }  // external API to mark object as modified
-   void markAsSaved() { m_modified = 0; }
+   void markAsSaved();
+   void enqueueForSync();
+   void clearSyncQueuedFlag() { m_syncQueued = 0; }
 
    virtual bool saveToDatabase(DB_HANDLE hdb);
    virtual bool saveRuntimeData(DB_HANDLE hdb);
@@ -1035,7 +1092,7 @@ class NXCORE_EXPORTABLE NetObj : public NObject
 
    void setId(UINT32 dwId) { m_id = dwId; setModified(MODIFY_ALL); }
    void generateGuid() { m_guid = uuid::generate(); }
-   void setName(const TCHAR *pszName) { lockProperties(); _tcslcpy(m_name, pszName, MAX_OBJECT_NAME); setModified(MODIFY_COMMON_PROPERTIES); unlockProperties(); }
+   void setName(const TCHAR *name);
    void resetStatus() { lockProperties(); m_status = STATUS_UNKNOWN; setModified(MODIFY_RUNTIME); unlockProperties(); }
    void setComments(TCHAR *text);	/* text must be dynamically allocated */
    void setCreationTime() { m_creationTime = time(nullptr); }
@@ -1492,6 +1549,7 @@ class NXCORE_EXPORTABLE Interface : public NetObj
    int m_ifTableSuffixLen;
    UINT32 *m_ifTableSuffix;
    IntegerArray<UINT32> *m_vlans;
+   UINT32 m_loadedNodeId;  // Parent node ID read from database (used only while objects are loaded at startup)
 
    void icmpStatusPoll(UINT32 rqId, UINT32 nodeIcmpProxy, Cluster *cluster, InterfaceAdminState *adminState, InterfaceOperState *operState);
 	void paeStatusPoll(UINT32 rqId, SNMP_Transport *pTransport, Node *node);
@@ -1519,6 +1577,7 @@ class NXCORE_EXPORTABLE Interface : public NetObj
    virtual bool saveToDatabase(DB_HANDLE hdb) override;
    virtual bool deleteFromDatabase(DB_HANDLE hdb) override;
    virtual bool loadFromDatabase(DB_HANDLE hdb, UINT32 id) override;
+   bool linkAfterLoad();
 
    virtual NXSL_Value *createNXSLObject(NXSL_VM *vm) const override;
 
@@ -1617,13 +1676,7 @@ class NXCORE_EXPORTABLE Interface : public NetObj
       setModified(MODIFY_INTERFACE_PROPERTIES | MODIFY_COMMON_PROPERTIES);
       unlockProperties();
    }
-   void setDescription(const TCHAR *descr)
-   {
-      lockProperties();
-      _tcslcpy(m_description, descr, MAX_DB_STRING);
-      setModified(MODIFY_INTERFACE_PROPERTIES);
-      unlockProperties();
-   }
+   void setDescription(const TCHAR *descr);
    void setAlias(const TCHAR *alias)
    {
       lockProperties();
@@ -1702,6 +1755,7 @@ class NXCORE_EXPORTABLE NetworkService : public NetObj
    weak_ptr<Node> m_hostNode;    // Pointer to node object which hosts this service
    uint32_t m_pollerNode; // ID of node object which is used for polling
                           // If 0, m_pHostNode->m_dwPollerNode will be used
+   uint32_t m_loadedHostNodeId;  // Host node ID read from database (used only while objects are loaded at startup)
    uint16_t m_proto;        // Protocol (TCP, UDP, etc.)
    uint16_t m_port;         // TCP or UDP port number
    InetAddress m_ipAddress;
@@ -1731,6 +1785,7 @@ class NXCORE_EXPORTABLE NetworkService : public NetObj
    virtual bool saveToDatabase(DB_HANDLE hdb) override;
    virtual bool deleteFromDatabase(DB_HANDLE hdb) override;
    virtual bool loadFromDatabase(DB_HANDLE hdb, UINT32 id) override;
+   bool linkAfterLoad();
 
    void statusPoll(ClientSession *session, UINT32 rqId, const shared_ptr<Node>& pollerNode, ObjectQueue<Event> *eventQueue);
 
@@ -1747,6 +1802,7 @@ class NXCORE_EXPORTABLE VPNConnector : public NetObj
 
 protected:
    UINT32 m_dwPeerGateway;        // Object ID of peer gateway
+   UINT32 m_loadedNodeId;         // Parent node ID read from database (used only while objects are loaded at startup)
    ObjectArray<InetAddress> *m_localNetworks;
    ObjectArray<InetAddress> *m_remoteNetworks;
 
@@ -1767,6 +1823,7 @@ class NXCORE_EXPORTABLE VPNConnector : public NetObj
    virtual bool saveToDatabase(DB_HANDLE hdb) override;
    virtual bool deleteFromDatabase(DB_HANDLE hdb) override;
    virtual bool loadFromDatabase(DB_HANDLE hdb, UINT32 id) override;
+   bool linkAfterLoad();
 
    bool isLocalAddr(const InetAddress& addr) const;
    bool isRemoteAddr(const InetAddress& addr) const;
@@ -2248,6 +2305,7 @@ class NXCORE_EXPORTABLE AccessPoint : public DataCollectionTarget
    virtual bool loadFromDatabase(DB_HANDLE hdb, UINT32 id) override;
    virtual bool saveToDatabase(DB_HANDLE hdb) override;
    virtual bool deleteFromDatabase(DB_HANDLE hdb) override;
+   bool linkAfterLoad();
 
    virtual NXSL_Value *createNXSLObject(NXSL_VM *vm) const override;
 
@@ -2295,6 +2353,7 @@ class NXCORE_EXPORTABLE Cluster : public DataCollectionTarget
 	UINT32 m_dwNumResources;
 	CLUSTER_RESOURCE *m_pResourceList;
 	int32_t m_zoneUIN;
+   IntegerArray<UINT32> *m_loadedMemberIds;  // Member node IDs read from database (used only while objects are loaded at startup)
 
    virtual void fillMessageInternal(NXCPMessage *pMsg, UINT32 userId) override;
    virtual UINT32 modifyFromMessageInternal(NXCPMessage *pRequest) override;
@@ -2318,6 +2377,7 @@ class NXCORE_EXPORTABLE Cluster : public DataCollectionTarget
    virtual bool deleteFromDatabase(DB_HANDLE hdb) override;
    virtual bool loadFromDatabase(DB_HANDLE hdb, UINT32 id) override;
    virtual bool showThresholdSummary() const override;
+   bool linkAfterLoad();
 
    virtual bool lockForInstancePoll() override { return false; }
 
@@ -2795,6 +2855,7 @@ class NXCORE_EXPORTABLE Node : public DataCollectionTarget
    time_t m_agentUpTime;
    time_t m_lastAgentCommTime;
    time_t m_lastAgentConnectAttempt;
+   IntegerArray<UINT32> *m_loadedSubnetIds;  // Subnet IDs read from database (used only while objects are loaded at startup)
    MUTEX m_hAgentAccessMutex;
    MUTEX m_hSmclpAccessMutex;
    MUTEX m_mutexRTAccess;
@@ -2869,6 +2930,7 @@ class NXCORE_EXPORTABLE Node : public DataCollectionTarget
 
    virtual void fillMessageInternal(NXCPMessage *pMsg, UINT32 userId) override;
    virtual UINT32 modifyFromMessageInternal(NXCPMessage *pRequest) override;
+   virtual UINT32 modifyFromMessageInternalStage2(NXCPMessage *pRequest) override;
 
    virtual void onDataCollectionChange() override;
 
@@ -2915,6 +2977,7 @@ class NXCORE_EXPORTABLE Node : public DataCollectionTarget
    NetworkPathCheckResult checkNetworkPathLayer3(uint32_t requestId, bool secondPass);
    NetworkPathCheckResult checkNetworkPathElement(uint32_t nodeId, const TCHAR *nodeType, bool isProxy, bool isSwitch, uint32_t requestId, bool secondPass);
    void icmpPollAddress(AgentConnection *conn, const TCHAR *target, const InetAddress& addr);
+   void updateIcmpStatCollector(const TCHAR *target, UINT32 status, UINT32 rtt);
 
    void syncDataCollectionWithAgent(AgentConnectionEx *conn);
 
@@ -2948,6 +3011,7 @@ class NXCORE_EXPORTABLE Node : public DataCollectionTarget
    virtual bool saveRuntimeData(DB_HANDLE hdb) override;
    virtual bool deleteFromDatabase(DB_HANDLE hdb) override;
    virtual bool loadFromDatabase(DB_HANDLE hdb, UINT32 id) override;
+   bool linkAfterLoad();
 
    virtual bool lockForStatusPoll() override;
    bool lockForDiscoveryPoll();
@@ -3053,11 +3117,12 @@ class NXCORE_EXPORTABLE Node : public DataCollectionTarget
    shared_ptr<Interface> createNewInterface(InterfaceInfo *ifInfo, bool manuallyCreated, bool fakeInterface);
    shared_ptr<Interface> createNewInterface(const InetAddress& ipAddr, const MacAddress& macAddr, bool fakeInterface);
 
-   void setPrimaryHostName(const TCHAR *name) { lockProperties(); m_primaryHostName = name; unlockProperties(); }
+   void setPrimaryHostName(const TCHAR *name) { lockProperties(); m_primaryHostName = name; unlockProperties(); updateAttributeIndexes(); }
    void setAgentPort(UINT16 port) { m_agentPort = port; }
    void setSnmpPort(UINT16 port) { m_snmpPort = port; }
    void setSshCredentials(const TCHAR *login, const TCHAR *password);
    void changeIPAddress(const InetAddress& ipAddr);
+   void updateAttributeIndexes();
    void changeZone(UINT32 newZone);
    void setTunnelId(const uuid& tunnelId, const TCHAR *certSubject);
    void setFileUpdateConnection(const shared_ptr<AgentConnection>& connection);
@@ -3681,11 +3746,13 @@ class NXCORE_EXPORTABLE Zone : public NetObj
 
    void addSubnet(const shared_ptr<Subnet>& subnet) { addChild(subnet); subnet->addParent(self()); }
 	void addToIndex(const shared_ptr<Subnet>& subnet) { m_idxSubnetByAddr->put(subnet->getIpAddress(), subnet); }
+   void addToIndex(const InetAddress& addr, const shared_ptr<Subnet>& subnet) { m_idxSubnetByAddr->put(addr, subnet); }
    void addToIndex(const shared_ptr<Interface>& iface) { m_idxInterfaceByAddr->put(iface->getIpAddressList(), iface); }
    void addToIndex(const InetAddress& addr, const shared_ptr<Interface>& iface) { m_idxInterfaceByAddr->put(addr, iface); }
 	void addToIndex(const shared_ptr<Node>& node) { m_idxNodeByAddr->put(node->getIpAddress(), node); }
    void addToIndex(const InetAddress& addr, const shared_ptr<Node>& node) { m_idxNodeByAddr->put(addr, node); }
 	void removeFromIndex(const Subnet& subnet) { m_idxSubnetByAddr->remove(subnet.getIpAddress()); }
+   void removeFromSubnetIndex(const InetAddress& addr) { m_idxSubnetByAddr->remove(addr); }
 	void removeFromIndex(const Interface& iface);
    void removeFromInterfaceIndex(const InetAddress& addr) { m_idxInterfaceByAddr->remove(addr); }
 	void removeFromIndex(const Node& node) { m_idxNodeByAddr->remove(node.getIpAddress()); }
@@ -3693,6 +3760,7 @@ class NXCORE_EXPORTABLE Zone : public NetObj
 	void updateInterfaceIndex(const InetAddress& oldIp, const InetAddress& newIp, const shared_ptr<Interface>& iface);
    void updateNodeIndex(const InetAddress& oldIp, const InetAddress& newIp, const shared_ptr<Node>& node);
    shared_ptr<Subnet> getSubnetByAddr(const InetAddress& ipAddr) const { return static_pointer_cast<Subnet>(m_idxSubnetByAddr->get(ipAddr)); }
+   shared_ptr<Subnet> findSubnetForAddress(const InetAddress& ipAddr) const { return static_pointer_cast<Subnet>(m_idxSubnetByAddr->findLongestPrefixMatch(ipAddr)); }
    shared_ptr<Interface> getInterfaceByAddr(const InetAddress& ipAddr) const { return static_pointer_cast<Interface>(m_idxInterfaceByAddr->get(ipAddr)); }
    shared_ptr<Node> getNodeByAddr(const InetAddress& ipAddr) const { return static_pointer_cast<Node>(m_idxNodeByAddr->get(ipAddr)); }
    shared_ptr<Subnet> findSubnet(bool (*comparator)(NetObj *, void *), void *context) const { return static_pointer_cast<Subnet>(m_idxSubnetByAddr->find(comparator, context)); }
@@ -4271,6 +4339,40 @@ class UserAgentNotificationItem
    json_t *toJson() const;
 };
 
+/**
+ * Loader for objects of single class (used for loading objects from database at startup)
+ */
+struct ObjectClassLoader
+{
+   const TCHAR *name;         // Name for log messages
+   const TCHAR *className;    // Class name for error messages
+   TCHAR query[256];          // Query for IDs of objects to be loaded
+   shared_ptr<NetObj> (*create)();
+   bool (*publish)(const shared_ptr<NetObj>& object);  // Called on main thread after loading, object is discarded if it returns false
+   int count;
+   uint32_t *ids;
+   shared_ptr<NetObj> *objects;
+
+   ObjectClassLoader(const TCHAR *_name, const TCHAR *_className, const TCHAR *_query, shared_ptr<NetObj> (*_create)(),
+            bool (*_publish)(const shared_ptr<NetObj>&) = nullptr)
+   {
+      name = _name;
+      className = _className;
+      _tcslcpy(query, _query, 256);
+      create = _create;
+      publish = _publish;
+      count = 0;
+      ids = nullptr;
+      objects = nullptr;
+   }
+
+   ~ObjectClassLoader()
+   {
+      MemFree(ids);
+      delete[] objects;
+   }
+};
+
 /**
  * Functions
  */
@@ -4328,6 +4430,10 @@ ObjectArray<ObjectQueryResult> *QueryObjects(const TCHAR *query, uint32_t userId
 StructArray<DependentNode> *GetNodeDependencies(uint32_t nodeId);
 
 BOOL LoadObjects();
+void NXCORE_EXPORTABLE LoadObjectGroup(const TCHAR *groupName, ObjectClassLoader *loaders, int numLoaders, DB_HANDLE hdb, ThreadPool *threadPool, int threadCount);
+void PrefetchObjectTables(DB_HANDLE hdb);
+void ReleasePrefetchedObjectTables();
+void EnqueueModifiedObject(const shared_ptr<NetObj>& object);
 void DumpObjects(CONSOLE_CTX pCtx, const TCHAR *filter);
 
 bool NXCORE_EXPORTABLE CreateObjectAccessSnapshot(UINT32 userId, int objClass);
@@ -4362,7 +4468,7 @@ extern shared_ptr<DashboardRoot> NXCORE_EXPORTABLE g_dashboardRoot;
 extern shared_ptr<BusinessServiceRoot> NXCORE_EXPORTABLE g_businessServiceRoot;
 
 extern UINT32 NXCORE_EXPORTABLE g_dwMgmtNode;
-extern BOOL g_bModificationsLocked;
+extern BOOL NXCORE_EXPORTABLE g_bModificationsLocked;
 extern ObjectQueue<TemplateUpdateTask> g_templateUpdateQueue;
 
 extern ObjectIndex NXCORE_EXPORTABLE g_idxObjectById;
@@ -4380,6 +4486,14 @@ extern ObjectIndex NXCORE_EXPORTABLE g_idxAccessPointById;
 extern ObjectIndex NXCORE_EXPORTABLE g_idxConditionById;
 extern ObjectIndex NXCORE_EXPORTABLE g_idxServiceCheckById;
 extern ObjectIndex NXCORE_EXPORTABLE g_idxSensorById;
+extern StringAttributeIndex NXCORE_EXPORTABLE g_idxNodeBySysName;
+extern StringAttributeIndex NXCORE_EXPORTABLE g_idxNodeByLLDPId;
+extern StringAttributeIndex NXCORE_EXPORTABLE g_idxNodeByBridgeId;
+extern StringAttributeIndex NXCORE_EXPORTABLE g_idxNodeByAgentId;
+extern StringAttributeIndex NXCORE_EXPORTABLE g_idxNodeByHostname;
+extern StringAttributeIndex NXCORE_EXPORTABLE g_idxNodeByName;
+extern StringAttributeIndex NXCORE_EXPORTABLE g_idxInterfaceByDescription;
+extern StringAttributeIndex NXCORE_EXPORTABLE g_idxMobileDeviceByDeviceId;
 
 //User agent messages
 extern Mutex g_userAgentNotificationListMutex;
@@ -263,6 +263,7 @@ class NXSL_ServerEnv : public NXSL_Environment
 
 public:
    NXSL_ServerEnv();
+   virtual ~NXSL_ServerEnv();
 
    virtual void print(NXSL_Value *value) override;
    virtual void trace(int level, const TCHAR *text) override;
@@ -113,23 +113,43 @@ struct PORT_MAPPING_ENTRY
    uint32_t ifIndex;
 };
 
+/**
+ * Number of MAC addresses on interface
+ */
+struct FDB_PORT_COUNT
+{
+   uint32_t ifIndex;
+   int count;
+   int firstEntry;   // Index of first FDB entry for this interface
+};
+
+struct FDB_MAC_INDEX_ENTRY;
+struct FDB_PORT_INDEX_ENTRY;
+
 /**
  * Switch forwarding database
  */
-class ForwardingDatabase : public RefCountObject
+class NXCORE_EXPORTABLE ForwardingDatabase : public RefCountObject
 {
 private:
    uint32_t m_nodeId;
 	int m_fdbSize;
 	int m_fdbAllocated;
 	FDB_ENTRY *m_fdb;
-	int m_pmSize;
-	int m_pmAllocated;
-	PORT_MAPPING_ENTRY *m_portMap;
+	FDB_MAC_INDEX_ENTRY *m_macIndex;     // MAC address index (only used while database is constructed)
+	MemoryPool *m_macIndexPool;
+	FDB_PORT_INDEX_ENTRY *m_portIndex;   // Bridge port to interface index mapping
+	MemoryPool *m_portIndexPool;
+	FDB_PORT_COUNT *m_portCounts;        // Sorted by interface index
+	int m_portCountsSize;
 	time_t m_timestamp;
 	uint16_t m_currentVlanId;
 
 	uint32_t ifIndexFromPort(uint32_t port);
+	void buildMacIndex();
+	void destroyMacIndex();
+	void buildPortCounts();
+	const FDB_PORT_COUNT *findPortCount(uint32_t ifIndex) const;
 
 public:
 	ForwardingDatabase(uint32_t nodeId);
@@ -155,6 +175,8 @@ class ForwardingDatabase : public RefCountObject
    void fillMessage(NXCPMessage *msg);
 };
 
+void BenchmarkForwardingDatabase(CONSOLE_CTX console, int size);
+
 /**
  * Link layer discovery protocols
  */
@@ -0,0 +1,109 @@
+/*
+** NetXMS - Network Management System
+** Server Core
+** Copyright (C) 2003-2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: nxcore_memacct.h
+**
+**/
+
+#ifndef _nxcore_memacct_h_
+#define _nxcore_memacct_h_
+
+/**
+ * Memory accounting tags. Counters are only maintained when server is built
+ * with WITH_MEMORY_ACCOUNTING defined (--enable-memory-accounting).
+ */
+enum class MemoryAccountingTag
+{
+   OBJECTS = 0,         // Network objects (object size plus estimate for parent/child lists and custom attributes)
+   NXCP_MESSAGES = 1,   // Serialized NXCP messages waiting for background delivery to clients
+   EVENTS = 2,          // Events in event queues and being processed
+   SCRIPT_VM = 3,       // Server script VMs
+   DB_WRITER_QUEUE = 4  // Requests in DB writer queues
+};
+
+#define MEMORY_ACCOUNTING_TAG_COUNT 5
+
+/**
+ * Memory accounting counters for single tag
+ */
+struct MemoryAccountingCounters
+{
+   VolatileCounter64 count;
+   VolatileCounter64 bytes;
+};
+
+#ifdef WITH_MEMORY_ACCOUNTING
+
+extern MemoryAccountingCounters g_memoryAccountingCounters[MEMORY_ACCOUNTING_TAG_COUNT];
+
+void MemoryAccountingUpdateLocked(VolatileCounter64 *counter, int64_t delta);
+
+/**
+ * Atomically add given value to accounting counter
+ */
+inline void MemoryAccountingUpdate(VolatileCounter64 *counter, int64_t delta)
+{
+#if defined(_WIN32) && (defined(_WIN64) || (_WIN32_WINNT >= 0x0502))
+   InterlockedExchangeAdd64(counter, delta);
+#elif defined(__GNUC__) || HAVE_DECL___SYNC_ADD_AND_FETCH
+   __sync_add_and_fetch(counter, delta);
+#else
+   MemoryAccountingUpdateLocked(counter, delta);
+#endif
+}
+
+/**
+ * Register allocation of given size for given tag
+ */
+inline void MemoryAccountingAdd(MemoryAccountingTag tag, size_t bytes)
+{
+   MemoryAccountingCounters *c = &g_memoryAccountingCounters[static_cast<int>(tag)];
+   MemoryAccountingUpdate(&c->count, 1);
+   MemoryAccountingUpdate(&c->bytes, static_cast<int64_t>(bytes));
+}
+
+/**
+ * Register deallocation of given size for given tag
+ */
+inline void MemoryAccountingRemove(MemoryAccountingTag tag, size_t bytes)
+{
+   MemoryAccountingCounters *c = &g_memoryAccountingCounters[static_cast<int>(tag)];
+   MemoryAccountingUpdate(&c->count, -1);
+   MemoryAccountingUpdate(&c->bytes, -static_cast<int64_t>(bytes));
+}
+
+void MemoryAccountingAddObject(NetObj *object);
+void MemoryAccountingUpdateObject(NetObj *object);
+void MemoryAccountingRemoveObject(NetObj *object);
+
+#else /* WITH_MEMORY_ACCOUNTING */
+
+inline void MemoryAccountingAdd(MemoryAccountingTag tag, size_t bytes) { }
+inline void MemoryAccountingRemove(MemoryAccountingTag tag, size_t bytes) { }
+inline void MemoryAccountingAddObject(NetObj *object) { }
+inline void MemoryAccountingUpdateObject(NetObj *object) { }
+inline void MemoryAccountingRemoveObject(NetObj *object) { }
+
+#endif /* WITH_MEMORY_ACCOUNTING */
+
+bool GetMemoryAccountingCounters(MemoryAccountingTag tag, uint64_t *count, uint64_t *bytes);
+bool GetObjectMemoryAccountingCounters(const TCHAR *className, uint64_t *count, uint64_t *bytes);
+void ShowMemoryAccountingCounters(ServerConsole *console);
+
+#endif
@@ -623,6 +623,7 @@ class LIBNXSRV_EXPORTABLE NObject
 
    void setCustomAttributesFromMessage(const NXCPMessage *msg);
    void setCustomAttributesFromDatabase(DB_RESULT hResult);
+   void setCustomAttributeFromDatabase(const TCHAR *name, const TCHAR *value, uint32_t flags);
    void deleteCustomAttribute(const TCHAR *name);
    void updateOrDeleteCustomAttributeOnParentRemove(const TCHAR *name);
    NXSL_Value *getCustomAttributeForNXSL(NXSL_VM *vm, const TCHAR *name) const;
@@ -21,13 +21,14 @@ namespace zmq {
 
       public:
          Subscription(UINT32 objectId, UINT32 dciId = ZMQ_DCI_ID_INVALID);
+         Subscription(const Subscription& src);
          ~Subscription();
-         UINT32 getObjectId() { return objectId; }
+         UINT32 getObjectId() const { return objectId; }
          IntegerArray<UINT32> *getItems() { return items; }
-         bool isIgnoreItems() { return ignoreItems; }
+         bool isIgnoreItems() const { return ignoreItems; }
          void addItem(UINT32 dciId);
          bool removeItem(UINT32 dciId);
-         bool match(UINT32 dciId);
+         bool match(UINT32 dciId) const;
    };
 }
 
@@ -40,5 +41,7 @@ bool ZmqUnsubscribeEvent(UINT32 objectId, UINT32 eventCode, UINT32 dciId);
 bool ZmqSubscribeData(UINT32 objectId, UINT32 dciId = 0);
 bool ZmqUnsubscribeData(UINT32 objectId, UINT32 dciId = 0);
 void ZmqFillSubscriptionListMessage(NXCPMessage *msg, zmq::SubscriptionType);
+void GetZmqPublisherStats(uint64_t *messagesSent, uint64_t *queueDrops, uint64_t *sendFailures);
+INT64 GetZmqPublisherQueueSize();
 
 #endif
@@ -1489,6 +1489,7 @@ uint32_t AgentConnection::getTable(const TCHAR *pszParam, Table **table)
       msg.setCode(CMD_GET_TABLE);
       msg.setId(dwRqId);
       msg.setField(VID_PARAMETER, pszParam);
+      msg.setField(VID_ACCEPT_BINARY_TABLE, true);
       if (sendMessage(&msg))
       {
          pResponse = waitForMessage(CMD_REQUEST_COMPLETED, dwRqId, m_commandTimeout);
@@ -496,6 +496,15 @@ void NObject::setCustomAttributesFromDatabase(DB_RESULT hResult)
    }
 }
 
+/**
+ * Set single custom attribute from values read from database. Attributes with NULL name or value are ignored.
+ */
+void NObject::setCustomAttributeFromDatabase(const TCHAR *name, const TCHAR *value, uint32_t flags)
+{
+   if ((name != nullptr) && (value != nullptr))
+      m_customAttributes->set(name, new CustomAttribute(value, flags));
+}
+
 /**
  * Set custom attribute from message
  */
@@ -0,0 +1,155 @@
+/*
+** NetXMS - Network Management System
+** Dummy performance data storage driver for debugging
+** Copyright (C) 2003-2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: dummy.cpp
+**
+**/
+
+#include <nms_core.h>
+#include <pdsdrv.h>
+
+// debug pdsdrv.dummy 1-8
+#define DEBUG_TAG _T("pdsdrv.dummy")
+
+/**
+ * Dummy driver - counts received values, optionally simulating slow or failing storage
+ */
+class DummyStorageDriver : public PerfDataStorageDriver
+{
+private:
+   VolatileCounter64 m_itemValues;
+   VolatileCounter64 m_tableValues;
+   VolatileCounter64 m_failures;
+   uint32_t m_delay;
+   uint32_t m_failureRate;
+
+   bool simulate();
+
+public:
+   DummyStorageDriver();
+
+   virtual const TCHAR *getName() override;
+   virtual bool init(Config *config) override;
+   virtual void shutdown() override;
+   virtual bool saveDCItemValue(DCItem *dcObject, time_t timestamp, const TCHAR *value) override;
+   virtual bool saveDCTableValue(DCTable *dcObject, time_t timestamp, Table *value) override;
+};
+
+/**
+ * Driver name
+ */
+static const TCHAR *s_driverName = _T("Dummy");
+
+/**
+ * Constructor
+ */
+DummyStorageDriver::DummyStorageDriver()
+{
+   m_itemValues = 0;
+   m_tableValues = 0;
+   m_failures = 0;
+   m_delay = 0;
+   m_failureRate = 0;
+}
+
+/**
+ * Get name
+ */
+const TCHAR *DummyStorageDriver::getName()
+{
+   return s_driverName;
+}
+
+/**
+ * Initialize driver
+ */
+bool DummyStorageDriver::init(Config *config)
+{
+   m_delay = config->getValueAsUInt(_T("/Dummy/Delay"), 0);
+   m_failureRate = std::min(config->getValueAsUInt(_T("/Dummy/FailureRate"), 0), 100u);
+   nxlog_debug_tag(DEBUG_TAG, 1, _T("Dummy driver initialized (delay %u ms, failure rate %u%%)"), m_delay, m_failureRate);
+   return true;
+}
+
+/**
+ * Shutdown driver
+ */
+void DummyStorageDriver::shutdown()
+{
+   nxlog_debug_tag(DEBUG_TAG, 1, _T("Dummy driver received ") INT64_FMT _T(" DCI values and ") INT64_FMT _T(" table values (") INT64_FMT _T(" simulated failures)"),
+            static_cast<int64_t>(m_itemValues), static_cast<int64_t>(m_tableValues), static_cast<int64_t>(m_failures));
+}
+
+/**
+ * Simulate storage delay and failure. Returns false if save should fail.
+ */
+bool DummyStorageDriver::simulate()
+{
+   if (m_delay > 0)
+      ThreadSleepMs(m_delay);
+   if ((m_failureRate > 0) && (static_cast<uint32_t>(rand() % 100) < m_failureRate))
+   {
+      InterlockedIncrement64(&m_failures);
+      return false;
+   }
+   return true;
+}
+
+/**
+ * Save DCI value
+ */
+bool DummyStorageDriver::saveDCItemValue(DCItem *dcObject, time_t timestamp, const TCHAR *value)
+{
+   if (!simulate())
+      return false;
+   int64_t count = static_cast<int64_t>(InterlockedIncrement64(&m_itemValues));
+   nxlog_debug_tag(DEBUG_TAG, 7, _T("DCI [%u] on %s: %s (") INT64_FMT _T(" values received)"), dcObject->getId(), dcObject->getOwnerName(), value, count);
+   return true;
+}
+
+/**
+ * Save table value
+ */
+bool DummyStorageDriver::saveDCTableValue(DCTable *dcObject, time_t timestamp, Table *value)
+{
+   if (!simulate())
+      return false;
+   int64_t count = static_cast<int64_t>(InterlockedIncrement64(&m_tableValues));
+   nxlog_debug_tag(DEBUG_TAG, 7, _T("Table DCI [%u] on %s: %d rows (") INT64_FMT _T(" values received)"), dcObject->getId(), dcObject->getOwnerName(), value->getNumRows(), count);
+   return true;
+}
+
+/**
+ * Driver entry point
+ */
+DECLARE_PDSDRV_ENTRY_POINT(s_driverName, DummyStorageDriver);
+
+#ifdef _WIN32
+
+/**
+ * DLL entry point
+ */
+BOOL WINAPI DllMain(HINSTANCE hInstance, DWORD dwReason, LPVOID lpReserved)
+{
+   if (dwReason == DLL_PROCESS_ATTACH)
+      DisableThreadLibraryCalls(hInstance);
+   return TRUE;
+}
+
+#endif
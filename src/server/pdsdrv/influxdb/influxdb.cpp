@@ -49,9 +49,11 @@ class InfluxDBStorageDriver : public PerfDataStorageDriver
    std::string m_queuedMessages;
    UINT32 m_queuedMessageCount;
    UINT32 m_maxQueueSize;
+   size_t m_maxPacketSize;
    Mutex m_mutex;
 
    void queuePush(const std::string& data);
+   bool sendQueuedMessages();
 
    static std::string normalizeString(std::string str);
    static std::string getString(const TCHAR *tstr);
@@ -85,6 +87,7 @@ InfluxDBStorageDriver::InfluxDBStorageDriver()
    m_queuedMessageCount = 0;
    m_queuedMessages = "";
    m_maxQueueSize = 100;
+   m_maxPacketSize = 65000;
 }
 
 /**
@@ -175,53 +178,59 @@ void InfluxDBStorageDriver::queuePush(const std::string& data)
 {
    m_mutex.lock();
 
-   bool flushNow = data.empty();
-   if (!flushNow)
+   // Send already queued messages first if new message will not fit into one datagram
+   if (!data.empty() && !m_queuedMessages.empty() && (data.length() + m_queuedMessages.length() + 1 > m_maxPacketSize))
    {
-      // Check that packet is not longer than 64K
-      if (data.length() + m_queuedMessages.length() < 65534)
+      nxlog_debug_tag(DEBUG_TAG, 7, _T("Queue size: %u / %u (sending, packet size limit reached)"), m_queuedMessageCount, m_maxQueueSize);
+      if (!sendQueuedMessages())
       {
-         m_queuedMessages += data + "\n";
-         m_queuedMessageCount++;
-      }
-      else
-      {
-         flushNow = true;
+         // Queued messages cannot be kept because datagram size is limited
+         nxlog_debug_tag(DEBUG_TAG, 6, _T("%u queued messages dropped"), m_queuedMessageCount);
+         m_queuedMessages.clear();
+         m_queuedMessageCount = 0;
       }
    }
 
-   if ((m_queuedMessageCount >= m_maxQueueSize) || flushNow)
+   if (!data.empty())
    {
-      nxlog_debug_tag(DEBUG_TAG, 7, _T("Queue size: %u / %u (sending)"), m_queuedMessageCount, m_maxQueueSize);
+      m_queuedMessages += data;
+      m_queuedMessages += "\n";
+      m_queuedMessageCount++;
+   }
 
-      if (m_queuedMessages.size() > 0)
-      {
-         if (SendEx(m_socket, m_queuedMessages.c_str(), m_queuedMessages.size(), 0, INVALID_MUTEX_HANDLE) <= 0)
-         {
-            nxlog_debug_tag(DEBUG_TAG, 8, _T("socket error: %s"), _tcserror(errno));
-            // Ignore; will be re-sent with the next message
-         }
-         else
-         {
-            // Data sent - empty queue
-            m_queuedMessages.clear();
-            m_queuedMessageCount = 0;
-         }
-      }
+   if ((m_queuedMessageCount >= m_maxQueueSize) || data.empty())
+   {
+      nxlog_debug_tag(DEBUG_TAG, 7, _T("Queue size: %u / %u (sending)"), m_queuedMessageCount, m_maxQueueSize);
+      sendQueuedMessages();   // On failure messages will be re-sent with the next message
    }
    else
    {
-      if (flushNow && !data.empty())
-      {
-         m_queuedMessages += data + "\n";
-         m_queuedMessageCount++;
-      }
       nxlog_debug_tag(DEBUG_TAG, 7, _T("Queue size: %u / %u"), m_queuedMessageCount, m_maxQueueSize);
    }
 
    m_mutex.unlock();
 }
 
+/**
+ * Send queued messages. Expected to be called with mutex locked.
+ */
+bool InfluxDBStorageDriver::sendQueuedMessages()
+{
+   if (m_queuedMessages.empty())
+      return true;
+
+   if (SendEx(m_socket, m_queuedMessages.c_str(), m_queuedMessages.size(), 0, INVALID_MUTEX_HANDLE) <= 0)
+   {
+      nxlog_debug_tag(DEBUG_TAG, 8, _T("socket error: %s"), _tcserror(errno));
+      return false;
+   }
+
+   // Data sent - empty queue
+   m_queuedMessages.clear();
+   m_queuedMessageCount = 0;
+   return true;
+}
+
 /**
  * Get name
  */
@@ -238,6 +247,8 @@ bool InfluxDBStorageDriver::init(Config *config)
    m_hostname = config->getValue(_T("/InfluxDB/Hostname"), m_hostname);
    m_port = static_cast<UINT16>(config->getValueAsUInt(_T("/InfluxDB/Port"), m_port));
    m_maxQueueSize = config->getValueAsUInt(_T("/InfluxDB/MaxQueueSize"), m_maxQueueSize);
+   // Maximum UDP payload size is 65507 bytes
+   m_maxPacketSize = std::min(std::max(config->getValueAsUInt(_T("/InfluxDB/MaxPacketSize"), static_cast<uint32_t>(m_maxPacketSize)), 512u), 65507u);
 
    InetAddress addr = InetAddress::resolveHostName(m_hostname);
    if (!addr.isValidUnicast())
@@ -255,6 +266,7 @@ bool InfluxDBStorageDriver::init(Config *config)
 
    nxlog_debug_tag(DEBUG_TAG, 2, _T("Using destination address %s:%u"), (const TCHAR *)addr.toString(), m_port);
    nxlog_debug_tag(DEBUG_TAG, 2, _T("Max queue size set to %u"), m_maxQueueSize);
+   nxlog_debug_tag(DEBUG_TAG, 2, _T("Max packet size set to %u"), static_cast<uint32_t>(m_maxPacketSize));
    return true;
 }
 
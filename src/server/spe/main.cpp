@@ -27,13 +27,19 @@
  */
 DEFINE_MODULE_METADATA("SPE", "Raden Solutions", NETXMS_VERSION_STRING_A, NETXMS_BUILD_TAG_A)
 
+/**
+ * Training configuration
+ */
+static int s_trainingThreads = 1;
+static uint32_t s_trainingTimeLimit = 60000;
+
 /**
  * Get prediction engines
  */
 static ObjectArray<PredictionEngine> *GetPredictionEngines()
 {
    ObjectArray<PredictionEngine> *engines = new ObjectArray<PredictionEngine>();
-   engines->add(new TimeSeriesRegressionEngine());
+   engines->add(new TimeSeriesRegressionEngine(s_trainingThreads, s_trainingTimeLimit));
    return engines;
 }
 
@@ -45,6 +51,9 @@ extern "C" bool __EXPORT NXM_Init(NXMODULE *module, Config *config)
    module->dwSize = sizeof(NXMODULE);
    _tcscpy(module->szName, _T("SPE"));
    module->pfGetPredictionEngines = GetPredictionEngines;
+
+   s_trainingThreads = std::max(config->getValueAsInt(_T("/SPE/TrainingThreads"), s_trainingThreads), 1);
+   s_trainingTimeLimit = config->getValueAsUInt(_T("/SPE/TrainingTimeLimit"), s_trainingTimeLimit);
    return true;
 }
 
@@ -20,91 +20,126 @@
 **
 **/
 
-#include "spe.h"
+#include "nn.h"
 #include <math.h>
 
 /**
- * Node constructor
+ * Allocate memory block for weights and working buffers and set up pointers
  */
-NeuralNetworkNode::NeuralNetworkNode(int nextLevelSize)
+void NeuralNetwork::allocate()
 {
-   numWeights = nextLevelSize;
-   weights = new double[nextLevelSize];
-   weightGradients = new double[nextLevelSize];
-   for(int i = 0; i < nextLevelSize; i++)
-      weights[i] = static_cast<double>(rand()) / RAND_MAX * (0.001 - 0.0001) + 0.0001;
-   bias = static_cast<double>(rand()) / RAND_MAX * (0.001 - 0.0001) + 0.0001;
-   biasGradient = 0.0;
-   value = 0.0;
+   size_t size = m_inputCount * m_hiddenCount + m_hiddenCount * 4 + m_inputCount;
+   m_memory = MemAllocArray<double>(size);
+   m_weights = m_memory;
+   m_hiddenBias = m_weights + m_inputCount * m_hiddenCount;
+   m_outputWeights = m_hiddenBias + m_hiddenCount;
+   m_hiddenValues = m_outputWeights + m_hiddenCount;
+   m_hiddenSignals = m_hiddenValues + m_hiddenCount;
+   m_input = m_hiddenSignals + m_hiddenCount;
 }
 
 /**
- * Node destructor
+ * Constructor
  */
-NeuralNetworkNode::~NeuralNetworkNode()
+NeuralNetwork::NeuralNetwork(int inputCount, int hiddenCount)
 {
-   delete[] weights;
-   delete[] weightGradients;
+   m_inputCount = inputCount;
+   m_hiddenCount = hiddenCount;
+   allocate();
+
+   // Initial weights are small random values scaled by layer size
+   double range = 1.0 / sqrt(static_cast<double>(inputCount));
+   for(int i = 0; i < inputCount * hiddenCount; i++)
+      m_weights[i] = (static_cast<double>(rand()) / RAND_MAX - 0.5) * 2 * range;
+   range = 1.0 / sqrt(static_cast<double>(hiddenCount));
+   for(int i = 0; i < hiddenCount; i++)
+      m_outputWeights[i] = (static_cast<double>(rand()) / RAND_MAX - 0.5) * 2 * range;
+   m_outputBias = 0;
+   m_mean = 0;
+   m_scale = 1;
+   m_trained = false;
 }
 
 /**
- * Reset node before training
+ * Copy constructor
  */
-void NeuralNetworkNode::reset()
+NeuralNetwork::NeuralNetwork(const NeuralNetwork& src)
 {
-   for(int i = 0; i < numWeights; i++)
-      weightGradients[i] = 0.0;
-   biasGradient = 0.0;
+   m_inputCount = src.m_inputCount;
+   m_hiddenCount = src.m_hiddenCount;
+   allocate();
+   memcpy(m_memory, src.m_memory, (m_inputCount * m_hiddenCount + m_hiddenCount * 2) * sizeof(double));
+   m_outputBias = src.m_outputBias;
+   m_mean = src.m_mean;
+   m_scale = src.m_scale;
+   m_trained = src.m_trained;
 }
 
 /**
- * Constructor
+ * Destructor
  */
-NeuralNetwork::NeuralNetwork(int inputCount, int hiddenCount) :
-      m_input(inputCount, 8, Ownership::True), m_hidden(hiddenCount, 8, Ownership::True), m_output(1)
+NeuralNetwork::~NeuralNetwork()
 {
-   for(int i = 0; i < inputCount; i++)
-      m_input.add(new NeuralNetworkNode(hiddenCount));
-   for(int i = 0; i < hiddenCount; i++)
-      m_hidden.add(new NeuralNetworkNode(1));
-   m_mutex = MutexCreate();
+   MemFree(m_memory);
 }
 
 /**
- * Destructor
+ * Forward pass on normalized inputs. Returns normalized output.
  */
-NeuralNetwork::~NeuralNetwork()
+double NeuralNetwork::forward(const double *inputs)
 {
-   MutexDestroy(m_mutex);
+   double *h = m_hiddenValues;
+   memcpy(h, m_hiddenBias, m_hiddenCount * sizeof(double));
+   for(int i = 0; i < m_inputCount; i++)
+   {
+      const double x = inputs[i];
+      const double *w = &m_weights[i * m_hiddenCount];
+      for(int j = 0; j < m_hiddenCount; j++)
+         h[j] += w[j] * x;
+   }
+
+   double output = m_outputBias;
+   for(int j = 0; j < m_hiddenCount; j++)
+   {
+      h[j] = tanh(h[j]);
+      output += h[j] * m_outputWeights[j];
+   }
+   return output;
 }
 
 /**
- * Compute output value
+ * Backward pass - update weights using output error (target - output) from last forward pass
  */
-double NeuralNetwork::computeOutput(double *inputs)
+void NeuralNetwork::backward(const double *inputs, double error, double learnRate)
 {
-   for(int i = 0; i < m_input.size(); i++)
-      m_input.get(i)->value = inputs[i];
-
-   double os = 0.0;
-   for(int i = 0; i < m_hidden.size(); i++)
+   // Hidden node signals must be calculated with hidden-to-output weights before update
+   double *s = m_hiddenSignals;
+   const double *h = m_hiddenValues;
+   for(int j = 0; j < m_hiddenCount; j++)
    {
-      double s = 0.0;
-      for(int j = 0; j < m_input.size(); j++)   // compute i-h sum of weights * inputs
-      {
-         s += inputs[j] + m_input.get(j)->weights[i];
-      }
-      s += m_hidden.get(i)->bias;
-
-      double v = tanh(s);
-      m_hidden.get(i)->value = v;
+      s[j] = (1 - h[j] * h[j]) * m_outputWeights[j] * error * learnRate;
+      m_outputWeights[j] += h[j] * error * learnRate;
+      m_hiddenBias[j] += s[j];
+   }
+   m_outputBias += error * learnRate;
 
-      os += v * m_hidden.get(i)->weights[0]; // update h-o sum of weights * hidden
+   for(int i = 0; i < m_inputCount; i++)
+   {
+      const double x = inputs[i];
+      double *w = &m_weights[i * m_hiddenCount];
+      for(int j = 0; j < m_hiddenCount; j++)
+         w[j] += s[j] * x;
    }
+}
 
-   os += m_output.bias; // add bias to output sum
-   m_output.value = os;
-   return os;
+/**
+ * Compute output value for given input series (should contain getInputCount() elements)
+ */
+double NeuralNetwork::computeOutput(const double *inputs)
+{
+   for(int i = 0; i < m_inputCount; i++)
+      m_input[i] = (inputs[i] - m_mean) / m_scale;
+   return forward(m_input) * m_scale + m_mean;
 }
 
 /**
@@ -115,107 +150,90 @@ static void Shuffle(int *data, int size)
    for(int i = 0; i < size - 1; i++)
    {
       int idx = i + rand() % (size - i);
-      int t = data[idx];
+      int t = data[i];
       data[i] = data[idx];
       data[idx] = t;
    }
 }
 
 /**
- * Train network using given data series
+ * Train network using given data series (oldest value first) with stochastic gradient descent.
+ * Training stops after given number of rounds or when time limit (in milliseconds, 0 for unlimited)
+ * is reached. If updateNormalization is false, normalization parameters from previous training are
+ * kept (used for incremental training on short series). Returns number of completed rounds.
  */
-void NeuralNetwork::train(double *series, size_t length, int rounds, double learnRate)
+int NeuralNetwork::train(const double *series, size_t length, int rounds, double learnRate, uint32_t timeLimit, bool updateNormalization,
+         const VolatileCounter *cancelFlag)
 {
-   if (length <= m_input.size())
-      return;  // Series is too short
-
-   // Prepare training data
-   int blockCount = static_cast<int>(length) - m_input.size();
-   int blockSize = m_input.size() + 1;
-   double **trainData = new double*[blockCount];
-   int idx = 0;
-   for(int i = 0; i < blockCount; i++)
+   if (length <= static_cast<size_t>(m_inputCount))
+      return 0;  // Series is too short
+
+   int64_t startTime = GetCurrentTimeMs();
+
+   if (updateNormalization || !m_trained)
    {
-      trainData[i] = new double[blockSize];
-      memcpy(trainData[i], &series[idx++], sizeof(double) * blockSize);
+      double sum = 0;
+      for(size_t i = 0; i < length; i++)
+         sum += series[i];
+      m_mean = sum / length;
+
+      double sqsum = 0;
+      for(size_t i = 0; i < length; i++)
+         sqsum += (series[i] - m_mean) * (series[i] - m_mean);
+      m_scale = sqrt(sqsum / length);
+      if (m_scale < 1e-12)
+         m_scale = (fabs(m_mean) > 1e-12) ? fabs(m_mean) : 1;
    }
 
-   double *hSignals = new double[m_hidden.size()];
+   // Each training sample is m_inputCount consecutive values followed by target value,
+   // so normalized series can be used directly without copying samples
+   double *data = MemAllocArrayNoInit<double>(length);
+   for(size_t i = 0; i < length; i++)
+      data[i] = (series[i] - m_mean) / m_scale;
 
-   for(int i = 0; i < m_input.size(); i++)
-      m_input.get(i)->reset();
-   for(int i = 0; i < m_hidden.size(); i++)
-      m_hidden.get(i)->reset();
-   m_output.reset();
-
-   // Processing sequence
-   int *sequence = new int[blockCount];
-   for(int i = 0; i < blockCount; i++)
+   int sampleCount = static_cast<int>(length) - m_inputCount;
+   int *sequence = MemAllocArrayNoInit<int>(sampleCount);
+   for(int i = 0; i < sampleCount; i++)
       sequence[i] = i;
 
-   while(rounds-- > 0)
+   int completed = 0;
+   while(completed < rounds)
    {
-      Shuffle(sequence, blockCount); // visit each block in random order
-      for(int i = 0; i < blockCount; i++)
+      if ((cancelFlag != nullptr) && (*cancelFlag != 0))
+         break;
+
+      Shuffle(sequence, sampleCount); // visit each sample in random order
+      for(int i = 0; i < sampleCount; i++)
       {
-         double *block = trainData[sequence[i]];
-         double target = block[m_input.size()];
-         computeOutput(block);
-
-         // 1. compute output node signal
-         double errorSignal = target - m_output.value;
-
-         // 2. compute hidden-to-output weight gradients using output signals
-         for(int j = 0; j < m_hidden.size(); j++)
-            m_hidden.get(j)->weightGradients[0] = errorSignal * m_hidden.get(j)->value;
-
-         // 3. compute output bias gradients using output signals
-         m_output.biasGradient = errorSignal;
-
-         // 4. compute hidden node signals
-         for(int j = 0; j < m_hidden.size(); j++)
-         {
-            NeuralNetworkNode *n = m_hidden.get(j);
-            double derivative = (1 + n->value) * (1 - n->value);
-            hSignals[j] = derivative * n->weights[0];
-         }
-
-         // 5. compute input-hidden weight gradients
-         for(int j = 0; j < m_input.size(); j++)
-         {
-            NeuralNetworkNode *n = m_input.get(j);
-            for(int k = 0; k < m_hidden.size(); k++)
-               n->weightGradients[k] = hSignals[k] * n->value;
-         }
-
-         // 6. compute hidden node bias gradients
-         for(int j = 0; j < m_hidden.size(); j++)
-            m_hidden.get(j)->biasGradient = hSignals[j];
-
-         // 7. update input-to-hidden weights
-         for(int j = 0; j < m_input.size(); j++)
-         {
-            NeuralNetworkNode *n = m_input.get(j);
-            for(int k = 0; k < m_hidden.size(); k++)
-               n->weights[k] += n->weightGradients[k] * learnRate;
-         }
-
-         // 8. update hidden biases and hidden-to-output weights
-         for(int j = 0; j < m_hidden.size(); j++)
-         {
-            NeuralNetworkNode *n = m_hidden.get(j);
-            n->bias += n->biasGradient * learnRate;
-            n->weights[0] += n->weightGradients[0] * learnRate;
-         }
-
-         // 9. update output node bias
-         m_output.bias += m_output.biasGradient * learnRate;
+         const double *inputs = &data[sequence[i]];
+         double error = inputs[m_inputCount] - forward(inputs);
+         backward(inputs, error, learnRate);
       }
+      completed++;
+
+      if ((timeLimit > 0) && (GetCurrentTimeMs() - startTime >= timeLimit))
+         break;
    }
 
-   delete[] hSignals;
-   delete[] sequence;
-   for(int i = 0; i < blockCount; i++)
-      delete[] trainData[i];
-   delete[] trainData;
+   MemFree(sequence);
+   MemFree(data);
+   m_trained = true;
+   return completed;
+}
+
+/**
+ * Calculate mean squared error of one step ahead prediction over given series
+ */
+double NeuralNetwork::meanSquaredError(const double *series, size_t length)
+{
+   if (length <= static_cast<size_t>(m_inputCount))
+      return 0;
+
+   double sum = 0;
+   for(size_t i = m_inputCount; i < length; i++)
+   {
+      double d = series[i] - computeOutput(&series[i - m_inputCount]);
+      sum += d * d;
+   }
+   return sum / (length - m_inputCount);
 }
@@ -0,0 +1,73 @@
+/*
+** NetXMS - Network Management System
+** Copyright (C) 2003-2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: nn.h
+**
+**/
+
+#ifndef _nn_h_
+#define _nn_h_
+
+#include <nms_common.h>
+#include <nms_util.h>
+
+/**
+ * Neural network with single hidden layer. All weights are kept in single contiguous
+ * memory block. Input-to-hidden weights are stored as one row of m_hiddenCount elements
+ * per input, so inner loops of both forward and backward passes run over consecutive
+ * elements without cross-iteration dependencies and can be vectorized by compiler.
+ * Inputs and output are normalized using mean and standard deviation of training series.
+ * Network object is not thread safe.
+ */
+class NeuralNetwork
+{
+private:
+   int m_inputCount;
+   int m_hiddenCount;
+   double *m_memory;
+   double *m_weights;         // input-to-hidden weights, m_hiddenCount elements for each input
+   double *m_hiddenBias;
+   double *m_outputWeights;
+   double *m_hiddenValues;    // hidden node values from last forward pass
+   double *m_hiddenSignals;   // hidden node error signals
+   double *m_input;           // normalized input buffer
+   double m_outputBias;
+   double m_mean;
+   double m_scale;
+   bool m_trained;
+
+   void allocate();
+   double forward(const double *inputs);
+   void backward(const double *inputs, double error, double learnRate);
+
+public:
+   NeuralNetwork(int inputCount, int hiddenCount);
+   NeuralNetwork(const NeuralNetwork& src);
+   ~NeuralNetwork();
+
+   int getInputCount() const { return m_inputCount; }
+   int getHiddenCount() const { return m_hiddenCount; }
+   bool isTrained() const { return m_trained; }
+
+   double computeOutput(const double *inputs);
+   int train(const double *series, size_t length, int rounds, double learnRate, uint32_t timeLimit, bool updateNormalization = true,
+            const VolatileCounter *cancelFlag = nullptr);
+   double meanSquaredError(const double *series, size_t length);
+};
+
+#endif
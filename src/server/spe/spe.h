@@ -1,6 +1,6 @@
 /*
 ** NetXMS - Network Management System
-** Copyright (C) 2003-2018 Raden Solutions
+** Copyright (C) 2003-2020 Raden Solutions
 **
 ** This program is free software; you can redistribute it and/or modify
 ** it under the terms of the GNU General Public License as published by
@@ -29,45 +29,34 @@
 #include <nxmodule.h>
 #include <nxconfig.h>
 #include <npe.h>
+#include "nn.h"
 
 /**
- * Neural network node
+ * Prediction model for single DCI - trained network and recent values for incremental training
  */
-struct NeuralNetworkNode
-{
-   int numWeights;
-   double *weights;
-   double *weightGradients;
-   double bias;
-   double biasGradient;
-   double value;
-
-   NeuralNetworkNode(int nextLevelSize);
-   ~NeuralNetworkNode();
-
-   void reset();
-};
-
-/**
- * Neural network class
- */
-class NeuralNetwork
+class TimeSeriesModel
 {
 private:
-   ObjectArray<NeuralNetworkNode> m_input;
-   ObjectArray<NeuralNetworkNode> m_hidden;
-   NeuralNetworkNode m_output;
-   MUTEX m_mutex;
+   Mutex m_mutex;
+   NeuralNetwork *m_network;
+   uint32_t m_generation;     // incremented on each full training
+   double *m_samples;         // ring buffer of recent values
+   int m_sampleCount;
+   int m_samplePos;
+   int m_newSamples;
+   bool m_updateScheduled;
+   const VolatileCounter *m_cancelFlag;  // Set by engine on shutdown
 
 public:
-   NeuralNetwork(int inputCount, int hiddenCount);
-   ~NeuralNetwork();
+   TimeSeriesModel(const VolatileCounter *cancelFlag);
+   ~TimeSeriesModel();
 
-   double computeOutput(double *inputs);
-   void train(double *series, size_t length, int rounds, double learnRate);
+   void setNetwork(NeuralNetwork *network, const double *series, size_t length);
+   bool addSample(double value);
+   void update();
 
-   void lock() { MutexLock(m_mutex); }
-   void unlock() { MutexUnlock(m_mutex); }
+   bool computeOutput(const double *inputs, double *output);
+   bool computeSeries(double *inputs, int count, double *series);
 };
 
 /**
@@ -76,13 +65,18 @@ class NeuralNetwork
 class TimeSeriesRegressionEngine : public PredictionEngine
 {
 private:
-   StringObjectMap<NeuralNetwork> m_networks;
-   MUTEX m_networkLock;
+   SharedStringObjectMap<TimeSeriesModel> m_models;
+   Mutex m_modelLock;
+   ThreadPool *m_trainingThreadPool;
+   VolatileCounter m_cancelFlag;
+   int m_trainingThreads;
+   uint32_t m_trainingTimeLimit;
 
-   NeuralNetwork *acquireNetwork(UINT32 nodeId, UINT32 dciId);
+   shared_ptr<TimeSeriesModel> getModel(UINT32 nodeId, UINT32 dciId, bool create);
+   void trainModel(struct TrainingRequest *request);
 
 public:
-   TimeSeriesRegressionEngine();
+   TimeSeriesRegressionEngine(int trainingThreads, uint32_t trainingTimeLimit);
    virtual ~TimeSeriesRegressionEngine();
 
    /**
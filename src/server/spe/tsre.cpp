@@ -25,13 +25,167 @@
 #define DEBUG_TAG _T("npe.tsre")
 
 #define INPUT_LAYER_SIZE   5
+#define HIDDEN_LAYER_SIZE  10
+
+#define TRAINING_SERIES_LENGTH   10000
+#define TRAINING_ROUNDS          10000
+#define TRAINING_LEARN_RATE      0.01
+
+#define RECENT_SAMPLES           256
+#define INCREMENTAL_UPDATE_STEP  32
+#define INCREMENTAL_ROUNDS       20
+#define INCREMENTAL_LEARN_RATE   0.005
+#define INCREMENTAL_TIME_LIMIT   200
+
+/**
+ * Full training request
+ */
+struct TrainingRequest
+{
+   UINT32 nodeId;
+   UINT32 dciId;
+   double *series;
+   size_t length;
+};
+
+/**
+ * Model constructor
+ */
+TimeSeriesModel::TimeSeriesModel(const VolatileCounter *cancelFlag)
+{
+   m_cancelFlag = cancelFlag;
+   m_network = nullptr;
+   m_generation = 0;
+   m_samples = MemAllocArray<double>(RECENT_SAMPLES);
+   m_sampleCount = 0;
+   m_samplePos = 0;
+   m_newSamples = 0;
+   m_updateScheduled = false;
+}
+
+/**
+ * Model destructor
+ */
+TimeSeriesModel::~TimeSeriesModel()
+{
+   delete m_network;
+   MemFree(m_samples);
+}
+
+/**
+ * Set network after full training. Tail of training series is used as initial set of recent values.
+ */
+void TimeSeriesModel::setNetwork(NeuralNetwork *network, const double *series, size_t length)
+{
+   m_mutex.lock();
+   delete m_network;
+   m_network = network;
+   m_generation++;
+   m_sampleCount = static_cast<int>(std::min(length, static_cast<size_t>(RECENT_SAMPLES)));
+   memcpy(m_samples, &series[length - m_sampleCount], m_sampleCount * sizeof(double));
+   m_samplePos = m_sampleCount % RECENT_SAMPLES;
+   m_newSamples = 0;
+   m_mutex.unlock();
+}
+
+/**
+ * Add new value. Returns true if incremental update should be scheduled.
+ */
+bool TimeSeriesModel::addSample(double value)
+{
+   m_mutex.lock();
+   m_samples[m_samplePos++] = value;
+   if (m_samplePos == RECENT_SAMPLES)
+      m_samplePos = 0;
+   if (m_sampleCount < RECENT_SAMPLES)
+      m_sampleCount++;
+   bool schedule = false;
+   if ((++m_newSamples >= INCREMENTAL_UPDATE_STEP) && !m_updateScheduled && (m_network != nullptr))
+   {
+      m_updateScheduled = true;
+      schedule = true;
+   }
+   m_mutex.unlock();
+   return schedule;
+}
+
+/**
+ * Update network using recent values. Training is done on a copy of the network,
+ * so predictions are not blocked while it runs.
+ */
+void TimeSeriesModel::update()
+{
+   m_mutex.lock();
+   int count = m_sampleCount;
+   double *series = MemAllocArrayNoInit<double>(count);
+   int start = (m_sampleCount < RECENT_SAMPLES) ? 0 : m_samplePos;
+   for(int i = 0; i < count; i++)
+      series[i] = m_samples[(start + i) % RECENT_SAMPLES];
+   NeuralNetwork *network = new NeuralNetwork(*m_network);
+   uint32_t generation = m_generation;
+   m_newSamples = 0;
+   m_mutex.unlock();
+
+   network->train(series, count, INCREMENTAL_ROUNDS, INCREMENTAL_LEARN_RATE, INCREMENTAL_TIME_LIMIT, false, m_cancelFlag);
+   MemFree(series);
+
+   m_mutex.lock();
+   if (generation == m_generation)
+   {
+      delete m_network;
+      m_network = network;
+   }
+   else
+   {
+      delete network;   // Full training was completed in the meantime
+   }
+   m_updateScheduled = false;
+   m_mutex.unlock();
+}
+
+/**
+ * Compute output for given inputs. Returns false if model is not trained yet.
+ */
+bool TimeSeriesModel::computeOutput(const double *inputs, double *output)
+{
+   m_mutex.lock();
+   bool success = (m_network != nullptr);
+   if (success)
+      *output = m_network->computeOutput(inputs);
+   m_mutex.unlock();
+   return success;
+}
+
+/**
+ * Compute series of predicted values feeding each predicted value back as input.
+ * Returns false if model is not trained yet.
+ */
+bool TimeSeriesModel::computeSeries(double *inputs, int count, double *series)
+{
+   m_mutex.lock();
+   bool success = (m_network != nullptr);
+   if (success)
+   {
+      for(int n = 0; n < count; n++)
+      {
+         series[n] = m_network->computeOutput(inputs);
+         memmove(inputs, &inputs[1], (INPUT_LAYER_SIZE - 1) * sizeof(double));
+         inputs[INPUT_LAYER_SIZE - 1] = series[n];
+      }
+   }
+   m_mutex.unlock();
+   return success;
+}
 
 /**
  * Constructor
  */
-TimeSeriesRegressionEngine::TimeSeriesRegressionEngine() : PredictionEngine(), m_networks(Ownership::True)
+TimeSeriesRegressionEngine::TimeSeriesRegressionEngine(int trainingThreads, uint32_t trainingTimeLimit) : PredictionEngine()
 {
-   m_networkLock = MutexCreate();
+   m_trainingThreadPool = nullptr;
+   m_cancelFlag = 0;
+   m_trainingThreads = trainingThreads;
+   m_trainingTimeLimit = trainingTimeLimit;
 }
 
 /**
@@ -39,7 +193,10 @@ TimeSeriesRegressionEngine::TimeSeriesRegressionEngine() : PredictionEngine(), m
  */
 TimeSeriesRegressionEngine::~TimeSeriesRegressionEngine()
 {
-   MutexDestroy(m_networkLock);
+   // Stop running and queued training jobs so that thread pool can be destroyed without waiting for them
+   InterlockedIncrement(&m_cancelFlag);
+   if (m_trainingThreadPool != nullptr)
+      ThreadPoolDestroy(m_trainingThreadPool);
 }
 
 /**
@@ -82,6 +239,9 @@ const TCHAR *TimeSeriesRegressionEngine::getVendor() const
  */
 bool TimeSeriesRegressionEngine::initialize(TCHAR *errorMessage)
 {
+   // Dedicated pool with small number of threads so that training does not compete with other server tasks
+   m_trainingThreadPool = ThreadPoolCreate(_T("SPE"), 1, m_trainingThreads);
+   nxlog_debug_tag(DEBUG_TAG, 2, _T("Training thread pool created (max threads %d, time limit %u ms)"), m_trainingThreads, m_trainingTimeLimit);
    return true;
 }
 
@@ -104,20 +264,62 @@ bool TimeSeriesRegressionEngine::requiresTraining()
  */
 void TimeSeriesRegressionEngine::train(UINT32 nodeId, UINT32 dciId, DCObjectStorageClass storageClass)
 {
-   nxlog_debug_tag(DEBUG_TAG, 5, _T("Starting training for DCI %u/%u"), nodeId, dciId);
-   StructArray<DciValue> *values = getDciValues(nodeId, dciId, storageClass, 10000);
-   if ((values != NULL) && (values->size() > INPUT_LAYER_SIZE))
+   StructArray<DciValue> *values = getDciValues(nodeId, dciId, storageClass, TRAINING_SERIES_LENGTH);
+   if ((values != nullptr) && (values->size() > INPUT_LAYER_SIZE))
    {
-      double *series = new double[values->size()];
+      TrainingRequest *request = new TrainingRequest;
+      request->nodeId = nodeId;
+      request->dciId = dciId;
+      request->length = values->size();
+      request->series = MemAllocArrayNoInit<double>(request->length);
       for(int i = 0, j = values->size(); i < values->size(); i++)
-         series[--j] = values->get(i)->value;
-      NeuralNetwork *nn = acquireNetwork(nodeId, dciId);
-      nn->train(series, values->size(), 10000, 0.01);
-      nn->unlock();
-      delete[] series;
+         request->series[--j] = values->get(i)->value;
+
+      TCHAR key[64];
+      _sntprintf(key, 64, _T("%u/%u"), nodeId, dciId);
+      ThreadPoolExecuteSerialized(m_trainingThreadPool, key, this, &TimeSeriesRegressionEngine::trainModel, request);
+   }
+   else
+   {
+      nxlog_debug_tag(DEBUG_TAG, 5, _T("Not enough data for training DCI %u/%u"), nodeId, dciId);
    }
    delete values;
-   nxlog_debug_tag(DEBUG_TAG, 5, _T("Training completed for DCI %u/%u"), nodeId, dciId);
+}
+
+/**
+ * Train new network for given DCI (executed on training thread pool)
+ */
+void TimeSeriesRegressionEngine::trainModel(TrainingRequest *request)
+{
+   if (m_cancelFlag != 0)
+   {
+      MemFree(request->series);
+      delete request;
+      return;
+   }
+
+   nxlog_debug_tag(DEBUG_TAG, 5, _T("Starting training for DCI %u/%u (%d values)"), request->nodeId, request->dciId, static_cast<int>(request->length));
+
+   int64_t startTime = GetCurrentTimeMs();
+   NeuralNetwork *network = new NeuralNetwork(INPUT_LAYER_SIZE, HIDDEN_LAYER_SIZE);
+   int rounds = network->train(request->series, request->length, TRAINING_ROUNDS, TRAINING_LEARN_RATE, m_trainingTimeLimit, true, &m_cancelFlag);
+   if (m_cancelFlag != 0)
+   {
+      nxlog_debug_tag(DEBUG_TAG, 5, _T("Training for DCI %u/%u cancelled"), request->nodeId, request->dciId);
+      delete network;
+      MemFree(request->series);
+      delete request;
+      return;
+   }
+   double mse = network->meanSquaredError(request->series, request->length);
+
+   getModel(request->nodeId, request->dciId, true)->setNetwork(network, request->series, request->length);
+
+   nxlog_debug_tag(DEBUG_TAG, 5, _T("Training completed for DCI %u/%u (%d rounds in ") INT64_FMT _T(" ms, RMSE %f)"),
+            request->nodeId, request->dciId, rounds, GetCurrentTimeMs() - startTime, sqrt(mse));
+
+   MemFree(request->series);
+   delete request;
 }
 
 /**
@@ -131,6 +333,13 @@ void TimeSeriesRegressionEngine::train(UINT32 nodeId, UINT32 dciId, DCObjectStor
  */
 void TimeSeriesRegressionEngine::update(UINT32 nodeId, UINT32 dciId, DCObjectStorageClass storageClass, time_t timestamp, double value)
 {
+   shared_ptr<TimeSeriesModel> model = getModel(nodeId, dciId, false);
+   if ((model != nullptr) && model->addSample(value))
+   {
+      TCHAR key[64];
+      _sntprintf(key, 64, _T("%u/%u"), nodeId, dciId);
+      ThreadPoolExecuteSerialized(m_trainingThreadPool, key, model, &TimeSeriesModel::update);
+   }
 }
 
 /**
@@ -145,9 +354,9 @@ void TimeSeriesRegressionEngine::reset(UINT32 nodeId, UINT32 dciId, DCObjectStor
    TCHAR nid[64];
    _sntprintf(nid, 64, _T("%u/%u"), nodeId, dciId);
 
-   MutexLock(m_networkLock);
-   m_networks.remove(nid);
-   MutexUnlock(m_networkLock);
+   m_modelLock.lock();
+   m_models.remove(nid);
+   m_modelLock.unlock();
 }
 
 /**
@@ -176,9 +385,10 @@ double TimeSeriesRegressionEngine::getPredictedValue(UINT32 nodeId, UINT32 dciId
       series[--j] = 0.0;
    delete values;
 
-   NeuralNetwork *nn = acquireNetwork(nodeId, dciId);
-   double result = nn->computeOutput(series);
-   nn->unlock();
+   double result = 0;
+   shared_ptr<TimeSeriesModel> model = getModel(nodeId, dciId, false);
+   if ((model == nullptr) || !model->computeOutput(series, &result))
+      nxlog_debug_tag(DEBUG_TAG, 5, _T("TimeSeriesRegressionEngine::getPredictedValue: model for DCI %u/%u is not trained yet"), nodeId, dciId);
 
    delete[] series;
    return result;
@@ -212,20 +422,13 @@ bool TimeSeriesRegressionEngine::getPredictedSeries(UINT32 nodeId, UINT32 dciId,
       input[--j] = 0.0;
    delete values;
 
-   NeuralNetwork *nn = acquireNetwork(nodeId, dciId);
-   for(int n = 0; n < count-1; n++)
-   {
-      series[n] = nn->computeOutput(input);
-
-      for(int i = INPUT_LAYER_SIZE - 1; i > 0; i--)
-         input[i-1] = input[i];
-      input[INPUT_LAYER_SIZE-1] = series[n];
-   }
-   series[count-1] = nn->computeOutput(input); //no value bid
-   nn->unlock();
+   shared_ptr<TimeSeriesModel> model = getModel(nodeId, dciId, false);
+   bool success = (model != nullptr) && model->computeSeries(input, count, series);
+   if (!success)
+      nxlog_debug_tag(DEBUG_TAG, 5, _T("TimeSeriesRegressionEngine::getPredictedSeries: model for DCI %u/%u is not trained yet"), nodeId, dciId);
 
    delete[] input;
-   return true;
+   return success;
 }
 
 /**
@@ -237,22 +440,20 @@ int TimeSeriesRegressionEngine::getRequiredCacheSize() const
 }
 
 /**
- * Acquire neural network object. Caller must unlock acquired object when done.
+ * Get model for given DCI, optionally creating new one
  */
-NeuralNetwork *TimeSeriesRegressionEngine::acquireNetwork(UINT32 nodeId, UINT32 dciId)
+shared_ptr<TimeSeriesModel> TimeSeriesRegressionEngine::getModel(UINT32 nodeId, UINT32 dciId, bool create)
 {
    TCHAR nid[64];
    _sntprintf(nid, 64, _T("%u/%u"), nodeId, dciId);
 
-   MutexLock(m_networkLock);
-   NeuralNetwork *nn = m_networks.get(nid);
-   if (nn == NULL)
+   m_modelLock.lock();
+   shared_ptr<TimeSeriesModel> model = m_models.getShared(nid);
+   if ((model == nullptr) && create)
    {
-      nn = new NeuralNetwork(INPUT_LAYER_SIZE, 10);
-      m_networks.set(nid, nn);
+      model = make_shared<TimeSeriesModel>(&m_cancelFlag);
+      m_models.set(nid, model);
    }
-   nn->lock();
-   MutexUnlock(m_networkLock);
-
-   return nn;
+   m_modelLock.unlock();
+   return model;
 }
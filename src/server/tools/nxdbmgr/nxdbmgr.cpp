@@ -322,6 +322,8 @@ int main(int argc, char *argv[])
                      _T("   init [<file>]        : Initialize database. If schema file is not specified,\n")
                      _T("                          it's loaded from $NETXMS_HOME/share/netxms/sql/dbinit_DBTYPE.sql\n")
 				         _T("   migrate <source>     : Migrate database from given source\n")
+                     _T("   partition-log-tables [day|week]\n")
+                     _T("                        : Convert log tables to tables partitioned by time\n")
                      _T("   reset-system-account : Unlock user \"system\" and reset it's password to default\n")
                      _T("   set <name> <value>   : Set value of server configuration variable\n")
                      _T("   unlock               : Forced database unlock\n")
@@ -472,6 +474,7 @@ int main(int argc, char *argv[])
        strcmp(argv[optind], "init") &&
        strcmp(argv[optind], "migrate") &&
        strcmp(argv[optind], "online-upgrade") &&   // synonym for "background-upgrade" for compatibility
+       strcmp(argv[optind], "partition-log-tables") &&
        strcmp(argv[optind], "reset-system-account") &&
        strcmp(argv[optind], "set") &&
        strcmp(argv[optind], "unlock") &&
@@ -702,6 +705,10 @@ int main(int argc, char *argv[])
       {
          ResetSystemAccount();
       }
+      else if (!strcmp(argv[optind], "partition-log-tables"))
+      {
+         PartitionLogTables((argc - optind > 1) ? argv[optind + 1] : "day");
+      }
 
       if (IsOnlineUpgradePending())
          WriteToTerminal(_T("\n\x1b[31;1mWARNING:\x1b[0m Background upgrades pending. Please run \x1b[1mnxdbmgr background-upgrade\x1b[0m when possible.\n"));
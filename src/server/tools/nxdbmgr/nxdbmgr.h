@@ -56,6 +56,7 @@ void MigrateDatabase(const TCHAR *sourceConfig, TCHAR *destConfFields, bool skip
 void UpgradeDatabase();
 void UnlockDatabase();
 void ReindexIData();
+void PartitionLogTables(const char *intervalName);
 
 bool ExecSQLBatch(const char *pszFile, bool showOutput);
 bool ValidateDatabase();
@@ -0,0 +1,284 @@
+/*
+** nxdbmgr - NetXMS database manager
+** Copyright (C) 2004-2020 Victor Kirhenshtein
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: partition.cpp
+**
+**/
+
+#include "nxdbmgr.h"
+
+/**
+ * Log table information
+ */
+struct LogTableInfo
+{
+   const TCHAR *name;
+   const TCHAR *idColumn;
+   const TCHAR *timestampColumn;
+   bool hypertable;           // Table is TimescaleDB hypertable
+   const TCHAR *indexes[4];   // Index names
+   const TCHAR *createIndexes;
+};
+
+/**
+ * Log tables which can be partitioned
+ */
+static LogTableInfo s_logTables[] =
+{
+   { _T("event_log"), _T("event_id"), _T("event_timestamp"), true,
+     { _T("idx_event_log_event_timestamp"), _T("idx_event_log_source"), _T("idx_event_log_root_id"), nullptr },
+     _T("CREATE INDEX idx_event_log_event_timestamp ON event_log(event_timestamp)\n")
+     _T("CREATE INDEX idx_event_log_source ON event_log(event_source)\n")
+     _T("CREATE INDEX idx_event_log_root_id ON event_log(root_event_id) WHERE root_event_id > 0\n")
+     _T("<END>") },
+   { _T("syslog"), _T("msg_id"), _T("msg_timestamp"), true,
+     { _T("idx_syslog_msg_timestamp"), _T("idx_syslog_source"), nullptr, nullptr },
+     _T("CREATE INDEX idx_syslog_msg_timestamp ON syslog(msg_timestamp)\n")
+     _T("CREATE INDEX idx_syslog_source ON syslog(source_object_id)\n")
+     _T("<END>") },
+   { _T("audit_log"), _T("record_id"), _T("timestamp"), false,
+     { nullptr, nullptr, nullptr, nullptr },
+     _T("<END>") },
+   { _T("snmp_trap_log"), _T("trap_id"), _T("trap_timestamp"), true,
+     { _T("idx_snmp_trap_log_tt"), _T("idx_snmp_trap_log_oid"), nullptr, nullptr },
+     _T("CREATE INDEX idx_snmp_trap_log_tt ON snmp_trap_log(trap_timestamp)\n")
+     _T("CREATE INDEX idx_snmp_trap_log_oid ON snmp_trap_log(object_id)\n")
+     _T("<END>") },
+   { nullptr, nullptr, nullptr, false, { nullptr, nullptr, nullptr, nullptr }, nullptr }
+};
+
+/**
+ * Get start time of first partition (aligned timestamp of oldest record or current time for empty table)
+ */
+static int64_t GetFirstPartitionStart(const TCHAR *table, const TCHAR *column, uint32_t interval)
+{
+   int64_t start = static_cast<int64_t>(time(nullptr));
+   TCHAR query[256];
+   _sntprintf(query, 256, _T("SELECT count(*),min(%s) FROM %s"), column, table);
+   DB_RESULT hResult = SQLSelect(query);
+   if (hResult != nullptr)
+   {
+      if ((DBGetNumRows(hResult) > 0) && (DBGetFieldLong(hResult, 0, 0) > 0))
+         start = std::min(start, DBGetFieldInt64(hResult, 0, 1));
+      DBFreeResult(hResult);
+   }
+   return (start / interval) * interval;
+}
+
+/**
+ * Convert log table to partitioned one - PostgreSQL way (table is re-created and data copied)
+ */
+static bool PartitionTable_PGSQL(const LogTableInfo *t, uint32_t interval, time_t until)
+{
+   TCHAR oldName[64], query[1024];
+   _sntprintf(oldName, 64, _T("%s_unpartitioned"), t->name);
+
+   CHK_EXEC_NO_SP(DBBegin(g_dbHandle));
+
+   CHK_EXEC_NO_SP(DBRenameTable(g_dbHandle, t->name, oldName));
+   for(int i = 0; t->indexes[i] != nullptr; i++)
+   {
+      _sntprintf(query, 1024, _T("DROP INDEX %s"), t->indexes[i]);
+      CHK_EXEC_NO_SP(SQLQuery(query));
+   }
+   _sntprintf(query, 1024, _T("ALTER TABLE %s DROP CONSTRAINT %s_pkey"), oldName, t->name);
+   CHK_EXEC_NO_SP(SQLQuery(query));
+
+   _sntprintf(query, 1024, _T("CREATE TABLE %s (LIKE %s INCLUDING DEFAULTS) PARTITION BY RANGE (%s)"), t->name, oldName, t->timestampColumn);
+   CHK_EXEC_NO_SP(SQLQuery(query));
+   _sntprintf(query, 1024, _T("%s,%s"), t->idColumn, t->timestampColumn);
+   CHK_EXEC_NO_SP(DBAddPrimaryKey(g_dbHandle, t->name, query));
+
+   for(int64_t start = GetFirstPartitionStart(oldName, t->timestampColumn, interval); start < static_cast<int64_t>(until); start += interval)
+   {
+      CHK_EXEC_NO_SP(DBCreateTimePartition(g_dbHandle, t->name, t->timestampColumn, start, interval));
+   }
+
+   // Default partition will catch records outside of created partitions
+   _sntprintf(query, 1024, _T("CREATE TABLE %s_pdefault PARTITION OF %s DEFAULT"), t->name, t->name);
+   CHK_EXEC_NO_SP(SQLQuery(query));
+
+   _sntprintf(query, 1024, _T("INSERT INTO %s SELECT * FROM %s"), t->name, oldName);
+   CHK_EXEC_NO_SP(SQLQuery(query));
+   _sntprintf(query, 1024, _T("DROP TABLE %s"), oldName);
+   CHK_EXEC_NO_SP(SQLQuery(query));
+
+   CHK_EXEC_NO_SP(SQLBatch(t->createIndexes));
+
+   CHK_EXEC_NO_SP(DBCommit(g_dbHandle));
+   return true;
+}
+
+/**
+ * Convert log table to partitioned one - MySQL way. DDL statements are not transactional in MySQL,
+ * so primary key is replaced by single statement and restored if partitioning fails.
+ */
+static bool PartitionTable_MYSQL(const LogTableInfo *t, uint32_t interval, time_t until)
+{
+   // All unique keys must include partitioning column
+   TCHAR pkQuery[256];
+   _sntprintf(pkQuery, 256, _T("ALTER TABLE %s DROP PRIMARY KEY, ADD PRIMARY KEY (%s,%s)"), t->name, t->idColumn, t->timestampColumn);
+   CHK_EXEC_NO_SP(SQLQuery(pkQuery));
+
+   StringBuffer query(_T("ALTER TABLE "));
+   query.append(t->name);
+   query.append(_T(" PARTITION BY RANGE ("));
+   query.append(t->timestampColumn);
+   query.append(_T(") ("));
+   for(int64_t start = GetFirstPartitionStart(t->name, t->timestampColumn, interval); start < static_cast<int64_t>(until); start += interval)
+   {
+      TCHAR name[128];
+      query.append(_T("PARTITION "));
+      query.append(DBGetTimePartitionName(g_dbHandle, t->name, start, name));
+      query.append(_T(" VALUES LESS THAN ("));
+      query.append(start + interval);
+      query.append(_T("),"));
+   }
+   query.append(_T("PARTITION pmax VALUES LESS THAN MAXVALUE)"));
+   if (SQLQuery(query))
+      return true;
+
+   _sntprintf(pkQuery, 256, _T("ALTER TABLE %s DROP PRIMARY KEY, ADD PRIMARY KEY (%s)"), t->name, t->idColumn);
+   if (!SQLQuery(pkQuery))
+      WriteToTerminalEx(_T("\x1b[31;1mERROR:\x1b[0m cannot restore primary key of table \x1b[1m%s\x1b[0m (should be %s)\n"), t->name, t->idColumn);
+   return false;
+}
+
+/**
+ * Check if Oracle server supports online conversion of table to partitioned one (12.2 or later)
+ */
+static bool IsOnlinePartitioningSupported_ORACLE()
+{
+   DB_RESULT hResult = SQLSelect(_T("SELECT version FROM product_component_version WHERE product LIKE 'Oracle Database%'"));
+   if (hResult == nullptr)
+   {
+      _tprintf(_T("Cannot determine Oracle server version\n"));
+      return false;
+   }
+
+   TCHAR version[64] = _T("");
+   if (DBGetNumRows(hResult) > 0)
+      DBGetField(hResult, 0, 0, version, 64);
+   DBFreeResult(hResult);
+
+   TCHAR *eptr;
+   int major = _tcstol(version, &eptr, 10);
+   int minor = (*eptr == _T('.')) ? _tcstol(eptr + 1, nullptr, 10) : 0;
+   if ((major > 12) || ((major == 12) && (minor >= 2)))
+      return true;
+
+   _tprintf(_T("Log table partitioning on Oracle requires Oracle Database 12.2 or later (server version is %s)\n"), (version[0] != 0) ? version : _T("unknown"));
+   return false;
+}
+
+/**
+ * Convert log table to partitioned one - Oracle way (interval partitioning, new partitions created by database)
+ */
+static bool PartitionTable_ORACLE(const LogTableInfo *t, uint32_t interval)
+{
+   TCHAR query[1024];
+   _sntprintf(query, 1024, _T("ALTER TABLE %s MODIFY PARTITION BY RANGE (%s) INTERVAL (%u) (PARTITION p0 VALUES LESS THAN (") INT64_FMT _T(")) ONLINE UPDATE INDEXES"),
+            t->name, t->timestampColumn, interval, GetFirstPartitionStart(t->name, t->timestampColumn, interval));
+   return SQLQuery(query);
+}
+
+/**
+ * Convert log tables (event log, syslog, SNMP trap log, audit log) to tables partitioned by time.
+ * Expired records in partitioned tables are removed by dropping whole partitions.
+ */
+void PartitionLogTables(const char *intervalName)
+{
+   uint32_t interval;
+   if (!stricmp(intervalName, "day"))
+   {
+      interval = 86400;
+   }
+   else if (!stricmp(intervalName, "week"))
+   {
+      interval = 604800;
+   }
+   else
+   {
+      _tprintf(_T("Invalid partition interval (should be \"day\" or \"week\")\n"));
+      return;
+   }
+
+   if ((g_dbSyntax != DB_SYNTAX_PGSQL) && (g_dbSyntax != DB_SYNTAX_TSDB) && (g_dbSyntax != DB_SYNTAX_MYSQL) && (g_dbSyntax != DB_SYNTAX_ORACLE))
+   {
+      _tprintf(_T("Log table partitioning is not supported for this database type\n"));
+      return;
+   }
+
+   if (!ValidateDatabase())
+      return;
+
+   if ((g_dbSyntax == DB_SYNTAX_ORACLE) && !IsOnlinePartitioningSupported_ORACLE())
+      return;
+
+   WriteToTerminal(_T("\n\n\x1b[1mWARNING!!!\x1b[0m\n"));
+   if (!GetYesNo(_T("This operation will rebuild log tables and may take very long time.\nNetXMS server must be stopped.\nAre you sure?")))
+      return;
+
+   time_t until = time(nullptr) + std::max(interval * 2, static_cast<uint32_t>(7 * 86400));
+   for(const LogTableInfo *t = s_logTables; t->name != nullptr; t++)
+   {
+      TCHAR var[128];
+      _sntprintf(var, 128, _T("LogTablePartitionInterval.%s"), t->name);
+      if (DBMgrMetaDataReadInt32(var, 0) > 0)
+      {
+         WriteToTerminalEx(_T("Table \x1b[1m%s\x1b[0m is already partitioned\n"), t->name);
+         continue;
+      }
+
+      if ((g_dbSyntax == DB_SYNTAX_TSDB) && t->hypertable)
+      {
+         WriteToTerminalEx(_T("Table \x1b[1m%s\x1b[0m is TimescaleDB hypertable and will not be converted\n"), t->name);
+         continue;
+      }
+
+      WriteToTerminalEx(_T("Converting table \x1b[1m%s\x1b[0m\n"), t->name);
+      bool success;
+      switch(g_dbSyntax)
+      {
+         case DB_SYNTAX_PGSQL:
+         case DB_SYNTAX_TSDB:
+            success = PartitionTable_PGSQL(t, interval, until);
+            if (!success)
+               DBRollback(g_dbHandle);
+            break;
+         case DB_SYNTAX_MYSQL:
+            success = PartitionTable_MYSQL(t, interval, until);
+            break;
+         case DB_SYNTAX_ORACLE:
+            success = PartitionTable_ORACLE(t, interval);
+            break;
+         default:
+            success = false;
+            break;
+      }
+
+      if (!success)
+      {
+         WriteToTerminalEx(_T("\x1b[31;1mERROR:\x1b[0m cannot convert table \x1b[1m%s\x1b[0m\n"), t->name);
+         return;
+      }
+      DBMgrMetaDataWriteInt32(var, interval);
+   }
+
+   _tprintf(_T("Log tables partitioning completed\n"));
+}
@@ -23,6 +23,49 @@
 #include "nxdbmgr.h"
 #include <nxevent.h>
 
+/**
+ * Upgrade from 34.12 to 34.13
+ */
+static bool H_UpgradeFromV12()
+{
+   CHK_EXEC(CreateConfigParam(_T("ZeroMQPublisherQueueLimit"), _T("100000"), _T("Maximum number of messages waiting in ZeroMQ publisher queue. Messages published when limit is reached are dropped. Value of 0 disables the limit."), nullptr, 'I', true, true, false, false));
+   CHK_EXEC(SetMinorSchemaVersion(13));
+   return true;
+}
+
+/**
+ * Upgrade from 34.11 to 34.12
+ */
+static bool H_UpgradeFromV11()
+{
+   CHK_EXEC(CreateConfigParam(_T("SourceBindingCache.MaxSize"), _T("16384"), _T("Maximum number of entries in each syslog and SNMP trap source to node binding cache."), nullptr, 'I', true, true, false, false));
+   CHK_EXEC(CreateConfigParam(_T("SourceBindingCache.TTL"), _T("300"), _T("Time to live for source to node binding cache entries. Value of 0 disables caching."), _T("seconds"), 'I', true, true, false, false));
+   CHK_EXEC(SetMinorSchemaVersion(12));
+   return true;
+}
+
+/**
+ * Upgrade from 34.10 to 34.11
+ */
+static bool H_UpgradeFromV10()
+{
+   CHK_EXEC(CreateConfigParam(_T("SyslogProcessingQueueLimit"), _T("1000000"), _T("Maximum number of syslog messages waiting for processing. Messages received when limit is reached are dropped. Value of 0 disables the limit."), nullptr, 'I', true, false, false, false));
+   CHK_EXEC(CreateConfigParam(_T("SyslogProcessingThreads"), _T("1"), _T("Number of threads used for syslog message processing. Messages from same source are always processed by same thread."), nullptr, 'I', true, true, false, false));
+   CHK_EXEC(CreateConfigParam(_T("SyslogReceiveBufferSize"), _T("0"), _T("Size of receive buffer for syslog socket. Value of 0 means system default."), _T("bytes"), 'I', true, true, false, false));
+   CHK_EXEC(SetMinorSchemaVersion(11));
+   return true;
+}
+
+/**
+ * Upgrade from 34.9 to 34.10
+ */
+static bool H_UpgradeFromV9()
+{
+   CHK_EXEC(CreateConfigParam(_T("ThreadPool.ObjectLoader.MaxSize"), _T("8"), _T("Number of threads used for loading objects from database at server startup (value of 1 will disable parallel loading)."), nullptr, 'I', true, true, false, false));
+   CHK_EXEC(SetMinorSchemaVersion(10));
+   return true;
+}
+
 /**
  * Upgrade from 34.8 to 34.9
  */
@@ -179,6 +222,10 @@ static struct
    bool (* upgradeProc)();
 } s_dbUpgradeMap[] =
 {
+   { 12, 34, 13, H_UpgradeFromV12 },
+   { 11, 34, 12, H_UpgradeFromV11 },
+   { 10, 34, 11, H_UpgradeFromV10 },
+   { 9,  34, 10, H_UpgradeFromV9  },
    { 8,  34, 9,  H_UpgradeFromV8  },
    { 7,  34, 8,  H_UpgradeFromV7  },
    { 6,  34, 7,  H_UpgradeFromV6  },
@@ -0,0 +1,256 @@
+/*
+** nxsyslogload - syslog load generator
+** Copyright (C) 2020 Raden Solutions
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: nxsyslogload.cpp
+**
+**/
+
+#include <nms_common.h>
+#include <nms_util.h>
+#include <netxms-version.h>
+
+NETXMS_EXECUTABLE_HEADER(nxsyslogload)
+
+/**
+ * Max number of source sockets
+ */
+#define MAX_SOURCES  1024
+
+/**
+ * Options
+ */
+static uint32_t s_count = 100000;
+static uint32_t s_rate = 0;
+static int s_sources = 1;
+static InetAddress s_bindAddress;
+static uint16_t s_port = 514;
+static const char *s_text = "load test message";
+
+/**
+ * Month names for RFC 3164 timestamp
+ */
+static const char *s_months[12] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+
+/**
+ * Create sockets for sending. If bind address is given, each socket is bound to next consecutive address
+ * (like 127.0.0.1, 127.0.0.2, etc.), so that receiver sees messages from different sources.
+ */
+static int CreateSockets(const InetAddress& target, SOCKET *sockets)
+{
+   for(int i = 0; i < s_sources; i++)
+   {
+      sockets[i] = CreateSocket(target.getFamily(), SOCK_DGRAM, 0);
+      if (sockets[i] == INVALID_SOCKET)
+      {
+         TCHAR buffer[1024];
+         _tprintf(_T("Cannot create socket (%s)\n"), GetLastSocketErrorText(buffer, 1024));
+         return i;
+      }
+
+      if (s_bindAddress.isValid())
+      {
+         InetAddress addr = (s_bindAddress.getFamily() == AF_INET) ? InetAddress(s_bindAddress.getAddressV4() + i) : s_bindAddress;
+         SockAddrBuffer sa;
+         addr.fillSockAddr(&sa);
+         if (bind(sockets[i], (struct sockaddr *)&sa, SA_LEN((struct sockaddr *)&sa)) != 0)
+         {
+            TCHAR buffer[1024], addrText[64];
+            _tprintf(_T("Cannot bind socket to %s (%s)\n"), addr.toString(addrText), GetLastSocketErrorText(buffer, 1024));
+            closesocket(sockets[i]);
+            return i;
+         }
+      }
+
+      SockAddrBuffer sa;
+      target.fillSockAddr(&sa, s_port);
+      if (connect(sockets[i], (struct sockaddr *)&sa, SA_LEN((struct sockaddr *)&sa)) != 0)
+      {
+         TCHAR buffer[1024];
+         _tprintf(_T("Cannot connect socket (%s)\n"), GetLastSocketErrorText(buffer, 1024));
+         closesocket(sockets[i]);
+         return i;
+      }
+   }
+   return s_sources;
+}
+
+/**
+ * Send messages
+ */
+static void SendMessages(SOCKET *sockets)
+{
+   uint32_t sent = 0, errors = 0;
+   int64_t startTime = GetCurrentTimeMs();
+   char header[64] = "";
+   time_t headerTime = 0;
+
+   for(uint32_t i = 0; i < s_count; i++)
+   {
+      // Rate control - check how many messages should be sent by now
+      if (s_rate > 0)
+      {
+         int64_t expected = static_cast<int64_t>(i) * 1000 / s_rate;
+         int64_t elapsed = GetCurrentTimeMs() - startTime;
+         if (expected > elapsed)
+            ThreadSleepMs(static_cast<uint32_t>(expected - elapsed));
+      }
+
+      time_t now = time(nullptr);
+      if (now != headerTime)
+      {
+#if HAVE_LOCALTIME_R
+         struct tm tmbuffer;
+         struct tm *ltm = localtime_r(&now, &tmbuffer);
+#else
+         struct tm *ltm = localtime(&now);
+#endif
+         snprintf(header, 64, "%s %2d %02d:%02d:%02d", s_months[ltm->tm_mon], ltm->tm_mday, ltm->tm_hour, ltm->tm_min, ltm->tm_sec);
+         headerTime = now;
+      }
+
+      int source = static_cast<int>(i % s_sources);
+      char message[1024];
+      int len = snprintf(message, 1024, "<134>%s loadgen%d nxsyslogload[%d]: %s %u", header, source, source, s_text, i + 1);
+      if (send(sockets[source], message, std::min(len, 1023), 0) > 0)
+         sent++;
+      else
+         errors++;
+   }
+
+   int64_t elapsed = GetCurrentTimeMs() - startTime;
+   _tprintf(_T("%u messages sent in ") INT64_FMT _T(" ms (%u errors, %u messages/sec)\n"), sent, elapsed, errors,
+            static_cast<uint32_t>((elapsed > 0) ? static_cast<int64_t>(sent) * 1000 / elapsed : sent));
+}
+
+/**
+ * Entry point
+ */
+int main(int argc, char *argv[])
+{
+   InitNetXMSProcess(true);
+
+   // Parse command line
+   opterr = 1;
+   int ch;
+   char *eptr;
+   while((ch = getopt(argc, argv, "b:hm:n:p:r:s:")) != -1)
+   {
+      switch(ch)
+      {
+         case 'b':   // Bind address
+            s_bindAddress = InetAddress::parse(optarg);
+            if (!s_bindAddress.isValid())
+            {
+               _tprintf(_T("Invalid bind address \"%hs\"\n"), optarg);
+               return 1;
+            }
+            break;
+         case 'h':   // Display help and exit
+            _tprintf(_T("NetXMS Syslog Load Generator Version ") NETXMS_VERSION_STRING _T("\n\n")
+                     _T("Usage: nxsyslogload [options] host\n\n")
+                     _T("Valid options are:\n")
+                     _T("   -b address : Bind sockets to given address (consecutive addresses are used for multiple sources)\n")
+                     _T("   -h         : Display help and exit\n")
+                     _T("   -m text    : Message text (default is \"%hs\")\n")
+                     _T("   -n count   : Number of messages to send (default is %u)\n")
+                     _T("   -p port    : Target UDP port (default is %d)\n")
+                     _T("   -r rate    : Messages per second (default is 0 - as fast as possible)\n")
+                     _T("   -s count   : Number of message sources (default is 1)\n")
+                     _T("\n"), s_text, s_count, s_port);
+            return 0;
+         case 'm':   // Message text
+            s_text = optarg;
+            break;
+         case 'n':   // Message count
+            s_count = strtoul(optarg, &eptr, 0);
+            if (*eptr != 0)
+            {
+               _tprintf(_T("Invalid message count \"%hs\"\n"), optarg);
+               return 1;
+            }
+            break;
+         case 'p':   // Port number
+            {
+               long port = strtol(optarg, &eptr, 0);
+               if ((*eptr != 0) || (port < 1) || (port > 65535))
+               {
+                  _tprintf(_T("Invalid port number \"%hs\"\n"), optarg);
+                  return 1;
+               }
+               s_port = static_cast<uint16_t>(port);
+            }
+            break;
+         case 'r':   // Rate
+            s_rate = strtoul(optarg, &eptr, 0);
+            if (*eptr != 0)
+            {
+               _tprintf(_T("Invalid rate \"%hs\"\n"), optarg);
+               return 1;
+            }
+            break;
+         case 's':   // Number of sources
+            s_sources = strtol(optarg, &eptr, 0);
+            if ((*eptr != 0) || (s_sources < 1) || (s_sources > MAX_SOURCES))
+            {
+               _tprintf(_T("Invalid number of sources \"%hs\"\n"), optarg);
+               return 1;
+            }
+            break;
+         case '?':
+            return 1;
+         default:
+            break;
+      }
+   }
+
+   if (argc - optind < 1)
+   {
+      _tprintf(_T("Usage: nxsyslogload [-b address] [-h] [-m text] [-n count] [-p port] [-r rate] [-s sources] host\n"));
+      return 1;
+   }
+
+#ifdef _WIN32
+   WSADATA wsaData;
+   WSAStartup(2, &wsaData);
+#endif
+
+   InetAddress target = InetAddress::resolveHostName(argv[optind]);
+   if (!target.isValid())
+   {
+      _tprintf(_T("Cannot resolve host name \"%hs\"\n"), argv[optind]);
+      return 2;
+   }
+
+   SOCKET *sockets = MemAllocArrayNoInit<SOCKET>(s_sources);
+   int count = CreateSockets(target, sockets);
+   int rc;
+   if (count == s_sources)
+   {
+      SendMessages(sockets);
+      rc = 0;
+   }
+   else
+   {
+      rc = 3;
+   }
+
+   for(int i = 0; i < count; i++)
+      closesocket(sockets[i]);
+   MemFree(sockets);
+   return rc;
+}
@@ -0,0 +1,168 @@
+/*
+** NetXMS - Network Management System
+** SNMP support library
+** Copyright (C) 2003-2020 Victor Kirhenshtein
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation; either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+**
+** File: oidtrie.cpp
+**
+**/
+
+#include "libnxsnmp.h"
+
+/**
+ * OID trie node. Child nodes are kept sorted by sub-identifier.
+ */
+struct SNMP_ObjectIdTrieNode
+{
+   UINT32 *subIds;
+   SNMP_ObjectIdTrieNode **children;
+   int count;
+   int allocated;
+   void *value;
+   bool hasValue;
+};
+
+/**
+ * Destroy trie node and all it's children
+ */
+static void DestroyNode(SNMP_ObjectIdTrieNode *node)
+{
+   for(int i = 0; i < node->count; i++)
+      DestroyNode(node->children[i]);
+   MemFree(node->subIds);
+   MemFree(node->children);
+   MemFree(node);
+}
+
+/**
+ * Find position of given sub-identifier in node's child list. If sub-identifier
+ * not found, returns -1 and sets insertion point.
+ */
+static int FindChild(const SNMP_ObjectIdTrieNode *node, UINT32 subId, int *insertionPoint = NULL)
+{
+   int l = 0, r = node->count - 1;
+   while(l <= r)
+   {
+      int m = (l + r) / 2;
+      if (node->subIds[m] == subId)
+         return m;
+      if (node->subIds[m] < subId)
+         l = m + 1;
+      else
+         r = m - 1;
+   }
+   if (insertionPoint != NULL)
+      *insertionPoint = l;
+   return -1;
+}
+
+/**
+ * Create empty trie
+ */
+SNMP_ObjectIdTrie::SNMP_ObjectIdTrie()
+{
+   m_root = MemAllocStruct<SNMP_ObjectIdTrieNode>();
+   m_size = 0;
+}
+
+/**
+ * Destructor
+ */
+SNMP_ObjectIdTrie::~SNMP_ObjectIdTrie()
+{
+   DestroyNode(m_root);
+}
+
+/**
+ * Put value into trie. Returns true if existing value for same OID was replaced.
+ */
+bool SNMP_ObjectIdTrie::put(const UINT32 *oid, size_t length, void *value)
+{
+   SNMP_ObjectIdTrieNode *node = m_root;
+   for(size_t i = 0; i < length; i++)
+   {
+      int insertionPoint;
+      int index = FindChild(node, oid[i], &insertionPoint);
+      if (index == -1)
+      {
+         if (node->count == node->allocated)
+         {
+            node->allocated += (node->allocated < 16) ? 4 : node->allocated / 2;
+            node->subIds = MemReallocArray(node->subIds, node->allocated);
+            node->children = MemReallocArray(node->children, node->allocated);
+         }
+         memmove(&node->subIds[insertionPoint + 1], &node->subIds[insertionPoint], (node->count - insertionPoint) * sizeof(UINT32));
+         memmove(&node->children[insertionPoint + 1], &node->children[insertionPoint], (node->count - insertionPoint) * sizeof(SNMP_ObjectIdTrieNode*));
+         node->subIds[insertionPoint] = oid[i];
+         node->children[insertionPoint] = MemAllocStruct<SNMP_ObjectIdTrieNode>();
+         node->count++;
+         index = insertionPoint;
+      }
+      node = node->children[index];
+   }
+
+   bool replaced = node->hasValue;
+   node->value = value;
+   node->hasValue = true;
+   if (!replaced)
+      m_size++;
+   return replaced;
+}
+
+/**
+ * Get value for exact OID match. Returns NULL if there are no value for given OID.
+ */
+void *SNMP_ObjectIdTrie::get(const UINT32 *oid, size_t length) const
+{
+   const SNMP_ObjectIdTrieNode *node = m_root;
+   for(size_t i = 0; i < length; i++)
+   {
+      int index = FindChild(node, oid[i]);
+      if (index == -1)
+         return NULL;
+      node = node->children[index];
+   }
+   return node->hasValue ? node->value : NULL;
+}
+
+/**
+ * Find value for longest OID in the trie which is equal to given OID or is a prefix
+ * of it. Length of matched OID is returned in matchLength (if not NULL).
+ * Returns NULL if there are no matching entries.
+ */
+void *SNMP_ObjectIdTrie::findLongestMatch(const UINT32 *oid, size_t length, size_t *matchLength) const
+{
+   const SNMP_ObjectIdTrieNode *node = m_root;
+   const SNMP_ObjectIdTrieNode *match = node->hasValue ? node : NULL;
+   size_t matchedElements = 0;
+   for(size_t i = 0; i < length; i++)
+   {
+      int index = FindChild(node, oid[i]);
+      if (index == -1)
+         break;
+      node = node->children[index];
+      if (node->hasValue)
+      {
+         match = node;
+         matchedElements = i + 1;
+      }
+   }
+
+   if (matchLength != NULL)
+      *matchLength = matchedElements;
+   return (match != NULL) ? match->value : NULL;
+}
@@ -40,6 +40,7 @@ static TCHAR m_helpText[] =
    _T("Where valid options are:\n")
    _T("   -D level   : Set debug level\n")
    _T("   -f file    : Input file (overrides parser settings)\n")
+   _T("   -g count   : Generate given number of lines in input file and report parser throughput\n")
    _T("   -h         : Show this help\n")
 	_T("   -i         : Use standard input instead of file defined in parser\n" )
 #ifdef _WIN32
@@ -69,6 +70,76 @@ static THREAD_RESULT THREAD_CALL ParserThread(void *arg)
 	return THREAD_OK;
 }
 
+/**
+ * Append lines to monitored file in bursts. File is rotated (renamed and re-created) once
+ * in the middle of the test.
+ */
+static void GenerateFileLoad(const TCHAR *fileName, int count)
+{
+   TCHAR rotatedName[MAX_PATH];
+   _sntprintf(rotatedName, MAX_PATH, _T("%s.1"), fileName);
+
+   FILE *f = _tfopen(fileName, _T("a"));
+   if (f == nullptr)
+   {
+      _tprintf(_T("ERROR: cannot open file %s for writing (%s)\n"), fileName, _tcserror(errno));
+      return;
+   }
+
+   for(int i = 0; i < count; i++)
+   {
+      fprintf(f, "%s nxlptest: generated record %d status=%s\n", "2020-01-01 00:00:00", i, (i % 10 == 0) ? "error" : "ok");
+      if ((i + 1) % 1000 == 0)
+      {
+         fflush(f);
+         ThreadSleepMs(1);
+      }
+      if (i == count / 2)
+      {
+         fclose(f);
+         _tremove(rotatedName);
+         _trename(fileName, rotatedName);
+         f = _tfopen(fileName, _T("w"));
+         if (f == nullptr)
+         {
+            _tprintf(_T("ERROR: cannot re-create file %s (%s)\n"), fileName, _tcserror(errno));
+            return;
+         }
+      }
+   }
+   fclose(f);
+}
+
+/**
+ * Run parser on generated file and report throughput
+ */
+static int RunLoadTest(LogParser *parser, int count)
+{
+   TCHAR fname[MAX_PATH];
+   ExpandFileName(parser->getFileName(), fname, MAX_PATH, false);
+   FILE *f = _tfopen(fname, _T("w"));
+   if (f != nullptr)
+      fclose(f);
+
+   THREAD thread = ThreadCreateEx(ParserThread, 0, parser);
+   ThreadSleep(1);   // Let parser open file
+
+   _tprintf(_T("Generating %d records in file %s\n"), count, fname);
+   int64_t startTime = GetCurrentTimeMs();
+   GenerateFileLoad(fname, count);
+   int64_t writeTime = GetCurrentTimeMs() - startTime;
+   while((parser->getProcessedRecordsCount() < count) && (GetCurrentTimeMs() - startTime < 60000))
+      ThreadSleepMs(10);
+   int64_t elapsedTime = GetCurrentTimeMs() - startTime;
+
+   parser->stop();
+   ThreadJoin(thread);
+   _tprintf(_T("Records written: %d in %d ms\nRecords processed: %d\nRecords matched: %d\nElapsed time: %d ms\n"),
+            count, static_cast<int>(writeTime), parser->getProcessedRecordsCount(),
+            parser->getMatchedRecordsCount(), static_cast<int>(elapsedTime));
+   return (parser->getProcessedRecordsCount() == count) ? 0 : 3;
+}
+
 #ifndef _WIN32
 
 bool s_stop = false;
@@ -87,6 +158,7 @@ int main(int argc, char *argv[])
 {
 	int rc = 0, ch, traceLevel = -1;
 	TCHAR *inputFile = NULL;
+	int generateCount = 0;
 #ifdef _WIN32
    bool vssSnapshots = false;
 #endif
@@ -95,7 +167,7 @@ int main(int argc, char *argv[])
 
    // Parse command line
    opterr = 1;
-	while((ch = getopt(argc, argv, "D:f:hist:v")) != -1)
+	while((ch = getopt(argc, argv, "D:f:g:hist:v")) != -1)
    {
 		switch(ch)
 		{
@@ -116,6 +188,9 @@ int main(int argc, char *argv[])
 				inputFile = optarg;
 #endif
 				break;
+         case 'g':
+            generateCount = strtol(optarg, NULL, 0);
+            break;
 #ifdef _WIN32
          case 's':
             vssSnapshots = true;
@@ -162,32 +237,39 @@ int main(int argc, char *argv[])
             parser->setSnapshotMode(true);
 #endif
 
-			THREAD thread = ThreadCreateEx(ParserThread, 0, parser);
+         if (generateCount > 0)
+         {
+            rc = RunLoadTest(parser, generateCount);
+         }
+         else
+         {
+            THREAD thread = ThreadCreateEx(ParserThread, 0, parser);
 #ifdef _WIN32
-			_tprintf(_T("Parser started. Press ESC to stop.\nFile: %s\nTrace level: %d\n\n"),
-				      parser->getFileName(), parser->getTraceLevel());
-			while(1)
-			{
-				ch = _getch();
-				if (ch == 27)
-					break;
-			}
+            _tprintf(_T("Parser started. Press ESC to stop.\nFile: %s\nTrace level: %d\n\n"),
+                     parser->getFileName(), parser->getTraceLevel());
+            while(1)
+            {
+               ch = _getch();
+               if (ch == 27)
+                  break;
+            }
 #else
-			_tprintf(_T("Parser started. Press Ctrl+C to stop.\nFile: %s\nTrace level: %d\n\n"),
-				      parser->getFileName(), parser->getTraceLevel());
+            _tprintf(_T("Parser started. Press Ctrl+C to stop.\nFile: %s\nTrace level: %d\n\n"),
+                     parser->getFileName(), parser->getTraceLevel());
 
-         signal(SIGINT, OnBreak);
+            signal(SIGINT, OnBreak);
 
-         sigset_t signals;
-         sigemptyset(&signals);
-         sigaddset(&signals, SIGINT);
-         pthread_sigmask(SIG_UNBLOCK, &signals, NULL);
+            sigset_t signals;
+            sigemptyset(&signals);
+            sigaddset(&signals, SIGINT);
+            pthread_sigmask(SIG_UNBLOCK, &signals, NULL);
 
-			while(!s_stop)
-            ThreadSleepMs(500);
+            while(!s_stop)
+               ThreadSleepMs(500);
 #endif
-         parser->stop();
-         ThreadJoin(thread);
+            parser->stop();
+            ThreadJoin(thread);
+         }
          delete parser;
 		}
 		else
@@ -0,0 +1,225 @@
+#include "nxbench.h"
+#include <nxdbapi.h>
+
+/**
+ * Database file name
+ */
+static TCHAR s_dbFile[MAX_PATH];
+
+/**
+ * Get database file name - either given on command line or nxbench.sqlite in temporary directory
+ */
+static const TCHAR *GetDatabaseFile()
+{
+   if (g_benchmarkDbFile != nullptr)
+      return g_benchmarkDbFile;
+
+   if (s_dbFile[0] == 0)
+   {
+#ifdef _WIN32
+      GetTempPath(MAX_PATH, s_dbFile);
+#else
+      const TCHAR *tmpDir = _tgetenv(_T("TMPDIR"));
+      _tcslcpy(s_dbFile, ((tmpDir != nullptr) && (*tmpDir != 0)) ? tmpDir : _T("/tmp"), MAX_PATH);
+#endif
+      size_t len = _tcslen(s_dbFile);
+      if ((len > 0) && (s_dbFile[len - 1] != FS_PATH_SEPARATOR_CHAR))
+         _tcslcat(s_dbFile, FS_PATH_SEPARATOR, MAX_PATH);
+      _tcslcat(s_dbFile, _T("nxbench.sqlite"), MAX_PATH);
+   }
+   return s_dbFile;
+}
+
+/**
+ * Number of rows pre-loaded for select benchmarks
+ */
+#define PRELOADED_ROWS  10000
+
+/**
+ * Column definition for bulk insert
+ */
+static const int s_sqlTypes[] = { DB_SQLTYPE_INTEGER, DB_SQLTYPE_BIGINT, DB_SQLTYPE_INTEGER, DB_SQLTYPE_VARCHAR };
+
+/**
+ * Benchmark context
+ */
+struct DatabaseBenchmarkContext
+{
+   DB_DRIVER driver;
+   DB_HANDLE hdb;
+   int32_t nextId;
+   uint32_t seed;
+};
+
+/**
+ * Setup - create database with single table similar to idata_xx
+ */
+static void *Setup()
+{
+   DB_DRIVER driver = DBLoadDriver(g_benchmarkDbDriver, _T(""), false, nullptr, nullptr);
+   if (driver == nullptr)
+   {
+      _tprintf(_T("(cannot load driver %s) "), g_benchmarkDbDriver);
+      return nullptr;
+   }
+
+   const TCHAR *dbFile = GetDatabaseFile();
+   _tremove(dbFile);
+   TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
+   DB_HANDLE hdb = DBConnect(driver, nullptr, dbFile, nullptr, nullptr, nullptr, errorText);
+   if (hdb == nullptr)
+   {
+      _tprintf(_T("(%s) "), errorText);
+      DBUnloadDriver(driver);
+      return nullptr;
+   }
+
+   if (!DBQueryEx(hdb, _T("CREATE TABLE bench_data (item_id integer not null, idata_timestamp bigint not null, status integer not null, idata_value varchar(255), PRIMARY KEY(item_id,idata_timestamp))"), errorText))
+   {
+      _tprintf(_T("(%s) "), errorText);
+      DBDisconnect(hdb);
+      DBUnloadDriver(driver);
+      return nullptr;
+   }
+
+   DatabaseBenchmarkContext *context = new DatabaseBenchmarkContext();
+   context->driver = driver;
+   context->hdb = hdb;
+   context->seed = 1;
+
+   DB_BULK_INSERT bi = DBBulkInsertCreate(_T("bench_data"), _T("item_id,idata_timestamp,status,idata_value"), s_sqlTypes, 4);
+   TCHAR value[32];
+   for(int32_t i = 0; i < PRELOADED_ROWS; i++)
+   {
+      DBBulkInsertAddRow(bi);
+      DBBulkInsertSet(bi, 1, i);
+      DBBulkInsertSet(bi, 2, static_cast<int64_t>(1600000000));
+      DBBulkInsertSet(bi, 3, static_cast<int32_t>(0));
+      _sntprintf(value, 32, _T("%u"), BenchmarkRandom(&context->seed));
+      DBBulkInsertSet(bi, 4, value);
+   }
+   DBBegin(hdb);
+   DBBulkInsertExecute(hdb, bi);
+   DBCommit(hdb);
+   DBBulkInsertFree(bi);
+   context->nextId = PRELOADED_ROWS;
+   return context;
+}
+
+/**
+ * Cleanup
+ */
+static void Cleanup(void *context)
+{
+   DatabaseBenchmarkContext *c = static_cast<DatabaseBenchmarkContext*>(context);
+   DBDisconnect(c->hdb);
+   DBUnloadDriver(c->driver);
+   _tremove(GetDatabaseFile());
+   delete c;
+}
+
+/**
+ * Insert rows using prepared statement in single transaction
+ */
+static void InsertPrepared(void *context, uint32_t operations)
+{
+   DatabaseBenchmarkContext *c = static_cast<DatabaseBenchmarkContext*>(context);
+   DBBegin(c->hdb);
+   DB_STATEMENT hStmt = DBPrepare(c->hdb, _T("INSERT INTO bench_data (item_id,idata_timestamp,status,idata_value) VALUES (?,?,?,?)"), true);
+   if (hStmt != nullptr)
+   {
+      TCHAR value[32];
+      for(uint32_t i = 0; i < operations; i++)
+      {
+         DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, c->nextId++);
+         DBBind(hStmt, 2, DB_SQLTYPE_BIGINT, static_cast<INT64>(1600000000));
+         DBBind(hStmt, 3, DB_SQLTYPE_INTEGER, static_cast<INT32>(0));
+         _sntprintf(value, 32, _T("%u"), BenchmarkRandom(&c->seed));
+         DBBind(hStmt, 4, DB_SQLTYPE_VARCHAR, value, DB_BIND_STATIC);
+         DBExecute(hStmt);
+      }
+      DBFreeStatement(hStmt);
+   }
+   DBCommit(c->hdb);
+}
+
+/**
+ * Insert rows using bulk insert
+ */
+static void BulkInsert(void *context, uint32_t operations)
+{
+   DatabaseBenchmarkContext *c = static_cast<DatabaseBenchmarkContext*>(context);
+   DB_BULK_INSERT bi = DBBulkInsertCreate(_T("bench_data"), _T("item_id,idata_timestamp,status,idata_value"), s_sqlTypes, 4);
+   TCHAR value[32];
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      DBBulkInsertAddRow(bi);
+      DBBulkInsertSet(bi, 1, c->nextId++);
+      DBBulkInsertSet(bi, 2, static_cast<int64_t>(1600000000));
+      DBBulkInsertSet(bi, 3, static_cast<int32_t>(0));
+      _sntprintf(value, 32, _T("%u"), BenchmarkRandom(&c->seed));
+      DBBulkInsertSet(bi, 4, value);
+   }
+   DBBegin(c->hdb);
+   DBBulkInsertExecute(c->hdb, bi);
+   DBCommit(c->hdb);
+   DBBulkInsertFree(bi);
+}
+
+/**
+ * Select single row by primary key using prepared statement
+ */
+static void SelectByKey(void *context, uint32_t operations)
+{
+   DatabaseBenchmarkContext *c = static_cast<DatabaseBenchmarkContext*>(context);
+   DB_STATEMENT hStmt = DBPrepare(c->hdb, _T("SELECT idata_value FROM bench_data WHERE item_id=? AND idata_timestamp=?"), true);
+   if (hStmt == nullptr)
+      return;
+
+   uint32_t seed = 1;
+   TCHAR value[256];
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, static_cast<INT32>(BenchmarkRandom(&seed) % PRELOADED_ROWS));
+      DBBind(hStmt, 2, DB_SQLTYPE_BIGINT, static_cast<INT64>(1600000000));
+      DB_RESULT hResult = DBSelectPrepared(hStmt);
+      if (hResult != nullptr)
+      {
+         if (DBGetNumRows(hResult) > 0)
+            g_benchmarkSink += _tcslen(DBGetField(hResult, 0, 0, value, 256));
+         DBFreeResult(hResult);
+      }
+   }
+   DBFreeStatement(hStmt);
+}
+
+/**
+ * Read large result set
+ */
+static void SelectAll(void *context, uint32_t operations)
+{
+   DatabaseBenchmarkContext *c = static_cast<DatabaseBenchmarkContext*>(context);
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      DB_RESULT hResult = DBSelect(c->hdb, _T("SELECT item_id,idata_timestamp,status,idata_value FROM bench_data WHERE item_id<1000"));
+      if (hResult != nullptr)
+      {
+         int count = DBGetNumRows(hResult);
+         for(int j = 0; j < count; j++)
+            g_benchmarkSink += DBGetFieldLong(hResult, j, 0);
+         DBFreeResult(hResult);
+      }
+   }
+}
+
+/**
+ * Register database benchmarks
+ */
+void RegisterDatabaseBenchmarks()
+{
+   DBInit();
+   RegisterBenchmark("db.sqlite.insert_prepared", 20000, InsertPrepared, Setup, Cleanup);
+   RegisterBenchmark("db.sqlite.bulk_insert", 20000, BulkInsert, Setup, Cleanup);
+   RegisterBenchmark("db.sqlite.select_by_key", 20000, SelectByKey, Setup, Cleanup);
+   RegisterBenchmark("db.sqlite.select_result_set", 50, SelectAll, Setup, Cleanup);
+}
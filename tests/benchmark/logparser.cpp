@@ -0,0 +1,131 @@
+#include "nxbench.h"
+#include <nxlpapi.h>
+
+/**
+ * Number of synthetic log lines
+ */
+#define LOG_LINES 64
+
+/**
+ * Parser definition with rules typical for syslog and application log monitoring
+ */
+static const char *s_parserXml =
+   "<parser>\n"
+   "   <file>benchmark.log</file>\n"
+   "   <macros>\n"
+   "      <macro name=\"ip\">([0-9]{1,3}\\.[0-9]{1,3}\\.[0-9]{1,3}\\.[0-9]{1,3})</macro>\n"
+   "   </macros>\n"
+   "   <rules>\n"
+   "      <rule><match>kernel: Out of memory: Kill process ([0-9]+)</match><event params=\"1\">100001</event></rule>\n"
+   "      <rule><match>sshd\\[[0-9]+\\]: Failed password for (invalid user )?([a-z0-9]+) from @{ip}</match><event params=\"3\">100002</event></rule>\n"
+   "      <rule><match>sshd\\[[0-9]+\\]: Accepted publickey for ([a-z0-9]+) from @{ip}</match><event params=\"2\">100003</event></rule>\n"
+   "      <rule><match>%LINK-3-UPDOWN: Interface ([A-Za-z0-9/]+), changed state to down</match><event params=\"1\">100004</event></rule>\n"
+   "      <rule><match>%LINK-3-UPDOWN: Interface ([A-Za-z0-9/]+), changed state to up</match><event params=\"1\">100005</event></rule>\n"
+   "      <rule><match>disk (sd[a-z]) I/O error, sector ([0-9]+)</match><event params=\"2\">100006</event></rule>\n"
+   "      <rule><match>ERROR \\[([A-Za-z.]+)\\] Connection to database lost</match><event params=\"1\">100007</event></rule>\n"
+   "      <rule><match>WARN .* response time ([0-9]+) ms exceeds threshold</match><event params=\"1\">100008</event></rule>\n"
+   "      <rule><match>CRON\\[[0-9]+\\]: \\(root\\) CMD \\((.*)\\)</match><event params=\"1\">100009</event></rule>\n"
+   "      <rule><match>segfault at [0-9a-f]+ ip [0-9a-f]+ sp [0-9a-f]+ error [0-9]+ in (.*)</match><event params=\"1\">100010</event></rule>\n"
+   "      <rule><match>.*FATAL.*</match><event>100011</event></rule>\n"
+   "      <rule><match>.*panic.*</match><event>100012</event></rule>\n"
+   "   </rules>\n"
+   "</parser>\n";
+
+/**
+ * Line templates (roughly half of them does not match any rule)
+ */
+static const TCHAR *s_lineTemplates[] =
+{
+   _T("Oct 19 10:15:%02d host%d kernel: Out of memory: Kill process %d (java) score 900"),
+   _T("Oct 19 10:15:%02d host%d sshd[%d]: Failed password for invalid user admin from 192.168.1.17 port 52113 ssh2"),
+   _T("Oct 19 10:15:%02d host%d sshd[%d]: Accepted publickey for deploy from 10.10.0.5 port 40022 ssh2"),
+   _T("Oct 19 10:15:%02d host%d systemd[%d]: Started Session 1234 of user deploy."),
+   _T("Oct 19 10:15:%02d host%d %%LINK-3-UPDOWN: Interface GigabitEthernet0/%d, changed state to down"),
+   _T("Oct 19 10:15:%02d host%d app[%d]: INFO [com.example.Service] Request processed in 15 ms"),
+   _T("Oct 19 10:15:%02d host%d app[%d]: WARN [com.example.Service] response time 2500 ms exceeds threshold"),
+   _T("Oct 19 10:15:%02d host%d dhclient[%d]: DHCPACK from 10.0.0.1 (xid=0x5a7d2f11)")
+};
+
+/**
+ * Match callback
+ */
+static void MatchCallback(UINT32 eventCode, const TCHAR *eventName, const TCHAR *eventTag, const TCHAR *line,
+         const TCHAR *source, UINT32 windowsEventId, UINT32 severity, const StringList *captureGroups,
+         const StringList *variables, UINT64 recordId, UINT32 objectId, int repeatCount, time_t timestamp,
+         const TCHAR *agentAction, const StringList *agentActionArgs, void *context)
+{
+   g_benchmarkSink += eventCode;
+}
+
+/**
+ * Benchmark context
+ */
+struct LogParserBenchmarkContext
+{
+   LogParser *parser;
+   TCHAR *lines[LOG_LINES];
+};
+
+/**
+ * Setup
+ */
+static void *Setup()
+{
+   InitLogParserLibrary();
+
+   TCHAR errorText[1024];
+   ObjectArray<LogParser> *parsers = LogParser::createFromXml(s_parserXml, -1, errorText, 1024);
+   if ((parsers == nullptr) || parsers->isEmpty())
+   {
+      _tprintf(_T("(%s) "), errorText);
+      delete parsers;
+      return nullptr;
+   }
+
+   LogParserBenchmarkContext *context = new LogParserBenchmarkContext();
+   context->parser = parsers->get(0);
+   context->parser->setCallback(MatchCallback);
+   for(int i = 1; i < parsers->size(); i++)
+      delete parsers->get(i);
+   delete parsers;
+
+   uint32_t seed = 1;
+   for(int i = 0; i < LOG_LINES; i++)
+   {
+      context->lines[i] = MemAllocString(256);
+      _sntprintf(context->lines[i], 256, s_lineTemplates[i % (sizeof(s_lineTemplates) / sizeof(const TCHAR*))],
+               i % 60, i % 5, BenchmarkRandom(&seed));
+   }
+   return context;
+}
+
+/**
+ * Cleanup
+ */
+static void Cleanup(void *context)
+{
+   LogParserBenchmarkContext *c = static_cast<LogParserBenchmarkContext*>(context);
+   delete c->parser;
+   for(int i = 0; i < LOG_LINES; i++)
+      MemFree(c->lines[i]);
+   delete c;
+   CleanupLogParserLibrary();
+}
+
+/**
+ * Match lines
+ */
+static void MatchLines(void *context, uint32_t operations)
+{
+   LogParserBenchmarkContext *c = static_cast<LogParserBenchmarkContext*>(context);
+   for(uint32_t i = 0; i < operations; i++)
+      c->parser->matchLine(c->lines[i % LOG_LINES]);
+}
+
+/**
+ * Register log parser benchmarks
+ */
+void RegisterLogParserBenchmarks()
+{
+   RegisterBenchmark("logparser.match", 100000, MatchLines, Setup, Cleanup);
+}
@@ -0,0 +1,466 @@
+#include "nxbench.h"
+#include <netxms-version.h>
+#include <math.h>
+
+NETXMS_EXECUTABLE_HEADER(nxbench)
+
+/**
+ * JSON output format version
+ */
+#define BENCHMARK_FORMAT_VERSION 1
+
+/**
+ * Result sink
+ */
+VolatileCounter64 g_benchmarkSink = 0;
+
+/**
+ * Database driver
+ */
+const TCHAR *g_benchmarkDbDriver = _T("sqlite.ddr");
+
+/**
+ * Database file
+ */
+const TCHAR *g_benchmarkDbFile = nullptr;
+
+/**
+ * Registered benchmark
+ */
+struct Benchmark
+{
+   const char *name;
+   uint32_t operations;
+   BenchmarkRunFunction run;
+   BenchmarkSetupFunction setup;
+   BenchmarkCleanupFunction cleanup;
+};
+
+/**
+ * Registered benchmarks
+ */
+static StructArray<Benchmark> s_benchmarks(64, 64);
+
+/**
+ * Register benchmark
+ */
+void RegisterBenchmark(const char *name, uint32_t operations, BenchmarkRunFunction run, BenchmarkSetupFunction setup, BenchmarkCleanupFunction cleanup)
+{
+   Benchmark b;
+   b.name = name;
+   b.operations = operations;
+   b.run = run;
+   b.setup = setup;
+   b.cleanup = cleanup;
+   s_benchmarks.add(&b);
+}
+
+/**
+ * Get monotonic timestamp in nanoseconds
+ */
+static uint64_t GetTimestampNs()
+{
+#if defined(_WIN32)
+   static LARGE_INTEGER frequency = { 0 };
+   if (frequency.QuadPart == 0)
+      QueryPerformanceFrequency(&frequency);
+   LARGE_INTEGER counter;
+   QueryPerformanceCounter(&counter);
+   return static_cast<uint64_t>(static_cast<double>(counter.QuadPart) * 1000000000.0 / static_cast<double>(frequency.QuadPart));
+#elif defined(CLOCK_MONOTONIC)
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return static_cast<uint64_t>(ts.tv_sec) * _ULL(1000000000) + static_cast<uint64_t>(ts.tv_nsec);
+#else
+   struct timeval tv;
+   gettimeofday(&tv, nullptr);
+   return static_cast<uint64_t>(tv.tv_sec) * _ULL(1000000000) + static_cast<uint64_t>(tv.tv_usec) * 1000;
+#endif
+}
+
+/**
+ * Compare doubles for qsort
+ */
+static int CompareDouble(const void *e1, const void *e2)
+{
+   double d1 = *static_cast<const double*>(e1);
+   double d2 = *static_cast<const double*>(e2);
+   return (d1 < d2) ? -1 : ((d1 > d2) ? 1 : 0);
+}
+
+/**
+ * Round value to two decimal places to keep JSON output stable
+ */
+static inline double RoundValue(double v)
+{
+   return floor(v * 100.0 + 0.5) / 100.0;
+}
+
+/**
+ * Check if benchmark name matches one of the filters (name prefix)
+ */
+static bool MatchFilter(const char *name, const StringList& filters)
+{
+   if (filters.isEmpty())
+      return true;
+   for(int i = 0; i < filters.size(); i++)
+   {
+#ifdef UNICODE
+      char prefix[256];
+      wchar_to_mb(filters.get(i), -1, prefix, 256);
+      prefix[255] = 0;
+#else
+      const char *prefix = filters.get(i);
+#endif
+      if (!strncmp(name, prefix, strlen(prefix)))
+         return true;
+   }
+   return false;
+}
+
+/**
+ * Run single benchmark. Returns JSON object with results or nullptr if benchmark was skipped.
+ */
+static json_t *RunBenchmark(const Benchmark *b, int repetitions, double scale)
+{
+   _tprintf(_T("%-40hs "), b->name);
+   fflush(stdout);
+
+   void *context = nullptr;
+   if (b->setup != nullptr)
+   {
+      context = b->setup();
+      if (context == nullptr)
+      {
+         _tprintf(_T("SKIPPED\n"));
+         return nullptr;
+      }
+   }
+
+   uint32_t operations = static_cast<uint32_t>(b->operations * scale);
+   if (operations == 0)
+      operations = 1;
+
+   // Warm-up run (not measured)
+   b->run(context, operations);
+
+   double *samples = MemAllocArrayNoInit<double>(repetitions);
+   for(int i = 0; i < repetitions; i++)
+   {
+      uint64_t startTime = GetTimestampNs();
+      b->run(context, operations);
+      samples[i] = static_cast<double>(GetTimestampNs() - startTime) / static_cast<double>(operations);
+   }
+
+   if (b->cleanup != nullptr)
+      b->cleanup(context);
+
+   qsort(samples, repetitions, sizeof(double), CompareDouble);
+   double median = (repetitions % 2 == 0) ? (samples[repetitions / 2 - 1] + samples[repetitions / 2]) / 2 : samples[repetitions / 2];
+   double mean = 0;
+   for(int i = 0; i < repetitions; i++)
+      mean += samples[i];
+   mean /= repetitions;
+
+   _tprintf(_T("%12.2f ns/op %14.0f ops/sec\n"), median, (median > 0) ? 1000000000.0 / median : 0.0);
+
+   json_t *result = json_object();
+   json_object_set_new(result, "name", json_string(b->name));
+   json_object_set_new(result, "operations", json_integer(operations));
+   json_object_set_new(result, "median", json_real(RoundValue(median)));
+   json_object_set_new(result, "mean", json_real(RoundValue(mean)));
+   json_object_set_new(result, "min", json_real(RoundValue(samples[0])));
+   json_object_set_new(result, "max", json_real(RoundValue(samples[repetitions - 1])));
+   MemFree(samples);
+   return result;
+}
+
+/**
+ * Run all matching benchmarks
+ */
+static int RunBenchmarks(const StringList& filters, int repetitions, double scale, const char *outputFile)
+{
+   json_t *results = json_array();
+   for(int i = 0; i < s_benchmarks.size(); i++)
+   {
+      Benchmark *b = s_benchmarks.get(i);
+      if (!MatchFilter(b->name, filters))
+         continue;
+      json_t *result = RunBenchmark(b, repetitions, scale);
+      if (result != nullptr)
+         json_array_append_new(results, result);
+   }
+
+   if (outputFile == nullptr)
+   {
+      json_decref(results);
+      return 0;
+   }
+
+   json_t *root = json_object();
+   json_object_set_new(root, "format", json_integer(BENCHMARK_FORMAT_VERSION));
+   json_object_set_new(root, "version", json_string(NETXMS_VERSION_STRING_A));
+   json_object_set_new(root, "unit", json_string("ns/op"));
+   json_object_set_new(root, "repetitions", json_integer(repetitions));
+   json_object_set_new(root, "scale", json_real(scale));
+   json_object_set_new(root, "benchmarks", results);
+   int rc = json_dump_file(root, outputFile, JSON_INDENT(2) | JSON_PRESERVE_ORDER | JSON_REAL_PRECISION(12));
+   json_decref(root);
+   if (rc != 0)
+   {
+      _tprintf(_T("Cannot write results to file %hs\n"), outputFile);
+      return 2;
+   }
+   return 0;
+}
+
+/**
+ * Load benchmark results from file
+ */
+static json_t *LoadResults(const char *fileName)
+{
+   json_error_t error;
+   json_t *root = json_load_file(fileName, 0, &error);
+   if (root == nullptr)
+   {
+      _tprintf(_T("Cannot load %hs (%hs at line %d)\n"), fileName, error.text, error.line);
+      return nullptr;
+   }
+   if (!json_is_object(root) || !json_is_array(json_object_get(root, "benchmarks")) ||
+       (json_integer_value(json_object_get(root, "format")) != BENCHMARK_FORMAT_VERSION))
+   {
+      _tprintf(_T("File %hs does not contain benchmark results in supported format\n"), fileName);
+      json_decref(root);
+      return nullptr;
+   }
+   return root;
+}
+
+/**
+ * Find benchmark result by name
+ */
+static json_t *FindResult(json_t *benchmarks, const char *name)
+{
+   size_t index;
+   json_t *e;
+   json_array_foreach(benchmarks, index, e)
+   {
+      const char *n = json_string_value(json_object_get(e, "name"));
+      if ((n != nullptr) && !strcmp(n, name))
+         return e;
+   }
+   return nullptr;
+}
+
+/**
+ * Compare two result files. Returns 0 if there are no regressions above threshold.
+ */
+static int CompareResults(const char *baselineFile, const char *currentFile, double threshold)
+{
+   json_t *baseline = LoadResults(baselineFile);
+   if (baseline == nullptr)
+      return 2;
+   json_t *current = LoadResults(currentFile);
+   if (current == nullptr)
+   {
+      json_decref(baseline);
+      return 2;
+   }
+
+   _tprintf(_T("Baseline: %hs (%hs)\nCurrent:  %hs (%hs)\nThreshold: %.1f%%\n\n"),
+            baselineFile, json_string_value(json_object_get(baseline, "version")),
+            currentFile, json_string_value(json_object_get(current, "version")), threshold);
+   _tprintf(_T("%-40s %14s %14s %9s\n"), _T("Benchmark"), _T("Baseline"), _T("Current"), _T("Change"));
+
+   int regressions = 0;
+   json_t *baselineBenchmarks = json_object_get(baseline, "benchmarks");
+   json_t *currentBenchmarks = json_object_get(current, "benchmarks");
+   size_t index;
+   json_t *e;
+   json_array_foreach(currentBenchmarks, index, e)
+   {
+      const char *name = json_string_value(json_object_get(e, "name"));
+      if (name == nullptr)
+         continue;
+
+      double currValue = json_number_value(json_object_get(e, "median"));
+      json_t *b = FindResult(baselineBenchmarks, name);
+      if (b == nullptr)
+      {
+         _tprintf(_T("%-40hs %14s %14.2f %9s\n"), name, _T("-"), currValue, _T("new"));
+         continue;
+      }
+
+      double baseValue = json_number_value(json_object_get(b, "median"));
+      double change = (baseValue > 0) ? (currValue - baseValue) * 100.0 / baseValue : 0;
+      const TCHAR *mark = _T("");
+      if (change > threshold)
+      {
+         mark = _T(" SLOWER");
+         regressions++;
+      }
+      else if (change < -threshold)
+      {
+         mark = _T(" FASTER");
+      }
+      _tprintf(_T("%-40hs %14.2f %14.2f %+8.1f%%%s\n"), name, baseValue, currValue, change, mark);
+   }
+
+   json_array_foreach(baselineBenchmarks, index, e)
+   {
+      const char *name = json_string_value(json_object_get(e, "name"));
+      if ((name != nullptr) && (FindResult(currentBenchmarks, name) == nullptr))
+         _tprintf(_T("%-40hs %14.2f %14s %9s\n"), name, json_number_value(json_object_get(e, "median")), _T("-"), _T("missing"));
+   }
+
+   _tprintf(_T("\n%d regression(s) above threshold\n"), regressions);
+   json_decref(baseline);
+   json_decref(current);
+   return (regressions > 0) ? 1 : 0;
+}
+
+/**
+ * Show usage
+ */
+static void ShowUsage()
+{
+   _tprintf(_T("NetXMS Benchmark Suite Version ") NETXMS_VERSION_STRING _T("\n\n")
+            _T("Usage: nxbench [options]\n")
+            _T("       nxbench [-t threshold] -c baseline.json current.json\n\n")
+            _T("Valid options are:\n")
+            _T("   -b prefix     : Run only benchmarks with given name prefix (can be repeated)\n")
+            _T("   -c            : Compare two result files\n")
+            _T("   -d file       : Database file for database benchmarks (default is nxbench.sqlite in temporary directory)\n")
+            _T("   -D driver     : Database driver for database benchmarks (default is sqlite.ddr)\n")
+            _T("   -h            : Display help and exit\n")
+            _T("   -l            : List available benchmarks and exit\n")
+            _T("   -o file       : Write results to given file in JSON format\n")
+            _T("   -r count      : Number of measured repetitions (default is 5)\n")
+            _T("   -s scale      : Scale factor for number of operations (default is 1.0)\n")
+            _T("   -t threshold  : Regression threshold in percents for compare mode (default is 10)\n")
+            _T("\n"));
+}
+
+/**
+ * main()
+ */
+int main(int argc, char *argv[])
+{
+   InitNetXMSProcess(true);
+
+   StringList filters;
+   int repetitions = 5;
+   double scale = 1.0;
+   double threshold = 10.0;
+   const char *outputFile = nullptr;
+   bool compareMode = false;
+   bool listMode = false;
+#ifdef UNICODE
+   WCHAR *dbDriver = nullptr;
+   WCHAR *dbFile = nullptr;
+#endif
+
+   int ch;
+   char *eptr;
+   opterr = 1;
+   while((ch = getopt(argc, argv, "b:cd:D:hlo:r:s:t:")) != -1)
+   {
+      switch(ch)
+      {
+         case 'b':
+#ifdef UNICODE
+            filters.addPreallocated(WideStringFromMBStringSysLocale(optarg));
+#else
+            filters.add(optarg);
+#endif
+            break;
+         case 'c':
+            compareMode = true;
+            break;
+         case 'd':
+#ifdef UNICODE
+            MemFree(dbFile);
+            dbFile = WideStringFromMBStringSysLocale(optarg);
+            g_benchmarkDbFile = dbFile;
+#else
+            g_benchmarkDbFile = optarg;
+#endif
+            break;
+         case 'D':
+#ifdef UNICODE
+            MemFree(dbDriver);
+            dbDriver = WideStringFromMBStringSysLocale(optarg);
+            g_benchmarkDbDriver = dbDriver;
+#else
+            g_benchmarkDbDriver = optarg;
+#endif
+            break;
+         case 'h':
+            ShowUsage();
+            return 0;
+         case 'l':
+            listMode = true;
+            break;
+         case 'o':
+            outputFile = optarg;
+            break;
+         case 'r':
+            repetitions = strtol(optarg, &eptr, 0);
+            if ((*eptr != 0) || (repetitions < 1))
+            {
+               _tprintf(_T("Invalid repetition count \"%hs\"\n"), optarg);
+               return 2;
+            }
+            break;
+         case 's':
+            scale = strtod(optarg, &eptr);
+            if ((*eptr != 0) || (scale <= 0))
+            {
+               _tprintf(_T("Invalid scale factor \"%hs\"\n"), optarg);
+               return 2;
+            }
+            break;
+         case 't':
+            threshold = strtod(optarg, &eptr);
+            if ((*eptr != 0) || (threshold < 0))
+            {
+               _tprintf(_T("Invalid threshold \"%hs\"\n"), optarg);
+               return 2;
+            }
+            break;
+         case '?':
+            return 2;
+      }
+   }
+
+   if (compareMode)
+   {
+      if (argc - optind < 2)
+      {
+         ShowUsage();
+         return 2;
+      }
+      return CompareResults(argv[optind], argv[optind + 1], threshold);
+   }
+
+   RegisterNXCPBenchmarks();
+   RegisterThreadPoolBenchmarks();
+   RegisterTableBenchmarks();
+   RegisterNXSLBenchmarks();
+   RegisterSNMPBenchmarks();
+   RegisterLogParserBenchmarks();
+   RegisterDatabaseBenchmarks();
+   RegisterObjectIndexBenchmarks();
+
+   if (listMode)
+   {
+      for(int i = 0; i < s_benchmarks.size(); i++)
+      {
+         Benchmark *b = s_benchmarks.get(i);
+         _tprintf(_T("%-40hs %u\n"), b->name, b->operations);
+      }
+      return 0;
+   }
+
+   return RunBenchmarks(filters, repetitions, scale, outputFile);
+}
@@ -0,0 +1,67 @@
+#ifndef _nxbench_h_
+#define _nxbench_h_
+
+#include <nms_common.h>
+#include <nms_util.h>
+
+/**
+ * Benchmark setup function. Should return benchmark context or nullptr if benchmark cannot run.
+ */
+typedef void *(*BenchmarkSetupFunction)();
+
+/**
+ * Benchmark function. Should execute given number of operations.
+ */
+typedef void (*BenchmarkRunFunction)(void *context, uint32_t operations);
+
+/**
+ * Benchmark cleanup function
+ */
+typedef void (*BenchmarkCleanupFunction)(void *context);
+
+/**
+ * Register benchmark. Name is used as stable identifier in JSON output and
+ * should not be changed once benchmark is published, otherwise results
+ * from different builds could not be compared.
+ */
+void RegisterBenchmark(const char *name, uint32_t operations, BenchmarkRunFunction run,
+         BenchmarkSetupFunction setup = nullptr, BenchmarkCleanupFunction cleanup = nullptr);
+
+/**
+ * Result sink to prevent compiler from optimizing out benchmarked code
+ */
+extern VolatileCounter64 g_benchmarkSink;
+
+/**
+ * Database driver for database benchmarks
+ */
+extern const TCHAR *g_benchmarkDbDriver;
+
+/**
+ * Database file for database benchmarks (nullptr to use file in temporary directory)
+ */
+extern const TCHAR *g_benchmarkDbFile;
+
+/**
+ * Deterministic pseudo-random number generator for synthetic workloads
+ * (same sequence on all platforms for same seed)
+ */
+static inline uint32_t BenchmarkRandom(uint32_t *state)
+{
+   *state = *state * 1103515245 + 12345;
+   return (*state >> 16) & 0x7FFF;
+}
+
+/**
+ * Benchmark registration functions
+ */
+void RegisterNXCPBenchmarks();
+void RegisterThreadPoolBenchmarks();
+void RegisterTableBenchmarks();
+void RegisterNXSLBenchmarks();
+void RegisterSNMPBenchmarks();
+void RegisterLogParserBenchmarks();
+void RegisterDatabaseBenchmarks();
+void RegisterObjectIndexBenchmarks();
+
+#endif
@@ -0,0 +1,155 @@
+#include "nxbench.h"
+#include <nxcpapi.h>
+
+/**
+ * Number of fields of each type in synthetic message
+ */
+#define INT_FIELDS      32
+#define STRING_FIELDS   16
+#define BINARY_SIZE     1024
+
+/**
+ * Fill message with synthetic data
+ */
+static void FillMessage(NXCPMessage *msg)
+{
+   uint32_t seed = 1;
+   uint32_t fieldId = 1;
+   for(int i = 0; i < INT_FIELDS; i++)
+   {
+      msg->setField(fieldId++, BenchmarkRandom(&seed));
+      msg->setField(fieldId++, static_cast<uint64_t>(BenchmarkRandom(&seed)) << 32);
+   }
+
+   TCHAR text[64];
+   for(int i = 0; i < STRING_FIELDS; i++)
+   {
+      _sntprintf(text, 64, _T("Synthetic string value %u for field %u"), BenchmarkRandom(&seed), fieldId);
+      msg->setField(fieldId++, text);
+   }
+
+   BYTE data[BINARY_SIZE];
+   for(int i = 0; i < BINARY_SIZE; i++)
+      data[i] = static_cast<BYTE>(BenchmarkRandom(&seed));
+   msg->setField(fieldId++, data, BINARY_SIZE);
+   msg->setField(fieldId++, InetAddress::parse(_T("10.0.0.1")));
+}
+
+/**
+ * Benchmark context
+ */
+struct NXCPBenchmarkContext
+{
+   NXCPMessage *msg;
+   NXCP_MESSAGE *rawMsg;
+};
+
+/**
+ * Setup
+ */
+static void *Setup()
+{
+   NXCPBenchmarkContext *context = new NXCPBenchmarkContext();
+   context->msg = new NXCPMessage(CMD_REQUEST_COMPLETED, 1);
+   FillMessage(context->msg);
+   context->rawMsg = context->msg->serialize(false);
+   return context;
+}
+
+/**
+ * Cleanup
+ */
+static void Cleanup(void *context)
+{
+   NXCPBenchmarkContext *c = static_cast<NXCPBenchmarkContext*>(context);
+   delete c->msg;
+   MemFree(c->rawMsg);
+   delete c;
+}
+
+/**
+ * Build message from scratch
+ */
+static void Build(void *context, uint32_t operations)
+{
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      NXCPMessage msg(CMD_REQUEST_COMPLETED, i);
+      FillMessage(&msg);
+      g_benchmarkSink += msg.getId();
+   }
+}
+
+/**
+ * Serialize message
+ */
+static void Serialize(void *context, uint32_t operations)
+{
+   NXCPMessage *msg = static_cast<NXCPBenchmarkContext*>(context)->msg;
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      NXCP_MESSAGE *rawMsg = msg->serialize(false);
+      g_benchmarkSink += rawMsg->size;
+      MemFree(rawMsg);
+   }
+}
+
+/**
+ * Serialize message with compression
+ */
+static void SerializeCompressed(void *context, uint32_t operations)
+{
+   NXCPMessage *msg = static_cast<NXCPBenchmarkContext*>(context)->msg;
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      NXCP_MESSAGE *rawMsg = msg->serialize(true);
+      g_benchmarkSink += rawMsg->size;
+      MemFree(rawMsg);
+   }
+}
+
+/**
+ * Deserialize message
+ */
+static void Deserialize(void *context, uint32_t operations)
+{
+   NXCP_MESSAGE *rawMsg = static_cast<NXCPBenchmarkContext*>(context)->rawMsg;
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      NXCPMessage *msg = NXCPMessage::deserialize(rawMsg);
+      g_benchmarkSink += msg->getFieldAsUInt32(1);
+      delete msg;
+   }
+}
+
+/**
+ * Read all fields from parsed message
+ */
+static void GetFields(void *context, uint32_t operations)
+{
+   NXCPMessage *msg = static_cast<NXCPBenchmarkContext*>(context)->msg;
+   TCHAR buffer[64];
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      uint32_t fieldId = 1;
+      for(int j = 0; j < INT_FIELDS; j++)
+      {
+         g_benchmarkSink += msg->getFieldAsUInt32(fieldId++);
+         g_benchmarkSink += msg->getFieldAsUInt64(fieldId++);
+      }
+      for(int j = 0; j < STRING_FIELDS; j++)
+         g_benchmarkSink += _tcslen(msg->getFieldAsString(fieldId++, buffer, 64));
+   }
+}
+
+/**
+ * Register NXCP benchmarks
+ */
+void RegisterNXCPBenchmarks()
+{
+   RegisterBenchmark("nxcp.build", 20000, Build);
+   RegisterBenchmark("nxcp.serialize", 50000, Serialize, Setup, Cleanup);
+   RegisterBenchmark("nxcp.serialize.compressed", 5000, SerializeCompressed, Setup, Cleanup);
+   RegisterBenchmark("nxcp.deserialize", 50000, Deserialize, Setup, Cleanup);
+   RegisterBenchmark("nxcp.get_fields", 20000, GetFields, Setup, Cleanup);
+}
@@ -0,0 +1,107 @@
+#include "nxbench.h"
+#include <nxsl.h>
+
+/**
+ * Synthetic script - mix of arithmetic, string and array operations typical for transformation scripts
+ */
+static const TCHAR *s_script =
+   _T("function makeItem(name, value)\n")
+   _T("{\n")
+   _T("   return name . \"=\" . value;\n")
+   _T("}\n")
+   _T("\n")
+   _T("sum = 0;\n")
+   _T("for(i = 0; i < 100; i++)\n")
+   _T("{\n")
+   _T("   sum += i * 2 + i % 7;\n")
+   _T("}\n")
+   _T("\n")
+   _T("items = %();\n")
+   _T("for(i = 0; i < 20; i++)\n")
+   _T("{\n")
+   _T("   items[i] = makeItem(\"item\" . i, i * 1.5);\n")
+   _T("}\n")
+   _T("\n")
+   _T("text = \"\";\n")
+   _T("foreach(s : items)\n")
+   _T("{\n")
+   _T("   if (s like \"item1*\")\n")
+   _T("      text .= upper(s) . \";\";\n")
+   _T("}\n")
+   _T("\n")
+   _T("return sum + length(text);\n");
+
+/**
+ * Setup
+ */
+static void *Setup()
+{
+   TCHAR errorMessage[256];
+   int errorLine;
+   NXSL_Program *program = NXSLCompile(s_script, errorMessage, 256, &errorLine);
+   if (program == nullptr)
+      _tprintf(_T("(%s) "), errorMessage);
+   return program;
+}
+
+/**
+ * Cleanup
+ */
+static void Cleanup(void *context)
+{
+   delete static_cast<NXSL_Program*>(context);
+}
+
+/**
+ * Compile script
+ */
+static void Compile(void *context, uint32_t operations)
+{
+   TCHAR errorMessage[256];
+   int errorLine;
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      NXSL_Program *program = NXSLCompile(s_script, errorMessage, 256, &errorLine);
+      g_benchmarkSink += (program != nullptr) ? 1 : 0;
+      delete program;
+   }
+}
+
+/**
+ * Create VM and load compiled program
+ */
+static void CreateVM(void *context, uint32_t operations)
+{
+   NXSL_Program *program = static_cast<NXSL_Program*>(context);
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      NXSL_VM *vm = new NXSL_VM(new NXSL_Environment());
+      g_benchmarkSink += vm->load(program) ? 1 : 0;
+      delete vm;
+   }
+}
+
+/**
+ * Create VM, load and run compiled program
+ */
+static void Run(void *context, uint32_t operations)
+{
+   NXSL_Program *program = static_cast<NXSL_Program*>(context);
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      NXSL_VM *vm = new NXSL_VM(new NXSL_Environment());
+      if (vm->load(program) && vm->run())
+         g_benchmarkSink += vm->getResult()->getValueAsInt32();
+      delete vm;
+   }
+}
+
+/**
+ * Register NXSL benchmarks
+ */
+void RegisterNXSLBenchmarks()
+{
+   RegisterBenchmark("nxsl.compile", 2000, Compile);
+   RegisterBenchmark("nxsl.vm.create", 20000, CreateVM, Setup, Cleanup);
+   RegisterBenchmark("nxsl.vm.run", 2000, Run, Setup, Cleanup);
+}
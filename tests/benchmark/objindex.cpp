@@ -0,0 +1,123 @@
+#include "nxbench.h"
+#include <nms_core.h>
+
+/**
+ * Number of objects in synthetic index
+ */
+#define INDEX_OBJECTS   10000
+
+/**
+ * Minimal object for index benchmarks
+ */
+class BenchmarkObject : public NetObj
+{
+public:
+   BenchmarkObject(uint32_t id) : NetObj()
+   {
+      m_id = id;
+      _sntprintf(m_name, MAX_OBJECT_NAME, _T("Object %u"), id);
+   }
+
+   virtual int getObjectClass() const override { return OBJECT_CONTAINER; }
+};
+
+/**
+ * Benchmark context
+ */
+struct ObjectIndexBenchmarkContext
+{
+   shared_ptr<NetObj> *objects;
+   ObjectIndex *index;
+   ObjectIndex *scratchIndex;
+};
+
+/**
+ * Setup
+ */
+static void *Setup()
+{
+   ObjectIndexBenchmarkContext *context = new ObjectIndexBenchmarkContext();
+   context->objects = new shared_ptr<NetObj>[INDEX_OBJECTS];
+   context->index = new ObjectIndex();
+   context->scratchIndex = new ObjectIndex();
+   for(int i = 0; i < INDEX_OBJECTS; i++)
+   {
+      context->objects[i] = make_shared<BenchmarkObject>(i + 1);
+      context->index->put(i + 1, context->objects[i]);
+   }
+   return context;
+}
+
+/**
+ * Cleanup
+ */
+static void Cleanup(void *context)
+{
+   ObjectIndexBenchmarkContext *c = static_cast<ObjectIndexBenchmarkContext*>(context);
+   delete c->index;
+   delete c->scratchIndex;
+   delete[] c->objects;
+   delete c;
+}
+
+/**
+ * Insert objects with ascending IDs (same order as objects are created by server)
+ */
+static void Put(void *context, uint32_t operations)
+{
+   ObjectIndexBenchmarkContext *c = static_cast<ObjectIndexBenchmarkContext*>(context);
+   c->scratchIndex->clear();
+   for(uint32_t i = 0; i < operations; i++)
+      c->scratchIndex->put(i + 1, c->objects[i % INDEX_OBJECTS]);
+   g_benchmarkSink += c->scratchIndex->size();
+}
+
+/**
+ * Lookup objects by ID in random order
+ */
+static void Get(void *context, uint32_t operations)
+{
+   ObjectIndexBenchmarkContext *c = static_cast<ObjectIndexBenchmarkContext*>(context);
+   uint32_t seed = 1;
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      shared_ptr<NetObj> object = c->index->get(BenchmarkRandom(&seed) % INDEX_OBJECTS + 1);
+      if (object != nullptr)
+         g_benchmarkSink++;
+   }
+}
+
+/**
+ * Comparator for find benchmark
+ */
+static bool CompareObjectName(NetObj *object, TCHAR *name)
+{
+   return !_tcscmp(object->getName(), name);
+}
+
+/**
+ * Find objects by name (full index scan)
+ */
+static void Find(void *context, uint32_t operations)
+{
+   ObjectIndexBenchmarkContext *c = static_cast<ObjectIndexBenchmarkContext*>(context);
+   uint32_t seed = 1;
+   TCHAR name[64];
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      _sntprintf(name, 64, _T("Object %u"), BenchmarkRandom(&seed) % INDEX_OBJECTS + 1);
+      shared_ptr<NetObj> object = c->index->find(CompareObjectName, name);
+      if (object != nullptr)
+         g_benchmarkSink++;
+   }
+}
+
+/**
+ * Register object index benchmarks
+ */
+void RegisterObjectIndexBenchmarks()
+{
+   RegisterBenchmark("objindex.put", INDEX_OBJECTS, Put, Setup, Cleanup);
+   RegisterBenchmark("objindex.get", 200000, Get, Setup, Cleanup);
+   RegisterBenchmark("objindex.find", 500, Find, Setup, Cleanup);
+}
@@ -0,0 +1,122 @@
+#include "nxbench.h"
+#include <nxsnmp.h>
+
+/**
+ * Number of variables in synthetic PDU
+ */
+#define PDU_VARIABLES   40
+
+/**
+ * Create synthetic response PDU (ifTable-like walk response)
+ */
+static SNMP_PDU *CreatePDU()
+{
+   SNMP_PDU *pdu = new SNMP_PDU(SNMP_RESPONSE, 12345, SNMP_VERSION_2C);
+   uint32_t seed = 1;
+   TCHAR oid[64], value[64];
+   for(int i = 0; i < PDU_VARIABLES; i++)
+   {
+      int column = (i % 4 == 0) ? 2 : ((i % 4 == 1) ? 5 : 10 + i % 4);
+      _sntprintf(oid, 64, _T(".1.3.6.1.2.1.2.2.1.%d.%d"), column, i / 4 + 1);
+      SNMP_Variable *v = new SNMP_Variable(oid);
+      if (column == 2)
+      {
+         _sntprintf(value, 64, _T("Synthetic interface %d"), i / 4 + 1);
+         v->setValueFromString(ASN_OCTET_STRING, value);
+      }
+      else
+      {
+         _sntprintf(value, 64, _T("%u"), BenchmarkRandom(&seed) * 1000);
+         v->setValueFromString((column == 5) ? ASN_GAUGE32 : ASN_COUNTER32, value);
+      }
+      pdu->bindVariable(v);
+   }
+   return pdu;
+}
+
+/**
+ * Benchmark context
+ */
+struct SNMPBenchmarkContext
+{
+   SNMP_PDU *pdu;
+   SNMP_SecurityContext *securityContext;
+   BYTE *encodedPdu;
+   size_t encodedSize;
+};
+
+/**
+ * Setup
+ */
+static void *Setup()
+{
+   SNMPBenchmarkContext *context = new SNMPBenchmarkContext();
+   context->pdu = CreatePDU();
+   context->securityContext = new SNMP_SecurityContext("public");
+   context->encodedSize = context->pdu->encode(&context->encodedPdu, context->securityContext);
+   return context;
+}
+
+/**
+ * Cleanup
+ */
+static void Cleanup(void *context)
+{
+   SNMPBenchmarkContext *c = static_cast<SNMPBenchmarkContext*>(context);
+   delete c->pdu;
+   delete c->securityContext;
+   MemFree(c->encodedPdu);
+   delete c;
+}
+
+/**
+ * Encode PDU
+ */
+static void Encode(void *context, uint32_t operations)
+{
+   SNMPBenchmarkContext *c = static_cast<SNMPBenchmarkContext*>(context);
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      BYTE *buffer;
+      g_benchmarkSink += c->pdu->encode(&buffer, c->securityContext);
+      MemFree(buffer);
+   }
+}
+
+/**
+ * Decode PDU
+ */
+static void Decode(void *context, uint32_t operations)
+{
+   SNMPBenchmarkContext *c = static_cast<SNMPBenchmarkContext*>(context);
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      SNMP_PDU pdu;
+      if (pdu.parse(c->encodedPdu, c->encodedSize, c->securityContext, false))
+         g_benchmarkSink += pdu.getNumVariables();
+   }
+}
+
+/**
+ * Parse and format OIDs
+ */
+static void ParseOID(void *context, uint32_t operations)
+{
+   uint32_t oid[MAX_OID_LEN];
+   TCHAR text[256];
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      size_t len = SNMPParseOID(_T(".1.3.6.1.4.1.2620.1.6.7.4.3.1.4.1"), oid, MAX_OID_LEN);
+      g_benchmarkSink += _tcslen(SNMPConvertOIDToText(len, oid, text, 256));
+   }
+}
+
+/**
+ * Register SNMP benchmarks
+ */
+void RegisterSNMPBenchmarks()
+{
+   RegisterBenchmark("snmp.pdu.encode", 20000, Encode, Setup, Cleanup);
+   RegisterBenchmark("snmp.pdu.decode", 20000, Decode, Setup, Cleanup);
+   RegisterBenchmark("snmp.oid.parse", 200000, ParseOID);
+}
@@ -0,0 +1,173 @@
+#include "nxbench.h"
+#include <nxcpapi.h>
+
+/**
+ * Synthetic table size
+ */
+#define TABLE_ROWS      100
+
+/**
+ * Create synthetic table (interface-like data)
+ */
+static Table *CreateTable()
+{
+   Table *table = new Table();
+   table->setTitle(_T("Benchmark"));
+   table->addColumn(_T("INDEX"), DCI_DT_INT, _T("Index"), true);
+   table->addColumn(_T("NAME"), DCI_DT_STRING, _T("Name"));
+   table->addColumn(_T("DESCRIPTION"), DCI_DT_STRING, _T("Description"));
+   table->addColumn(_T("SPEED"), DCI_DT_UINT64, _T("Speed"));
+   table->addColumn(_T("IN_OCTETS"), DCI_DT_UINT64, _T("Inbound octets"));
+   table->addColumn(_T("OUT_OCTETS"), DCI_DT_UINT64, _T("Outbound octets"));
+   table->addColumn(_T("STATUS"), DCI_DT_INT, _T("Status"));
+
+   uint32_t seed = 1;
+   TCHAR text[64];
+   for(int i = 0; i < TABLE_ROWS; i++)
+   {
+      table->addRow();
+      table->set(0, static_cast<int32_t>(i + 1));
+      _sntprintf(text, 64, _T("eth%d"), i);
+      table->set(1, text);
+      _sntprintf(text, 64, _T("Synthetic interface %d on slot %d"), i, i / 24);
+      table->set(2, text);
+      table->set(3, static_cast<uint64_t>(1000000000));
+      table->set(4, static_cast<uint64_t>(BenchmarkRandom(&seed)) * 100000);
+      table->set(5, static_cast<uint64_t>(BenchmarkRandom(&seed)) * 100000);
+      table->set(6, static_cast<int32_t>(BenchmarkRandom(&seed) % 3));
+   }
+   return table;
+}
+
+/**
+ * Benchmark context
+ */
+struct TableBenchmarkContext
+{
+   Table *table;
+   char *packedXml;
+   NXCPMessage *msg;
+   NXCPMessage *binaryMsg;
+};
+
+/**
+ * Setup
+ */
+static void *Setup()
+{
+   TableBenchmarkContext *context = new TableBenchmarkContext();
+   context->table = CreateTable();
+   context->packedXml = context->table->createPackedXML();
+   context->msg = new NXCPMessage();
+   context->table->fillMessage(*context->msg, 0, -1);
+   context->binaryMsg = new NXCPMessage();
+   context->table->fillMessageBinary(*context->binaryMsg);
+   return context;
+}
+
+/**
+ * Cleanup
+ */
+static void Cleanup(void *context)
+{
+   TableBenchmarkContext *c = static_cast<TableBenchmarkContext*>(context);
+   delete c->table;
+   MemFree(c->packedXml);
+   delete c->msg;
+   delete c->binaryMsg;
+   delete c;
+}
+
+/**
+ * Pack table to compressed XML
+ */
+static void PackXml(void *context, uint32_t operations)
+{
+   Table *table = static_cast<TableBenchmarkContext*>(context)->table;
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      char *xml = table->createPackedXML();
+      g_benchmarkSink += strlen(xml);
+      MemFree(xml);
+   }
+}
+
+/**
+ * Unpack table from compressed XML
+ */
+static void UnpackXml(void *context, uint32_t operations)
+{
+   const char *xml = static_cast<TableBenchmarkContext*>(context)->packedXml;
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      Table *table = Table::createFromPackedXML(xml);
+      g_benchmarkSink += table->getNumRows();
+      delete table;
+   }
+}
+
+/**
+ * Fill NXCP message (field per cell)
+ */
+static void FillMessage(void *context, uint32_t operations)
+{
+   Table *table = static_cast<TableBenchmarkContext*>(context)->table;
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      NXCPMessage msg;
+      g_benchmarkSink += table->fillMessage(msg, 0, -1);
+   }
+}
+
+/**
+ * Fill NXCP message (binary encoding)
+ */
+static void FillMessageBinary(void *context, uint32_t operations)
+{
+   Table *table = static_cast<TableBenchmarkContext*>(context)->table;
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      NXCPMessage msg;
+      table->fillMessageBinary(msg);
+      g_benchmarkSink += msg.getId();
+   }
+}
+
+/**
+ * Create table from NXCP message (field per cell)
+ */
+static void CreateFromMessage(void *context, uint32_t operations)
+{
+   NXCPMessage *msg = static_cast<TableBenchmarkContext*>(context)->msg;
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      Table table(msg);
+      g_benchmarkSink += table.getNumRows();
+   }
+}
+
+/**
+ * Create table from NXCP message (binary encoding)
+ */
+static void CreateFromMessageBinary(void *context, uint32_t operations)
+{
+   NXCPMessage *msg = static_cast<TableBenchmarkContext*>(context)->binaryMsg;
+   for(uint32_t i = 0; i < operations; i++)
+   {
+      Table table(msg);
+      g_benchmarkSink += table.getNumRows();
+   }
+}
+
+/**
+ * Register table benchmarks
+ */
+void RegisterTableBenchmarks()
+{
+   RegisterBenchmark("table.pack_xml", 500, PackXml, Setup, Cleanup);
+   RegisterBenchmark("table.unpack_xml", 500, UnpackXml, Setup, Cleanup);
+   RegisterBenchmark("table.fill_message", 2000, FillMessage, Setup, Cleanup);
+   RegisterBenchmark("table.fill_message.binary", 2000, FillMessageBinary, Setup, Cleanup);
+   RegisterBenchmark("table.create_from_message", 2000, CreateFromMessage, Setup, Cleanup);
+   RegisterBenchmark("table.create_from_message.binary", 2000, CreateFromMessageBinary, Setup, Cleanup);
+}
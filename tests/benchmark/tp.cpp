@@ -0,0 +1,92 @@
+#include "nxbench.h"
+
+/**
+ * Number of distinct keys for serialized execution
+ */
+#define SERIALIZATION_KEYS 16
+
+/**
+ * Benchmark context
+ */
+struct ThreadPoolBenchmarkContext
+{
+   ThreadPool *pool;
+   VolatileCounter pending;
+   Condition completed;
+
+   ThreadPoolBenchmarkContext() : completed(false)
+   {
+      pool = ThreadPoolCreate(_T("BENCHMARK"), 4, 16);
+      pending = 0;
+   }
+
+   ~ThreadPoolBenchmarkContext()
+   {
+      ThreadPoolDestroy(pool);
+   }
+};
+
+/**
+ * Setup
+ */
+static void *Setup()
+{
+   return new ThreadPoolBenchmarkContext();
+}
+
+/**
+ * Cleanup
+ */
+static void Cleanup(void *context)
+{
+   delete static_cast<ThreadPoolBenchmarkContext*>(context);
+}
+
+/**
+ * Worker function - signal completion when last task is done
+ */
+static void Task(void *arg)
+{
+   ThreadPoolBenchmarkContext *context = static_cast<ThreadPoolBenchmarkContext*>(arg);
+   if (InterlockedDecrement(&context->pending) == 0)
+      context->completed.set();
+}
+
+/**
+ * Execute tasks and wait for completion
+ */
+static void Execute(void *context, uint32_t operations)
+{
+   ThreadPoolBenchmarkContext *c = static_cast<ThreadPoolBenchmarkContext*>(context);
+   c->pending = operations;
+   for(uint32_t i = 0; i < operations; i++)
+      ThreadPoolExecute(c->pool, Task, c);
+   c->completed.wait();
+}
+
+/**
+ * Execute serialized tasks and wait for completion
+ */
+static void ExecuteSerialized(void *context, uint32_t operations)
+{
+   static const TCHAR *keys[SERIALIZATION_KEYS] =
+   {
+      _T("K00"), _T("K01"), _T("K02"), _T("K03"), _T("K04"), _T("K05"), _T("K06"), _T("K07"),
+      _T("K08"), _T("K09"), _T("K10"), _T("K11"), _T("K12"), _T("K13"), _T("K14"), _T("K15")
+   };
+
+   ThreadPoolBenchmarkContext *c = static_cast<ThreadPoolBenchmarkContext*>(context);
+   c->pending = operations;
+   for(uint32_t i = 0; i < operations; i++)
+      ThreadPoolExecuteSerialized(c->pool, keys[i % SERIALIZATION_KEYS], Task, c);
+   c->completed.wait();
+}
+
+/**
+ * Register thread pool benchmarks
+ */
+void RegisterThreadPoolBenchmarks()
+{
+   RegisterBenchmark("threadpool.execute", 200000, Execute, Setup, Cleanup);
+   RegisterBenchmark("threadpool.execute_serialized", 100000, ExecuteSerialized, Setup, Cleanup);
+}
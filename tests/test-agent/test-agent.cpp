@@ -0,0 +1,438 @@
+#include <nms_common.h>
+#include <nms_util.h>
+#include <nms_agent.h>
+#include <testtools.h>
+
+#include "../../src/agent/core/dcbatch.h"
+#include "../../src/agent/core/paramidx.h"
+
+#ifdef __linux__
+#include "../../src/agent/subagents/linux/procsnap.cpp"
+#endif
+
+NETXMS_EXECUTABLE_HEADER(test-agent)
+
+#define SUBAGENT_COUNT     50
+#define PARAMS_PER_AGENT   80
+#define LOOKUP_COUNT       200000
+
+/**
+ * Dummy parameter handler
+ */
+static LONG H_Dummy(const TCHAR *param, const TCHAR *arg, TCHAR *value, AbstractCommSession *session)
+{
+   return SYSINFO_RC_SUCCESS;
+}
+
+/**
+ * Create parameter list similar to one registered by agent with many subagents loaded
+ */
+static NETXMS_SUBAGENT_PARAM *CreateParameterList(int *count)
+{
+   int size = SUBAGENT_COUNT * PARAMS_PER_AGENT + 2;
+   NETXMS_SUBAGENT_PARAM *list = MemAllocArray<NETXMS_SUBAGENT_PARAM>(size);
+   int n = 0;
+   _tcscpy(list[n++].name, _T("Agent.Version"));
+   for(int s = 0; s < SUBAGENT_COUNT; s++)
+   {
+      for(int p = 0; p < PARAMS_PER_AGENT; p++)
+      {
+         switch(p % 4)
+         {
+            case 0:
+               _sntprintf(list[n].name, MAX_PARAM_NAME, _T("Subagent%d.Counter%d"), s, p);
+               break;
+            case 1:
+            case 2:
+               _sntprintf(list[n].name, MAX_PARAM_NAME, _T("Subagent%d.Instance%d(*)"), s, p);
+               break;
+            case 3:
+               if (p % 20 == 3)
+                  _sntprintf(list[n].name, MAX_PARAM_NAME, _T("Subagent%d.Dynamic%d.*"), s, p);
+               else
+                  _sntprintf(list[n].name, MAX_PARAM_NAME, _T("Subagent%d.Item%d(*,*)"), s, p);
+               break;
+         }
+         list[n].handler = H_Dummy;
+         list[n].dataType = DCI_DT_INT;
+         n++;
+      }
+   }
+   _tcscpy(list[n++].name, _T("*.Fallback"));
+   *count = n;
+   return list;
+}
+
+/**
+ * Linear search (reference implementation)
+ */
+static int LinearFind(const NETXMS_SUBAGENT_PARAM *list, int count, const TCHAR *name)
+{
+   for(int i = 0; i < count; i++)
+      if (MatchString(list[i].name, name, false))
+         return i;
+   return -1;
+}
+
+/**
+ * Generate request name
+ */
+static void GenerateRequest(TCHAR *buffer, int seed)
+{
+   int s = seed % SUBAGENT_COUNT;
+   int p = (seed / SUBAGENT_COUNT) % PARAMS_PER_AGENT;
+   switch(seed % 9)
+   {
+      case 0:
+         _sntprintf(buffer, MAX_PARAM_NAME, _T("Subagent%d.Counter%d"), s, p);
+         break;
+      case 1:
+         _sntprintf(buffer, MAX_PARAM_NAME, _T("SUBAGENT%d.instance%d(eth%d)"), s, p, seed % 4);
+         break;
+      case 2:
+         _sntprintf(buffer, MAX_PARAM_NAME, _T("Subagent%d.Item%d(a,b(c))"), s, p);
+         break;
+      case 3:
+         _sntprintf(buffer, MAX_PARAM_NAME, _T("Subagent%d.Dynamic%d.Value"), s, p);
+         break;
+      case 4:
+         _sntprintf(buffer, MAX_PARAM_NAME, _T("Unknown%d.Fallback"), s);
+         break;
+      case 5:
+         _sntprintf(buffer, MAX_PARAM_NAME, _T("Subagent%d.Missing%d"), s, p);
+         break;
+      case 6:
+         _tcscpy(buffer, _T("agent.version"));
+         break;
+      case 7:
+         _sntprintf(buffer, MAX_PARAM_NAME, _T("Subagent%d.Instance%d"), s, p);
+         break;
+      default:
+         _sntprintf(buffer, MAX_PARAM_NAME, _T("Subagent%d.Counter%d(x)"), s, p);
+         break;
+   }
+}
+
+/**
+ * Test parameter index against linear search
+ */
+static void TestParameterIndex()
+{
+   int count;
+   NETXMS_SUBAGENT_PARAM *list = CreateParameterList(&count);
+
+   StartTest(_T("Parameter index - build"));
+   ParameterIndex index;
+   for(int i = 0; i < count; i++)
+      index.add(list[i].name, i);
+   AssertEquals(index.getWildcardCount(), SUBAGENT_COUNT * (PARAMS_PER_AGENT / 20) + 1);
+   EndTest();
+
+   StartTest(_T("Parameter index - lookup"));
+   TCHAR request[MAX_PARAM_NAME];
+   for(int i = 0; i < 20000; i++)
+   {
+      GenerateRequest(request, i * 7919);
+      AssertEquals(index.find(list, request), LinearFind(list, count, request));
+   }
+   EndTest();
+
+   StartTest(_T("Parameter index - lookup performance"));
+   int64_t startTime = GetCurrentTimeMs();
+   int found = 0;
+   for(int i = 0; i < LOOKUP_COUNT / 20; i++)
+   {
+      GenerateRequest(request, i * 7919);
+      if (LinearFind(list, count, request) != -1)
+         found++;
+   }
+   int64_t linearTime = (GetCurrentTimeMs() - startTime) * 20;
+
+   startTime = GetCurrentTimeMs();
+   int foundIndexed = 0;
+   for(int i = 0; i < LOOKUP_COUNT; i++)
+   {
+      GenerateRequest(request, i * 7919);
+      if (index.find(list, request) != -1)
+         foundIndexed++;
+   }
+   int64_t indexedTime = GetCurrentTimeMs() - startTime;
+   AssertTrue(foundIndexed > 0);
+   AssertTrue(indexedTime < linearTime);
+   EndTest(indexedTime);
+   _tprintf(_T("   %d handlers, %d lookups: linear search %d ms (estimated), index %d ms\n"),
+            count, LOOKUP_COUNT, static_cast<int>(linearTime), static_cast<int>(indexedTime));
+
+   MemFree(list);
+}
+
+/**
+ * Number of live test data elements
+ */
+static int s_liveElements = 0;
+
+/**
+ * Data element for batch sender test
+ */
+class TestDataElement
+{
+private:
+   UINT64 m_serverId;
+   int m_sequence;
+
+public:
+   TestDataElement(UINT64 serverId, int sequence)
+   {
+      m_serverId = serverId;
+      m_sequence = sequence;
+      s_liveElements++;
+   }
+
+   ~TestDataElement()
+   {
+      s_liveElements--;
+   }
+
+   UINT64 getServerId() const { return m_serverId; }
+   int getSequence() const { return m_sequence; }
+};
+
+/**
+ * Batch sender for test. Server 2 rejects element with sequence number 5, server 3 has queued values.
+ */
+class TestDataBatchSender : public DataBatchSender<TestDataElement>
+{
+public:
+   StringBuffer sent;
+   StringBuffer queued;
+   int sendCalls;
+
+   TestDataBatchSender()
+   {
+      sendCalls = 0;
+   }
+
+protected:
+   virtual bool isQueued(UINT64 serverId) override
+   {
+      return serverId == 3;
+   }
+
+   virtual void send(UINT64 serverId, ObjectArray<TestDataElement> *elements) override
+   {
+      sendCalls++;
+      for(int i = 0; i < elements->size(); i++)
+      {
+         TestDataElement *e = elements->get(i);
+         if ((serverId == 2) && (e->getSequence() == 5))
+            break;
+         sent.appendFormattedString(_T("%d:%d "), static_cast<int>(serverId), e->getSequence());
+         delete e;
+         elements->set(i, nullptr);
+      }
+   }
+
+   virtual void queue(UINT64 serverId, ObjectArray<TestDataElement> *elements) override
+   {
+      for(int i = 0; i < elements->size(); i++)
+      {
+         TestDataElement *e = elements->get(i);
+         AssertNotNull(e);
+         queued.appendFormattedString(_T("%d:%d "), static_cast<int>(serverId), e->getSequence());
+         delete e;
+      }
+   }
+};
+
+/**
+ * Test grouping and delivery of collected data batch
+ */
+static void TestCollectedDataBatch()
+{
+   StartTest(_T("Data batch sender"));
+   static const UINT64 servers[] = { 1, 2, 1, 3, 2, 2, 1, 2, 3 };
+   ObjectArray<TestDataElement> batch(16, 16, Ownership::False);
+   for(int i = 0; i < 9; i++)
+      batch.add(new TestDataElement(servers[i], i));
+
+   TestDataBatchSender sender;
+   sender.process(&batch);
+   AssertEquals(batch.size(), 0);
+   AssertEquals(s_liveElements, 0);
+   AssertEquals(sender.sendCalls, 2);
+   AssertTrue(!_tcscmp(sender.sent, _T("1:0 1:2 1:6 2:1 2:4 ")));
+   AssertTrue(!_tcscmp(sender.queued, _T("2:5 2:7 3:3 3:8 ")));
+   EndTest();
+}
+
+#ifdef __linux__
+
+/**
+ * Fake process entries for process snapshot test
+ */
+static struct
+{
+   const char *pid;
+   const char *stat;
+   const char *cmdline;
+   size_t cmdlineLen;
+} s_fakeProcesses[] =
+{
+   { "1", "1 (init) S 0 1 1 0 -1 4194560 1000 2000 30 40 150 250 0 0 20 0 1 0 5 170000000 2500 18446744073709551615", "/sbin/init\0splash\0", 18 },
+   { "742", "742 (nxagentd) S 1 742 742 0 -1 4194560 5000 0 12 0 300 100 0 0 20 0 8 0 900 450000000 6000 18446744073709551615", "/usr/bin/nxagentd\0-d\0", 21 },
+   { "743", "743 (weird) name) R 1 743 743 0 -1 4194560 7 0 1 0 2 3 0 0 20 0 2 0 901 1000 10 18446744073709551615", "", 0 },
+   { "1000", "1000 (kworker/0:1) I 2 0 0 0 -1 69238880 0 0 0 0 0 7 0 0 20 0 1 0 50 0 0 18446744073709551615", "", 0 },
+   { "1001", NULL, NULL, 0 },   // terminated process (no stat file)
+   { "self", "1 (init) S 0 1 1 0 -1 4194560 1000 2000 30 40 150 250 0 0 20 0 1 0 5 170000000 2500 18446744073709551615", "", 0 }
+};
+
+/**
+ * Write file for fake process
+ */
+static void WriteFakeFile(const char *base, const char *pid, const char *file, const char *data, size_t len)
+{
+   char path[MAX_PATH];
+   snprintf(path, MAX_PATH, "%s/%s/%s", base, pid, file);
+   FILE *f = fopen(path, "w");
+   if (f != NULL)
+   {
+      fwrite(data, 1, len, f);
+      fclose(f);
+   }
+}
+
+/**
+ * Create fake procfs
+ */
+static void CreateFakeProcfs(const char *base)
+{
+   mkdir(base, 0700);
+   for(size_t i = 0; i < sizeof(s_fakeProcesses) / sizeof(s_fakeProcesses[0]); i++)
+   {
+      char path[MAX_PATH];
+      snprintf(path, MAX_PATH, "%s/%s", base, s_fakeProcesses[i].pid);
+      mkdir(path, 0700);
+      if (s_fakeProcesses[i].stat != NULL)
+      {
+         WriteFakeFile(base, s_fakeProcesses[i].pid, "stat", s_fakeProcesses[i].stat, strlen(s_fakeProcesses[i].stat));
+         WriteFakeFile(base, s_fakeProcesses[i].pid, "cmdline", s_fakeProcesses[i].cmdline, s_fakeProcesses[i].cmdlineLen);
+      }
+   }
+}
+
+/**
+ * Delete fake procfs
+ */
+static void DeleteFakeProcfs(const char *base)
+{
+   for(size_t i = 0; i < sizeof(s_fakeProcesses) / sizeof(s_fakeProcesses[0]); i++)
+   {
+      char path[MAX_PATH];
+      snprintf(path, MAX_PATH, "%s/%s/stat", base, s_fakeProcesses[i].pid);
+      remove(path);
+      snprintf(path, MAX_PATH, "%s/%s/cmdline", base, s_fakeProcesses[i].pid);
+      remove(path);
+      snprintf(path, MAX_PATH, "%s/%s", base, s_fakeProcesses[i].pid);
+      rmdir(path);
+   }
+   rmdir(base);
+}
+
+/**
+ * Find process in snapshot
+ */
+static const ProcessSnapshotEntry *FindProcess(const ProcessSnapshot *snapshot, uint32_t pid)
+{
+   for(int i = 0; i < snapshot->size(); i++)
+      if (snapshot->get(i)->pid == pid)
+         return snapshot->get(i);
+   return NULL;
+}
+
+/**
+ * Test process snapshot on fake procfs
+ */
+static void TestProcessSnapshot()
+{
+   char base[MAX_PATH];
+   snprintf(base, MAX_PATH, "/tmp/test-agent-procfs.%u", static_cast<unsigned int>(getpid()));
+   CreateFakeProcfs(base);
+
+   StartTest(_T("Process snapshot - read"));
+   ProcessSnapshot *snapshot = ProcessSnapshot::create(base);
+   AssertNotNull(snapshot);
+   AssertEquals(snapshot->size(), 4);
+
+   const ProcessSnapshotEntry *p = FindProcess(snapshot, 742);
+   AssertNotNull(p);
+   AssertTrue(!strcmp(p->name, "nxagentd"));
+   AssertEquals(p->state, 'S');
+   AssertEquals(p->parent, 1);
+   AssertEquals(p->minflt, 5000);
+   AssertEquals(p->majflt, 12);
+   AssertEquals(p->utime, 300);
+   AssertEquals(p->ktime, 100);
+   AssertEquals(p->threads, 8);
+   AssertEquals(p->vmsize, 450000000);
+   AssertEquals(p->rss, 6000);
+   AssertEquals(p->uid, getuid());
+   AssertTrue(!strcmp(snapshot->getCommandLine(p), "/usr/bin/nxagentd -d"));
+
+   p = FindProcess(snapshot, 743);
+   AssertNotNull(p);
+   AssertTrue(!strcmp(p->name, "weird) name"));
+   AssertEquals(p->state, 'R');
+   AssertEquals(p->threads, 2);
+   AssertTrue(!strcmp(snapshot->getCommandLine(p), ""));
+
+   p = FindProcess(snapshot, 1);
+   AssertNotNull(p);
+   AssertTrue(!strcmp(snapshot->getCommandLine(p), "/sbin/init splash"));
+   AssertNull(FindProcess(snapshot, 1001));
+   delete snapshot;
+   EndTest();
+
+   StartTest(_T("Process snapshot - cache"));
+   SetProcessSnapshotOptions(base, 60000);
+   uint64_t hits, misses;
+   GetProcessSnapshotStats(&hits, &misses);
+   shared_ptr<ProcessSnapshot> s1 = AcquireProcessSnapshot();
+   shared_ptr<ProcessSnapshot> s2 = AcquireProcessSnapshot();
+   AssertNotNull(s1.get());
+   AssertTrue(s1.get() == s2.get());
+   uint64_t hits2, misses2;
+   GetProcessSnapshotStats(&hits2, &misses2);
+   AssertEquals(hits2 - hits, 1);
+   AssertEquals(misses2 - misses, 1);
+
+   SetProcessSnapshotOptions(base, 0);
+   s2 = AcquireProcessSnapshot();
+   AssertNotNull(s2.get());
+   AssertTrue(s1.get() != s2.get());
+   AssertEquals(s2->size(), 4);
+   EndTest();
+
+   DeleteFakeProcfs(base);
+   SetProcessSnapshotOptions(base, 0);
+   StartTest(_T("Process snapshot - missing procfs"));
+   AssertNull(AcquireProcessSnapshot().get());
+   EndTest();
+}
+
+#endif
+
+/**
+ * main()
+ */
+int main(int argc, char *argv[])
+{
+   InitNetXMSProcess(true);
+
+   TestParameterIndex();
+   TestCollectedDataBatch();
+#ifdef __linux__
+   TestProcessSnapshot();
+#endif
+
+   return 0;
+}
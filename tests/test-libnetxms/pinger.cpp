@@ -0,0 +1,118 @@
+#include <nms_common.h>
+#include <nms_util.h>
+#include <testtools.h>
+
+/**
+ * Number of concurrent requests for loopback test
+ */
+#define CONCURRENT_REQUESTS   500
+
+/**
+ * Completion counter for asynchronous requests
+ */
+struct PingCounter
+{
+   VolatileCounter completed;
+   VolatileCounter success;
+   Condition done;
+   int total;
+
+   PingCounter(int _total) : done(true)
+   {
+      completed = 0;
+      success = 0;
+      total = _total;
+   }
+};
+
+/**
+ * Callback for asynchronous ping test
+ */
+static void PingCallback(UINT32 result, UINT32 rtt, void *context)
+{
+   PingCounter *counter = static_cast<PingCounter*>(context);
+   if (result == ICMP_SUCCESS)
+      InterlockedIncrement(&counter->success);
+   if (InterlockedIncrement(&counter->completed) == counter->total)
+      counter->done.set();
+}
+
+/**
+ * Test shared ICMP pinger
+ */
+void TestIcmpPinger()
+{
+   InetAddress loopback = InetAddress::parse("127.0.0.1");
+
+   StartTest(_T("ICMP pinger - loopback"));
+   PingCounter probe(1);
+   if (!IcmpPingAsync(loopback, 1000, 64, false, PingCallback, &probe))
+   {
+      EndTest();
+      _tprintf(_T("   Raw sockets are not available, ICMP pinger tests skipped\n"));
+      return;
+   }
+   AssertTrue(probe.done.wait(5000));
+   AssertEquals(probe.success, 1);
+
+   UINT32 rtt = 0xFFFFFFFF;
+   AssertEquals(IcmpPingShared(loopback, 3, 1000, &rtt, 64, false), ICMP_SUCCESS);
+   AssertTrue(rtt < 1000);
+   EndTest();
+
+   StartTest(_T("ICMP pinger - concurrent requests"));
+   INT64 startTime = GetCurrentTimeMs();
+   PingCounter counter(CONCURRENT_REQUESTS);
+   for(int i = 0; i < CONCURRENT_REQUESTS; i++)
+      AssertTrue(IcmpPingAsync(loopback, 2000, 64 + (i % 64), (i % 2) == 0, PingCallback, &counter));
+   AssertTrue(counter.done.wait(10000));
+   AssertEquals(counter.completed, CONCURRENT_REQUESTS);
+   AssertTrue(counter.success > CONCURRENT_REQUESTS * 9 / 10);
+   EndTest(GetCurrentTimeMs() - startTime);
+
+   StartTest(_T("ICMP pinger - timeout"));
+   startTime = GetCurrentTimeMs();
+   // TEST-NET-1 address should not respond, but some test environments answer any ping,
+   // so only check that request is completed within expected time
+   PingCounter timeout(1);
+   AssertTrue(IcmpPingAsync(InetAddress::parse("192.0.2.1"), 300, 64, false, PingCallback, &timeout));
+   AssertTrue(timeout.done.wait(2000));
+   AssertTrue(GetCurrentTimeMs() - startTime < 2000);
+   EndTest();
+
+   StartTest(_T("ICMP pinger - multiple targets"));
+   IcmpPingTarget targets[3];
+   targets[0].addr = loopback;
+   targets[1].addr = InetAddress::parse("192.0.2.1");
+   targets[2].addr = loopback;
+   AssertTrue(IcmpPingMultiple(targets, 3, 2, 300, 64, false) >= 2);
+   AssertEquals(targets[0].result, ICMP_SUCCESS);
+   AssertTrue(targets[0].rtt < 300);
+   AssertEquals(targets[2].result, ICMP_SUCCESS);
+   AssertTrue((targets[1].result == ICMP_SUCCESS) || (targets[1].result == ICMP_TIMEOUT) || (targets[1].result == ICMP_UNREACHABLE));
+   EndTest();
+
+   StartTest(_T("ICMP pinger - shutdown"));
+   InitIcmpPinger();
+   InitIcmpPinger();
+   ShutdownIcmpPinger();   // pinger still has registered user
+   PingCounter active(1);
+   AssertTrue(IcmpPingAsync(loopback, 1000, 64, false, PingCallback, &active));
+   AssertTrue(active.done.wait(5000));
+   PingCounter pending(1);
+   AssertTrue(IcmpPingAsync(InetAddress::parse("192.0.2.1"), 60000, 64, false, PingCallback, &pending));
+   ShutdownIcmpPinger();
+   AssertTrue(pending.done.wait(0));
+   AssertFalse(IcmpPingAsync(loopback, 1000, 64, false, PingCallback, &probe));
+   EndTest();
+
+   StartTest(_T("ICMP pinger - restart"));
+   InitIcmpPinger();
+   PingCounter restarted(1);
+   AssertTrue(IcmpPingAsync(loopback, 1000, 64, false, PingCallback, &restarted));
+   AssertTrue(restarted.done.wait(5000));
+   AssertEquals(restarted.success, 1);
+   ShutdownIcmpPinger();
+   AssertFalse(IcmpPingAsync(loopback, 1000, 64, false, PingCallback, &probe));
+   EndTest();
+}
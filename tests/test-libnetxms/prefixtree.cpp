@@ -0,0 +1,170 @@
+#include <nms_common.h>
+#include <nms_util.h>
+#include <testtools.h>
+
+/**
+ * Find longest matching prefix by scanning all prefixes (reference implementation)
+ */
+static const InetAddress *ScanForPrefix(const ObjectArray<InetAddress>& prefixes, const InetAddress& addr)
+{
+   const InetAddress *match = nullptr;
+   for(int i = 0; i < prefixes.size(); i++)
+   {
+      const InetAddress *p = prefixes.get(i);
+      if (p->contain(addr) && ((match == nullptr) || (p->getMaskBits() > match->getMaskBits())))
+         match = p;
+   }
+   return match;
+}
+
+/**
+ * Test IP address prefix tree
+ */
+void TestInetAddressPrefixTree()
+{
+   StartTest(_T("InetAddressPrefixTree - put/get"));
+   InetAddressPrefixTree *tree = new InetAddressPrefixTree();
+   InetAddress p8(0x0A000000, 0xFF000000);
+   InetAddress p16(0x0A010000, 0xFFFF0000);
+   InetAddress p24(0x0A010200, 0xFFFFFF00);
+   InetAddress p24b(0x0A010300, 0xFFFFFF00);
+   AssertFalse(tree->put(p24, &p24));
+   AssertFalse(tree->put(p8, &p8));
+   AssertFalse(tree->put(p24b, &p24b));
+   AssertFalse(tree->put(p16, &p16));
+   AssertTrue(tree->put(p16, &p16));
+   AssertEquals(tree->size(), 4);
+   AssertTrue(tree->get(p8) == &p8);
+   AssertTrue(tree->get(p16) == &p16);
+   AssertTrue(tree->get(p24) == &p24);
+   AssertTrue(tree->get(p24b) == &p24b);
+   AssertNull(tree->get(InetAddress(0x0A010000, 0xFFFFFE00)));
+   EndTest();
+
+   StartTest(_T("InetAddressPrefixTree - longest match"));
+   InetAddress prefix;
+   AssertTrue(tree->findLongestMatch(InetAddress(0x0A010205)) == &p24);
+   AssertTrue(tree->findLongestMatch(InetAddress(0x0A0103FF), &prefix) == &p24b);
+   AssertTrue(prefix.equals(p24b));
+   AssertEquals(prefix.getMaskBits(), 24);
+   AssertTrue(tree->findLongestMatch(InetAddress(0x0A010405)) == &p16);
+   AssertTrue(tree->findLongestMatch(InetAddress(0x0A7F0001)) == &p8);
+   AssertNull(tree->findLongestMatch(InetAddress(0x0B000001)));
+   AssertNull(tree->findLongestMatch(InetAddress::parse("fe80::1")));
+   EndTest();
+
+   StartTest(_T("InetAddressPrefixTree - remove"));
+   AssertTrue(tree->remove(p16) == &p16);
+   AssertNull(tree->remove(p16));
+   AssertEquals(tree->size(), 3);
+   AssertTrue(tree->findLongestMatch(InetAddress(0x0A010405)) == &p8);
+   AssertTrue(tree->findLongestMatch(InetAddress(0x0A010205)) == &p24);
+   AssertTrue(tree->remove(p24) == &p24);
+   AssertTrue(tree->findLongestMatch(InetAddress(0x0A010205)) == &p8);
+   AssertTrue(tree->findLongestMatch(InetAddress(0x0A010301)) == &p24b);
+   AssertTrue(tree->remove(p8) == &p8);
+   AssertNull(tree->findLongestMatch(InetAddress(0x0A010205)));
+   AssertTrue(tree->remove(p24b) == &p24b);
+   AssertTrue(tree->isEmpty());
+   EndTest();
+
+   StartTest(_T("InetAddressPrefixTree - IPv6"));
+   InetAddress v6a = InetAddress::parse("2001:db8::");
+   v6a.setMaskBits(32);
+   InetAddress v6b = InetAddress::parse("2001:db8:0:10::");
+   v6b.setMaskBits(64);
+   InetAddress v4def((UINT32)0);
+   v4def.setMaskBits(0);
+   tree->put(v6a, &v6a);
+   tree->put(v6b, &v6b);
+   tree->put(v4def, &v4def);
+   AssertTrue(tree->findLongestMatch(InetAddress::parse("2001:db8:0:10::15")) == &v6b);
+   AssertTrue(tree->findLongestMatch(InetAddress::parse("2001:db8:1::1")) == &v6a);
+   AssertNull(tree->findLongestMatch(InetAddress::parse("2001:db9::1")));
+   AssertTrue(tree->findLongestMatch(InetAddress(0xC0A80101)) == &v4def);
+   tree->clear();
+   AssertTrue(tree->isEmpty());
+   EndTest();
+
+   // Synthetic zone with ~120k subnets: one /8, 256 /16, 118k /24 and /30 inside every 10th /24
+   // First 65536 /24 subnets fill 10.0.0.0/8, the rest go to 20.0.0.0/8, so 11.0.0.0/8 is never covered
+   ObjectArray<InetAddress> prefixes(131072, 65536, Ownership::True);
+   prefixes.add(new InetAddress(0x0A000000, 0xFF000000));
+   for(uint32_t i = 0; i < 256; i++)
+      prefixes.add(new InetAddress(0x0A000000 | (i << 16), 0xFFFF0000));
+   for(uint32_t i = 0; i < 118000; i++)
+   {
+      uint32_t base = (i < 65536) ? 0x0A000000 : 0x14000000;
+      uint32_t subnet = base | ((i & 0xFFFF) << 8);
+      prefixes.add(new InetAddress(subnet, 0xFFFFFF00));
+      if (i % 10 == 0)
+         prefixes.add(new InetAddress(subnet | 0x40, 0xFFFFFFFC));
+   }
+
+   StartTest(_T("InetAddressPrefixTree - build (130k prefixes)"));
+   int64_t startTime = GetCurrentTimeMs();
+   for(int i = 0; i < prefixes.size(); i++)
+      tree->put(*prefixes.get(i), prefixes.get(i));
+   AssertEquals(tree->size(), prefixes.size());
+   EndTest(GetCurrentTimeMs() - startTime);
+
+   static const int LOOKUPS = 2000;
+   uint32_t addrList[LOOKUPS];
+   uint32_t seed = 12345;
+   for(int i = 0; i < LOOKUPS; i++)
+   {
+      seed = seed * 1103515245 + 12345;
+      if (i % 50 == 0)
+         addrList[i] = 0x0B000000 | (seed & 0xFFFFFF);   // miss - 11.0.0.0/8 has no subnets
+      else if (i % 7 == 0)
+         addrList[i] = 0x0A000000 | (((seed >> 8) & 0x1FFF) << 8) | 0x41;   // hit on /30
+      else if (i % 3 == 0)
+         addrList[i] = 0x14000000 | (seed & 0xCAFFFF);   // hit on /24 inside 20.0.0.0/8
+      else
+         addrList[i] = 0x0A000000 | (seed & 0xFFFFFF);
+   }
+
+   StartTest(_T("InetAddressPrefixTree - linear scan (2000 lookups)"));
+   const InetAddress *scanResults[LOOKUPS];
+   startTime = GetCurrentTimeMs();
+   for(int i = 0; i < LOOKUPS; i++)
+      scanResults[i] = ScanForPrefix(prefixes, InetAddress(addrList[i]));
+   EndTest(GetCurrentTimeMs() - startTime);
+
+   StartTest(_T("InetAddressPrefixTree - tree lookup (2000 lookups)"));
+   startTime = GetCurrentTimeMs();
+   for(int i = 0; i < LOOKUPS; i++)
+      AssertTrue(tree->findLongestMatch(InetAddress(addrList[i])) == scanResults[i]);
+   EndTest(GetCurrentTimeMs() - startTime);
+
+   StartTest(_T("InetAddressPrefixTree - hit and miss keys"));
+   for(int i = 0; i < LOOKUPS; i++)
+   {
+      if (i % 50 == 0)
+         AssertNull(scanResults[i]);
+      else
+         AssertNotNull(scanResults[i]);
+   }
+   EndTest();
+
+   StartTest(_T("InetAddressPrefixTree - tree lookup (1000000 lookups)"));
+   startTime = GetCurrentTimeMs();
+   int found = 0;
+   for(int i = 0; i < 1000000; i++)
+   {
+      if (tree->findLongestMatch(InetAddress(addrList[i % LOOKUPS])) != nullptr)
+         found++;
+   }
+   AssertTrue(found > 0);
+   EndTest(GetCurrentTimeMs() - startTime);
+
+   StartTest(_T("InetAddressPrefixTree - remove all"));
+   for(int i = prefixes.size() - 1; i >= 0; i -= 2)
+      AssertTrue(tree->remove(*prefixes.get(i)) == prefixes.get(i));
+   for(int i = prefixes.size() - 2; i >= 0; i -= 2)
+      AssertTrue(tree->remove(*prefixes.get(i)) == prefixes.get(i));
+   AssertTrue(tree->isEmpty());
+   EndTest();
+
+   delete tree;
+}
@@ -11,6 +11,8 @@
 NETXMS_EXECUTABLE_HEADER(test-libnetxms)
 
 void TestGauge64();
+void TestIcmpPinger();
+void TestInetAddressPrefixTree();
 void TestMemoryPool();
 void TestObjectMemoryPool();
 void TestThreadPool();
@@ -1309,6 +1311,88 @@ static void TestTable()
    AssertTrue(!_tcscmp(table2->getAsString(15, 0), table->getAsString(15, 0)));
    EndTest(GetCurrentTimeMs() - start);
 
+   StartTest(_T("Table: pack binary"));
+   start = GetCurrentTimeMs();
+   packedTable = table->createPackedBinary();
+   AssertNotNull(packedTable);
+   EndTest(GetCurrentTimeMs() - start);
+
+   StartTest(_T("Table: unpack binary"));
+   start = GetCurrentTimeMs();
+   Table *tableC = Table::createFromPackedData(packedTable);
+   MemFree(packedTable);
+   AssertNotNull(tableC);
+   AssertEquals(tableC->getNumColumns(), table->getNumColumns());
+   AssertEquals(tableC->getNumRows(), table->getNumRows());
+   for(int r = 0; r < table->getNumRows(); r++)
+      for(int c = 0; c < table->getNumColumns(); c++)
+         AssertTrue(!_tcscmp(tableC->getAsString(r, c, _T("(null)")), table->getAsString(r, c, _T("(null)"))));
+   delete tableC;
+   EndTest(GetCurrentTimeMs() - start);
+
+   StartTest(_T("Table: binary format edge cases"));
+   Table *tableB = new Table();
+   tableB->setTitle(_T("Edge cases"));
+   tableB->setExtendedFormat(true);
+   tableB->addColumn(_T("SIGNED"), DCI_DT_INT64, _T("Signed"), true);
+   tableB->addColumn(_T("UNSIGNED"), DCI_DT_UINT64);
+   tableB->addColumn(_T("TEXT"));
+   tableB->addColumn(_T("MIXED"));  // valid signed value followed by value valid only as unsigned
+   tableB->addRow();
+   tableB->set(0, static_cast<int64_t>(_LL(-9223372036854775807) - 1));
+   tableB->set(1, _ULL(18446744073709551615));
+   tableB->set(2, _T("007"));
+   tableB->set(3, _T("-5"));
+   tableB->setStatus(2, 3);
+   tableB->setObjectId(42);
+   tableB->addRow();
+   tableB->set(0, static_cast<int64_t>(_LL(9223372036854775807)));
+   tableB->set(1, static_cast<uint64_t>(0));
+   tableB->set(3, _T("18446744073709551615"));
+   tableB->setCellObjectId(1, 17);
+   tableB->setBaseRow(0);
+   tableB->addRow();
+   tableB->set(0, _T("-0"));
+   tableB->set(1, _T("12"));
+   tableB->set(2, _T("007"));
+   tableB->set(3, _T("3"));
+
+   ByteStream stream;
+   tableB->writeBinary(&stream);
+   stream.seek(0);
+   tableC = Table::createFromBinary(&stream);
+   AssertNotNull(tableC);
+   AssertTrue(!_tcscmp(tableC->getTitle(), _T("Edge cases")));
+   AssertTrue(tableC->isExtendedFormat());
+   AssertEquals(tableC->getColumnDataType(0), DCI_DT_INT64);
+   AssertTrue(tableC->getColumnDefinition(0)->isInstanceColumn());
+   AssertTrue(!_tcscmp(tableC->getColumnDefinition(0)->getDisplayName(), _T("Signed")));
+   for(int r = 0; r < tableB->getNumRows(); r++)
+   {
+      AssertEquals(tableC->getObjectId(r), tableB->getObjectId(r));
+      AssertEquals(tableC->getBaseRow(r), tableB->getBaseRow(r));
+      for(int c = 0; c < tableB->getNumColumns(); c++)
+      {
+         const TCHAR *v = tableB->getAsString(r, c);
+         if (v != nullptr)
+            AssertTrue(!_tcscmp(tableC->getAsString(r, c), v));
+         else
+            AssertNull(tableC->getAsString(r, c));
+         AssertEquals(tableC->getStatus(r, c), tableB->getStatus(r, c));
+         AssertEquals(tableC->getCellObjectId(r, c), tableB->getCellObjectId(r, c));
+      }
+   }
+   delete tableC;
+
+   NXCPMessage msg;
+   tableB->fillMessageBinary(msg);
+   tableC = new Table(&msg);
+   AssertEquals(tableC->getNumRows(), 3);
+   AssertTrue(!_tcscmp(tableC->getAsString(1, 0), _T("9223372036854775807")));
+   delete tableC;
+   delete tableB;
+   EndTest();
+
    StartTest(_T("Table: merge"));
    Table *table3 = new Table();
    table3->addColumn(_T("NAME"));
@@ -1712,10 +1796,44 @@ static void TestDebugTags()
    EndTest(GetCurrentTimeMs() - startTime);
 #endif
 
+   StartTest(_T("Debug tags: registered tag"));
+   DebugTagHandle *handle = nxlog_register_debug_tag(_T("server.node.status.poll"));
+   AssertNotNull(handle);
+   AssertTrue(nxlog_register_debug_tag(_T("server.node.status.poll")) == handle);
+   AssertEquals(handle->level, 2);
+   AssertTrue(nxlog_is_debug_enabled(handle, 2));
+   AssertFalse(nxlog_is_debug_enabled(handle, 3));
+   nxlog_set_debug_level_tag(_T("server.node.status.poll"), 6);
+   AssertEquals(handle->level, 6);
+   nxlog_set_debug_level_tag(_T("server.node.status.poll"), -1);
+   AssertEquals(handle->level, nxlog_get_debug_level_tag(_T("server.node.status.poll")));
+   nxlog_set_debug_level_tag(_T("server.node.status.*"), 8);
+   AssertEquals(handle->level, nxlog_get_debug_level_tag(_T("server.node.status.poll")));
+   EndTest();
+
    StartTest(_T("Debug tags: reset"));
    nxlog_reset_debug_level_tags();
    AssertEquals(nxlog_get_debug_level_tag(_T("test.tag1.subtag1")), nxlog_get_debug_level());
+   AssertEquals(handle->level, nxlog_get_debug_level());
    EndTest();
+
+#if !WITH_ADDRESS_SANITIZER
+   nxlog_set_debug_level(3);
+
+   StartTest(_T("Disabled debug output performance - string tag"));
+   startTime = GetCurrentTimeMs();
+   for(int i = 0; i < 1000000; i++)
+      nxlog_debug_tag(_T("server.node.status.poll"), 6, _T("Test message %d"), i);
+   EndTest(GetCurrentTimeMs() - startTime);
+
+   StartTest(_T("Disabled debug output performance - registered tag"));
+   startTime = GetCurrentTimeMs();
+   for(int i = 0; i < 1000000; i++)
+      nxlog_debug_tag(handle, 6, _T("Test message %d"), i);
+   EndTest(GetCurrentTimeMs() - startTime);
+
+   nxlog_set_debug_level(0);
+#endif
 }
 
 /**
@@ -1775,6 +1893,7 @@ int main(int argc, char *argv[])
    TestMsgWaitQueue();
    TestMacAddress();
    TestInetAddress();
+   TestInetAddressPrefixTree();
    TestItoa();
    TestQueue();
    TestSharedObjectQueue();
@@ -1798,5 +1917,6 @@ int main(int argc, char *argv[])
    TestSubProcess(argv[0]);
    TestThreadPool();
    TestThreadCountAndMaxWaitTime();
+   TestIcmpPinger();
    return 0;
 }
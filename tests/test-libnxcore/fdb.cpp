@@ -0,0 +1,118 @@
+#include "test-libnxcore.h"
+
+/**
+ * Create MAC address for test entry
+ */
+static void MakeMacAddress(int n, BYTE *macAddr)
+{
+   macAddr[0] = 0x02;
+   macAddr[1] = 0x00;
+   macAddr[2] = 0x00;
+   macAddr[3] = static_cast<BYTE>(n >> 16);
+   macAddr[4] = static_cast<BYTE>(n >> 8);
+   macAddr[5] = static_cast<BYTE>(n);
+}
+
+/**
+ * Add entry to forwarding database
+ */
+static void AddEntry(ForwardingDatabase *fdb, int n, uint32_t port, uint16_t type = 3)
+{
+   FDB_ENTRY entry;
+   memset(&entry, 0, sizeof(FDB_ENTRY));
+   MakeMacAddress(n, entry.macAddr);
+   entry.port = port;
+   entry.vlanId = 1;
+   entry.type = type;
+   fdb->addEntry(&entry);
+}
+
+/**
+ * Add bridge port to interface index mapping
+ */
+static void AddPortMapping(ForwardingDatabase *fdb, uint32_t port, uint32_t ifIndex)
+{
+   PORT_MAPPING_ENTRY pm;
+   pm.port = port;
+   pm.ifIndex = ifIndex;
+   fdb->addPortMapping(&pm);
+}
+
+/**
+ * Find interface index for test MAC address
+ */
+static uint32_t FindEntry(ForwardingDatabase *fdb, int n, bool *isStatic = nullptr)
+{
+   BYTE macAddr[MAC_ADDR_LENGTH];
+   MakeMacAddress(n, macAddr);
+   return fdb->findMacAddress(macAddr, isStatic);
+}
+
+/**
+ * Test forwarding database interface index lookup
+ */
+void TestForwardingDatabase()
+{
+   StartTest(_T("Forwarding database - port mapping"));
+   ForwardingDatabase *fdb = new ForwardingDatabase(0);
+   for(uint32_t port = 1; port <= 48; port++)
+      AddPortMapping(fdb, port, port + 1000);
+   AddPortMapping(fdb, 1, 2000);   // first mapping for port wins
+   for(int i = 1; i <= 1000; i++)
+      AddEntry(fdb, i, i % 48 + 1, (i == 7) ? 5 : 3);
+   AddEntry(fdb, 2000, 100);       // unmapped port on unknown node
+   fdb->sort();
+   AssertEquals(fdb->getSize(), 1001);
+   for(int i = 1; i <= 1000; i++)
+      AssertEquals(FindEntry(fdb, i), static_cast<uint32_t>(i % 48 + 1001));
+   AssertEquals(FindEntry(fdb, 2000), 0);
+   AssertEquals(FindEntry(fdb, 3000), 0);
+   bool isStatic = false;
+   AssertEquals(FindEntry(fdb, 7, &isStatic), 1008);
+   AssertTrue(isStatic);
+   FindEntry(fdb, 8, &isStatic);
+   AssertFalse(isStatic);
+   EndTest();
+
+   StartTest(_T("Forwarding database - duplicate entries"));
+   ForwardingDatabase *fdb2 = new ForwardingDatabase(0);
+   AddPortMapping(fdb2, 1, 11);
+   AddPortMapping(fdb2, 2, 12);
+   AddEntry(fdb2, 1, 1);
+   AddEntry(fdb2, 2, 1);
+   AddEntry(fdb2, 1, 2);          // same address reported again on other port
+   fdb2->sort();
+   AssertEquals(fdb2->getSize(), 2);
+   AssertEquals(FindEntry(fdb2, 1), 12);
+   AssertEquals(FindEntry(fdb2, 2), 11);
+   EndTest();
+
+   StartTest(_T("Forwarding database - MAC count on port"));
+   AssertEquals(fdb->getMacCountOnPort(1001), 20);   // 1000 entries on 48 ports
+   AssertEquals(fdb->getMacCountOnPort(1048), 20);
+   AssertEquals(fdb->getMacCountOnPort(2000), 0);
+   AssertEquals(fdb->getMacCountOnPort(0), 1);
+   BYTE macAddr[MAC_ADDR_LENGTH], expectedMacAddr[MAC_ADDR_LENGTH];
+   AssertTrue(fdb->isSingleMacOnPort(0, macAddr));
+   MakeMacAddress(2000, expectedMacAddr);
+   AssertTrue(!memcmp(macAddr, expectedMacAddr, MAC_ADDR_LENGTH));
+   AssertFalse(fdb->isSingleMacOnPort(1001));
+   AssertTrue(fdb2->isSingleMacOnPort(11));
+   AssertTrue(fdb2->isSingleMacOnPort(12));
+   EndTest();
+
+   StartTest(_T("Forwarding database - add entries after sort"));
+   AddEntry(fdb, 5000, 3);
+   AddEntry(fdb, 1, 4);
+   AssertEquals(fdb->getSize(), 1002);
+   AssertEquals(fdb->getMacCountOnPort(1003), 22);
+   fdb->sort();
+   AssertEquals(FindEntry(fdb, 5000), 1003);
+   AssertEquals(FindEntry(fdb, 1), 1004);
+   AssertEquals(fdb->getMacCountOnPort(1003), 22);
+   AssertEquals(fdb->getMacCountOnPort(1002), 20);
+   EndTest();
+
+   fdb->decRefCount();
+   fdb2->decRefCount();
+}
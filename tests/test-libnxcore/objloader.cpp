@@ -0,0 +1,214 @@
+#include "test-libnxcore.h"
+
+#define ROOT_COUNT      40
+#define CHILD_COUNT     5000
+#define FIRST_CHILD_ID  1000
+#define ORPHAN_ID       (FIRST_CHILD_ID + CHILD_COUNT)
+
+/**
+ * Object with single parent loaded from test table
+ */
+class LoaderTestObject : public NetObj
+{
+protected:
+   uint32_t m_loadedParentId;
+   uint32_t m_loaderThreadId;
+
+public:
+   LoaderTestObject() : NetObj()
+   {
+      m_loadedParentId = 0;
+      m_loaderThreadId = 0;
+   }
+
+   virtual int getObjectClass() const override { return OBJECT_CONTAINER; }
+
+   virtual bool loadFromDatabase(DB_HANDLE hdb, UINT32 id) override
+   {
+      m_id = id;
+      m_loaderThreadId = GetCurrentThreadId();
+
+      DB_STATEMENT hStmt = DBPrepare(hdb, _T("SELECT parent_id,name FROM test_objects WHERE id=?"));
+      if (hStmt == nullptr)
+         return false;
+      DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, id);
+      DB_RESULT hResult = DBSelectPrepared(hStmt);
+      bool success = false;
+      if (hResult != nullptr)
+      {
+         if (DBGetNumRows(hResult) > 0)
+         {
+            m_loadedParentId = DBGetFieldULong(hResult, 0, 0);
+            DBGetField(hResult, 0, 1, m_name, MAX_OBJECT_NAME);
+            success = true;
+         }
+         DBFreeResult(hResult);
+      }
+      DBFreeStatement(hStmt);
+      return success;
+   }
+
+   uint32_t getLoadedParentId() const { return m_loadedParentId; }
+   uint32_t getLoaderThreadId() const { return m_loaderThreadId; }
+};
+
+/**
+ * Root objects loaded in current run
+ */
+static shared_ptr<NetObj> s_roots[ROOT_COUNT + 1];
+static int s_loadedObjects = 0;
+static int s_foreignThreadObjects = 0;
+
+/**
+ * Create test object
+ */
+static shared_ptr<NetObj> CreateTestObject()
+{
+   return MakeSharedNObject<LoaderTestObject>();
+}
+
+/**
+ * Count objects loaded outside of main thread
+ */
+static void CountLoadedObject(const shared_ptr<NetObj>& object)
+{
+   s_loadedObjects++;
+   if (static_cast<LoaderTestObject&>(*object).getLoaderThreadId() != GetCurrentThreadId())
+      s_foreignThreadObjects++;
+}
+
+/**
+ * Publish root object
+ */
+static bool PublishRoot(const shared_ptr<NetObj>& object)
+{
+   CountLoadedObject(object);
+   s_roots[object->getId()] = object;
+   return true;
+}
+
+/**
+ * Publish child object (link to parent loaded in previous group)
+ */
+static bool PublishChild(const shared_ptr<NetObj>& object)
+{
+   uint32_t parentId = static_cast<LoaderTestObject&>(*object).getLoadedParentId();
+   if ((parentId == 0) || (parentId > ROOT_COUNT))
+      return false;
+   CountLoadedObject(object);
+   s_roots[parentId]->addChild(object);
+   object->addParent(s_roots[parentId]);
+   return true;
+}
+
+/**
+ * Load test objects using given thread pool and return object tree as text
+ * (list of children IDs for each root object, in child list order)
+ */
+static StringBuffer LoadTestObjects(ThreadPool *threadPool, int threadCount)
+{
+   s_loadedObjects = 0;
+   s_foreignThreadObjects = 0;
+   for(int i = 0; i <= ROOT_COUNT; i++)
+      s_roots[i].reset();
+
+   DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+
+   ObjectClassLoader roots[] = {
+      ObjectClassLoader(_T("roots"), _T("root"), _T("SELECT id FROM test_objects WHERE parent_id=0 ORDER BY id"), CreateTestObject, PublishRoot)
+   };
+   LoadObjectGroup(_T("roots"), roots, 1, hdb, threadPool, threadCount);
+
+   ObjectClassLoader children[] = {
+      ObjectClassLoader(_T("odd children"), _T("child"), _T("SELECT id FROM test_objects WHERE parent_id<>0 AND id%2=1 ORDER BY id"), CreateTestObject, PublishChild),
+      ObjectClassLoader(_T("even children"), _T("child"), _T("SELECT id FROM test_objects WHERE parent_id<>0 AND id%2=0 ORDER BY id"), CreateTestObject, PublishChild)
+   };
+   LoadObjectGroup(_T("children"), children, 2, hdb, threadPool, threadCount);
+
+   DBConnectionPoolReleaseConnection(hdb);
+
+   StringBuffer tree;
+   for(int i = 1; i <= ROOT_COUNT; i++)
+   {
+      if (s_roots[i] == nullptr)
+         continue;
+      tree.append(s_roots[i]->getId());
+      tree.append(_T(":"));
+      SharedObjectArray<NetObj> *childList = s_roots[i]->getChildren();
+      for(int j = 0; j < childList->size(); j++)
+      {
+         NetObj *child = childList->get(j);
+         SharedObjectArray<NetObj> *parentList = child->getParents();
+         if ((parentList->size() != 1) || (parentList->get(0) != s_roots[i].get()))
+            tree.append(_T("!"));
+         delete parentList;
+         tree.append(_T(" "));
+         tree.append(child->getId());
+      }
+      delete childList;
+      tree.append(_T("\n"));
+   }
+   return tree;
+}
+
+/**
+ * Test parallel object loading
+ */
+void TestObjectLoader()
+{
+   StartTest(_T("Object loader - create test objects"));
+   DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+   AssertTrue(DBQuery(hdb, _T("CREATE TABLE test_objects (id integer not null, parent_id integer not null, name varchar(63) not null, PRIMARY KEY(id))")));
+   AssertTrue(DBBegin(hdb));
+   DB_STATEMENT hStmt = DBPrepare(hdb, _T("INSERT INTO test_objects (id,parent_id,name) VALUES (?,?,?)"));
+   AssertNotNull(hStmt);
+   for(uint32_t id = 1; id <= ORPHAN_ID; id++)
+   {
+      if ((id > ROOT_COUNT) && (id < FIRST_CHILD_ID))
+         continue;
+
+      // Last object refers to non-existing parent and should not be loaded
+      uint32_t parentId = (id <= ROOT_COUNT) ? 0 : ((id == ORPHAN_ID) ? ROOT_COUNT + 1 : (id * 7919) % ROOT_COUNT + 1);
+      TCHAR name[64];
+      _sntprintf(name, 64, _T("Object %u"), id);
+      DBBind(hStmt, 1, DB_SQLTYPE_INTEGER, id);
+      DBBind(hStmt, 2, DB_SQLTYPE_INTEGER, parentId);
+      DBBind(hStmt, 3, DB_SQLTYPE_VARCHAR, name, DB_BIND_STATIC);
+      AssertTrue(DBExecute(hStmt));
+   }
+   DBFreeStatement(hStmt);
+   AssertTrue(DBCommit(hdb));
+   DBConnectionPoolReleaseConnection(hdb);
+   EndTest();
+
+   g_bModificationsLocked = TRUE;
+
+   StartTest(_T("Object loader - sequential"));
+   StringBuffer sequentialTree = LoadTestObjects(nullptr, 1);
+   AssertEquals(s_loadedObjects, ROOT_COUNT + CHILD_COUNT);
+   AssertEquals(s_foreignThreadObjects, 0);
+   AssertTrue(_tcschr(sequentialTree, _T('!')) == nullptr);
+   int childCount = 0;
+   for(int i = 1; i <= ROOT_COUNT; i++)
+   {
+      AssertNotNull(s_roots[i]);
+      childCount += s_roots[i]->getChildrenCount();
+   }
+   AssertEquals(childCount, CHILD_COUNT);
+   EndTest();
+
+   StartTest(_T("Object loader - parallel"));
+   ThreadPool *threadPool = ThreadPoolCreate(_T("OBJLOAD"), 8, 8);
+   StringBuffer parallelTree = LoadTestObjects(threadPool, 8);
+   ThreadPoolDestroy(threadPool);
+   AssertEquals(s_loadedObjects, ROOT_COUNT + CHILD_COUNT);
+   AssertTrue(s_foreignThreadObjects > 0);
+   AssertTrue(!_tcscmp(sequentialTree, parallelTree));
+   EndTest();
+
+   g_bModificationsLocked = FALSE;
+
+   hdb = DBConnectionPoolAcquireConnection();
+   DBQuery(hdb, _T("DROP TABLE test_objects"));
+   DBConnectionPoolReleaseConnection(hdb);
+}
@@ -0,0 +1,129 @@
+#include "test-libnxcore.h"
+
+/**
+ * Object with access to common properties save functions
+ */
+class SaveTestObject : public NetObj
+{
+public:
+   SaveTestObject(uint32_t id) : NetObj()
+   {
+      m_id = id;
+      _tcscpy(m_name, _T("Save test object"));
+   }
+
+   virtual int getObjectClass() const override { return OBJECT_CONTAINER; }
+
+   bool save(DB_HANDLE hdb, uint32_t flags)
+   {
+      m_modified = flags;
+      lockProperties();
+      bool success = saveCommonProperties(hdb) && saveACLToDB(hdb);
+      unlockProperties();
+      if (success)
+         markAsSaved();
+      return success;
+   }
+
+   void setTestName(const TCHAR *name) { _tcslcpy(m_name, name, MAX_OBJECT_NAME); }
+
+   void setAccessList(const uint32_t *users, const uint32_t *rights, int count)
+   {
+      NXCPMessage msg;
+      msg.setField(VID_INHERIT_RIGHTS, true);
+      msg.setField(VID_ACL_SIZE, count);
+      for(int i = 0; i < count; i++)
+      {
+         msg.setField(VID_ACL_USER_BASE + i, users[i]);
+         msg.setField(VID_ACL_RIGHTS_BASE + i, rights[i]);
+      }
+      AssertEquals(modifyFromMessage(&msg), RCC_SUCCESS);
+   }
+};
+
+/**
+ * Save object within transaction and return number of executed non-SELECT statements
+ */
+static int SaveObject(DB_HANDLE hdb, SaveTestObject *object, uint32_t flags)
+{
+   AssertTrue(DBBegin(hdb));
+   uint64_t count = DBGetNonSelectQueryCount(hdb);
+   AssertTrue(object->save(hdb, flags));
+   count = DBGetNonSelectQueryCount(hdb) - count;
+   AssertTrue(DBCommit(hdb));
+   return static_cast<int>(count);
+}
+
+/**
+ * Read single text value from database
+ */
+static void ReadValue(DB_HANDLE hdb, const TCHAR *query, TCHAR *buffer, size_t size)
+{
+   DB_RESULT hResult = DBSelect(hdb, query);
+   AssertNotNull(hResult);
+   AssertEquals(DBGetNumRows(hResult), 1);
+   DBGetField(hResult, 0, 0, buffer, size);
+   DBFreeResult(hResult);
+}
+
+/**
+ * Test delta save of common object properties
+ */
+void TestObjectSave()
+{
+   g_bModificationsLocked = TRUE;
+
+   DB_HANDLE hdb = DBConnectionPoolAcquireConnection();
+   AssertTrue(DBQuery(hdb, _T("CREATE TABLE object_properties (object_id integer not null, name varchar(63), status integer, is_deleted integer, ")
+            _T("inherit_access_rights integer, last_modified integer, status_calc_alg integer, status_prop_alg integer, status_fixed_val integer, ")
+            _T("status_shift integer, status_translation varchar(8), status_single_threshold integer, status_thresholds varchar(8), comments varchar(255), ")
+            _T("is_system integer, location_type integer, latitude varchar(20), longitude varchar(20), location_accuracy integer, location_timestamp integer, ")
+            _T("guid varchar(36), image varchar(36), submap_id integer, country varchar(63), city varchar(63), street_address varchar(255), ")
+            _T("postcode varchar(31), maint_event_id integer, state_before_maint integer, state integer, flags integer, creation_time integer, ")
+            _T("maint_initiator integer, PRIMARY KEY(object_id))")));
+   AssertTrue(DBQuery(hdb, _T("CREATE TABLE object_custom_attributes (object_id integer not null, attr_name varchar(127) not null, attr_value varchar(2000), flags integer, PRIMARY KEY(object_id,attr_name))")));
+   AssertTrue(DBQuery(hdb, _T("CREATE TABLE dashboard_associations (object_id integer not null, dashboard_id integer not null, PRIMARY KEY(object_id,dashboard_id))")));
+   AssertTrue(DBQuery(hdb, _T("CREATE TABLE object_urls (object_id integer not null, url_id integer not null, url varchar(2000), description varchar(2000), PRIMARY KEY(object_id,url_id))")));
+   AssertTrue(DBQuery(hdb, _T("CREATE TABLE trusted_nodes (source_object_id integer not null, target_node_id integer not null, PRIMARY KEY(source_object_id,target_node_id))")));
+   AssertTrue(DBQuery(hdb, _T("CREATE TABLE responsible_users (object_id integer not null, user_id integer not null, PRIMARY KEY(object_id,user_id))")));
+   AssertTrue(DBQuery(hdb, _T("CREATE TABLE acl (object_id integer not null, user_id integer not null, access_rights integer not null, PRIMARY KEY(object_id,user_id))")));
+
+   shared_ptr<SaveTestObject> object = MakeSharedNObject<SaveTestObject>(100);
+   uint32_t users[2] = { 1, 2 };
+   uint32_t rights[2] = { 0x0F, 0x01 };
+   object->setAccessList(users, rights, 2);
+
+   StartTest(_T("Object save - initial save"));
+   AssertTrue(SaveObject(hdb, object.get(), MODIFY_COMMON_PROPERTIES | MODIFY_CUSTOM_ATTRIBUTES | MODIFY_ACCESS_LIST) > 0);
+   TCHAR value[256];
+   ReadValue(hdb, _T("SELECT name FROM object_properties WHERE object_id=100"), value, 256);
+   AssertTrue(!_tcscmp(value, _T("Save test object")));
+   ReadValue(hdb, _T("SELECT count(*) FROM acl WHERE object_id=100"), value, 256);
+   AssertTrue(!_tcscmp(value, _T("2")));
+   EndTest();
+
+   StartTest(_T("Object save - unchanged object"));
+   AssertEquals(SaveObject(hdb, object.get(), MODIFY_COMMON_PROPERTIES | MODIFY_CUSTOM_ATTRIBUTES | MODIFY_ACCESS_LIST), 0);
+   EndTest();
+
+   StartTest(_T("Object save - single changed field"));
+   object->setTestName(_T("Renamed test object"));
+   AssertEquals(SaveObject(hdb, object.get(), MODIFY_COMMON_PROPERTIES | MODIFY_CUSTOM_ATTRIBUTES | MODIFY_ACCESS_LIST), 1);
+   ReadValue(hdb, _T("SELECT name FROM object_properties WHERE object_id=100"), value, 256);
+   AssertTrue(!_tcscmp(value, _T("Renamed test object")));
+   AssertEquals(SaveObject(hdb, object.get(), MODIFY_COMMON_PROPERTIES), 0);
+   EndTest();
+
+   StartTest(_T("Object save - single changed ACL element"));
+   rights[1] = 0x03;
+   object->setAccessList(users, rights, 2);
+   AssertEquals(SaveObject(hdb, object.get(), MODIFY_ACCESS_LIST), 1);
+   ReadValue(hdb, _T("SELECT access_rights FROM acl WHERE object_id=100 AND user_id=2"), value, 256);
+   AssertTrue(!_tcscmp(value, _T("3")));
+   AssertEquals(SaveObject(hdb, object.get(), MODIFY_ACCESS_LIST), 0);
+   EndTest();
+
+   DBConnectionPoolReleaseConnection(hdb);
+
+   g_bModificationsLocked = FALSE;
+}
@@ -0,0 +1,148 @@
+#include "test-libnxcore.h"
+
+/**
+ * Number of writer threads and records per thread for concurrent access test
+ */
+#define WRITER_THREADS     4
+#define WRITER_RECORDS     1000
+
+/**
+ * Build path to spool file in system temporary directory
+ */
+static void GetSpoolFilePath(TCHAR *path, size_t size)
+{
+#ifdef _WIN32
+   TCHAR tempDir[MAX_PATH];
+   GetTempPath(MAX_PATH, tempDir);
+   _sntprintf(path, size, _T("%stest-libnxcore.spool"), tempDir);
+#else
+   const char *tempDir = getenv("TMPDIR");
+   if ((tempDir == nullptr) || (*tempDir == 0))
+      tempDir = "/tmp";
+   _sntprintf(path, size, _T("%hs/test-libnxcore.spool"), tempDir);
+#endif
+}
+
+/**
+ * Write record with single 32 bit value to spool
+ */
+static bool WriteRecord(PerfDataSpool *spool, uint32_t value)
+{
+   ByteStream record(16);
+   record.write(value);
+   return spool->write(&record);
+}
+
+/**
+ * Replay context
+ */
+struct ReplayContext
+{
+   int limit;
+   int processed;
+   uint32_t nextValue;
+   bool ordered;
+
+   ReplayContext(int _limit)
+   {
+      limit = _limit;
+      processed = 0;
+      nextValue = 0;
+      ordered = true;
+   }
+};
+
+/**
+ * Replay handler which accepts limited number of records and checks record order
+ */
+static bool ReplayHandler(ByteStream *record, void *context)
+{
+   ReplayContext *c = static_cast<ReplayContext*>(context);
+   if (c->processed >= c->limit)
+      return false;
+   if (record->readUInt32() != c->nextValue)
+      c->ordered = false;
+   c->nextValue++;
+   c->processed++;
+   return true;
+}
+
+/**
+ * Replay handler which accepts all records
+ */
+static bool CountingReplayHandler(ByteStream *record, void *context)
+{
+   (*static_cast<int*>(context))++;
+   return true;
+}
+
+/**
+ * Writer thread for concurrent access test
+ */
+static void SpoolWriterThread(PerfDataSpool *spool)
+{
+   for(uint32_t i = 0; i < WRITER_RECORDS; i++)
+      AssertTrue(WriteRecord(spool, i));
+}
+
+/**
+ * Test performance data spool
+ */
+void TestPerfDataSpool()
+{
+   TCHAR path[MAX_PATH];
+   GetSpoolFilePath(path, MAX_PATH);
+   _tremove(path);
+
+   StartTest(_T("Performance data spool - write"));
+   PerfDataSpool *spool = new PerfDataSpool(path, 1024);
+   AssertEquals(spool->getSize(), static_cast<uint64_t>(0));
+   for(uint32_t i = 0; i < 10; i++)
+      AssertTrue(WriteRecord(spool, i));
+   AssertEquals(spool->getSize(), static_cast<uint64_t>(80));
+   ByteStream largeRecord(2048);
+   for(int i = 0; i < 512; i++)
+      largeRecord.write(static_cast<uint32_t>(i));
+   AssertFalse(spool->write(&largeRecord));
+   AssertEquals(spool->getSize(), static_cast<uint64_t>(80));
+   delete spool;
+
+   // Size of existing file should be picked up on creation
+   spool = new PerfDataSpool(path, 1024);
+   AssertEquals(spool->getSize(), static_cast<uint64_t>(80));
+   EndTest();
+
+   StartTest(_T("Performance data spool - partial replay"));
+   ReplayContext context(4);
+   AssertEquals(spool->replay(ReplayHandler, &context), 4);
+   AssertEquals(spool->getSize(), static_cast<uint64_t>(48));
+   context.limit = INT_MAX;
+   AssertEquals(spool->replay(ReplayHandler, &context), 6);
+   AssertTrue(context.ordered);
+   AssertEquals(context.processed, 10);
+   AssertEquals(spool->getSize(), static_cast<uint64_t>(0));
+   AssertEquals(spool->replay(ReplayHandler, &context), 0);
+   delete spool;
+   EndTest();
+
+   StartTest(_T("Performance data spool - concurrent access"));
+   spool = new PerfDataSpool(path, WRITER_THREADS * WRITER_RECORDS * 8);
+   THREAD threads[WRITER_THREADS];
+   for(int i = 0; i < WRITER_THREADS; i++)
+      threads[i] = ThreadCreateEx(SpoolWriterThread, spool);
+   int replayed = 0;
+   for(int i = 0; i < 50; i++)
+   {
+      if (spool->getSize() > 0)
+         spool->replay(CountingReplayHandler, &replayed);
+      ThreadSleepMs(1);
+   }
+   for(int i = 0; i < WRITER_THREADS; i++)
+      ThreadJoin(threads[i]);
+   spool->replay(CountingReplayHandler, &replayed);
+   AssertEquals(replayed, WRITER_THREADS * WRITER_RECORDS);
+   AssertEquals(spool->getSize(), static_cast<uint64_t>(0));
+   delete spool;
+   _tremove(path);
+   EndTest();
+}
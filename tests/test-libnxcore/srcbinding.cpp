@@ -0,0 +1,76 @@
+#include "test-libnxcore.h"
+
+/**
+ * Test source binding cache
+ */
+void TestSourceBindingCache()
+{
+   InetAddress addr = InetAddress::parse("10.0.0.1");
+   InetAddress otherAddr = InetAddress::parse("10.0.0.2");
+   uint32_t nodeId, generation;
+
+   StartTest(_T("Source binding cache - get/put"));
+   SourceBindingCache cache(_T("Test"), 64, 300);
+   AssertFalse(cache.get(0, addr, "host1", &nodeId, &generation));
+   cache.put(0, addr, "host1", 100, generation);
+   AssertTrue(cache.get(0, addr, "host1", &nodeId, &generation));
+   AssertEquals(nodeId, 100);
+   AssertFalse(cache.get(0, addr, "host2", &nodeId, &generation));
+   AssertFalse(cache.get(1, addr, "host1", &nodeId, &generation));
+   AssertFalse(cache.get(0, otherAddr, nullptr, &nodeId, &generation));
+   cache.put(0, otherAddr, nullptr, 0, generation);
+   AssertTrue(cache.get(0, otherAddr, nullptr, &nodeId, &generation));
+   AssertEquals(nodeId, 0);
+   EndTest();
+
+   StartTest(_T("Source binding cache - invalidation"));
+   InvalidateSourceBindingCaches();
+   AssertFalse(cache.get(0, addr, "host1", &nodeId, &generation));
+   AssertFalse(cache.get(0, otherAddr, nullptr, &nodeId, &generation));
+   EndTest();
+
+   StartTest(_T("Source binding cache - invalidation during lookup"));
+   AssertFalse(cache.get(0, addr, "host1", &nodeId, &generation));
+   InvalidateSourceBindingCaches();   // node index changed while binding was resolved
+   cache.put(0, addr, "host1", 200, generation);
+   AssertFalse(cache.get(0, addr, "host1", &nodeId, &generation));
+   cache.put(0, addr, "host1", 300, generation);
+   AssertTrue(cache.get(0, addr, "host1", &nodeId, &generation));
+   AssertEquals(nodeId, 300);
+   EndTest();
+
+   StartTest(_T("Source binding cache - TTL expiration"));
+   SourceBindingCache shortCache(_T("Short TTL"), 64, 1);
+   AssertFalse(shortCache.get(0, addr, nullptr, &nodeId, &generation));
+   shortCache.put(0, addr, nullptr, 400, generation);
+   AssertTrue(shortCache.get(0, addr, nullptr, &nodeId, &generation));
+   AssertEquals(nodeId, 400);
+   ThreadSleepMs(2100);
+   AssertFalse(shortCache.get(0, addr, nullptr, &nodeId, &generation));
+   EndTest();
+
+   StartTest(_T("Source binding cache - disabled"));
+   SourceBindingCache disabledCache(_T("Disabled"), 64, 0);
+   AssertFalse(disabledCache.get(0, addr, nullptr, &nodeId, &generation));
+   disabledCache.put(0, addr, nullptr, 500, generation);
+   AssertFalse(disabledCache.get(0, addr, nullptr, &nodeId, &generation));
+   EndTest();
+
+   StartTest(_T("Source binding cache - size limit"));
+   SourceBindingCache smallCache(_T("Small"), 16, 300);
+   for(uint32_t i = 1; i <= 100; i++)
+   {
+      InetAddress a(0x0A010000 + i);
+      smallCache.get(0, a, nullptr, &nodeId, &generation);
+      smallCache.put(0, a, nullptr, i, generation);
+      AssertTrue(smallCache.get(0, a, nullptr, &nodeId, &generation));
+      AssertEquals(nodeId, i);
+   }
+   uint64_t hits, misses;
+   int size;
+   smallCache.getStatistics(&hits, &misses, &size);
+   AssertTrue(size <= 16);
+   AssertEquals(hits, 100);
+   AssertEquals(misses, 100);
+   EndTest();
+}
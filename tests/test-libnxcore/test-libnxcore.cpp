@@ -0,0 +1,68 @@
+#include "test-libnxcore.h"
+
+NETXMS_EXECUTABLE_HEADER(test-libnxcore)
+
+/**
+ * Build path to test database in system temporary directory
+ */
+static void GetTestDatabasePath(TCHAR *path, size_t size)
+{
+#ifdef _WIN32
+   TCHAR tempDir[MAX_PATH];
+   GetTempPath(MAX_PATH, tempDir);
+   _sntprintf(path, size, _T("%stest-libnxcore.sqlite"), tempDir);
+#else
+   const char *tempDir = getenv("TMPDIR");
+   if ((tempDir == nullptr) || (*tempDir == 0))
+      tempDir = "/tmp";
+   _sntprintf(path, size, _T("%hs/test-libnxcore.sqlite"), tempDir);
+#endif
+}
+
+/**
+ * main()
+ */
+int main(int argc, char *argv[])
+{
+   InitNetXMSProcess(true);
+   DBInit();
+   DB_DRIVER driver = DBLoadDriver(_T("sqlite.ddr"), _T(""), false, nullptr, nullptr);
+   if (driver == nullptr)
+   {
+      _tprintf(_T("Cannot load SQLite database driver\n"));
+      return 1;
+   }
+
+   TCHAR dbPath[MAX_PATH];
+   GetTestDatabasePath(dbPath, MAX_PATH);
+   _tremove(dbPath);
+
+   // Server configuration is read through connection pool, so create empty configuration table
+   TCHAR errorText[DBDRV_MAX_ERROR_TEXT];
+   DB_HANDLE hdb = DBConnect(driver, nullptr, dbPath, nullptr, nullptr, nullptr, errorText);
+   if (hdb == nullptr)
+   {
+      _tprintf(_T("Cannot create test database %s (%s)\n"), dbPath, errorText);
+      return 1;
+   }
+   DBQuery(hdb, _T("CREATE TABLE config (var_name varchar(63) not null, var_value varchar(2000), PRIMARY KEY(var_name))"));
+   DBDisconnect(hdb);
+
+   if (!DBConnectionPoolStartup(driver, nullptr, dbPath, nullptr, nullptr, nullptr, 4, 16, 60, 0))
+   {
+      _tprintf(_T("Cannot start database connection pool\n"));
+      return 1;
+   }
+
+   TestObjectLoader();
+   TestObjectSave();
+   TestPerfDataSpool();
+   TestSourceBindingCache();
+   TestForwardingDatabase();
+   TestZmqMessageSerialization();
+
+   DBConnectionPoolShutdown();
+   DBUnloadDriver(driver);
+   _tremove(dbPath);
+   return 0;
+}
@@ -0,0 +1,14 @@
+#ifndef _test_libnxcore_h_
+#define _test_libnxcore_h_
+
+#include <nms_core.h>
+#include <testtools.h>
+
+void TestForwardingDatabase();
+void TestObjectLoader();
+void TestObjectSave();
+void TestPerfDataSpool();
+void TestSourceBindingCache();
+void TestZmqMessageSerialization();
+
+#endif
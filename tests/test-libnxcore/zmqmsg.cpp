@@ -0,0 +1,169 @@
+#include "test-libnxcore.h"
+
+/**
+ * Reference serialization of event using jansson
+ */
+static char *EventToJson(const Event *event, const NetObj& object)
+{
+   json_t *root = json_object();
+   json_t *args = json_object();
+   json_t *source = json_object();
+
+   json_object_set_new(root, "source", source);
+   json_object_set_new(root, "arguments", args);
+
+   json_object_set_new(root, "id", json_integer(event->getId()));
+   json_object_set_new(root, "time", json_integer(event->getTimestamp()));
+   json_object_set_new(root, "code", json_integer(event->getCode()));
+   json_object_set_new(root, "severity", json_integer(event->getSeverity()));
+   json_object_set_new(root, "message", json_string_t(event->getMessage()));
+
+   json_object_set_new(source, "id", json_integer(event->getSourceId()));
+   json_object_set_new(source, "type", json_integer(object.getObjectClass()));
+   json_object_set_new(source, "name", json_string_t(object.getName()));
+   if (object.getObjectClass() == OBJECT_NODE)
+   {
+      InetAddress ip = static_cast<const Node&>(object).getIpAddress();
+      char buffer[128];
+      json_object_set_new(source, "primary-ip", json_string(ip.toStringA(buffer)));
+   }
+
+   int count = event->getParametersCount();
+   json_object_set_new(args, "count", json_integer(count));
+   for (int i = 0; i < count; i++)
+   {
+      char name[16];
+      sprintf(name, "p%d", i + 1);
+      json_object_set_new(args, name, json_string_t(event->getParameter(i)));
+   }
+
+   char *message = json_dumps(root, 0);
+   json_decref(root);
+   return message;
+}
+
+/**
+ * Reference serialization of DCI value using jansson
+ */
+static char *DataToJson(UINT32 objectId, UINT32 dciId, const TCHAR *dciName, const TCHAR *value)
+{
+   json_t *root = json_object();
+   json_object_set_new(root, "id", json_integer(objectId));
+
+   json_t *data = json_array();
+   json_object_set_new(root, "data", data);
+
+   json_t *record = json_object();
+   json_object_set_new(record, "id", json_integer(dciId));
+   char *utf8name = UTF8StringFromTString(dciName);
+   json_object_set_new(record, utf8name, json_string_t(value));
+   MemFree(utf8name);
+   json_array_append_new(data, record);
+
+   char *message = json_dumps(root, 0);
+   json_decref(root);
+   return message;
+}
+
+/**
+ * Compare serialized message with reference serialization
+ */
+static bool CompareMessage(ZmqMessage *message, char *expected)
+{
+   bool match = (message->length == strlen(expected)) && !memcmp(message->data, expected, message->length);
+   if (!match)
+      WriteToTerminalEx(_T("\n   Expected: %hs\n   Actual:   %.*hs\n"), expected, static_cast<int>(message->length), message->data);
+   MemFree(message);
+   MemFree(expected);
+   return match;
+}
+
+/**
+ * Test strings (plain, escaped, control characters, non-ASCII, empty)
+ */
+static const TCHAR *s_strings[] =
+{
+   _T("Plain text"),
+   _T("Quote \" backslash \\ slash /"),
+   _T("Tab\tnew line\ncarriage return\rbackspace\bform feed\f"),
+   _T("Control \x01\x1F characters"),
+#ifdef UNICODE
+   L"Non-ASCII: \x00E9t\x00E9 \x0416 \x20AC \x4E2D",
+#if !defined(UNICODE_UCS2)
+   L"Outside BMP: \x1F600",
+#endif
+#endif
+   _T(""),
+   nullptr
+};
+
+/**
+ * Create test event
+ */
+static Event *CreateTestEvent(uint32_t sourceId, const TCHAR *message, int paramCount)
+{
+   json_t *parameters = json_array();
+   for(int i = 0; i < paramCount; i++)
+   {
+      const TCHAR *value = s_strings[i % (sizeof(s_strings) / sizeof(s_strings[0]) - 1)];
+      json_array_append_new(parameters, json_pack("{s:s, s:o}", "name", "param", "value", json_string_t(value)));
+   }
+   json_t *json = json_pack("{s:I, s:I, s:i, s:s, s:I, s:I, s:i, s:i, s:i, s:i, s:i, s:s, s:o, s:o}",
+            "id", static_cast<json_int_t>(123456789012LL), "rootId", static_cast<json_int_t>(0), "code", 4001, "name", "TEST_EVENT",
+            "timestamp", static_cast<json_int_t>(1600000000), "originTimestamp", static_cast<json_int_t>(1600000000), "origin", 0,
+            "source", sourceId, "zone", 0, "dci", 0, "severity", 3, "message", "", "tags", json_array(), "parameters", parameters);
+   Event *event = Event::createFromJson(json);
+   json_decref(json);
+   if (event != nullptr)
+      event->setMessage(message);
+   return event;
+}
+
+/**
+ * Test ZeroMQ message serialization against jansson output
+ */
+void TestZmqMessageSerialization()
+{
+   g_bModificationsLocked = TRUE;
+
+   StartTest(_T("ZeroMQ message serialization - events"));
+   shared_ptr<Container> container = MakeSharedNObject<Container>();
+   shared_ptr<Node> node = MakeSharedNObject<Node>();
+   for(int i = 0; s_strings[i] != nullptr; i++)
+   {
+      container->setName(s_strings[i]);
+      node->setName(s_strings[i]);
+      for(int paramCount = 0; paramCount < 8; paramCount += 3)
+      {
+         Event *event = CreateTestEvent(container->getId(), s_strings[i], paramCount);
+         AssertNotNull(event);
+         AssertTrue(CompareMessage(ZmqSerializeEvent(event, *container), EventToJson(event, *container)));
+         AssertTrue(CompareMessage(ZmqSerializeEvent(event, *node), EventToJson(event, *node)));
+         event->setMessage(nullptr);
+         AssertTrue(CompareMessage(ZmqSerializeEvent(event, *container), EventToJson(event, *container)));
+         delete event;
+      }
+   }
+
+   // Long message exceeding builder's local buffer
+   StringBuffer longText;
+   for(int i = 0; i < 1000; i++)
+      longText.append(s_strings[i % (sizeof(s_strings) / sizeof(s_strings[0]) - 1)]);
+   Event *event = CreateTestEvent(node->getId(), longText, 5);
+   AssertTrue(CompareMessage(ZmqSerializeEvent(event, *node), EventToJson(event, *node)));
+   delete event;
+   EndTest();
+
+   StartTest(_T("ZeroMQ message serialization - data"));
+   for(int i = 0; s_strings[i] != nullptr; i++)
+   {
+      if (s_strings[i][0] != 0)
+         AssertTrue(CompareMessage(ZmqSerializeData(1000, 42, s_strings[i], s_strings[i]), DataToJson(1000, 42, s_strings[i], s_strings[i])));
+      AssertTrue(CompareMessage(ZmqSerializeData(1000, 42, _T("Value"), s_strings[i]), DataToJson(1000, 42, _T("Value"), s_strings[i])));
+   }
+   AssertTrue(CompareMessage(ZmqSerializeData(0xFFFFFFFF, 0xFFFFFFFF, _T("Value"), nullptr), DataToJson(0xFFFFFFFF, 0xFFFFFFFF, _T("Value"), nullptr)));
+   AssertTrue(CompareMessage(ZmqSerializeData(1, 2, _T("Value"), longText), DataToJson(1, 2, _T("Value"), longText)));
+   EndTest();
+
+   g_bModificationsLocked = FALSE;
+}
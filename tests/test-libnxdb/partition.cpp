@@ -0,0 +1,64 @@
+#include <nms_common.h>
+#include <nms_util.h>
+#include <nxdbapi.h>
+#include <testtools.h>
+
+/**
+ * Partition start times and expected name suffixes
+ */
+static struct
+{
+   int64_t start;
+   const TCHAR *suffix;
+} s_partitionNames[] =
+{
+   { 0, _T("19700101") },
+   { 951782400, _T("20000229") },
+   { 1577750400, _T("20191231") },
+   { 1577836800, _T("20200101") },
+   { 1582934400, _T("20200229") },
+   { 1583020800, _T("20200301") },
+   { 1609372800, _T("20201231") },   // weekly partition crossing year boundary
+   { 1612051200, _T("20210131") },
+   { 1612137600, _T("20210201") },
+   { 1614470400, _T("20210228") },
+   { 1614556800, _T("20210301") },
+   { 4107456000, _T("21000228") },
+   { 4107542400, _T("21000301") },   // 2100 is not a leap year
+   { -1, nullptr }
+};
+
+/**
+ * Test time partition name generation and parsing
+ */
+void TestTimePartitionNames(const TCHAR *prefix, DB_HANDLE session, bool mysql)
+{
+   StartTest(prefix, _T("time partition names"));
+   TCHAR name[128], expected[128];
+   for(int i = 0; s_partitionNames[i].suffix != nullptr; i++)
+   {
+      _sntprintf(expected, 128, mysql ? _T("p%s") : _T("event_log_p%s"), s_partitionNames[i].suffix);
+      AssertTrue(!_tcscmp(DBGetTimePartitionName(session, _T("event_log"), s_partitionNames[i].start, name), expected));
+      AssertEquals(DBGetTimePartitionStart(session, _T("event_log"), name), s_partitionNames[i].start);
+
+      // Any time within the day belongs to the same partition
+      AssertTrue(!_tcscmp(DBGetTimePartitionName(session, _T("event_log"), s_partitionNames[i].start + 86399, name), expected));
+   }
+
+   AssertEquals(DBGetTimePartitionStart(session, _T("event_log"), mysql ? _T("pmax") : _T("event_log_pdefault")), static_cast<int64_t>(-1));
+   AssertEquals(DBGetTimePartitionStart(session, _T("event_log"), mysql ? _T("p20201301") : _T("event_log_p20201301")), static_cast<int64_t>(-1));
+   AssertEquals(DBGetTimePartitionStart(session, _T("event_log"), mysql ? _T("p2020010") : _T("event_log_p2020010")), static_cast<int64_t>(-1));
+   AssertEquals(DBGetTimePartitionStart(session, _T("syslog"), _T("event_log_p20200101")), static_cast<int64_t>(-1));
+   EndTest();
+
+   StartTest(prefix, _T("time partition date conversion"));
+   for(int64_t start = 0; start < static_cast<int64_t>(36525) * 86400; start += 86400)
+   {
+      time_t t = static_cast<time_t>(start);
+      struct tm *tm = gmtime(&t);
+      _sntprintf(expected, 128, mysql ? _T("p%04d%02d%02d") : _T("event_log_p%04d%02d%02d"), tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday);
+      AssertTrue(!_tcscmp(DBGetTimePartitionName(session, _T("event_log"), start, name), expected));
+      AssertEquals(DBGetTimePartitionStart(session, _T("event_log"), name), start);
+   }
+   EndTest();
+}
@@ -10,6 +10,11 @@ NETXMS_EXECUTABLE_HEADER(test-libnxdb)
 #define MYSQL_LOGIN    _T("builder")
 #define MYSQL_PASSWORD _T("builder1")
 
+#define PGSQL_SERVER   _T("postgres")
+#define PGSQL_DBNAME   _T("nx_build_test")
+#define PGSQL_LOGIN    _T("builder")
+#define PGSQL_PASSWORD _T("builder1")
+
 #define ORA_SERVER   _T("//127.0.0.1/XE")
 #define ORA_LOGIN    _T("netxms")
 #define ORA_PASSWORD _T("netxms")
@@ -21,6 +26,7 @@ NETXMS_EXECUTABLE_HEADER(test-libnxdb)
 #endif
 
 void TestOracleBatch(const TCHAR *server, const TCHAR *login, const TCHAR *password);
+void TestTimePartitionNames(const TCHAR *prefix, DB_HANDLE session, bool mysql);
 
 /**
  * Common tests
@@ -55,6 +61,8 @@ static void CommonTests(const TCHAR *prefix, const TCHAR *driver, const TCHAR *s
    AssertTrueEx(DBQueryEx(session, query, buffer), buffer);
    EndTest();
 
+   TestTimePartitionNames(prefix, session, !_tcscmp(syntax, _T("MYSQL")));
+
    /*** create test table ***/
    StartTest(prefix, _T("create test table"));
    AssertTrueEx(DBQueryEx(session, _T("CREATE TABLE nx_test (id integer not null,value1 varchar(63), value2 integer, PRIMARY KEY(id))"), buffer), buffer);
@@ -123,6 +131,80 @@ static void CommonTests(const TCHAR *prefix, const TCHAR *driver, const TCHAR *s
    AssertEquals(count, 200);
    EndTest();
 
+   /*** bulk insert ***/
+   StartTest(prefix, _T("bulk insert"));
+   static const int bulkSqlTypes[] = { DB_SQLTYPE_INTEGER, DB_SQLTYPE_VARCHAR, DB_SQLTYPE_INTEGER };
+   DB_BULK_INSERT bi = DBBulkInsertCreate(_T("nx_test"), _T("id,value1,value2_new"), bulkSqlTypes, 3);
+   for(int i = 1001; i <= 6000; i++)
+   {
+      DBBulkInsertAddRow(bi);
+      DBBulkInsertSet(bi, 1, static_cast<INT32>(i));
+      if (i % 100 != 0)  // leave some values unset
+      {
+         DBBulkInsertSet(bi, 2, (i == 1001) ? _T("tab\there\nnew line\\ 'quoted'") : _T("bulk"));
+         DBBulkInsertSet(bi, 3, static_cast<UINT32>(i * 2));
+      }
+   }
+   AssertEquals(DBBulkInsertGetRowCount(bi), 5000);
+   AssertTrue(DBBegin(session));
+   AssertTrueEx(DBBulkInsertExecuteEx(session, bi, buffer), buffer);
+   AssertTrue(DBCommit(session));
+   DBBulkInsertFree(bi);
+
+   hResult = DBSelectEx(session, _T("SELECT count(*),sum(value2_new) FROM nx_test WHERE id>1000"), buffer);
+   AssertNotNullEx(hResult, buffer);
+   AssertEquals(DBGetFieldLong(hResult, 0, 0), 5000);
+   AssertEquals(DBGetFieldInt64(hResult, 0, 1), static_cast<INT64>(34650000));
+   DBFreeResult(hResult);
+
+   hResult = DBSelectEx(session, _T("SELECT value1 FROM nx_test WHERE id=1001"), buffer);
+   AssertNotNullEx(hResult, buffer);
+   TCHAR value[64];
+   AssertTrue(!_tcscmp(DBGetField(hResult, 0, 0, value, 64), _T("tab\there\nnew line\\ 'quoted'")));
+   DBFreeResult(hResult);
+
+   hResult = DBSelectEx(session, _T("SELECT value1,value2_new FROM nx_test WHERE id=1100"), buffer);
+   AssertNotNullEx(hResult, buffer);
+   AssertTrue(DBGetField(hResult, 0, 0, value, 64)[0] == 0);
+   AssertEquals(DBGetFieldLong(hResult, 0, 1), 0);
+   DBFreeResult(hResult);
+   EndTest();
+
+   /*** bulk insert with rejected row ***/
+   StartTest(prefix, _T("bulk insert with rejected row"));
+   bi = DBBulkInsertCreate(_T("nx_test"), _T("id,value1,value2_new"), bulkSqlTypes, 3);
+   for(int i = 6001; i <= 6010; i++)
+   {
+      DBBulkInsertAddRow(bi);
+      DBBulkInsertSet(bi, 1, static_cast<INT32>((i == 6005) ? 1501 : i));  // duplicate primary key
+      DBBulkInsertSet(bi, 2, _T("retry"));
+      DBBulkInsertSet(bi, 3, static_cast<INT32>(i));
+   }
+   AssertTrue(DBBegin(session));
+   AssertFalse(DBBulkInsertExecuteEx(session, bi, buffer));
+   AssertFalse(DBBulkInsertIsConnectionLost(bi));
+   DBRollback(session);
+
+   hResult = DBSelectEx(session, _T("SELECT count(*) FROM nx_test WHERE value1='retry'"), buffer);
+   AssertNotNullEx(hResult, buffer);
+   AssertEquals(DBGetFieldLong(hResult, 0, 0), 0);
+   DBFreeResult(hResult);
+
+   AssertEquals(DBBulkInsertExecuteRowByRow(session, bi), 9);
+   DBBulkInsertFree(bi);
+
+   hResult = DBSelectEx(session, _T("SELECT count(*),sum(value2_new) FROM nx_test WHERE value1='retry'"), buffer);
+   AssertNotNullEx(hResult, buffer);
+   AssertEquals(DBGetFieldLong(hResult, 0, 0), 9);
+   AssertEquals(DBGetFieldInt64(hResult, 0, 1), static_cast<INT64>(54050));
+   DBFreeResult(hResult);
+
+   hResult = DBSelectEx(session, _T("SELECT value1 FROM nx_test WHERE id=1501"), buffer);
+   AssertNotNullEx(hResult, buffer);
+   AssertTrue(!_tcscmp(DBGetField(hResult, 0, 0, value, 64), _T("bulk")));
+   DBFreeResult(hResult);
+   EndTest();
+
    /*** drop test table ***/
    StartTest(prefix, _T("drop test table"));
    AssertTrue(DBQuery(session, _T("DROP TABLE nx_test")));
@@ -145,6 +227,7 @@ int main(int argc, char *argv[])
 
    bool skipMySQL = false;
    bool skipOracle = false;
+   bool skipPgSQL = false;
    bool skipSQLite = false;
 
    for(int i = 1; i < argc; i++)
@@ -153,6 +236,8 @@ int main(int argc, char *argv[])
          skipMySQL = true;
       else if (!strcmp(argv[i], "--skip-oracle"))
          skipOracle = true;
+      else if (!strcmp(argv[i], "--skip-pgsql"))
+         skipPgSQL = true;
       else if (!strcmp(argv[i], "--skip-sqlite"))
          skipSQLite = true;
    }
@@ -170,6 +255,11 @@ int main(int argc, char *argv[])
       TestOracleBatch(ORA_SERVER, ORA_LOGIN, ORA_PASSWORD);
    }
 
+   if (!skipPgSQL)
+   {
+      CommonTests(_T("PostgreSQL"), _T("pgsql.ddr"), PGSQL_SERVER, PGSQL_DBNAME, PGSQL_LOGIN, PGSQL_PASSWORD, _T("PGSQL"));
+   }
+
    if (!skipSQLite)
    {
       CommonTests(_T("SQLite"), _T("sqlite.ddr"), SQLITE_DB, NULL, NULL, NULL, _T("SQLITE"));
@@ -0,0 +1,201 @@
+#include <nms_common.h>
+#include <nms_util.h>
+#include <nxlpapi.h>
+#include <testtools.h>
+
+NETXMS_EXECUTABLE_HEADER(test-libnxlp)
+
+#define RANDOM_LINE_COUNT  200000
+
+/**
+ * Rules for prefilter tests
+ */
+static struct
+{
+   const TCHAR *regexp;
+   bool ignoreCase;
+   bool inverted;
+} s_rules[] =
+{
+   { _T("error.*disk"), true, false },
+   { _T("Disk full"), false, false },
+   { _T("(fail|error) on device"), true, false },
+   { _T("user [a-z]+ logged in"), true, false },
+   { _T("\\d+ packets dropped"), true, false },
+   { _T("^sshd\\[\\d+\\]: Accepted"), false, false },
+   { _T("colou?r depth"), true, false },
+   { _T("ab{2}cd"), true, false },
+   { _T("x\\.y\\.z"), true, false },
+   { _T("(?i)warning: link"), false, false },
+   { _T("[Tt]imeout after"), false, false },
+   { _T("conn(ection)? reset"), true, false },
+   { _T("kernel: oops"), true, false },
+   { _T("link (up|down)"), true, false },
+   { _T("a+bcd+e"), true, false },
+   { _T("abc{0,2}de"), true, false },
+   { _T("\\Qa.b\\E"), true, false },
+   { _T("skip"), true, false },
+   { _T("ask me"), true, false },
+   { _T("disk|net"), true, false },
+   { _T("heartbeat"), true, true },
+   { _T("ab\\x41cd"), true, false },
+   { _T("port\\s+\\d+ is down"), true, false },
+   { _T("[^a]bc de"), false, false },
+   { _T("FULL DISK"), false, false },
+   { nullptr, false, false }
+};
+
+/**
+ * Line fragments for random line generation
+ */
+static const TCHAR *s_fragments[] =
+{
+   _T("error"), _T("disk"), _T("Disk full"), _T("fail"), _T(" on device"), _T("user "), _T("admin"), _T(" logged in"),
+   _T("123"), _T(" packets dropped"), _T("sshd[42]: Accepted"), _T("color"), _T("colour"), _T(" depth"), _T("abbcd"),
+   _T("abcd"), _T("x.y.z"), _T("xay.z"), _T("warning: link"), _T("Timeout after"), _T("connection reset"), _T("conn reset"),
+   _T("kernel: "), _T("oops"), _T("link up"), _T("aabcdde"), _T("abde"), _T("abccde"), _T("a.b"), _T("heartbeat"),
+   _T("port 8 is down"), _T("port  12 is down"), _T("abAcd"), _T("xbc de"), _T("FULL DISK"), _T("net"), _T(" "), _T("-"),
+#ifdef UNICODE
+   L"\x212Aip", L"a\x017Fk me", L"\x00E9t\x00E9",   // KELVIN SIGN and LONG S match K and S in caseless mode
+#endif
+   nullptr
+};
+
+/**
+ * Generate random line from fragments, random characters and random case changes
+ */
+static void GenerateRandomLine(TCHAR *line, size_t size)
+{
+   static int fragmentCount = 0;
+   if (fragmentCount == 0)
+   {
+      while(s_fragments[fragmentCount] != nullptr)
+         fragmentCount++;
+   }
+
+   StringBuffer sb;
+   int parts = rand() % 8 + 1;
+   for(int i = 0; i < parts; i++)
+   {
+      int r = rand() % 10;
+      if (r == 0)
+      {
+         sb.append(static_cast<TCHAR>(rand() % 95 + 32));
+         continue;
+      }
+
+      size_t start = sb.length();
+      sb.append(s_fragments[rand() % fragmentCount]);
+      if (r == 1)
+      {
+         TCHAR *p = sb.getBuffer() + start;
+         for(; *p != 0; p++)
+            if ((*p < 128) && (rand() % 2 == 0))
+               *p = _totupper(*p);
+      }
+   }
+   _tcslcpy(line, sb, size);
+}
+
+/**
+ * Parser callback - record matched rules
+ */
+static void MatchCallback(UINT32 eventCode, const TCHAR *eventName, const TCHAR *eventTag, const TCHAR *line, const TCHAR *source,
+         UINT32 facility, UINT32 severity, const StringList *captureGroups, const StringList *variables, UINT64 recordId,
+         UINT32 objectId, int repeatCount, time_t timestamp, const TCHAR *agentAction, const StringList *agentActionArgs, void *context)
+{
+   static_cast<bool*>(context)[eventCode - 1] = true;
+}
+
+/**
+ * Test rule prefilter against direct regular expression matching
+ */
+static void TestPrefilter()
+{
+   StartTest(_T("Rule prefilter - required literals"));
+   LogParser parser;
+   LogParserRule *rules[64];
+   int ruleCount = 0;
+   for(; s_rules[ruleCount].regexp != nullptr; ruleCount++)
+   {
+      TCHAR name[32];
+      _sntprintf(name, 32, _T("rule%d"), ruleCount);
+      LogParserRule *rule = new LogParserRule(&parser, name, s_rules[ruleCount].regexp, s_rules[ruleCount].ignoreCase, ruleCount + 1);
+      rule->setInverted(s_rules[ruleCount].inverted);
+      AssertTrue(parser.addRule(rule));
+      rules[ruleCount] = rule;
+   }
+   AssertTrue(!_tcscmp(rules[0]->getRequiredLiteral(), _T("error")));
+   AssertTrue(!_tcscmp(rules[1]->getRequiredLiteral(), _T("disk full")));
+   AssertTrue(!_tcscmp(rules[2]->getRequiredLiteral(), _T(" on device")));
+   AssertTrue(rules[16]->getRequiredLiteral() == nullptr);   // quoting
+   AssertTrue(rules[19]->getRequiredLiteral() == nullptr);   // top level alternation
+   AssertTrue(rules[21]->getRequiredLiteral() == nullptr);   // hex escape
+   EndTest();
+
+   StartTest(_T("Rule prefilter - differential test"));
+   PCRE **regexps = MemAllocArray<PCRE*>(ruleCount);
+   for(int i = 0; i < ruleCount; i++)
+   {
+      const char *eptr;
+      int eoffset;
+      regexps[i] = _pcre_compile_t(reinterpret_cast<const PCRE_TCHAR*>(s_rules[i].regexp),
+            s_rules[i].ignoreCase ? PCRE_COMMON_FLAGS | PCRE_CASELESS : PCRE_COMMON_FLAGS, &eptr, &eoffset, nullptr);
+      AssertNotNull(regexps[i]);
+   }
+
+   bool *matched = MemAllocArray<bool>(ruleCount);
+   parser.setCallback(MatchCallback);
+   parser.setUserArg(matched);
+   parser.setProcessAllFlag(true);
+
+   int64_t startTime = GetCurrentTimeMs();
+   int mismatches = 0;
+   int pmatch[30];
+   TCHAR line[1024];
+   for(int n = 0; n < RANDOM_LINE_COUNT; n++)
+   {
+      GenerateRandomLine(line, 1024);
+      memset(matched, 0, ruleCount * sizeof(bool));
+      parser.matchLine(line);
+      for(int i = 0; i < ruleCount; i++)
+      {
+         bool expected = (_pcre_exec_t(regexps[i], nullptr, reinterpret_cast<const PCRE_TCHAR*>(line), static_cast<int>(_tcslen(line)), 0, 0, pmatch, 30) >= 0);
+         if (s_rules[i].inverted)
+            expected = !expected;
+         if (expected != matched[i])
+         {
+            if (mismatches < 10)
+               WriteToTerminalEx(_T("\n   Rule \"%s\" %s line \"%s\""), s_rules[i].regexp, expected ? _T("missed") : _T("wrongly matched"), line);
+            mismatches++;
+         }
+      }
+   }
+   AssertEquals(mismatches, 0);
+
+   int skipCount = 0;
+   for(int i = 0; i < ruleCount; i++)
+   {
+      skipCount += rules[i]->getSkipCount();
+      AssertEquals(rules[i]->getCheckCount(), RANDOM_LINE_COUNT);
+   }
+   AssertTrue(skipCount > 0);
+
+   for(int i = 0; i < ruleCount; i++)
+      _pcre_free_t(regexps[i]);
+   MemFree(regexps);
+   MemFree(matched);
+   EndTest(GetCurrentTimeMs() - startTime);
+}
+
+/**
+ * main()
+ */
+int main(int argc, char *argv[])
+{
+   InitNetXMSProcess(true);
+   srand(static_cast<unsigned int>(time(nullptr)));
+
+   TestPrefilter();
+   return 0;
+}
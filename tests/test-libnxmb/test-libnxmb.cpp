@@ -0,0 +1,365 @@
+#include <nms_common.h>
+#include <nms_util.h>
+#include <nxmbapi.h>
+#include <testtools.h>
+
+NETXMS_EXECUTABLE_HEADER(test-libnxmb)
+
+#define SEQUENCE_LENGTH    5000
+#define CHAIN_COUNT        20
+#define CHAIN_DEPTH        25
+
+/**
+ * Test message with sequence number
+ */
+class TestMessage : public NXMBMessage
+{
+private:
+   int m_sequence;
+
+public:
+   TestMessage(const TCHAR *type, int sequence) : NXMBMessage(type, _T("test")) { m_sequence = sequence; }
+
+   int getSequence() const { return m_sequence; }
+};
+
+/**
+ * Subscriber which counts received messages and checks their order
+ */
+class CountingSubscriber : public NXMBSubscriber
+{
+private:
+   int m_nextSequence;
+   int m_delay;
+
+public:
+   VolatileCounter count;
+   VolatileCounter orderErrors;
+   UINT32 threadId;
+
+   CountingSubscriber(const TCHAR *id, int delay = 0) : NXMBSubscriber(id)
+   {
+      m_nextSequence = 0;
+      m_delay = delay;
+      count = 0;
+      orderErrors = 0;
+      threadId = 0;
+   }
+
+   virtual void messageHandler(NXMBMessage &msg) override
+   {
+      if (static_cast<TestMessage&>(msg).getSequence() != m_nextSequence++)
+         InterlockedIncrement(&orderErrors);
+      threadId = GetCurrentThreadId();
+      if ((m_delay > 0) && (m_nextSequence % 100 == 0))
+         ThreadSleepMs(m_delay);
+      InterlockedIncrement(&count);
+   }
+
+   virtual bool isOwnedByDispatcher() override { return false; }
+};
+
+/**
+ * Type filter which counts calls made by dispatcher
+ */
+class CountingTypeFilter : public NXMBTypeFilter
+{
+public:
+   StringMap typeChecks;
+   VolatileCounter allowChecks;
+
+   CountingTypeFilter() : NXMBTypeFilter() { allowChecks = 0; }
+
+   virtual bool isAllowed(NXMBMessage &msg) override
+   {
+      InterlockedIncrement(&allowChecks);
+      return NXMBTypeFilter::isAllowed(msg);
+   }
+
+   virtual bool isTypeAccepted(const TCHAR *type) override
+   {
+      typeChecks.set(type, typeChecks.getInt32(type, 0) + 1);
+      return NXMBTypeFilter::isTypeAccepted(type);
+   }
+
+   virtual bool isOwnedByDispatcher() override { return false; }
+};
+
+/**
+ * Wait until counter reaches expected value
+ */
+static bool WaitForCounter(VolatileCounter *counter, int expected, uint32_t timeout = 10000)
+{
+   int64_t startTime = GetCurrentTimeMs();
+   while(*counter < expected)
+   {
+      if (GetCurrentTimeMs() - startTime > timeout)
+         return false;
+      ThreadSleepMs(10);
+   }
+   return true;
+}
+
+/**
+ * Post sequence of test messages
+ */
+static void PostSequence(NXMBDispatcher *dispatcher, const TCHAR *type, int count)
+{
+   for(int i = 0; i < count; i++)
+      dispatcher->postMessage(new TestMessage(type, i));
+}
+
+/**
+ * Test delivery through subscriber queues
+ */
+static void TestQueuedDelivery(NXMBDispatcher *dispatcher)
+{
+   StartTest(_T("NXMB - queued delivery"));
+   CountingSubscriber inlineSubscriber(_T("inline"));
+   CountingSubscriber queuedSubscriber(_T("queued"), 5);
+   CountingSubscriber smallQueueSubscriber(_T("smallQueue"), 1);
+   dispatcher->addSubscriber(&inlineSubscriber, new NXMBFilter());
+   dispatcher->addSubscriber(&queuedSubscriber, new NXMBFilter(), 1000);
+   dispatcher->addSubscriber(&smallQueueSubscriber, new NXMBFilter(), 2);   // dispatcher has to wait for free space
+
+   PostSequence(dispatcher, _T("sequence"), SEQUENCE_LENGTH);
+   AssertTrue(WaitForCounter(&inlineSubscriber.count, SEQUENCE_LENGTH));
+   AssertTrue(WaitForCounter(&queuedSubscriber.count, SEQUENCE_LENGTH));
+   AssertTrue(WaitForCounter(&smallQueueSubscriber.count, SEQUENCE_LENGTH));
+   AssertEquals(inlineSubscriber.orderErrors, 0);
+   AssertEquals(queuedSubscriber.orderErrors, 0);
+   AssertEquals(smallQueueSubscriber.orderErrors, 0);
+   AssertTrue(inlineSubscriber.threadId != queuedSubscriber.threadId);
+   AssertTrue(queuedSubscriber.threadId != smallQueueSubscriber.threadId);
+
+   dispatcher->removeSubscriber(_T("queued"));   // pending messages are delivered before removal completes
+   dispatcher->removeSubscriber(_T("smallQueue"));
+   dispatcher->removeSubscriber(_T("inline"));
+   PostSequence(dispatcher, _T("sequence"), 10);
+   ThreadSleepMs(200);
+   AssertEquals(inlineSubscriber.count, SEQUENCE_LENGTH);
+   AssertEquals(queuedSubscriber.count, SEQUENCE_LENGTH);
+   AssertEquals(smallQueueSubscriber.count, SEQUENCE_LENGTH);
+   EndTest();
+}
+
+/**
+ * Test subscriber selection by message type
+ */
+static void TestTypeLookup(NXMBDispatcher *dispatcher)
+{
+   StartTest(_T("NXMB - type lookup"));
+   CountingTypeFilter filter;
+   filter.addMessageType(_T("type.a"));
+   filter.addMessageType(_T("type.b"));
+   CountingSubscriber subscriberA(_T("typeA"));
+   CountingSubscriber subscriberC(_T("typeC"));
+   NXMBTypeFilter *filterC = new NXMBTypeFilter();
+   filterC->addMessageType(_T("type.c"));
+   dispatcher->addSubscriber(&subscriberA, &filter);
+   dispatcher->addSubscriber(&subscriberC, filterC, 10);
+
+   PostSequence(dispatcher, _T("type.c"), 100);
+   PostSequence(dispatcher, _T("type.b"), 100);
+   PostSequence(dispatcher, _T("type.x"), 100);
+   PostSequence(dispatcher, _T("type.a"), 1);   // messages are dispatched in order, so all previous ones are processed after this one
+   AssertTrue(WaitForCounter(&subscriberA.count, 101));
+   AssertTrue(WaitForCounter(&subscriberC.count, 100));
+   AssertEquals(subscriberA.count, 101);
+   AssertEquals(subscriberA.orderErrors, 1);   // sequence restarts for type.a message
+   AssertEquals(subscriberC.orderErrors, 0);
+
+   // Filter is asked once per message type and only for messages of accepted types
+   AssertEquals(filter.allowChecks, 101);
+   AssertEquals(filter.typeChecks.getInt32(_T("type.a"), 0), 1);
+   AssertEquals(filter.typeChecks.getInt32(_T("type.b"), 0), 1);
+   AssertEquals(filter.typeChecks.getInt32(_T("type.c"), 0), 1);
+   AssertEquals(filter.typeChecks.getInt32(_T("type.x"), 0), 1);
+
+   // Subscriber list change should reset type cache
+   CountingSubscriber other(_T("other"));
+   dispatcher->addSubscriber(&other, new NXMBTypeFilter());
+   PostSequence(dispatcher, _T("type.x"), 1);
+   PostSequence(dispatcher, _T("type.a"), 1);
+   AssertTrue(WaitForCounter(&subscriberA.count, 102));
+   AssertEquals(filter.typeChecks.getInt32(_T("type.x"), 0), 2);
+   AssertEquals(filter.typeChecks.getInt32(_T("type.a"), 0), 2);
+   AssertEquals(other.count, 0);
+
+   dispatcher->removeSubscriber(_T("other"));
+   dispatcher->removeSubscriber(_T("typeC"));
+   dispatcher->removeSubscriber(_T("typeA"));
+   EndTest();
+}
+
+/**
+ * Subscriber which posts next message in chain from within message handler
+ */
+class ChainSubscriber : public NXMBSubscriber
+{
+private:
+   NXMBDispatcher *m_dispatcher;
+   const TCHAR *m_type;
+
+public:
+   VolatileCounter count;
+
+   ChainSubscriber(const TCHAR *id, const TCHAR *type, NXMBDispatcher *dispatcher) : NXMBSubscriber(id)
+   {
+      m_dispatcher = dispatcher;
+      m_type = type;
+      count = 0;
+   }
+
+   virtual void messageHandler(NXMBMessage &msg) override
+   {
+      int sequence = static_cast<TestMessage&>(msg).getSequence();
+      if (sequence < CHAIN_DEPTH - 1)
+         m_dispatcher->postMessage(new TestMessage(m_type, sequence + 1));
+      InterlockedIncrement(&count);
+   }
+
+   virtual bool isOwnedByDispatcher() override { return false; }
+};
+
+/**
+ * Subscriber which registers and removes other subscribers from within message handler
+ */
+class ControlSubscriber : public NXMBSubscriber
+{
+private:
+   NXMBDispatcher *m_dispatcher;
+   CountingSubscriber *m_helper;
+
+public:
+   ControlSubscriber(NXMBDispatcher *dispatcher, CountingSubscriber *helper) : NXMBSubscriber(_T("control"))
+   {
+      m_dispatcher = dispatcher;
+      m_helper = helper;
+   }
+
+   virtual void messageHandler(NXMBMessage &msg) override
+   {
+      if (!_tcscmp(msg.getType(), _T("control.add")))
+      {
+         NXMBTypeFilter *filter = new NXMBTypeFilter();
+         filter->addMessageType(_T("helper"));
+         m_dispatcher->addSubscriber(m_helper, filter, static_cast<TestMessage&>(msg).getSequence());
+         m_dispatcher->postMessage(new TestMessage(_T("helper"), 0));
+      }
+      else if (!_tcscmp(msg.getType(), _T("control.remove")))
+      {
+         m_dispatcher->removeSubscriber(m_helper->getId());
+         m_dispatcher->postMessage(new TestMessage(_T("helper"), 1));
+      }
+   }
+
+   virtual bool isOwnedByDispatcher() override { return false; }
+};
+
+/**
+ * Number of destroyed self removing subscribers
+ */
+static VolatileCounter s_selfRemovingDestroyed = 0;
+
+/**
+ * Subscriber owned by dispatcher which removes itself from within message handler
+ */
+class SelfRemovingSubscriber : public NXMBSubscriber
+{
+private:
+   NXMBDispatcher *m_dispatcher;
+   VolatileCounter *m_count;
+
+public:
+   SelfRemovingSubscriber(const TCHAR *id, NXMBDispatcher *dispatcher, VolatileCounter *count) : NXMBSubscriber(id)
+   {
+      m_dispatcher = dispatcher;
+      m_count = count;
+   }
+
+   virtual ~SelfRemovingSubscriber()
+   {
+      InterlockedIncrement(&s_selfRemovingDestroyed);
+   }
+
+   virtual void messageHandler(NXMBMessage &msg) override
+   {
+      m_dispatcher->removeSubscriber(getId());
+      InterlockedIncrement(m_count);
+   }
+};
+
+/**
+ * Test dispatcher calls made from within message handlers
+ */
+static void TestRecursiveDispatch(NXMBDispatcher *dispatcher)
+{
+   StartTest(_T("NXMB - recursive dispatch"));
+   NXMBTypeFilter *inlineFilter = new NXMBTypeFilter();
+   inlineFilter->addMessageType(_T("chain.inline"));
+   NXMBTypeFilter *queuedFilter = new NXMBTypeFilter();
+   queuedFilter->addMessageType(_T("chain.queued"));
+   ChainSubscriber inlineChain(_T("chainInline"), _T("chain.inline"), dispatcher);
+   ChainSubscriber queuedChain(_T("chainQueued"), _T("chain.queued"), dispatcher);
+   dispatcher->addSubscriber(&inlineChain, inlineFilter);
+   dispatcher->addSubscriber(&queuedChain, queuedFilter, 4);
+   for(int i = 0; i < CHAIN_COUNT; i++)
+   {
+      dispatcher->postMessage(new TestMessage(_T("chain.inline"), 0));
+      dispatcher->postMessage(new TestMessage(_T("chain.queued"), 0));
+   }
+   AssertTrue(WaitForCounter(&inlineChain.count, CHAIN_COUNT * CHAIN_DEPTH));
+   AssertTrue(WaitForCounter(&queuedChain.count, CHAIN_COUNT * CHAIN_DEPTH));
+   dispatcher->removeSubscriber(_T("chainInline"));
+   dispatcher->removeSubscriber(_T("chainQueued"));
+   ThreadSleepMs(100);
+   AssertEquals(inlineChain.count, CHAIN_COUNT * CHAIN_DEPTH);
+   AssertEquals(queuedChain.count, CHAIN_COUNT * CHAIN_DEPTH);
+
+   // Register and remove subscriber from within handler on dispatcher thread
+   CountingSubscriber helper(_T("helper"));
+   ControlSubscriber control(dispatcher, &helper);
+   NXMBTypeFilter *controlFilter = new NXMBTypeFilter();
+   controlFilter->addMessageType(_T("control.add"));
+   controlFilter->addMessageType(_T("control.remove"));
+   dispatcher->addSubscriber(&control, controlFilter);
+   dispatcher->postMessage(new TestMessage(_T("control.add"), 0));
+   AssertTrue(WaitForCounter(&helper.count, 1));
+   dispatcher->postMessage(new TestMessage(_T("control.remove"), 0));
+   ThreadSleepMs(200);
+   AssertEquals(helper.count, 1);   // message posted after removal is not delivered
+   dispatcher->postMessage(new TestMessage(_T("control.add"), 10));   // queued this time
+   AssertTrue(WaitForCounter(&helper.count, 2));
+   dispatcher->postMessage(new TestMessage(_T("control.remove"), 0));
+   ThreadSleepMs(200);
+   AssertEquals(helper.count, 2);   // messages posted after removal are not delivered
+   AssertEquals(helper.orderErrors, 1);   // second registration restarts sequence
+   dispatcher->removeSubscriber(_T("control"));
+
+   // Remove subscriber from within own handler
+   int64_t startTime = GetCurrentTimeMs();
+   VolatileCounter inlineCount = 0, queuedCount = 0;
+   dispatcher->addSubscriber(new SelfRemovingSubscriber(_T("selfInline"), dispatcher, &inlineCount), new NXMBFilter());
+   dispatcher->addSubscriber(new SelfRemovingSubscriber(_T("selfQueued"), dispatcher, &queuedCount), new NXMBFilter(), 10);
+   PostSequence(dispatcher, _T("self"), 5);
+   AssertTrue(WaitForCounter(&s_selfRemovingDestroyed, 2));
+   AssertTrue(GetCurrentTimeMs() - startTime < 5000);
+   AssertEquals(inlineCount, 1);
+   AssertTrue((queuedCount >= 1) && (queuedCount <= 5));   // messages queued before removal are still delivered
+   EndTest();
+}
+
+/**
+ * main()
+ */
+int main(int argc, char *argv[])
+{
+   InitNetXMSProcess(true);
+
+   NXMBDispatcher *dispatcher = NXMBDispatcher::getInstance();
+   TestQueuedDelivery(dispatcher);
+   TestTypeLookup(dispatcher);
+   TestRecursiveDispatch(dispatcher);
+   return 0;
+}
@@ -142,6 +142,62 @@ static void TestVariableClass()
    EndTest();
 }
 
+/**
+ * Test SNMP_ObjectIdTrie class
+ */
+static void TestOidTrie()
+{
+   SNMP_ObjectIdTrie trie;
+   int v1 = 1, v2 = 2, v3 = 3, v4 = 4;
+
+   StartTest(_T("SNMP_ObjectIdTrie::put"));
+   AssertFalse(trie.put(s_oidSystem, &v1));
+   AssertFalse(trie.put(s_oidSysDescription, &v2));
+   AssertFalse(trie.put(SNMP_ObjectId::parse(_T(".1.3.6.1.4.1")), &v3));
+   AssertTrue(trie.put(SNMP_ObjectId::parse(_T(".1.3.6.1.4.1")), &v4));
+   AssertEquals(trie.size(), 3);
+   EndTest();
+
+   StartTest(_T("SNMP_ObjectIdTrie::get"));
+   AssertTrue(trie.get(s_oidSystem) == &v1);
+   AssertTrue(trie.get(s_oidSysDescription) == &v2);
+   AssertTrue(trie.get(SNMP_ObjectId::parse(_T(".1.3.6.1.4.1"))) == &v4);
+   AssertNull(trie.get(s_oidSysLocation));
+   AssertNull(trie.get(SNMP_ObjectId::parse(_T(".1.3.6.1"))));
+   EndTest();
+
+   StartTest(_T("SNMP_ObjectIdTrie::findLongestMatch"));
+   size_t matchLength;
+   AssertTrue(trie.findLongestMatch(s_oidSysDescription, &matchLength) == &v2);
+   AssertEquals(matchLength, 9);
+   AssertTrue(trie.findLongestMatch(s_oidSysLocation, &matchLength) == &v1);
+   AssertEquals(matchLength, 7);
+   AssertTrue(trie.findLongestMatch(SNMP_ObjectId::parse(_T(".1.3.6.1.4.1.2620.1.2"))) == &v4);
+   AssertNull(trie.findLongestMatch(SNMP_ObjectId::parse(_T(".1.3.6.1.2.1.2"))));
+   AssertNull(trie.findLongestMatch(SNMP_ObjectId::parse(_T(".1.3.6"))));
+   EndTest();
+
+   StartTest(_T("SNMP_ObjectIdTrie - large number of entries"));
+   SNMP_ObjectIdTrie largeTrie;
+   UINT32 oid[] = { 1, 3, 6, 1, 4, 1, 0, 0, 0 };
+   for(UINT32 i = 0; i < 6000; i++)
+   {
+      oid[6] = (i * 7919) % 10007;   // enterprise numbers in random order
+      oid[7] = i % 3;
+      largeTrie.put(oid, 8, CAST_TO_POINTER(i + 1, void*));
+   }
+   AssertEquals(largeTrie.size(), 6000);
+   for(UINT32 i = 0; i < 6000; i++)
+   {
+      oid[6] = (i * 7919) % 10007;
+      oid[7] = i % 3;
+      oid[8] = i;
+      AssertTrue(largeTrie.findLongestMatch(oid, 9, &matchLength) == CAST_TO_POINTER(i + 1, void*));
+      AssertEquals(matchLength, 8);
+   }
+   EndTest();
+}
+
 /**
  * main()
  */
@@ -152,5 +208,6 @@ int main(int argc, char *argv[])
    TestOidConversion();
    TestOidClass();
    TestVariableClass();
+   TestOidTrie();
    return 0;
 }
@@ -0,0 +1,192 @@
+#include <nms_common.h>
+#include <nms_util.h>
+#include <testtools.h>
+#include <math.h>
+
+#include "../../src/server/spe/nn.cpp"
+
+NETXMS_EXECUTABLE_HEADER(test-spe)
+
+#define SERIES_LENGTH   2000
+#define TRAINING_LENGTH 1600
+#define INPUT_COUNT     5
+#define HIDDEN_COUNT    10
+
+/**
+ * Generate noise in range -amplitude..amplitude
+ */
+static double Noise(double amplitude)
+{
+   return (static_cast<double>(rand()) / RAND_MAX - 0.5) * 2 * amplitude;
+}
+
+/**
+ * Generate sine wave with noise
+ */
+static double *GenerateSineSeries(size_t length, double level, double amplitude)
+{
+   double *series = MemAllocArrayNoInit<double>(length);
+   for(size_t i = 0; i < length; i++)
+      series[i] = level + amplitude * sin(i * M_PI / 12) + Noise(amplitude * 0.05);
+   return series;
+}
+
+/**
+ * Generate series with slow trend and two seasonal components
+ */
+static double *GenerateSeasonalSeries(size_t length)
+{
+   double *series = MemAllocArrayNoInit<double>(length);
+   for(size_t i = 0; i < length; i++)
+      series[i] = 500 + i * 0.05 + 40 * sin(i * M_PI / 12) + 15 * sin(i * M_PI / 84) + Noise(2);
+   return series;
+}
+
+/**
+ * Calculate RMSE of naive prediction (next value equals last value) on given range
+ */
+static double NaiveRMSE(const double *series, size_t start, size_t end)
+{
+   double sum = 0;
+   for(size_t i = start; i < end; i++)
+      sum += (series[i] - series[i - 1]) * (series[i] - series[i - 1]);
+   return sqrt(sum / (end - start));
+}
+
+/**
+ * Train network on first part of series and check that prediction on remaining part is better than naive one
+ */
+static void TestPrediction(const TCHAR *name, double *series)
+{
+   StartTest(name);
+   int64_t startTime = GetCurrentTimeMs();
+   NeuralNetwork nn(INPUT_COUNT, HIDDEN_COUNT);
+   int rounds = nn.train(series, TRAINING_LENGTH, 500, 0.01, 30000);
+   AssertTrue(rounds > 0);
+   AssertTrue(nn.isTrained());
+   double rmse = sqrt(nn.meanSquaredError(&series[TRAINING_LENGTH - INPUT_COUNT], SERIES_LENGTH - TRAINING_LENGTH + INPUT_COUNT));
+   double naive = NaiveRMSE(series, TRAINING_LENGTH, SERIES_LENGTH);
+   AssertTrue(rmse < naive);
+   EndTest(GetCurrentTimeMs() - startTime);
+   _tprintf(_T("      %d rounds, RMSE %f (naive %f)\n"), rounds, rmse, naive);
+}
+
+/**
+ * Test network copy
+ */
+static void TestCopy()
+{
+   StartTest(_T("Network copy"));
+   double *series = GenerateSineSeries(SERIES_LENGTH, 0, 1);
+   NeuralNetwork nn(INPUT_COUNT, HIDDEN_COUNT);
+   nn.train(series, SERIES_LENGTH, 20, 0.01, 0);
+   NeuralNetwork copy(nn);
+   AssertEquals(copy.getInputCount(), INPUT_COUNT);
+   AssertEquals(copy.getHiddenCount(), HIDDEN_COUNT);
+   AssertTrue(copy.isTrained());
+   for(int i = 0; i < 100; i++)
+      AssertEquals(nn.computeOutput(&series[i]), copy.computeOutput(&series[i]));
+   MemFree(series);
+   EndTest();
+}
+
+/**
+ * Test incremental update on short window after change in series amplitude
+ */
+static void TestIncrementalUpdate()
+{
+   StartTest(_T("Incremental update"));
+   double *series = GenerateSineSeries(SERIES_LENGTH, 100, 10);
+   NeuralNetwork nn(INPUT_COUNT, HIDDEN_COUNT);
+   nn.train(series, SERIES_LENGTH, 200, 0.01, 30000);
+   MemFree(series);
+
+   series = GenerateSineSeries(256, 100, 14);
+   double before = nn.meanSquaredError(series, 256);
+   int64_t startTime = GetCurrentTimeMs();
+   int rounds = nn.train(series, 256, 200, 0.005, 200, false);
+   int64_t elapsed = GetCurrentTimeMs() - startTime;
+   AssertTrue(rounds > 0);
+   AssertTrue(elapsed < 1000);
+   double after = nn.meanSquaredError(series, 256);
+   AssertTrue(after < before);
+   MemFree(series);
+   EndTest(elapsed);
+}
+
+/**
+ * Test that training stops when time limit is reached
+ */
+static void TestTimeLimit()
+{
+   StartTest(_T("Training time limit"));
+   double *series = GenerateSeasonalSeries(SERIES_LENGTH);
+   NeuralNetwork nn(INPUT_COUNT, HIDDEN_COUNT);
+   int64_t startTime = GetCurrentTimeMs();
+   int rounds = nn.train(series, SERIES_LENGTH, 1000000, 0.01, 100);
+   int64_t elapsed = GetCurrentTimeMs() - startTime;
+   AssertTrue(rounds < 1000000);
+   AssertTrue(elapsed < 1000);
+   MemFree(series);
+   EndTest(elapsed);
+}
+
+/**
+ * Test that training stops when cancel flag is set
+ */
+static void TestCancel()
+{
+   StartTest(_T("Training cancellation"));
+   double *series = GenerateSeasonalSeries(SERIES_LENGTH);
+   NeuralNetwork nn(INPUT_COUNT, HIDDEN_COUNT);
+   VolatileCounter cancelFlag = 0;
+   AssertTrue(nn.train(series, SERIES_LENGTH, 5, 0.01, 0, true, &cancelFlag) == 5);
+   InterlockedIncrement(&cancelFlag);
+   int64_t startTime = GetCurrentTimeMs();
+   AssertEquals(nn.train(series, SERIES_LENGTH, 1000000, 0.01, 0, true, &cancelFlag), 0);
+   MemFree(series);
+   EndTest(GetCurrentTimeMs() - startTime);
+}
+
+/**
+ * Benchmark prediction
+ */
+static void BenchmarkPrediction()
+{
+   StartTest(_T("Prediction performance"));
+   double *series = GenerateSineSeries(SERIES_LENGTH, 0, 1);
+   NeuralNetwork nn(INPUT_COUNT, HIDDEN_COUNT);
+   nn.train(series, SERIES_LENGTH, 10, 0.01, 0);
+   int64_t startTime = GetCurrentTimeMs();
+   double sum = 0;
+   for(int n = 0; n < 500; n++)
+      for(int i = 0; i < SERIES_LENGTH - INPUT_COUNT; i++)
+         sum += nn.computeOutput(&series[i]);
+   AssertFalse(isnan(sum));
+   MemFree(series);
+   EndTest(GetCurrentTimeMs() - startTime);
+}
+
+/**
+ * main()
+ */
+int main(int argc, char *argv[])
+{
+   InitNetXMSProcess(true);
+   srand(static_cast<unsigned int>(time(nullptr)));
+
+   double *series = GenerateSineSeries(SERIES_LENGTH, 0, 1);
+   TestPrediction(_T("Prediction - sine wave with noise"), series);
+   MemFree(series);
+
+   series = GenerateSeasonalSeries(SERIES_LENGTH);
+   TestPrediction(_T("Prediction - trend with seasonality"), series);
+   MemFree(series);
+
+   TestCopy();
+   TestIncrementalUpdate();
+   TestTimeLimit();
+   TestCancel();
+   BenchmarkPrediction();
+   return 0;
+}